@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef CCLIENT_REQUEST_WERE_ADDRESSES_SPENT_FROM_H
+#define CCLIENT_REQUEST_WERE_ADDRESSES_SPENT_FROM_H
+
+#include "cclient/types/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  /**
+   * List of addresses you want to check the spent state for.
+   */
+  hash243_queue_t addresses;
+} were_addresses_spent_from_req_t;
+
+were_addresses_spent_from_req_t* were_addresses_spent_from_req_new();
+void were_addresses_spent_from_req_free(were_addresses_spent_from_req_t** req);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CCLIENT_REQUEST_WERE_ADDRESSES_SPENT_FROM_H
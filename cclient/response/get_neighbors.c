@@ -9,10 +9,7 @@
 
 void neighbor_info_t_copy(void* _dst, const void* _src) {
   neighbor_info_t *dst = (neighbor_info_t*)_dst, *src = (neighbor_info_t*)_src;
-  dst->address = src->address;
-  dst->all_trans_num = src->all_trans_num;
-  dst->invalid_trans_num = src->invalid_trans_num;
-  dst->new_trans_num = src->new_trans_num;
+  *dst = *src;
 }
 
 void neighbor_info_t_dtor(void* _elt) {
@@ -37,7 +34,7 @@ neighbor_info_t* get_neighbors_res_create_neighbor(char_buffer_t* addr,
                                                    int all_trans,
                                                    int invalid_trans,
                                                    int new_trans) {
-  neighbor_info_t* nb = (neighbor_info_t*)malloc(sizeof(neighbor_info_t));
+  neighbor_info_t* nb = (neighbor_info_t*)calloc(1, sizeof(neighbor_info_t));
   if (nb == NULL) {
     return NULL;
   }
@@ -59,6 +56,10 @@ retcode_t get_neighbors_res_add_neighbor(get_neighbors_res_t* nbors,
   return RC_OK;
 }
 
+size_t get_neighbors_res_num(get_neighbors_res_t* nbors) {
+  return utarray_len(nbors);
+}
+
 neighbor_info_t* get_neighbors_res_neighbor_at(get_neighbors_res_t* nbors,
                                                int index) {
   if (utarray_len(nbors) > index) {
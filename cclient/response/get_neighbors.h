@@ -32,6 +32,43 @@ typedef struct {
    * Number of newly transmitted transactions.
    */
   int new_trans_num;
+  /**
+   * Number of already seen transactions your peer has sent you.
+   */
+  int duplicate_trans_num;
+  /**
+   * Number of random transaction requests your peer has sent you.
+   */
+  int random_trans_req_num;
+  /**
+   * Number of transactions sent to your peer.
+   */
+  int sent_trans_num;
+  /**
+   * Transactions and requests of your peer dropped by its rate limits or
+   * because it is disconnected, and transactions not sent to it for the same
+   * reasons.
+   */
+  int dropped_trans_num;
+  int dropped_req_num;
+  int dropped_sent_trans_num;
+  /**
+   * Usefulness of the transactions your peer sends, in [0,1].
+   */
+  double score;
+  /**
+   * Whether your peer has its rate limits scaled down by its score, or all its
+   * traffic dropped for a while.
+   */
+  bool throttled;
+  bool disconnected;
+  /**
+   * Rate limits currently applied to your peer: transactions and requests it
+   * sends and bytes sent to it, per second. 0 for no limit.
+   */
+  double trans_rate_limit;
+  double req_rate_limit;
+  double bytes_rate_limit;
 } neighbor_info_t;
 
 typedef UT_array get_neighbors_res_t;
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include "cclient/response/were_addresses_spent_from.h"
+
+were_addresses_spent_from_res_t* were_addresses_spent_from_res_new() {
+  were_addresses_spent_from_res_t* res =
+      (were_addresses_spent_from_res_t*)malloc(
+          sizeof(were_addresses_spent_from_res_t));
+  if (res) {
+    utarray_new(res->states, &ut_int_icd);
+  }
+  return res;
+}
+
+bool were_addresses_spent_from_res_states_at(
+    were_addresses_spent_from_res_t* in, int index) {
+  int* b = (int*)utarray_eltptr(in->states, index);
+  if (b != NULL) {
+    return (*b > 0) ? true : false;
+  }
+  return false;
+}
+
+int were_addresses_spent_from_res_states_num(
+    were_addresses_spent_from_res_t* in) {
+  return utarray_len(in->states);
+}
+
+void were_addresses_spent_from_res_free(
+    were_addresses_spent_from_res_t** res) {
+  if (*res) {
+    utarray_free((*res)->states);
+    free(*res);
+    *res = NULL;
+  }
+}
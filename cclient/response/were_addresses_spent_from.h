@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef CCLIENT_RESPONSE_WERE_ADDRESSES_SPENT_FROM_H
+#define CCLIENT_RESPONSE_WERE_ADDRESSES_SPENT_FROM_H
+
+#include "cclient/types/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  UT_array* states;
+} were_addresses_spent_from_res_t;
+
+were_addresses_spent_from_res_t* were_addresses_spent_from_res_new();
+void were_addresses_spent_from_res_free(were_addresses_spent_from_res_t** res);
+bool were_addresses_spent_from_res_states_at(
+    were_addresses_spent_from_res_t* in, int index);
+int were_addresses_spent_from_res_states_num(
+    were_addresses_spent_from_res_t* in);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CCLIENT_RESPONSE_WERE_ADDRESSES_SPENT_FROM_H
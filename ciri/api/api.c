@@ -5,14 +5,17 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdio.h>
 #include <string.h>
 
 #include "cclient/request/requests.h"
 #include "cclient/response/responses.h"
 #include "cclient/serialization/json/json_serializer.h"
 #include "ciri/api/api.h"
+#include "consensus/utils/tangle_traversals.h"
 #include "gossip/node.h"
 #include "utils/logger_helper.h"
+#include "utils/macros.h"
 #include "utils/time.h"
 
 #define API_LOGGER_ID "api"
@@ -29,6 +32,57 @@ static bool invalid_subtangle_status(iota_api_t const *const api) {
           api->consensus->milestone_tracker.milestone_start_index);
 }
 
+typedef struct inclusion_states_traversal_params_s {
+  hash243_set_t const *targets;
+  hash243_set_t *found;
+  uint64_t min_target_index;
+  size_t visited;
+  size_t max_visited;
+} inclusion_states_traversal_params_t;
+
+static retcode_t inclusion_states_traversal_do_func(flex_trit_t *const hash,
+                                                    iota_stor_pack_t *pack,
+                                                    void *data,
+                                                    bool *should_branch,
+                                                    bool *should_stop) {
+  retcode_t ret = RC_OK;
+  inclusion_states_traversal_params_t *params = data;
+  uint64_t snapshot_index = 0;
+
+  *should_branch = false;
+  *should_stop = false;
+
+  if (pack->num_loaded == 0) {
+    return RC_OK;
+  }
+
+  if (++params->visited > params->max_visited) {
+    *should_stop = true;
+    return RC_API_MAX_INCLUSION_STATES_TRAVERSAL;
+  }
+
+  if (hash243_set_contains(params->targets, hash)) {
+    if ((ret = hash243_set_add(params->found, hash)) != RC_OK) {
+      *should_stop = true;
+      return ret;
+    }
+    if (hash243_set_size(params->found) == hash243_set_size(params->targets)) {
+      *should_stop = true;
+      return RC_OK;
+    }
+  }
+
+  // The past cone of a transaction confirmed by a milestone only contains
+  // transactions confirmed by the same or earlier milestones
+  snapshot_index =
+      transaction_snapshot_index((iota_transaction_t *)pack->models[0]);
+  *should_branch = snapshot_index == 0 ||
+                   (params->min_target_index != 0 &&
+                    snapshot_index >= params->min_target_index);
+
+  return ret;
+}
+
 typedef enum iota_api_command_e {
   CMD_GET_NODE_INFO,
   CMD_GET_NEIGHBORS,
@@ -49,6 +103,41 @@ typedef enum iota_api_command_e {
   CMD_UNKNOWN
 } iota_api_command_t;
 
+/**
+ * Computes the delta of a list of tips on top of the snapshot, failing if one
+ * of them is missing or if they are not consistent with each other
+ */
+static retcode_t tips_delta(iota_api_t const *const api, tangle_t *const tangle,
+                            hash243_queue_t const tips,
+                            state_delta_t *const diff) {
+  retcode_t ret = RC_OK;
+  hash243_queue_entry_t *iter = NULL;
+  hash243_set_t analyzed_hashes = NULL;
+  bool exists = false, is_consistent = false;
+
+  CDL_FOREACH(tips, iter) {
+    if ((ret = iota_tangle_transaction_exist(tangle, TRANSACTION_FIELD_HASH,
+                                             iter->hash, &exists)) != RC_OK) {
+      goto done;
+    } else if (!exists) {
+      ret = RC_API_TIP_MISSING;
+      goto done;
+    }
+    if ((ret = iota_consensus_ledger_validator_update_delta(
+             &api->consensus->ledger_validator, tangle, &analyzed_hashes, diff,
+             iter->hash, &is_consistent)) != RC_OK) {
+      goto done;
+    } else if (!is_consistent) {
+      ret = RC_API_TIPS_NOT_CONSISTENT;
+      goto done;
+    }
+  }
+
+done:
+  hash243_set_free(&analyzed_hashes);
+  return ret;
+}
+
 static iota_api_command_t get_command(char const *const command) {
   static struct iota_api_command_map_s {
     char const *const string;
@@ -84,6 +173,8 @@ static iota_api_command_t get_command(char const *const command) {
 
 retcode_t iota_api_get_node_info(iota_api_t const *const api,
                                  get_node_info_res_t *const res) {
+  uint64_t latest_solid_subtangle_milestone_index = 0;
+
   if (api == NULL || res == NULL) {
     return RC_NULL_PARAM;
   }
@@ -94,12 +185,13 @@ retcode_t iota_api_get_node_info(iota_api_t const *const api,
          api->consensus->milestone_tracker.latest_milestone,
          FLEX_TRIT_SIZE_243);
   res->latest_milestone_index =
-      api->consensus->milestone_tracker.latest_milestone_index;
-  memcpy(res->latest_solid_subtangle_milestone,
-         api->consensus->milestone_tracker.latest_solid_subtangle_milestone,
-         FLEX_TRIT_SIZE_243);
+      __atomic_load_n(&api->consensus->milestone_tracker.latest_milestone_index,
+                      __ATOMIC_ACQUIRE);
+  iota_milestone_tracker_latest_solid_subtangle_milestone(
+      &api->consensus->milestone_tracker, res->latest_solid_subtangle_milestone,
+      &latest_solid_subtangle_milestone_index);
   res->latest_solid_subtangle_milestone_index =
-      api->consensus->milestone_tracker.latest_solid_subtangle_milestone_index;
+      latest_solid_subtangle_milestone_index;
   res->milestone_start_index =
       api->consensus->milestone_tracker.milestone_start_index;
   rw_lock_handle_rdlock(&api->node->neighbors_lock);
@@ -118,11 +210,52 @@ retcode_t iota_api_get_node_info(iota_api_t const *const api,
 
 retcode_t iota_api_get_neighbors(iota_api_t const *const api,
                                  get_neighbors_res_t *const res) {
+  retcode_t ret = RC_OK;
+  neighbor_t *iter = NULL;
+  neighbor_info_t info;
+  neighbor_traffic_status_t status;
+  char address[MAX_HOST_LENGTH + 16];
+
   if (api == NULL || res == NULL) {
     return RC_NULL_PARAM;
   }
 
-  return RC_OK;
+  rw_lock_handle_rdlock(&api->node->neighbors_lock);
+  LL_FOREACH(api->node->neighbors, iter) {
+    memset(&info, 0, sizeof(neighbor_info_t));
+    snprintf(address, sizeof(address), "%s://%s:%d",
+             iter->endpoint.protocol == PROTOCOL_TCP ? "tcp" : "udp",
+             iter->endpoint.host, iter->endpoint.port);
+    if ((info.address = char_buffer_new()) == NULL) {
+      ret = RC_OOM;
+      goto done;
+    }
+    if ((ret = char_buffer_set(info.address, address)) != RC_OK) {
+      char_buffer_free(info.address);
+      goto done;
+    }
+    info.all_trans_num = iter->nbr_all_tx;
+    info.invalid_trans_num = iter->nbr_invalid_tx;
+    info.new_trans_num = iter->nbr_new_tx;
+    info.duplicate_trans_num = iter->nbr_duplicate_tx;
+    info.random_trans_req_num = iter->nbr_random_tx_req;
+    info.sent_trans_num = iter->nbr_sent_tx;
+    info.dropped_trans_num = iter->nbr_dropped_tx;
+    info.dropped_req_num = iter->nbr_dropped_req;
+    info.dropped_sent_trans_num = iter->nbr_dropped_sent_tx;
+    neighbor_traffic_status(iter, &api->node->conf, &status);
+    info.score = status.score;
+    info.throttled = status.state == NEIGHBOR_THROTTLED;
+    info.disconnected = status.state == NEIGHBOR_DISCONNECTED;
+    info.trans_rate_limit = status.packets_rate;
+    info.req_rate_limit = status.requests_rate;
+    info.bytes_rate_limit = status.bytes_rate;
+    utarray_push_back(res, &info);
+  }
+
+done:
+  rw_lock_handle_unlock(&api->node->neighbors_lock);
+  return ret;
 }
 
 retcode_t iota_api_add_neighbors(iota_api_t const *const api,
@@ -292,23 +425,203 @@ retcode_t iota_api_get_trytes(iota_api_t const *const api,
 }
 
 retcode_t iota_api_get_inclusion_states(
-    iota_api_t const *const api, get_inclusion_state_req_t const *const req,
+    iota_api_t const *const api, tangle_t *const tangle,
+    get_inclusion_state_req_t const *const req,
     get_inclusion_state_res_t *const res) {
-  if (api == NULL || req == NULL || res == NULL) {
+  retcode_t ret = RC_OK;
+  hash243_queue_entry_t *iter = NULL;
+  hash243_queue_t traversal_tips = NULL;
+  hash243_set_t targets = NULL, found = NULL, analyzed_hashes = NULL;
+  uint64_t *snapshot_indexes = NULL;
+  uint64_t milestone_index = 0, min_target_index = 0;
+  size_t count = 0, i = 0;
+  bool is_milestone = false, exists = false;
+  int state = 0;
+  DECLARE_PACK_SINGLE_TX(tx, txp, pack);
+
+  if (api == NULL || tangle == NULL || req == NULL || res == NULL) {
     return RC_NULL_PARAM;
   }
 
-  return RC_OK;
+  if (invalid_subtangle_status(api)) {
+    return RC_API_INVALID_SUBTANGLE_STATUS;
+  }
+
+  if ((count = hash243_queue_count(req->hashes)) == 0) {
+    return RC_OK;
+  }
+
+  if ((snapshot_indexes = (uint64_t *)calloc(count, sizeof(uint64_t))) ==
+      NULL) {
+    return RC_OOM;
+  }
+
+  // A milestone includes every transaction confirmed up to its own index,
+  // other tips need a traversal
+  CDL_FOREACH(req->tips, iter) {
+    hash_pack_reset(&pack);
+    if ((ret = iota_tangle_transaction_load_partial(
+             tangle, iter->hash, &pack, PARTIAL_TX_MODEL_METADATA)) != RC_OK) {
+      goto done;
+    } else if (pack.num_loaded == 0) {
+      ret = RC_API_TIP_MISSING;
+      goto done;
+    }
+    if ((ret = iota_tangle_milestone_exist(tangle, iter->hash,
+                                           &is_milestone)) != RC_OK) {
+      goto done;
+    }
+    if (is_milestone && transaction_snapshot_index(&tx) != 0) {
+      milestone_index = MAX(milestone_index, transaction_snapshot_index(&tx));
+    } else if ((ret = hash243_queue_push(&traversal_tips, iter->hash)) !=
+               RC_OK) {
+      goto done;
+    }
+  }
+
+  // Recently confirmed transactions are served from the confirmation cache
+  i = 0;
+  CDL_FOREACH(req->hashes, iter) {
+    exists = (snapshot_indexes[i] = iota_confirmation_cache_get(
+                  &api->consensus->milestone_tracker.confirmation_cache,
+                  iter->hash)) != 0;
+    if (!exists) {
+      hash_pack_reset(&pack);
+      if ((ret = iota_tangle_transaction_load_partial(
+               tangle, iter->hash, &pack, PARTIAL_TX_MODEL_METADATA)) !=
+          RC_OK) {
+        goto done;
+      }
+      if ((exists = pack.num_loaded != 0)) {
+        snapshot_indexes[i] = transaction_snapshot_index(&tx);
+      }
+    }
+    if (traversal_tips && exists &&
+        (snapshot_indexes[i] == 0 || snapshot_indexes[i] > milestone_index)) {
+      if ((ret = hash243_set_add(&targets, iter->hash)) != RC_OK) {
+        goto done;
+      }
+      if (snapshot_indexes[i] != 0 &&
+          (min_target_index == 0 || snapshot_indexes[i] < min_target_index)) {
+        min_target_index = snapshot_indexes[i];
+      }
+    }
+    i++;
+  }
+
+  // Traversals share their analyzed hashes so that each transaction is
+  // visited at most once per request
+  if (targets) {
+    inclusion_states_traversal_params_t params = {
+        .targets = &targets,
+        .found = &found,
+        .min_target_index = min_target_index,
+        .visited = 0,
+        .max_visited = api->conf.max_inclusion_states_traversal};
+    CDL_FOREACH(traversal_tips, iter) {
+      if ((ret = tangle_traversal_dfs_to_genesis(
+               tangle, inclusion_states_traversal_do_func, iter->hash,
+               api->consensus->conf.genesis_hash, &analyzed_hashes, &params)) !=
+          RC_OK) {
+        goto done;
+      }
+      if (hash243_set_size(&found) == hash243_set_size(&targets)) {
+        break;
+      }
+    }
+  }
+
+  i = 0;
+  CDL_FOREACH(req->hashes, iter) {
+    state = (snapshot_indexes[i] != 0 &&
+             snapshot_indexes[i] <= milestone_index) ||
+            hash243_set_contains(&found, iter->hash);
+    utarray_push_back(res->states, &state);
+    i++;
+  }
+
+done:
+  free(snapshot_indexes);
+  hash243_queue_free(&traversal_tips);
+  hash243_set_free(&targets);
+  hash243_set_free(&found);
+  hash243_set_free(&analyzed_hashes);
+
+  return ret;
 }
 
 retcode_t iota_api_get_balances(iota_api_t const *const api,
+                                tangle_t *const tangle,
                                 get_balances_req_t const *const req,
                                 get_balances_res_t *const res) {
-  if (api == NULL || req == NULL || res == NULL) {
+  retcode_t ret = RC_OK;
+  hash243_queue_entry_t *iter = NULL;
+  state_delta_t diff = NULL;
+  int64_t *balances = NULL;
+  uint64_t balance = 0;
+  size_t count = 0, index = 0, delta_index = 0, i = 0;
+  snapshot_t *snapshot = NULL;
+  flex_trit_t milestone[FLEX_TRIT_SIZE_243];
+
+  if (api == NULL || tangle == NULL || req == NULL || res == NULL) {
     return RC_NULL_PARAM;
   }
 
-  return RC_OK;
+  if (req->threshold == 0 || req->threshold > 100) {
+    return RC_API_INVALID_THRESHOLD;
+  }
+
+  count = hash243_queue_count(req->addresses);
+  if (count != 0 &&
+      (balances = (int64_t *)calloc(count, sizeof(int64_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  snapshot = api->consensus->milestone_tracker.latest_snapshot;
+
+  if (req->tips == NULL) {
+    iota_milestone_tracker_latest_solid_subtangle_milestone(
+        &api->consensus->milestone_tracker, milestone, NULL);
+    if ((ret = hash243_queue_push(&res->milestone, milestone)) != RC_OK) {
+      goto done;
+    }
+    if ((ret = iota_snapshot_get_balances(snapshot, req->addresses, NULL,
+                                          balances, &index)) != RC_OK) {
+      goto done;
+    }
+  } else {
+    // The deltas of the tips are computed without holding the snapshot lock,
+    // they are computed again if the snapshot moved before the balances are
+    // read
+    do {
+      state_delta_destroy(&diff);
+      delta_index = iota_snapshot_get_index(snapshot);
+      if ((ret = tips_delta(api, tangle, req->tips, &diff)) != RC_OK) {
+        goto done;
+      }
+      if ((ret = iota_snapshot_get_balances(snapshot, req->addresses, &diff,
+                                            balances, &index)) != RC_OK) {
+        goto done;
+      }
+    } while (index != delta_index);
+    CDL_FOREACH(req->tips, iter) {
+      if ((ret = hash243_queue_push(&res->milestone, iter->hash)) != RC_OK) {
+        goto done;
+      }
+    }
+  }
+
+  for (i = 0; i < count; i++) {
+    balance = balances[i];
+    utarray_push_back(res->balances, &balance);
+  }
+  res->milestoneIndex = index;
+
+done:
+  free(balances);
+  state_delta_destroy(&diff);
+
+  return ret;
 }
 
 retcode_t iota_api_get_transactions_to_approve(
@@ -366,6 +679,7 @@ retcode_t iota_api_broadcast_transactions(
   retcode_t ret = RC_OK;
   flex_trit_t *elt = NULL;
   iota_transaction_t tx;
+  iota_packet_t packet;
 
   if (api == NULL || req == NULL) {
     return RC_NULL_PARAM;
@@ -381,8 +695,12 @@ retcode_t iota_api_broadcast_transactions(
             &api->consensus->transaction_validator, &tx)) {
       continue;
     }
-    // TODO priority queue on weight_magnitude
-    if ((ret = broadcaster_on_next(&api->node->broadcaster, elt)) != RC_OK) {
+    if ((ret = iota_packet_set_transaction(&packet, elt)) != RC_OK) {
+      return ret;
+    }
+    // Locally attached transactions go ahead of the ones relayed for neighbors
+    if ((ret = broadcaster_on_next(&api->node->broadcaster, packet.content,
+                                   GOSSIP_PRIORITY_HIGH)) != RC_OK) {
       return ret;
     }
   }
@@ -432,13 +750,29 @@ retcode_t iota_api_store_transactions(
 }
 
 retcode_t iota_api_were_addresses_spent_from(
-    iota_api_t const *const api, check_consistency_req_t const *const req,
-    check_consistency_res_t *const res) {
-  if (api == NULL || req == NULL || res == NULL) {
+    iota_api_t const *const api, tangle_t *const tangle,
+    were_addresses_spent_from_req_t const *const req,
+    were_addresses_spent_from_res_t *const res) {
+  retcode_t ret = RC_OK;
+  hash243_queue_entry_t *iter = NULL;
+  bool spent = false;
+  int state = 0;
+
+  if (api == NULL || tangle == NULL || req == NULL || res == NULL) {
     return RC_NULL_PARAM;
   }
 
-  return RC_OK;
+  CDL_FOREACH(req->addresses, iter) {
+    if ((ret = iota_spent_addresses_provider_contains(
+             &api->consensus->spent_addresses_provider, tangle, iter->hash,
+             &spent)) != RC_OK) {
+      return ret;
+    }
+    state = spent;
+    utarray_push_back(res->states, &state);
+  }
+
+  return ret;
 }
 
 retcode_t iota_api_check_consistency(iota_api_t const *const api,
@@ -447,7 +781,6 @@ retcode_t iota_api_check_consistency(iota_api_t const *const api,
                                      check_consistency_res_t *const res) {
   retcode_t ret = RC_OK;
   hash243_queue_entry_t *iter = NULL;
-  bundle_transactions_t *bundle = NULL;
   bundle_status_t bundle_status = BUNDLE_NOT_INITIALIZED;
   exit_prob_transaction_validator_t walker_validator;
   DECLARE_PACK_SINGLE_TX(tx, txp, pack);
@@ -463,7 +796,6 @@ retcode_t iota_api_check_consistency(iota_api_t const *const api,
   }
 
   CDL_FOREACH(req->tails, iter) {
-    bundle_transactions_new(&bundle);
     hash_pack_reset(&pack);
     if ((ret = iota_tangle_transaction_load_partial(
              tangle, iter->hash, &pack, PARTIAL_TX_MODEL_ESSENCE_METADATA)) !=
@@ -474,13 +806,11 @@ retcode_t iota_api_check_consistency(iota_api_t const *const api,
       ret = RC_API_NOT_TAIL;
     } else if (!tx.metadata.solid) {
       check_consistency_res_info_set(res, API_TAILS_NOT_SOLID);
-    } else if ((ret = iota_consensus_bundle_validator_validate(
-                    tangle, iter->hash, bundle, &bundle_status)) != RC_OK) {
-    } else if (bundle_status != BUNDLE_VALID ||
-               bundle_transactions_size(bundle) == 0) {
+    } else if ((ret = iota_consensus_bundle_validator_validate_transfers(
+                    tangle, iter->hash, NULL, &bundle_status)) != RC_OK) {
+    } else if (bundle_status != BUNDLE_VALID) {
       check_consistency_res_info_set(res, API_TAILS_BUNDLE_INVALID);
     }
-    bundle_transactions_free(&bundle);
     if (ret != RC_OK || (res->info != NULL && res->info->data != NULL)) {
       return ret;
     }
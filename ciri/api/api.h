@@ -96,7 +96,8 @@ retcode_t iota_api_get_node_info(iota_api_t const *const api,
 
 /**
  * Returns the set of neighbors you are connected with, as well as their
- * activity count. The activity counter is reset after restarting IRI.
+ * activity count, score and current rate limits. The activity counter is reset
+ * after restarting IRI.
  *
  * @param api The API
  * @param res The response
@@ -190,15 +191,19 @@ retcode_t iota_api_get_trytes(iota_api_t const *const api,
  * of transactions. This API call simply returns a list of boolean values in the
  * same order as the transaction list you submitted, thus you get a true/false
  * whether a transaction is confirmed or not.
+ * Milestone tips are answered from the snapshot index of the transactions,
+ * other tips require a bounded traversal of their past cone.
  *
  * @param api The API
+ * @param tangle A tangle
  * @param req The request
  * @param res The response
  *
  * @return a status code
  */
 retcode_t iota_api_get_inclusion_states(
-    iota_api_t const *const api, get_inclusion_state_req_t const *const req,
+    iota_api_t const *const api, tangle_t *const tangle,
+    get_inclusion_state_req_t const *const req,
     get_inclusion_state_res_t *const res);
 
 /**
@@ -207,14 +212,17 @@ retcode_t iota_api_get_inclusion_states(
  * to the balances, it also returns the referencing tips (or milestone), as well
  * as the index with which the confirmed balance was determined. The balances is
  * returned as a list in the same order as the addresses were provided as input.
+ * All balances are read at the same snapshot index.
  *
  * @param api The API
+ * @param tangle A tangle
  * @param req The request
  * @param res The response
  *
  * @return a status code
  */
 retcode_t iota_api_get_balances(iota_api_t const *const api,
+                                tangle_t *const tangle,
                                 get_balances_req_t const *const req,
                                 get_balances_res_t *const res);
 
@@ -298,17 +306,20 @@ retcode_t iota_api_store_transactions(
 
 /**
  * Checks if a list of addresses was ever spent from, in the current epoch, or
- * in previous epochs.
+ * in previous epochs. States are returned in the same order as the addresses
+ * were provided as input.
  *
  * @param api The API
+ * @param tangle A tangle
  * @param req The request
  * @param res The response
  *
  * @return a status code
  */
 retcode_t iota_api_were_addresses_spent_from(
-    iota_api_t const *const api, check_consistency_req_t const *const req,
-    check_consistency_res_t *const res);
+    iota_api_t const *const api, tangle_t *const tangle,
+    were_addresses_spent_from_req_t const *const req,
+    were_addresses_spent_from_res_t *const res);
 
 /**
  * Checks consistency of transactions.
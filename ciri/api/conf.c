@@ -15,6 +15,7 @@ retcode_t iota_api_conf_init(iota_api_conf_t* const conf) {
   conf->port = DEFAULT_API_PORT;
   conf->max_find_transactions = DEFAULT_MAX_FIND_TRANSACTIONS;
   conf->max_get_trytes = DEFAULT_MAX_GET_TRYTES;
+  conf->max_inclusion_states_traversal = DEFAULT_MAX_INCLUSION_STATES_TRAVERSAL;
 
   return RC_OK;
 }
@@ -15,6 +15,7 @@
 #define DEFAULT_API_PORT 14265
 #define DEFAULT_MAX_FIND_TRANSACTIONS 100000;
 #define DEFAULT_MAX_GET_TRYTES 10000;
+#define DEFAULT_MAX_INCLUSION_STATES_TRAVERSAL 100000;
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,6 +33,10 @@ typedef struct iota_api_conf_s {
   // Maximum number of transactions that will be returned by the 'getTrytes' API
   // call
   size_t max_get_trytes;
+  // Maximum number of transactions that may be traversed by the
+  // 'getInclusionStates' API call when some tips are not milestones. If this
+  // number is exceeded an error will be returned
+  size_t max_inclusion_states_traversal;
   // Path of the DB file
   char db_path[128];
 } iota_api_conf_t;
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/api/api.h"
+#include "consensus/test_utils/bundle.h"
+#include "consensus/test_utils/tangle.h"
+#include "gossip/node.h"
+#include "utils/files.h"
+
+static char *test_db_path = "ciri/api/tests/test.db";
+static char *ciri_db_path = "ciri/api/tests/ciri.db";
+static connection_config_t config;
+static iota_api_t api;
+static node_t node;
+static tangle_t tangle;
+static iota_consensus_t consensus;
+
+void setUp(void) {
+  TEST_ASSERT(tangle_setup(&tangle, &config, test_db_path, ciri_db_path) ==
+              RC_OK);
+}
+
+void tearDown(void) {
+  TEST_ASSERT(tangle_cleanup(&tangle, test_db_path) == RC_OK);
+}
+
+void test_get_balances_invalid_threshold(void) {
+  get_balances_req_t *req = get_balances_req_new();
+  get_balances_res_t *res = get_balances_res_new();
+
+  req->threshold = 0;
+  TEST_ASSERT(iota_api_get_balances(&api, &tangle, req, res) ==
+              RC_API_INVALID_THRESHOLD);
+  req->threshold = 101;
+  TEST_ASSERT(iota_api_get_balances(&api, &tangle, req, res) ==
+              RC_API_INVALID_THRESHOLD);
+  TEST_ASSERT_EQUAL_INT(get_balances_res_balances_num(res), 0);
+
+  get_balances_req_free(&req);
+  get_balances_res_free(&res);
+}
+
+void test_get_balances_no_tips(void) {
+  get_balances_req_t *req = get_balances_req_new();
+  get_balances_res_t *res = get_balances_res_new();
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  req->threshold = 100;
+  flex_trits_from_trytes(hash, HASH_LENGTH_TRIT, TX_2_OF_4_ADDRESS,
+                         HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  hash243_queue_push(&req->addresses, hash);
+  flex_trits_from_trytes(hash, HASH_LENGTH_TRIT, TX_1_OF_4_HASH,
+                         HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  hash243_queue_push(&req->addresses, hash);
+
+  TEST_ASSERT(iota_api_get_balances(&api, &tangle, req, res) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(get_balances_res_balances_num(res), 2);
+  TEST_ASSERT_EQUAL_INT(get_balances_res_balances_at(res, 0), 1545071560);
+  TEST_ASSERT_EQUAL_INT(get_balances_res_balances_at(res, 1), 0);
+  TEST_ASSERT_EQUAL_INT(res->milestoneIndex,
+                        iota_snapshot_get_index(&consensus.snapshot));
+  TEST_ASSERT_EQUAL_INT(hash243_queue_count(res->milestone), 1);
+  TEST_ASSERT_EQUAL_MEMORY(
+      hash243_queue_peek(res->milestone),
+      consensus.milestone_tracker.latest_solid_subtangle_milestone,
+      FLEX_TRIT_SIZE_243);
+
+  get_balances_req_free(&req);
+  get_balances_res_free(&res);
+}
+
+void test_get_balances_missing_tip(void) {
+  get_balances_req_t *req = get_balances_req_new();
+  get_balances_res_t *res = get_balances_res_new();
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  req->threshold = 100;
+  flex_trits_from_trytes(hash, HASH_LENGTH_TRIT, TX_2_OF_4_ADDRESS,
+                         HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  hash243_queue_push(&req->addresses, hash);
+  flex_trits_from_trytes(hash, HASH_LENGTH_TRIT, TX_1_OF_4_HASH,
+                         HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  hash243_queue_push(&req->tips, hash);
+
+  TEST_ASSERT(iota_api_get_balances(&api, &tangle, req, res) ==
+              RC_API_TIP_MISSING);
+  TEST_ASSERT_EQUAL_INT(get_balances_res_balances_num(res), 0);
+
+  get_balances_req_free(&req);
+  get_balances_res_free(&res);
+}
+
+void test_get_balances_with_tips(void) {
+  get_balances_req_t *req = get_balances_req_new();
+  get_balances_res_t *res = get_balances_res_new();
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  iota_transaction_t *txs[4];
+  tryte_t const *const trytes[4] = {
+      TX_1_OF_4_VALUE_BUNDLE_TRYTES, TX_2_OF_4_VALUE_BUNDLE_TRYTES,
+      TX_3_OF_4_VALUE_BUNDLE_TRYTES, TX_4_OF_4_VALUE_BUNDLE_TRYTES};
+
+  transactions_deserialize(trytes, txs, 4, true);
+  TEST_ASSERT(build_tangle(&tangle, txs, 4) == RC_OK);
+  flex_trits_from_trytes(hash, HASH_LENGTH_TRIT, TX_1_OF_4_HASH,
+                         HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  TEST_ASSERT(iota_tangle_transaction_update_solid_state(&tangle, hash, true) ==
+              RC_OK);
+  hash243_queue_push(&req->tips, hash);
+
+  req->threshold = 100;
+  hash243_queue_push(&req->addresses, transaction_address(txs[1]));
+  hash243_queue_push(&req->addresses, transaction_address(txs[0]));
+  hash243_queue_push(&req->addresses, transaction_address(txs[3]));
+
+  TEST_ASSERT(iota_api_get_balances(&api, &tangle, req, res) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(get_balances_res_balances_num(res), 3);
+  TEST_ASSERT_EQUAL_INT(get_balances_res_balances_at(res, 0), 0);
+  TEST_ASSERT_EQUAL_INT(get_balances_res_balances_at(res, 1), 1500000000);
+  TEST_ASSERT_EQUAL_INT(get_balances_res_balances_at(res, 2), 45071560);
+  TEST_ASSERT_EQUAL_INT(hash243_queue_count(res->milestone), 1);
+  TEST_ASSERT_EQUAL_MEMORY(hash243_queue_peek(res->milestone), hash,
+                           FLEX_TRIT_SIZE_243);
+
+  get_balances_req_free(&req);
+  get_balances_res_free(&res);
+  transactions_free(txs, 4);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  TEST_ASSERT(storage_init() == RC_OK);
+
+  config.db_path = test_db_path;
+  api.node = &node;
+  api.consensus = &consensus;
+
+  TEST_ASSERT(iota_gossip_conf_init(&api.node->conf) == RC_OK);
+  TEST_ASSERT(iota_consensus_conf_init(&api.consensus->conf) == RC_OK);
+  TEST_ASSERT(requester_init(&api.node->transaction_requester, api.node) ==
+              RC_OK);
+  TEST_ASSERT(tips_cache_init(&api.node->tips,
+                              api.node->conf.tips_cache_size) == RC_OK);
+
+  setUp();
+
+  // Avoid verifying snapshot signature
+  api.consensus->conf.snapshot_signature_file[0] = '\0';
+
+  TEST_ASSERT(iota_consensus_init(api.consensus, &tangle,
+                                  &api.node->transaction_requester,
+                                  &api.node->tips) == RC_OK);
+
+  state_delta_destroy(&api.consensus->snapshot.state);
+
+  tearDown();
+
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trits_from_trytes(hash, HASH_LENGTH_TRIT, TX_2_OF_4_ADDRESS,
+                         HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  state_delta_add(&api.consensus->snapshot.state, hash, 1545071560);
+
+  RUN_TEST(test_get_balances_invalid_threshold);
+  RUN_TEST(test_get_balances_no_tips);
+  RUN_TEST(test_get_balances_missing_tip);
+  RUN_TEST(test_get_balances_with_tips);
+
+  TEST_ASSERT(iota_consensus_destroy(&consensus) == RC_OK);
+
+  TEST_ASSERT(storage_destroy() == RC_OK);
+  return UNITY_END();
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/api/api.h"
+#include "common/model/milestone.h"
+#include "consensus/test_utils/bundle.h"
+#include "consensus/test_utils/tangle.h"
+#include "gossip/node.h"
+#include "utils/files.h"
+
+static char *test_db_path = "ciri/api/tests/test.db";
+static char *ciri_db_path = "ciri/api/tests/ciri.db";
+static connection_config_t config;
+static iota_api_t api;
+static node_t node;
+static tangle_t tangle;
+static iota_consensus_t consensus;
+static iota_transaction_t *txs[4];
+
+void setUp(void) {
+  TEST_ASSERT(tangle_setup(&tangle, &config, test_db_path, ciri_db_path) ==
+              RC_OK);
+}
+
+void tearDown(void) {
+  TEST_ASSERT(tangle_cleanup(&tangle, test_db_path) == RC_OK);
+}
+
+static void build_bundle_tangle() {
+  tryte_t const *const trytes[4] = {
+      TX_1_OF_4_VALUE_BUNDLE_TRYTES, TX_2_OF_4_VALUE_BUNDLE_TRYTES,
+      TX_3_OF_4_VALUE_BUNDLE_TRYTES, TX_4_OF_4_VALUE_BUNDLE_TRYTES};
+
+  transactions_deserialize(trytes, txs, 4, true);
+  TEST_ASSERT(build_tangle(&tangle, txs, 4) == RC_OK);
+}
+
+void test_get_inclusion_states_invalid_subtangle_status(void) {
+  get_inclusion_state_req_t *req = get_inclusion_state_req_new();
+  get_inclusion_state_res_t *res = get_inclusion_state_res_new();
+
+  TEST_ASSERT(iota_api_get_inclusion_states(&api, &tangle, req, res) ==
+              RC_API_INVALID_SUBTANGLE_STATUS);
+
+  get_inclusion_state_req_free(&req);
+  get_inclusion_state_res_free(&res);
+}
+
+void test_get_inclusion_states_missing_tip(void) {
+  get_inclusion_state_req_t *req = get_inclusion_state_req_new();
+  get_inclusion_state_res_t *res = get_inclusion_state_res_new();
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  flex_trits_from_trytes(hash, HASH_LENGTH_TRIT, TX_1_OF_4_HASH,
+                         HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  hash243_queue_push(&req->hashes, hash);
+  hash243_queue_push(&req->tips, hash);
+
+  TEST_ASSERT(iota_api_get_inclusion_states(&api, &tangle, req, res) ==
+              RC_API_TIP_MISSING);
+  TEST_ASSERT_EQUAL_INT(get_inclusion_state_res_bool_num(res), 0);
+
+  get_inclusion_state_req_free(&req);
+  get_inclusion_state_res_free(&res);
+}
+
+void test_get_inclusion_states_milestone_tip(void) {
+  get_inclusion_state_req_t *req = get_inclusion_state_req_new();
+  get_inclusion_state_res_t *res = get_inclusion_state_res_new();
+  iota_milestone_t milestone;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  build_bundle_tangle();
+  milestone.index = 42;
+  memcpy(milestone.hash, transaction_hash(txs[0]), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT(iota_tangle_milestone_store(&tangle, &milestone) == RC_OK);
+  for (size_t i = 0; i < 3; i++) {
+    TEST_ASSERT(iota_tangle_transaction_update_snapshot_index(
+                    &tangle, transaction_hash(txs[i]), 42) == RC_OK);
+  }
+
+  hash243_queue_push(&req->tips, transaction_hash(txs[0]));
+  hash243_queue_push(&req->hashes, transaction_hash(txs[1]));
+  hash243_queue_push(&req->hashes, transaction_hash(txs[2]));
+  hash243_queue_push(&req->hashes, transaction_hash(txs[3]));
+  flex_trits_from_trytes(hash, HASH_LENGTH_TRIT, TX_2_OF_4_ADDRESS,
+                         HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  hash243_queue_push(&req->hashes, hash);
+
+  TEST_ASSERT(iota_api_get_inclusion_states(&api, &tangle, req, res) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(get_inclusion_state_res_bool_num(res), 4);
+  TEST_ASSERT_TRUE(get_inclusion_state_res_bool_at(res, 0));
+  TEST_ASSERT_TRUE(get_inclusion_state_res_bool_at(res, 1));
+  TEST_ASSERT_FALSE(get_inclusion_state_res_bool_at(res, 2));
+  TEST_ASSERT_FALSE(get_inclusion_state_res_bool_at(res, 3));
+
+  get_inclusion_state_req_free(&req);
+  get_inclusion_state_res_free(&res);
+  transactions_free(txs, 4);
+}
+
+void test_get_inclusion_states_non_milestone_tip(void) {
+  get_inclusion_state_req_t *req = get_inclusion_state_req_new();
+  get_inclusion_state_res_t *res = get_inclusion_state_res_new();
+
+  build_bundle_tangle();
+
+  hash243_queue_push(&req->tips, transaction_hash(txs[0]));
+  hash243_queue_push(&req->hashes, transaction_hash(txs[3]));
+  hash243_queue_push(&req->hashes, transaction_hash(txs[2]));
+
+  TEST_ASSERT(iota_api_get_inclusion_states(&api, &tangle, req, res) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(get_inclusion_state_res_bool_num(res), 2);
+  TEST_ASSERT_TRUE(get_inclusion_state_res_bool_at(res, 0));
+  TEST_ASSERT_TRUE(get_inclusion_state_res_bool_at(res, 1));
+  get_inclusion_state_req_free(&req);
+  get_inclusion_state_res_free(&res);
+
+  req = get_inclusion_state_req_new();
+  res = get_inclusion_state_res_new();
+  hash243_queue_push(&req->tips, transaction_hash(txs[3]));
+  hash243_queue_push(&req->hashes, transaction_hash(txs[0]));
+
+  TEST_ASSERT(iota_api_get_inclusion_states(&api, &tangle, req, res) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(get_inclusion_state_res_bool_num(res), 1);
+  TEST_ASSERT_FALSE(get_inclusion_state_res_bool_at(res, 0));
+
+  get_inclusion_state_req_free(&req);
+  get_inclusion_state_res_free(&res);
+  transactions_free(txs, 4);
+}
+
+void test_get_inclusion_states_max_traversal(void) {
+  get_inclusion_state_req_t *req = get_inclusion_state_req_new();
+  get_inclusion_state_res_t *res = get_inclusion_state_res_new();
+
+  build_bundle_tangle();
+
+  hash243_queue_push(&req->tips, transaction_hash(txs[0]));
+  hash243_queue_push(&req->hashes, transaction_hash(txs[3]));
+
+  api.conf.max_inclusion_states_traversal = 2;
+  TEST_ASSERT(iota_api_get_inclusion_states(&api, &tangle, req, res) ==
+              RC_API_MAX_INCLUSION_STATES_TRAVERSAL);
+  api.conf.max_inclusion_states_traversal =
+      DEFAULT_MAX_INCLUSION_STATES_TRAVERSAL;
+
+  get_inclusion_state_req_free(&req);
+  get_inclusion_state_res_free(&res);
+  transactions_free(txs, 4);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  TEST_ASSERT(storage_init() == RC_OK);
+
+  config.db_path = test_db_path;
+  api.node = &node;
+  api.consensus = &consensus;
+
+  TEST_ASSERT(iota_api_conf_init(&api.conf) == RC_OK);
+  TEST_ASSERT(iota_gossip_conf_init(&api.node->conf) == RC_OK);
+  TEST_ASSERT(iota_consensus_conf_init(&api.consensus->conf) == RC_OK);
+  TEST_ASSERT(requester_init(&api.node->transaction_requester, api.node) ==
+              RC_OK);
+  TEST_ASSERT(tips_cache_init(&api.node->tips,
+                              api.node->conf.tips_cache_size) == RC_OK);
+
+  setUp();
+
+  // Avoid verifying snapshot signature
+  api.consensus->conf.snapshot_signature_file[0] = '\0';
+
+  TEST_ASSERT(iota_consensus_init(api.consensus, &tangle,
+                                  &api.node->transaction_requester,
+                                  &api.node->tips) == RC_OK);
+
+  tearDown();
+
+  RUN_TEST(test_get_inclusion_states_invalid_subtangle_status);
+
+  consensus.milestone_tracker.latest_solid_subtangle_milestone_index++;
+
+  RUN_TEST(test_get_inclusion_states_missing_tip);
+  RUN_TEST(test_get_inclusion_states_milestone_tip);
+  RUN_TEST(test_get_inclusion_states_non_milestone_tip);
+  RUN_TEST(test_get_inclusion_states_max_traversal);
+
+  TEST_ASSERT(iota_consensus_destroy(&consensus) == RC_OK);
+
+  TEST_ASSERT(storage_destroy() == RC_OK);
+  return UNITY_END();
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/api/api.h"
+#include "gossip/node.h"
+#include "utils/time.h"
+
+static iota_api_t api;
+static node_t node;
+
+/**
+ * Makes the score window of a neighbor end with a given traffic
+ */
+static void neighbor_window(neighbor_t *const neighbor, unsigned int const all,
+                            unsigned int const new_tx,
+                            unsigned int const invalid) {
+  neighbor->traffic.window_start_ms = current_timestamp_ms() - 20000;
+  neighbor->nbr_all_tx += all;
+  neighbor->nbr_new_tx += new_tx;
+  neighbor->nbr_invalid_tx += invalid;
+  neighbor->nbr_duplicate_tx += all - new_tx - invalid;
+}
+
+void test_get_neighbors(void) {
+  get_neighbors_res_t *res = get_neighbors_res_new();
+  neighbor_info_t *info = NULL;
+  neighbor_t *neighbor = node.neighbors;
+
+  neighbor->nbr_all_tx = 10;
+  neighbor->nbr_new_tx = 4;
+  neighbor->nbr_invalid_tx = 1;
+  neighbor->nbr_duplicate_tx = 5;
+  neighbor->nbr_sent_tx = 7;
+  neighbor->nbr_random_tx_req = 3;
+
+  TEST_ASSERT(iota_api_get_neighbors(&api, res) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(2, get_neighbors_res_num(res));
+
+  info = get_neighbors_res_neighbor_at(res, 0);
+  TEST_ASSERT_EQUAL_STRING("tcp://8.8.8.2:15002", info->address->data);
+  TEST_ASSERT_EQUAL_INT(10, info->all_trans_num);
+  TEST_ASSERT_EQUAL_INT(4, info->new_trans_num);
+  TEST_ASSERT_EQUAL_INT(1, info->invalid_trans_num);
+  TEST_ASSERT_EQUAL_INT(5, info->duplicate_trans_num);
+  TEST_ASSERT_EQUAL_INT(7, info->sent_trans_num);
+  TEST_ASSERT_EQUAL_INT(3, info->random_trans_req_num);
+  TEST_ASSERT_EQUAL_INT(0, info->dropped_trans_num);
+  TEST_ASSERT_TRUE(info->score == 1.0);
+  TEST_ASSERT_FALSE(info->throttled);
+  TEST_ASSERT_FALSE(info->disconnected);
+  TEST_ASSERT_EQUAL_INT(100, (int)info->trans_rate_limit);
+  TEST_ASSERT_EQUAL_INT(50, (int)info->req_rate_limit);
+  TEST_ASSERT_EQUAL_INT(0, (int)info->bytes_rate_limit);
+
+  info = get_neighbors_res_neighbor_at(res, 1);
+  TEST_ASSERT_EQUAL_STRING("udp://8.8.8.1:15001", info->address->data);
+  TEST_ASSERT_EQUAL_INT(0, info->all_trans_num);
+
+  get_neighbors_res_free(res);
+}
+
+void test_get_neighbors_rate_limited(void) {
+  get_neighbors_res_t *res = get_neighbors_res_new();
+  neighbor_info_t *info = NULL;
+  neighbor_t *neighbor = node.neighbors->next;
+  size_t admitted = 0;
+
+  // A full second worth of packets is admitted in a burst
+  for (size_t i = 0; i < 200; i++) {
+    admitted += neighbor_admit_packet(neighbor, &node.conf);
+  }
+  TEST_ASSERT_TRUE(admitted >= 100 && admitted < 110);
+  for (size_t i = 0; i < 200; i++) {
+    neighbor_admit_request(neighbor, &node.conf);
+  }
+
+  TEST_ASSERT(iota_api_get_neighbors(&api, res) == RC_OK);
+  info = get_neighbors_res_neighbor_at(res, 1);
+  TEST_ASSERT_EQUAL_INT(200 - admitted, info->dropped_trans_num);
+  TEST_ASSERT_TRUE(info->dropped_req_num >= 140);
+
+  get_neighbors_res_free(res);
+}
+
+void test_get_neighbors_honest_mesh(void) {
+  neighbor_t *neighbor = node.neighbors;
+  neighbor_traffic_status_t status;
+
+  // Starts the first window
+  neighbor_admit_packet(neighbor, &node.conf);
+
+  // In a mesh of 8 neighbors an honest one is the first to relay about one
+  // transaction out of 8, the others are duplicates
+  for (size_t i = 0; i < 10; i++) {
+    neighbor_window(neighbor, 800, 100, 0);
+    neighbor_admit_packet(neighbor, &node.conf);
+    neighbor_traffic_status(neighbor, &node.conf, &status);
+    TEST_ASSERT_EQUAL_INT(NEIGHBOR_ACTIVE, status.state);
+  }
+  TEST_ASSERT_TRUE(status.score > 0.99);
+  TEST_ASSERT_EQUAL_INT(node.conf.neighbor_packets_rate,
+                        (int)status.packets_rate);
+
+  // An occasional invalid transaction does not throttle it either
+  neighbor_window(neighbor, 800, 100, 8);
+  neighbor_admit_packet(neighbor, &node.conf);
+  neighbor_traffic_status(neighbor, &node.conf, &status);
+  TEST_ASSERT_EQUAL_INT(NEIGHBOR_ACTIVE, status.state);
+}
+
+void test_get_neighbors_scored(void) {
+  get_neighbors_res_t *res = get_neighbors_res_new();
+  neighbor_info_t *info = NULL;
+  neighbor_t *neighbor = node.neighbors;
+
+  // Starts the first window
+  neighbor_admit_packet(neighbor, &node.conf);
+
+
+  // Invalid transactions throttle then disconnect it
+  neighbor_window(neighbor, 100, 0, 100);
+  neighbor_admit_packet(neighbor, &node.conf);
+  neighbor_window(neighbor, 100, 0, 100);
+  neighbor_admit_packet(neighbor, &node.conf);
+  TEST_ASSERT_EQUAL_INT(NEIGHBOR_THROTTLED, neighbor->traffic.state);
+
+  TEST_ASSERT(iota_api_get_neighbors(&api, res) == RC_OK);
+  info = get_neighbors_res_neighbor_at(res, 0);
+  TEST_ASSERT_TRUE(info->throttled);
+  TEST_ASSERT_TRUE(info->score < 0.5);
+  TEST_ASSERT_TRUE(info->trans_rate_limit < 50);
+  get_neighbors_res_free(res);
+
+  neighbor_window(neighbor, 100, 0, 100);
+  neighbor_admit_packet(neighbor, &node.conf);
+  neighbor_window(neighbor, 100, 0, 100);
+  TEST_ASSERT_FALSE(neighbor_admit_packet(neighbor, &node.conf));
+  TEST_ASSERT_EQUAL_INT(NEIGHBOR_DISCONNECTED, neighbor->traffic.state);
+  TEST_ASSERT_FALSE(neighbor_admit_request(neighbor, &node.conf));
+
+  // Back on probation once the disconnection is over
+  neighbor->traffic.disconnected_until_ms = current_timestamp_ms();
+  TEST_ASSERT_TRUE(neighbor_admit_packet(neighbor, &node.conf));
+  TEST_ASSERT_EQUAL_INT(NEIGHBOR_THROTTLED, neighbor->traffic.state);
+
+  res = get_neighbors_res_new();
+  TEST_ASSERT(iota_api_get_neighbors(&api, res) == RC_OK);
+  info = get_neighbors_res_neighbor_at(res, 0);
+  TEST_ASSERT_TRUE(info->throttled);
+  TEST_ASSERT_FALSE(info->disconnected);
+  TEST_ASSERT_TRUE(info->score == node.conf.neighbor_throttle_score);
+  get_neighbors_res_free(res);
+}
+
+int main(void) {
+  neighbor_t neighbor;
+
+  UNITY_BEGIN();
+
+  api.node = &node;
+  node.conf.neighbor_packets_rate = 100;
+  node.conf.neighbor_requests_rate = 50;
+  node.conf.neighbor_bytes_rate = 0;
+  node.conf.neighbor_throttle_score = 0.5;
+  node.conf.neighbor_disconnect_score = 0.1;
+
+  node.neighbors = NULL;
+  rw_lock_handle_init(&node.neighbors_lock);
+  TEST_ASSERT(neighbor_init_with_uri(&neighbor, "udp://8.8.8.1:15001") ==
+              RC_OK);
+  TEST_ASSERT(neighbors_add(&node.neighbors, &neighbor) == RC_OK);
+  TEST_ASSERT(neighbor_init_with_uri(&neighbor, "tcp://8.8.8.2:15002") ==
+              RC_OK);
+  TEST_ASSERT(neighbors_add(&node.neighbors, &neighbor) == RC_OK);
+
+  RUN_TEST(test_get_neighbors);
+  RUN_TEST(test_get_neighbors_rate_limited);
+  RUN_TEST(test_get_neighbors_honest_mesh);
+  RUN_TEST(test_get_neighbors_scored);
+
+  neighbors_free(&node.neighbors);
+  rw_lock_handle_destroy(&node.neighbors_lock);
+
+  return UNITY_END();
+}
@@ -140,11 +140,15 @@ int main(void) {
 
   // Adding broadcasts
 
-  flex_trit_t to_broadcast[FLEX_TRIT_SIZE_8019];
-  TEST_ASSERT(broadcaster_on_next(&node.broadcaster, to_broadcast) == RC_OK);
-  TEST_ASSERT(broadcaster_on_next(&node.broadcaster, to_broadcast) == RC_OK);
-  TEST_ASSERT(broadcaster_on_next(&node.broadcaster, to_broadcast) == RC_OK);
-  TEST_ASSERT(broadcaster_on_next(&node.broadcaster, to_broadcast) == RC_OK);
+  byte_t to_broadcast[PACKET_TX_SIZE] = {0};
+  TEST_ASSERT(broadcaster_on_next(&node.broadcaster, to_broadcast,
+                                  GOSSIP_PRIORITY_NORMAL) == RC_OK);
+  TEST_ASSERT(broadcaster_on_next(&node.broadcaster, to_broadcast,
+                                  GOSSIP_PRIORITY_NORMAL) == RC_OK);
+  TEST_ASSERT(broadcaster_on_next(&node.broadcaster, to_broadcast,
+                                  GOSSIP_PRIORITY_NORMAL) == RC_OK);
+  TEST_ASSERT(broadcaster_on_next(&node.broadcaster, to_broadcast,
+                                  GOSSIP_PRIORITY_NORMAL) == RC_OK);
 
   RUN_TEST(test_get_node_info);
 
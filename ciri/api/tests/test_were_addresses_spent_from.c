@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/api/api.h"
+#include "consensus/test_utils/bundle.h"
+#include "consensus/test_utils/tangle.h"
+#include "gossip/node.h"
+#include "utils/files.h"
+
+static char *test_db_path = "ciri/api/tests/test.db";
+static char *ciri_db_path = "ciri/api/tests/ciri.db";
+static connection_config_t config;
+static iota_api_t api;
+static node_t node;
+static tangle_t tangle;
+static iota_consensus_t consensus;
+
+void setUp(void) {
+  TEST_ASSERT(tangle_setup(&tangle, &config, test_db_path, ciri_db_path) ==
+              RC_OK);
+}
+
+void tearDown(void) {
+  TEST_ASSERT(tangle_cleanup(&tangle, test_db_path) == RC_OK);
+}
+
+void test_were_addresses_spent_from_empty(void) {
+  were_addresses_spent_from_req_t *req = were_addresses_spent_from_req_new();
+  were_addresses_spent_from_res_t *res = were_addresses_spent_from_res_new();
+
+  TEST_ASSERT(iota_api_were_addresses_spent_from(&api, &tangle, req, res) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(were_addresses_spent_from_res_states_num(res), 0);
+
+  were_addresses_spent_from_req_free(&req);
+  were_addresses_spent_from_res_free(&res);
+}
+
+void test_were_addresses_spent_from(void) {
+  were_addresses_spent_from_req_t *req = were_addresses_spent_from_req_new();
+  were_addresses_spent_from_res_t *res = were_addresses_spent_from_res_new();
+  flex_trit_t spent[FLEX_TRIT_SIZE_243];
+  flex_trit_t not_spent[FLEX_TRIT_SIZE_243];
+
+  flex_trits_from_trytes(spent, HASH_LENGTH_TRIT, TX_2_OF_4_ADDRESS,
+                         HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  flex_trits_from_trytes(not_spent, HASH_LENGTH_TRIT, TX_1_OF_4_HASH,
+                         HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  hash243_queue_push(&req->addresses, not_spent);
+  hash243_queue_push(&req->addresses, spent);
+
+  TEST_ASSERT(iota_api_were_addresses_spent_from(&api, &tangle, req, res) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(were_addresses_spent_from_res_states_num(res), 2);
+  TEST_ASSERT_FALSE(were_addresses_spent_from_res_states_at(res, 0));
+  TEST_ASSERT_FALSE(were_addresses_spent_from_res_states_at(res, 1));
+  were_addresses_spent_from_res_free(&res);
+
+  TEST_ASSERT(iota_spent_addresses_provider_store(
+                  &consensus.spent_addresses_provider, &tangle, spent) ==
+              RC_OK);
+
+  res = were_addresses_spent_from_res_new();
+  TEST_ASSERT(iota_api_were_addresses_spent_from(&api, &tangle, req, res) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(were_addresses_spent_from_res_states_num(res), 2);
+  TEST_ASSERT_FALSE(were_addresses_spent_from_res_states_at(res, 0));
+  TEST_ASSERT_TRUE(were_addresses_spent_from_res_states_at(res, 1));
+
+  were_addresses_spent_from_req_free(&req);
+  were_addresses_spent_from_res_free(&res);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  TEST_ASSERT(storage_init() == RC_OK);
+
+  config.db_path = test_db_path;
+  api.node = &node;
+  api.consensus = &consensus;
+
+  TEST_ASSERT(iota_gossip_conf_init(&api.node->conf) == RC_OK);
+  TEST_ASSERT(iota_consensus_conf_init(&api.consensus->conf) == RC_OK);
+  TEST_ASSERT(requester_init(&api.node->transaction_requester, api.node) ==
+              RC_OK);
+  TEST_ASSERT(tips_cache_init(&api.node->tips,
+                              api.node->conf.tips_cache_size) == RC_OK);
+
+  setUp();
+
+  // Avoid verifying snapshot signature
+  api.consensus->conf.snapshot_signature_file[0] = '\0';
+
+  TEST_ASSERT(iota_consensus_init(api.consensus, &tangle,
+                                  &api.node->transaction_requester,
+                                  &api.node->tips) == RC_OK);
+
+  tearDown();
+
+  RUN_TEST(test_were_addresses_spent_from_empty);
+  RUN_TEST(test_were_addresses_spent_from);
+
+  TEST_ASSERT(iota_consensus_destroy(&consensus) == RC_OK);
+
+  TEST_ASSERT(storage_destroy() == RC_OK);
+  return UNITY_END();
+}
@@ -91,13 +91,34 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf,
     case 'l':  // --log-level
       ciri_conf->log_level = get_log_level(value);
       break;
+    case CONF_TANGLE_CACHE_SIZE:  // --tangle-cache-size
+      ciri_conf->tangle_cache_size = atol(value);
+      break;
 
     // Gossip configuration
+    case CONF_GOSSIP_QUEUE_SIZE:  // --gossip-queue-size
+      gossip_conf->gossip_queue_size = atoi(value);
+      break;
     case CONF_MWM:  // --mwm
       gossip_conf->mwm = atoi(value);
       gossip_conf->request_hash_size_trit = HASH_LENGTH_TRIT - gossip_conf->mwm;
       consensus_conf->mwm = atoi(value);
       break;
+    case CONF_NEIGHBOR_BYTES_RATE:  // --neighbor-bytes-rate
+      gossip_conf->neighbor_bytes_rate = atoi(value);
+      break;
+    case CONF_NEIGHBOR_DISCONNECT_SCORE:  // --neighbor-disconnect-score
+      gossip_conf->neighbor_disconnect_score = atof(value);
+      break;
+    case CONF_NEIGHBOR_PACKETS_RATE:  // --neighbor-packets-rate
+      gossip_conf->neighbor_packets_rate = atoi(value);
+      break;
+    case CONF_NEIGHBOR_REQUESTS_RATE:  // --neighbor-requests-rate
+      gossip_conf->neighbor_requests_rate = atoi(value);
+      break;
+    case CONF_NEIGHBOR_THROTTLE_SCORE:  // --neighbor-throttle-score
+      gossip_conf->neighbor_throttle_score = atof(value);
+      break;
     case 'n':  // --neighbors
       gossip_conf->neighbors = strdup(value);
       break;
@@ -116,6 +137,13 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf,
     case CONF_P_SEND_MILESTONE:  // --p-send-milestone
       gossip_conf->p_send_milestone = atof(value);
       break;
+    case CONF_PACKET_CACHE_SIZE:  // --packet-cache-size
+      gossip_conf->packet_cache_size = atoi(value);
+      break;
+    case CONF_PACKET_COMPRESSION:  // --packet-compression
+      gossip_conf->packet_compression =
+          value == NULL || strcmp(value, "false") != 0;
+      break;
     case CONF_REQUESTER_QUEUE_SIZE:  // --requester-queue-size
       gossip_conf->requester_queue_size = atoi(value);
       break;
@@ -136,6 +164,9 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf,
     case CONF_MAX_GET_TRYTES:  // --max-get-trytes
       api_conf->max_get_trytes = atoi(value);
       break;
+    case CONF_MAX_INCLUSION_STATES_TRAVERSAL:  // --max-inclusion-states-traversal
+      api_conf->max_inclusion_states_traversal = atoi(value);
+      break;
     case 'p':  // --port
       api_conf->port = atoi(value);
       break;
@@ -158,6 +189,23 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf,
     case CONF_LAST_MILESTONE:  // --last-milestone
       consensus_conf->last_milestone = atoi(value);
       break;
+    case CONF_LEDGER_CHECKPOINT_INTERVAL:  // --ledger-checkpoint-interval
+      consensus_conf->ledger_checkpoint_interval = atoi(value);
+      break;
+    case CONF_LOCAL_SNAPSHOTS:  // --local-snapshots
+      consensus_conf->local_snapshots_enabled =
+          value == NULL || strcmp(value, "false") != 0;
+      break;
+    case CONF_LOCAL_SNAPSHOTS_DEPTH:  // --local-snapshots-depth
+      consensus_conf->local_snapshots_depth = atoi(value);
+      break;
+    case CONF_LOCAL_SNAPSHOTS_INTERVAL:  // --local-snapshots-interval
+      consensus_conf->local_snapshots_interval = atoi(value);
+      break;
+    case CONF_LOCAL_SNAPSHOTS_PATH:  // --local-snapshots-path
+      strncpy(consensus_conf->local_snapshots_path, value,
+              sizeof(consensus_conf->local_snapshots_path));
+      break;
     case CONF_MAX_DEPTH:  // --max-depth
       consensus_conf->max_depth = atoi(value);
       break;
@@ -212,6 +260,7 @@ retcode_t iota_ciri_conf_default(iota_ciri_conf_t* const ciri_conf,
 
   ciri_conf->log_level = DEFAULT_LOG_LEVEL;
   strncpy(ciri_conf->db_path, DEFAULT_DB_PATH, sizeof(ciri_conf->db_path));
+  ciri_conf->tangle_cache_size = DEFAULT_TANGLE_CACHE_SIZE;
   strncpy(consensus_conf->db_path, DEFAULT_DB_PATH,
           sizeof(consensus_conf->db_path));
   strncpy(gossip_conf->db_path, DEFAULT_DB_PATH, sizeof(gossip_conf->db_path));
@@ -18,6 +18,7 @@
 
 #define DEFAULT_LOG_LEVEL LOGGER_INFO
 #define DEFAULT_DB_PATH DB_PATH
+#define DEFAULT_TANGLE_CACHE_SIZE 10000
 
 #ifdef __cplusplus
 extern "C" {
@@ -31,6 +32,8 @@ typedef struct iota_ciri_conf_s {
   logger_level_t log_level;
   // Path of the DB file
   char db_path[128];
+  // Maximum number of decoded transactions cached for all tangle connections
+  size_t tangle_cache_size;
 } iota_ciri_conf_t;
 
 /**
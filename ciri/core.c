@@ -20,6 +20,12 @@ retcode_t core_init(core_t* const core, tangle_t* const tangle) {
   logger_id = logger_helper_enable(CORE_LOGGER_ID, LOGGER_DEBUG, true);
   core->running = false;
 
+  log_info(logger_id, "Initializing executor\n");
+  if (executor_init(&core->executor, 0) != RC_OK) {
+    log_critical(logger_id, "Initializing executor failed\n");
+    return RC_CORE_FAILED_EXECUTOR_INIT;
+  }
+
   log_info(logger_id, "Initializing consensus\n");
   if (iota_consensus_init(&core->consensus, tangle,
                           &core->node.transaction_requester,
@@ -49,8 +55,15 @@ retcode_t core_start(core_t* const core, tangle_t* const tangle) {
     return RC_CORE_NULL_CORE;
   }
 
+  log_info(logger_id, "Starting executor\n");
+  if (executor_start(&core->executor) != RC_OK) {
+    log_critical(logger_id, "Starting executor failed\n");
+    return RC_CORE_FAILED_EXECUTOR_START;
+  }
+
   log_info(logger_id, "Starting consensus\n");
-  if (iota_consensus_start(&core->consensus, tangle) != RC_OK) {
+  if (iota_consensus_start(&core->consensus, tangle, &core->executor) !=
+      RC_OK) {
     log_critical(logger_id, "Starting consensus failed\n");
     return RC_CORE_FAILED_CONSENSUS_START;
   }
@@ -98,7 +111,14 @@ retcode_t core_stop(core_t* const core) {
   log_info(logger_id, "Stopping consensus\n");
   if (iota_consensus_stop(&core->consensus) != RC_OK) {
     log_critical(logger_id, "Stopping consensus failed\n");
-    return RC_CORE_FAILED_CONSENSUS_STOP;
+    ret = RC_CORE_FAILED_CONSENSUS_STOP;
+  }
+
+  // Components have cancelled their tasks
+  log_info(logger_id, "Stopping executor\n");
+  if (executor_stop(&core->executor) != RC_OK) {
+    log_error(logger_id, "Stopping executor failed\n");
+    ret = RC_CORE_FAILED_EXECUTOR_STOP;
   }
 
   return ret;
@@ -131,6 +151,12 @@ retcode_t core_destroy(core_t* const core) {
     ret = RC_CORE_FAILED_CONSENSUS_DESTROY;
   }
 
+  log_info(logger_id, "Destroying executor\n");
+  if (executor_destroy(&core->executor) != RC_OK) {
+    log_error(logger_id, "Destroying executor failed\n");
+    ret = RC_CORE_FAILED_EXECUTOR_DESTROY;
+  }
+
   logger_helper_release(logger_id);
   return ret;
 }
@@ -13,6 +13,7 @@
 #include "consensus/consensus.h"
 #include "gossip/components/transaction_requester.h"
 #include "gossip/node.h"
+#include "utils/handles/executor.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,6 +22,8 @@ extern "C" {
 typedef struct core_s {
   bool running;
   iota_ciri_conf_t conf;
+  // Runs the tasks of the consensus and node components
+  executor_t executor;
   iota_consensus_t consensus;
   iota_node_t node;
   iota_api_t api;
@@ -5,6 +5,7 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -75,6 +76,12 @@ int main(int argc, char* argv[]) {
     return EXIT_FAILURE;
   }
 
+  log_info(logger_id, "Initializing tangle cache\n");
+  if (iota_tangle_cache_init(ciri_core.conf.tangle_cache_size) != RC_OK) {
+    log_critical(logger_id, "Initializing tangle cache failed\n");
+    return EXIT_FAILURE;
+  }
+
   db_conf.db_path = ciri_core.conf.db_path;
   if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
     log_critical(logger_id, "Initializing tangle connection failed\n");
@@ -94,6 +101,8 @@ int main(int argc, char* argv[]) {
   }
 
   size_t count = 0;
+  transaction_cache_stats_t cache_stats;
+  transaction_solidifier_stats_t solidifier_stats;
   while (ciri_core.running) {
     if (iota_tangle_transaction_count(&tangle, &count) != RC_OK) {
       ret = EXIT_FAILURE;
@@ -106,6 +115,24 @@ int main(int argc, char* argv[]) {
              broadcaster_size(&ciri_core.node.broadcaster),
              requester_size(&ciri_core.node.transaction_requester),
              responder_size(&ciri_core.node.responder), count);
+    iota_tangle_cache_stats(&cache_stats);
+    log_info(logger_id,
+             "Tangle cache: size %zu, hits %" PRIu64 ", misses %" PRIu64
+             ", evictions %" PRIu64 "\n",
+             cache_stats.size, cache_stats.hits, cache_stats.misses,
+             cache_stats.evictions);
+    iota_consensus_transaction_solidifier_stats(
+        &ciri_core.consensus.transaction_solidifier, &solidifier_stats);
+    log_info(logger_id,
+             "Solidifier: frontier %zu, evictions %" PRIu64
+             ", milestones solid %" PRIu64 " after last arrival avg %" PRIu64
+             " us max %" PRIu64 " us\n",
+             solidifier_stats.frontier_size, solidifier_stats.evictions,
+             solidifier_stats.milestones,
+             solidifier_stats.milestones ? solidifier_stats.total_latency_us /
+                                               solidifier_stats.milestones
+                                         : 0,
+             solidifier_stats.max_latency_us);
     sleep(STATS_LOG_INTERVAL_S);
   }
 
@@ -115,6 +142,11 @@ int main(int argc, char* argv[]) {
     ret = EXIT_FAILURE;
   }
 
+  if (iota_tangle_cache_destroy() != RC_OK) {
+    log_error(logger_id, "Destroying tangle cache failed\n");
+    ret = EXIT_FAILURE;
+  }
+
   log_info(logger_id, "Destroying storage\n");
   if (storage_destroy() != RC_OK) {
     log_error(logger_id, "Destroying storage failed\n");
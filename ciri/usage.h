@@ -13,14 +13,26 @@
 typedef enum cli_arg_value_e {
   CONF_START = 1000,
 
+  // cIRI configuration
+
+  CONF_TANGLE_CACHE_SIZE,
+
   // Gossip configuration
 
+  CONF_GOSSIP_QUEUE_SIZE,
   CONF_MWM,
+  CONF_NEIGHBOR_BYTES_RATE,
+  CONF_NEIGHBOR_DISCONNECT_SCORE,
+  CONF_NEIGHBOR_PACKETS_RATE,
+  CONF_NEIGHBOR_REQUESTS_RATE,
+  CONF_NEIGHBOR_THROTTLE_SCORE,
   CONF_P_PROPAGATE_REQUEST,
   CONF_P_REMOVE_REQUEST,
   CONF_P_REPLY_RANDOM_TIP,
   CONF_P_SELECT_MILESTONE,
   CONF_P_SEND_MILESTONE,
+  CONF_PACKET_CACHE_SIZE,
+  CONF_PACKET_COMPRESSION,
   CONF_REQUESTER_QUEUE_SIZE,
   CONF_TIPS_CACHE_SIZE,
 
@@ -28,6 +40,7 @@ typedef enum cli_arg_value_e {
 
   CONF_MAX_FIND_TRANSACTIONS,
   CONF_MAX_GET_TRYTES,
+  CONF_MAX_INCLUSION_STATES_TRAVERSAL,
 
   // Consensus configuration
 
@@ -35,6 +48,11 @@ typedef enum cli_arg_value_e {
   CONF_BELOW_MAX_DEPTH,
   CONF_COORDINATOR,
   CONF_LAST_MILESTONE,
+  CONF_LEDGER_CHECKPOINT_INTERVAL,
+  CONF_LOCAL_SNAPSHOTS,
+  CONF_LOCAL_SNAPSHOTS_DEPTH,
+  CONF_LOCAL_SNAPSHOTS_INTERVAL,
+  CONF_LOCAL_SNAPSHOTS_PATH,
   CONF_MAX_DEPTH,
   CONF_NUM_KEYS_IN_MILESTONE,
   CONF_SNAPSHOT_FILE,
@@ -68,13 +86,43 @@ static struct cli_argument_s {
      "\"error\", \"critical\", \"alert\" "
      "and \"emergency\".",
      REQUIRED_ARG},
+    {"tangle-cache-size", CONF_TANGLE_CACHE_SIZE,
+     "Maximum number of decoded transactions cached in memory and shared by "
+     "all components. 0 disables the cache.",
+     REQUIRED_ARG},
 
     // Gossip configuration
 
+    {"gossip-queue-size", CONF_GOSSIP_QUEUE_SIZE,
+     "Maximum number of entries in each of the processor, broadcaster and "
+     "responder queues. When full, regular transactions are dropped in favor "
+     "of milestones, local transactions and specific requests. 0 for no "
+     "limit.",
+     REQUIRED_ARG},
     {"mwm", CONF_MWM,
      "Number of trailing ternary 0s that must appear at the end of a "
      "transaction hash. Difficulty can be described as 3^mwm.",
      REQUIRED_ARG},
+    {"neighbor-bytes-rate", CONF_NEIGHBOR_BYTES_RATE,
+     "Maximum number of bytes per second sent to a neighbor. 0 for no limit.",
+     REQUIRED_ARG},
+    {"neighbor-disconnect-score", CONF_NEIGHBOR_DISCONNECT_SCORE,
+     "Score under which a neighbor is disconnected for a minute. The score "
+     "measures the share of valid transactions sent by a neighbor, duplicates "
+     "included. Value must be in [0,1].",
+     REQUIRED_ARG},
+    {"neighbor-packets-rate", CONF_NEIGHBOR_PACKETS_RATE,
+     "Maximum number of packets per second accepted from a neighbor. 0 for no "
+     "limit.",
+     REQUIRED_ARG},
+    {"neighbor-requests-rate", CONF_NEIGHBOR_REQUESTS_RATE,
+     "Maximum number of requests per second answered to a neighbor. 0 for no "
+     "limit.",
+     REQUIRED_ARG},
+    {"neighbor-throttle-score", CONF_NEIGHBOR_THROTTLE_SCORE,
+     "Score under which the packets and requests rate limits of a neighbor are "
+     "scaled down by its score. Value must be in [0,1].",
+     REQUIRED_ARG},
     {"neighbors", 'n', "URIs of neighbouring nodes, separated by a space.",
      REQUIRED_ARG},
     {"p-propagate-request", CONF_P_PROPAGATE_REQUEST,
@@ -99,6 +147,15 @@ static struct cli_argument_s {
      "Probability of sending a milestone transaction when the node looks for a "
      "random transaction to send to a neighbor. Value must be in [0,1].",
      REQUIRED_ARG},
+    {"packet-cache-size", CONF_PACKET_CACHE_SIZE,
+     "Maximum number of transactions kept in their wire encoding to answer "
+     "neighbors requests without a database lookup. 0 disables the cache.",
+     REQUIRED_ARG},
+    {"packet-compression", CONF_PACKET_COMPRESSION,
+     "Offers TCP neighbors to send compressed packets, leaving out the "
+     "trailing zeros of the signature or message fragment. Neighbors not "
+     "supporting it keep sending fixed-size packets.",
+     NO_ARG},
     {"requester-queue-size", CONF_REQUESTER_QUEUE_SIZE,
      "Size of the transaction requester queue.", REQUIRED_ARG},
     {"tcp-receiver-port", 't', "TCP listen port.", REQUIRED_ARG},
@@ -119,6 +176,10 @@ static struct cli_argument_s {
      "Maximum number of transactions that will be returned by the 'getTrytes' "
      "API call.",
      REQUIRED_ARG},
+    {"max-inclusion-states-traversal", CONF_MAX_INCLUSION_STATES_TRAVERSAL,
+     "Maximum number of transactions that may be traversed by the "
+     "'getInclusionStates' API call when some tips are not milestones.",
+     REQUIRED_ARG},
     {"port", 'p', "HTTP API listen port.", REQUIRED_ARG},
 
     // Consensus configuration
@@ -138,6 +199,25 @@ static struct cli_argument_s {
      "The index of the last milestone issued by the corrdinator before the "
      "last snapshot.",
      REQUIRED_ARG},
+    {"ledger-checkpoint-interval", CONF_LEDGER_CHECKPOINT_INTERVAL,
+     "Number of new solid milestones between two checkpoints of the ledger "
+     "state, loaded at startup instead of replaying every milestone. 0 "
+     "disables checkpoints.",
+     REQUIRED_ARG},
+    {"local-snapshots", CONF_LOCAL_SNAPSHOTS,
+     "Takes local snapshots of the ledger and prunes the transactions they "
+     "confirm.",
+     NO_ARG},
+    {"local-snapshots-depth", CONF_LOCAL_SNAPSHOTS_DEPTH,
+     "Number of milestones kept below the latest solid milestone when taking "
+     "a local snapshot. Must be greater than max-depth.",
+     REQUIRED_ARG},
+    {"local-snapshots-interval", CONF_LOCAL_SNAPSHOTS_INTERVAL,
+     "Number of new solid milestones between two local snapshots.",
+     REQUIRED_ARG},
+    {"local-snapshots-path", CONF_LOCAL_SNAPSHOTS_PATH,
+     "Path of the local snapshot file, loaded at startup when it exists.",
+     REQUIRED_ARG},
     {"max-depth", CONF_MAX_DEPTH,
      "Limits how many milestones behind the current one the random walk can "
      "start.",
@@ -64,6 +64,9 @@ extern "C" {
 #define RC_MODULE_CONSENSUS_SNAPSHOT (0x0D << RC_SHIFT_MODULE)
 #define RC_MODULE_LEDGER_VALIDATOR (0x0E << RC_SHIFT_MODULE)
 #define RC_MODULE_CONSENSUS_TIP_SELECTOR (0x0F << RC_SHIFT_MODULE)
+#define RC_MODULE_CONSENSUS_SPENT_ADDRESSES_PROVIDER (0x10 << RC_SHIFT_MODULE)
+#define RC_MODULE_CONSENSUS_LOCAL_SNAPSHOTS (0x11 << RC_SHIFT_MODULE)
+#define RC_MODULE_CONSENSUS_LEDGER_CHECKPOINTER (0x12 << RC_SHIFT_MODULE)
 
 #define RC_MODULE_UTILS (0xA1 << RC_SHIFT_MODULE)
 
@@ -176,6 +179,10 @@ enum retcode_t {
       0x12 | RC_MODULE_STORAGE_SQLITE3 | RC_SEVERITY_FATAL,
   RC_SQLITE3_FAILED_SHUTDOWN =
       0x13 | RC_MODULE_STORAGE_SQLITE3 | RC_SEVERITY_FATAL,
+  RC_SQLITE3_FAILED_MIGRATION =
+      0x14 | RC_MODULE_STORAGE_SQLITE3 | RC_SEVERITY_FATAL,
+  RC_SQLITE3_UNSUPPORTED_SCHEMA_VERSION =
+      0x15 | RC_MODULE_STORAGE_SQLITE3 | RC_SEVERITY_FATAL,
 
   // Storage SQL Module
   RC_SQL_FAILED_WRITE_STATEMENT =
@@ -214,6 +221,11 @@ enum retcode_t {
   RC_CORE_FAILED_CONSENSUS_START = 0x16 | RC_MODULE_CORE | RC_SEVERITY_FATAL,
   RC_CORE_FAILED_CONSENSUS_STOP = 0x17 | RC_MODULE_CORE | RC_SEVERITY_FATAL,
   RC_CORE_FAILED_CONSENSUS_DESTROY = 0x18 | RC_MODULE_CORE | RC_SEVERITY_FATAL,
+  RC_CORE_FAILED_EXECUTOR_INIT = 0x19 | RC_MODULE_CORE | RC_SEVERITY_FATAL,
+  RC_CORE_FAILED_EXECUTOR_START = 0x1A | RC_MODULE_CORE | RC_SEVERITY_FATAL,
+  RC_CORE_FAILED_EXECUTOR_STOP = 0x1B | RC_MODULE_CORE | RC_SEVERITY_MODERATE,
+  RC_CORE_FAILED_EXECUTOR_DESTROY =
+      0x1C | RC_MODULE_CORE | RC_SEVERITY_MODERATE,
 
   // Node Module
   RC_NODE_NULL_NODE = 0x01 | RC_MODULE_NODE | RC_SEVERITY_FATAL,
@@ -379,6 +391,8 @@ enum retcode_t {
       0x01 | RC_MODULE_GOSSIP | RC_SEVERITY_MODERATE,
   RC_GOSSIP_SET_PACKET_REQUEST_FAILED =
       0x02 | RC_MODULE_GOSSIP | RC_SEVERITY_MODERATE,
+  RC_GOSSIP_INVALID_COMPRESSED_PACKET =
+      0x03 | RC_MODULE_GOSSIP | RC_SEVERITY_MODERATE,
 
   // Conf Module
   RC_CIRI_CONF_NULL_CONF = 0x01 | RC_MODULE_CIRI_CONF | RC_SEVERITY_FATAL,
@@ -409,6 +423,11 @@ enum retcode_t {
   RC_API_INVALID_SUBTANGLE_STATUS = 0x06 | RC_MODULE_API | RC_SEVERITY_MODERATE,
   RC_API_TAIL_MISSING = 0x07 | RC_MODULE_API | RC_SEVERITY_MODERATE,
   RC_API_NOT_TAIL = 0x08 | RC_MODULE_API | RC_SEVERITY_MODERATE,
+  RC_API_INVALID_THRESHOLD = 0x09 | RC_MODULE_API | RC_SEVERITY_MODERATE,
+  RC_API_TIP_MISSING = 0x0A | RC_MODULE_API | RC_SEVERITY_MODERATE,
+  RC_API_TIPS_NOT_CONSISTENT = 0x0B | RC_MODULE_API | RC_SEVERITY_MODERATE,
+  RC_API_MAX_INCLUSION_STATES_TRAVERSAL =
+      0x0C | RC_MODULE_API | RC_SEVERITY_MODERATE,
 
   // Snapshot Module
   RC_SNAPSHOT_NULL_SELF =
@@ -436,6 +455,10 @@ enum retcode_t {
       0x0C | RC_MODULE_CONSENSUS_SNAPSHOT | RC_SEVERITY_FATAL,
   RC_SNAPSHOT_FAILED_JSON_PARSING =
       0x0D | RC_MODULE_CONSENSUS_SNAPSHOT | RC_SEVERITY_FATAL,
+  RC_SNAPSHOT_FAILED_WRITING_FILE =
+      0x0E | RC_MODULE_CONSENSUS_SNAPSHOT | RC_SEVERITY_MAJOR,
+  RC_SNAPSHOT_INVALID_SERIALIZED_DELTA =
+      0x0F | RC_MODULE_CONSENSUS_SNAPSHOT | RC_SEVERITY_MAJOR,
 
   // Ledger Validator Module
   RC_LEDGER_VALIDATOR_NULL_PTR =
@@ -457,6 +480,38 @@ enum retcode_t {
   RC_TIP_SELECTOR_REFERENCE_TOO_OLD =
       0x02 | RC_MODULE_CONSENSUS_TIP_SELECTOR | RC_SEVERITY_MODERATE,
 
+  // Spent Addresses Provider Module
+  RC_SPENT_ADDRESSES_PROVIDER_NULL_SELF =
+      0x01 | RC_MODULE_CONSENSUS_SPENT_ADDRESSES_PROVIDER | RC_SEVERITY_FATAL,
+  RC_SPENT_ADDRESSES_PROVIDER_OOM =
+      0x02 | RC_MODULE_CONSENSUS_SPENT_ADDRESSES_PROVIDER | RC_SEVERITY_FATAL,
+
+  // Local Snapshots Module
+  RC_LOCAL_SNAPSHOTS_NULL_SELF =
+      0x01 | RC_MODULE_CONSENSUS_LOCAL_SNAPSHOTS | RC_SEVERITY_FATAL,
+  RC_LOCAL_SNAPSHOTS_INVALID_DEPTH =
+      0x02 | RC_MODULE_CONSENSUS_LOCAL_SNAPSHOTS | RC_SEVERITY_FATAL,
+  RC_LOCAL_SNAPSHOTS_FAILED_THREAD_SPAWN =
+      0x03 | RC_MODULE_CONSENSUS_LOCAL_SNAPSHOTS | RC_SEVERITY_FATAL,
+  RC_LOCAL_SNAPSHOTS_FAILED_THREAD_JOIN =
+      0x04 | RC_MODULE_CONSENSUS_LOCAL_SNAPSHOTS | RC_SEVERITY_MAJOR,
+  RC_LOCAL_SNAPSHOTS_STILL_RUNNING =
+      0x05 | RC_MODULE_CONSENSUS_LOCAL_SNAPSHOTS | RC_SEVERITY_FATAL,
+  RC_LOCAL_SNAPSHOTS_MILESTONE_NOT_FOUND =
+      0x06 | RC_MODULE_CONSENSUS_LOCAL_SNAPSHOTS | RC_SEVERITY_MAJOR,
+
+  // Ledger Checkpointer Module
+  RC_LEDGER_CHECKPOINTER_NULL_SELF =
+      0x01 | RC_MODULE_CONSENSUS_LEDGER_CHECKPOINTER | RC_SEVERITY_FATAL,
+  RC_LEDGER_CHECKPOINTER_FAILED_THREAD_SPAWN =
+      0x02 | RC_MODULE_CONSENSUS_LEDGER_CHECKPOINTER | RC_SEVERITY_FATAL,
+  RC_LEDGER_CHECKPOINTER_FAILED_THREAD_JOIN =
+      0x03 | RC_MODULE_CONSENSUS_LEDGER_CHECKPOINTER | RC_SEVERITY_MAJOR,
+  RC_LEDGER_CHECKPOINTER_STILL_RUNNING =
+      0x04 | RC_MODULE_CONSENSUS_LEDGER_CHECKPOINTER | RC_SEVERITY_FATAL,
+  RC_LEDGER_CHECKPOINTER_MILESTONE_NOT_FOUND =
+      0x05 | RC_MODULE_CONSENSUS_LEDGER_CHECKPOINTER | RC_SEVERITY_MAJOR,
+
   // MAM Module
   RC_MAM_BUFFER_TOO_SMALL = 0x01 | RC_MODULE_MAM | RC_SEVERITY_MODERATE,
   RC_MAM_INVALID_ARGUMENT = 0x02 | RC_MODULE_MAM | RC_SEVERITY_MODERATE,
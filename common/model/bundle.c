@@ -5,21 +5,111 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
+
 #include "common/model/bundle.h"
 #include "common/model/transfer.h"
 #include "common/trinary/trit_long.h"
 #include "common/trinary/tryte_long.h"
+#include "utils/handles/thread.h"
 
 static UT_icd bundle_transactions_icd = {sizeof(iota_transaction_t), 0, 0, 0};
 
+typedef struct signature_fragment_s {
+  iota_transaction_t const *input;
+  flex_trit_t const *signature;
+  trit_t const *normalized_bundle_fragment;
+  trit_t digest[NUM_TRITS_ADDRESS];
+} signature_fragment_t;
+
+typedef struct signature_worker_s {
+  thread_handle_t thread;
+  signature_fragment_t *fragments;
+  size_t num_fragments;
+  size_t first;
+  size_t step;
+} signature_worker_t;
+
+/**
+ * Digests every step-th signature fragment starting at first, workers only
+ * write to their own fragments so results do not depend on scheduling
+ */
+static void *signature_worker_routine(void *arg) {
+  signature_worker_t *worker = (signature_worker_t *)arg;
+  trit_t key[NUM_TRITS_SIGNATURE];
+  Kerl kerl;
+
+  for (size_t i = worker->first; i < worker->num_fragments;
+       i += worker->step) {
+    init_kerl(&kerl);
+    flex_trits_to_trits(key, NUM_TRITS_SIGNATURE,
+                        worker->fragments[i].signature, NUM_TRITS_SIGNATURE,
+                        NUM_TRITS_SIGNATURE);
+    iss_kerl_sig_digest(worker->fragments[i].digest,
+                        worker->fragments[i].normalized_bundle_fragment, key,
+                        NUM_TRITS_SIGNATURE, &kerl);
+  }
+
+  return NULL;
+}
+
+static size_t signature_workers_count(size_t const num_fragments) {
+  size_t count = BUNDLE_SIGNATURE_MAX_THREADS;
+
+#ifdef _SC_NPROCESSORS_ONLN
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if (cpus > 0 && (size_t)cpus < count) {
+    count = cpus;
+  }
+#endif
+
+  if (num_fragments < BUNDLE_SIGNATURE_PARALLEL_THRESHOLD) {
+    return 1;
+  }
+  return count < num_fragments ? count : num_fragments;
+}
+
+static void digest_signature_fragments(signature_fragment_t *const fragments,
+                                       size_t const num_fragments) {
+  size_t num_workers = signature_workers_count(num_fragments);
+  signature_worker_t workers[BUNDLE_SIGNATURE_MAX_THREADS];
+  bool spawned[BUNDLE_SIGNATURE_MAX_THREADS] = {false};
+
+  for (size_t i = 0; i < num_workers; i++) {
+    workers[i].fragments = fragments;
+    workers[i].num_fragments = num_fragments;
+    workers[i].first = i;
+    workers[i].step = num_workers;
+  }
+
+  // The calling thread takes the first share, shares of workers that could
+  // not be spawned are digested inline
+  for (size_t i = 1; i < num_workers; i++) {
+    spawned[i] = thread_handle_create(&workers[i].thread,
+                                      signature_worker_routine,
+                                      &workers[i]) == 0;
+  }
+  signature_worker_routine(&workers[0]);
+  for (size_t i = 1; i < num_workers; i++) {
+    if (spawned[i]) {
+      thread_handle_join(workers[i].thread, NULL);
+    } else {
+      signature_worker_routine(&workers[i]);
+    }
+  }
+}
+
 /**
  * Validate signatures in a bundle,
  * it's a private method called by bundle_validator()
  *
+ * Signature fragments are independent from each other and are digested
+ * concurrently, digests are then absorbed in bundle order to rebuild the input
+ * addresses.
+ *
  * @param {bundle_transactions_t} bundle - the bundle with transactions.
  * @param {trit_t} normalized_bundle - the bundle hash
  * @param {Kerl} address_kerl - the kerl instance for address calculation
- * @param {Kerl} sig_frag_kerl - the kerl instance for signature calculation
  * @param {bool} is_valid - the result of validation
  *
  * @return {retcode_t}
@@ -27,15 +117,19 @@ static UT_icd bundle_transactions_icd = {sizeof(iota_transaction_t), 0, 0, 0};
 static retcode_t validate_signatures(bundle_transactions_t const *const bundle,
                                      trit_t const *const normalized_bundle,
                                      Kerl *const address_kerl,
-                                     Kerl *const sig_frag_kerl,
                                      bool *const is_valid) {
   iota_transaction_t *curr_tx = NULL, *curr_inp_tx = NULL;
-  trit_t digested_sig_trits[NUM_TRITS_ADDRESS];
+  signature_fragment_t *fragments = NULL;
+  size_t num_fragments = 0;
   trit_t digested_address[NUM_TRITS_ADDRESS];
-  trit_t key[NUM_TRITS_SIGNATURE];
   flex_trit_t digest[FLEX_TRIT_SIZE_243];
   size_t offset = 0, next_offset = 0;
 
+  if ((fragments = (signature_fragment_t *)malloc(
+           utarray_len(bundle) * sizeof(signature_fragment_t))) == NULL) {
+    return RC_OOM;
+  }
+
   for (curr_tx = (iota_transaction_t *)utarray_eltptr(bundle, 0);
        curr_tx != NULL;) {
     if (transaction_value(curr_tx) >= 0) {
@@ -45,23 +139,30 @@ static retcode_t validate_signatures(bundle_transactions_t const *const bundle,
     curr_inp_tx = curr_tx;
     offset = 0;
     next_offset = 0;
-    init_kerl(address_kerl);
     do {
-      init_kerl(sig_frag_kerl);
       next_offset = (offset + ISS_FRAGMENTS * RADIX - 1) % NUM_TRITS_HASH + 1;
-      flex_trits_to_trits(key, NUM_TRITS_SIGNATURE,
-                          transaction_signature(curr_inp_tx),
-                          NUM_TRITS_SIGNATURE, NUM_TRITS_SIGNATURE);
-      iss_kerl_sig_digest(digested_sig_trits,
-                          &normalized_bundle[offset % NUM_TRITS_HASH], key,
-                          NUM_TRITS_SIGNATURE, sig_frag_kerl);
-      kerl_absorb(address_kerl, digested_sig_trits, NUM_TRITS_ADDRESS);
+      fragments[num_fragments].input = curr_tx;
+      fragments[num_fragments].signature = transaction_signature(curr_inp_tx);
+      fragments[num_fragments].normalized_bundle_fragment =
+          &normalized_bundle[offset % NUM_TRITS_HASH];
+      num_fragments++;
       curr_inp_tx = (iota_transaction_t *)utarray_next(bundle, curr_inp_tx);
       offset = next_offset;
     } while (curr_inp_tx != NULL &&
              memcmp(transaction_address(curr_inp_tx),
                     transaction_address(curr_tx), FLEX_TRIT_SIZE_243) == 0 &&
              transaction_value(curr_inp_tx) == 0);
+    curr_tx = curr_inp_tx;
+  }
+
+  digest_signature_fragments(fragments, num_fragments);
+
+  for (size_t i = 0; i < num_fragments;) {
+    curr_tx = (iota_transaction_t *)fragments[i].input;
+    init_kerl(address_kerl);
+    for (; i < num_fragments && fragments[i].input == curr_tx; i++) {
+      kerl_absorb(address_kerl, fragments[i].digest, NUM_TRITS_ADDRESS);
+    }
 
     kerl_squeeze(address_kerl, digested_address, NUM_TRITS_ADDRESS);
     flex_trits_from_trits(digest, NUM_TRITS_HASH, digested_address,
@@ -71,10 +172,10 @@ static retcode_t validate_signatures(bundle_transactions_t const *const bundle,
       *is_valid = false;
       break;
     }
-    curr_tx = curr_inp_tx;
     *is_valid = true;
   }
 
+  free(fragments);
   return RC_OK;
 }
 
@@ -161,7 +262,7 @@ retcode_t bundle_validator(bundle_transactions_t *const bundle,
   int64_t bundle_value = 0, tx_value = 0;
   flex_trit_t bundle_hash[FLEX_TRIT_SIZE_243];
   bool valid_sig = false;
-  Kerl shared_kerl1, shared_kerl2;
+  Kerl shared_kerl;
   flex_trit_t bundle_hash_calculated[FLEX_TRIT_SIZE_243];
   trit_t normalized_bundle[HASH_LENGTH_TRIT];
 
@@ -212,7 +313,7 @@ retcode_t bundle_validator(bundle_transactions_t *const bundle,
         break;
       }
 
-      bundle_calculate_hash(bundle, &shared_kerl1, bundle_hash_calculated);
+      bundle_calculate_hash(bundle, &shared_kerl, bundle_hash_calculated);
       if (memcmp(bundle_hash, bundle_hash_calculated, FLEX_TRIT_SIZE_243) !=
           0) {
         *status = BUNDLE_INVALID_HASH;
@@ -221,8 +322,8 @@ retcode_t bundle_validator(bundle_transactions_t *const bundle,
 
       normalize_flex_hash_to_trits(bundle_hash_calculated, normalized_bundle);
 
-      res = validate_signatures(bundle, normalized_bundle, &shared_kerl1,
-                                &shared_kerl2, &valid_sig);
+      res = validate_signatures(bundle, normalized_bundle, &shared_kerl,
+                                &valid_sig);
       if (res != RC_OK || !valid_sig) {
         *status = BUNDLE_INVALID_SIGNATURE;
         break;
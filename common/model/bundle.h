@@ -21,6 +21,12 @@ extern "C" {
 
 #define MAX_IOTA_SUPPLY 2779530283277761LL
 
+// Signature fragments of a bundle are digested concurrently by up to this many
+// threads, and only when the bundle has at least as many fragments as the
+// threshold
+#define BUNDLE_SIGNATURE_MAX_THREADS 8
+#define BUNDLE_SIGNATURE_PARALLEL_THRESHOLD 2
+
 typedef enum bundle_status_e {
   BUNDLE_VALID,
   BUNDLE_NOT_INITIALIZED,
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "common/model/bundle.h"
+#include "common/model/tests/bundle_builder.h"
+
+#define NUM_RUNS 10
+
+static double elapsed_ms(struct timespec const *const start,
+                         struct timespec const *const end) {
+  return (end->tv_sec - start->tv_sec) * 1e3 +
+         (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static int benchmark(size_t const num_inputs) {
+  bundle_transactions_t *bundle = NULL;
+  bundle_status_t status = BUNDLE_NOT_INITIALIZED;
+  struct timespec start, end;
+  double total = 0;
+
+  bundle_transactions_new(&bundle);
+  bundle_build_signed(bundle, num_inputs, 2);
+
+  for (size_t i = 0; i < NUM_RUNS; i++) {
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (bundle_validator(bundle, &status) != RC_OK || status != BUNDLE_VALID) {
+      fprintf(stderr, "Bundle with %zu inputs is invalid\n", num_inputs);
+      bundle_transactions_free(&bundle);
+      return EXIT_FAILURE;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    total += elapsed_ms(&start, &end);
+  }
+
+  printf("%2zu inputs (%3zu transactions): %8.3f ms per bundle\n", num_inputs,
+         bundle_transactions_size(bundle), total / NUM_RUNS);
+  bundle_transactions_free(&bundle);
+  return EXIT_SUCCESS;
+}
+
+int main(void) {
+  size_t const inputs[] = {1, 10, 50};
+
+  for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+    if (benchmark(inputs[i]) != EXIT_SUCCESS) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+
+#include "common/helpers/sign.h"
+#include "common/model/tests/bundle_builder.h"
+#include "common/model/tests/defs.h"
+#include "common/model/transfer.h"
+
+void bundle_build_signed(bundle_transactions_t *const bundle,
+                         size_t const num_inputs, uint8_t const security) {
+  flex_trit_t seed[FLEX_TRIT_SIZE_243];
+  flex_trit_t tag[FLEX_TRIT_SIZE_81];
+  flex_trit_t *addresses[num_inputs + 1];
+  transfer_value_out_t outputs[num_inputs];
+  transfer_t *transfers[num_inputs + 1];
+  transfer_iterator_t *iter = NULL;
+  iota_transaction_t *tx = NULL;
+  Kerl kerl;
+
+  flex_trits_from_trytes(seed, NUM_TRITS_ADDRESS, TEST_SEED, NUM_TRYTES_ADDRESS,
+                         NUM_TRYTES_ADDRESS);
+  flex_trits_from_trytes(tag, NUM_TRITS_TAG, TEST_TAG_NULL, NUM_TRYTES_TAG,
+                         NUM_TRYTES_TAG);
+
+  for (size_t i = 0; i <= num_inputs; i++) {
+    addresses[i] = iota_sign_address_gen_flex_trits(seed, i, security);
+  }
+  transfers[0] = transfer_value_in_new(addresses[num_inputs], tag, num_inputs,
+                                       NULL, 0, TEST_TIMESTAMP);
+  for (size_t i = 0; i < num_inputs; i++) {
+    outputs[i].seed = seed;
+    outputs[i].security = security;
+    outputs[i].seed_index = i;
+    transfers[i + 1] = transfer_value_out_new(&outputs[i], tag, addresses[i],
+                                              -1, TEST_TIMESTAMP);
+  }
+
+  init_kerl(&kerl);
+  iter = transfer_iterator_new(transfers, num_inputs + 1, &kerl, NULL);
+  while ((tx = transfer_iterator_next(iter)) != NULL) {
+    bundle_transactions_add(bundle, tx);
+  }
+  transfer_iterator_free(&iter);
+
+  for (size_t i = 0; i <= num_inputs; i++) {
+    transfer_free(&transfers[i]);
+    free(addresses[i]);
+  }
+}
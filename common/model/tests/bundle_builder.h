@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_MODEL_TESTS_BUNDLE_BUILDER_H__
+#define __COMMON_MODEL_TESTS_BUNDLE_BUILDER_H__
+
+#include "common/model/bundle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Builds a signed bundle spending 1i from each of the first num_inputs
+ * addresses of a test seed to a single output
+ *
+ * @param bundle The bundle to fill
+ * @param num_inputs The number of inputs
+ * @param security The security level of the inputs
+ */
+void bundle_build_signed(bundle_transactions_t *const bundle,
+                         size_t const num_inputs, uint8_t const security);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_MODEL_TESTS_BUNDLE_BUILDER_H__
@@ -8,6 +8,7 @@
 #include <unity/unity.h>
 
 #include "common/model/bundle.h"
+#include "common/model/tests/bundle_builder.h"
 #include "common/sign/normalize.h"
 
 static tryte_t *trytes =
@@ -33,10 +34,42 @@ void test_normalized_bundle(void) {
   TEST_ASSERT_EQUAL_MEMORY(bytes, normalized_bundle_bytes, length);
 }
 
+void test_bundle_validator_multi_input(void) {
+  bundle_transactions_t *bundle = NULL;
+  bundle_status_t status = BUNDLE_NOT_INITIALIZED;
+  iota_transaction_t *tx = NULL;
+  trit_t buffer[NUM_TRITS_PER_FLEX_TRIT];
+
+  bundle_transactions_new(&bundle);
+  bundle_build_signed(bundle, 10, 2);
+  TEST_ASSERT_EQUAL_INT(21, bundle_transactions_size(bundle));
+
+  // Results must not depend on how fragments are spread across threads
+  for (size_t i = 0; i < 3; i++) {
+    TEST_ASSERT(bundle_validator(bundle, &status) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(BUNDLE_VALID, status);
+  }
+
+  // Alters the second fragment of the last input
+  tx = (iota_transaction_t *)utarray_eltptr(bundle, 20);
+  flex_trits_to_trits(buffer, NUM_TRITS_PER_FLEX_TRIT,
+                      transaction_signature(tx), NUM_TRITS_PER_FLEX_TRIT,
+                      NUM_TRITS_PER_FLEX_TRIT);
+  buffer[0] = buffer[0] == 1 ? 0 : 1;
+  flex_trits_from_trits(transaction_signature(tx), NUM_TRITS_PER_FLEX_TRIT,
+                        buffer, NUM_TRITS_PER_FLEX_TRIT,
+                        NUM_TRITS_PER_FLEX_TRIT);
+  TEST_ASSERT(bundle_validator(bundle, &status) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(BUNDLE_INVALID_SIGNATURE, status);
+
+  bundle_transactions_free(&bundle);
+}
+
 int main(void) {
   UNITY_BEGIN();
 
   RUN_TEST(test_normalized_bundle);
+  RUN_TEST(test_bundle_validator_multi_input);
 
   return UNITY_END();
 }
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unity/unity.h>
+
+#include "common/model/tests/defs.h"
+#include "common/model/transaction_view.h"
+#include "common/trinary/trit_tryte.h"
+
+static trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION];
+static byte_t bytes[NUM_BYTES_SERIALIZED_TRANSACTION];
+static flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+static void view_from_trits(transaction_view_t *const view,
+                            iota_transaction_t *const expected) {
+  flex_trit_t flex_trits[FLEX_TRIT_SIZE_8019];
+
+  trits_to_bytes(trits, bytes, NUM_TRITS_SERIALIZED_TRANSACTION);
+  flex_trits_from_trits(flex_trits, NUM_TRITS_SERIALIZED_TRANSACTION, trits,
+                        NUM_TRITS_SERIALIZED_TRANSACTION,
+                        NUM_TRITS_SERIALIZED_TRANSACTION);
+  transaction_deserialize_from_trits(expected, flex_trits, false);
+  transaction_set_hash(expected, hash);
+  transaction_view_init(view, bytes, hash);
+}
+
+static void assert_fields(transaction_view_t *const view,
+                          iota_transaction_t const *const expected) {
+  flex_trit_t field[FLEX_TRIT_SIZE_6561];
+
+  transaction_view_signature_or_message(view, field);
+  TEST_ASSERT_EQUAL_MEMORY(expected->data.signature_or_message, field,
+                           FLEX_TRIT_SIZE_6561);
+  transaction_view_address(view, field);
+  TEST_ASSERT_EQUAL_MEMORY(expected->essence.address, field,
+                           FLEX_TRIT_SIZE_243);
+  transaction_view_obsolete_tag(view, field);
+  TEST_ASSERT_EQUAL_MEMORY(expected->essence.obsolete_tag, field,
+                           FLEX_TRIT_SIZE_81);
+  transaction_view_bundle(view, field);
+  TEST_ASSERT_EQUAL_MEMORY(expected->essence.bundle, field,
+                           FLEX_TRIT_SIZE_243);
+  transaction_view_trunk(view, field);
+  TEST_ASSERT_EQUAL_MEMORY(expected->attachment.trunk, field,
+                           FLEX_TRIT_SIZE_243);
+  transaction_view_branch(view, field);
+  TEST_ASSERT_EQUAL_MEMORY(expected->attachment.branch, field,
+                           FLEX_TRIT_SIZE_243);
+  transaction_view_tag(view, field);
+  TEST_ASSERT_EQUAL_MEMORY(expected->attachment.tag, field, FLEX_TRIT_SIZE_81);
+  transaction_view_nonce(view, field);
+  TEST_ASSERT_EQUAL_MEMORY(expected->attachment.nonce, field,
+                           FLEX_TRIT_SIZE_81);
+
+  TEST_ASSERT_EQUAL_INT64(transaction_value(expected),
+                          transaction_view_value(view));
+  TEST_ASSERT_EQUAL_UINT64(transaction_timestamp(expected),
+                           transaction_view_timestamp(view));
+  TEST_ASSERT_EQUAL_INT64(transaction_current_index(expected),
+                          transaction_view_current_index(view));
+  TEST_ASSERT_EQUAL_INT64(transaction_last_index(expected),
+                          transaction_view_last_index(view));
+  TEST_ASSERT_EQUAL_UINT64(transaction_attachment_timestamp(expected),
+                           transaction_view_attachment_timestamp(view));
+  TEST_ASSERT_EQUAL_UINT64(transaction_attachment_timestamp_lower(expected),
+                           transaction_view_attachment_timestamp_lower(view));
+  TEST_ASSERT_EQUAL_UINT64(transaction_attachment_timestamp_upper(expected),
+                           transaction_view_attachment_timestamp_upper(view));
+}
+
+static void assert_transaction(transaction_view_t *const view,
+                               iota_transaction_t const *const expected) {
+  iota_transaction_t transaction;
+  flex_trit_t serialized[FLEX_TRIT_SIZE_8019];
+  flex_trit_t expected_serialized[FLEX_TRIT_SIZE_8019];
+
+  transaction_reset(&transaction);
+  TEST_ASSERT_EQUAL_INT(NUM_TRITS_SERIALIZED_TRANSACTION,
+                        transaction_view_to_transaction(view, &transaction));
+  transaction_serialize_on_flex_trits(&transaction, serialized);
+  transaction_serialize_on_flex_trits(expected, expected_serialized);
+  TEST_ASSERT_EQUAL_MEMORY(expected_serialized, serialized,
+                           FLEX_TRIT_SIZE_8019);
+  TEST_ASSERT_EQUAL_MEMORY(hash, transaction_hash(&transaction),
+                           FLEX_TRIT_SIZE_243);
+}
+
+void test_view_fields(void) {
+  transaction_view_t view;
+  iota_transaction_t expected;
+
+  trytes_to_trits((tryte_t *)TRYTES, trits, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  view_from_trits(&view, &expected);
+  assert_fields(&view, &expected);
+  // Second access goes through the cache
+  assert_fields(&view, &expected);
+}
+
+void test_view_trit_at(void) {
+  transaction_view_t view;
+  iota_transaction_t expected;
+
+  trytes_to_trits((tryte_t *)TRYTES, trits, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  view_from_trits(&view, &expected);
+  for (size_t i = 0; i < NUM_TRITS_SERIALIZED_TRANSACTION; i++) {
+    TEST_ASSERT_EQUAL_INT8(trits[i], transaction_view_trit_at(&view, i));
+  }
+  TEST_ASSERT_EQUAL_INT8(
+      0, transaction_view_trit_at(&view, NUM_TRITS_SERIALIZED_TRANSACTION));
+}
+
+void test_view_to_transaction(void) {
+  transaction_view_t view;
+  iota_transaction_t expected;
+
+  trytes_to_trits((tryte_t *)TRYTES, trits, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  view_from_trits(&view, &expected);
+  assert_transaction(&view, &expected);
+
+  // Numeric fields decoded beforehand are reused
+  view_from_trits(&view, &expected);
+  transaction_view_value(&view);
+  transaction_view_attachment_timestamp(&view);
+  assert_transaction(&view, &expected);
+}
+
+void test_view_random(void) {
+  transaction_view_t view;
+  iota_transaction_t expected;
+
+  for (size_t run = 0; run < 32; run++) {
+    for (size_t i = 0; i < NUM_TRITS_SERIALIZED_TRANSACTION; i++) {
+      trits[i] = (trit_t)(rand() % 3 - 1);
+    }
+    // Keeps the value within the trits an int64_t can hold
+    memset(trits + NUM_TRITS_SIGNATURE + NUM_TRITS_ADDRESS + 33, 0,
+           NUM_TRITS_VALUE - 33);
+    view_from_trits(&view, &expected);
+    assert_fields(&view, &expected);
+    view_from_trits(&view, &expected);
+    assert_transaction(&view, &expected);
+  }
+}
+
+void test_view_weight_magnitude(void) {
+  transaction_view_t view;
+  iota_transaction_t expected;
+
+  trytes_to_trits((tryte_t *)TRYTES, trits, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  view_from_trits(&view, &expected);
+  TEST_ASSERT_EQUAL_UINT8(transaction_weight_magnitude(&expected),
+                          transaction_view_weight_magnitude(&view));
+
+  transaction_view_init(&view, bytes, NULL);
+  TEST_ASSERT_NULL(transaction_view_hash(&view));
+  TEST_ASSERT_EQUAL_UINT8(0, transaction_view_weight_magnitude(&view));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  flex_trits_from_trytes(hash, HASH_LENGTH_TRIT, (tryte_t *)TEST_HASH,
+                         NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+
+  RUN_TEST(test_view_fields);
+  RUN_TEST(test_view_trit_at);
+  RUN_TEST(test_view_to_transaction);
+  RUN_TEST(test_view_random);
+  RUN_TEST(test_view_weight_magnitude);
+
+  return UNITY_END();
+}
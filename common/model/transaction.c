@@ -258,18 +258,20 @@ void transaction_reset(iota_transaction_t *const transaction) {
 
 uint8_t transaction_weight_magnitude(
     iota_transaction_t const *const transaction) {
+  return transaction_hash_weight_magnitude(transaction_hash(transaction));
+}
+
+uint8_t transaction_hash_weight_magnitude(flex_trit_t const *const hash) {
   uint8_t num_trailing_null_values = 0;
   uint8_t pos = FLEX_TRIT_SIZE_243;
 
-  while (pos-- > 0 &&
-         transaction_hash(transaction)[pos] == FLEX_TRIT_NULL_VALUE) {
+  while (pos-- > 0 && hash[pos] == FLEX_TRIT_NULL_VALUE) {
     num_trailing_null_values += NUM_TRITS_PER_FLEX_TRIT;
   }
 
   if (pos > 0) {
     trit_t one_trit_buffer[NUM_TRITS_PER_FLEX_TRIT];
-    flex_trits_to_trits(one_trit_buffer, NUM_TRITS_PER_FLEX_TRIT,
-                        &transaction_hash(transaction)[pos],
+    flex_trits_to_trits(one_trit_buffer, NUM_TRITS_PER_FLEX_TRIT, &hash[pos],
                         NUM_TRITS_PER_FLEX_TRIT, NUM_TRITS_PER_FLEX_TRIT);
 
     pos = NUM_TRITS_PER_FLEX_TRIT;
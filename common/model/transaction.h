@@ -485,6 +485,8 @@ void transaction_obj_dump(iota_transaction_t *tx_obj);
 
 uint8_t transaction_weight_magnitude(
     iota_transaction_t const *const transaction);
+// Number of trailing 0 trits of a transaction hash
+uint8_t transaction_hash_weight_magnitude(flex_trit_t const *const hash);
 
 /***********************************************************************************************************
  * Constructors
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include "common/model/transaction_view.h"
+#include "common/trinary/trit_long.h"
+
+// Offsets of the fields in the serialized transaction
+#define OFFSET_SIGNATURE 0
+#define OFFSET_ADDRESS (OFFSET_SIGNATURE + NUM_TRITS_SIGNATURE)
+#define OFFSET_VALUE (OFFSET_ADDRESS + NUM_TRITS_ADDRESS)
+#define OFFSET_OBSOLETE_TAG (OFFSET_VALUE + NUM_TRITS_VALUE)
+#define OFFSET_TIMESTAMP (OFFSET_OBSOLETE_TAG + NUM_TRITS_OBSOLETE_TAG)
+#define OFFSET_CURRENT_INDEX (OFFSET_TIMESTAMP + NUM_TRITS_TIMESTAMP)
+#define OFFSET_LAST_INDEX (OFFSET_CURRENT_INDEX + NUM_TRITS_CURRENT_INDEX)
+#define OFFSET_BUNDLE (OFFSET_LAST_INDEX + NUM_TRITS_LAST_INDEX)
+#define OFFSET_TRUNK (OFFSET_BUNDLE + NUM_TRITS_BUNDLE)
+#define OFFSET_BRANCH (OFFSET_TRUNK + NUM_TRITS_TRUNK)
+#define OFFSET_TAG (OFFSET_BRANCH + NUM_TRITS_BRANCH)
+#define OFFSET_ATTACHMENT_TIMESTAMP (OFFSET_TAG + NUM_TRITS_TAG)
+#define OFFSET_ATTACHMENT_TIMESTAMP_LOWER \
+  (OFFSET_ATTACHMENT_TIMESTAMP + NUM_TRITS_ATTACHMENT_TIMESTAMP)
+#define OFFSET_ATTACHMENT_TIMESTAMP_UPPER \
+  (OFFSET_ATTACHMENT_TIMESTAMP_LOWER + NUM_TRITS_ATTACHMENT_TIMESTAMP_LOWER)
+#define OFFSET_NONCE \
+  (OFFSET_ATTACHMENT_TIMESTAMP_UPPER + NUM_TRITS_ATTACHMENT_TIMESTAMP_UPPER)
+
+typedef enum view_decoded_e {
+  DECODED_VALUE = (1u << 0),
+  DECODED_TIMESTAMP = (1u << 1),
+  DECODED_CURRENT_INDEX = (1u << 2),
+  DECODED_LAST_INDEX = (1u << 3),
+  DECODED_ATTACHMENT_TIMESTAMP = (1u << 4),
+  DECODED_ATTACHMENT_TIMESTAMP_LOWER = (1u << 5),
+  DECODED_ATTACHMENT_TIMESTAMP_UPPER = (1u << 6),
+} view_decoded_t;
+
+/*
+ * Private functions
+ */
+
+/**
+ * Unpacks the bytes spanning a field. Fields aren't aligned on bytes so the
+ * field starts a few trits into the buffer.
+ *
+ * @param view The view
+ * @param offset Offset of the field in trits
+ * @param length Length of the field in trits
+ * @param buffer At least length + NUMBER_OF_TRITS_IN_A_BYTE - 1 trits
+ *
+ * @return the first trit of the field in the buffer
+ */
+static trit_t const *view_unpack(transaction_view_t const *const view,
+                                 size_t const offset, size_t const length,
+                                 trit_t *const buffer) {
+  size_t const first = offset / NUMBER_OF_TRITS_IN_A_BYTE;
+  size_t const skip = offset % NUMBER_OF_TRITS_IN_A_BYTE;
+
+  bytes_to_trits(view->bytes + first, MIN_BYTES(skip + length), buffer,
+                 skip + length);
+
+  return buffer + skip;
+}
+
+static void view_field(transaction_view_t const *const view,
+                       size_t const offset, size_t const length,
+                       flex_trit_t *const field) {
+  trit_t buffer[NUM_TRITS_SIGNATURE + NUMBER_OF_TRITS_IN_A_BYTE - 1];
+
+  flex_trits_from_trits(field, length,
+                        view_unpack(view, offset, length, buffer), length,
+                        length);
+}
+
+// Decodes a numeric field unless cached, from the unpacked transaction if
+// given or else from the bytes spanning it
+static int64_t view_long(transaction_view_t *const view,
+                         trit_t const *const trits, size_t const offset,
+                         size_t const length, view_decoded_t const bit,
+                         int64_t *const cache) {
+  trit_t buffer[NUM_TRITS_VALUE + NUMBER_OF_TRITS_IN_A_BYTE - 1];
+
+  if ((view->decoded & bit) == 0) {
+    *cache = trits_to_long(
+        trits ? trits + offset : view_unpack(view, offset, length, buffer),
+        length);
+    view->decoded |= bit;
+  }
+
+  return *cache;
+}
+
+/*
+ * Public functions
+ */
+
+void transaction_view_init(transaction_view_t *const view,
+                           byte_t const *const bytes,
+                           flex_trit_t const *const hash) {
+  memset(view, 0, sizeof(transaction_view_t));
+  view->bytes = bytes;
+  view->hash = hash;
+}
+
+trit_t transaction_view_trit_at(transaction_view_t const *const view,
+                                size_t const index) {
+  trit_t trits[NUMBER_OF_TRITS_IN_A_BYTE];
+
+  if (index >= NUM_TRITS_SERIALIZED_TRANSACTION) {
+    return 0;
+  }
+
+  byte_to_trits(view->bytes[index / NUMBER_OF_TRITS_IN_A_BYTE], trits,
+                NUMBER_OF_TRITS_IN_A_BYTE);
+
+  return trits[index % NUMBER_OF_TRITS_IN_A_BYTE];
+}
+
+uint8_t transaction_view_weight_magnitude(
+    transaction_view_t const *const view) {
+  return view->hash ? transaction_hash_weight_magnitude(view->hash) : 0;
+}
+
+void transaction_view_signature_or_message(
+    transaction_view_t const *const view, flex_trit_t *const field) {
+  view_field(view, OFFSET_SIGNATURE, NUM_TRITS_SIGNATURE, field);
+}
+
+void transaction_view_address(transaction_view_t const *const view,
+                              flex_trit_t *const field) {
+  view_field(view, OFFSET_ADDRESS, NUM_TRITS_ADDRESS, field);
+}
+
+void transaction_view_obsolete_tag(transaction_view_t const *const view,
+                                   flex_trit_t *const field) {
+  view_field(view, OFFSET_OBSOLETE_TAG, NUM_TRITS_OBSOLETE_TAG, field);
+}
+
+void transaction_view_bundle(transaction_view_t const *const view,
+                             flex_trit_t *const field) {
+  view_field(view, OFFSET_BUNDLE, NUM_TRITS_BUNDLE, field);
+}
+
+void transaction_view_trunk(transaction_view_t const *const view,
+                            flex_trit_t *const field) {
+  view_field(view, OFFSET_TRUNK, NUM_TRITS_TRUNK, field);
+}
+
+void transaction_view_branch(transaction_view_t const *const view,
+                             flex_trit_t *const field) {
+  view_field(view, OFFSET_BRANCH, NUM_TRITS_BRANCH, field);
+}
+
+void transaction_view_tag(transaction_view_t const *const view,
+                          flex_trit_t *const field) {
+  view_field(view, OFFSET_TAG, NUM_TRITS_TAG, field);
+}
+
+void transaction_view_nonce(transaction_view_t const *const view,
+                            flex_trit_t *const field) {
+  view_field(view, OFFSET_NONCE, NUM_TRITS_NONCE, field);
+}
+
+int64_t transaction_view_value(transaction_view_t *const view) {
+  return view_long(view, NULL, OFFSET_VALUE, NUM_TRITS_VALUE, DECODED_VALUE,
+                   &view->value);
+}
+
+uint64_t transaction_view_timestamp(transaction_view_t *const view) {
+  return view_long(view, NULL, OFFSET_TIMESTAMP, NUM_TRITS_TIMESTAMP,
+                   DECODED_TIMESTAMP, (int64_t *)&view->timestamp);
+}
+
+int64_t transaction_view_current_index(transaction_view_t *const view) {
+  return view_long(view, NULL, OFFSET_CURRENT_INDEX, NUM_TRITS_CURRENT_INDEX,
+                   DECODED_CURRENT_INDEX, &view->current_index);
+}
+
+int64_t transaction_view_last_index(transaction_view_t *const view) {
+  return view_long(view, NULL, OFFSET_LAST_INDEX, NUM_TRITS_LAST_INDEX,
+                   DECODED_LAST_INDEX, &view->last_index);
+}
+
+uint64_t transaction_view_attachment_timestamp(transaction_view_t *const view) {
+  return view_long(view, NULL, OFFSET_ATTACHMENT_TIMESTAMP,
+                   NUM_TRITS_ATTACHMENT_TIMESTAMP, DECODED_ATTACHMENT_TIMESTAMP,
+                   (int64_t *)&view->attachment_timestamp);
+}
+
+uint64_t transaction_view_attachment_timestamp_lower(
+    transaction_view_t *const view) {
+  return view_long(view, NULL, OFFSET_ATTACHMENT_TIMESTAMP_LOWER,
+                   NUM_TRITS_ATTACHMENT_TIMESTAMP_LOWER,
+                   DECODED_ATTACHMENT_TIMESTAMP_LOWER,
+                   (int64_t *)&view->attachment_timestamp_lower);
+}
+
+uint64_t transaction_view_attachment_timestamp_upper(
+    transaction_view_t *const view) {
+  return view_long(view, NULL, OFFSET_ATTACHMENT_TIMESTAMP_UPPER,
+                   NUM_TRITS_ATTACHMENT_TIMESTAMP_UPPER,
+                   DECODED_ATTACHMENT_TIMESTAMP_UPPER,
+                   (int64_t *)&view->attachment_timestamp_upper);
+}
+
+size_t transaction_view_to_transaction(transaction_view_t *const view,
+                                       iota_transaction_t *const transaction) {
+  trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION];
+
+  bytes_to_trits(view->bytes, NUM_BYTES_SERIALIZED_TRANSACTION, trits,
+                 NUM_TRITS_SERIALIZED_TRANSACTION);
+
+  flex_trits_from_trits(transaction->data.signature_or_message,
+                        NUM_TRITS_SIGNATURE, trits + OFFSET_SIGNATURE,
+                        NUM_TRITS_SIGNATURE, NUM_TRITS_SIGNATURE);
+  transaction->loaded_columns_mask.data |= MASK_DATA_SIG_OR_MSG;
+  flex_trits_from_trits(transaction->essence.address, NUM_TRITS_ADDRESS,
+                        trits + OFFSET_ADDRESS, NUM_TRITS_ADDRESS,
+                        NUM_TRITS_ADDRESS);
+  transaction->loaded_columns_mask.essence |= MASK_ESSENCE_ADDRESS;
+  flex_trits_from_trits(transaction->essence.obsolete_tag,
+                        NUM_TRITS_OBSOLETE_TAG, trits + OFFSET_OBSOLETE_TAG,
+                        NUM_TRITS_OBSOLETE_TAG, NUM_TRITS_OBSOLETE_TAG);
+  transaction->loaded_columns_mask.essence |= MASK_ESSENCE_OBSOLETE_TAG;
+  flex_trits_from_trits(transaction->essence.bundle, NUM_TRITS_BUNDLE,
+                        trits + OFFSET_BUNDLE, NUM_TRITS_BUNDLE,
+                        NUM_TRITS_BUNDLE);
+  transaction->loaded_columns_mask.essence |= MASK_ESSENCE_BUNDLE;
+  flex_trits_from_trits(transaction->attachment.trunk, NUM_TRITS_TRUNK,
+                        trits + OFFSET_TRUNK, NUM_TRITS_TRUNK, NUM_TRITS_TRUNK);
+  transaction->loaded_columns_mask.attachment |= MASK_ATTACHMENT_TRUNK;
+  flex_trits_from_trits(transaction->attachment.branch, NUM_TRITS_BRANCH,
+                        trits + OFFSET_BRANCH, NUM_TRITS_BRANCH,
+                        NUM_TRITS_BRANCH);
+  transaction->loaded_columns_mask.attachment |= MASK_ATTACHMENT_BRANCH;
+  flex_trits_from_trits(transaction->attachment.tag, NUM_TRITS_TAG,
+                        trits + OFFSET_TAG, NUM_TRITS_TAG, NUM_TRITS_TAG);
+  transaction->loaded_columns_mask.attachment |= MASK_ATTACHMENT_TAG;
+  flex_trits_from_trits(transaction->attachment.nonce, NUM_TRITS_NONCE,
+                        trits + OFFSET_NONCE, NUM_TRITS_NONCE, NUM_TRITS_NONCE);
+  transaction->loaded_columns_mask.attachment |= MASK_ATTACHMENT_NONCE;
+
+  // Numeric fields already decoded through the view are reused
+  transaction_set_value(
+      transaction, view_long(view, trits, OFFSET_VALUE, NUM_TRITS_VALUE,
+                             DECODED_VALUE, &view->value));
+  transaction_set_timestamp(
+      transaction,
+      view_long(view, trits, OFFSET_TIMESTAMP, NUM_TRITS_TIMESTAMP,
+                DECODED_TIMESTAMP, (int64_t *)&view->timestamp));
+  transaction_set_current_index(
+      transaction,
+      view_long(view, trits, OFFSET_CURRENT_INDEX, NUM_TRITS_CURRENT_INDEX,
+                DECODED_CURRENT_INDEX, &view->current_index));
+  transaction_set_last_index(
+      transaction,
+      view_long(view, trits, OFFSET_LAST_INDEX, NUM_TRITS_LAST_INDEX,
+                DECODED_LAST_INDEX, &view->last_index));
+  transaction_set_attachment_timestamp(
+      transaction, view_long(view, trits, OFFSET_ATTACHMENT_TIMESTAMP,
+                             NUM_TRITS_ATTACHMENT_TIMESTAMP,
+                             DECODED_ATTACHMENT_TIMESTAMP,
+                             (int64_t *)&view->attachment_timestamp));
+  transaction_set_attachment_timestamp_lower(
+      transaction, view_long(view, trits, OFFSET_ATTACHMENT_TIMESTAMP_LOWER,
+                             NUM_TRITS_ATTACHMENT_TIMESTAMP_LOWER,
+                             DECODED_ATTACHMENT_TIMESTAMP_LOWER,
+                             (int64_t *)&view->attachment_timestamp_lower));
+  transaction_set_attachment_timestamp_upper(
+      transaction, view_long(view, trits, OFFSET_ATTACHMENT_TIMESTAMP_UPPER,
+                             NUM_TRITS_ATTACHMENT_TIMESTAMP_UPPER,
+                             DECODED_ATTACHMENT_TIMESTAMP_UPPER,
+                             (int64_t *)&view->attachment_timestamp_upper));
+
+  if (view->hash) {
+    transaction_set_hash(transaction, view->hash);
+  }
+
+  return NUM_TRITS_SERIALIZED_TRANSACTION;
+}
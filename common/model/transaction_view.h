@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_MODEL_TRANSACTION_VIEW_H__
+#define __COMMON_MODEL_TRANSACTION_VIEW_H__
+
+#include "common/model/transaction.h"
+#include "common/trinary/bytes.h"
+#include "common/trinary/trit_byte.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Size of a transaction packed 5 trits per byte, as sent on the wire
+#define NUM_BYTES_SERIALIZED_TRANSACTION \
+  MIN_BYTES(NUM_TRITS_SERIALIZED_TRANSACTION)
+
+/**
+ * A transaction view reads the fields of a transaction in its wire encoding
+ * without deserializing it: every accessor only decodes the bytes of the
+ * field it is asked for. Numeric fields are cached once decoded.
+ * The view doesn't own the bytes nor the hash, which must outlive it.
+ */
+typedef struct transaction_view_s {
+  byte_t const *bytes;
+  flex_trit_t const *hash;
+  // Bits of the numeric fields already decoded
+  uint8_t decoded;
+  int64_t value;
+  uint64_t timestamp;
+  int64_t current_index;
+  int64_t last_index;
+  uint64_t attachment_timestamp;
+  uint64_t attachment_timestamp_lower;
+  uint64_t attachment_timestamp_upper;
+} transaction_view_t;
+
+/**
+ * Initializes a view over a packed transaction
+ *
+ * @param view The view
+ * @param bytes NUM_BYTES_SERIALIZED_TRANSACTION bytes of a transaction
+ * @param hash The hash of the transaction, may be NULL if unknown
+ */
+void transaction_view_init(transaction_view_t *const view,
+                           byte_t const *const bytes,
+                           flex_trit_t const *const hash);
+
+/**
+ * Gets a trit of the serialized transaction
+ *
+ * @param view The view
+ * @param index Index of the trit, up to NUM_TRITS_SERIALIZED_TRANSACTION
+ *
+ * @return the trit
+ */
+trit_t transaction_view_trit_at(transaction_view_t const *const view,
+                                size_t const index);
+
+/**
+ * Gets the hash of the transaction given at initialization
+ *
+ * @param view The view
+ *
+ * @return the hash, NULL if unknown
+ */
+static inline flex_trit_t const *transaction_view_hash(
+    transaction_view_t const *const view) {
+  return view->hash;
+}
+
+/**
+ * Gets the weight magnitude of the transaction hash
+ *
+ * @param view The view, with a known hash
+ *
+ * @return the number of trailing 0 trits of the hash
+ */
+uint8_t transaction_view_weight_magnitude(transaction_view_t const *const view);
+
+/**
+ * Decodes a hash or tag field of the transaction
+ *
+ * @param view The view
+ * @param field A flex_trit_t array big enough for the field, e.g.
+ * FLEX_TRIT_SIZE_243 for an address
+ */
+void transaction_view_signature_or_message(
+    transaction_view_t const *const view, flex_trit_t *const field);
+void transaction_view_address(transaction_view_t const *const view,
+                              flex_trit_t *const field);
+void transaction_view_obsolete_tag(transaction_view_t const *const view,
+                                   flex_trit_t *const field);
+void transaction_view_bundle(transaction_view_t const *const view,
+                             flex_trit_t *const field);
+void transaction_view_trunk(transaction_view_t const *const view,
+                            flex_trit_t *const field);
+void transaction_view_branch(transaction_view_t const *const view,
+                             flex_trit_t *const field);
+void transaction_view_tag(transaction_view_t const *const view,
+                          flex_trit_t *const field);
+void transaction_view_nonce(transaction_view_t const *const view,
+                            flex_trit_t *const field);
+
+/**
+ * Gets a numeric field of the transaction, decoded on first access only
+ *
+ * @param view The view
+ *
+ * @return the field
+ */
+int64_t transaction_view_value(transaction_view_t *const view);
+uint64_t transaction_view_timestamp(transaction_view_t *const view);
+int64_t transaction_view_current_index(transaction_view_t *const view);
+int64_t transaction_view_last_index(transaction_view_t *const view);
+uint64_t transaction_view_attachment_timestamp(transaction_view_t *const view);
+uint64_t transaction_view_attachment_timestamp_lower(
+    transaction_view_t *const view);
+uint64_t transaction_view_attachment_timestamp_upper(
+    transaction_view_t *const view);
+
+/**
+ * Deserializes the whole transaction, unpacking its bytes only once. The hash
+ * is copied if known.
+ *
+ * @param view The view
+ * @param transaction The transaction to fill
+ *
+ * @return the number of trits deserialized
+ */
+size_t transaction_view_to_transaction(transaction_view_t *const view,
+                                       iota_transaction_t *const transaction);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_MODEL_TRANSACTION_VIEW_H__
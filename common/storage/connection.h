@@ -26,6 +26,16 @@ extern retcode_t connection_init(storage_connection_t* const connection,
                                  connection_config_t const* const config);
 extern retcode_t connection_destroy(storage_connection_t* const connection);
 
+/**
+ * Deletes the database a configuration points to, all connections to it must
+ * have been destroyed
+ *
+ * @param config The connection configuration
+ *
+ * @return a status code
+ */
+extern retcode_t connection_drop_db(connection_config_t const* const config);
+
 #ifdef __cplusplus
 }
 #endif
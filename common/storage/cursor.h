@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_STORAGE_CURSOR_H__
+#define __COMMON_STORAGE_CURSOR_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/trinary/flex_trit.h"
+
+/**
+ * A cursor yields the hashes matched by a query one row at a time, straight
+ * from the backend statement or iterator, instead of loading them all into a
+ * pack. It lives on the caller stack and opening it doesn't allocate.
+ *
+ * The statement a cursor reads from is busy until the cursor is closed: the
+ * same query must not be run again on that connection in the meantime.
+ */
+typedef struct iota_stor_cursor_s {
+  // Backend statement or iterator, NULL once the cursor is exhausted
+  void *handle;
+  // Whether a row has already been yielded
+  bool started;
+  // Rows with a timestamp at or after this one are skipped, 0 to keep all
+  int64_t before_timestamp;
+  // Key the query was opened with
+  flex_trit_t key[FLEX_TRIT_SIZE_243];
+  // Row buffer for hashes the backend doesn't store in full
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+} iota_stor_cursor_t;
+
+#endif  // __COMMON_STORAGE_CURSOR_H__
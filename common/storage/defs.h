@@ -48,4 +48,51 @@
 
 #define MILESTONE_NUM_COLS 3
 
+/*
+ * Spent address definitions
+ */
+
+#define SPENT_ADDRESS_TABLE_NAME "iota_spent_address"
+
+#define SPENT_ADDRESS_COL_HASH "hash"
+
+#define SPENT_ADDRESS_NUM_COLS 1
+
+/*
+ * Tip definitions
+ */
+
+#define TIP_TABLE_NAME "iota_tip"
+
+#define TIP_COL_HASH "hash"
+
+/*
+ * Missing transaction definitions
+ */
+
+#define MISSING_TRANSACTION_TABLE_NAME "iota_missing_transaction"
+
+#define MISSING_TRANSACTION_COL_HASH "hash"
+
+/*
+ * Counter definitions
+ */
+
+#define COUNTER_TABLE_NAME "iota_counter"
+
+#define COUNTER_COL_NAME "name"
+#define COUNTER_COL_VALUE "value"
+
+#define COUNTER_TRANSACTION "transaction"
+
+/*
+ * Ledger checkpoint definitions
+ */
+
+#define LEDGER_CHECKPOINT_TABLE_NAME "iota_ledger_checkpoint"
+
+#define LEDGER_CHECKPOINT_COL_INDEX "id"
+#define LEDGER_CHECKPOINT_COL_HASH "hash"
+#define LEDGER_CHECKPOINT_COL_STATE "state"
+
 #endif  // __COMMON_STORAGE_DEFS_H__
@@ -1,3 +1,8 @@
+-- Schema version 2, databases created with an older version are upgraded by
+-- the migrations of statements.c when a connection is opened
+
+-- The primary key is the only index on hash, secondary indexes carry the hash
+-- so that approvers, address and bundle lookups don't touch the rows
 CREATE TABLE IF NOT EXISTS iota_transaction (
   signature_or_message BLOB NOT NULL,
   address BLOB NOT NULL,
@@ -20,13 +25,13 @@ CREATE TABLE IF NOT EXISTS iota_transaction (
   arrival_timestamp INTEGER NOT NULL
 );
 
-CREATE INDEX IF NOT EXISTS address_index ON iota_transaction(address);
-CREATE INDEX IF NOT EXISTS bundle_index ON iota_transaction(bundle);
-CREATE INDEX IF NOT EXISTS trunk_index ON iota_transaction(trunk);
-CREATE INDEX IF NOT EXISTS branch_index ON iota_transaction(branch);
+CREATE INDEX IF NOT EXISTS address_index ON iota_transaction(address, hash);
+CREATE INDEX IF NOT EXISTS bundle_index ON iota_transaction(bundle, hash);
+CREATE INDEX IF NOT EXISTS trunk_index ON iota_transaction(trunk, hash);
+CREATE INDEX IF NOT EXISTS branch_index ON iota_transaction(branch, hash);
 CREATE INDEX IF NOT EXISTS tag_index ON iota_transaction(tag);
-CREATE INDEX IF NOT EXISTS transaction_hash_index ON iota_transaction(hash);
 CREATE INDEX IF NOT EXISTS arrival_time_index ON iota_transaction(arrival_timestamp);
+CREATE INDEX IF NOT EXISTS snapshot_index_index ON iota_transaction(snapshot_index);
 
 CREATE TABLE IF NOT EXISTS iota_milestone (
   id INTEGER NOT NULL PRIMARY KEY,
@@ -34,4 +39,75 @@ CREATE TABLE IF NOT EXISTS iota_milestone (
   delta BLOB
 );
 
-CREATE INDEX IF NOT EXISTS milestone_hash_index ON iota_milestone(hash);
+CREATE TABLE IF NOT EXISTS iota_spent_address (
+  hash BLOB NOT NULL PRIMARY KEY
+) WITHOUT ROWID;
+
+CREATE TABLE IF NOT EXISTS iota_ledger_checkpoint (
+  id INTEGER NOT NULL PRIMARY KEY,
+  hash BLOB NOT NULL,
+  state BLOB NOT NULL
+);
+
+-- Incrementally maintained views of iota_transaction, kept up to date by the
+-- triggers below within the statement modifying iota_transaction
+
+CREATE TABLE IF NOT EXISTS iota_tip (
+  hash BLOB NOT NULL PRIMARY KEY
+) WITHOUT ROWID;
+
+CREATE TABLE IF NOT EXISTS iota_missing_transaction (
+  hash BLOB NOT NULL PRIMARY KEY
+) WITHOUT ROWID;
+
+CREATE TABLE IF NOT EXISTS iota_counter (
+  name TEXT NOT NULL PRIMARY KEY,
+  value INTEGER NOT NULL
+) WITHOUT ROWID;
+
+INSERT OR IGNORE INTO iota_tip(hash)
+  SELECT hash FROM iota_transaction a WHERE NOT(EXISTS(SELECT 1 FROM
+  iota_transaction b WHERE b.trunk = a.hash OR b.branch = a.hash));
+
+INSERT OR IGNORE INTO iota_missing_transaction(hash)
+  SELECT trunk FROM iota_transaction a WHERE NOT(EXISTS(SELECT 1 FROM
+  iota_transaction b WHERE b.hash = a.trunk)) UNION SELECT branch FROM
+  iota_transaction a WHERE NOT(EXISTS(SELECT 1 FROM iota_transaction b WHERE
+  b.hash = a.branch));
+
+INSERT OR IGNORE INTO iota_counter(name, value)
+  SELECT 'transaction', COUNT(*) FROM iota_transaction;
+
+CREATE TRIGGER IF NOT EXISTS transaction_insert_trigger
+AFTER INSERT ON iota_transaction
+BEGIN
+  DELETE FROM iota_tip WHERE hash = NEW.trunk OR hash = NEW.branch;
+  INSERT OR IGNORE INTO iota_tip(hash) SELECT NEW.hash WHERE NOT(EXISTS(
+    SELECT 1 FROM iota_transaction WHERE trunk = NEW.hash OR
+    branch = NEW.hash));
+  DELETE FROM iota_missing_transaction WHERE hash = NEW.hash;
+  INSERT OR IGNORE INTO iota_missing_transaction(hash)
+    SELECT NEW.trunk WHERE NOT(EXISTS(SELECT 1 FROM iota_transaction WHERE
+    hash = NEW.trunk)) UNION SELECT NEW.branch WHERE NOT(EXISTS(SELECT 1 FROM
+    iota_transaction WHERE hash = NEW.branch));
+  UPDATE iota_counter SET value = value + 1 WHERE name = 'transaction';
+END;
+
+CREATE TRIGGER IF NOT EXISTS transaction_delete_trigger
+AFTER DELETE ON iota_transaction
+BEGIN
+  DELETE FROM iota_tip WHERE hash = OLD.hash;
+  INSERT OR IGNORE INTO iota_tip(hash) SELECT hash FROM iota_transaction a
+    WHERE (hash = OLD.trunk OR hash = OLD.branch) AND NOT(EXISTS(SELECT 1 FROM
+    iota_transaction b WHERE b.trunk = a.hash OR b.branch = a.hash));
+  DELETE FROM iota_missing_transaction WHERE (hash = OLD.trunk OR
+    hash = OLD.branch) AND NOT(EXISTS(SELECT 1 FROM iota_transaction WHERE
+    trunk = iota_missing_transaction.hash OR
+    branch = iota_missing_transaction.hash));
+  INSERT OR IGNORE INTO iota_missing_transaction(hash) SELECT OLD.hash WHERE
+    EXISTS(SELECT 1 FROM iota_transaction WHERE trunk = OLD.hash OR
+    branch = OLD.hash);
+  UPDATE iota_counter SET value = value - 1 WHERE name = 'transaction';
+END;
+
+PRAGMA user_version = 2;
@@ -5,6 +5,7 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -19,6 +20,78 @@
 
 static logger_id_t logger_id;
 
+static retcode_t schema_version(sqlite3* const db, int* const version) {
+  sqlite3_stmt* statement = NULL;
+  retcode_t ret = RC_OK;
+
+  if (sqlite3_prepare_v2(db, "PRAGMA user_version", -1, &statement, NULL) !=
+      SQLITE_OK) {
+    return RC_SQLITE3_FAILED_PREPARED_STATEMENT;
+  }
+  if (sqlite3_step(statement) == SQLITE_ROW) {
+    *version = sqlite3_column_int(statement, 0);
+  } else {
+    ret = RC_SQLITE3_FAILED_STEP;
+  }
+  sqlite3_finalize(statement);
+
+  return ret;
+}
+
+/**
+ * Brings the schema of an existing database up to IOTA_SCHEMA_VERSION, all
+ * pending migrations being applied in a single transaction
+ */
+static retcode_t migrate_schema(sqlite3* const db) {
+  retcode_t ret = RC_OK;
+  char* err_msg = NULL;
+  char sql[32];
+  int version = 0;
+
+  if ((ret = schema_version(db, &version)) != RC_OK ||
+      version == IOTA_SCHEMA_VERSION) {
+    return ret;
+  }
+
+  // Concurrent connections wait for the write lock and read the version again
+  if (sqlite3_exec(db, "BEGIN IMMEDIATE", NULL, NULL, NULL) != SQLITE_OK) {
+    return RC_SQLITE3_FAILED_BEGIN;
+  }
+  if ((ret = schema_version(db, &version)) != RC_OK) {
+    goto rollback;
+  }
+  if (version > IOTA_SCHEMA_VERSION) {
+    log_critical(logger_id, "Unsupported schema version %d\n", version);
+    ret = RC_SQLITE3_UNSUPPORTED_SCHEMA_VERSION;
+    goto rollback;
+  }
+
+  for (; version < IOTA_SCHEMA_VERSION; version++) {
+    log_info(logger_id, "Migrating schema from version %d to %d\n", version,
+             version + 1);
+    snprintf(sql, sizeof(sql), "PRAGMA user_version = %d", version + 1);
+    if (sqlite3_exec(db, iota_schema_migrations[version], NULL, NULL,
+                     &err_msg) != SQLITE_OK ||
+        sqlite3_exec(db, sql, NULL, NULL, &err_msg) != SQLITE_OK) {
+      log_critical(logger_id, "Migrating schema failed: %s\n", err_msg);
+      sqlite3_free(err_msg);
+      ret = RC_SQLITE3_FAILED_MIGRATION;
+      goto rollback;
+    }
+  }
+
+  if (sqlite3_exec(db, "COMMIT", NULL, NULL, NULL) != SQLITE_OK) {
+    ret = RC_SQLITE3_FAILED_END;
+    goto rollback;
+  }
+
+  return RC_OK;
+
+rollback:
+  sqlite3_exec(db, "ROLLBACK", NULL, NULL, NULL);
+  return ret;
+}
+
 static retcode_t prepare_statements(sqlite3_connection_t* const connection) {
   retcode_t ret = RC_OK;
 
@@ -53,6 +126,14 @@ static retcode_t prepare_statements(sqlite3_connection_t* const connection) {
       connection->db,
       &connection->statements.transaction_select_hashes_of_milestone_candidates,
       iota_statement_transaction_select_hashes_of_milestone_candidates);
+  ret |= prepare_statement(
+      connection->db,
+      &connection->statements.transaction_select_hashes_of_solid_entry_points,
+      iota_statement_transaction_select_hashes_of_solid_entry_points);
+  ret |= prepare_statement(
+      connection->db,
+      &connection->statements.transaction_select_hashes_to_prune,
+      iota_statement_transaction_select_hashes_to_prune);
   ret |= prepare_statement(
       connection->db, &connection->statements.transaction_update_snapshot_index,
       iota_statement_transaction_update_snapshot_index);
@@ -71,6 +152,12 @@ static retcode_t prepare_statements(sqlite3_connection_t* const connection) {
   ret |= prepare_statement(connection->db,
                            &connection->statements.transaction_count,
                            iota_statement_transaction_count);
+  ret |= prepare_statement(connection->db,
+                           &connection->statements.transaction_delete,
+                           iota_statement_transaction_delete);
+  ret |= prepare_statement(connection->db,
+                           &connection->statements.missing_transaction_delete,
+                           iota_statement_missing_transaction_delete);
   ret |= prepare_statement(
       connection->db,
       &connection->statements.transaction_select_essence_and_metadata,
@@ -87,6 +174,9 @@ static retcode_t prepare_statements(sqlite3_connection_t* const connection) {
   ret |= prepare_statement(connection->db,
                            &connection->statements.transaction_select_metadata,
                            iota_statement_transaction_select_metadata);
+  ret |= prepare_statement(connection->db,
+                           &connection->statements.transaction_select_signature,
+                           iota_statement_transaction_select_signature);
   ret |= prepare_statement(connection->db,
                            &connection->statements.milestone_insert,
                            iota_statement_milestone_insert);
@@ -108,12 +198,33 @@ static retcode_t prepare_statements(sqlite3_connection_t* const connection) {
   ret |= prepare_statement(connection->db,
                            &connection->statements.milestone_exist_by_hash,
                            iota_statement_milestone_exist_by_hash);
+  ret |= prepare_statement(connection->db,
+                           &connection->statements.milestone_delete_up_to,
+                           iota_statement_milestone_delete_up_to);
   ret |= prepare_statement(connection->db,
                            &connection->statements.state_delta_store,
                            iota_statement_state_delta_store);
   ret |= prepare_statement(connection->db,
                            &connection->statements.state_delta_load,
                            iota_statement_state_delta_load);
+  ret |= prepare_statement(connection->db,
+                           &connection->statements.ledger_checkpoint_store,
+                           iota_statement_ledger_checkpoint_store);
+  ret |= prepare_statement(
+      connection->db, &connection->statements.ledger_checkpoint_select_latest,
+      iota_statement_ledger_checkpoint_select_latest);
+  ret |= prepare_statement(connection->db,
+                           &connection->statements.ledger_checkpoint_delete_old,
+                           iota_statement_ledger_checkpoint_delete_old);
+  ret |= prepare_statement(connection->db,
+                           &connection->statements.spent_address_insert,
+                           iota_statement_spent_address_insert);
+  ret |= prepare_statement(connection->db,
+                           &connection->statements.spent_address_select,
+                           iota_statement_spent_address_select);
+  ret |= prepare_statement(connection->db,
+                           &connection->statements.spent_address_exist,
+                           iota_statement_spent_address_exist);
 
   if (ret != RC_OK) {
     log_error(logger_id, "Preparing statements failed\n");
@@ -141,6 +252,10 @@ static retcode_t finalize_statements(sqlite3_connection_t* const connection) {
       connection->statements.transaction_select_hashes_of_tips);
   ret |= finalize_statement(
       connection->statements.transaction_select_hashes_of_milestone_candidates);
+  ret |= finalize_statement(
+      connection->statements.transaction_select_hashes_of_solid_entry_points);
+  ret |= finalize_statement(
+      connection->statements.transaction_select_hashes_to_prune);
   ret |= finalize_statement(
       connection->statements.transaction_update_snapshot_index);
   ret |=
@@ -149,6 +264,8 @@ static retcode_t finalize_statements(sqlite3_connection_t* const connection) {
   ret |= finalize_statement(connection->statements.transaction_exist_by_hash);
   ret |= finalize_statement(connection->statements.transaction_approvers_count);
   ret |= finalize_statement(connection->statements.transaction_count);
+  ret |= finalize_statement(connection->statements.transaction_delete);
+  ret |= finalize_statement(connection->statements.missing_transaction_delete);
   ret |= finalize_statement(
       connection->statements.transaction_select_essence_and_metadata);
   ret |= finalize_statement(
@@ -157,6 +274,8 @@ static retcode_t finalize_statements(sqlite3_connection_t* const connection) {
   ret |= finalize_statement(
       connection->statements.transaction_select_essence_and_consensus);
   ret |= finalize_statement(connection->statements.transaction_select_metadata);
+  ret |=
+      finalize_statement(connection->statements.transaction_select_signature);
   ret |= finalize_statement(connection->statements.milestone_insert);
   ret |= finalize_statement(connection->statements.milestone_select_by_hash);
   ret |= finalize_statement(connection->statements.milestone_select_first);
@@ -164,8 +283,16 @@ static retcode_t finalize_statements(sqlite3_connection_t* const connection) {
   ret |= finalize_statement(connection->statements.milestone_select_next);
   ret |= finalize_statement(connection->statements.milestone_exist);
   ret |= finalize_statement(connection->statements.milestone_exist_by_hash);
+  ret |= finalize_statement(connection->statements.milestone_delete_up_to);
   ret |= finalize_statement(connection->statements.state_delta_store);
   ret |= finalize_statement(connection->statements.state_delta_load);
+  ret |= finalize_statement(connection->statements.ledger_checkpoint_store);
+  ret |= finalize_statement(
+      connection->statements.ledger_checkpoint_select_latest);
+  ret |= finalize_statement(connection->statements.ledger_checkpoint_delete_old);
+  ret |= finalize_statement(connection->statements.spent_address_insert);
+  ret |= finalize_statement(connection->statements.spent_address_select);
+  ret |= finalize_statement(connection->statements.spent_address_exist);
 
   if (ret != RC_OK) {
     log_error(logger_id, "Finalizing statements failed\n");
@@ -180,6 +307,7 @@ retcode_t connection_init(storage_connection_t* const connection,
   char* err_msg = NULL;
   char* sql = NULL;
   int rc = 0;
+  retcode_t ret = RC_OK;
 
   if (connection == NULL) {
     return RC_NULL_PARAM;
@@ -216,6 +344,10 @@ retcode_t connection_init(storage_connection_t* const connection,
     return RC_SQLITE3_FAILED_INSERT_DB;
   }
 
+  if ((ret = migrate_schema(sqlite3_connection->db)) != RC_OK) {
+    return ret;
+  }
+
   return prepare_statements(sqlite3_connection);
 }
 
@@ -235,3 +367,15 @@ retcode_t connection_destroy(storage_connection_t* const connection) {
 
   return ret;
 }
+
+retcode_t connection_drop_db(connection_config_t const* const config) {
+  if (config->db_path == NULL) {
+    return RC_SQLITE3_NO_PATH_FOR_DB_SPECIFIED;
+  }
+
+  if (remove(config->db_path) != 0) {
+    return RC_SQLITE3_FAILED_OPEN_DB;
+  }
+
+  return RC_OK;
+}
@@ -99,6 +99,9 @@ static void select_transactions_populate_from_row_essence_and_consensus(
 static void select_transactions_populate_from_row_metadata(
     sqlite3_stmt* const statement, iota_transaction_t* const tx);
 
+static void select_transactions_populate_from_row_signature(
+    sqlite3_stmt* const statement, iota_transaction_t* const tx);
+
 enum load_model {
   MODEL_TRANSACTION,
   MODEL_HASH,
@@ -107,6 +110,7 @@ enum load_model {
   MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA,
   MODEL_TRANSACTION_MODEL_ESSENCE_CONSENSUS,
   MODEL_TRANSACTION_MODEL_METADATA,
+  MODEL_TRANSACTION_MODEL_SIGNATURE,
 };
 
 static retcode_t execute_statement_load_gen(
@@ -141,6 +145,9 @@ static retcode_t execute_statement_load_gen(
     } else if (model == MODEL_TRANSACTION_MODEL_METADATA) {
       select_transactions_populate_from_row_metadata(
           sqlite_statement, pack->models[pack->num_loaded++]);
+    } else if (model == MODEL_TRANSACTION_MODEL_SIGNATURE) {
+      select_transactions_populate_from_row_signature(
+          sqlite_statement, pack->models[pack->num_loaded++]);
     } else {
       return RC_SQLITE3_FAILED_NOT_IMPLEMENTED;
     }
@@ -292,6 +299,12 @@ static retcode_t execute_statement_load_transaction_metadata(
                                     MODEL_TRANSACTION_MODEL_METADATA);
 }
 
+static retcode_t execute_statement_load_transaction_signature(
+    sqlite3_stmt* const sqlite_statement, iota_stor_pack_t* const pack) {
+  return execute_statement_load_gen(sqlite_statement, pack, pack->capacity,
+                                    MODEL_TRANSACTION_MODEL_SIGNATURE);
+}
+
 static void select_transactions_populate_from_row(
     sqlite3_stmt* const statement, iota_transaction_t* const tx) {
   column_decompress_load(statement, 0, tx->data.signature_or_message,
@@ -404,6 +417,13 @@ static void select_transactions_populate_from_row_metadata(
   transaction_set_arrival_timestamp(tx, sqlite3_column_int64(statement, 2));
 }
 
+static void select_transactions_populate_from_row_signature(
+    sqlite3_stmt* const statement, iota_transaction_t* const tx) {
+  column_decompress_load(statement, 0, tx->data.signature_or_message,
+                         FLEX_TRIT_SIZE_6561);
+  tx->loaded_columns_mask.data |= MASK_DATA_SIG_OR_MSG;
+}
+
 retcode_t iota_stor_transaction_count(
     storage_connection_t const* const connection, size_t* const count) {
   sqlite3_connection_t const* sqlite3_connection =
@@ -619,6 +639,31 @@ done:
   return ret;
 }
 
+retcode_t iota_stor_transaction_load_signature(
+    storage_connection_t const* const connection, flex_trit_t const* const hash,
+    iota_stor_pack_t* const pack) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement =
+      sqlite3_connection->statements.transaction_select_signature;
+
+  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) !=
+      RC_OK) {
+    ret = RC_SQLITE3_FAILED_BINDING;
+    goto done;
+  }
+
+  if ((ret = execute_statement_load_transaction_signature(sqlite_statement,
+                                                          pack)) != RC_OK) {
+    goto done;
+  }
+
+done:
+  sqlite3_reset(sqlite_statement);
+  return ret;
+}
+
 retcode_t iota_stor_transaction_load_hashes(
     storage_connection_t const* const connection,
     transaction_field_t const field, flex_trit_t const* const key,
@@ -762,6 +807,115 @@ done:
   return ret;
 }
 
+retcode_t iota_stor_transaction_load_hashes_of_solid_entry_points(
+    storage_connection_t const* const connection, uint64_t const snapshot_index,
+    iota_stor_pack_t* const pack) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement =
+      sqlite3_connection->statements
+          .transaction_select_hashes_of_solid_entry_points;
+
+  if (sqlite3_bind_int64(sqlite_statement, 1, snapshot_index) != SQLITE_OK) {
+    ret = RC_SQLITE3_FAILED_BINDING;
+    goto done;
+  }
+
+  if ((ret = execute_statement_load_hashes(sqlite_statement, pack)) != RC_OK) {
+    goto done;
+  }
+
+done:
+  sqlite3_reset(sqlite_statement);
+  return ret;
+}
+
+static retcode_t delete_hash(sqlite3_stmt* const sqlite_statement,
+                             flex_trit_t const* const hash) {
+  retcode_t ret = RC_OK;
+
+  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) !=
+      RC_OK) {
+    ret = RC_SQLITE3_FAILED_BINDING;
+    goto done;
+  }
+
+  ret = execute_statement_store_update(sqlite_statement);
+
+done:
+  sqlite3_reset(sqlite_statement);
+  return ret;
+}
+
+retcode_t iota_stor_transactions_prune(
+    storage_connection_t const* const connection, uint64_t const snapshot_index,
+    size_t const limit, size_t* const count) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  retcode_t ret_rollback = RC_OK;
+  sqlite3_stmt* sqlite_statement =
+      sqlite3_connection->statements.transaction_select_hashes_to_prune;
+  iota_stor_pack_t pack;
+  bool should_rollback_if_failed = false;
+
+  *count = 0;
+
+  if ((ret = hash_pack_init(&pack, limit)) != RC_OK) {
+    return ret;
+  }
+
+  if (sqlite3_bind_int64(sqlite_statement, 1, snapshot_index) != SQLITE_OK ||
+      sqlite3_bind_int64(sqlite_statement, 2, limit) != SQLITE_OK) {
+    ret = RC_SQLITE3_FAILED_BINDING;
+    goto done;
+  }
+
+  if ((ret = execute_statement_load_hashes(sqlite_statement, &pack)) !=
+      RC_OK) {
+    goto done;
+  }
+  sqlite3_reset(sqlite_statement);
+
+  if (pack.num_loaded == 0) {
+    goto done;
+  }
+
+  if ((ret = begin_transaction(sqlite3_connection->db)) != RC_OK) {
+    goto done;
+  }
+  should_rollback_if_failed = true;
+
+  // Parents of pruned transactions are not missing, they are gone for good
+  for (size_t i = 0; i < pack.num_loaded; i++) {
+    if ((ret = delete_hash(sqlite3_connection->statements.transaction_delete,
+                           (flex_trit_t*)pack.models[i])) != RC_OK ||
+        (ret = delete_hash(
+             sqlite3_connection->statements.missing_transaction_delete,
+             (flex_trit_t*)pack.models[i])) != RC_OK) {
+      goto done;
+    }
+  }
+
+  if ((ret = end_transaction(sqlite3_connection->db)) != RC_OK) {
+    goto done;
+  }
+  should_rollback_if_failed = false;
+  *count = pack.num_loaded;
+
+done:
+  sqlite3_reset(sqlite_statement);
+  hash_pack_free(&pack);
+  if (ret != RC_OK && should_rollback_if_failed) {
+    if ((ret_rollback = rollback_transaction(sqlite3_connection->db)) !=
+        RC_OK) {
+      return ret_rollback;
+    }
+  }
+  return ret;
+}
+
 retcode_t iota_stor_transaction_update_solid_state(
     storage_connection_t const* const connection, flex_trit_t const* const hash,
     bool const is_solid) {
@@ -998,6 +1152,131 @@ done:
   return ret;
 }
 
+/*
+ * Cursor operations
+ */
+
+/**
+ * The key is bound from the cursor itself since statements don't copy their
+ * bound blobs and the cursor may outlive the caller key
+ */
+static retcode_t cursor_open(sqlite3_stmt* const sqlite_statement,
+                             flex_trit_t const* const key,
+                             int64_t const before_timestamp,
+                             size_t const num_key_bindings,
+                             iota_stor_cursor_t* const cursor) {
+  cursor->handle = NULL;
+  cursor->started = false;
+  cursor->before_timestamp = before_timestamp;
+  memcpy(cursor->key, key, FLEX_TRIT_SIZE_243);
+
+  for (size_t i = 1; i <= num_key_bindings; i++) {
+    if (column_compress_bind(sqlite_statement, i, cursor->key,
+                             FLEX_TRIT_SIZE_243) != RC_OK) {
+      goto fail;
+    }
+  }
+  if (before_timestamp != 0 &&
+      sqlite3_bind_int64(sqlite_statement, num_key_bindings + 1,
+                         before_timestamp) != SQLITE_OK) {
+    goto fail;
+  }
+  cursor->handle = sqlite_statement;
+
+  return RC_OK;
+
+fail:
+  sqlite3_reset(sqlite_statement);
+  return RC_SQLITE3_FAILED_BINDING;
+}
+
+retcode_t iota_stor_transaction_cursor_hashes(
+    storage_connection_t const* const connection,
+    transaction_field_t const field, flex_trit_t const* const key,
+    iota_stor_cursor_t* const cursor) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+
+  switch (field) {
+    case TRANSACTION_FIELD_ADDRESS:
+      return cursor_open(
+          sqlite3_connection->statements.transaction_select_hashes_by_address,
+          key, 0, 1, cursor);
+    default:
+      return RC_SQLITE3_FAILED_NOT_IMPLEMENTED;
+  }
+}
+
+retcode_t iota_stor_transaction_cursor_hashes_of_approvers(
+    storage_connection_t const* const connection,
+    flex_trit_t const* const approvee_hash, int64_t const before_timestamp,
+    iota_stor_cursor_t* const cursor) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+
+  return cursor_open(
+      before_timestamp != 0
+          ? sqlite3_connection->statements
+                .transaction_select_hashes_of_approvers_before_date
+          : sqlite3_connection->statements
+                .transaction_select_hashes_of_approvers,
+      approvee_hash, before_timestamp, 2, cursor);
+}
+
+retcode_t iota_stor_cursor_next(iota_stor_cursor_t* const cursor,
+                                flex_trit_t const** const hash) {
+  sqlite3_stmt* sqlite_statement = (sqlite3_stmt*)cursor->handle;
+  int rc = 0;
+
+  *hash = NULL;
+  if (sqlite_statement == NULL) {
+    return RC_OK;
+  }
+
+  cursor->started = true;
+  if ((rc = sqlite3_step(sqlite_statement)) == SQLITE_ROW) {
+    // Hashes are stored trimmed of their trailing null trits
+    if (sqlite3_column_bytes(sqlite_statement, 0) == FLEX_TRIT_SIZE_243) {
+      *hash = sqlite3_column_blob(sqlite_statement, 0);
+    } else {
+      column_decompress_load(sqlite_statement, 0, cursor->hash,
+                             FLEX_TRIT_SIZE_243);
+      *hash = cursor->hash;
+    }
+    return RC_OK;
+  }
+
+  iota_stor_cursor_close(cursor);
+  return rc == SQLITE_DONE ? RC_OK : RC_SQLITE3_FAILED_STEP;
+}
+
+retcode_t iota_stor_cursor_read(iota_stor_cursor_t* const cursor,
+                                flex_trit_t* const hashes,
+                                size_t const capacity, size_t* const count) {
+  flex_trit_t const* hash = NULL;
+  retcode_t ret = RC_OK;
+
+  for (*count = 0; *count < capacity; (*count)++) {
+    if ((ret = iota_stor_cursor_next(cursor, &hash)) != RC_OK ||
+        hash == NULL) {
+      break;
+    }
+    memcpy(hashes + *count * FLEX_TRIT_SIZE_243, hash, FLEX_TRIT_SIZE_243);
+  }
+
+  return ret;
+}
+
+retcode_t iota_stor_cursor_close(iota_stor_cursor_t* const cursor) {
+  if (cursor->handle != NULL) {
+    // Statements are owned by the connection and only need to be reset
+    sqlite3_reset((sqlite3_stmt*)cursor->handle);
+    cursor->handle = NULL;
+  }
+
+  return RC_OK;
+}
+
 /*
  * Milestone operations
  */
@@ -1159,6 +1438,28 @@ done:
   return ret;
 }
 
+retcode_t iota_stor_milestones_delete(
+    storage_connection_t const* const connection, uint64_t const index) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement =
+      sqlite3_connection->statements.milestone_delete_up_to;
+
+  if (sqlite3_bind_int64(sqlite_statement, 1, index) != SQLITE_OK) {
+    ret = RC_SQLITE3_FAILED_BINDING;
+    goto done;
+  }
+
+  if ((ret = execute_statement_store_update(sqlite_statement)) != RC_OK) {
+    goto done;
+  }
+
+done:
+  sqlite3_reset(sqlite_statement);
+  return ret;
+}
+
 /*
  * State delta operations
  */
@@ -1236,3 +1537,256 @@ done:
   sqlite3_reset(sqlite_statement);
   return ret;
 }
+
+retcode_t iota_stor_state_delta_load_serialized(
+    storage_connection_t const* const connection, uint64_t const index,
+    byte_t** const bytes, size_t* const size) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  int rc = 0;
+  sqlite3_stmt* sqlite_statement =
+      sqlite3_connection->statements.state_delta_load;
+
+  *bytes = NULL;
+  *size = 0;
+
+  if (sqlite3_bind_int(sqlite_statement, 1, index) != SQLITE_OK) {
+    ret = RC_SQLITE3_FAILED_BINDING;
+    goto done;
+  }
+
+  rc = sqlite3_step(sqlite_statement);
+  if (rc == SQLITE_ROW) {
+    // The blob only lives until the statement is reset
+    if ((*size = sqlite3_column_bytes(sqlite_statement, 0)) != 0) {
+      if ((*bytes = (byte_t*)malloc(*size)) == NULL) {
+        *size = 0;
+        ret = RC_STORAGE_OOM;
+        goto done;
+      }
+      memcpy(*bytes, sqlite3_column_blob(sqlite_statement, 0), *size);
+    }
+  } else if (rc != SQLITE_OK && rc != SQLITE_DONE) {
+    ret = RC_SQLITE3_FAILED_STEP;
+  }
+
+done:
+  sqlite3_reset(sqlite_statement);
+  return ret;
+}
+
+/*
+ * Ledger checkpoint operations
+ */
+
+retcode_t iota_stor_ledger_checkpoint_store(
+    storage_connection_t const* const connection, uint64_t const index,
+    flex_trit_t const* const hash, state_delta_t const* const state,
+    size_t const kept) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  retcode_t ret_rollback;
+  size_t size = 0;
+  byte_t* bytes = NULL;
+  sqlite3_stmt* store_statement =
+      sqlite3_connection->statements.ledger_checkpoint_store;
+  sqlite3_stmt* delete_statement =
+      sqlite3_connection->statements.ledger_checkpoint_delete_old;
+
+  size = state_delta_serialized_size(state);
+  if ((bytes = (byte_t*)calloc(size, sizeof(byte_t))) == NULL) {
+    return RC_STORAGE_OOM;
+  }
+  if ((ret = state_delta_serialize(state, bytes)) != RC_OK) {
+    free(bytes);
+    return ret;
+  }
+
+  if ((ret = begin_transaction(sqlite3_connection->db)) != RC_OK) {
+    free(bytes);
+    return ret;
+  }
+
+  if (sqlite3_bind_int64(store_statement, 1, index) != SQLITE_OK ||
+      column_compress_bind(store_statement, 2, hash, FLEX_TRIT_SIZE_243) !=
+          RC_OK ||
+      sqlite3_bind_blob(store_statement, 3, bytes, size, NULL) != SQLITE_OK ||
+      sqlite3_bind_int64(delete_statement, 1, kept) != SQLITE_OK) {
+    ret = RC_SQLITE3_FAILED_BINDING;
+    goto done;
+  }
+  if ((ret = execute_statement_store_update(store_statement)) != RC_OK) {
+    goto done;
+  }
+  ret = execute_statement_store_update(delete_statement);
+
+done:
+  sqlite3_reset(store_statement);
+  sqlite3_reset(delete_statement);
+  free(bytes);
+  if (ret != RC_OK) {
+    if ((ret_rollback = rollback_transaction(sqlite3_connection->db)) !=
+        RC_OK) {
+      return ret_rollback;
+    }
+    return ret;
+  }
+  return end_transaction(sqlite3_connection->db);
+}
+
+retcode_t iota_stor_ledger_checkpoint_load_latest(
+    storage_connection_t const* const connection, uint64_t const below_index,
+    uint64_t* const index, flex_trit_t* const hash, state_delta_t* const state) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  int rc = 0;
+  sqlite3_stmt* sqlite_statement =
+      sqlite3_connection->statements.ledger_checkpoint_select_latest;
+
+  *index = 0;
+  *state = NULL;
+
+  if (sqlite3_bind_int64(sqlite_statement, 1,
+                         below_index > INT64_MAX ? INT64_MAX : below_index) !=
+      SQLITE_OK) {
+    ret = RC_SQLITE3_FAILED_BINDING;
+    goto done;
+  }
+
+  rc = sqlite3_step(sqlite_statement);
+  if (rc == SQLITE_ROW) {
+    column_decompress_load(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243);
+    if ((ret = state_delta_deserialize(
+             (byte_t*)sqlite3_column_blob(sqlite_statement, 2),
+             sqlite3_column_bytes(sqlite_statement, 2), state)) != RC_OK) {
+      goto done;
+    }
+    *index = sqlite3_column_int64(sqlite_statement, 0);
+  } else if (rc != SQLITE_OK && rc != SQLITE_DONE) {
+    ret = RC_SQLITE3_FAILED_STEP;
+  }
+
+done:
+  sqlite3_reset(sqlite_statement);
+  return ret;
+}
+
+/*
+ * Spent address operations
+ */
+
+static retcode_t bind_execute_spent_address_do_func(
+    bind_execute_hash_params_t* const params, flex_trit_t const* const hash) {
+  int reset_ret = sqlite3_reset(params->sqlite_statement);
+
+  if (reset_ret != SQLITE_DONE && reset_ret != SQLITE_OK) {
+    return RC_SQLITE3_FAILED_BINDING;
+  }
+
+  if (column_compress_bind(params->sqlite_statement, 1, hash,
+                           FLEX_TRIT_SIZE_243) != RC_OK) {
+    return RC_SQLITE3_FAILED_BINDING;
+  }
+
+  return execute_statement_store_update(params->sqlite_statement);
+}
+
+retcode_t iota_stor_spent_address_store(
+    storage_connection_t const* const connection,
+    flex_trit_t const* const address) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement =
+      sqlite3_connection->statements.spent_address_insert;
+
+  if (column_compress_bind(sqlite_statement, 1, address, FLEX_TRIT_SIZE_243) !=
+      RC_OK) {
+    ret = RC_SQLITE3_FAILED_BINDING;
+    goto done;
+  }
+
+  if ((ret = execute_statement_store_update(sqlite_statement)) != RC_OK) {
+    goto done;
+  }
+
+done:
+  sqlite3_reset(sqlite_statement);
+  return ret;
+}
+
+retcode_t iota_stor_spent_addresses_store(
+    storage_connection_t const* const connection,
+    hash243_set_t const addresses) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  retcode_t ret_rollback = RC_OK;
+  sqlite3_stmt* sqlite_statement =
+      sqlite3_connection->statements.spent_address_insert;
+  bind_execute_hash_params_t params = {.sqlite_statement = sqlite_statement};
+
+  if ((ret = begin_transaction(sqlite3_connection->db)) != RC_OK) {
+    return ret;
+  }
+
+  ret = hash243_set_for_each(
+      &addresses, (hash243_on_container_func)bind_execute_spent_address_do_func,
+      &params);
+  sqlite3_reset(sqlite_statement);
+
+  if (ret != RC_OK) {
+    if ((ret_rollback = rollback_transaction(sqlite3_connection->db)) !=
+        RC_OK) {
+      return ret_rollback;
+    }
+    return ret;
+  }
+
+  return end_transaction(sqlite3_connection->db);
+}
+
+retcode_t iota_stor_spent_address_exist(
+    storage_connection_t const* const connection,
+    flex_trit_t const* const address, bool* const exist) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement =
+      sqlite3_connection->statements.spent_address_exist;
+
+  if (column_compress_bind(sqlite_statement, 1, address, FLEX_TRIT_SIZE_243) !=
+      RC_OK) {
+    ret = RC_SQLITE3_FAILED_BINDING;
+    goto done;
+  }
+
+  if ((ret = execute_statement_exist(sqlite_statement, exist)) != RC_OK) {
+    goto done;
+  }
+
+done:
+  sqlite3_reset(sqlite_statement);
+  return ret;
+}
+
+retcode_t iota_stor_spent_addresses_load(
+    storage_connection_t const* const connection,
+    iota_stor_pack_t* const pack) {
+  sqlite3_connection_t const* sqlite3_connection =
+      (sqlite3_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement =
+      sqlite3_connection->statements.spent_address_select;
+
+  if ((ret = execute_statement_load_hashes(sqlite_statement, pack)) != RC_OK) {
+    goto done;
+  }
+
+done:
+  sqlite3_reset(sqlite_statement);
+  return ret;
+}
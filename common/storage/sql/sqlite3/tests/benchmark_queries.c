@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sqlite3.h>
+
+#include "common/model/transaction.h"
+#include "common/storage/defs.h"
+#include "common/storage/sql/sqlite3/connection.h"
+#include "common/storage/sql/statements.h"
+#include "common/storage/storage.h"
+#include "utils/files.h"
+#include "utils/macros.h"
+
+// Times the hot transaction queries on a generated tangle against the current
+// schema and against a copy of the transactions indexed as in schema version
+// 0, i.e. with a duplicate hash index and non covering indexes
+//
+// usage: benchmark_queries [num_rows...]
+
+#define NUM_LOOKUPS 10000
+#define BATCH_SIZE 100000
+#define NUM_ADDRESSES 10000
+#define MILESTONE_INTERVAL 100
+#define TIPS_WINDOW 100
+#define MESSAGE_SIZE 100
+
+static char *test_db_path = "common/storage/sql/sqlite3/tests/benchmark.db";
+static char *ciri_db_path = "common/storage/sql/sqlite3/tests/ciri.db";
+
+static char *legacy_layout =
+    "CREATE TABLE legacy_transaction AS SELECT * FROM " TRANSACTION_TABLE_NAME
+    ";"
+    "CREATE UNIQUE INDEX legacy_primary_key ON legacy_transaction(hash);"
+    "CREATE INDEX legacy_hash_index ON legacy_transaction(hash);"
+    "CREATE INDEX legacy_address_index ON legacy_transaction(address);"
+    "CREATE INDEX legacy_trunk_index ON legacy_transaction(trunk);"
+    "CREATE INDEX legacy_branch_index ON legacy_transaction(branch);"
+    "VACUUM;"
+    "ANALYZE;";
+
+static char *legacy_select_by_hash =
+    "SELECT signature_or_message,address,value,obsolete_tag,timestamp,"
+    "current_index,last_index,bundle,trunk,branch,tag,attachment_timestamp,"
+    "attachment_timestamp_upper,attachment_timestamp_lower,nonce,hash FROM "
+    "legacy_transaction WHERE hash=?";
+
+static char *legacy_approvers =
+    "SELECT hash FROM legacy_transaction WHERE branch=? OR trunk=?";
+
+static char *legacy_approvers_count =
+    "SELECT COUNT(*) FROM legacy_transaction WHERE branch=? OR trunk=?";
+
+static char *legacy_exist_by_hash =
+    "SELECT 1 WHERE EXISTS(SELECT 1 FROM legacy_transaction WHERE hash=?)";
+
+static char *legacy_milestone_candidates =
+    "SELECT hash FROM legacy_transaction WHERE address LIKE ? EXCEPT SELECT "
+    "hash FROM iota_milestone";
+
+static double elapsed_ms(struct timespec const *const start,
+                         struct timespec const *const end) {
+  return (end->tv_sec - start->tv_sec) * 1e3 +
+         (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+ * Hashes are spread over the key space like real ones so that inserts don't
+ * append to the primary key
+ */
+static void index_to_hash(flex_trit_t *const hash, uint64_t const index,
+                          uint64_t const salt) {
+  uint64_t x = index * 0x9E3779B97F4A7C15ULL + salt;
+
+  memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+  for (size_t i = 0; i < FLEX_TRIT_SIZE_243 - 1; i += sizeof(x)) {
+    x ^= x >> 31;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    memcpy(hash + i, &x,
+           MIN(sizeof(x), (size_t)(FLEX_TRIT_SIZE_243 - 1 - i)));
+  }
+  // Avoids trailing null values that would be trimmed by the storage
+  hash[FLEX_TRIT_SIZE_243 - 1] = 1;
+}
+
+/**
+ * Bundles of 1 to 4 transactions chained by their trunks, the last one
+ * approving recent transactions. Every MILESTONE_INTERVAL bundle is issued by
+ * the coordinator and a quarter of the bundles carry full signatures.
+ */
+static retcode_t populate(storage_connection_t const *const connection,
+                          uint64_t const num_rows) {
+  retcode_t ret = RC_OK;
+  sqlite3 *db = ((sqlite3_connection_t *)connection->actual)->db;
+  iota_transaction_t tx;
+  flex_trit_t buffer[FLEX_TRIT_SIZE_6561];
+  uint64_t bundle_index = 0;
+  size_t bundle_size = 0, last_index = 0;
+
+  transaction_reset(&tx);
+  memset(buffer, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_6561);
+  transaction_set_value(&tx, 0);
+  transaction_set_obsolete_tag(&tx, buffer);
+  transaction_set_tag(&tx, buffer);
+  transaction_set_nonce(&tx, buffer);
+  transaction_set_attachment_timestamp(&tx, 0);
+  transaction_set_attachment_timestamp_lower(&tx, 0);
+  transaction_set_attachment_timestamp_upper(&tx, 0);
+
+  srand(42);
+  sqlite3_exec(db, "BEGIN", NULL, NULL, NULL);
+  for (uint64_t i = 0; i < num_rows; i++) {
+    if (bundle_size == 0) {
+      bundle_index++;
+      last_index = rand() % 4;
+      bundle_size = last_index + 1;
+      index_to_hash(buffer, bundle_index, 1);
+      transaction_set_bundle(&tx, buffer);
+      if (bundle_index % MILESTONE_INTERVAL == 0) {
+        index_to_hash(buffer, 0, 2);
+      } else {
+        index_to_hash(buffer, 1 + rand() % NUM_ADDRESSES, 2);
+      }
+      transaction_set_address(&tx, buffer);
+      memset(buffer, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_6561);
+      memset(buffer, 1, rand() % 4 == 0 ? FLEX_TRIT_SIZE_6561 : MESSAGE_SIZE);
+      transaction_set_signature(&tx, buffer);
+    }
+    bundle_size--;
+
+    index_to_hash(buffer, i, 0);
+    transaction_set_hash(&tx, buffer);
+    transaction_set_current_index(&tx, last_index - bundle_size);
+    transaction_set_last_index(&tx, last_index);
+    transaction_set_timestamp(&tx, i);
+    if (bundle_size > 0 || i < TIPS_WINDOW) {
+      // Bundles are attached from their last transaction, the head first
+      index_to_hash(buffer, i + 1, 0);
+      transaction_set_trunk(&tx, buffer);
+      index_to_hash(buffer, i < TIPS_WINDOW ? num_rows : i + 1, 0);
+      transaction_set_branch(&tx, buffer);
+    } else {
+      index_to_hash(buffer, i - 1 - rand() % TIPS_WINDOW, 0);
+      transaction_set_trunk(&tx, buffer);
+      index_to_hash(buffer, i - 1 - rand() % TIPS_WINDOW, 0);
+      transaction_set_branch(&tx, buffer);
+    }
+
+    if ((ret = iota_stor_transaction_store(connection, &tx)) != RC_OK) {
+      goto done;
+    }
+    if ((i + 1) % BATCH_SIZE == 0) {
+      sqlite3_exec(db, "COMMIT", NULL, NULL, NULL);
+      sqlite3_exec(db, "BEGIN", NULL, NULL, NULL);
+    }
+  }
+
+done:
+  sqlite3_exec(db, "COMMIT", NULL, NULL, NULL);
+  return ret;
+}
+
+/**
+ * Runs a statement for each key, all parameters being bound to the key
+ *
+ * @return the average duration of a run in microseconds
+ */
+static double time_lookups(sqlite3 *const db, char const *const statement,
+                           flex_trit_t keys[][FLEX_TRIT_SIZE_243],
+                           size_t const num_keys) {
+  sqlite3_stmt *sqlite_statement = NULL;
+  struct timespec start, end;
+  int num_params = 0;
+
+  if (sqlite3_prepare_v2(db, statement, -1, &sqlite_statement, NULL) !=
+      SQLITE_OK) {
+    fprintf(stderr, "%s\n", sqlite3_errmsg(db));
+    return -1;
+  }
+  num_params = sqlite3_bind_parameter_count(sqlite_statement);
+
+  // Warms the page cache up
+  for (size_t i = 0; i < num_keys; i++) {
+    for (int j = 1; j <= num_params; j++) {
+      sqlite3_bind_blob(sqlite_statement, j, keys[i], FLEX_TRIT_SIZE_243,
+                        SQLITE_STATIC);
+    }
+    while (sqlite3_step(sqlite_statement) == SQLITE_ROW)
+      ;
+    sqlite3_reset(sqlite_statement);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < num_keys; i++) {
+    for (int j = 1; j <= num_params; j++) {
+      sqlite3_bind_blob(sqlite_statement, j, keys[i], FLEX_TRIT_SIZE_243,
+                        SQLITE_STATIC);
+    }
+    while (sqlite3_step(sqlite_statement) == SQLITE_ROW)
+      ;
+    sqlite3_reset(sqlite_statement);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  sqlite3_finalize(sqlite_statement);
+
+  return elapsed_ms(&start, &end) * 1e3 / num_keys;
+}
+
+static void print_lookups(sqlite3 *const db, char const *const name,
+                          char const *const statement,
+                          char const *const legacy_statement,
+                          flex_trit_t keys[][FLEX_TRIT_SIZE_243],
+                          size_t const num_keys) {
+  printf("  %-21s %10.3f us (version 0 %10.3f us)\n", name,
+         time_lookups(db, statement, keys, num_keys),
+         time_lookups(db, legacy_statement, keys, num_keys));
+}
+
+static retcode_t benchmark(uint64_t const num_rows) {
+  retcode_t ret = RC_OK;
+  storage_connection_t connection;
+  connection_config_t config = {.db_path = test_db_path};
+  flex_trit_t(*keys)[FLEX_TRIT_SIZE_243] = NULL;
+  flex_trit_t coordinator[1][FLEX_TRIT_SIZE_243];
+  struct timespec start, end;
+  sqlite3 *db = NULL;
+
+  if ((keys = malloc(NUM_LOOKUPS * FLEX_TRIT_SIZE_243)) == NULL) {
+    return RC_OOM;
+  }
+  for (size_t i = 0; i < NUM_LOOKUPS; i++) {
+    index_to_hash(keys[i], rand() % num_rows, 0);
+  }
+  index_to_hash(coordinator[0], 0, 2);
+
+  copy_file(test_db_path, ciri_db_path);
+  if ((ret = connection_init(&connection, &config)) != RC_OK) {
+    goto done;
+  }
+  db = ((sqlite3_connection_t *)connection.actual)->db;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  if ((ret = populate(&connection, num_rows)) != RC_OK) {
+    goto done;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("%" PRIu64 " rows inserted in %.0f ms\n", num_rows,
+         elapsed_ms(&start, &end));
+
+  if (sqlite3_exec(db, legacy_layout, NULL, NULL, NULL) != SQLITE_OK) {
+    fprintf(stderr, "%s\n", sqlite3_errmsg(db));
+    ret = RC_SQLITE3_FAILED_INSERT_DB;
+    goto done;
+  }
+
+  print_lookups(db, "select by hash:", iota_statement_transaction_select_by_hash,
+                legacy_select_by_hash, keys, NUM_LOOKUPS);
+  print_lookups(db, "exist by hash:",
+                iota_statement_transaction_exist_by_hash, legacy_exist_by_hash,
+                keys, NUM_LOOKUPS);
+  print_lookups(db, "approvers:",
+                iota_statement_transaction_select_hashes_of_approvers,
+                legacy_approvers, keys, NUM_LOOKUPS);
+  print_lookups(db, "approvers count:",
+                iota_statement_transaction_approvers_count,
+                legacy_approvers_count, keys, NUM_LOOKUPS);
+  printf("  %-21s %10.3f us (version 0 %10.3f us)\n", "milestone candidates:",
+         time_lookups(
+             db, iota_statement_transaction_select_hashes_of_milestone_candidates,
+             coordinator, 1),
+         time_lookups(db, legacy_milestone_candidates, coordinator, 1));
+
+  ret = connection_destroy(&connection);
+
+done:
+  free(keys);
+  remove_file(test_db_path);
+  return ret;
+}
+
+int main(int argc, char *argv[]) {
+  uint64_t default_rows[] = {100000, 1000000};
+
+  if (storage_init() != RC_OK) {
+    return EXIT_FAILURE;
+  }
+
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++) {
+      if (benchmark(strtoull(argv[i], NULL, 10)) != RC_OK) {
+        return EXIT_FAILURE;
+      }
+    }
+  } else {
+    for (size_t i = 0; i < sizeof(default_rows) / sizeof(default_rows[0]);
+         i++) {
+      if (benchmark(default_rows[i]) != RC_OK) {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return storage_destroy() == RC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
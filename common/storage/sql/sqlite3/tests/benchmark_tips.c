@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sqlite3.h>
+
+#include "common/model/transaction.h"
+#include "common/storage/defs.h"
+#include "common/storage/sql/sqlite3/connection.h"
+#include "common/storage/storage.h"
+#include "utils/files.h"
+
+// Times the tips, missing transactions and count queries on databases of
+// growing size, along with the anti-join scans they replace
+//
+// usage: benchmark_tips [num_rows...]
+
+#define NUM_RUNS 10
+#define QUERY_LIMIT 100
+#define BATCH_SIZE 100000
+
+static char *test_db_path = "common/storage/sql/sqlite3/tests/benchmark.db";
+static char *ciri_db_path = "common/storage/sql/sqlite3/tests/ciri.db";
+
+static char *legacy_tips =
+    "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME
+    " a WHERE NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME
+    " b WHERE b." TRANSACTION_COL_TRUNK " = a." TRANSACTION_COL_HASH
+    " OR b." TRANSACTION_COL_BRANCH " = a." TRANSACTION_COL_HASH ")) LIMIT ?";
+
+static char *legacy_requests =
+    "SELECT " TRANSACTION_COL_TRUNK " FROM " TRANSACTION_TABLE_NAME
+    " a WHERE NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME
+    " b WHERE b." TRANSACTION_COL_HASH " = a." TRANSACTION_COL_TRUNK
+    ")) UNION SELECT " TRANSACTION_COL_BRANCH " FROM " TRANSACTION_TABLE_NAME
+    " a WHERE NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME
+    " b WHERE b." TRANSACTION_COL_HASH " = a." TRANSACTION_COL_BRANCH
+    ")) LIMIT ?";
+
+static char *legacy_count = "SELECT COUNT(*) FROM " TRANSACTION_TABLE_NAME;
+
+static double elapsed_ms(struct timespec const *const start,
+                         struct timespec const *const end) {
+  return (end->tv_sec - start->tv_sec) * 1e3 +
+         (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static void index_to_hash(flex_trit_t *const hash, uint64_t const index) {
+  memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+  // Avoids trailing null values that would be trimmed by the storage
+  hash[0] = 1;
+  memcpy(hash + 1, &index, sizeof(index));
+}
+
+static retcode_t populate(storage_connection_t const *const connection,
+                          uint64_t const num_rows) {
+  retcode_t ret = RC_OK;
+  sqlite3 *db = ((sqlite3_connection_t *)connection->actual)->db;
+  iota_transaction_t *tx = transaction_new();
+
+  if (tx == NULL) {
+    return RC_OOM;
+  }
+
+  srand(42);
+  sqlite3_exec(db, "BEGIN", NULL, NULL, NULL);
+  for (uint64_t i = 0; i < num_rows; i++) {
+    // Approvees are recent transactions and sometimes not yet stored ones
+    index_to_hash(transaction_hash(tx), i);
+    index_to_hash(transaction_trunk(tx),
+                  i > 0 ? i - 1 - rand() % (i < 50 ? i : 50) : num_rows);
+    index_to_hash(transaction_branch(tx), i + rand() % 50 - 40);
+    if ((ret = iota_stor_transaction_store(connection, tx)) != RC_OK) {
+      goto done;
+    }
+    if ((i + 1) % BATCH_SIZE == 0) {
+      sqlite3_exec(db, "COMMIT", NULL, NULL, NULL);
+      sqlite3_exec(db, "BEGIN", NULL, NULL, NULL);
+    }
+  }
+
+done:
+  sqlite3_exec(db, "COMMIT", NULL, NULL, NULL);
+  transaction_free(tx);
+  return ret;
+}
+
+static double time_statement(storage_connection_t const *const connection,
+                             char const *const statement) {
+  sqlite3 *db = ((sqlite3_connection_t *)connection->actual)->db;
+  sqlite3_stmt *sqlite_statement = NULL;
+  struct timespec start, end;
+
+  if (sqlite3_prepare_v2(db, statement, -1, &sqlite_statement, NULL) !=
+      SQLITE_OK) {
+    return -1;
+  }
+  sqlite3_bind_int(sqlite_statement, 1, QUERY_LIMIT);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  while (sqlite3_step(sqlite_statement) == SQLITE_ROW)
+    ;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  sqlite3_finalize(sqlite_statement);
+
+  return elapsed_ms(&start, &end);
+}
+
+static retcode_t benchmark(uint64_t const num_rows) {
+  retcode_t ret = RC_OK;
+  storage_connection_t connection;
+  connection_config_t config = {.db_path = test_db_path};
+  flex_trit_t *hashes[QUERY_LIMIT];
+  iota_stor_pack_t pack = {.models = (void **)hashes,
+                           .capacity = QUERY_LIMIT,
+                           .num_loaded = 0,
+                           .insufficient_capacity = false};
+  struct timespec start, end;
+  double tips = 0, requests = 0, count = 0;
+  size_t num_transactions = 0;
+
+  for (size_t i = 0; i < QUERY_LIMIT; i++) {
+    hashes[i] = (flex_trit_t *)malloc(FLEX_TRIT_SIZE_243);
+  }
+
+  copy_file(test_db_path, ciri_db_path);
+  if ((ret = connection_init(&connection, &config)) != RC_OK) {
+    goto done;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  if ((ret = populate(&connection, num_rows)) != RC_OK) {
+    goto done;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("%" PRIu64 " rows inserted in %.0f ms\n", num_rows,
+         elapsed_ms(&start, &end));
+
+  for (size_t i = 0; i < NUM_RUNS; i++) {
+    hash_pack_reset(&pack);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    iota_stor_transaction_load_hashes_of_tips(&connection, &pack, QUERY_LIMIT);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    tips += elapsed_ms(&start, &end);
+
+    hash_pack_reset(&pack);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    iota_stor_transaction_load_hashes_of_requests(&connection, &pack,
+                                                  QUERY_LIMIT);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    requests += elapsed_ms(&start, &end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    iota_stor_transaction_count(&connection, &num_transactions);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    count += elapsed_ms(&start, &end);
+  }
+
+  printf("  tips:     %10.3f ms (anti-join %10.3f ms)\n", tips / NUM_RUNS,
+         time_statement(&connection, legacy_tips));
+  printf("  requests: %10.3f ms (anti-join %10.3f ms)\n", requests / NUM_RUNS,
+         time_statement(&connection, legacy_requests));
+  printf("  count:    %10.3f ms (full scan %10.3f ms)\n", count / NUM_RUNS,
+         time_statement(&connection, legacy_count));
+
+  ret = connection_destroy(&connection);
+
+done:
+  for (size_t i = 0; i < QUERY_LIMIT; i++) {
+    free(hashes[i]);
+  }
+  remove_file(test_db_path);
+  return ret;
+}
+
+int main(int argc, char *argv[]) {
+  uint64_t default_rows[] = {1000000, 10000000};
+
+  if (storage_init() != RC_OK) {
+    return EXIT_FAILURE;
+  }
+
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++) {
+      if (benchmark(strtoull(argv[i], NULL, 10)) != RC_OK) {
+        return EXIT_FAILURE;
+      }
+    }
+  } else {
+    for (size_t i = 0; i < sizeof(default_rows) / sizeof(default_rows[0]);
+         i++) {
+      if (benchmark(default_rows[i]) != RC_OK) {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return storage_destroy() == RC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -254,6 +254,50 @@ void test_stored_load_hashes_by_address(void) {
   transaction_free(test_tx);
 }
 
+void test_stored_load_hashes_of_tips_and_requests(void) {
+  flex_trit_t *hashes[5];
+  iota_stor_pack_t pack = {.models = (void **)hashes,
+                           .capacity = 5,
+                           .num_loaded = 0,
+                           .insufficient_capacity = false};
+  size_t count = 0;
+
+  for (size_t i = 0; i < 5; ++i) {
+    hashes[i] = (flex_trit_t *)malloc(FLEX_TRIT_SIZE_243);
+  }
+
+  flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         TEST_TX_TRYTES, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION);
+  iota_transaction_t *test_tx = transaction_deserialize(tx_test_trits, true);
+
+  TEST_ASSERT(iota_stor_transaction_count(&connection, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, count);
+
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_tips(&connection, &pack,
+                                                        5) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(test_tx),
+                           ((flex_trit_t *)pack.models[0]), FLEX_TRIT_SIZE_243);
+
+  // Neither the trunk nor the branch of the only transaction are stored
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_requests(&connection, &pack,
+                                                            5) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(
+      memcmp(transaction_trunk(test_tx), transaction_branch(test_tx),
+             FLEX_TRIT_SIZE_243) == 0
+          ? 1
+          : 2,
+      pack.num_loaded);
+
+  for (size_t i = 0; i < 5; ++i) {
+    free(hashes[i]);
+  }
+  transaction_free(test_tx);
+}
+
 void test_stored_load_hashes_of_approvers(void) {
   flex_trit_t hashes[5][FLEX_TRIT_SIZE_243];
   iota_stor_pack_t pack = {.models = (void **)hashes,
@@ -275,6 +319,63 @@ void test_stored_load_hashes_of_approvers(void) {
   transaction_free(test_tx);
 }
 
+void test_stored_cursor_hashes(void) {
+  iota_stor_cursor_t cursor;
+  flex_trit_t const *hash = NULL;
+  flex_trit_t batch[2][FLEX_TRIT_SIZE_243];
+  size_t count = 0;
+
+  flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         TEST_TX_TRYTES, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION);
+  iota_transaction_t *test_tx = transaction_deserialize(tx_test_trits, true);
+
+  TEST_ASSERT(iota_stor_transaction_cursor_hashes(
+                  &connection, TRANSACTION_FIELD_ADDRESS,
+                  transaction_address(test_tx), &cursor) == RC_OK);
+  TEST_ASSERT(iota_stor_cursor_next(&cursor, &hash) == RC_OK);
+  TEST_ASSERT_NOT_NULL(hash);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(test_tx), hash,
+                           FLEX_TRIT_SIZE_243);
+  TEST_ASSERT(iota_stor_cursor_next(&cursor, &hash) == RC_OK);
+  TEST_ASSERT_NULL(hash);
+  // An exhausted cursor keeps yielding nothing and can still be closed
+  TEST_ASSERT(iota_stor_cursor_next(&cursor, &hash) == RC_OK);
+  TEST_ASSERT_NULL(hash);
+  TEST_ASSERT(iota_stor_cursor_close(&cursor) == RC_OK);
+
+  // The only stored transaction approves its trunk
+  TEST_ASSERT(iota_stor_transaction_cursor_hashes_of_approvers(
+                  &connection, transaction_trunk(test_tx), 0, &cursor) ==
+              RC_OK);
+  TEST_ASSERT(iota_stor_cursor_read(&cursor, (flex_trit_t *)batch, 2,
+                                    &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, count);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(test_tx), batch[0],
+                           FLEX_TRIT_SIZE_243);
+  TEST_ASSERT(iota_stor_cursor_close(&cursor) == RC_OK);
+
+  // Closing a cursor before it is exhausted releases its statement
+  TEST_ASSERT(iota_stor_transaction_cursor_hashes_of_approvers(
+                  &connection, transaction_trunk(test_tx), 0, &cursor) ==
+              RC_OK);
+  TEST_ASSERT(iota_stor_cursor_read(&cursor, (flex_trit_t *)batch, 0,
+                                    &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, count);
+  TEST_ASSERT(iota_stor_cursor_close(&cursor) == RC_OK);
+  TEST_ASSERT(iota_stor_cursor_close(&cursor) == RC_OK);
+
+  TEST_ASSERT(iota_stor_transaction_cursor_hashes_of_approvers(
+                  &connection, transaction_hash(test_tx), 0, &cursor) ==
+              RC_OK);
+  TEST_ASSERT(iota_stor_cursor_next(&cursor, &hash) == RC_OK);
+  TEST_ASSERT_NULL(hash);
+  TEST_ASSERT(iota_stor_cursor_close(&cursor) == RC_OK);
+
+  transaction_free(test_tx);
+}
+
 void test_transaction_update_snapshot_index(void) {
   flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
   flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION,
@@ -297,9 +398,28 @@ void test_transaction_update_snapshot_index(void) {
   transaction_free(test_tx);
 }
 
+void test_transaction_load_signature(void) {
+  flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         TEST_TX_TRYTES, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION);
+  iota_transaction_t *test_tx = transaction_deserialize(tx_test_trits, true);
+  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
+
+  memset(&tx, 0, sizeof(iota_transaction_t));
+  TEST_ASSERT(iota_stor_transaction_load_signature(
+                  &connection, transaction_hash(test_tx), &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_signature(test_tx),
+                           transaction_signature(&tx), FLEX_TRIT_SIZE_6561);
+  TEST_ASSERT(tx.loaded_columns_mask.data & MASK_DATA_SIG_OR_MSG);
+  TEST_ASSERT_EQUAL_INT(0, tx.loaded_columns_mask.essence);
+  transaction_free(test_tx);
+}
+
 void test_milestone_state_delta(void) {
   state_delta_t state_delta1 = NULL, state_delta2 = NULL;
-  state_delta_entry_t *iter = NULL, *tmp = NULL;
+  state_delta_entry_t *iter = NULL;
   trit_t trits[HASH_LENGTH] = {1};
   flex_trit_t hash[FLEX_TRIT_SIZE_243];
   flex_trit_t *hashed_hash;
@@ -323,22 +443,117 @@ void test_milestone_state_delta(void) {
               RC_OK);
   TEST_ASSERT(state_delta2 != NULL);
 
-  int i = -1000;
+  // Serialized entries are sorted by address, not in insertion order
+  TEST_ASSERT_EQUAL_INT(state_delta_size(state_delta1),
+                        state_delta_size(state_delta2));
   flex_trits_from_trits(hash, HASH_LENGTH, trits, HASH_LENGTH, HASH_LENGTH);
-  iter = NULL;
-  HASH_ITER(hh, state_delta2, iter, tmp) {
+  for (int64_t i = -1000; i <= 1000; i++) {
     hashed_hash = iota_flex_digest(hash, HASH_LENGTH);
     memcpy(hash, hashed_hash, FLEX_TRIT_SIZE_243);
     free(hashed_hash);
-    TEST_ASSERT_EQUAL_MEMORY(iter->hash, hash, FLEX_TRIT_SIZE_243);
+    iter = NULL;
+    state_delta_find(state_delta2, hash, iter);
+    TEST_ASSERT_NOT_NULL(iter);
     TEST_ASSERT_EQUAL_INT64(iter->value, i);
-    i++;
   }
 
   state_delta_destroy(&state_delta1);
   state_delta_destroy(&state_delta2);
 }
 
+void test_ledger_checkpoint(void) {
+  state_delta_t state = NULL, loaded_state = NULL;
+  state_delta_entry_t *entry = NULL;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t loaded_hash[FLEX_TRIT_SIZE_243];
+  uint64_t index = 0;
+
+  TEST_ASSERT(state_delta_add(&state, HASH, 1000) == RC_OK);
+
+  // Milestones #42 and #43 are stored by test_stored_milestone
+  memcpy(hash, HASH, FLEX_TRIT_SIZE_243);
+  TEST_ASSERT(iota_stor_ledger_checkpoint_store(&connection, 42, hash, &state,
+                                                2) == RC_OK);
+  hash[0]++;
+  TEST_ASSERT(iota_stor_ledger_checkpoint_store(&connection, 43, hash, &state,
+                                                2) == RC_OK);
+  // No milestone #44 with this hash, the checkpoint is ignored
+  TEST_ASSERT(iota_stor_ledger_checkpoint_store(&connection, 44, hash, &state,
+                                                3) == RC_OK);
+
+  TEST_ASSERT(iota_stor_ledger_checkpoint_load_latest(
+                  &connection, UINT64_MAX, &index, loaded_hash,
+                  &loaded_state) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(43, index);
+  TEST_ASSERT_EQUAL_MEMORY(hash, loaded_hash, FLEX_TRIT_SIZE_243);
+  state_delta_find(loaded_state, HASH, entry);
+  TEST_ASSERT_NOT_NULL(entry);
+  TEST_ASSERT_EQUAL_INT64(1000, entry->value);
+  state_delta_destroy(&loaded_state);
+
+  TEST_ASSERT(iota_stor_ledger_checkpoint_load_latest(
+                  &connection, 43, &index, loaded_hash, &loaded_state) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(42, index);
+  state_delta_destroy(&loaded_state);
+
+  // Only the 2 most recent checkpoints are kept
+  TEST_ASSERT(iota_stor_ledger_checkpoint_store(&connection, 43, hash, &state,
+                                                2) == RC_OK);
+  TEST_ASSERT(iota_stor_ledger_checkpoint_load_latest(
+                  &connection, 43, &index, loaded_hash, &loaded_state) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, index);
+  TEST_ASSERT(loaded_state == NULL);
+
+  state_delta_destroy(&state);
+}
+
+void test_spent_addresses(void) {
+  hash243_set_t addresses = NULL;
+  trit_t trits[HASH_LENGTH] = {1};
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t *hashed_hash;
+  iota_stor_pack_t pack;
+  size_t contained = 0;
+  bool exist = false;
+
+  flex_trits_from_trits(hash, HASH_LENGTH, trits, HASH_LENGTH, HASH_LENGTH);
+  TEST_ASSERT(iota_stor_spent_address_exist(&connection, hash, &exist) ==
+              RC_OK);
+  TEST_ASSERT_FALSE(exist);
+  TEST_ASSERT(iota_stor_spent_address_store(&connection, hash) == RC_OK);
+  TEST_ASSERT(iota_stor_spent_address_store(&connection, hash) == RC_OK);
+  TEST_ASSERT(iota_stor_spent_address_exist(&connection, hash, &exist) ==
+              RC_OK);
+  TEST_ASSERT_TRUE(exist);
+
+  for (size_t i = 0; i < 10; i++) {
+    hashed_hash = iota_flex_digest(hash, HASH_LENGTH);
+    memcpy(hash, hashed_hash, FLEX_TRIT_SIZE_243);
+    free(hashed_hash);
+    TEST_ASSERT(hash243_set_add(&addresses, hash) == RC_OK);
+  }
+  TEST_ASSERT(iota_stor_spent_addresses_store(&connection, addresses) ==
+              RC_OK);
+  TEST_ASSERT(iota_stor_spent_address_exist(&connection, hash, &exist) ==
+              RC_OK);
+  TEST_ASSERT_TRUE(exist);
+
+  TEST_ASSERT(hash_pack_init(&pack, 16) == RC_OK);
+  TEST_ASSERT(iota_stor_spent_addresses_load(&connection, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(11, pack.num_loaded);
+  for (size_t i = 0; i < pack.num_loaded; i++) {
+    if (hash243_set_contains(&addresses, (flex_trit_t *)pack.models[i])) {
+      contained++;
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(10, contained);
+
+  hash_pack_free(&pack);
+  hash243_set_free(&addresses);
+}
+
 void test_transaction_update_solid_state(void) {
   flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
   flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION,
@@ -461,6 +676,61 @@ void test_transactions_arrival_time(void) {
   transaction_free(test_tx);
 }
 
+void test_transactions_prune(void) {
+  flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         TEST_TX_TRYTES, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION);
+  iota_transaction_t *test_tx = transaction_deserialize(tx_test_trits, true);
+  iota_transaction_t txs[3];
+  flex_trit_t hashes[3][FLEX_TRIT_SIZE_243];
+  tryte_t const *trytes[3] = {
+      (tryte_t *)"PRUNE9A99999999999999999999999999999999999999999999999999999999999999999999999999",
+      (tryte_t *)"PRUNE9B99999999999999999999999999999999999999999999999999999999999999999999999999",
+      (tryte_t *)"PRUNE9C99999999999999999999999999999999999999999999999999999999999999999999999999"};
+  uint64_t snapshot_indexes[3] = {1, 2, 0};
+  iota_stor_pack_t pack;
+  size_t count = 0;
+  bool exist = false;
+
+  // C (unconfirmed) approves B (milestone #2) which approves A (milestone #1)
+  for (size_t i = 0; i < 3; i++) {
+    flex_trits_from_trytes(hashes[i], NUM_TRITS_HASH, trytes[i], NUM_TRYTES_HASH,
+                           NUM_TRYTES_HASH);
+    txs[i] = *test_tx;
+    transaction_set_hash(&txs[i], hashes[i]);
+    if (i > 0) {
+      transaction_set_trunk(&txs[i], hashes[i - 1]);
+      transaction_set_branch(&txs[i], hashes[i - 1]);
+    }
+    TEST_ASSERT(iota_stor_transaction_store(&connection, &txs[i]) == RC_OK);
+    TEST_ASSERT(iota_stor_transaction_update_snapshot_index(
+                    &connection, hashes[i], snapshot_indexes[i]) == RC_OK);
+  }
+
+  TEST_ASSERT(hash_pack_init(&pack, 4) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_solid_entry_points(
+                  &connection, 2, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(hashes[1], pack.models[0], FLEX_TRIT_SIZE_243);
+
+  TEST_ASSERT(iota_stor_transactions_prune(&connection, 2, 4, &count) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, count);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH,
+                                          hashes[0], &exist) == RC_OK);
+  TEST_ASSERT_FALSE(exist);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH,
+                                          hashes[1], &exist) == RC_OK);
+  TEST_ASSERT_TRUE(exist);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH,
+                                          hashes[2], &exist) == RC_OK);
+  TEST_ASSERT_TRUE(exist);
+
+  hash_pack_free(&pack);
+  transaction_free(test_tx);
+}
+
 int main(int argc, char *argv[]) {
   UNITY_BEGIN();
   TEST_ASSERT(storage_init() == RC_OK);
@@ -479,15 +749,21 @@ int main(int argc, char *argv[]) {
   RUN_TEST(test_initialized_db_empty_transaction);
   RUN_TEST(test_initialized_db_empty_milestone);
   RUN_TEST(test_stored_transaction);
+  RUN_TEST(test_stored_load_hashes_of_tips_and_requests);
   RUN_TEST(test_stored_milestone);
   RUN_TEST(test_stored_load_hashes_by_address);
   RUN_TEST(test_stored_load_hashes_of_approvers);
+  RUN_TEST(test_stored_cursor_hashes);
   RUN_TEST(test_milestone_state_delta);
+  RUN_TEST(test_ledger_checkpoint);
   RUN_TEST(test_transaction_update_snapshot_index);
+  RUN_TEST(test_transaction_load_signature);
+  RUN_TEST(test_spent_addresses);
   RUN_TEST(test_transaction_update_solid_state);
   RUN_TEST(test_transactions_update_solid_states_one_transaction);
   RUN_TEST(test_transactions_update_solid_states_two_transaction);
   RUN_TEST(test_transactions_arrival_time);
+  RUN_TEST(test_transactions_prune);
   RUN_TEST(test_destroy_connection);
 
   TEST_ASSERT(storage_destroy() == RC_OK);
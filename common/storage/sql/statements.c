@@ -12,6 +12,7 @@
 #include <string.h>
 
 #include "common/storage/defs.h"
+#include "common/storage/sql/statements.h"
 
 /*
  * Generic statement builders
@@ -63,34 +64,55 @@ char *iota_statement_transaction_select_hashes_by_address =
     "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME
     " WHERE " TRANSACTION_COL_ADDRESS "=?";
 
+// A union instead of an OR so that both lookups are served by the covering
+// branch and trunk indexes
 char *iota_statement_transaction_select_hashes_of_approvers =
     "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME
-    " WHERE " TRANSACTION_COL_BRANCH "=? OR " TRANSACTION_COL_TRUNK "=?";
+    " WHERE " TRANSACTION_COL_BRANCH "=? UNION SELECT " TRANSACTION_COL_HASH
+    " FROM " TRANSACTION_TABLE_NAME " WHERE " TRANSACTION_COL_TRUNK "=?";
 
 char *iota_statement_transaction_select_hashes_of_approvers_before_date =
     "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME
-    " WHERE (" TRANSACTION_COL_BRANCH "=? OR " TRANSACTION_COL_TRUNK
-    "=?) AND " TRANSACTION_COL_ARRIVAL_TIME "<?";
+    " WHERE " TRANSACTION_COL_BRANCH "=?1 AND " TRANSACTION_COL_ARRIVAL_TIME
+    "<?3 UNION SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME
+    " WHERE " TRANSACTION_COL_TRUNK "=?2 AND " TRANSACTION_COL_ARRIVAL_TIME
+    "<?3";
 
 char *iota_statement_transaction_select_hashes_of_transactions_to_request =
-    "SELECT " TRANSACTION_COL_TRUNK " FROM " TRANSACTION_TABLE_NAME
-    " a WHERE NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME
-    " b WHERE b." TRANSACTION_COL_HASH " = a." TRANSACTION_COL_TRUNK
-    ")) UNION SELECT " TRANSACTION_COL_BRANCH " FROM " TRANSACTION_TABLE_NAME
-    " a WHERE NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME
-    " b WHERE b." TRANSACTION_COL_HASH " = a." TRANSACTION_COL_BRANCH
-    ")) LIMIT ?";
+    "SELECT " MISSING_TRANSACTION_COL_HASH
+    " FROM " MISSING_TRANSACTION_TABLE_NAME " LIMIT ?";
 
 char *iota_statement_transaction_select_hashes_of_tips =
-    "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME
-    " a WHERE NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME
-    " b WHERE b." TRANSACTION_COL_TRUNK " = a." TRANSACTION_COL_HASH
-    " OR b." TRANSACTION_COL_BRANCH " = a." TRANSACTION_COL_HASH ")) LIMIT ?";
+    "SELECT " TIP_COL_HASH " FROM " TIP_TABLE_NAME " LIMIT ?";
 
 char *iota_statement_transaction_select_hashes_of_milestone_candidates =
     "SELECT " TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME
     " WHERE " TRANSACTION_COL_ADDRESS
-    " LIKE ? EXCEPT SELECT " MILESTONE_COL_HASH " FROM " MILESTONE_TABLE_NAME;
+    "=? EXCEPT SELECT " MILESTONE_COL_HASH " FROM " MILESTONE_TABLE_NAME;
+
+// Transactions confirmed by a milestone up to the given index that are still
+// referenced by a transaction left unconfirmed or confirmed afterwards
+char *iota_statement_transaction_select_hashes_of_solid_entry_points =
+    "SELECT a." TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME
+    " a WHERE a." TRANSACTION_COL_SNAPSHOT_INDEX
+    ">0 AND a." TRANSACTION_COL_SNAPSHOT_INDEX
+    "<=?1 AND EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME
+    " b WHERE (b." TRANSACTION_COL_TRUNK "=a." TRANSACTION_COL_HASH
+    " OR b." TRANSACTION_COL_BRANCH "=a." TRANSACTION_COL_HASH
+    ") AND (b." TRANSACTION_COL_SNAPSHOT_INDEX
+    "=0 OR b." TRANSACTION_COL_SNAPSHOT_INDEX ">?1))";
+
+// Transactions confirmed by a milestone up to the given index that are not
+// solid entry points
+char *iota_statement_transaction_select_hashes_to_prune =
+    "SELECT a." TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME
+    " a WHERE a." TRANSACTION_COL_SNAPSHOT_INDEX
+    ">0 AND a." TRANSACTION_COL_SNAPSHOT_INDEX
+    "<=?1 AND NOT(EXISTS(SELECT 1 FROM " TRANSACTION_TABLE_NAME
+    " b WHERE (b." TRANSACTION_COL_TRUNK "=a." TRANSACTION_COL_HASH
+    " OR b." TRANSACTION_COL_BRANCH "=a." TRANSACTION_COL_HASH
+    ") AND (b." TRANSACTION_COL_SNAPSHOT_INDEX
+    "=0 OR b." TRANSACTION_COL_SNAPSHOT_INDEX ">?1))) LIMIT ?2";
 
 char *iota_statement_transaction_update_snapshot_index =
     "UPDATE " TRANSACTION_TABLE_NAME " SET " TRANSACTION_COL_SNAPSHOT_INDEX
@@ -112,7 +134,15 @@ char *iota_statement_transaction_approvers_count =
     "SELECT COUNT(*) FROM " TRANSACTION_TABLE_NAME " WHERE branch=? OR trunk=?";
 
 char *iota_statement_transaction_count =
-    "SELECT COUNT(*) FROM " TRANSACTION_TABLE_NAME;
+    "SELECT " COUNTER_COL_VALUE " FROM " COUNTER_TABLE_NAME
+    " WHERE " COUNTER_COL_NAME "='" COUNTER_TRANSACTION "'";
+
+char *iota_statement_transaction_delete =
+    "DELETE FROM " TRANSACTION_TABLE_NAME " WHERE " TRANSACTION_COL_HASH "=?";
+
+char *iota_statement_missing_transaction_delete =
+    "DELETE FROM " MISSING_TRANSACTION_TABLE_NAME
+    " WHERE " MISSING_TRANSACTION_COL_HASH "=?";
 
 char *iota_statement_transaction_find =
     "SELECT a." TRANSACTION_COL_HASH " FROM " TRANSACTION_TABLE_NAME
@@ -165,6 +195,10 @@ char *iota_statement_transaction_select_metadata =
     "," TRANSACTION_COL_ARRIVAL_TIME " FROM " TRANSACTION_TABLE_NAME
     " WHERE " TRANSACTION_COL_HASH "=?";
 
+char *iota_statement_transaction_select_signature =
+    "SELECT " TRANSACTION_COL_SIG_OR_MSG " FROM " TRANSACTION_TABLE_NAME
+    " WHERE " TRANSACTION_COL_HASH "=?";
+
 /*
  * Transaction statement builders
  */
@@ -230,6 +264,9 @@ char *iota_statement_milestone_exist_by_hash =
     "SELECT 1 WHERE EXISTS(SELECT 1 "
     "FROM " MILESTONE_TABLE_NAME " WHERE " MILESTONE_COL_HASH "=?)";
 
+char *iota_statement_milestone_delete_up_to =
+    "DELETE FROM " MILESTONE_TABLE_NAME " WHERE " MILESTONE_COL_INDEX "<=?";
+
 /*
  * State delta statements
  */
@@ -241,3 +278,78 @@ char *iota_statement_state_delta_store =
 char *iota_statement_state_delta_load =
     "SELECT " MILESTONE_COL_DELTA " FROM " MILESTONE_TABLE_NAME
     " WHERE " MILESTONE_COL_INDEX "=?";
+
+/*
+ * Ledger checkpoint statements
+ */
+
+char *iota_statement_ledger_checkpoint_store =
+    "INSERT OR REPLACE INTO " LEDGER_CHECKPOINT_TABLE_NAME
+    "(" LEDGER_CHECKPOINT_COL_INDEX "," LEDGER_CHECKPOINT_COL_HASH
+    "," LEDGER_CHECKPOINT_COL_STATE ")VALUES(?,?,?)";
+
+// Only checkpoints of milestones still known with the same hash are candidates
+char *iota_statement_ledger_checkpoint_select_latest =
+    "SELECT a." LEDGER_CHECKPOINT_COL_INDEX ",a." LEDGER_CHECKPOINT_COL_HASH
+    ",a." LEDGER_CHECKPOINT_COL_STATE " FROM " LEDGER_CHECKPOINT_TABLE_NAME
+    " a WHERE a." LEDGER_CHECKPOINT_COL_INDEX
+    "<? AND EXISTS(SELECT 1 FROM " MILESTONE_TABLE_NAME
+    " b WHERE b." MILESTONE_COL_INDEX "=a." LEDGER_CHECKPOINT_COL_INDEX
+    " AND b." MILESTONE_COL_HASH "=a." LEDGER_CHECKPOINT_COL_HASH
+    ") ORDER BY a." LEDGER_CHECKPOINT_COL_INDEX " DESC LIMIT 1";
+
+char *iota_statement_ledger_checkpoint_delete_old =
+    "DELETE FROM " LEDGER_CHECKPOINT_TABLE_NAME
+    " WHERE " LEDGER_CHECKPOINT_COL_INDEX " NOT IN(SELECT "
+    LEDGER_CHECKPOINT_COL_INDEX " FROM " LEDGER_CHECKPOINT_TABLE_NAME
+    " ORDER BY " LEDGER_CHECKPOINT_COL_INDEX " DESC LIMIT ?)";
+
+/*
+ * Spent address statements
+ */
+
+char *iota_statement_spent_address_insert =
+    "INSERT OR IGNORE INTO " SPENT_ADDRESS_TABLE_NAME
+    "(" SPENT_ADDRESS_COL_HASH ")VALUES(?)";
+
+char *iota_statement_spent_address_select =
+    "SELECT " SPENT_ADDRESS_COL_HASH " FROM " SPENT_ADDRESS_TABLE_NAME;
+
+char *iota_statement_spent_address_exist =
+    "SELECT 1 WHERE EXISTS(SELECT 1 FROM " SPENT_ADDRESS_TABLE_NAME
+    " WHERE " SPENT_ADDRESS_COL_HASH "=?)";
+
+/*
+ * Schema migrations
+ *
+ * Migrations describe a past schema and must not use the column name macros
+ */
+
+char *iota_schema_migrations[IOTA_SCHEMA_VERSION] = {
+    // Version 1: no duplicate hash indexes, covering approvers, address and
+    // bundle indexes, and the ledger checkpoints table. State deltas and
+    // checkpoints of unversioned databases are a bare sequence of addresses
+    // and values, they are prefixed with the version byte of that layout
+    "DROP INDEX IF EXISTS transaction_hash_index;"
+    "DROP INDEX IF EXISTS milestone_hash_index;"
+    "DROP INDEX IF EXISTS address_index;"
+    "DROP INDEX IF EXISTS bundle_index;"
+    "DROP INDEX IF EXISTS trunk_index;"
+    "DROP INDEX IF EXISTS branch_index;"
+    "CREATE INDEX address_index ON iota_transaction(address, hash);"
+    "CREATE INDEX bundle_index ON iota_transaction(bundle, hash);"
+    "CREATE INDEX trunk_index ON iota_transaction(trunk, hash);"
+    "CREATE INDEX branch_index ON iota_transaction(branch, hash);"
+    "CREATE TABLE IF NOT EXISTS iota_ledger_checkpoint(id INTEGER NOT NULL "
+    "PRIMARY KEY, hash BLOB NOT NULL, state BLOB NOT NULL);"
+    "UPDATE iota_milestone SET delta = CAST(X'00' || delta AS BLOB) WHERE "
+    "length(delta) > 0;"
+    "UPDATE iota_ledger_checkpoint SET state = CAST(X'00' || state AS BLOB) "
+    "WHERE length(state) > 0;",
+    // Version 2: addresses spent by transactions confirmed before spent
+    // addresses were recorded, or by milestones whose recording failed
+    "CREATE TABLE IF NOT EXISTS iota_spent_address(hash BLOB NOT NULL PRIMARY "
+    "KEY) WITHOUT ROWID;"
+    "INSERT OR IGNORE INTO iota_spent_address(hash) SELECT address FROM "
+    "iota_transaction WHERE value < 0 AND snapshot_index != 0;",
+};
@@ -25,16 +25,21 @@ typedef struct iota_statements_s {
   sqlite3_stmt* transaction_select_hashes_of_transactions_to_request;
   sqlite3_stmt* transaction_select_hashes_of_tips;
   sqlite3_stmt* transaction_select_hashes_of_milestone_candidates;
+  sqlite3_stmt* transaction_select_hashes_of_solid_entry_points;
+  sqlite3_stmt* transaction_select_hashes_to_prune;
   sqlite3_stmt* transaction_update_snapshot_index;
   sqlite3_stmt* transaction_update_solid_state;
   sqlite3_stmt* transaction_exist;
   sqlite3_stmt* transaction_exist_by_hash;
   sqlite3_stmt* transaction_approvers_count;
   sqlite3_stmt* transaction_count;
+  sqlite3_stmt* transaction_delete;
+  sqlite3_stmt* missing_transaction_delete;
   sqlite3_stmt* transaction_select_essence_and_metadata;
   sqlite3_stmt* transaction_select_essence_attachment_and_metadata;
   sqlite3_stmt* transaction_select_essence_and_consensus;
   sqlite3_stmt* transaction_select_metadata;
+  sqlite3_stmt* transaction_select_signature;
   sqlite3_stmt* milestone_insert;
   sqlite3_stmt* milestone_select_by_hash;
   sqlite3_stmt* milestone_select_first;
@@ -42,8 +47,15 @@ typedef struct iota_statements_s {
   sqlite3_stmt* milestone_select_next;
   sqlite3_stmt* milestone_exist;
   sqlite3_stmt* milestone_exist_by_hash;
+  sqlite3_stmt* milestone_delete_up_to;
   sqlite3_stmt* state_delta_store;
   sqlite3_stmt* state_delta_load;
+  sqlite3_stmt* ledger_checkpoint_store;
+  sqlite3_stmt* ledger_checkpoint_select_latest;
+  sqlite3_stmt* ledger_checkpoint_delete_old;
+  sqlite3_stmt* spent_address_insert;
+  sqlite3_stmt* spent_address_select;
+  sqlite3_stmt* spent_address_exist;
 } iota_statements_t;
 
 /*
@@ -65,12 +77,16 @@ extern char*
     iota_statement_transaction_select_hashes_of_transactions_to_request;
 extern char* iota_statement_transaction_select_hashes_of_tips;
 extern char* iota_statement_transaction_select_hashes_of_milestone_candidates;
+extern char* iota_statement_transaction_select_hashes_of_solid_entry_points;
+extern char* iota_statement_transaction_select_hashes_to_prune;
 extern char* iota_statement_transaction_update_snapshot_index;
 extern char* iota_statement_transaction_update_solid_state;
 extern char* iota_statement_transaction_exist;
 extern char* iota_statement_transaction_exist_by_hash;
 extern char* iota_statement_transaction_approvers_count;
 extern char* iota_statement_transaction_count;
+extern char* iota_statement_transaction_delete;
+extern char* iota_statement_missing_transaction_delete;
 extern char* iota_statement_transaction_find;
 
 /*
@@ -81,6 +97,7 @@ extern char* iota_statement_transaction_select_essence_and_metadata;
 extern char* iota_statement_transaction_select_essence_attachment_and_metadata;
 extern char* iota_statement_transaction_select_essence_and_consensus;
 extern char* iota_statement_transaction_select_metadata;
+extern char* iota_statement_transaction_select_signature;
 
 /*
  * Transaction statement builders
@@ -101,6 +118,7 @@ extern char* iota_statement_milestone_select_last;
 extern char* iota_statement_milestone_select_next;
 extern char* iota_statement_milestone_exist;
 extern char* iota_statement_milestone_exist_by_hash;
+extern char* iota_statement_milestone_delete_up_to;
 
 /*
  * State delta statements
@@ -109,6 +127,32 @@ extern char* iota_statement_milestone_exist_by_hash;
 extern char* iota_statement_state_delta_store;
 extern char* iota_statement_state_delta_load;
 
+/*
+ * Ledger checkpoint statements
+ */
+
+extern char* iota_statement_ledger_checkpoint_store;
+extern char* iota_statement_ledger_checkpoint_select_latest;
+extern char* iota_statement_ledger_checkpoint_delete_old;
+
+/*
+ * Spent address statements
+ */
+
+extern char* iota_statement_spent_address_insert;
+extern char* iota_statement_spent_address_select;
+extern char* iota_statement_spent_address_exist;
+
+/*
+ * Schema migrations
+ */
+
+// Version of the schema created by schema.sql, kept in PRAGMA user_version
+#define IOTA_SCHEMA_VERSION 2
+
+// iota_schema_migrations[i] upgrades a database from version i to i + 1
+extern char* iota_schema_migrations[IOTA_SCHEMA_VERSION];
+
 #ifdef __cplusplus
 }
 #endif
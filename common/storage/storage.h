@@ -12,6 +12,7 @@
 
 #include "common/errors.h"
 #include "common/storage/connection.h"
+#include "common/storage/cursor.h"
 #include "common/storage/defs.h"
 #include "common/storage/pack.h"
 #include "common/trinary/flex_trit.h"
@@ -82,6 +83,10 @@ extern retcode_t iota_stor_transaction_load_metadata(
     storage_connection_t const* const connection, flex_trit_t const* const hash,
     iota_stor_pack_t* const pack);
 
+extern retcode_t iota_stor_transaction_load_signature(
+    storage_connection_t const* const connection, flex_trit_t const* const hash,
+    iota_stor_pack_t* const pack);
+
 extern retcode_t iota_stor_transaction_exist(
     storage_connection_t const* const connection,
     transaction_field_t const field, flex_trit_t const* const key,
@@ -125,6 +130,14 @@ extern retcode_t iota_stor_transaction_load_hashes_of_milestone_candidates(
     storage_connection_t const* const connection, iota_stor_pack_t* const pack,
     flex_trit_t const* const coordinator);
 
+extern retcode_t iota_stor_transaction_load_hashes_of_solid_entry_points(
+    storage_connection_t const* const connection, uint64_t const snapshot_index,
+    iota_stor_pack_t* const pack);
+
+extern retcode_t iota_stor_transactions_prune(
+    storage_connection_t const* const connection, uint64_t const snapshot_index,
+    size_t const limit, size_t* const count);
+
 extern retcode_t iota_stor_transaction_approvers_count(
     storage_connection_t const* const connection, flex_trit_t const* const hash,
     size_t* const count);
@@ -134,6 +147,80 @@ extern retcode_t iota_stor_transaction_find(
     hash243_queue_t const addresses, hash81_queue_t const tags,
     hash243_queue_t const approvees, iota_stor_pack_t* const pack);
 
+/*
+ * Cursor operations
+ */
+
+/**
+ * Opens a cursor over the hashes of transactions with a given field value
+ *
+ * @param connection The storage connection
+ * @param field The field to match, only TRANSACTION_FIELD_ADDRESS is supported
+ * @param key The value of the field
+ * @param cursor The cursor to open
+ *
+ * @return a status code
+ */
+extern retcode_t iota_stor_transaction_cursor_hashes(
+    storage_connection_t const* const connection,
+    transaction_field_t const field, flex_trit_t const* const key,
+    iota_stor_cursor_t* const cursor);
+
+/**
+ * Opens a cursor over the hashes of the approvers of a transaction
+ *
+ * @param connection The storage connection
+ * @param approvee_hash The hash of the approved transaction
+ * @param before_timestamp Only approvers attached before it are yielded, 0 to
+ * yield all of them
+ * @param cursor The cursor to open
+ *
+ * @return a status code
+ */
+extern retcode_t iota_stor_transaction_cursor_hashes_of_approvers(
+    storage_connection_t const* const connection,
+    flex_trit_t const* const approvee_hash, int64_t const before_timestamp,
+    iota_stor_cursor_t* const cursor);
+
+/**
+ * Yields the next hash of a cursor without copying it when the backend stores
+ * it in full. The hash is valid until the next call or until the cursor is
+ * closed.
+ *
+ * @param cursor The cursor
+ * @param hash The next hash, NULL when the cursor is exhausted
+ *
+ * @return a status code
+ */
+extern retcode_t iota_stor_cursor_next(iota_stor_cursor_t* const cursor,
+                                       flex_trit_t const** const hash);
+
+/**
+ * Copies the next hashes of a cursor into a caller-supplied batch
+ *
+ * @param cursor The cursor
+ * @param hashes A buffer of capacity hashes of FLEX_TRIT_SIZE_243 bytes
+ * @param capacity The maximum number of hashes to copy
+ * @param count The number of copied hashes, less than capacity when the
+ * cursor is exhausted
+ *
+ * @return a status code
+ */
+extern retcode_t iota_stor_cursor_read(iota_stor_cursor_t* const cursor,
+                                       flex_trit_t* const hashes,
+                                       size_t const capacity,
+                                       size_t* const count);
+
+/**
+ * Closes a cursor, releasing its statement or iterator. Closing an exhausted
+ * or already closed cursor is a no-op.
+ *
+ * @param cursor The cursor
+ *
+ * @return a status code
+ */
+extern retcode_t iota_stor_cursor_close(iota_stor_cursor_t* const cursor);
+
 /*
  * Milestone operations
  */
@@ -160,6 +247,9 @@ extern retcode_t iota_stor_milestone_exist(
     storage_connection_t const* const connection, flex_trit_t const* const hash,
     bool* const exist);
 
+extern retcode_t iota_stor_milestones_delete(
+    storage_connection_t const* const connection, uint64_t const index);
+
 /*
  * State delta operations
  */
@@ -172,6 +262,42 @@ extern retcode_t iota_stor_state_delta_load(
     storage_connection_t const* const connection, uint64_t const index,
     state_delta_t* const delta);
 
+extern retcode_t iota_stor_state_delta_load_serialized(
+    storage_connection_t const* const connection, uint64_t const index,
+    byte_t** const bytes, size_t* const size);
+
+/*
+ * Ledger checkpoint operations
+ */
+
+extern retcode_t iota_stor_ledger_checkpoint_store(
+    storage_connection_t const* const connection, uint64_t const index,
+    flex_trit_t const* const hash, state_delta_t const* const state,
+    size_t const kept);
+
+extern retcode_t iota_stor_ledger_checkpoint_load_latest(
+    storage_connection_t const* const connection, uint64_t const below_index,
+    uint64_t* const index, flex_trit_t* const hash, state_delta_t* const state);
+
+/*
+ * Spent address operations
+ */
+
+extern retcode_t iota_stor_spent_address_store(
+    storage_connection_t const* const connection,
+    flex_trit_t const* const address);
+
+extern retcode_t iota_stor_spent_addresses_store(
+    storage_connection_t const* const connection,
+    hash243_set_t const addresses);
+
+extern retcode_t iota_stor_spent_address_exist(
+    storage_connection_t const* const connection,
+    flex_trit_t const* const address, bool* const exist);
+
+extern retcode_t iota_stor_spent_addresses_load(
+    storage_connection_t const* const connection, iota_stor_pack_t* const pack);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/model/transaction.h"
+#include "common/storage/connection.h"
+#include "common/storage/storage.h"
+#include "utils/files.h"
+#include "utils/macros.h"
+
+// Runs a gossip like workload through the iota_stor_* interface of the
+// backend the binary is linked with
+//
+// usage: benchmark_storage_sqlite3 [num_transactions...]
+
+#define NUM_LOOKUPS 10000
+#define NUM_ADDRESSES 10000
+#define MILESTONE_INTERVAL 100
+#define TIPS_WINDOW 100
+#define MESSAGE_SIZE 100
+#define PRUNE_LIMIT 1000
+
+static char *test_db_path = "common/storage/tests/benchmark.db";
+static char *ciri_db_path = "common/storage/tests/ciri.db";
+
+static double elapsed_ms(struct timespec const *const start,
+                         struct timespec const *const end) {
+  return (end->tv_sec - start->tv_sec) * 1e3 +
+         (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+ * Hashes are spread over the key space like real ones so that inserts don't
+ * append to the keys
+ */
+static void index_to_hash(flex_trit_t *const hash, uint64_t const index,
+                          uint64_t const salt) {
+  uint64_t x = index * 0x9E3779B97F4A7C15ULL + salt;
+
+  memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+  for (size_t i = 0; i < FLEX_TRIT_SIZE_243 - 1; i += sizeof(x)) {
+    x ^= x >> 31;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    memcpy(hash + i, &x,
+           MIN(sizeof(x), (size_t)(FLEX_TRIT_SIZE_243 - 1 - i)));
+  }
+  // Avoids trailing null values that would be trimmed by the storage
+  hash[FLEX_TRIT_SIZE_243 - 1] = 1;
+}
+
+/**
+ * Bundles of 1 to 4 transactions chained by their trunks, the last one
+ * approving recent transactions. Every MILESTONE_INTERVAL bundle is issued by
+ * the coordinator and a quarter of the bundles carry full signatures. Each
+ * transaction is stored on its own, as received from a neighbor.
+ */
+static retcode_t populate(storage_connection_t const *const connection,
+                          uint64_t const num_txs) {
+  retcode_t ret = RC_OK;
+  iota_transaction_t tx;
+  flex_trit_t buffer[FLEX_TRIT_SIZE_6561];
+  uint64_t bundle_index = 0;
+  size_t bundle_size = 0, last_index = 0;
+
+  transaction_reset(&tx);
+  memset(buffer, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_6561);
+  transaction_set_value(&tx, 0);
+  transaction_set_obsolete_tag(&tx, buffer);
+  transaction_set_tag(&tx, buffer);
+  transaction_set_nonce(&tx, buffer);
+  transaction_set_attachment_timestamp(&tx, 0);
+  transaction_set_attachment_timestamp_lower(&tx, 0);
+  transaction_set_attachment_timestamp_upper(&tx, 0);
+
+  srand(42);
+  for (uint64_t i = 0; i < num_txs; i++) {
+    if (bundle_size == 0) {
+      bundle_index++;
+      last_index = rand() % 4;
+      bundle_size = last_index + 1;
+      index_to_hash(buffer, bundle_index, 1);
+      transaction_set_bundle(&tx, buffer);
+      if (bundle_index % MILESTONE_INTERVAL == 0) {
+        index_to_hash(buffer, 0, 2);
+      } else {
+        index_to_hash(buffer, 1 + rand() % NUM_ADDRESSES, 2);
+      }
+      transaction_set_address(&tx, buffer);
+      memset(buffer, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_6561);
+      memset(buffer, 1, rand() % 4 == 0 ? FLEX_TRIT_SIZE_6561 : MESSAGE_SIZE);
+      transaction_set_signature(&tx, buffer);
+    }
+    bundle_size--;
+
+    index_to_hash(buffer, i, 0);
+    transaction_set_hash(&tx, buffer);
+    transaction_set_current_index(&tx, last_index - bundle_size);
+    transaction_set_last_index(&tx, last_index);
+    transaction_set_timestamp(&tx, i);
+    if (bundle_size > 0 || i < TIPS_WINDOW) {
+      // Bundles are attached from their last transaction, the head first
+      index_to_hash(buffer, i + 1, 0);
+      transaction_set_trunk(&tx, buffer);
+      index_to_hash(buffer, i < TIPS_WINDOW ? num_txs : i + 1, 0);
+      transaction_set_branch(&tx, buffer);
+    } else {
+      index_to_hash(buffer, i - 1 - rand() % TIPS_WINDOW, 0);
+      transaction_set_trunk(&tx, buffer);
+      index_to_hash(buffer, i - 1 - rand() % TIPS_WINDOW, 0);
+      transaction_set_branch(&tx, buffer);
+    }
+
+    if ((ret = iota_stor_transaction_store(connection, &tx)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return ret;
+}
+
+typedef enum lookup_e {
+  LOOKUP_LOAD,
+  LOOKUP_EXIST,
+  LOOKUP_APPROVERS,
+  LOOKUP_APPROVERS_CURSOR,
+  LOOKUP_APPROVERS_COUNT,
+  LOOKUP_UPDATE_SOLID_STATE,
+} lookup_t;
+
+/**
+ * Runs an operation for each key
+ *
+ * @return the average duration of an operation in microseconds
+ */
+static double time_lookups(storage_connection_t const *const connection,
+                           lookup_t const lookup,
+                           flex_trit_t keys[][FLEX_TRIT_SIZE_243],
+                           size_t const num_keys) {
+  retcode_t ret = RC_OK;
+  iota_transaction_t tx;
+  iota_transaction_t *txs[1] = {&tx};
+  iota_stor_pack_t tx_pack = {.models = (void **)txs,
+                              .capacity = 1,
+                              .num_loaded = 0,
+                              .insufficient_capacity = false};
+  iota_stor_pack_t hash_pack;
+  iota_stor_cursor_t cursor;
+  flex_trit_t const *hash = NULL;
+  struct timespec start, end;
+  size_t count = 0;
+  bool exist = false;
+
+  if (hash_pack_init(&hash_pack, 8) != RC_OK) {
+    return -1;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; ret == RC_OK && i < num_keys; i++) {
+    switch (lookup) {
+      case LOOKUP_LOAD:
+        tx_pack.num_loaded = 0;
+        ret = iota_stor_transaction_load_essence_attachment_and_metadata(
+            connection, keys[i], &tx_pack);
+        break;
+      case LOOKUP_EXIST:
+        ret = iota_stor_transaction_exist(connection, TRANSACTION_FIELD_HASH,
+                                          keys[i], &exist);
+        break;
+      case LOOKUP_APPROVERS:
+        hash_pack_reset(&hash_pack);
+        ret = iota_stor_transaction_load_hashes_of_approvers(
+            connection, keys[i], &hash_pack, 0);
+        break;
+      case LOOKUP_APPROVERS_CURSOR:
+        if ((ret = iota_stor_transaction_cursor_hashes_of_approvers(
+                 connection, keys[i], 0, &cursor)) != RC_OK) {
+          break;
+        }
+        while ((ret = iota_stor_cursor_next(&cursor, &hash)) == RC_OK &&
+               hash != NULL) {
+          // Hashes are only walked, as a traversal would
+        }
+        iota_stor_cursor_close(&cursor);
+        break;
+      case LOOKUP_APPROVERS_COUNT:
+        ret = iota_stor_transaction_approvers_count(connection, keys[i],
+                                                    &count);
+        break;
+      case LOOKUP_UPDATE_SOLID_STATE:
+        ret = iota_stor_transaction_update_solid_state(connection, keys[i],
+                                                       true);
+        break;
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  hash_pack_free(&hash_pack);
+
+  return ret == RC_OK ? elapsed_ms(&start, &end) * 1e3 / num_keys : -1;
+}
+
+static double time_tips(storage_connection_t const *const connection) {
+  iota_stor_pack_t pack;
+  struct timespec start, end;
+  retcode_t ret = RC_OK;
+
+  if (hash_pack_init(&pack, TIPS_WINDOW) != RC_OK) {
+    return -1;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  ret = iota_stor_transaction_load_hashes_of_tips(connection, &pack,
+                                                  TIPS_WINDOW);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  hash_pack_free(&pack);
+
+  return ret == RC_OK ? elapsed_ms(&start, &end) * 1e3 : -1;
+}
+
+static double time_milestone_candidates(
+    storage_connection_t const *const connection,
+    flex_trit_t const *const coordinator) {
+  iota_stor_pack_t pack;
+  struct timespec start, end;
+  retcode_t ret = RC_OK;
+
+  if (hash_pack_init(&pack, 8) != RC_OK) {
+    return -1;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  while ((ret = iota_stor_transaction_load_hashes_of_milestone_candidates(
+              connection, &pack, coordinator)) == RC_OK &&
+         pack.insufficient_capacity) {
+    hash_pack_resize(&pack, 2);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  hash_pack_free(&pack);
+
+  return ret == RC_OK ? elapsed_ms(&start, &end) * 1e3 : -1;
+}
+
+/**
+ * Confirms the oldest transactions and prunes them
+ *
+ * @return the duration of the pruning in milliseconds
+ */
+static double time_prune(storage_connection_t const *const connection,
+                         uint64_t const num_txs, size_t *const count) {
+  hash243_set_t confirmed = NULL;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  struct timespec start, end;
+  retcode_t ret = RC_OK;
+
+  *count = 0;
+  for (uint64_t i = 0; i < num_txs / 2; i++) {
+    index_to_hash(hash, i, 0);
+    hash243_set_add(&confirmed, hash);
+  }
+  ret = iota_stor_transactions_update_snapshot_index(connection, confirmed, 1);
+  hash243_set_free(&confirmed);
+  if (ret != RC_OK) {
+    return -1;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  ret = iota_stor_transactions_prune(connection, 1, PRUNE_LIMIT, count);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  return ret == RC_OK ? elapsed_ms(&start, &end) : -1;
+}
+
+static retcode_t benchmark(uint64_t const num_txs) {
+  retcode_t ret = RC_OK;
+  storage_connection_t connection;
+  connection_config_t config = {.db_path = test_db_path};
+  flex_trit_t(*keys)[FLEX_TRIT_SIZE_243] = NULL;
+  flex_trit_t coordinator[FLEX_TRIT_SIZE_243];
+  struct timespec start, end;
+  size_t count = 0;
+
+  if ((keys = malloc(NUM_LOOKUPS * FLEX_TRIT_SIZE_243)) == NULL) {
+    return RC_OOM;
+  }
+  for (size_t i = 0; i < NUM_LOOKUPS; i++) {
+    index_to_hash(keys[i], rand() % num_txs, 0);
+  }
+  index_to_hash(coordinator, 0, 2);
+
+  connection_drop_db(&config);
+  copy_file(test_db_path, ciri_db_path);
+  if ((ret = connection_init(&connection, &config)) != RC_OK) {
+    goto done;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  if ((ret = populate(&connection, num_txs)) != RC_OK) {
+    goto done;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("%" PRIu64 " transactions stored in %.0f ms (%.3f us each)\n",
+         num_txs, elapsed_ms(&start, &end),
+         elapsed_ms(&start, &end) * 1e3 / num_txs);
+
+  printf("  %-21s %10.3f us\n", "load:",
+         time_lookups(&connection, LOOKUP_LOAD, keys, NUM_LOOKUPS));
+  printf("  %-21s %10.3f us\n", "exist:",
+         time_lookups(&connection, LOOKUP_EXIST, keys, NUM_LOOKUPS));
+  printf("  %-21s %10.3f us\n", "approvers:",
+         time_lookups(&connection, LOOKUP_APPROVERS, keys, NUM_LOOKUPS));
+  printf("  %-21s %10.3f us\n", "approvers (cursor):",
+         time_lookups(&connection, LOOKUP_APPROVERS_CURSOR, keys,
+                      NUM_LOOKUPS));
+  printf("  %-21s %10.3f us\n", "approvers count:",
+         time_lookups(&connection, LOOKUP_APPROVERS_COUNT, keys, NUM_LOOKUPS));
+  printf("  %-21s %10.3f us\n", "update solid state:",
+         time_lookups(&connection, LOOKUP_UPDATE_SOLID_STATE, keys,
+                      NUM_LOOKUPS));
+  printf("  %-21s %10.3f us\n", "tips:", time_tips(&connection));
+  printf("  %-21s %10.3f us\n", "milestone candidates:",
+         time_milestone_candidates(&connection, coordinator));
+  printf("  %-21s %10.3f ms", "prune:",
+         time_prune(&connection, num_txs, &count));
+  printf(" (%zu transactions)\n", count);
+
+  ret = connection_destroy(&connection);
+
+done:
+  free(keys);
+  connection_drop_db(&config);
+  return ret;
+}
+
+int main(int argc, char *argv[]) {
+  uint64_t default_txs[] = {10000, 100000};
+
+  if (storage_init() != RC_OK) {
+    return EXIT_FAILURE;
+  }
+
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++) {
+      if (benchmark(strtoull(argv[i], NULL, 10)) != RC_OK) {
+        return EXIT_FAILURE;
+      }
+    }
+  } else {
+    for (size_t i = 0; i < sizeof(default_txs) / sizeof(default_txs[0]);
+         i++) {
+      if (benchmark(default_txs[i]) != RC_OK) {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return storage_destroy() == RC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
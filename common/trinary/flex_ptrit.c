@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include "common/trinary/flex_ptrit.h"
+#include "common/trinary/trit_ptrit.h"
+#include "utils/macros.h"
+
+void flex_trits_from_ptrits(flex_trit_t *const to_flex_trits,
+                            ptrit_t const *const ptrits, size_t const index,
+                            size_t const length) {
+#if defined(FLEX_TRIT_ENCODING_1_TRIT_PER_BYTE)
+  ptrits_to_trits(ptrits, to_flex_trits, index, length);
+#else
+  trit_t trits[NUM_TRITS_PER_FLEX_TRIT];
+
+  for (size_t i = 0, j = 0; i < length; i += NUM_TRITS_PER_FLEX_TRIT, j++) {
+    size_t const num_trits = MIN(length - i, NUM_TRITS_PER_FLEX_TRIT);
+
+    memset(trits, 0, sizeof(trits));
+    ptrits_to_trits(ptrits + i, trits, index, num_trits);
+#if defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE)
+    int tryte = trits[0] + trits[1] * 3 + trits[2] * 9;
+    to_flex_trits[j] = TRYTE_ALPHABET[tryte < 0 ? tryte + TRYTE_SPACE : tryte];
+#elif defined(FLEX_TRIT_ENCODING_4_TRITS_PER_BYTE)
+    to_flex_trits[j] = (trits[0] & 0x03) | (trits[1] & 0x03) << 2U |
+                       (trits[2] & 0x03) << 4U | (trits[3] & 0x03) << 6U;
+#elif defined(FLEX_TRIT_ENCODING_5_TRITS_PER_BYTE)
+    to_flex_trits[j] = trits_to_byte(trits, NUM_TRITS_PER_FLEX_TRIT);
+#endif
+  }
+#endif
+}
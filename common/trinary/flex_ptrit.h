@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_TRINARY_FLEX_PTRIT_H_
+#define __COMMON_TRINARY_FLEX_PTRIT_H_
+
+#include "common/stdint.h"
+#include "common/trinary/flex_trit.h"
+#include "common/trinary/ptrit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Extracts a lane of ptrits straight into flex_trits. It is equivalent to
+/// ptrits_to_trits followed by flex_trits_from_trits, without the
+/// intermediate trits.
+/// @param[in] to_flex_trits - An array of NUM_FLEX_TRITS_FOR_TRITS(length)
+/// flex_trits
+/// @param[in] ptrits - An array of length ptrits
+/// @param[in] index - the lane to extract
+/// @param[in] length - the number of trits to extract
+void flex_trits_from_ptrits(flex_trit_t *const to_flex_trits,
+                            ptrit_t const *const ptrits, size_t const index,
+                            size_t const length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_TRINARY_FLEX_PTRIT_H_
@@ -12,6 +12,12 @@
 #include "common/trinary/trit_byte.h"
 #include "utils/macros.h"
 
+#if defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE)
+// Conversions between bytes and trytes go through trits by chunks that are a
+// whole number of both bytes and trytes, so that both halves are vectorized
+#define FLEX_TRIT_CHUNK_TRITS (15 * 64)
+#endif
+
 size_t flex_trits_slice(flex_trit_t *const to_flex_trits, size_t const to_len,
                         flex_trit_t const *const flex_trits, size_t const len,
                         size_t const start, size_t const num_trits) {
@@ -288,8 +294,15 @@ size_t flex_trits_to_bytes(byte_t *bytes, size_t to_len,
   memset(bytes, 0, MIN_BYTES(to_len));
 #if defined(FLEX_TRIT_ENCODING_1_TRIT_PER_BYTE)
   trits_to_bytes((trit_t *)flex_trits, bytes, num_trits);
-#elif defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE) || \
-    defined(FLEX_TRIT_ENCODING_4_TRITS_PER_BYTE)
+#elif defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE)
+  trit_t trits[FLEX_TRIT_CHUNK_TRITS];
+  for (size_t i = 0; i < num_trits; i += FLEX_TRIT_CHUNK_TRITS) {
+    size_t chunk = MIN(FLEX_TRIT_CHUNK_TRITS, num_trits - i);
+    trytes_to_trits((tryte_t *)flex_trits + i / NUMBER_OF_TRITS_IN_A_TRYTE,
+                    trits, num_trytes_for_trits(chunk));
+    trits_to_bytes(trits, bytes + i / NUMBER_OF_TRITS_IN_A_BYTE, chunk);
+  }
+#elif defined(FLEX_TRIT_ENCODING_4_TRITS_PER_BYTE)
   union _shifter {
     uint64_t val;
     trit_t trits[8];
@@ -345,8 +358,17 @@ size_t flex_trits_from_bytes(flex_trit_t *to_flex_trits, size_t to_len,
 #if defined(FLEX_TRIT_ENCODING_1_TRIT_PER_BYTE)
   size_t num_bytes = MIN_BYTES(num_trits);
   bytes_to_trits(bytes, num_bytes, to_flex_trits, num_trits);
-#elif defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE) || \
-    defined(FLEX_TRIT_ENCODING_4_TRITS_PER_BYTE)
+#elif defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE)
+  trit_t trits[FLEX_TRIT_CHUNK_TRITS];
+  for (size_t i = 0; i < num_trits; i += FLEX_TRIT_CHUNK_TRITS) {
+    size_t chunk = MIN(FLEX_TRIT_CHUNK_TRITS, num_trits - i);
+    bytes_to_trits(bytes + i / NUMBER_OF_TRITS_IN_A_BYTE, MIN_BYTES(chunk),
+                   trits, chunk);
+    trits_to_trytes(trits, (tryte_t *)to_flex_trits +
+                               i / NUMBER_OF_TRITS_IN_A_TRYTE,
+                    chunk);
+  }
+#elif defined(FLEX_TRIT_ENCODING_4_TRITS_PER_BYTE)
   union _shifter {
     uint64_t val;
     trit_t trits[8];
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "common/trinary/flex_trit.h"
+#include "common/trinary/trit_byte.h"
+#include "common/trinary/trit_ptrit.h"
+#include "common/trinary/trit_simd.h"
+#include "common/trinary/trit_tryte.h"
+
+// A transaction worth of trits
+#define NUM_TRITS 8019
+#define NUM_BYTES MIN_BYTES(NUM_TRITS)
+#define NUM_TRYTES (NUM_TRITS / NUMBER_OF_TRITS_IN_A_TRYTE)
+#define NUM_FLEX_TRITS NUM_FLEX_TRITS_FOR_TRITS(NUM_TRITS)
+#define NUM_RUNS 20000
+
+static trit_t trits[NUM_TRITS];
+static byte_t bytes[NUM_BYTES];
+static tryte_t trytes[NUM_TRYTES];
+static flex_trit_t flex_trits[NUM_FLEX_TRITS];
+static ptrit_t ptrits[NUM_TRITS];
+
+static double elapsed_ms(struct timespec const *const start,
+                         struct timespec const *const end) {
+  return (end->tv_sec - start->tv_sec) * 1e3 +
+         (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static void bench_bytes_to_trits(void) {
+  bytes_to_trits(bytes, NUM_BYTES, trits, NUM_TRITS);
+}
+
+static void bench_trits_to_bytes(void) {
+  trits_to_bytes(trits, bytes, NUM_TRITS);
+}
+
+static void bench_trytes_to_trits(void) {
+  trytes_to_trits(trytes, trits, NUM_TRYTES);
+}
+
+static void bench_trits_to_trytes(void) {
+  trits_to_trytes(trits, trytes, NUM_TRITS);
+}
+
+static void bench_flex_trits_from_bytes(void) {
+  flex_trits_from_bytes(flex_trits, NUM_TRITS, bytes, NUM_TRITS, NUM_TRITS);
+}
+
+static void bench_flex_trits_to_bytes(void) {
+  flex_trits_to_bytes(bytes, NUM_TRITS, flex_trits, NUM_TRITS, NUM_TRITS);
+}
+
+static void bench_trits_to_ptrits(void) {
+  trits_to_ptrits(trits, ptrits, 0, NUM_TRITS);
+}
+
+static void benchmark(char const *const name, void (*convert)(void)) {
+  struct timespec start, end;
+  double ms = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < NUM_RUNS; i++) {
+    convert();
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  ms = elapsed_ms(&start, &end);
+
+  printf("  %-22s %8.3f us per transaction %8.3f Gtrit/s\n", name,
+         ms * 1e3 / NUM_RUNS, (double)NUM_TRITS * NUM_RUNS / (ms * 1e6));
+}
+
+int main(void) {
+  char const *const level_names[] = {"none", "sse4.1", "avx2"};
+  trit_simd_level_t const supported = trit_simd_set_level(TRIT_SIMD_AVX2);
+
+  for (size_t i = 0; i < NUM_TRITS; i++) {
+    trits[i] = (trit_t)(rand() % 3 - 1);
+  }
+  trits_to_bytes(trits, bytes, NUM_TRITS);
+  trits_to_trytes(trits, trytes, NUM_TRITS);
+  flex_trits_from_trits(flex_trits, NUM_TRITS, trits, NUM_TRITS, NUM_TRITS);
+
+  for (int level = TRIT_SIMD_NONE; level <= (int)supported; level++) {
+    trit_simd_set_level((trit_simd_level_t)level);
+    printf("%s:\n", level_names[level]);
+    benchmark("bytes_to_trits", bench_bytes_to_trits);
+    benchmark("trits_to_bytes", bench_trits_to_bytes);
+    benchmark("trytes_to_trits", bench_trytes_to_trits);
+    benchmark("trits_to_trytes", bench_trits_to_trytes);
+    benchmark("flex_trits_from_bytes", bench_flex_trits_from_bytes);
+    benchmark("flex_trits_to_bytes", bench_flex_trits_to_bytes);
+    benchmark("trits_to_ptrits", bench_trits_to_ptrits);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "common/trinary/flex_ptrit.h"
+#include "common/trinary/trit_ptrit.h"
+
+#if defined(FLEX_TRIT_ENCODING_1_TRIT_PER_BYTE)
+#define FLEX_TRITS_EXP -1, 0, 1, 1, 0, 1, 1, 0, -1, -1, 1, 0, 1, 1, 0, -1, 1, 0
+#elif defined(FLEX_TRIT_ENCODING_3_TRITS_PER_BYTE)
+#define FLEX_TRITS_EXP 0x48, 0x4a, 0x53, 0x42, 0x44, 0x42
+#elif defined(FLEX_TRIT_ENCODING_4_TRITS_PER_BYTE)
+#define FLEX_TRITS_EXP 0x53, 0x14, 0x1f, 0xC5, 0x01
+#elif defined(FLEX_TRIT_ENCODING_5_TRITS_PER_BYTE)
+#define FLEX_TRITS_EXP 0x23, 0x98, 0x25, 0x02
+#endif
+#define TRITS_IN -1, 0, 1, 1, 0, 1, 1, 0, -1, -1, 1, 0, 1, 1, 0, -1, 1, 0
+#define NUM_TRITS 18
+
+void test_flex_trits_from_ptrits(void) {
+  trit_t trits[] = {TRITS_IN};
+  trit_t zeros[NUM_TRITS] = {0};
+  flex_trit_t flex_trits[] = {FLEX_TRITS_EXP};
+  flex_trit_t flex_zeros[NUM_FLEX_TRITS_FOR_TRITS(NUM_TRITS)];
+  flex_trit_t flex_trits_out[NUM_FLEX_TRITS_FOR_TRITS(NUM_TRITS)];
+  ptrit_t ptrits[NUM_TRITS] = {{0}};
+
+  flex_trits_from_trits(flex_zeros, NUM_TRITS, zeros, NUM_TRITS, NUM_TRITS);
+
+  // Odd lanes hold the trits, even lanes are zeros
+  for (size_t i = 0; i < 64; i++) {
+    trits_to_ptrits(i % 2 ? trits : zeros, ptrits, i, NUM_TRITS);
+  }
+
+  for (size_t i = 0; i < 64; i++) {
+    flex_trits_from_ptrits(flex_trits_out, ptrits, i, NUM_TRITS);
+    TEST_ASSERT_EQUAL_MEMORY(i % 2 ? flex_trits : flex_zeros, flex_trits_out,
+                             sizeof(flex_trits_out));
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_flex_trits_from_ptrits);
+
+  return UNITY_END();
+}
@@ -5,11 +5,14 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <string.h>
 #include <unity/unity.h>
 
 #include "common/trinary/trit_ptrit.h"
 
 #define TRITS_IN -1, 0, 1
+#define BYTES_TRITS_IN -1, 0, 1, 1, 0, 1, 1, 0, -1, -1, 1, 0, 1
+#define BYTES_IN 0x23, 0x98, 0XA
 #define ptrit_EXP \
   {HIGH_BITS, LOW_BITS}, {HIGH_BITS, HIGH_BITS}, { LOW_BITS, HIGH_BITS }
 
@@ -31,10 +34,42 @@ void test_trit_to_ptrit(void) {
   TEST_ASSERT_EQUAL_MEMORY(exp, ptrit, sizeof(exp));
 }
 
+void test_bytes_to_ptrits(void) {
+  trit_t trits[] = {BYTES_TRITS_IN};
+  size_t const length = sizeof(trits) / sizeof(trit_t);
+  byte_t bytes[] = {BYTES_IN};
+  byte_t zeros[sizeof(bytes)] = {0};
+  byte_t const *lanes[64];
+  ptrit_t ptrits[sizeof(trits)];
+  trit_t trits_out[sizeof(trits)];
+  trit_t zero_trits[sizeof(trits)] = {0};
+
+  // Odd lanes hold the bytes, even lanes are zeros
+  for (size_t i = 0; i < 64; i++) {
+    lanes[i] = i % 2 ? bytes : zeros;
+  }
+
+  for (size_t num_lanes = 0; num_lanes <= 64; num_lanes++) {
+    memset(ptrits, 0xFF, sizeof(ptrits));
+    bytes_to_ptrits(lanes, num_lanes, ptrits, length);
+    for (size_t i = 0; i < num_lanes; i++) {
+      ptrits_to_trits(ptrits, trits_out, i, length);
+      TEST_ASSERT_EQUAL_MEMORY(i % 2 ? trits : zero_trits, trits_out,
+                               sizeof(trits));
+    }
+    // Lanes without bytes are cleared
+    for (size_t i = 0; i < length; i++) {
+      TEST_ASSERT_TRUE(num_lanes == 64 || (ptrits[i].low >> num_lanes == 0 &&
+                                           ptrits[i].high >> num_lanes == 0));
+    }
+  }
+}
+
 int main(void) {
   UNITY_BEGIN();
 
   RUN_TEST(test_trit_to_ptrit);
+  RUN_TEST(test_bytes_to_ptrits);
 
   return UNITY_END();
 }
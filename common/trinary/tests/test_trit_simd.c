@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unity/unity.h>
+
+#include "common/trinary/trit_byte.h"
+#include "common/trinary/trit_simd.h"
+#include "common/trinary/trit_tryte.h"
+
+// Long enough to cover several AVX2 blocks and odd tails
+#define NUM_TRITS 1000
+#define NUM_BYTES MIN_BYTES(NUM_TRITS)
+#define NUM_TRYTES (NUM_TRITS / NUMBER_OF_TRITS_IN_A_TRYTE)
+
+static trit_t trits[NUM_TRITS];
+static byte_t bytes[NUM_BYTES];
+static tryte_t trytes[NUM_TRYTES];
+
+static trit_simd_level_t const levels[] = {TRIT_SIMD_SSE4_1, TRIT_SIMD_AVX2};
+
+static void random_input(void) {
+  tryte_t const alphabet[] = "9ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+  for (size_t i = 0; i < NUM_TRITS; i++) {
+    trits[i] = (trit_t)(rand() % 3 - 1);
+  }
+  // Any byte value, including the ones no trits pack to
+  for (size_t i = 0; i < NUM_BYTES; i++) {
+    bytes[i] = (byte_t)rand();
+  }
+  for (size_t i = 0; i < NUM_TRYTES; i++) {
+    trytes[i] = alphabet[rand() % 27];
+  }
+}
+
+// Runs every conversion on all lengths and offsets up to a couple of blocks
+// and compares the outputs against the scalar implementation
+static void compare_to_scalar(trit_simd_level_t const level) {
+  trit_t trits_ref[NUM_TRITS], trits_out[NUM_TRITS];
+  byte_t bytes_ref[NUM_BYTES], bytes_out[NUM_BYTES];
+  tryte_t trytes_ref[NUM_TRYTES], trytes_out[NUM_TRYTES];
+
+  for (size_t offset = 0; offset < 3; offset++) {
+    for (size_t len = 0; len + offset * NUMBER_OF_TRITS_IN_A_BYTE <= NUM_TRITS;
+         len += len < 200 ? 1 : 97) {
+      size_t const num_bytes = MIN_BYTES(len);
+      size_t const num_trytes = len / NUMBER_OF_TRITS_IN_A_TRYTE;
+      size_t const trit_offset = offset * NUMBER_OF_TRITS_IN_A_BYTE;
+
+      memset(trits_ref, 0, sizeof(trits_ref));
+      memset(trits_out, 0, sizeof(trits_out));
+      trit_simd_set_level(TRIT_SIMD_NONE);
+      bytes_to_trits(bytes + offset, num_bytes, trits_ref, len);
+      trit_simd_set_level(level);
+      bytes_to_trits(bytes + offset, num_bytes, trits_out, len);
+      TEST_ASSERT_EQUAL_MEMORY(trits_ref, trits_out, sizeof(trits_ref));
+
+      memset(bytes_ref, 0, sizeof(bytes_ref));
+      memset(bytes_out, 0, sizeof(bytes_out));
+      trit_simd_set_level(TRIT_SIMD_NONE);
+      trits_to_bytes(trits + trit_offset, bytes_ref, len);
+      trit_simd_set_level(level);
+      trits_to_bytes(trits + trit_offset, bytes_out, len);
+      TEST_ASSERT_EQUAL_MEMORY(bytes_ref, bytes_out, sizeof(bytes_ref));
+
+      memset(trits_ref, 0, sizeof(trits_ref));
+      memset(trits_out, 0, sizeof(trits_out));
+      trit_simd_set_level(TRIT_SIMD_NONE);
+      trytes_to_trits(trytes + offset, trits_ref, num_trytes);
+      trit_simd_set_level(level);
+      trytes_to_trits(trytes + offset, trits_out, num_trytes);
+      TEST_ASSERT_EQUAL_MEMORY(trits_ref, trits_out, sizeof(trits_ref));
+
+      memset(trytes_ref, 0, sizeof(trytes_ref));
+      memset(trytes_out, 0, sizeof(trytes_out));
+      trit_simd_set_level(TRIT_SIMD_NONE);
+      trits_to_trytes(trits + trit_offset, trytes_ref, len);
+      trit_simd_set_level(level);
+      trits_to_trytes(trits + trit_offset, trytes_out, len);
+      TEST_ASSERT_EQUAL_MEMORY(trytes_ref, trytes_out, sizeof(trytes_ref));
+    }
+  }
+}
+
+void test_trit_simd_levels(void) {
+  trit_simd_level_t const supported = trit_simd_set_level(TRIT_SIMD_AVX2);
+
+  for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+    if (levels[i] > supported) {
+      continue;
+    }
+    TEST_ASSERT_EQUAL_INT(levels[i], trit_simd_set_level(levels[i]));
+    random_input();
+    compare_to_scalar(levels[i]);
+  }
+  trit_simd_set_level(supported);
+}
+
+void test_trit_simd_round_trip(void) {
+  trit_t trits_out[NUM_TRITS];
+  byte_t bytes_out[NUM_BYTES];
+  tryte_t trytes_out[NUM_TRYTES];
+
+  random_input();
+  trits_to_bytes(trits, bytes_out, NUM_TRITS);
+  bytes_to_trits(bytes_out, NUM_BYTES, trits_out, NUM_TRITS);
+  TEST_ASSERT_EQUAL_MEMORY(trits, trits_out, NUM_TRITS);
+
+  trytes_to_trits(trytes, trits_out, NUM_TRYTES);
+  trits_to_trytes(trits_out, trytes_out, NUM_TRYTES * 3);
+  TEST_ASSERT_EQUAL_MEMORY(trytes, trytes_out, NUM_TRYTES);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  srand(0);
+  RUN_TEST(test_trit_simd_levels);
+  RUN_TEST(test_trit_simd_round_trip);
+
+  return UNITY_END();
+}
@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include "common/trinary/trit_byte.h"
+#include "common/trinary/trit_simd.h"
 #include "utils/macros.h"
 
 // Since the LUT can be quite heavy for little devices, it is possible to
@@ -122,11 +123,17 @@ byte_t trits_to_byte(trit_t const *const trits, size_t const num_trits) {
 
 void trits_to_bytes(trit_t const *const trits, byte_t *const bytes,
                     size_t const num_trits) {
+  size_t j = 0;
+
   if (num_trits == 0) {
     return;
   }
 
-  for (size_t i = 0, j = 0; i < num_trits;
+  // Whole bytes go through the vectorized kernels when available
+  j = trit_simd_trits_to_bytes(trits, bytes,
+                               num_trits / NUMBER_OF_TRITS_IN_A_BYTE);
+
+  for (size_t i = j * NUMBER_OF_TRITS_IN_A_BYTE; i < num_trits;
        i += NUMBER_OF_TRITS_IN_A_BYTE, j++) {
     bytes[j] =
         trits_to_byte(trits + i, MIN(num_trits - i, NUMBER_OF_TRITS_IN_A_BYTE));
@@ -169,11 +176,17 @@ void byte_to_trits(byte_t const byte, trit_t *const trits,
 void bytes_to_trits(byte_t const *const bytes, size_t const num_bytes,
                     trit_t *const trits, size_t const num_trits) {
   assert(num_trits <= NUMBER_OF_TRITS_IN_A_BYTE * num_bytes);
+  size_t j = 0;
+
   if (num_bytes == 0 || num_trits == 0) {
     return;
   }
 
-  for (size_t i = 0, j = 0; i < num_trits && j < num_bytes;
+  // Whole bytes go through the vectorized kernels when available
+  j = trit_simd_bytes_to_trits(
+      bytes, trits, MIN(num_bytes, num_trits / NUMBER_OF_TRITS_IN_A_BYTE));
+
+  for (size_t i = j * NUMBER_OF_TRITS_IN_A_BYTE; i < num_trits && j < num_bytes;
        i += NUMBER_OF_TRITS_IN_A_BYTE, j++) {
     byte_to_trits(bytes[j], &trits[i],
                   MIN(num_trits - i, NUMBER_OF_TRITS_IN_A_BYTE));
@@ -5,7 +5,10 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <string.h>
+
 #include "common/trinary/trit_ptrit.h"
+#include "common/defs.h"
 
 void trits_to_ptrits(trit_t const *const trits, ptrit_t *const ptrits,
                      size_t const index, size_t const length) {
@@ -15,42 +18,20 @@ void trits_to_ptrits(trit_t const *const trits, ptrit_t *const ptrits,
     return;
   }
 
+  // Branchless so that the loop can be vectorized: the low bit is set for 0
+  // and -1, the high bit for 0 and 1
   for (; j < length; j++) {
-    switch (trits[j]) {
-      case 0:
-        ptrits[j].low |= (1uLL << index);
-        ptrits[j].high |= (1uLL << index);
-        break;
-      case 1:
-        ptrits[j].high |= (1uLL << index);
-        break;
-      default:
-        ptrits[j].low |= (1uLL << index);
-        break;
-    }
+    ptrits[j].low |= (uint64_t)(trits[j] != 1) << index;
+    ptrits[j].high |= (uint64_t)((uint8_t)trits[j] <= 1) << index;
   }
 }
 
 void trits_to_ptrits_fill(trit_t const *const trits, ptrit_t *const ptrits,
                           size_t const length) {
-  if (length == 0) {
-    return;
+  for (size_t j = 0; j < length; j++) {
+    ptrits[j].low = trits[j] != 1 ? HIGH_BITS : LOW_BITS;
+    ptrits[j].high = (uint8_t)trits[j] <= 1 ? HIGH_BITS : LOW_BITS;
   }
-
-  switch (*trits) {
-    case 0:
-      ptrits->low = HIGH_BITS;
-      ptrits->high = HIGH_BITS;
-      break;
-    case 1:
-      ptrits->low = LOW_BITS;
-      ptrits->high = HIGH_BITS;
-      break;
-    default:
-      ptrits->low = HIGH_BITS;
-      ptrits->high = LOW_BITS;
-  }
-  trits_to_ptrits_fill(&trits[1], &ptrits[1], length - 1);
 }
 
 void ptrits_to_trits(ptrit_t const *const ptrits, trit_t *const trits,
@@ -65,6 +46,109 @@ void ptrits_to_trits(ptrit_t const *const ptrits, trit_t *const trits,
     int h = (ptrits[j].high >> index) & 1;
     int l = (ptrits[j].low >> index) & 1;
 
-    trits[j] = l ? (h ? 0 : -1) : 1;
+    // 1 if l is unset, else 0 or -1 depending on h
+    trits[j] = 1 - l - (l & (h ^ 1));
+  }
+}
+
+// The trits of a byte as ptrit bits: low bits in the low byte and high bits in
+// the high byte. Indexed by the unsigned byte, values out of the trits range
+// wrap around like in bytes_to_trits.
+#define BYTE_VALUE(b) ((b) < 128 ? (b) : (b)-256)
+#define BYTE_ROW(b) (BYTE_VALUE(b) < 0 ? BYTE_VALUE(b) + 243 : BYTE_VALUE(b))
+#define BYTE_TRITS(b) (BYTE_ROW(b) <= 121 ? BYTE_ROW(b) : BYTE_ROW(b) - 243)
+// 0, 1 or 2 for a trit of -1, 0 or 1
+#define BYTE_DIGIT(b, k) (((BYTE_TRITS(b) + 121) / (k)) % 3)
+#define BYTE_PTRIT(b, k, s) \
+  ((BYTE_DIGIT(b, k) != 2) << (s) | (BYTE_DIGIT(b, k) != 0) << ((s) + 8))
+#define BYTE_PTRITS(b)                                                       \
+  (BYTE_PTRIT(b, 1, 0) | BYTE_PTRIT(b, 3, 1) | BYTE_PTRIT(b, 9, 2) |         \
+   BYTE_PTRIT(b, 27, 3) | BYTE_PTRIT(b, 81, 4))
+#define BYTE_PTRITS_4(b) \
+  BYTE_PTRITS(b), BYTE_PTRITS(b + 1), BYTE_PTRITS(b + 2), BYTE_PTRITS(b + 3)
+#define BYTE_PTRITS_16(b)                                            \
+  BYTE_PTRITS_4(b), BYTE_PTRITS_4(b + 4), BYTE_PTRITS_4(b + 8), \
+      BYTE_PTRITS_4(b + 12)
+#define BYTE_PTRITS_64(b)                                                \
+  BYTE_PTRITS_16(b), BYTE_PTRITS_16(b + 16), BYTE_PTRITS_16(b + 32), \
+      BYTE_PTRITS_16(b + 48)
+
+static uint16_t const BYTE_PTRITS_LUT[256] = {
+    BYTE_PTRITS_64(0), BYTE_PTRITS_64(64), BYTE_PTRITS_64(128),
+    BYTE_PTRITS_64(192)};
+
+// Transposes the 8x8 bit matrix whose rows are the bytes of x
+static inline uint64_t transpose_8x8(uint64_t x) {
+  uint64_t t;
+
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x ^= t ^ (t << 28);
+  return x;
+}
+
+// Spreads byte i of 8 rows of bytes over 5 ptrits. The bytes make a 8x8 bit
+// matrix, one row per lane, that is transposed into one row per trit.
+#define BYTE_ROW_BITS(r)                     \
+  bits = BYTE_PTRITS_LUT[(uint8_t)rows[r][i]]; \
+  l |= (uint64_t)(bits & 0xFF) << ((r)*8);     \
+  h |= (uint64_t)(bits >> 8) << ((r)*8)
+
+static inline void bytes_to_ptrits_8(byte_t const *const *const rows,
+                                     size_t const i, uint64_t const mask,
+                                     uint64_t *const low, uint64_t *const high) {
+  uint64_t l = 0, h = 0;
+  uint16_t bits;
+
+  BYTE_ROW_BITS(0);
+  BYTE_ROW_BITS(1);
+  BYTE_ROW_BITS(2);
+  BYTE_ROW_BITS(3);
+  BYTE_ROW_BITS(4);
+  BYTE_ROW_BITS(5);
+  BYTE_ROW_BITS(6);
+  BYTE_ROW_BITS(7);
+  *low = transpose_8x8(l) & mask;
+  *high = transpose_8x8(h) & mask;
+}
+
+void bytes_to_ptrits(byte_t const *const *const bytes, size_t const num_lanes,
+                     ptrit_t *const ptrits, size_t const length) {
+  size_t const lanes = num_lanes < 64 ? num_lanes : 64;
+  size_t const num_full_bytes = length / NUMBER_OF_TRITS_IN_A_BYTE;
+  size_t const tail = length % NUMBER_OF_TRITS_IN_A_BYTE;
+
+  memset(ptrits, 0, length * sizeof(ptrit_t));
+
+  // Going through a group of 8 lanes at once reads the bytes sequentially
+  for (size_t group = 0; group < lanes; group += 8) {
+    byte_t const *rows[8];
+    size_t const num_rows = lanes - group < 8 ? lanes - group : 8;
+    // Missing rows repeat the last lane and are masked out of the result
+    uint64_t const mask = 0x0101010101010101ULL * ((1U << num_rows) - 1);
+    uint64_t l, h;
+    size_t i = 0, j = 0;
+
+    for (size_t r = 0; r < 8; r++) {
+      rows[r] = bytes[group + (r < num_rows ? r : num_rows - 1)];
+    }
+
+    for (; i < num_full_bytes; i++, j += NUMBER_OF_TRITS_IN_A_BYTE) {
+      bytes_to_ptrits_8(rows, i, mask, &l, &h);
+      for (size_t k = 0; k < NUMBER_OF_TRITS_IN_A_BYTE; k++) {
+        ptrits[j + k].low |= ((l >> (k * 8)) & 0xFF) << group;
+        ptrits[j + k].high |= ((h >> (k * 8)) & 0xFF) << group;
+      }
+    }
+    if (tail) {
+      bytes_to_ptrits_8(rows, i, mask, &l, &h);
+      for (size_t k = 0; k < tail; k++) {
+        ptrits[j + k].low |= ((l >> (k * 8)) & 0xFF) << group;
+        ptrits[j + k].high |= ((h >> (k * 8)) & 0xFF) << group;
+      }
+    }
   }
 }
@@ -9,6 +9,7 @@
 #define __COMMON_TRINARY_TRIT_PTRIT_H_
 
 #include "common/stdint.h"
+#include "common/trinary/bytes.h"
 #include "common/trinary/ptrit_incr.h"
 #include "common/trinary/trits.h"
 
@@ -23,6 +24,17 @@ void trits_to_ptrits_fill(trit_t const *const trits, ptrit_t *const ptrits,
 void ptrits_to_trits(ptrit_t const *const ptrits, trit_t *const trits,
                      size_t const index, size_t const length);
 
+/// Unpacks up to 64 arrays of bytes straight into ptrits, the array at index i
+/// going to lane i. It is equivalent to bytes_to_trits followed by
+/// trits_to_ptrits for every lane, without the intermediate trits.
+/// @param[in] bytes - An array of num_lanes arrays of MIN_BYTES(length) bytes
+/// @param[in] num_lanes - the number of arrays, at most 64
+/// @param[in] ptrits - An array of length ptrits, overwritten, lanes past
+/// num_lanes being cleared
+/// @param[in] length - the number of trits to unpack from every array
+void bytes_to_ptrits(byte_t const *const *const bytes, size_t const num_lanes,
+                     ptrit_t *const ptrits, size_t const length);
+
 #ifdef __cplusplus
 }
 #endif
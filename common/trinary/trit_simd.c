@@ -0,0 +1,546 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include "common/trinary/trit_simd.h"
+#include "common/defs.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TRIT_SIMD_X86
+#include <immintrin.h>
+#endif
+
+// -1 until the CPU has been probed. Probing always gives the same result so
+// concurrent first calls are harmless.
+static int supported_level = -1;
+static trit_simd_level_t level_cap = TRIT_SIMD_AVX2;
+
+static trit_simd_level_t trit_simd_supported_level(void) {
+  if (supported_level < 0) {
+    trit_simd_level_t level = TRIT_SIMD_NONE;
+
+#ifdef TRIT_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      level = TRIT_SIMD_AVX2;
+    } else if (__builtin_cpu_supports("sse4.1")) {
+      level = TRIT_SIMD_SSE4_1;
+    }
+#endif
+    supported_level = level;
+  }
+
+  return (trit_simd_level_t)supported_level;
+}
+
+trit_simd_level_t trit_simd_level(void) {
+  trit_simd_level_t supported = trit_simd_supported_level();
+
+  return level_cap < supported ? level_cap : supported;
+}
+
+trit_simd_level_t trit_simd_set_level(trit_simd_level_t const level) {
+  level_cap = level;
+  return trit_simd_level();
+}
+
+#ifdef TRIT_SIMD_X86
+
+#define SIMD_TARGET_SSE4_1 __attribute__((target("sse4.1")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+
+/*
+ * Shuffle masks
+ *
+ * A block of 16 bytes or trytes gives G digit vectors, vector i holding digit
+ * i of every element, G being 5 trits per byte or 3 trits per tryte. Merging
+ * interleaves the G vectors into G chunks of 16 trits, splitting is the
+ * reverse. Each output vector is the OR of G byte shuffles, lanes taken from
+ * another input being zeroed by the 0x80 mask bytes.
+ */
+
+#define LANES_16(F, G, A, B)                                          \
+  F(G, A, B, 0), F(G, A, B, 1), F(G, A, B, 2), F(G, A, B, 3),         \
+      F(G, A, B, 4), F(G, A, B, 5), F(G, A, B, 6), F(G, A, B, 7),     \
+      F(G, A, B, 8), F(G, A, B, 9), F(G, A, B, 10), F(G, A, B, 11),   \
+      F(G, A, B, 12), F(G, A, B, 13), F(G, A, B, 14), F(G, A, B, 15)
+#define MASK(F, G, A, B) \
+  { LANES_16(F, G, A, B) }
+#define MASKS_3(F, G, A) \
+  { MASK(F, G, A, 0), MASK(F, G, A, 1), MASK(F, G, A, 2) }
+#define MASKS_5(F, G, A)                                               \
+  {                                                                    \
+    MASK(F, G, A, 0), MASK(F, G, A, 1), MASK(F, G, A, 2),              \
+        MASK(F, G, A, 3), MASK(F, G, A, 4)                             \
+  }
+
+// Lane p of output chunk c takes digit (16c + p) % G of element (16c + p) / G
+#define MERGE_LANE(G, c, i, p) \
+  (((16 * (c) + (p)) % (G)) == (i) ? (16 * (c) + (p)) / (G) : 0x80)
+// Lane j of digit vector i takes trit Gj + i, found in input chunk (Gj + i)/16
+#define SPLIT_LANE(G, i, c, j) \
+  ((((G) * (j) + (i)) / 16) == (c) ? ((G) * (j) + (i)) % 16 : 0x80)
+
+// Indexed by [chunk][digit]
+static uint8_t const MERGE_3[3][3][16] = {MASKS_3(MERGE_LANE, 3, 0),
+                                          MASKS_3(MERGE_LANE, 3, 1),
+                                          MASKS_3(MERGE_LANE, 3, 2)};
+static uint8_t const MERGE_5[5][5][16] = {
+    MASKS_5(MERGE_LANE, 5, 0), MASKS_5(MERGE_LANE, 5, 1),
+    MASKS_5(MERGE_LANE, 5, 2), MASKS_5(MERGE_LANE, 5, 3),
+    MASKS_5(MERGE_LANE, 5, 4)};
+// Indexed by [digit][chunk]
+static uint8_t const SPLIT_3[3][3][16] = {MASKS_3(SPLIT_LANE, 3, 0),
+                                          MASKS_3(SPLIT_LANE, 3, 1),
+                                          MASKS_3(SPLIT_LANE, 3, 2)};
+static uint8_t const SPLIT_5[5][5][16] = {
+    MASKS_5(SPLIT_LANE, 5, 0), MASKS_5(SPLIT_LANE, 5, 1),
+    MASKS_5(SPLIT_LANE, 5, 2), MASKS_5(SPLIT_LANE, 5, 3),
+    MASKS_5(SPLIT_LANE, 5, 4)};
+
+// Trit k of the tryte of index t, i.e. of value t or t - 27, is the k-th base 3
+// digit of the value plus 13, minus 1
+#define TRYTE_TRIT(t, k)                                              \
+  (((((t) <= 13 ? (t) : (t)-27) + 13) / ((k) == 0 ? 1 : (k) == 1 ? 3 : 9)) % \
+       3 -                                                             \
+   1)
+#define TRYTE_TRIT_LOW(G, k, unused, p) TRYTE_TRIT(p, k)
+#define TRYTE_TRIT_HIGH(G, k, unused, p) \
+  ((p) + 16 < TRYTE_SPACE ? TRYTE_TRIT((p) + 16, k) : 0)
+
+// Trits of the trytes of index 0 to 15 and 16 to 26, indexed by [trit]
+static int8_t const TRYTE_TRITS_LOW[3][16] = {
+    MASK(TRYTE_TRIT_LOW, 0, 0, 0), MASK(TRYTE_TRIT_LOW, 0, 1, 0),
+    MASK(TRYTE_TRIT_LOW, 0, 2, 0)};
+static int8_t const TRYTE_TRITS_HIGH[3][16] = {
+    MASK(TRYTE_TRIT_HIGH, 0, 0, 0), MASK(TRYTE_TRIT_HIGH, 0, 1, 0),
+    MASK(TRYTE_TRIT_HIGH, 0, 2, 0)};
+
+#define LOAD_128(p) _mm_loadu_si128((__m128i const *)(p))
+#define LOAD_256(p) _mm256_broadcastsi128_si256(LOAD_128(p))
+#define LOAD_2x128(low, high) \
+  _mm256_inserti128_si256(_mm256_castsi128_si256(LOAD_128(low)), LOAD_128(high), 1)
+
+/*
+ * SSE4.1 kernels, one block of 16 elements at a time
+ */
+
+SIMD_TARGET_SSE4_1 static inline __m128i sse4_1_times_3_plus(__m128i const x,
+                                                            __m128i const y) {
+  return _mm_add_epi8(_mm_add_epi8(x, _mm_add_epi8(x, x)), y);
+}
+
+// Maps 16 bit values of any byte to their index in [0, 242], i.e. the value of
+// the 5 trits plus 1 each, as the byte lookup table does
+SIMD_TARGET_SSE4_1 static inline __m128i sse4_1_byte_index(__m128i u) {
+  u = _mm_add_epi16(u, _mm_set1_epi16(121));
+  u = _mm_add_epi16(u, _mm_and_si128(_mm_cmpgt_epi16(_mm_setzero_si128(), u),
+                                     _mm_set1_epi16(243)));
+  return _mm_sub_epi16(
+      u, _mm_and_si128(_mm_cmpgt_epi16(u, _mm_set1_epi16(242)),
+                       _mm_set1_epi16(243)));
+}
+
+SIMD_TARGET_SSE4_1 static size_t bytes_to_trits_sse4_1(
+    byte_t const *const bytes, trit_t *const trits, size_t const num_bytes) {
+  __m128i merge[5][5], u[2], q[2], d[5], out;
+  __m128i const one = _mm_set1_epi8(1);
+  // x / 3 == (x * 171) >> 9 for x in [0, 255]
+  __m128i const third = _mm_set1_epi16(171);
+  size_t i = 0;
+
+  for (size_t c = 0; c < 5; c++) {
+    for (size_t k = 0; k < 5; k++) {
+      merge[c][k] = LOAD_128(MERGE_5[c][k]);
+    }
+  }
+
+  for (; i + 16 <= num_bytes; i += 16) {
+    __m128i v = LOAD_128(bytes + i);
+
+    u[0] = sse4_1_byte_index(_mm_cvtepi8_epi16(v));
+    u[1] = sse4_1_byte_index(_mm_cvtepi8_epi16(_mm_srli_si128(v, 8)));
+    for (size_t k = 0; k < 5; k++) {
+      for (size_t h = 0; h < 2; h++) {
+        q[h] = _mm_srli_epi16(_mm_mullo_epi16(u[h], third), 9);
+        u[h] = _mm_sub_epi16(u[h], _mm_add_epi16(q[h], _mm_add_epi16(q[h], q[h])));
+      }
+      d[k] = _mm_sub_epi8(_mm_packs_epi16(u[0], u[1]), one);
+      u[0] = q[0];
+      u[1] = q[1];
+    }
+    for (size_t c = 0; c < 5; c++) {
+      out = _mm_shuffle_epi8(d[0], merge[c][0]);
+      for (size_t k = 1; k < 5; k++) {
+        out = _mm_or_si128(out, _mm_shuffle_epi8(d[k], merge[c][k]));
+      }
+      _mm_storeu_si128((__m128i *)(trits + 5 * i + 16 * c), out);
+    }
+  }
+
+  return i;
+}
+
+SIMD_TARGET_SSE4_1 static size_t trits_to_bytes_sse4_1(
+    trit_t const *const trits, byte_t *const bytes, size_t const num_bytes) {
+  __m128i split[5][5], in[5], d[5], x;
+  size_t i = 0;
+
+  for (size_t k = 0; k < 5; k++) {
+    for (size_t c = 0; c < 5; c++) {
+      split[k][c] = LOAD_128(SPLIT_5[k][c]);
+    }
+  }
+
+  for (; i + 16 <= num_bytes; i += 16) {
+    for (size_t c = 0; c < 5; c++) {
+      in[c] = LOAD_128(trits + 5 * i + 16 * c);
+    }
+    for (size_t k = 0; k < 5; k++) {
+      d[k] = _mm_shuffle_epi8(in[0], split[k][0]);
+      for (size_t c = 1; c < 5; c++) {
+        d[k] = _mm_or_si128(d[k], _mm_shuffle_epi8(in[c], split[k][c]));
+      }
+    }
+    x = d[4];
+    for (size_t k = 4; k-- > 0;) {
+      x = sse4_1_times_3_plus(x, d[k]);
+    }
+    _mm_storeu_si128((__m128i *)(bytes + i), x);
+  }
+
+  return i;
+}
+
+SIMD_TARGET_SSE4_1 static size_t trytes_to_trits_sse4_1(
+    tryte_t const *const trytes, trit_t *const trits, size_t const num_trytes) {
+  __m128i merge[3][3], low[3], high[3], d[3], out;
+  size_t i = 0;
+
+  for (size_t k = 0; k < 3; k++) {
+    for (size_t c = 0; c < 3; c++) {
+      merge[c][k] = LOAD_128(MERGE_3[c][k]);
+    }
+    low[k] = LOAD_128(TRYTE_TRITS_LOW[k]);
+    high[k] = LOAD_128(TRYTE_TRITS_HIGH[k]);
+  }
+
+  for (; i + 16 <= num_trytes; i += 16) {
+    __m128i v = LOAD_128(trytes + i);
+    __m128i index = _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('9')),
+                                     _mm_sub_epi8(v, _mm_set1_epi8('A' - 1)));
+    __m128i is_high = _mm_cmpgt_epi8(index, _mm_set1_epi8(15));
+    __m128i high_index = _mm_sub_epi8(index, _mm_set1_epi8(16));
+
+    for (size_t k = 0; k < 3; k++) {
+      d[k] = _mm_blendv_epi8(_mm_shuffle_epi8(low[k], index),
+                             _mm_shuffle_epi8(high[k], high_index), is_high);
+    }
+    for (size_t c = 0; c < 3; c++) {
+      out = _mm_shuffle_epi8(d[0], merge[c][0]);
+      for (size_t k = 1; k < 3; k++) {
+        out = _mm_or_si128(out, _mm_shuffle_epi8(d[k], merge[c][k]));
+      }
+      _mm_storeu_si128((__m128i *)(trits + 3 * i + 16 * c), out);
+    }
+  }
+
+  return i;
+}
+
+SIMD_TARGET_SSE4_1 static size_t trits_to_trytes_sse4_1(
+    trit_t const *const trits, tryte_t *const trytes, size_t const num_trytes) {
+  __m128i split[3][3], in[3], d[3], x;
+  size_t i = 0;
+
+  for (size_t k = 0; k < 3; k++) {
+    for (size_t c = 0; c < 3; c++) {
+      split[k][c] = LOAD_128(SPLIT_3[k][c]);
+    }
+  }
+
+  for (; i + 16 <= num_trytes; i += 16) {
+    for (size_t c = 0; c < 3; c++) {
+      in[c] = LOAD_128(trits + 3 * i + 16 * c);
+    }
+    for (size_t k = 0; k < 3; k++) {
+      d[k] = _mm_shuffle_epi8(in[0], split[k][0]);
+      for (size_t c = 1; c < 3; c++) {
+        d[k] = _mm_or_si128(d[k], _mm_shuffle_epi8(in[c], split[k][c]));
+      }
+    }
+    x = sse4_1_times_3_plus(sse4_1_times_3_plus(d[2], d[1]), d[0]);
+    // Value in [-13, 13] to index in [0, 26] to character
+    x = _mm_add_epi8(x, _mm_and_si128(_mm_cmpgt_epi8(_mm_setzero_si128(), x),
+                                      _mm_set1_epi8(TRYTE_SPACE)));
+    x = _mm_blendv_epi8(_mm_add_epi8(x, _mm_set1_epi8('A' - 1)),
+                        _mm_set1_epi8('9'),
+                        _mm_cmpeq_epi8(x, _mm_setzero_si128()));
+    _mm_storeu_si128((__m128i *)(trytes + i), x);
+  }
+
+  return i;
+}
+
+/*
+ * AVX2 kernels, two blocks of 16 elements at a time, one per 128 bit lane
+ * since byte shuffles don't cross lanes
+ */
+
+SIMD_TARGET_AVX2 static inline __m256i avx2_times_3_plus(__m256i const x,
+                                                        __m256i const y) {
+  return _mm256_add_epi8(_mm256_add_epi8(x, _mm256_add_epi8(x, x)), y);
+}
+
+SIMD_TARGET_AVX2 static inline __m256i avx2_byte_index(__m256i u) {
+  u = _mm256_add_epi16(u, _mm256_set1_epi16(121));
+  u = _mm256_add_epi16(
+      u, _mm256_and_si256(_mm256_cmpgt_epi16(_mm256_setzero_si256(), u),
+                          _mm256_set1_epi16(243)));
+  return _mm256_sub_epi16(
+      u, _mm256_and_si256(_mm256_cmpgt_epi16(u, _mm256_set1_epi16(242)),
+                          _mm256_set1_epi16(243)));
+}
+
+SIMD_TARGET_AVX2 static inline void avx2_store_2x128(void *const low,
+                                                    void *const high,
+                                                    __m256i const x) {
+  _mm_storeu_si128((__m128i *)low, _mm256_castsi256_si128(x));
+  _mm_storeu_si128((__m128i *)high, _mm256_extracti128_si256(x, 1));
+}
+
+SIMD_TARGET_AVX2 static size_t bytes_to_trits_avx2(byte_t const *const bytes,
+                                                   trit_t *const trits,
+                                                   size_t const num_bytes) {
+  __m256i merge[5][5], u[2], q[2], d[5], out;
+  __m256i const one = _mm256_set1_epi8(1);
+  __m256i const third = _mm256_set1_epi16(171);
+  size_t i = 0;
+
+  for (size_t c = 0; c < 5; c++) {
+    for (size_t k = 0; k < 5; k++) {
+      merge[c][k] = LOAD_256(MERGE_5[c][k]);
+    }
+  }
+
+  for (; i + 32 <= num_bytes; i += 32) {
+    u[0] = avx2_byte_index(_mm256_cvtepi8_epi16(LOAD_128(bytes + i)));
+    u[1] = avx2_byte_index(_mm256_cvtepi8_epi16(LOAD_128(bytes + i + 16)));
+    for (size_t k = 0; k < 5; k++) {
+      for (size_t h = 0; h < 2; h++) {
+        q[h] = _mm256_srli_epi16(_mm256_mullo_epi16(u[h], third), 9);
+        u[h] = _mm256_sub_epi16(
+            u[h], _mm256_add_epi16(q[h], _mm256_add_epi16(q[h], q[h])));
+      }
+      // Packing interleaves the two blocks by 8 bytes, the permutation puts
+      // each of them back in its own lane
+      d[k] = _mm256_sub_epi8(
+          _mm256_permute4x64_epi64(_mm256_packs_epi16(u[0], u[1]), 0xD8), one);
+      u[0] = q[0];
+      u[1] = q[1];
+    }
+    for (size_t c = 0; c < 5; c++) {
+      out = _mm256_shuffle_epi8(d[0], merge[c][0]);
+      for (size_t k = 1; k < 5; k++) {
+        out = _mm256_or_si256(out, _mm256_shuffle_epi8(d[k], merge[c][k]));
+      }
+      avx2_store_2x128(trits + 5 * i + 16 * c, trits + 5 * (i + 16) + 16 * c,
+                       out);
+    }
+  }
+
+  return i;
+}
+
+SIMD_TARGET_AVX2 static size_t trits_to_bytes_avx2(trit_t const *const trits,
+                                                   byte_t *const bytes,
+                                                   size_t const num_bytes) {
+  __m256i split[5][5], in[5], d[5], x;
+  size_t i = 0;
+
+  for (size_t k = 0; k < 5; k++) {
+    for (size_t c = 0; c < 5; c++) {
+      split[k][c] = LOAD_256(SPLIT_5[k][c]);
+    }
+  }
+
+  for (; i + 32 <= num_bytes; i += 32) {
+    for (size_t c = 0; c < 5; c++) {
+      in[c] = LOAD_2x128(trits + 5 * i + 16 * c, trits + 5 * (i + 16) + 16 * c);
+    }
+    for (size_t k = 0; k < 5; k++) {
+      d[k] = _mm256_shuffle_epi8(in[0], split[k][0]);
+      for (size_t c = 1; c < 5; c++) {
+        d[k] = _mm256_or_si256(d[k], _mm256_shuffle_epi8(in[c], split[k][c]));
+      }
+    }
+    x = d[4];
+    for (size_t k = 4; k-- > 0;) {
+      x = avx2_times_3_plus(x, d[k]);
+    }
+    _mm256_storeu_si256((__m256i *)(bytes + i), x);
+  }
+
+  return i;
+}
+
+SIMD_TARGET_AVX2 static size_t trytes_to_trits_avx2(tryte_t const *const trytes,
+                                                    trit_t *const trits,
+                                                    size_t const num_trytes) {
+  __m256i merge[3][3], low[3], high[3], d[3], out;
+  size_t i = 0;
+
+  for (size_t k = 0; k < 3; k++) {
+    for (size_t c = 0; c < 3; c++) {
+      merge[c][k] = LOAD_256(MERGE_3[c][k]);
+    }
+    low[k] = LOAD_256(TRYTE_TRITS_LOW[k]);
+    high[k] = LOAD_256(TRYTE_TRITS_HIGH[k]);
+  }
+
+  for (; i + 32 <= num_trytes; i += 32) {
+    __m256i v = _mm256_loadu_si256((__m256i const *)(trytes + i));
+    __m256i index = _mm256_andnot_si256(
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('9')),
+        _mm256_sub_epi8(v, _mm256_set1_epi8('A' - 1)));
+    __m256i is_high = _mm256_cmpgt_epi8(index, _mm256_set1_epi8(15));
+    __m256i high_index = _mm256_sub_epi8(index, _mm256_set1_epi8(16));
+
+    for (size_t k = 0; k < 3; k++) {
+      d[k] = _mm256_blendv_epi8(_mm256_shuffle_epi8(low[k], index),
+                                _mm256_shuffle_epi8(high[k], high_index),
+                                is_high);
+    }
+    for (size_t c = 0; c < 3; c++) {
+      out = _mm256_shuffle_epi8(d[0], merge[c][0]);
+      for (size_t k = 1; k < 3; k++) {
+        out = _mm256_or_si256(out, _mm256_shuffle_epi8(d[k], merge[c][k]));
+      }
+      avx2_store_2x128(trits + 3 * i + 16 * c, trits + 3 * (i + 16) + 16 * c,
+                       out);
+    }
+  }
+
+  return i;
+}
+
+SIMD_TARGET_AVX2 static size_t trits_to_trytes_avx2(trit_t const *const trits,
+                                                    tryte_t *const trytes,
+                                                    size_t const num_trytes) {
+  __m256i split[3][3], in[3], d[3], x;
+  size_t i = 0;
+
+  for (size_t k = 0; k < 3; k++) {
+    for (size_t c = 0; c < 3; c++) {
+      split[k][c] = LOAD_256(SPLIT_3[k][c]);
+    }
+  }
+
+  for (; i + 32 <= num_trytes; i += 32) {
+    for (size_t c = 0; c < 3; c++) {
+      in[c] = LOAD_2x128(trits + 3 * i + 16 * c, trits + 3 * (i + 16) + 16 * c);
+    }
+    for (size_t k = 0; k < 3; k++) {
+      d[k] = _mm256_shuffle_epi8(in[0], split[k][0]);
+      for (size_t c = 1; c < 3; c++) {
+        d[k] = _mm256_or_si256(d[k], _mm256_shuffle_epi8(in[c], split[k][c]));
+      }
+    }
+    x = avx2_times_3_plus(avx2_times_3_plus(d[2], d[1]), d[0]);
+    x = _mm256_add_epi8(
+        x, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_setzero_si256(), x),
+                            _mm256_set1_epi8(TRYTE_SPACE)));
+    x = _mm256_blendv_epi8(_mm256_add_epi8(x, _mm256_set1_epi8('A' - 1)),
+                           _mm256_set1_epi8('9'),
+                           _mm256_cmpeq_epi8(x, _mm256_setzero_si256()));
+    _mm256_storeu_si256((__m256i *)(trytes + i), x);
+  }
+
+  return i;
+}
+
+#endif  // TRIT_SIMD_X86
+
+/*
+ * Dispatch, AVX2 takes the pairs of blocks and SSE4.1 the one left if any
+ */
+
+size_t trit_simd_bytes_to_trits(byte_t const *const bytes, trit_t *const trits,
+                                size_t const num_bytes) {
+  size_t done = 0;
+
+#ifdef TRIT_SIMD_X86
+  trit_simd_level_t level = trit_simd_level();
+
+  if (level >= TRIT_SIMD_AVX2) {
+    done = bytes_to_trits_avx2(bytes, trits, num_bytes);
+  }
+  if (level >= TRIT_SIMD_SSE4_1) {
+    done += bytes_to_trits_sse4_1(bytes + done, trits + 5 * done,
+                                  num_bytes - done);
+  }
+#endif
+
+  return done;
+}
+
+size_t trit_simd_trits_to_bytes(trit_t const *const trits, byte_t *const bytes,
+                                size_t const num_bytes) {
+  size_t done = 0;
+
+#ifdef TRIT_SIMD_X86
+  trit_simd_level_t level = trit_simd_level();
+
+  if (level >= TRIT_SIMD_AVX2) {
+    done = trits_to_bytes_avx2(trits, bytes, num_bytes);
+  }
+  if (level >= TRIT_SIMD_SSE4_1) {
+    done += trits_to_bytes_sse4_1(trits + 5 * done, bytes + done,
+                                  num_bytes - done);
+  }
+#endif
+
+  return done;
+}
+
+size_t trit_simd_trytes_to_trits(tryte_t const *const trytes,
+                                 trit_t *const trits, size_t const num_trytes) {
+  size_t done = 0;
+
+#ifdef TRIT_SIMD_X86
+  trit_simd_level_t level = trit_simd_level();
+
+  if (level >= TRIT_SIMD_AVX2) {
+    done = trytes_to_trits_avx2(trytes, trits, num_trytes);
+  }
+  if (level >= TRIT_SIMD_SSE4_1) {
+    done += trytes_to_trits_sse4_1(trytes + done, trits + 3 * done,
+                                   num_trytes - done);
+  }
+#endif
+
+  return done;
+}
+
+size_t trit_simd_trits_to_trytes(trit_t const *const trits,
+                                 tryte_t *const trytes,
+                                 size_t const num_trytes) {
+  size_t done = 0;
+
+#ifdef TRIT_SIMD_X86
+  trit_simd_level_t level = trit_simd_level();
+
+  if (level >= TRIT_SIMD_AVX2) {
+    done = trits_to_trytes_avx2(trits, trytes, num_trytes);
+  }
+  if (level >= TRIT_SIMD_SSE4_1) {
+    done += trits_to_trytes_sse4_1(trits + 3 * done, trytes + done,
+                                   num_trytes - done);
+  }
+#endif
+
+  return done;
+}
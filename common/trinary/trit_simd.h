@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_TRINARY_TRIT_SIMD_H_
+#define __COMMON_TRINARY_TRIT_SIMD_H_
+
+#include "common/stdint.h"
+#include "common/trinary/bytes.h"
+#include "common/trinary/trits.h"
+#include "common/trinary/tryte.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Vectorized kernels behind trits_to_bytes, bytes_to_trits, trits_to_trytes
+/// and trytes_to_trits. They only convert whole blocks of 16 or 32 elements
+/// and return how many they converted, the caller finishing the job with its
+/// scalar loop, which is also the reference implementation.
+/// The instruction set is picked at runtime from what the CPU supports, the
+/// kernels are compiled out on other architectures than x86.
+
+typedef enum trit_simd_level_e {
+  TRIT_SIMD_NONE = 0,
+  TRIT_SIMD_SSE4_1,
+  TRIT_SIMD_AVX2,
+} trit_simd_level_t;
+
+/// Returns the instruction set currently used by the kernels
+/// @return trit_simd_level_t - the instruction set
+trit_simd_level_t trit_simd_level(void);
+
+/// Caps the instruction set used by the kernels, e.g. to TRIT_SIMD_NONE to
+/// run the scalar reference implementation
+/// @param[in] level - the widest instruction set allowed
+/// @return trit_simd_level_t - the instruction set now in use, which may be
+/// lower if the CPU doesn't support the requested one
+trit_simd_level_t trit_simd_set_level(trit_simd_level_t const level);
+
+/// Unpacks whole bytes into trits, 5 per byte
+/// @param[in] bytes - An array of bytes
+/// @param[in] trits - An array of at least 5 * num_bytes trits
+/// @param[in] num_bytes - the number of bytes available
+/// @return size_t - the number of bytes unpacked
+size_t trit_simd_bytes_to_trits(byte_t const *const bytes, trit_t *const trits,
+                                size_t const num_bytes);
+
+/// Packs trits into whole bytes, 5 per byte
+/// @param[in] trits - An array of at least 5 * num_bytes trits
+/// @param[in] bytes - An array of bytes
+/// @param[in] num_bytes - the number of bytes to fill
+/// @return size_t - the number of bytes packed
+size_t trit_simd_trits_to_bytes(trit_t const *const trits, byte_t *const bytes,
+                                size_t const num_bytes);
+
+/// Unpacks trytes into trits, 3 per tryte
+/// @param[in] trytes - An array of trytes
+/// @param[in] trits - An array of at least 3 * num_trytes trits
+/// @param[in] num_trytes - the number of trytes available
+/// @return size_t - the number of trytes unpacked
+size_t trit_simd_trytes_to_trits(tryte_t const *const trytes,
+                                 trit_t *const trits, size_t const num_trytes);
+
+/// Packs trits into whole trytes, 3 per tryte
+/// @param[in] trits - An array of at least 3 * num_trytes trits
+/// @param[in] trytes - An array of trytes
+/// @param[in] num_trytes - the number of trytes to fill
+/// @return size_t - the number of trytes packed
+size_t trit_simd_trits_to_trytes(trit_t const *const trits,
+                                 tryte_t *const trytes,
+                                 size_t const num_trytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_TRINARY_TRIT_SIMD_H_
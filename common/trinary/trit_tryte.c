@@ -7,6 +7,7 @@
 
 #include <string.h>
 
+#include "common/trinary/trit_simd.h"
 #include "common/trinary/trit_tryte.h"
 
 static const trit_t TRYTES_TRITS_LUT[TRYTE_SPACE][NUMBER_OF_TRITS_IN_A_TRYTE] =
@@ -57,8 +58,11 @@ uint8_t set_trit_at(tryte_t *const trytes, size_t const length,
 void trits_to_trytes(trit_t const *const trits, tryte_t *const trytes,
                      size_t const length) {
   int k = 0;
+  // Whole trytes go through the vectorized kernels when available
+  size_t j = trit_simd_trits_to_trytes(trits, trytes,
+                                       length / NUMBER_OF_TRITS_IN_A_TRYTE);
 
-  for (size_t i = 0, j = 0; i < length; i += RADIX, j++) {
+  for (size_t i = j * NUMBER_OF_TRITS_IN_A_TRYTE; i < length; i += RADIX, j++) {
     k = 0;
     for (size_t l = length - i < NUMBER_OF_TRITS_IN_A_TRYTE
                         ? length - i
@@ -76,11 +80,16 @@ void trits_to_trytes(trit_t const *const trits, tryte_t *const trytes,
 
 void trytes_to_trits(tryte_t const *const trytes, trit_t *const trits,
                      size_t const length) {
+  size_t i = 0;
+
   if (length == 0) {
     return;
   }
 
-  for (size_t i = 0, j = 0; i < length; i++, j += RADIX) {
+  // Whole trytes go through the vectorized kernels when available
+  i = trit_simd_trytes_to_trits(trytes, trits, length);
+
+  for (size_t j = i * NUMBER_OF_TRITS_IN_A_TRYTE; i < length; i++, j += RADIX) {
     memcpy(trits + j, TRYTES_TRITS_LUT[INDEX_OF_TRYTE(trytes[i])],
            NUMBER_OF_TRITS_IN_A_TRYTE);
   }
@@ -5,17 +5,45 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "uthash.h"
+
 #include "consensus/bundle_validator/bundle_validator.h"
 #include "common/sign/normalize.h"
 #include "common/sign/v1/iss_kerl.h"
 #include "common/trinary/trit_long.h"
 #include "consensus/conf.h"
+#include "utils/handles/lock.h"
 #include "utils/logger_helper.h"
 
 #define BUNDLE_VALIDATOR_LOGGER_ID "bundle_validator"
 
 static logger_id_t logger_id;
 
+typedef struct bundle_cache_entry_s {
+  flex_trit_t tail[FLEX_TRIT_SIZE_243];
+  bundle_status_t status;
+  size_t num_transfers;
+  bundle_transfer_t* transfers;
+  UT_hash_handle hh;
+} bundle_cache_entry_t;
+
+// Validation results are immutable for a given tail, entries are evicted in
+// insertion order once the cache is full
+typedef struct bundle_cache_s {
+  lock_handle_t lock;
+  bundle_cache_entry_t* entries;
+  uint64_t hits;
+  uint64_t misses;
+  bool enabled;
+} bundle_cache_t;
+
+static bundle_cache_t cache;
+
+static UT_icd bundle_transfers_icd = {sizeof(bundle_transfer_t), 0, 0, 0};
+
 /*
  * Private functions
  */
@@ -57,17 +85,170 @@ static retcode_t load_bundle_transactions(tangle_t const* const tangle,
   return res;
 }
 
+static retcode_t load_bundle_transactions_partial(
+    tangle_t const* const tangle, flex_trit_t const* const tail_hash,
+    bundle_transactions_t* const bundle) {
+  retcode_t res = RC_OK;
+  flex_trit_t bundle_hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t curr_hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t input_address[FLEX_TRIT_SIZE_243];
+  bool is_input = false;
+  size_t last_index = 0, curr_index = 0;
+  DECLARE_PACK_SINGLE_TX(curr_tx_s, curr_tx, pack);
+
+  memcpy(curr_hash, tail_hash, FLEX_TRIT_SIZE_243);
+  res = iota_tangle_transaction_load_partial(
+      tangle, curr_hash, &pack, PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA);
+  if (res != RC_OK || pack.num_loaded == 0) {
+    return res;
+  }
+
+  last_index = transaction_last_index(curr_tx);
+  memcpy(bundle_hash, transaction_bundle(curr_tx), FLEX_TRIT_SIZE_243);
+
+  while (pack.num_loaded != 0 && curr_index <= last_index &&
+         memcmp(bundle_hash, transaction_bundle(curr_tx), FLEX_TRIT_SIZE_243) ==
+             0) {
+    transaction_set_hash(curr_tx, curr_hash);
+
+    // Signature fragments are carried by the input transaction and the
+    // zero-value transactions that follow it with the same address
+    if (transaction_value(curr_tx) < 0) {
+      memcpy(input_address, transaction_address(curr_tx), FLEX_TRIT_SIZE_243);
+      is_input = true;
+    } else if (is_input && (transaction_value(curr_tx) != 0 ||
+                            memcmp(input_address, transaction_address(curr_tx),
+                                   FLEX_TRIT_SIZE_243) != 0)) {
+      is_input = false;
+    }
+    if (is_input) {
+      hash_pack_reset(&pack);
+      if ((res = iota_tangle_transaction_load_partial(
+               tangle, curr_hash, &pack, PARTIAL_TX_MODEL_SIGNATURE)) !=
+          RC_OK) {
+        return res;
+      }
+    }
+
+    bundle_transactions_add(bundle, curr_tx);
+    memcpy(curr_hash, transaction_trunk(curr_tx), FLEX_TRIT_SIZE_243);
+
+    hash_pack_reset(&pack);
+    if ((res = iota_tangle_transaction_load_partial(
+             tangle, curr_hash, &pack,
+             PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA)) != RC_OK) {
+      return res;
+    }
+    curr_index++;
+  }
+
+  return res;
+}
+
+static void bundle_cache_clear() {
+  bundle_cache_entry_t *entry = NULL, *tmp = NULL;
+
+  HASH_ITER(hh, cache.entries, entry, tmp) {
+    HASH_DEL(cache.entries, entry);
+    free(entry->transfers);
+    free(entry);
+  }
+}
+
+static bool bundle_cache_get(flex_trit_t const* const tail_hash,
+                             bundle_transfers_t* const transfers,
+                             bundle_status_t* const status) {
+  bundle_cache_entry_t* entry = NULL;
+
+  if (!cache.enabled) {
+    return false;
+  }
+
+  lock_handle_lock(&cache.lock);
+  HASH_FIND(hh, cache.entries, tail_hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry) {
+    cache.hits++;
+    *status = entry->status;
+    for (size_t i = 0; transfers && i < entry->num_transfers; i++) {
+      utarray_push_back(transfers, &entry->transfers[i]);
+    }
+  } else {
+    cache.misses++;
+  }
+  lock_handle_unlock(&cache.lock);
+
+  return entry != NULL;
+}
+
+/**
+ * Takes ownership of the transfers array
+ */
+static void bundle_cache_add(flex_trit_t const* const tail_hash,
+                             bundle_status_t const status,
+                             bundle_transfer_t* const transfers,
+                             size_t const num_transfers) {
+  bundle_cache_entry_t* entry = NULL;
+
+  // Missing transactions may still arrive, only definitive results are cached
+  if (!cache.enabled ||
+      (status != BUNDLE_VALID && status < BUNDLE_INVALID_TX) ||
+      (entry = (bundle_cache_entry_t*)malloc(sizeof(bundle_cache_entry_t))) ==
+          NULL) {
+    free(transfers);
+    return;
+  }
+  memcpy(entry->tail, tail_hash, FLEX_TRIT_SIZE_243);
+  entry->status = status;
+  entry->transfers = transfers;
+  entry->num_transfers = num_transfers;
+
+  lock_handle_lock(&cache.lock);
+  if (HASH_COUNT(cache.entries) >= BUNDLE_VALIDATOR_CACHE_MAX_SIZE) {
+    bundle_cache_entry_t* oldest = cache.entries;
+    HASH_DEL(cache.entries, oldest);
+    free(oldest->transfers);
+    free(oldest);
+  }
+  HASH_ADD(hh, cache.entries, tail, FLEX_TRIT_SIZE_243, entry);
+  lock_handle_unlock(&cache.lock);
+}
+
 /*
  * Public functions
  */
 
+void bundle_transfers_new(bundle_transfers_t** const transfers) {
+  utarray_new(*transfers, &bundle_transfers_icd);
+}
+
+void bundle_transfers_free(bundle_transfers_t** const transfers) {
+  if (transfers && *transfers) {
+    utarray_free(*transfers);
+  }
+  *transfers = NULL;
+}
+
 retcode_t iota_consensus_bundle_validator_init() {
   logger_id =
       logger_helper_enable(BUNDLE_VALIDATOR_LOGGER_ID, LOGGER_DEBUG, true);
+  lock_handle_init(&cache.lock);
+  cache.entries = NULL;
+  cache.hits = 0;
+  cache.misses = 0;
+  cache.enabled = true;
   return RC_OK;
 }
 
 retcode_t iota_consensus_bundle_validator_destroy() {
+  if (cache.enabled) {
+    log_debug(logger_id,
+              "Bundle validation cache: %" PRIu64 " hits, %" PRIu64
+              " misses\n",
+              cache.hits, cache.misses);
+    cache.enabled = false;
+    bundle_cache_clear();
+    lock_handle_destroy(&cache.lock);
+  }
   logger_helper_release(logger_id);
   return RC_OK;
 }
@@ -91,3 +272,69 @@ retcode_t iota_consensus_bundle_validator_validate(
   }
   return bundle_validator(bundle, status);
 }
+
+retcode_t iota_consensus_bundle_validator_validate_transfers(
+    tangle_t const* const tangle, flex_trit_t const* const tail_hash,
+    bundle_transfers_t* const transfers, bundle_status_t* const status) {
+  retcode_t res = RC_OK;
+  bundle_transactions_t* bundle = NULL;
+  iota_transaction_t* tx = NULL;
+  bundle_transfer_t* bundle_transfers = NULL;
+  size_t num_transfers = 0;
+
+  if (bundle_cache_get(tail_hash, transfers, status)) {
+    return RC_OK;
+  }
+
+  bundle_transactions_new(&bundle);
+  if ((res = load_bundle_transactions_partial(tangle, tail_hash, bundle)) !=
+          RC_OK ||
+      utarray_len(bundle) == 0) {
+    *status = BUNDLE_TAIL_NOT_FOUND;
+    goto done;
+  }
+  if ((res = bundle_validator(bundle, status)) != RC_OK) {
+    goto done;
+  }
+
+  if (*status == BUNDLE_VALID) {
+    if ((bundle_transfers = (bundle_transfer_t*)malloc(
+             utarray_len(bundle) * sizeof(bundle_transfer_t))) == NULL) {
+      res = RC_OOM;
+      goto done;
+    }
+    BUNDLE_FOREACH(bundle, tx) {
+      if (transaction_value(tx) != 0) {
+        memcpy(bundle_transfers[num_transfers].address,
+               transaction_address(tx), FLEX_TRIT_SIZE_243);
+        bundle_transfers[num_transfers].value = transaction_value(tx);
+        if (transfers) {
+          utarray_push_back(transfers, &bundle_transfers[num_transfers]);
+        }
+        num_transfers++;
+      }
+    }
+  }
+  bundle_cache_add(tail_hash, *status, bundle_transfers, num_transfers);
+
+done:
+  bundle_transactions_free(&bundle);
+  return res;
+}
+
+void iota_consensus_bundle_validator_cache_stats(
+    bundle_validator_cache_stats_t* const stats) {
+  stats->hits = 0;
+  stats->misses = 0;
+  stats->size = 0;
+
+  if (!cache.enabled) {
+    return;
+  }
+
+  lock_handle_lock(&cache.lock);
+  stats->hits = cache.hits;
+  stats->misses = cache.misses;
+  stats->size = HASH_COUNT(cache.entries);
+  lock_handle_unlock(&cache.lock);
+}
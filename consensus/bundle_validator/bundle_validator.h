@@ -13,16 +13,59 @@
 #include "common/trinary/trit_array.h"
 #include "consensus/tangle/tangle.h"
 
+#define BUNDLE_VALIDATOR_CACHE_MAX_SIZE 50000
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+typedef struct bundle_transfer_s {
+  flex_trit_t address[FLEX_TRIT_SIZE_243];
+  int64_t value;
+} bundle_transfer_t;
+
+typedef UT_array bundle_transfers_t;
+
+typedef struct bundle_validator_cache_stats_s {
+  uint64_t hits;
+  uint64_t misses;
+  size_t size;
+} bundle_validator_cache_stats_t;
+
+void bundle_transfers_new(bundle_transfers_t** const transfers);
+void bundle_transfers_free(bundle_transfers_t** const transfers);
+
 retcode_t iota_consensus_bundle_validator_init();
 retcode_t iota_consensus_bundle_validator_destroy();
 retcode_t iota_consensus_bundle_validator_validate(
     tangle_t const* const tangle, flex_trit_t* const tail_hash,
     bundle_transactions_t* const bundle, bundle_status_t* const status);
 
+/**
+ * Validates a bundle and gets its value transfers, i.e. the address and value
+ * of every transaction with a non-zero value, in bundle order. Results are
+ * cached by tail hash and signatures are only loaded for input transactions.
+ *
+ * @param tangle A tangle
+ * @param tail_hash The bundle tail hash
+ * @param transfers The value transfers of the bundle if it is valid, can be
+ * NULL
+ * @param status The bundle status
+ *
+ * @return a status code
+ */
+retcode_t iota_consensus_bundle_validator_validate_transfers(
+    tangle_t const* const tangle, flex_trit_t const* const tail_hash,
+    bundle_transfers_t* const transfers, bundle_status_t* const status);
+
+/**
+ * Gets the hits, misses and size of the bundle validation cache
+ *
+ * @param stats The cache statistics
+ */
+void iota_consensus_bundle_validator_cache_stats(
+    bundle_validator_cache_stats_t* const stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -202,6 +202,88 @@ void test_iota_consensus_bundle_validator_validate_size_4_value_valid() {
   transactions_free(txs, 4);
 }
 
+void test_iota_consensus_bundle_validator_validate_transfers_valid() {
+  bundle_transfers_t *transfers = NULL;
+  bundle_transfer_t *transfer = NULL;
+  bundle_status_t bundle_status = BUNDLE_NOT_INITIALIZED;
+  bundle_validator_cache_stats_t stats;
+  iota_transaction_t *txs[4];
+  int64_t values[3];
+  size_t i = 0;
+
+  tryte_t const *const trytes[4] = {
+      TX_1_OF_4_VALUE_BUNDLE_TRYTES, TX_2_OF_4_VALUE_BUNDLE_TRYTES,
+      TX_3_OF_4_VALUE_BUNDLE_TRYTES, TX_4_OF_4_VALUE_BUNDLE_TRYTES};
+
+  transactions_deserialize(trytes, txs, 4, true);
+  TEST_ASSERT(build_tangle(&tangle, txs, 4) == RC_OK);
+
+  // The second validation is served from the cache
+  for (size_t run = 0; run < 2; run++) {
+    bundle_transfers_new(&transfers);
+    TEST_ASSERT(iota_consensus_bundle_validator_validate_transfers(
+                    &tangle, transaction_hash(txs[0]), transfers,
+                    &bundle_status) == RC_OK);
+    TEST_ASSERT(bundle_status == BUNDLE_VALID);
+    TEST_ASSERT_EQUAL_INT(3, utarray_len(transfers));
+    i = 0;
+    for (transfer = (bundle_transfer_t *)utarray_front(transfers);
+         transfer != NULL;
+         transfer = (bundle_transfer_t *)utarray_next(transfers, transfer)) {
+      values[i++] = transfer->value;
+    }
+    TEST_ASSERT_EQUAL_INT64(transaction_value(txs[0]), values[0]);
+    TEST_ASSERT_EQUAL_INT64(transaction_value(txs[1]), values[1]);
+    TEST_ASSERT_EQUAL_INT64(transaction_value(txs[3]), values[2]);
+    bundle_transfers_free(&transfers);
+  }
+
+  iota_consensus_bundle_validator_cache_stats(&stats);
+  TEST_ASSERT_EQUAL_INT(1, stats.hits);
+  TEST_ASSERT_EQUAL_INT(1, stats.misses);
+  TEST_ASSERT_EQUAL_INT(1, stats.size);
+
+  transactions_free(txs, 4);
+}
+
+void test_iota_consensus_bundle_validator_validate_transfers_wrong_sig_invalid() {
+  iota_transaction_t *txs[4];
+  trit_t buffer[NUM_TRITS_PER_FLEX_TRIT];
+  bundle_status_t bundle_status = BUNDLE_NOT_INITIALIZED;
+  bundle_validator_cache_stats_t stats;
+  tryte_t const *const trytes[4] = {
+      TX_1_OF_4_VALUE_BUNDLE_TRYTES, TX_2_OF_4_VALUE_BUNDLE_TRYTES,
+      TX_3_OF_4_VALUE_BUNDLE_TRYTES, TX_4_OF_4_VALUE_BUNDLE_TRYTES};
+
+  transactions_deserialize(trytes, txs, 4, true);
+
+  // Alters the last signature fragment of the input
+  flex_trits_to_trits(buffer, NUM_TRITS_PER_FLEX_TRIT,
+                      transaction_signature(txs[2]), NUM_TRITS_PER_FLEX_TRIT,
+                      NUM_TRITS_PER_FLEX_TRIT);
+  buffer[NUM_TRITS_PER_FLEX_TRIT - 1] = !buffer[NUM_TRITS_PER_FLEX_TRIT - 1];
+  flex_trits_from_trits(transaction_signature(txs[2]), NUM_TRITS_PER_FLEX_TRIT,
+                        buffer, NUM_TRITS_PER_FLEX_TRIT,
+                        NUM_TRITS_PER_FLEX_TRIT);
+
+  TEST_ASSERT(build_tangle(&tangle, txs, 4) == RC_OK);
+
+  TEST_ASSERT(iota_consensus_bundle_validator_validate_transfers(
+                  &tangle, transaction_hash(txs[0]), NULL, &bundle_status) ==
+              RC_OK);
+  TEST_ASSERT(bundle_status == BUNDLE_INVALID_SIGNATURE);
+  TEST_ASSERT(iota_consensus_bundle_validator_validate_transfers(
+                  &tangle, transaction_hash(txs[0]), NULL, &bundle_status) ==
+              RC_OK);
+  TEST_ASSERT(bundle_status == BUNDLE_INVALID_SIGNATURE);
+
+  iota_consensus_bundle_validator_cache_stats(&stats);
+  TEST_ASSERT_EQUAL_INT(1, stats.hits);
+  TEST_ASSERT_EQUAL_INT(1, stats.misses);
+
+  transactions_free(txs, 4);
+}
+
 int main(int argc, char *argv[]) {
   UNITY_BEGIN();
   TEST_ASSERT(storage_init() == RC_OK);
@@ -223,6 +305,9 @@ int main(int argc, char *argv[]) {
   RUN_TEST(
       test_iota_consensus_bundle_validator_validate_size_4_value_wrong_sig_invalid);
   RUN_TEST(test_iota_consensus_bundle_validator_validate_size_4_value_valid);
+  RUN_TEST(test_iota_consensus_bundle_validator_validate_transfers_valid);
+  RUN_TEST(
+      test_iota_consensus_bundle_validator_validate_transfers_wrong_sig_invalid);
 
   TEST_ASSERT(storage_destroy() == RC_OK);
   return UNITY_END();
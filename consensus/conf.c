@@ -148,6 +148,11 @@ retcode_t iota_consensus_conf_init(iota_consensus_conf_t *const conf) {
   strcpy(conf->snapshot_file, DEFAULT_SNAPSHOT_FILE);
   conf->num_keys_in_milestone = DEFAULT_NUM_KEYS_IN_MILESTONE;
   conf->mwm = DEFAULT_MWN;
+  conf->ledger_checkpoint_interval = DEFAULT_LEDGER_CHECKPOINT_INTERVAL;
+  conf->local_snapshots_enabled = DEFAULT_LOCAL_SNAPSHOTS_ENABLED;
+  conf->local_snapshots_depth = DEFAULT_LOCAL_SNAPSHOTS_DEPTH;
+  conf->local_snapshots_interval = DEFAULT_LOCAL_SNAPSHOTS_INTERVAL;
+  strcpy(conf->local_snapshots_path, DEFAULT_LOCAL_SNAPSHOTS_PATH);
 
   ret = iota_snapshot_conf_init(conf);
 
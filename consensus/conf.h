@@ -8,6 +8,8 @@
 #ifndef __CONSENSUS_CONF_H__
 #define __CONSENSUS_CONF_H__
 
+#include <stdbool.h>
+
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
 
@@ -23,6 +25,11 @@
 #define DEFAULT_SNAPSHOT_FILE SNAPSHOT_FILE
 #define DEFAULT_NUM_KEYS_IN_MILESTONE NUM_KEYS_IN_MILESTONE
 #define DEFAULT_MWN MWM
+#define DEFAULT_LEDGER_CHECKPOINT_INTERVAL 1000
+#define DEFAULT_LOCAL_SNAPSHOTS_ENABLED false
+#define DEFAULT_LOCAL_SNAPSHOTS_DEPTH 100
+#define DEFAULT_LOCAL_SNAPSHOTS_INTERVAL 10
+#define DEFAULT_LOCAL_SNAPSHOTS_PATH "ciri/db/local_snapshot.txt"
 
 #ifdef __cplusplus
 extern "C" {
@@ -48,7 +55,9 @@ typedef struct iota_consensus_conf_s {
   char snapshot_signature_file[128];
   // Path to the file that contains the state of the ledger at the last snapshot
   char snapshot_file[128];
-  // Epoch time of the last snapshot
+  // Epoch time of the last snapshot, moved forward by the local snapshots
+  // manager while transactions are validated so it is accessed atomically
+  // once the node is running
   uint64_t snapshot_timestamp_sec;
   // Index of the snapshot signature
   uint64_t snapshot_signature_index;
@@ -69,6 +78,18 @@ typedef struct iota_consensus_conf_s {
   uint8_t mwm;
   // Path of the DB file
   char db_path[128];
+  // Number of new solid milestones between two checkpoints of the ledger
+  // state, 0 disables checkpoints
+  size_t ledger_checkpoint_interval;
+  // Whether local snapshots are taken and transactions they confirm pruned
+  bool local_snapshots_enabled;
+  // Number of milestones kept below the latest solid milestone when taking a
+  // local snapshot
+  size_t local_snapshots_depth;
+  // Number of new solid milestones between two local snapshots
+  size_t local_snapshots_interval;
+  // Path of the local snapshot file, loaded at startup when it exists
+  char local_snapshots_path[128];
 } iota_consensus_conf_t;
 
 /**
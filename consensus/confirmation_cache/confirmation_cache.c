@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include "consensus/confirmation_cache/confirmation_cache.h"
+
+/*
+ * Private functions
+ */
+
+static void confirmation_cache_evict(confirmation_cache_t *const cache) {
+  hash_to_int64_t_map_entry_t *iter = NULL, *tmp = NULL;
+
+  if (cache->latest_index <= cache->depth) {
+    return;
+  }
+
+  HASH_ITER(hh, cache->confirmed, iter, tmp) {
+    if ((uint64_t)iter->value + cache->depth <= cache->latest_index) {
+      hash_to_int64_t_map_remove_entry(&cache->confirmed, iter);
+    }
+  }
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t iota_confirmation_cache_init(confirmation_cache_t *const cache,
+                                       size_t const depth) {
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_init(&cache->rw_lock);
+  cache->confirmed = NULL;
+  cache->latest_index = 0;
+  cache->depth = depth;
+
+  return RC_OK;
+}
+
+retcode_t iota_confirmation_cache_destroy(confirmation_cache_t *const cache) {
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  hash_to_int64_t_map_free(&cache->confirmed);
+  rw_lock_handle_destroy(&cache->rw_lock);
+
+  return RC_OK;
+}
+
+retcode_t iota_confirmation_cache_add(confirmation_cache_t *const cache,
+                                      hash243_set_t const hashes,
+                                      uint64_t const index) {
+  retcode_t ret = RC_OK;
+  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_wrlock(&cache->rw_lock);
+
+  if (index + cache->depth > cache->latest_index) {
+    HASH_ITER(hh, hashes, iter, tmp) {
+      if (!hash_to_int64_t_map_contains(&cache->confirmed, iter->hash) &&
+          (ret = hash_to_int64_t_map_add(&cache->confirmed, iter->hash,
+                                         index)) != RC_OK) {
+        break;
+      }
+    }
+  }
+
+  if (index > cache->latest_index) {
+    cache->latest_index = index;
+    confirmation_cache_evict(cache);
+  }
+
+  rw_lock_handle_unlock(&cache->rw_lock);
+
+  return ret;
+}
+
+uint64_t iota_confirmation_cache_get(confirmation_cache_t *const cache,
+                                     flex_trit_t const *const hash) {
+  hash_to_int64_t_map_entry_t *entry = NULL;
+  uint64_t index = 0;
+
+  rw_lock_handle_rdlock(&cache->rw_lock);
+  if (hash_to_int64_t_map_find(&cache->confirmed, hash, &entry)) {
+    index = entry->value;
+  }
+  rw_lock_handle_unlock(&cache->rw_lock);
+
+  return index;
+}
+
+size_t iota_confirmation_cache_size(confirmation_cache_t *const cache) {
+  size_t size = 0;
+
+  rw_lock_handle_rdlock(&cache->rw_lock);
+  size = HASH_COUNT(cache->confirmed);
+  rw_lock_handle_unlock(&cache->rw_lock);
+
+  return size;
+}
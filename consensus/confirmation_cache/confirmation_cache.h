@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_CONFIRMATION_CACHE_CONFIRMATION_CACHE_H__
+#define __CONSENSUS_CONFIRMATION_CACHE_CONFIRMATION_CACHE_H__
+
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/containers/hash/hash243_set.h"
+#include "utils/containers/hash/hash_int64_t_map.h"
+#include "utils/handles/rw_lock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * In-memory mirror of the snapshot index of the transactions confirmed by the
+ * latest milestones. Entries confirmed more than `depth` milestones before the
+ * latest one are evicted.
+ */
+typedef struct confirmation_cache_s {
+  rw_lock_handle_t rw_lock;
+  hash_to_int64_t_map_t confirmed;
+  uint64_t latest_index;
+  size_t depth;
+} confirmation_cache_t;
+
+/**
+ * Initializes a confirmation cache
+ *
+ * @param cache The confirmation cache
+ * @param depth Number of milestones to keep confirmed transactions for
+ *
+ * @return a status code
+ */
+retcode_t iota_confirmation_cache_init(confirmation_cache_t *const cache,
+                                       size_t const depth);
+
+/**
+ * Destroys a confirmation cache
+ *
+ * @param cache The confirmation cache
+ *
+ * @return a status code
+ */
+retcode_t iota_confirmation_cache_destroy(confirmation_cache_t *const cache);
+
+/**
+ * Adds transactions confirmed by a milestone and evicts the ones confirmed by
+ * milestones that fell out of the cache depth
+ *
+ * @param cache The confirmation cache
+ * @param hashes Hashes of the confirmed transactions
+ * @param index Index of the confirming milestone
+ *
+ * @return a status code
+ */
+retcode_t iota_confirmation_cache_add(confirmation_cache_t *const cache,
+                                      hash243_set_t const hashes,
+                                      uint64_t const index);
+
+/**
+ * Gets the index of the milestone that confirmed a transaction
+ *
+ * @param cache The confirmation cache
+ * @param hash The transaction hash
+ *
+ * @return the milestone index or 0 if the transaction is not in the cache
+ */
+uint64_t iota_confirmation_cache_get(confirmation_cache_t *const cache,
+                                     flex_trit_t const *const hash);
+
+/**
+ * Gets the number of transactions in a confirmation cache
+ *
+ * @param cache The confirmation cache
+ *
+ * @return the number of transactions
+ */
+size_t iota_confirmation_cache_size(confirmation_cache_t *const cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_CONFIRMATION_CACHE_CONFIRMATION_CACHE_H__
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "common/helpers/digest.h"
+#include "consensus/confirmation_cache/confirmation_cache.h"
+
+#define DEPTH 3
+#define NUM_MILESTONES 10
+#define NUM_HASHES_PER_MILESTONE 10
+
+static confirmation_cache_t cache;
+static flex_trit_t hashes[NUM_MILESTONES][NUM_HASHES_PER_MILESTONE]
+                         [FLEX_TRIT_SIZE_243];
+
+void setUp(void) {
+  TEST_ASSERT(iota_confirmation_cache_init(&cache, DEPTH) == RC_OK);
+}
+
+void tearDown(void) {
+  TEST_ASSERT(iota_confirmation_cache_destroy(&cache) == RC_OK);
+}
+
+static void hashes_init() {
+  trit_t trits[HASH_LENGTH_TRIT] = {1};
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t *hashed_hash = NULL;
+
+  flex_trits_from_trits(hash, HASH_LENGTH_TRIT, trits, HASH_LENGTH_TRIT,
+                        HASH_LENGTH_TRIT);
+  for (size_t i = 0; i < NUM_MILESTONES; i++) {
+    for (size_t j = 0; j < NUM_HASHES_PER_MILESTONE; j++) {
+      hashed_hash = iota_flex_digest(hash, HASH_LENGTH_TRIT);
+      memcpy(hash, hashed_hash, FLEX_TRIT_SIZE_243);
+      memcpy(hashes[i][j], hashed_hash, FLEX_TRIT_SIZE_243);
+      free(hashed_hash);
+    }
+  }
+}
+
+static void add_milestone(size_t const index) {
+  hash243_set_t set = NULL;
+
+  for (size_t j = 0; j < NUM_HASHES_PER_MILESTONE; j++) {
+    TEST_ASSERT(hash243_set_add(&set, hashes[index - 1][j]) == RC_OK);
+  }
+  TEST_ASSERT(iota_confirmation_cache_add(&cache, set, index) == RC_OK);
+  hash243_set_free(&set);
+}
+
+void test_confirmation_cache_empty(void) {
+  TEST_ASSERT_EQUAL_INT(iota_confirmation_cache_size(&cache), 0);
+  TEST_ASSERT_EQUAL_INT(iota_confirmation_cache_get(&cache, hashes[0][0]), 0);
+}
+
+void test_confirmation_cache_add_and_get(void) {
+  for (size_t i = 1; i <= DEPTH; i++) {
+    add_milestone(i);
+  }
+
+  TEST_ASSERT_EQUAL_INT(iota_confirmation_cache_size(&cache),
+                        DEPTH * NUM_HASHES_PER_MILESTONE);
+  for (size_t i = 1; i <= DEPTH; i++) {
+    for (size_t j = 0; j < NUM_HASHES_PER_MILESTONE; j++) {
+      TEST_ASSERT_EQUAL_INT(
+          iota_confirmation_cache_get(&cache, hashes[i - 1][j]), i);
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(iota_confirmation_cache_get(&cache, hashes[DEPTH][0]),
+                        0);
+}
+
+void test_confirmation_cache_eviction(void) {
+  for (size_t i = 1; i <= NUM_MILESTONES; i++) {
+    add_milestone(i);
+    TEST_ASSERT(iota_confirmation_cache_size(&cache) <=
+                DEPTH * NUM_HASHES_PER_MILESTONE);
+  }
+
+  for (size_t i = 1; i <= NUM_MILESTONES; i++) {
+    for (size_t j = 0; j < NUM_HASHES_PER_MILESTONE; j++) {
+      TEST_ASSERT_EQUAL_INT(
+          iota_confirmation_cache_get(&cache, hashes[i - 1][j]),
+          i + DEPTH > NUM_MILESTONES ? i : 0);
+    }
+  }
+
+  // Milestones older than the cache depth are ignored
+  add_milestone(1);
+  TEST_ASSERT_EQUAL_INT(iota_confirmation_cache_get(&cache, hashes[0][0]), 0);
+  TEST_ASSERT_EQUAL_INT(iota_confirmation_cache_size(&cache),
+                        DEPTH * NUM_HASHES_PER_MILESTONE);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  hashes_init();
+
+  RUN_TEST(test_confirmation_cache_empty);
+  RUN_TEST(test_confirmation_cache_add_and_get);
+  RUN_TEST(test_confirmation_cache_eviction);
+
+  return UNITY_END();
+}
@@ -70,6 +70,13 @@ retcode_t iota_consensus_init(
     return ret;
   }
 
+  log_info(logger_id, "Initializing spent addresses provider\n");
+  if ((ret = iota_spent_addresses_provider_init(
+           &consensus->spent_addresses_provider, tangle)) != RC_OK) {
+    log_critical(logger_id, "Initializing spent addresses provider failed\n");
+    return ret;
+  }
+
   log_info(logger_id, "Initializing transaction solidifier\n");
   if ((ret = iota_consensus_transaction_solidifier_init(
            &consensus->transaction_solidifier, &consensus->conf,
@@ -87,6 +94,23 @@ retcode_t iota_consensus_init(
     return ret;
   }
 
+  log_info(logger_id, "Initializing local snapshots manager\n");
+  if ((ret = iota_local_snapshots_manager_init(
+           &consensus->local_snapshots_manager, &consensus->conf,
+           &consensus->milestone_tracker)) != RC_OK) {
+    log_critical(logger_id, "Initializing local snapshots manager failed\n");
+    return ret;
+  }
+
+  log_info(logger_id, "Initializing ledger checkpointer\n");
+  if ((ret = iota_ledger_checkpointer_init(&consensus->ledger_checkpointer,
+                                           &consensus->conf,
+                                           &consensus->milestone_tracker)) !=
+      RC_OK) {
+    log_critical(logger_id, "Initializing ledger checkpointer failed\n");
+    return ret;
+  }
+
   log_info(logger_id, "Initializing tip selector\n");
   if ((ret = iota_consensus_tip_selector_init(
            &consensus->tip_selector, &consensus->conf,
@@ -109,7 +133,8 @@ retcode_t iota_consensus_init(
   log_info(logger_id, "Initializing ledger validator\n");
   if ((ret = iota_consensus_ledger_validator_init(
            &consensus->ledger_validator, tangle, &consensus->conf,
-           &consensus->milestone_tracker)) != RC_OK) {
+           &consensus->milestone_tracker,
+           &consensus->spent_addresses_provider)) != RC_OK) {
     log_critical(logger_id, "Initializing ledger validator failed\n");
     return ret;
   }
@@ -118,12 +143,13 @@ retcode_t iota_consensus_init(
 }
 
 retcode_t iota_consensus_start(iota_consensus_t *const consensus,
-                               tangle_t *const tangle) {
+                               tangle_t *const tangle,
+                               executor_t *const executor) {
   retcode_t ret = RC_OK;
 
   log_info(logger_id, "Starting milestone tracker\n");
   if ((ret = iota_milestone_tracker_start(&consensus->milestone_tracker,
-                                          tangle)) != RC_OK) {
+                                          tangle, executor)) != RC_OK) {
     log_critical(logger_id, "Starting milestone tracker failed\n");
     return ret;
   }
@@ -135,18 +161,45 @@ retcode_t iota_consensus_start(iota_consensus_t *const consensus,
     return ret;
   }
 
+  log_info(logger_id, "Starting local snapshots manager\n");
+  if ((ret = iota_local_snapshots_manager_start(
+           &consensus->local_snapshots_manager)) != RC_OK) {
+    log_critical(logger_id, "Starting local snapshots manager failed\n");
+    return ret;
+  }
+
+  log_info(logger_id, "Starting ledger checkpointer\n");
+  if ((ret = iota_ledger_checkpointer_start(&consensus->ledger_checkpointer)) !=
+      RC_OK) {
+    log_critical(logger_id, "Starting ledger checkpointer failed\n");
+    return ret;
+  }
+
   return ret;
 }
 
 retcode_t iota_consensus_stop(iota_consensus_t *const consensus) {
   retcode_t ret = RC_OK;
 
+  log_info(logger_id, "Stopping local snapshots manager\n");
+  if ((ret = iota_local_snapshots_manager_stop(
+           &consensus->local_snapshots_manager)) != RC_OK) {
+    log_critical(logger_id, "Stopping local snapshots manager failed\n");
+  }
+
   log_info(logger_id, "Stopping milestone tracker\n");
   if ((ret = iota_milestone_tracker_stop(&consensus->milestone_tracker)) !=
       RC_OK) {
     log_critical(logger_id, "Stopping milestone tracker failed\n");
   }
 
+  // Stopped after the milestone tracker so that its last checkpoint is final
+  log_info(logger_id, "Stopping ledger checkpointer\n");
+  if ((ret = iota_ledger_checkpointer_stop(&consensus->ledger_checkpointer)) !=
+      RC_OK) {
+    log_critical(logger_id, "Stopping ledger checkpointer failed\n");
+  }
+
   log_info(logger_id, "Stopping transaction solidifier\n");
   if ((ret = iota_consensus_transaction_solidifier_stop(
            &consensus->transaction_solidifier)) != RC_OK) {
@@ -196,6 +249,18 @@ retcode_t iota_consensus_destroy(iota_consensus_t *const consensus) {
     log_error(logger_id, "Destroying ledger validator failed\n");
   }
 
+  log_info(logger_id, "Destroying ledger checkpointer\n");
+  if ((ret = iota_ledger_checkpointer_destroy(
+           &consensus->ledger_checkpointer)) != RC_OK) {
+    log_error(logger_id, "Destroying ledger checkpointer failed\n");
+  }
+
+  log_info(logger_id, "Destroying local snapshots manager\n");
+  if ((ret = iota_local_snapshots_manager_destroy(
+           &consensus->local_snapshots_manager)) != RC_OK) {
+    log_error(logger_id, "Destroying local snapshots manager failed\n");
+  }
+
   log_info(logger_id, "Destroying milestone tracker\n");
   if ((ret = iota_milestone_tracker_destroy(&consensus->milestone_tracker)) !=
       RC_OK) {
@@ -213,6 +278,12 @@ retcode_t iota_consensus_destroy(iota_consensus_t *const consensus) {
     log_error(logger_id, "Destroying snapshot failed\n");
   }
 
+  log_info(logger_id, "Destroying spent addresses provider\n");
+  if ((ret = iota_spent_addresses_provider_destroy(
+           &consensus->spent_addresses_provider)) != RC_OK) {
+    log_error(logger_id, "Destroying spent addresses provider failed\n");
+  }
+
   log_info(logger_id, "Destroying tip selector\n");
   if ((ret = iota_consensus_tip_selector_destroy(&consensus->tip_selector))) {
     log_error(logger_id, "Destroying tip selector failed\n");
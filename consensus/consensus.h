@@ -16,11 +16,15 @@
 #include "consensus/exit_probability_randomizer/exit_probability_randomizer.h"
 #include "consensus/exit_probability_validator/exit_probability_validator.h"
 #include "consensus/ledger_validator/ledger_validator.h"
+#include "consensus/ledger_checkpointer/ledger_checkpointer.h"
+#include "consensus/local_snapshots/local_snapshots_manager.h"
 #include "consensus/milestone_tracker/milestone_tracker.h"
 #include "consensus/snapshot/snapshot.h"
+#include "consensus/spent_addresses_provider/spent_addresses_provider.h"
 #include "consensus/tip_selector/tip_selector.h"
 #include "consensus/transaction_solidifier/transaction_solidifier.h"
 #include "consensus/transaction_validator/transaction_validator.h"
+#include "utils/handles/executor.h"
 
 typedef struct iota_consensus_s {
   iota_consensus_conf_t conf;
@@ -29,8 +33,11 @@ typedef struct iota_consensus_s {
   ep_randomizer_t ep_randomizer;
   exit_prob_transaction_validator_t exit_prob_transaction_validator;
   ledger_validator_t ledger_validator;
+  local_snapshots_manager_t local_snapshots_manager;
+  ledger_checkpointer_t ledger_checkpointer;
   milestone_tracker_t milestone_tracker;
   snapshot_t snapshot;
+  spent_addresses_provider_t spent_addresses_provider;
   tip_selector_t tip_selector;
   transaction_validator_t transaction_validator;
   transaction_solidifier_t transaction_solidifier;
@@ -60,11 +67,13 @@ retcode_t iota_consensus_init(
  *
  * @param consensus The consensus
  * @param tangle A tangle
+ * @param executor The executor running the consensus tasks
  *
  * @return a status code
  */
 retcode_t iota_consensus_start(iota_consensus_t* const consensus,
-                               tangle_t* const tangle);
+                               tangle_t* const tangle,
+                               executor_t* const executor);
 
 /**
  * Stops all consensus components
@@ -109,15 +109,11 @@ static retcode_t cw_rating_dfs_do_dfs_from_db(
     flex_trit_t *entry_point, hash_to_indexed_hash_set_map_t *tx_to_approvers,
     uint64_t *subtangle_size, int64_t subtangle_before_timestamp) {
   hash_to_indexed_hash_set_entry_t *curr_tx = NULL;
-  size_t curr_approver_index;
   retcode_t res = RC_OK;
-  iota_stor_pack_t pack;
+  iota_stor_cursor_t cursor = {.handle = NULL};
+  flex_trit_t const *approver_hash = NULL;
   *subtangle_size = 0;
 
-  if ((res = hash_pack_init(&pack, 10)) != RC_OK) {
-    return res;
-  }
-
   hash243_stack_t stack = NULL;
   if ((res = hash243_stack_push(&stack, entry_point))) {
     return res;
@@ -129,38 +125,39 @@ static retcode_t cw_rating_dfs_do_dfs_from_db(
     curr_tx_hash = hash243_stack_peek(stack);
 
     if (!hash_to_indexed_hash_set_map_contains(tx_to_approvers, curr_tx_hash)) {
-      hash_pack_reset(&pack);
-      if ((res = iota_tangle_transaction_load_hashes_of_approvers(
-               tangle, curr_tx_hash, &pack, subtangle_before_timestamp))) {
+      if ((res = iota_tangle_transaction_cursor_hashes_of_approvers(
+               tangle, curr_tx_hash, subtangle_before_timestamp, &cursor))) {
         log_error(logger_id,
                   "Failed in loading approvers, error code is: %" PRIu64 "\n",
                   res);
-        return res;
+        goto done;
       }
       if ((res = hash_to_indexed_hash_set_map_add_new_set(
                tx_to_approvers, curr_tx_hash, &curr_tx, (*subtangle_size)++))) {
-        return res;
+        goto done;
       }
       hash243_stack_pop(&stack);
-      while (pack.num_loaded > 0) {
-        curr_approver_index = --pack.num_loaded;
+      // Approvers are streamed from the cursor rather than loaded into a pack
+      while ((res = iota_stor_cursor_next(&cursor, &approver_hash)) == RC_OK &&
+             approver_hash != NULL) {
         // Add each found approver to the currently traversed tx
-        if ((res = hash243_stack_push(
-                 &stack, ((flex_trit_t *)pack.models[curr_approver_index])))) {
-          return res;
+        if ((res = hash243_stack_push(&stack, approver_hash))) {
+          goto done;
         }
-        if ((res = hash243_set_add(
-                 &curr_tx->approvers,
-                 ((flex_trit_t *)pack.models[pack.num_loaded])))) {
-          return res;
+        if ((res = hash243_set_add(&curr_tx->approvers, approver_hash))) {
+          goto done;
         }
       }
+      if (res != RC_OK) {
+        goto done;
+      }
       continue;
     }
     hash243_stack_pop(&stack);
   }
 
-  hash_pack_free(&pack);
+done:
+  iota_stor_cursor_close(&cursor);
   hash243_stack_free(&stack);
 
   return res;
@@ -98,8 +98,8 @@ static void init_epv(exit_prob_transaction_validator_t *const epv) {
                                                          NULL) == RC_OK);
   TEST_ASSERT(iota_milestone_tracker_init(&mt, &conf, &snapshot, &lv, &ts) ==
               RC_OK);
-  TEST_ASSERT(iota_consensus_ledger_validator_init(&lv, &tangle, &conf, &mt) ==
-              RC_OK);
+  TEST_ASSERT(iota_consensus_ledger_validator_init(&lv, &tangle, &conf, &mt,
+                                                   NULL) == RC_OK);
 
   // We want to avoid unnecessary validation
   mt.latest_snapshot->index = 9999999;
@@ -7,6 +7,7 @@
 
 #include "consensus/exit_probability_validator/exit_probability_validator.h"
 #include "utarray.h"
+#include "utils/containers/hash/hash_allocator.h"
 #include "utils/logger_helper.h"
 
 #define WALKER_VALIDATOR_LOGGER_ID "walker_validator"
@@ -24,10 +25,16 @@ static retcode_t iota_consensus_exit_prob_transaction_validator_below_max_depth(
   retcode_t res = RC_OK;
 
   bool is_genesis_hash;
+  bool active;
   flex_trit_t *curr_hash_trits;
   hash243_stack_t non_analyzed_hashes = NULL;
+  hash_allocator_scope_t scope;
+
+  // The traversal state only lives for the duration of the call
+  hash_allocator_scope_begin(&scope);
+
   if ((res = hash243_stack_push(&non_analyzed_hashes, tail_hash)) != RC_OK) {
-    return res;
+    goto done;
   }
 
   // Load the transaction
@@ -60,7 +67,7 @@ static retcode_t iota_consensus_exit_prob_transaction_validator_below_max_depth(
       if ((res = iota_tangle_transaction_load_partial(
                tangle, curr_hash_trits, &pack,
                PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA)) != RC_OK) {
-        return res;
+        goto done;
       }
       curr_snapshot_index = transaction_snapshot_index(&curr_tx_s);
     } else {
@@ -77,22 +84,25 @@ static retcode_t iota_consensus_exit_prob_transaction_validator_below_max_depth(
     if (!is_genesis_hash && transaction_snapshot_index(curr_tx) == 0) {
       if ((res = hash243_stack_push(&non_analyzed_hashes,
                                     transaction_trunk(curr_tx))) != RC_OK) {
-        return res;
+        goto done;
       }
       if ((res = hash243_stack_push(&non_analyzed_hashes,
                                     transaction_branch(curr_tx))) != RC_OK) {
-        return res;
+        goto done;
       }
     }
   }
 
   hash243_stack_free(&non_analyzed_hashes);
   hash243_set_free(&visited_hashes);
-  if ((res = hash243_set_add(&epv->max_depth_ok_memoization, tail_hash)) !=
-      RC_OK) {
-    return res;
-  }
 
+  // The memoization outlives any scope of the caller
+  active = hash_allocator_suspend();
+  res = hash243_set_add(&epv->max_depth_ok_memoization, tail_hash);
+  hash_allocator_resume(active);
+
+done:
+  hash_allocator_scope_end(&scope);
   return res;
 }
 
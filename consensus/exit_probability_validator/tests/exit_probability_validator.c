@@ -66,7 +66,7 @@ static void init_epv(exit_prob_transaction_validator_t *const epv) {
   TEST_ASSERT(iota_milestone_tracker_init(&mt, &consensus_conf, &snapshot, &lv,
                                           &ts) == RC_OK);
   TEST_ASSERT(iota_consensus_ledger_validator_init(
-                  &lv, &tangle, &consensus_conf, &mt) == RC_OK);
+                  &lv, &tangle, &consensus_conf, &mt, NULL) == RC_OK);
   // We want to avoid unnecessary validation
   mt.latest_snapshot->index = 99999999999;
 
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "common/model/milestone.h"
+#include "consensus/ledger_checkpointer/ledger_checkpointer.h"
+#include "consensus/milestone_tracker/milestone_tracker.h"
+#include "consensus/snapshot/snapshot.h"
+#include "consensus/tangle/tangle.h"
+#include "utils/logger_helper.h"
+
+#define LEDGER_CHECKPOINTER_LOGGER_ID "ledger_checkpointer"
+#define LEDGER_CHECKPOINTER_RESCAN_INTERVAL_SEC 10
+
+static logger_id_t logger_id;
+
+/*
+ * Private functions
+ */
+
+static void *ledger_checkpointer_routine(ledger_checkpointer_t *const lc) {
+  connection_config_t db_conf = {.db_path = lc->conf->db_path};
+  tangle_t tangle;
+
+  if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
+    log_critical(logger_id, "Initializing tangle connection failed\n");
+    return NULL;
+  }
+
+  lock_handle_lock(&lc->lock);
+  while (lc->running) {
+    lock_handle_unlock(&lc->lock);
+    if (iota_ledger_checkpointer_write(lc, &tangle, false) != RC_OK) {
+      log_warning(logger_id, "Writing ledger checkpoint failed\n");
+    }
+    lock_handle_lock(&lc->lock);
+    if (lc->running) {
+      cond_handle_timedwait(&lc->cond, &lc->lock,
+                            LEDGER_CHECKPOINTER_RESCAN_INTERVAL_SEC);
+    }
+  }
+  lock_handle_unlock(&lc->lock);
+
+  // Clean shutdown, the milestone tracker is already stopped
+  if (iota_ledger_checkpointer_write(lc, &tangle, true) != RC_OK) {
+    log_warning(logger_id, "Writing last ledger checkpoint failed\n");
+  }
+
+  if (iota_tangle_destroy(&tangle) != RC_OK) {
+    log_critical(logger_id, "Destroying tangle connection failed\n");
+  }
+
+  return NULL;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t iota_ledger_checkpointer_init(ledger_checkpointer_t *const lc,
+                                        iota_consensus_conf_t *const conf,
+                                        milestone_tracker_t *const mt) {
+  if (lc == NULL) {
+    return RC_LEDGER_CHECKPOINTER_NULL_SELF;
+  }
+
+  logger_id =
+      logger_helper_enable(LEDGER_CHECKPOINTER_LOGGER_ID, LOGGER_DEBUG, true);
+  memset(lc, 0, sizeof(ledger_checkpointer_t));
+  lc->running = false;
+  lc->conf = conf;
+  lc->mt = mt;
+  lock_handle_init(&lc->lock);
+  cond_handle_init(&lc->cond);
+
+  return RC_OK;
+}
+
+retcode_t iota_ledger_checkpointer_start(ledger_checkpointer_t *const lc) {
+  if (lc == NULL) {
+    return RC_LEDGER_CHECKPOINTER_NULL_SELF;
+  } else if (lc->conf->ledger_checkpoint_interval == 0) {
+    return RC_OK;
+  }
+
+  // The ledger validator built the snapshot from the latest checkpoint
+  lc->last_checkpoint_index = iota_snapshot_get_index(lc->mt->latest_snapshot);
+  lc->running = true;
+
+  log_info(logger_id, "Spawning ledger checkpointer thread\n");
+  if (thread_handle_create(&lc->thread,
+                           (thread_routine_t)ledger_checkpointer_routine,
+                           lc) != 0) {
+    log_critical(logger_id, "Spawning ledger checkpointer thread failed\n");
+    lc->running = false;
+    return RC_LEDGER_CHECKPOINTER_FAILED_THREAD_SPAWN;
+  }
+
+  return RC_OK;
+}
+
+retcode_t iota_ledger_checkpointer_stop(ledger_checkpointer_t *const lc) {
+  if (lc == NULL) {
+    return RC_LEDGER_CHECKPOINTER_NULL_SELF;
+  } else if (lc->running == false) {
+    return RC_OK;
+  }
+
+  lock_handle_lock(&lc->lock);
+  lc->running = false;
+  cond_handle_signal(&lc->cond);
+  lock_handle_unlock(&lc->lock);
+
+  log_info(logger_id, "Shutting down ledger checkpointer thread\n");
+  if (thread_handle_join(lc->thread, NULL) != 0) {
+    log_error(logger_id, "Shutting down ledger checkpointer thread failed\n");
+    return RC_LEDGER_CHECKPOINTER_FAILED_THREAD_JOIN;
+  }
+
+  return RC_OK;
+}
+
+retcode_t iota_ledger_checkpointer_destroy(ledger_checkpointer_t *const lc) {
+  if (lc == NULL) {
+    return RC_LEDGER_CHECKPOINTER_NULL_SELF;
+  } else if (lc->running) {
+    return RC_LEDGER_CHECKPOINTER_STILL_RUNNING;
+  }
+
+  lock_handle_destroy(&lc->lock);
+  cond_handle_destroy(&lc->cond);
+  memset(lc, 0, sizeof(ledger_checkpointer_t));
+  logger_helper_release(logger_id);
+
+  return RC_OK;
+}
+
+retcode_t iota_ledger_checkpointer_write(ledger_checkpointer_t *const lc,
+                                         tangle_t const *const tangle,
+                                         bool const force) {
+  retcode_t ret = RC_OK;
+  state_delta_t state = NULL;
+  size_t index = 0;
+  DECLARE_PACK_SINGLE_MILESTONE(milestone, milestone_ptr, milestone_pack);
+
+  if (lc == NULL) {
+    return RC_LEDGER_CHECKPOINTER_NULL_SELF;
+  }
+
+  index = iota_snapshot_get_index(lc->mt->latest_snapshot);
+  if (index <= lc->last_checkpoint_index ||
+      (!force &&
+       index < lc->last_checkpoint_index + lc->conf->ledger_checkpoint_interval)) {
+    return RC_OK;
+  }
+
+  // Only the copy holds the snapshot lock, serialization and storage happen
+  // without blocking the milestone tracker
+  if ((ret = iota_snapshot_copy_state(lc->mt->latest_snapshot, &state,
+                                      &index)) != RC_OK) {
+    goto done;
+  }
+
+  if ((ret = iota_tangle_milestone_load_next(tangle, index - 1,
+                                             &milestone_pack)) != RC_OK) {
+    goto done;
+  } else if (milestone_pack.num_loaded == 0 || milestone.index != index) {
+    ret = RC_LEDGER_CHECKPOINTER_MILESTONE_NOT_FOUND;
+    goto done;
+  }
+
+  if ((ret = iota_tangle_ledger_checkpoint_store(
+           tangle, index, milestone.hash, &state, LEDGER_CHECKPOINTS_KEPT)) !=
+      RC_OK) {
+    goto done;
+  }
+  lc->last_checkpoint_index = index;
+  log_info(logger_id, "Ledger checkpoint written at milestone #%zu\n", index);
+
+done:
+  state_delta_destroy(&state);
+  return ret;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_LEDGER_CHECKPOINTER_LEDGER_CHECKPOINTER_H__
+#define __CONSENSUS_LEDGER_CHECKPOINTER_LEDGER_CHECKPOINTER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "consensus/conf.h"
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of most recent checkpoints kept in the database
+#define LEDGER_CHECKPOINTS_KEPT 2
+
+// Forward declarations
+typedef struct tangle_s tangle_t;
+typedef struct milestone_tracker_s milestone_tracker_t;
+
+// Periodically, and once more when stopped, persists the ledger state at the
+// latest solid milestone so that startup only replays later state deltas
+typedef struct ledger_checkpointer_s {
+  bool running;
+  iota_consensus_conf_t *conf;
+  milestone_tracker_t *mt;
+  uint64_t last_checkpoint_index;
+  thread_handle_t thread;
+  lock_handle_t lock;
+  cond_handle_t cond;
+} ledger_checkpointer_t;
+
+/**
+ * Initializes a ledger checkpointer
+ *
+ * @param lc The ledger checkpointer
+ * @param conf Consensus configuration
+ * @param mt A milestone tracker
+ *
+ * @return a status code
+ */
+retcode_t iota_ledger_checkpointer_init(ledger_checkpointer_t *const lc,
+                                        iota_consensus_conf_t *const conf,
+                                        milestone_tracker_t *const mt);
+
+/**
+ * Starts a ledger checkpointer, does nothing if checkpoints are disabled
+ *
+ * @param lc The ledger checkpointer
+ *
+ * @return a status code
+ */
+retcode_t iota_ledger_checkpointer_start(ledger_checkpointer_t *const lc);
+
+/**
+ * Stops a ledger checkpointer after writing a last checkpoint
+ *
+ * @param lc The ledger checkpointer
+ *
+ * @return a status code
+ */
+retcode_t iota_ledger_checkpointer_stop(ledger_checkpointer_t *const lc);
+
+/**
+ * Destroys a ledger checkpointer
+ *
+ * @param lc The ledger checkpointer
+ *
+ * @return a status code
+ */
+retcode_t iota_ledger_checkpointer_destroy(ledger_checkpointer_t *const lc);
+
+/**
+ * Writes a checkpoint of the ledger state at the current snapshot index
+ *
+ * @param lc The ledger checkpointer
+ * @param tangle A tangle
+ * @param force Whether to write it even if the configured interval did not
+ * elapse since the last one
+ *
+ * @return a status code
+ */
+retcode_t iota_ledger_checkpointer_write(ledger_checkpointer_t *const lc,
+                                         tangle_t const *const tangle,
+                                         bool const force);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_LEDGER_CHECKPOINTER_LEDGER_CHECKPOINTER_H__
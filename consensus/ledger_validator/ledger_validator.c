@@ -6,6 +6,7 @@
  */
 
 #include <inttypes.h>
+#include <stdlib.h>
 
 #include "common/model/milestone.h"
 #include "consensus/bundle_validator/bundle_validator.h"
@@ -13,6 +14,7 @@
 #include "consensus/milestone_tracker/milestone_tracker.h"
 #include "consensus/snapshot/snapshot.h"
 #include "consensus/utils/tangle_traversals.h"
+#include "utils/containers/hash/hash_allocator.h"
 #include "utils/logger_helper.h"
 
 #define LEDGER_VALIDATOR_LOGGER_ID "ledger_validator"
@@ -61,22 +63,83 @@ static retcode_t update_snapshot_milestone(ledger_validator_t const *const lv,
            lv->conf->genesis_hash, NULL, &hashes_to_update)) != RC_OK) {
     return ret;
   }
-  ret = iota_tangle_transactions_update_snapshot_index(tangle, hashes_to_update,
-                                                       index);
+  if ((ret = iota_tangle_transactions_update_snapshot_index(
+           tangle, hashes_to_update, index)) == RC_OK) {
+    ret = iota_confirmation_cache_add(
+        &lv->milestone_tracker->confirmation_cache, hashes_to_update, index);
+  }
   hash243_set_free(&hashes_to_update);
   return ret;
 }
 
+static retcode_t load_checkpoint(ledger_validator_t const *const lv,
+                                 tangle_t const *const tangle,
+                                 uint64_t *const consistent_index,
+                                 flex_trit_t *const consistent_hash) {
+  retcode_t ret = RC_OK;
+  state_delta_t state = NULL;
+  uint64_t below_index = UINT64_MAX;
+  uint64_t index = 0;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  size_t snapshot_index =
+      iota_snapshot_get_index(lv->milestone_tracker->latest_snapshot);
+
+  // Falls back to older checkpoints if the latest one is corrupted
+  while (true) {
+    if ((ret = iota_tangle_ledger_checkpoint_load_latest(
+             tangle, below_index, &index, hash, &state)) != RC_OK) {
+      break;
+    }
+    if (index <= snapshot_index) {
+      break;
+    }
+    if (state_delta_sum(&state) == IOTA_SUPPLY &&
+        state_delta_is_consistent(&state)) {
+      log_info(logger_id, "Loading ledger checkpoint #%" PRIu64 "\n", index);
+      if ((ret = iota_snapshot_replace_state(
+               lv->milestone_tracker->latest_snapshot, &state, index)) ==
+          RC_OK) {
+        *consistent_index = index;
+        memcpy(consistent_hash, hash, FLEX_TRIT_SIZE_243);
+      }
+      break;
+    }
+    log_warning(logger_id, "Skipping invalid ledger checkpoint #%" PRIu64 "\n",
+                index);
+    state_delta_destroy(&state);
+    below_index = index;
+  }
+
+  state_delta_destroy(&state);
+  return ret;
+}
+
 static retcode_t build_snapshot(ledger_validator_t const *const lv,
                                 tangle_t const *const tangle,
                                 uint64_t *const consistent_index,
                                 flex_trit_t *const consistent_hash) {
   retcode_t ret = RC_OK;
-  state_delta_t delta = NULL;
-  state_delta_t patch = NULL;
+  byte_t *delta = NULL;
+  size_t delta_size = 0;
+  bool is_consistent = false;
+  size_t snapshot_index = 0;
   DECLARE_PACK_SINGLE_MILESTONE(milestone, milestone_ptr, pack);
 
-  if ((ret = iota_tangle_milestone_load_first(tangle, &pack)) != RC_OK) {
+  if ((ret = load_checkpoint(lv, tangle, consistent_index, consistent_hash)) !=
+      RC_OK) {
+    goto done;
+  }
+
+  // A local snapshot or a ledger checkpoint already accounts for the deltas up
+  // to its index
+  snapshot_index =
+      iota_snapshot_get_index(lv->milestone_tracker->latest_snapshot);
+  if (snapshot_index == 0) {
+    ret = iota_tangle_milestone_load_first(tangle, &pack);
+  } else {
+    ret = iota_tangle_milestone_load_next(tangle, snapshot_index, &pack);
+  }
+  if (ret != RC_OK) {
     goto done;
   }
 
@@ -87,22 +150,18 @@ static retcode_t build_snapshot(ledger_validator_t const *const lv,
                ", Candidate: #%" PRIu64 "\n",
                *consistent_index, milestone.index);
     }
-    if ((ret = iota_tangle_state_delta_load(tangle, milestone.index, &delta)) !=
-        RC_OK) {
+    // Deltas are applied to the snapshot while being decoded
+    if ((ret = iota_tangle_state_delta_load_serialized(
+             tangle, milestone.index, &delta, &delta_size)) != RC_OK) {
       goto done;
     }
-    if (delta != NULL && !state_delta_empty(delta)) {
-      if ((ret = iota_snapshot_create_patch(
-               lv->milestone_tracker->latest_snapshot, &delta, &patch)) !=
-          RC_OK) {
+    if (delta != NULL) {
+      if ((ret = iota_snapshot_apply_serialized_patch(
+               lv->milestone_tracker->latest_snapshot, delta, delta_size,
+               milestone.index, &is_consistent)) != RC_OK) {
         goto done;
       }
-      if (state_delta_is_consistent(&patch)) {
-        if ((ret = iota_snapshot_apply_patch(
-                 lv->milestone_tracker->latest_snapshot, &delta,
-                 milestone.index)) != RC_OK) {
-          goto done;
-        }
+      if (is_consistent) {
         *consistent_index = milestone.index;
         memcpy(consistent_hash, milestone.hash, FLEX_TRIT_SIZE_243);
       } else {
@@ -116,13 +175,12 @@ static retcode_t build_snapshot(ledger_validator_t const *const lv,
                                                &pack)) != RC_OK) {
       goto done;
     }
-    state_delta_destroy(&delta);
-    state_delta_destroy(&patch);
+    free(delta);
+    delta = NULL;
   }
 
 done:
-  state_delta_destroy(&delta);
-  state_delta_destroy(&patch);
+  free(delta);
   return ret;
 }
 
@@ -132,6 +190,8 @@ typedef struct get_latest_delta_do_func_params_s {
   bool is_milestone;
   uint64_t latest_snapshot_index;
   state_delta_t *state;
+  hash243_set_t *spent_addresses;
+  validation_cache_t *validation_cache;
 } get_latest_delta_do_func_params_t;
 
 static retcode_t get_latest_delta_do_func(flex_trit_t *hash,
@@ -140,8 +200,11 @@ static retcode_t get_latest_delta_do_func(flex_trit_t *hash,
                                           bool *should_stop) {
   retcode_t ret = RC_OK;
   bundle_status_t bundle_status = BUNDLE_NOT_INITIALIZED;
-  bundle_transactions_t *bundle = NULL;
-  iota_transaction_t *tx_bundle = NULL;
+  bundle_transfers_t *transfers = NULL;
+  bundle_transfer_t *transfer = NULL;
+  state_delta_t bundle_delta = NULL;
+  bool cached = false;
+  bool valid = false;
 
   *should_stop = false;
   *should_branch = false;
@@ -154,34 +217,64 @@ static retcode_t get_latest_delta_do_func(flex_trit_t *hash,
       transaction_snapshot_index(tx) > params->latest_snapshot_index) {
     *should_branch = true;
     if (transaction_current_index(tx) == 0) {
-      bundle_transactions_new(&bundle);
-      if ((ret = iota_consensus_bundle_validator_validate(
-               tangle, hash, bundle, &bundle_status)) != RC_OK) {
+      if (params->validation_cache) {
+        if ((ret = iota_validation_cache_bundle_get(
+                 params->validation_cache, params->latest_snapshot_index, hash,
+                 params->state, &cached, &valid)) != RC_OK) {
+          goto done;
+        }
+        if (cached) {
+          if (!valid) {
+            params->valid_delta = false;
+            *should_stop = true;
+          }
+          goto done;
+        }
+      }
+      bundle_transfers_new(&transfers);
+      if ((ret = iota_consensus_bundle_validator_validate_transfers(
+               tangle, hash, transfers, &bundle_status)) != RC_OK) {
         goto done;
       }
-      if (bundle_status != BUNDLE_VALID ||
-          (tx_bundle = (iota_transaction_t *)utarray_eltptr(bundle, 0)) ==
-              NULL) {
+      if (bundle_status != BUNDLE_VALID) {
+        // Incomplete bundles may still become valid and are not cached
+        if (params->validation_cache && bundle_status >= BUNDLE_INVALID_TX) {
+          ret = iota_validation_cache_bundle_add(
+              params->validation_cache, params->latest_snapshot_index, hash,
+              false, NULL);
+        }
         params->valid_delta = false;
         *should_stop = true;
         goto done;
       }
-      while (tx_bundle != NULL) {
-        if (transaction_value(tx_bundle) != 0) {
-          if ((ret = state_delta_add_or_sum(
-                   params->state, transaction_address(tx_bundle),
-                   transaction_value(tx_bundle))) != RC_OK) {
-            goto done;
-          }
+      for (transfer = (bundle_transfer_t *)utarray_front(transfers);
+           transfer != NULL;
+           transfer = (bundle_transfer_t *)utarray_next(transfers, transfer)) {
+        if ((ret = state_delta_add_or_sum(&bundle_delta, transfer->address,
+                                          transfer->value)) != RC_OK) {
+          goto done;
+        }
+        if (params->spent_addresses && transfer->value < 0 &&
+            (ret = hash243_set_add(params->spent_addresses,
+                                   transfer->address)) != RC_OK) {
+          goto done;
         }
-        tx_bundle = (iota_transaction_t *)utarray_next(bundle, tx_bundle);
       }
-      bundle_transactions_free(&bundle);
+      if ((ret = state_delta_apply_patch(params->state, &bundle_delta)) !=
+          RC_OK) {
+        goto done;
+      }
+      if (params->validation_cache) {
+        ret = iota_validation_cache_bundle_add(params->validation_cache,
+                                               params->latest_snapshot_index,
+                                               hash, true, bundle_delta);
+      }
     }
   }
 
 done:
-  bundle_transactions_free(&bundle);
+  bundle_transfers_free(&transfers);
+  state_delta_destroy(&bundle_delta);
   if (ret != RC_OK) {
     *should_stop = true;
     params->valid_delta = false;
@@ -193,15 +286,18 @@ done:
 static retcode_t get_latest_delta(
     ledger_validator_t const *const lv, tangle_t *const tangle,
     hash243_set_t *const analyzed_hashes, state_delta_t *const state,
-    flex_trit_t const *const tip, uint64_t const latest_snapshot_index,
-    bool const is_milestone, bool *const valid_delta) {
+    hash243_set_t *const spent_addresses, flex_trit_t const *const tip,
+    uint64_t const latest_snapshot_index, bool const is_milestone,
+    bool *const valid_delta) {
   retcode_t ret = RC_OK;
 
   get_latest_delta_do_func_params_t params = {
       .state = state,
+      .spent_addresses = spent_addresses,
       .valid_delta = true,
       .latest_snapshot_index = latest_snapshot_index,
       .is_milestone = is_milestone,
+      .validation_cache = is_milestone ? NULL : lv->validation_cache,
       .tangle = tangle};
 
   ret = tangle_traversal_dfs_to_genesis(tangle, get_latest_delta_do_func, tip,
@@ -217,13 +313,23 @@ static retcode_t get_latest_delta(
 
 retcode_t iota_consensus_ledger_validator_init(
     ledger_validator_t *const lv, tangle_t const *const tangle,
-    iota_consensus_conf_t *const conf, milestone_tracker_t *const mt) {
+    iota_consensus_conf_t *const conf, milestone_tracker_t *const mt,
+    spent_addresses_provider_t *const sap) {
   retcode_t ret = RC_OK;
 
   logger_id =
       logger_helper_enable(LEDGER_VALIDATOR_LOGGER_ID, LOGGER_DEBUG, true);
   lv->conf = conf;
   lv->milestone_tracker = mt;
+  lv->spent_addresses_provider = sap;
+
+  if ((lv->validation_cache = (validation_cache_t *)malloc(
+           sizeof(validation_cache_t))) == NULL) {
+    return RC_OOM;
+  }
+  if ((ret = iota_validation_cache_init(lv->validation_cache)) != RC_OK) {
+    return ret;
+  }
 
   if ((ret = build_snapshot(lv, tangle,
                             &mt->latest_solid_subtangle_milestone_index,
@@ -238,6 +344,12 @@ retcode_t iota_consensus_ledger_validator_init(
 retcode_t iota_consensus_ledger_validator_destroy(
     ledger_validator_t *const lv) {
   lv->milestone_tracker = NULL;
+  lv->spent_addresses_provider = NULL;
+  if (lv->validation_cache) {
+    iota_validation_cache_destroy(lv->validation_cache);
+    free(lv->validation_cache);
+    lv->validation_cache = NULL;
+  }
   logger_helper_release(logger_id);
   return RC_OK;
 }
@@ -249,6 +361,7 @@ retcode_t iota_consensus_ledger_validator_update_snapshot(
   bool valid_delta = true;
   state_delta_t delta = NULL;
   state_delta_t patch = NULL;
+  hash243_set_t spent_addresses = NULL;
   DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
   *has_snapshot = false;
 
@@ -267,7 +380,9 @@ retcode_t iota_consensus_ledger_validator_update_snapshot(
   *has_snapshot = transaction_snapshot_index(&tx) != 0;
   if (!(*has_snapshot)) {
     if ((ret = get_latest_delta(
-             lv, tangle, NULL, &delta, milestone->hash,
+             lv, tangle, NULL, &delta,
+             lv->spent_addresses_provider ? &spent_addresses : NULL,
+             milestone->hash,
              iota_snapshot_get_index(lv->milestone_tracker->latest_snapshot),
              true, &valid_delta)) != RC_OK) {
       log_error(logger_id, "Getting latest delta failed\n");
@@ -283,6 +398,15 @@ retcode_t iota_consensus_ledger_validator_update_snapshot(
       goto done;
     }
     if ((*has_snapshot = state_delta_is_consistent(&patch))) {
+      // Stored before the milestone gets a snapshot index, its delta and
+      // spent addresses are not computed again once it has one
+      if (lv->spent_addresses_provider &&
+          (ret = iota_spent_addresses_provider_batch_store(
+               lv->spent_addresses_provider, tangle, spent_addresses)) !=
+              RC_OK) {
+        log_error(logger_id, "Storing spent addresses failed\n");
+        goto done;
+      }
       if ((ret = update_snapshot_milestone(lv, tangle, milestone->hash,
                                            milestone->index)) != RC_OK) {
         log_error(logger_id, "Updating snapshot milestone failed\n");
@@ -306,6 +430,7 @@ retcode_t iota_consensus_ledger_validator_update_snapshot(
 done:
   state_delta_destroy(&delta);
   state_delta_destroy(&patch);
+  hash243_set_free(&spent_addresses);
   return ret;
 }
 
@@ -344,7 +469,14 @@ retcode_t iota_consensus_ledger_validator_update_delta(
   state_delta_t patch = NULL;
   hash243_set_t visited_hashes = NULL;
   bool valid_delta = true;
-
+  bool cached = false;
+  bool fresh = false;
+  bool active = false;
+  uint64_t snapshot_index = 0;
+  hash_allocator_scope_t scope;
+
+  // The past cone of the tip is only kept when merged into the caller's state
+  hash_allocator_scope_begin(&scope);
   *is_consistent = false;
   // Load the transaction
   DECLARE_PACK_SINGLE_TX(curr_tx_s, curr_tx, pack);
@@ -366,16 +498,35 @@ retcode_t iota_consensus_ledger_validator_update_delta(
     goto done;
   }
 
-  if ((ret = get_latest_delta(
-           lv, tangle, &visited_hashes, &tip_state, tip,
-           iota_snapshot_get_index(lv->milestone_tracker->latest_snapshot),
-           false, &valid_delta)) != RC_OK) {
-    log_error(logger_id, "Getting latest delta failed\n");
+  snapshot_index =
+      iota_snapshot_get_index(lv->milestone_tracker->latest_snapshot);
+
+  // A past cone computed from scratch can be reused by any later validation
+  // as long as it does not overlap the hashes already analyzed
+  if ((ret = iota_validation_cache_cone_get(
+           lv->validation_cache, snapshot_index, tip, analyzed_hashes,
+           &tip_state, &visited_hashes, &cached)) != RC_OK) {
     goto done;
   }
 
-  if (!valid_delta) {
-    goto done;
+  if (!cached) {
+    fresh = hash243_set_size(analyzed_hashes) == 0;
+    if ((ret = get_latest_delta(lv, tangle, &visited_hashes, &tip_state, NULL,
+                                tip, snapshot_index, false, &valid_delta)) !=
+        RC_OK) {
+      log_error(logger_id, "Getting latest delta failed\n");
+      goto done;
+    }
+
+    if (!valid_delta) {
+      goto done;
+    }
+
+    if (fresh && (ret = iota_validation_cache_cone_add(
+                      lv->validation_cache, snapshot_index, tip, tip_state,
+                      visited_hashes)) != RC_OK) {
+      goto done;
+    }
   }
 
   if ((ret = state_delta_apply_patch(&tip_state, delta)) != RC_OK) {
@@ -390,11 +541,13 @@ retcode_t iota_consensus_ledger_validator_update_delta(
   }
 
   if (state_delta_is_consistent(&patch)) {
-    if ((ret = state_delta_merge_patch(delta, &tip_state)) != RC_OK) {
-      log_error(logger_id, "Merging patch failed\n");
-      goto done;
+    active = hash_allocator_suspend();
+    if ((ret = state_delta_merge_patch(delta, &tip_state)) == RC_OK) {
+      ret = hash243_set_append(&visited_hashes, analyzed_hashes);
     }
-    if ((ret = hash243_set_append(&visited_hashes, analyzed_hashes)) != RC_OK) {
+    hash_allocator_resume(active);
+    if (ret != RC_OK) {
+      log_error(logger_id, "Merging patch failed\n");
       goto done;
     }
     *is_consistent = true;
@@ -404,5 +557,6 @@ done:
   state_delta_destroy(&tip_state);
   state_delta_destroy(&patch);
   hash243_set_free(&visited_hashes);
+  hash_allocator_scope_end(&scope);
   return ret;
 }
@@ -10,7 +10,9 @@
 
 #include "common/errors.h"
 #include "consensus/conf.h"
+#include "consensus/ledger_validator/validation_cache.h"
 #include "consensus/snapshot/snapshot.h"
+#include "consensus/spent_addresses_provider/spent_addresses_provider.h"
 #include "utils/containers/hash/hash243_stack.h"
 #include "utils/hash_indexed_map.h"
 
@@ -27,11 +29,14 @@ typedef int8_t flex_trit_t;
 typedef struct ledger_validator_s {
   iota_consensus_conf_t *conf;
   milestone_tracker_t *milestone_tracker;
+  spent_addresses_provider_t *spent_addresses_provider;
+  validation_cache_t *validation_cache;
 } ledger_validator_t;
 
 retcode_t iota_consensus_ledger_validator_init(
     ledger_validator_t *const lv, tangle_t const *const tangle,
-    iota_consensus_conf_t *const conf, milestone_tracker_t *const mt);
+    iota_consensus_conf_t *const conf, milestone_tracker_t *const mt,
+    spent_addresses_provider_t *const sap);
 
 retcode_t iota_consensus_ledger_validator_destroy(ledger_validator_t *const lv);
 
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "common/helpers/digest.h"
+#include "consensus/ledger_validator/validation_cache.h"
+
+#define NUM_HASHES 8
+
+static validation_cache_t cache;
+static flex_trit_t hashes[NUM_HASHES][FLEX_TRIT_SIZE_243];
+
+void setUp(void) { TEST_ASSERT(iota_validation_cache_init(&cache) == RC_OK); }
+
+void tearDown(void) {
+  TEST_ASSERT(iota_validation_cache_destroy(&cache) == RC_OK);
+}
+
+static void hashes_init() {
+  trit_t trits[HASH_LENGTH_TRIT] = {1};
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t *hashed_hash = NULL;
+
+  flex_trits_from_trits(hash, HASH_LENGTH_TRIT, trits, HASH_LENGTH_TRIT,
+                        HASH_LENGTH_TRIT);
+  for (size_t i = 0; i < NUM_HASHES; i++) {
+    hashed_hash = iota_flex_digest(hash, HASH_LENGTH_TRIT);
+    memcpy(hash, hashed_hash, FLEX_TRIT_SIZE_243);
+    memcpy(hashes[i], hashed_hash, FLEX_TRIT_SIZE_243);
+    free(hashed_hash);
+  }
+}
+
+static int64_t state_delta_value(state_delta_t delta,
+                                 flex_trit_t const *const hash) {
+  state_delta_entry_t *entry = NULL;
+
+  state_delta_find(delta, hash, entry);
+  TEST_ASSERT_NOT_NULL(entry);
+  return entry->value;
+}
+
+void test_validation_cache_bundle(void) {
+  state_delta_t bundle_delta = NULL;
+  state_delta_t state = NULL;
+  bool found = true;
+  bool valid = true;
+
+  TEST_ASSERT(iota_validation_cache_bundle_get(&cache, 1, hashes[0], &state,
+                                               &found, &valid) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+
+  TEST_ASSERT(state_delta_add(&bundle_delta, hashes[2], 10) == RC_OK);
+  TEST_ASSERT(state_delta_add(&bundle_delta, hashes[3], -10) == RC_OK);
+  TEST_ASSERT(iota_validation_cache_bundle_add(&cache, 1, hashes[0], true,
+                                               bundle_delta) == RC_OK);
+  TEST_ASSERT(iota_validation_cache_bundle_add(&cache, 1, hashes[1], false,
+                                               NULL) == RC_OK);
+
+  TEST_ASSERT(state_delta_add(&state, hashes[2], 5) == RC_OK);
+  TEST_ASSERT(iota_validation_cache_bundle_get(&cache, 1, hashes[0], &state,
+                                               &found, &valid) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_EQUAL_INT(state_delta_value(state, hashes[2]), 15);
+  TEST_ASSERT_EQUAL_INT(state_delta_value(state, hashes[3]), -10);
+
+  TEST_ASSERT(iota_validation_cache_bundle_get(&cache, 1, hashes[1], &state,
+                                               &found, &valid) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_FALSE(valid);
+  TEST_ASSERT_EQUAL_INT(state_delta_size(state), 2);
+
+  // Entries are only valid for the snapshot index they were computed against
+  TEST_ASSERT(iota_validation_cache_bundle_get(&cache, 2, hashes[0], &state,
+                                               &found, &valid) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+
+  state_delta_destroy(&bundle_delta);
+  state_delta_destroy(&state);
+}
+
+void test_validation_cache_snapshot_index(void) {
+  state_delta_t state = NULL;
+  bool found = false;
+  bool valid = false;
+
+  TEST_ASSERT(iota_validation_cache_bundle_add(&cache, 1, hashes[0], false,
+                                               NULL) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(cache.num_bundles, 1);
+  TEST_ASSERT(iota_validation_cache_bundle_add(&cache, 2, hashes[1], false,
+                                               NULL) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(cache.num_bundles, 1);
+  TEST_ASSERT(iota_validation_cache_bundle_get(&cache, 2, hashes[0], &state,
+                                               &found, &valid) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+  TEST_ASSERT(iota_validation_cache_bundle_get(&cache, 2, hashes[1], &state,
+                                               &found, &valid) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+
+  // Stale entries are ignored
+  TEST_ASSERT(iota_validation_cache_bundle_add(&cache, 1, hashes[2], false,
+                                               NULL) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(cache.num_bundles, 1);
+  TEST_ASSERT_EQUAL_INT(cache.snapshot_index, 2);
+}
+
+void test_validation_cache_cone(void) {
+  state_delta_t cone_delta = NULL;
+  state_delta_t state = NULL;
+  hash243_set_t cone = NULL;
+  hash243_set_t analyzed = NULL;
+  hash243_set_t visited = NULL;
+  bool found = false;
+
+  for (size_t i = 0; i < NUM_HASHES / 2; i++) {
+    TEST_ASSERT(hash243_set_add(&cone, hashes[i]) == RC_OK);
+  }
+  TEST_ASSERT(state_delta_add(&cone_delta, hashes[6], 42) == RC_OK);
+  TEST_ASSERT(iota_validation_cache_cone_add(&cache, 1, hashes[0], cone_delta,
+                                             cone) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(cache.num_cone_hashes, NUM_HASHES / 2);
+
+  TEST_ASSERT(hash243_set_add(&analyzed, hashes[NUM_HASHES - 1]) == RC_OK);
+  TEST_ASSERT(iota_validation_cache_cone_get(&cache, 1, hashes[0], &analyzed,
+                                             &state, &visited,
+                                             &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_EQUAL_INT(state_delta_value(state, hashes[6]), 42);
+  TEST_ASSERT_EQUAL_INT(hash243_set_size(&visited), NUM_HASHES / 2);
+  state_delta_destroy(&state);
+  hash243_set_free(&visited);
+
+  // The cone can not be reused once part of it has been analyzed
+  TEST_ASSERT(hash243_set_add(&analyzed, hashes[1]) == RC_OK);
+  TEST_ASSERT(iota_validation_cache_cone_get(&cache, 1, hashes[0], &analyzed,
+                                             &state, &visited,
+                                             &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+  TEST_ASSERT_NULL(state);
+  TEST_ASSERT_NULL(visited);
+
+  state_delta_destroy(&cone_delta);
+  hash243_set_free(&cone);
+  hash243_set_free(&analyzed);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  hashes_init();
+
+  RUN_TEST(test_validation_cache_bundle);
+  RUN_TEST(test_validation_cache_snapshot_index);
+  RUN_TEST(test_validation_cache_cone);
+
+  return UNITY_END();
+}
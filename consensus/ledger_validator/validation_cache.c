@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "consensus/ledger_validator/validation_cache.h"
+#include "utils/containers/hash/hash_allocator.h"
+
+/*
+ * Private functions
+ */
+
+static void validation_cache_clear(validation_cache_t *const cache) {
+  validation_cache_bundle_entry_t *bundle = NULL, *bundle_tmp = NULL;
+  validation_cache_cone_entry_t *cone = NULL, *cone_tmp = NULL;
+
+  HASH_ITER(hh, cache->bundles, bundle, bundle_tmp) {
+    HASH_DEL(cache->bundles, bundle);
+    state_delta_destroy(&bundle->delta);
+    free(bundle);
+  }
+  HASH_ITER(hh, cache->cones, cone, cone_tmp) {
+    HASH_DEL(cache->cones, cone);
+    state_delta_destroy(&cone->delta);
+    hash243_set_free(&cone->hashes);
+    free(cone);
+  }
+  cache->num_bundles = 0;
+  cache->num_cone_hashes = 0;
+}
+
+/**
+ * Must be called with the write lock held
+ *
+ * @return whether entries for this snapshot index can be added
+ */
+static bool validation_cache_sync_index(validation_cache_t *const cache,
+                                        uint64_t const snapshot_index) {
+  if (snapshot_index > cache->snapshot_index) {
+    validation_cache_clear(cache);
+    cache->snapshot_index = snapshot_index;
+  }
+  return snapshot_index == cache->snapshot_index;
+}
+
+static bool hash243_sets_intersect(hash243_set_t const *const set1,
+                                   hash243_set_t const *const set2) {
+  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+  hash243_set_t const *small = set1;
+  hash243_set_t const *large = set2;
+
+  if (hash243_set_size(set1) > hash243_set_size(set2)) {
+    small = set2;
+    large = set1;
+  }
+  HASH_ITER(hh, *small, iter, tmp) {
+    if (hash243_set_contains(large, iter->hash)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t iota_validation_cache_init(validation_cache_t *const cache) {
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  rw_lock_handle_init(&cache->rw_lock);
+  cache->snapshot_index = 0;
+  cache->bundles = NULL;
+  cache->num_bundles = 0;
+  cache->cones = NULL;
+  cache->num_cone_hashes = 0;
+
+  return RC_OK;
+}
+
+retcode_t iota_validation_cache_destroy(validation_cache_t *const cache) {
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  validation_cache_clear(cache);
+  rw_lock_handle_destroy(&cache->rw_lock);
+
+  return RC_OK;
+}
+
+retcode_t iota_validation_cache_bundle_get(validation_cache_t *const cache,
+                                           uint64_t const snapshot_index,
+                                           flex_trit_t const *const tail,
+                                           state_delta_t *const delta,
+                                           bool *const found,
+                                           bool *const valid) {
+  retcode_t ret = RC_OK;
+  validation_cache_bundle_entry_t *entry = NULL;
+
+  *found = false;
+  *valid = false;
+
+  rw_lock_handle_rdlock(&cache->rw_lock);
+  if (cache->snapshot_index == snapshot_index) {
+    HASH_FIND(hh, cache->bundles, tail, FLEX_TRIT_SIZE_243, entry);
+  }
+  if (entry) {
+    *found = true;
+    if ((*valid = entry->valid)) {
+      ret = state_delta_apply_patch(delta, &entry->delta);
+    }
+  }
+  rw_lock_handle_unlock(&cache->rw_lock);
+
+  return ret;
+}
+
+retcode_t iota_validation_cache_bundle_add(validation_cache_t *const cache,
+                                           uint64_t const snapshot_index,
+                                           flex_trit_t const *const tail,
+                                           bool const valid,
+                                           state_delta_t const delta) {
+  retcode_t ret = RC_OK;
+  validation_cache_bundle_entry_t *entry = NULL;
+  // Entries outlive the scope of the caller, if any
+  bool active = hash_allocator_suspend();
+
+  rw_lock_handle_wrlock(&cache->rw_lock);
+
+  if (!validation_cache_sync_index(cache, snapshot_index) ||
+      cache->num_bundles >= VALIDATION_CACHE_MAX_BUNDLES) {
+    goto done;
+  }
+
+  HASH_FIND(hh, cache->bundles, tail, FLEX_TRIT_SIZE_243, entry);
+  if (entry) {
+    goto done;
+  }
+
+  if ((entry = (validation_cache_bundle_entry_t *)malloc(
+           sizeof(validation_cache_bundle_entry_t))) == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+  memcpy(entry->tail, tail, FLEX_TRIT_SIZE_243);
+  entry->valid = valid;
+  entry->delta = NULL;
+  if (valid && (ret = state_delta_apply_patch(&entry->delta, &delta)) !=
+                   RC_OK) {
+    state_delta_destroy(&entry->delta);
+    free(entry);
+    goto done;
+  }
+  HASH_ADD(hh, cache->bundles, tail, FLEX_TRIT_SIZE_243, entry);
+  cache->num_bundles++;
+
+done:
+  rw_lock_handle_unlock(&cache->rw_lock);
+  hash_allocator_resume(active);
+  return ret;
+}
+
+retcode_t iota_validation_cache_cone_get(
+    validation_cache_t *const cache, uint64_t const snapshot_index,
+    flex_trit_t const *const tip, hash243_set_t const *const analyzed_hashes,
+    state_delta_t *const delta, hash243_set_t *const hashes,
+    bool *const found) {
+  retcode_t ret = RC_OK;
+  validation_cache_cone_entry_t *entry = NULL;
+
+  *found = false;
+
+  rw_lock_handle_rdlock(&cache->rw_lock);
+  if (cache->snapshot_index == snapshot_index) {
+    HASH_FIND(hh, cache->cones, tip, FLEX_TRIT_SIZE_243, entry);
+  }
+  if (entry == NULL ||
+      hash243_sets_intersect(&entry->hashes, analyzed_hashes)) {
+    goto done;
+  }
+  if ((ret = state_delta_apply_patch(delta, &entry->delta)) != RC_OK ||
+      (ret = hash243_set_append(&entry->hashes, hashes)) != RC_OK) {
+    goto done;
+  }
+  *found = true;
+
+done:
+  rw_lock_handle_unlock(&cache->rw_lock);
+  return ret;
+}
+
+retcode_t iota_validation_cache_cone_add(validation_cache_t *const cache,
+                                         uint64_t const snapshot_index,
+                                         flex_trit_t const *const tip,
+                                         state_delta_t const delta,
+                                         hash243_set_t const hashes) {
+  retcode_t ret = RC_OK;
+  validation_cache_cone_entry_t *entry = NULL;
+  size_t num_hashes = hash243_set_size(&hashes);
+  // Entries outlive the scope of the caller, if any
+  bool active = hash_allocator_suspend();
+
+  rw_lock_handle_wrlock(&cache->rw_lock);
+
+  if (!validation_cache_sync_index(cache, snapshot_index) ||
+      cache->num_cone_hashes + num_hashes > VALIDATION_CACHE_MAX_CONE_HASHES) {
+    goto done;
+  }
+
+  HASH_FIND(hh, cache->cones, tip, FLEX_TRIT_SIZE_243, entry);
+  if (entry) {
+    goto done;
+  }
+
+  if ((entry = (validation_cache_cone_entry_t *)malloc(
+           sizeof(validation_cache_cone_entry_t))) == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+  memcpy(entry->tip, tip, FLEX_TRIT_SIZE_243);
+  entry->delta = NULL;
+  entry->hashes = NULL;
+  if ((ret = state_delta_apply_patch(&entry->delta, &delta)) != RC_OK ||
+      (ret = hash243_set_append(&hashes, &entry->hashes)) != RC_OK) {
+    state_delta_destroy(&entry->delta);
+    hash243_set_free(&entry->hashes);
+    free(entry);
+    goto done;
+  }
+  HASH_ADD(hh, cache->cones, tip, FLEX_TRIT_SIZE_243, entry);
+  cache->num_cone_hashes += num_hashes;
+
+done:
+  rw_lock_handle_unlock(&cache->rw_lock);
+  hash_allocator_resume(active);
+  return ret;
+}
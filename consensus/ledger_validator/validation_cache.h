@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_LEDGER_VALIDATOR_VALIDATION_CACHE_H__
+#define __CONSENSUS_LEDGER_VALIDATOR_VALIDATION_CACHE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "uthash.h"
+
+#include "common/errors.h"
+#include "common/trinary/flex_trit.h"
+#include "consensus/snapshot/state_delta.h"
+#include "utils/containers/hash/hash243_set.h"
+#include "utils/handles/rw_lock.h"
+
+#define VALIDATION_CACHE_MAX_BUNDLES 100000
+#define VALIDATION_CACHE_MAX_CONE_HASHES 1000000
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct validation_cache_bundle_entry_s {
+  flex_trit_t tail[FLEX_TRIT_SIZE_243];
+  bool valid;
+  state_delta_t delta;
+  UT_hash_handle hh;
+} validation_cache_bundle_entry_t;
+
+typedef struct validation_cache_cone_entry_s {
+  flex_trit_t tip[FLEX_TRIT_SIZE_243];
+  state_delta_t delta;
+  hash243_set_t hashes;
+  UT_hash_handle hh;
+} validation_cache_cone_entry_t;
+
+/**
+ * Results of the ledger validation of unconfirmed transactions, relative to
+ * the snapshot at a given index. Bundles are stored with their validity and
+ * their own state delta, valid tips with the cumulative state delta and the
+ * hashes of their unconfirmed past cone. The cache is emptied whenever the snapshot
+ * index changes.
+ */
+typedef struct validation_cache_s {
+  rw_lock_handle_t rw_lock;
+  uint64_t snapshot_index;
+  validation_cache_bundle_entry_t *bundles;
+  size_t num_bundles;
+  validation_cache_cone_entry_t *cones;
+  size_t num_cone_hashes;
+} validation_cache_t;
+
+/**
+ * Initializes a validation cache
+ *
+ * @param cache The validation cache
+ *
+ * @return a status code
+ */
+retcode_t iota_validation_cache_init(validation_cache_t *const cache);
+
+/**
+ * Destroys a validation cache
+ *
+ * @param cache The validation cache
+ *
+ * @return a status code
+ */
+retcode_t iota_validation_cache_destroy(validation_cache_t *const cache);
+
+/**
+ * Gets a validated bundle and sums its state delta into a given delta if it is
+ * valid
+ *
+ * @param cache The validation cache
+ * @param snapshot_index The index of the snapshot the bundle is validated
+ * against
+ * @param tail The bundle tail hash
+ * @param delta A delta to sum the bundle delta into
+ * @param found Whether the bundle was found
+ * @param valid Whether the bundle is valid
+ *
+ * @return a status code
+ */
+retcode_t iota_validation_cache_bundle_get(validation_cache_t *const cache,
+                                           uint64_t const snapshot_index,
+                                           flex_trit_t const *const tail,
+                                           state_delta_t *const delta,
+                                           bool *const found,
+                                           bool *const valid);
+
+/**
+ * Adds a validated bundle
+ *
+ * @param cache The validation cache
+ * @param snapshot_index The index of the snapshot the bundle is validated
+ * against
+ * @param tail The bundle tail hash
+ * @param valid Whether the bundle is valid
+ * @param delta The bundle state delta
+ *
+ * @return a status code
+ */
+retcode_t iota_validation_cache_bundle_add(validation_cache_t *const cache,
+                                           uint64_t const snapshot_index,
+                                           flex_trit_t const *const tail,
+                                           bool const valid,
+                                           state_delta_t const delta);
+
+/**
+ * Gets the cumulative state delta and the past cone of a tip. The entry is
+ * only used if the past cone does not intersect already analyzed hashes.
+ *
+ * @param cache The validation cache
+ * @param snapshot_index The index of the snapshot the tip is validated against
+ * @param tip The tip hash
+ * @param analyzed_hashes Hashes already accounted for by the caller
+ * @param delta A delta to copy the tip delta into
+ * @param hashes A set to copy the past cone into
+ * @param found Whether a usable entry was found
+ *
+ * @return a status code
+ */
+retcode_t iota_validation_cache_cone_get(
+    validation_cache_t *const cache, uint64_t const snapshot_index,
+    flex_trit_t const *const tip, hash243_set_t const *const analyzed_hashes,
+    state_delta_t *const delta, hash243_set_t *const hashes,
+    bool *const found);
+
+/**
+ * Adds the cumulative state delta and the past cone of a valid tip
+ *
+ * @param cache The validation cache
+ * @param snapshot_index The index of the snapshot the tip is validated against
+ * @param tip The tip hash
+ * @param delta The cumulative state delta of the past cone
+ * @param hashes The past cone
+ *
+ * @return a status code
+ */
+retcode_t iota_validation_cache_cone_add(validation_cache_t *const cache,
+                                         uint64_t const snapshot_index,
+                                         flex_trit_t const *const tip,
+                                         state_delta_t const delta,
+                                         hash243_set_t const hashes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_LEDGER_VALIDATOR_VALIDATION_CACHE_H__
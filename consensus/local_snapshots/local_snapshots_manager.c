@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "common/model/milestone.h"
+#include "consensus/local_snapshots/local_snapshots_manager.h"
+#include "consensus/milestone_tracker/milestone_tracker.h"
+#include "consensus/snapshot/snapshot.h"
+#include "consensus/tangle/tangle.h"
+#include "utils/logger_helper.h"
+
+#define LOCAL_SNAPSHOTS_MANAGER_LOGGER_ID "local_snapshots_manager"
+#define LOCAL_SNAPSHOTS_RESCAN_INTERVAL_SEC 10
+#define LOCAL_SNAPSHOTS_PRUNING_BATCH_SIZE 10000
+#define LOCAL_SNAPSHOTS_SOLID_ENTRY_POINTS_PACK_SIZE 1024
+
+static logger_id_t logger_id;
+
+/*
+ * Private functions
+ */
+
+static retcode_t revert_delta(tangle_t const *const tangle,
+                              state_delta_t *const state,
+                              uint64_t const index) {
+  retcode_t ret = RC_OK;
+  state_delta_t delta = NULL;
+  state_delta_entry_t *iter = NULL, *tmp = NULL;
+
+  if ((ret = iota_tangle_state_delta_load(tangle, index, &delta)) != RC_OK) {
+    return ret;
+  }
+  HASH_ITER(hh, delta, iter, tmp) {
+    if ((ret = state_delta_add_or_sum(state, iter->hash, -iter->value)) !=
+        RC_OK) {
+      break;
+    }
+  }
+  state_delta_destroy(&delta);
+  return ret;
+}
+
+static retcode_t load_metadata(tangle_t const *const tangle,
+                               snapshot_metadata_t *const metadata,
+                               uint64_t const index) {
+  retcode_t ret = RC_OK;
+  iota_stor_pack_t hash_pack;
+  DECLARE_PACK_SINGLE_MILESTONE(milestone, milestone_ptr, milestone_pack);
+  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, tx_pack);
+
+  if ((ret = iota_tangle_milestone_load_next(tangle, index - 1,
+                                             &milestone_pack)) != RC_OK) {
+    return ret;
+  } else if (milestone_pack.num_loaded == 0) {
+    return RC_LOCAL_SNAPSHOTS_MILESTONE_NOT_FOUND;
+  }
+  if ((ret = iota_tangle_transaction_load_partial(
+           tangle, milestone.hash, &tx_pack,
+           PARTIAL_TX_MODEL_ESSENCE_METADATA)) != RC_OK) {
+    return ret;
+  } else if (tx_pack.num_loaded == 0) {
+    return RC_LOCAL_SNAPSHOTS_MILESTONE_NOT_FOUND;
+  }
+
+  memcpy(metadata->hash, milestone.hash, FLEX_TRIT_SIZE_243);
+  metadata->index = index;
+  metadata->timestamp = transaction_timestamp(&tx);
+
+  if ((ret = hash_pack_init(
+           &hash_pack, LOCAL_SNAPSHOTS_SOLID_ENTRY_POINTS_PACK_SIZE)) !=
+      RC_OK) {
+    return ret;
+  }
+  if ((ret = iota_tangle_transaction_load_hashes_of_solid_entry_points(
+           tangle, index, &hash_pack)) != RC_OK) {
+    goto done;
+  }
+  for (size_t i = 0; i < hash_pack.num_loaded; i++) {
+    if ((ret = hash243_set_add(&metadata->solid_entry_points,
+                               (flex_trit_t *)hash_pack.models[i])) != RC_OK) {
+      goto done;
+    }
+  }
+
+done:
+  hash_pack_free(&hash_pack);
+  return ret;
+}
+
+static retcode_t prune(local_snapshots_manager_t const *const lsm,
+                       tangle_t const *const tangle, uint64_t const index) {
+  retcode_t ret = RC_OK;
+  size_t count = 0, total = 0;
+
+  // Small batches keep the write lock short for the other connections
+  do {
+    if ((ret = iota_tangle_transactions_prune(
+             tangle, index, LOCAL_SNAPSHOTS_PRUNING_BATCH_SIZE, &count)) !=
+        RC_OK) {
+      return ret;
+    }
+    total += count;
+  } while (count == LOCAL_SNAPSHOTS_PRUNING_BATCH_SIZE && lsm->running);
+
+  if ((ret = iota_tangle_milestones_delete(tangle, index)) != RC_OK) {
+    return ret;
+  }
+  log_info(logger_id, "Pruned %zu transactions up to milestone #%" PRIu64 "\n",
+           total, index);
+  return ret;
+}
+
+static void *local_snapshots_manager_routine(
+    local_snapshots_manager_t *const lsm) {
+  connection_config_t db_conf = {.db_path = lsm->conf->db_path};
+  tangle_t tangle;
+  uint64_t index = 0;
+
+  if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
+    log_critical(logger_id, "Initializing tangle connection failed\n");
+    return NULL;
+  }
+
+  lock_handle_lock(&lsm->lock);
+  while (lsm->running) {
+    lock_handle_unlock(&lsm->lock);
+    if (iota_local_snapshots_manager_take_snapshot(lsm, &tangle, &index) !=
+        RC_OK) {
+      log_warning(logger_id, "Taking local snapshot failed\n");
+    } else if (index != 0 && prune(lsm, &tangle, index) != RC_OK) {
+      log_warning(logger_id, "Pruning transactions failed\n");
+    }
+    lock_handle_lock(&lsm->lock);
+    if (lsm->running) {
+      cond_handle_timedwait(&lsm->cond, &lsm->lock,
+                            LOCAL_SNAPSHOTS_RESCAN_INTERVAL_SEC);
+    }
+  }
+  lock_handle_unlock(&lsm->lock);
+
+  if (iota_tangle_destroy(&tangle) != RC_OK) {
+    log_critical(logger_id, "Destroying tangle connection failed\n");
+  }
+
+  return NULL;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t iota_local_snapshots_manager_init(local_snapshots_manager_t *const lsm,
+                                            iota_consensus_conf_t *const conf,
+                                            milestone_tracker_t *const mt) {
+  if (lsm == NULL) {
+    return RC_LOCAL_SNAPSHOTS_NULL_SELF;
+  }
+
+  logger_id = logger_helper_enable(LOCAL_SNAPSHOTS_MANAGER_LOGGER_ID,
+                                   LOGGER_DEBUG, true);
+  memset(lsm, 0, sizeof(local_snapshots_manager_t));
+  lsm->running = false;
+  lsm->conf = conf;
+  lsm->mt = mt;
+  lsm->last_snapshot_index = conf->last_milestone;
+  lock_handle_init(&lsm->lock);
+  cond_handle_init(&lsm->cond);
+
+  // Tip selection starts its walks from milestones up to max depth below the
+  // latest solid one, those must never be pruned
+  if (conf->local_snapshots_enabled &&
+      conf->local_snapshots_depth <= conf->max_depth) {
+    log_critical(logger_id,
+                 "Local snapshots depth must be greater than max depth\n");
+    return RC_LOCAL_SNAPSHOTS_INVALID_DEPTH;
+  }
+
+  return RC_OK;
+}
+
+retcode_t iota_local_snapshots_manager_start(
+    local_snapshots_manager_t *const lsm) {
+  if (lsm == NULL) {
+    return RC_LOCAL_SNAPSHOTS_NULL_SELF;
+  } else if (!lsm->conf->local_snapshots_enabled) {
+    return RC_OK;
+  }
+
+  lsm->running = true;
+
+  log_info(logger_id, "Spawning local snapshots manager thread\n");
+  if (thread_handle_create(&lsm->thread,
+                           (thread_routine_t)local_snapshots_manager_routine,
+                           lsm) != 0) {
+    log_critical(logger_id,
+                 "Spawning local snapshots manager thread failed\n");
+    lsm->running = false;
+    return RC_LOCAL_SNAPSHOTS_FAILED_THREAD_SPAWN;
+  }
+
+  return RC_OK;
+}
+
+retcode_t iota_local_snapshots_manager_stop(
+    local_snapshots_manager_t *const lsm) {
+  if (lsm == NULL) {
+    return RC_LOCAL_SNAPSHOTS_NULL_SELF;
+  } else if (lsm->running == false) {
+    return RC_OK;
+  }
+
+  lock_handle_lock(&lsm->lock);
+  lsm->running = false;
+  cond_handle_signal(&lsm->cond);
+  lock_handle_unlock(&lsm->lock);
+
+  log_info(logger_id, "Shutting down local snapshots manager thread\n");
+  if (thread_handle_join(lsm->thread, NULL) != 0) {
+    log_error(logger_id,
+              "Shutting down local snapshots manager thread failed\n");
+    return RC_LOCAL_SNAPSHOTS_FAILED_THREAD_JOIN;
+  }
+
+  return RC_OK;
+}
+
+retcode_t iota_local_snapshots_manager_destroy(
+    local_snapshots_manager_t *const lsm) {
+  if (lsm == NULL) {
+    return RC_LOCAL_SNAPSHOTS_NULL_SELF;
+  } else if (lsm->running) {
+    return RC_LOCAL_SNAPSHOTS_STILL_RUNNING;
+  }
+
+  lock_handle_destroy(&lsm->lock);
+  cond_handle_destroy(&lsm->cond);
+  memset(lsm, 0, sizeof(local_snapshots_manager_t));
+  logger_helper_release(logger_id);
+
+  return RC_OK;
+}
+
+retcode_t iota_local_snapshots_manager_take_snapshot(
+    local_snapshots_manager_t *const lsm, tangle_t const *const tangle,
+    uint64_t *const index) {
+  retcode_t ret = RC_OK;
+  state_delta_t state = NULL;
+  snapshot_metadata_t metadata = {.solid_entry_points = NULL};
+  size_t snapshot_index = 0;
+  uint64_t target = 0;
+
+  if (lsm == NULL) {
+    return RC_LOCAL_SNAPSHOTS_NULL_SELF;
+  }
+
+  *index = 0;
+
+  // The state is copied along with its index so that milestones solidified in
+  // the meantime do not need to be accounted for
+  if ((ret = iota_snapshot_copy_state(lsm->mt->latest_snapshot, &state,
+                                      &snapshot_index)) != RC_OK) {
+    goto done;
+  }
+
+  if (snapshot_index < lsm->last_snapshot_index +
+                           lsm->conf->local_snapshots_interval +
+                           lsm->conf->local_snapshots_depth) {
+    goto done;
+  }
+  target = snapshot_index - lsm->conf->local_snapshots_depth;
+
+  log_info(logger_id, "Taking local snapshot at milestone #%" PRIu64 "\n",
+           target);
+
+  for (uint64_t i = snapshot_index; i > target; i--) {
+    if ((ret = revert_delta(tangle, &state, i)) != RC_OK) {
+      goto done;
+    }
+  }
+  if (state_delta_sum(&state) != IOTA_SUPPLY ||
+      !state_delta_is_consistent(&state)) {
+    log_critical(logger_id, "Inconsistent local snapshot state\n");
+    ret = RC_SNAPSHOT_INCONSISTENT_SNAPSHOT;
+    goto done;
+  }
+
+  if ((ret = load_metadata(tangle, &metadata, target)) != RC_OK) {
+    goto done;
+  }
+
+  if ((ret = iota_snapshot_local_write(lsm->conf->local_snapshots_path, &state,
+                                       &metadata)) != RC_OK) {
+    goto done;
+  }
+
+  // Transactions older than the local snapshot can no longer be attached to
+  __atomic_store_n(&lsm->conf->snapshot_timestamp_sec, metadata.timestamp,
+                   __ATOMIC_RELEASE);
+  lsm->last_snapshot_index = target;
+  *index = target;
+  log_info(logger_id,
+           "Local snapshot #%" PRIu64 " written with %d solid entry points\n",
+           target, hash243_set_size(&metadata.solid_entry_points));
+
+done:
+  state_delta_destroy(&state);
+  hash243_set_free(&metadata.solid_entry_points);
+  return ret;
+}
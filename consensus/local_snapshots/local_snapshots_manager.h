@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_LOCAL_SNAPSHOTS_LOCAL_SNAPSHOTS_MANAGER_H__
+#define __CONSENSUS_LOCAL_SNAPSHOTS_LOCAL_SNAPSHOTS_MANAGER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "consensus/conf.h"
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Forward declarations
+typedef struct tangle_s tangle_t;
+typedef struct milestone_tracker_s milestone_tracker_t;
+
+// Periodically persists the ledger state at a given depth below the latest
+// solid milestone and prunes the transactions and milestones it confirms so
+// that the database size and startup time stay bounded
+typedef struct local_snapshots_manager_s {
+  bool running;
+  iota_consensus_conf_t *conf;
+  milestone_tracker_t *mt;
+  uint64_t last_snapshot_index;
+  thread_handle_t thread;
+  lock_handle_t lock;
+  cond_handle_t cond;
+} local_snapshots_manager_t;
+
+/**
+ * Initializes a local snapshots manager
+ *
+ * @param lsm The local snapshots manager
+ * @param conf Consensus configuration
+ * @param mt A milestone tracker
+ *
+ * @return a status code
+ */
+retcode_t iota_local_snapshots_manager_init(local_snapshots_manager_t *const lsm,
+                                            iota_consensus_conf_t *const conf,
+                                            milestone_tracker_t *const mt);
+
+/**
+ * Starts a local snapshots manager, does nothing if local snapshots are
+ * disabled
+ *
+ * @param lsm The local snapshots manager
+ *
+ * @return a status code
+ */
+retcode_t iota_local_snapshots_manager_start(
+    local_snapshots_manager_t *const lsm);
+
+/**
+ * Stops a local snapshots manager
+ *
+ * @param lsm The local snapshots manager
+ *
+ * @return a status code
+ */
+retcode_t iota_local_snapshots_manager_stop(
+    local_snapshots_manager_t *const lsm);
+
+/**
+ * Destroys a local snapshots manager
+ *
+ * @param lsm The local snapshots manager
+ *
+ * @return a status code
+ */
+retcode_t iota_local_snapshots_manager_destroy(
+    local_snapshots_manager_t *const lsm);
+
+/**
+ * Writes a local snapshot of the ledger state at the configured depth below
+ * the current snapshot index if enough milestones were solidified since the
+ * last one
+ *
+ * @param lsm The local snapshots manager
+ * @param tangle A tangle
+ * @param index The index of the local snapshot taken, 0 if none was due
+ *
+ * @return a status code
+ */
+retcode_t iota_local_snapshots_manager_take_snapshot(
+    local_snapshots_manager_t *const lsm, tangle_t const *const tangle,
+    uint64_t *const index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_LOCAL_SNAPSHOTS_LOCAL_SNAPSHOTS_MANAGER_H__
@@ -8,6 +8,8 @@
 #include <inttypes.h>
 #include <stdlib.h>
 
+#include "utlist.h"
+
 #include "common/model/milestone.h"
 #include "common/sign/normalize.h"
 #include "common/sign/v1/iss_curl.h"
@@ -21,14 +23,27 @@
 #include "utils/logger_helper.h"
 #include "utils/macros.h"
 #include "utils/merkle.h"
+#include "utils/system.h"
 #include "utils/time.h"
 
 #define MILESTONE_TRACKER_LOGGER_ID "milestone_tracker"
-#define MILESTONE_VALIDATION_INTERVAL 10uLL
-#define SOLID_MILESTONE_RESCAN_INTERVAL 5000uLL
+#define MILESTONE_INCOMPLETE_RETRY_INTERVAL_MS 1000uLL
+#define SOLID_MILESTONE_RESCAN_INTERVAL_MS 5000uLL
 
 static logger_id_t logger_id;
 
+struct validated_milestone_s {
+  iota_milestone_t milestone;
+  validated_milestone_t* next;
+};
+
+struct milestone_candidate_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  uint64_t index;
+  milestone_candidate_t* prev;
+  milestone_candidate_t* next;
+};
+
 static retcode_t validate_coordinator(milestone_tracker_t* const mt,
                                       iota_milestone_t* const candidate,
                                       iota_transaction_t* const tx1,
@@ -83,13 +98,20 @@ static retcode_t validate_milestone(
   bundle_transactions_t* bundle = NULL;
   bool exists = false, valid = false;
   bundle_status_t bundle_status = BUNDLE_NOT_INITIALIZED;
+  uint64_t latest_solid_index = 0;
+  uint64_t const latest_index =
+      __atomic_load_n(&mt->latest_milestone_index, __ATOMIC_ACQUIRE);
   *milestone_status = MILESTONE_INVALID;
 
+  lock_handle_lock(&mt->solid_lock);
+  latest_solid_index = mt->latest_solid_subtangle_milestone_index;
+  lock_handle_unlock(&mt->solid_lock);
+
   if (candidate->index >= 0x200000) {
     *milestone_status = MILESTONE_INVALID;
     return ret;
-  } else if (candidate->index <= mt->latest_solid_subtangle_milestone_index ||
-             candidate->index == mt->latest_milestone_index) {
+  } else if (candidate->index <= latest_solid_index ||
+             candidate->index == latest_index) {
     *milestone_status = MILESTONE_EXISTS;
     return ret;
   }
@@ -146,78 +168,277 @@ done:
   return ret;
 }
 
-static uint64_t get_milestone_index(iota_transaction_t* const tx) {
-  trit_t buffer[NUM_TRITS_OBSOLETE_TAG];
+static retcode_t candidate_push(milestone_candidate_t** const candidates,
+                                flex_trit_t const* const hash,
+                                uint64_t const index) {
+  milestone_candidate_t* candidate = NULL;
 
-  flex_trits_to_trits(buffer, NUM_TRITS_OBSOLETE_TAG,
-                      transaction_obsolete_tag(tx), NUM_TRITS_OBSOLETE_TAG,
-                      NUM_TRITS_OBSOLETE_TAG);
-  return trits_to_long(buffer, NUM_TRITS_VALUE);
+  if ((candidate = (milestone_candidate_t*)malloc(
+           sizeof(milestone_candidate_t))) == NULL) {
+    return RC_OOM;
+  }
+  memcpy(candidate->hash, hash, FLEX_TRIT_SIZE_243);
+  candidate->index = index;
+  DL_APPEND(*candidates, candidate);
+  return RC_OK;
+}
+
+static void candidates_free(milestone_candidate_t** const candidates) {
+  milestone_candidate_t *iter = NULL, *tmp = NULL;
+
+  DL_FOREACH_SAFE(*candidates, iter, tmp) {
+    DL_DELETE(*candidates, iter);
+    free(iter);
+  }
+}
+
+/**
+ * Pops the next candidate and marks the worker busy with its index before the
+ * candidate leaves the queue
+ */
+static bool next_candidate(milestone_tracker_t* const mt,
+                           milestone_validation_worker_t* const worker,
+                           flex_trit_t* const hash, bool* const more) {
+  milestone_candidate_t* head = NULL;
+
+  lock_handle_lock(&mt->candidates_lock);
+  if ((head = mt->candidates) != NULL) {
+    memcpy(hash, head->hash, FLEX_TRIT_SIZE_243);
+    DL_DELETE(mt->candidates, head);
+    lock_handle_lock(&mt->validated_lock);
+    worker->busy = true;
+    worker->index = head->index;
+    lock_handle_unlock(&mt->validated_lock);
+    free(head);
+  }
+  *more = mt->candidates != NULL;
+  lock_handle_unlock(&mt->candidates_lock);
+
+  return head != NULL;
+}
+
+/**
+ * Finds a worker not validating a candidate, NULL if all of them are
+ */
+static milestone_validation_worker_t* idle_worker(
+    milestone_tracker_t* const mt) {
+  milestone_validation_worker_t* idle = NULL;
+
+  lock_handle_lock(&mt->validated_lock);
+  for (size_t i = 0; i < mt->workers_count; i++) {
+    if (!mt->workers[i].busy) {
+      idle = &mt->workers[i];
+      break;
+    }
+  }
+  lock_handle_unlock(&mt->validated_lock);
+
+  return idle;
+}
+
+/**
+ * Hands the outcome of a validation over to the committer, valid milestones
+ * are kept sorted by index
+ */
+static void validation_done(milestone_tracker_t* const mt,
+                            milestone_validation_worker_t* const worker,
+                            iota_milestone_t const* const candidate,
+                            milestone_status_t const milestone_status) {
+  validated_milestone_t *validated = NULL, **iter = NULL;
+
+  lock_handle_lock(&mt->validated_lock);
+  if (milestone_status == MILESTONE_VALID) {
+    if ((validated = (validated_milestone_t*)malloc(
+             sizeof(validated_milestone_t))) == NULL) {
+      log_warning(logger_id, "Allocating validated milestone failed\n");
+    } else {
+      validated->milestone = *candidate;
+      for (iter = &mt->validated;
+           *iter != NULL && (*iter)->milestone.index <= candidate->index;
+           iter = &(*iter)->next) {
+      }
+      validated->next = *iter;
+      *iter = validated;
+    }
+  } else if (milestone_status == MILESTONE_INCOMPLETE) {
+    if (candidate_push(&mt->incomplete, candidate->hash, candidate->index) !=
+        RC_OK) {
+      log_warning(logger_id, "Pushing incomplete milestone failed\n");
+    }
+  }
+  worker->busy = false;
+  lock_handle_unlock(&mt->validated_lock);
+
+  executor_schedule(mt->executor, &mt->milestone_committer);
 }
 
-static void* milestone_validator(void* arg) {
-  milestone_tracker_t* mt = (milestone_tracker_t*)arg;
+/**
+ * Validates the next candidate and schedules itself again if more are queued
+ */
+static void milestone_validation_worker(
+    milestone_validation_worker_t* const worker) {
+  milestone_tracker_t* mt = worker->mt;
   iota_milestone_t candidate;
   DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
-  flex_trit_t* peek = NULL;
-  milestone_status_t milestone_status;
-  connection_config_t db_conf = {.db_path = mt->conf->db_path};
-  tangle_t tangle;
+  milestone_status_t milestone_status = MILESTONE_INVALID;
+  milestone_validation_worker_t* idle = NULL;
+  bool more = false;
 
-  if (mt == NULL) {
-    return NULL;
+  if (!next_candidate(mt, worker, candidate.hash, &more)) {
+    return;
   }
+  // Scheduling a running task only makes it run again once done, an idle
+  // worker is scheduled as well to take the next candidate meanwhile
+  if (more) {
+    executor_schedule(mt->executor, &worker->task);
+    if ((idle = idle_worker(mt)) != NULL) {
+      executor_schedule(mt->executor, &idle->task);
+    }
+  }
+
+  hash_pack_reset(&pack);
+  if (iota_tangle_transaction_load_partial(
+          &worker->tangle, candidate.hash, &pack,
+          PARTIAL_TX_MODEL_ESSENCE_CONSENSUS) == RC_OK &&
+      pack.num_loaded != 0) {
+    candidate.index = iota_milestone_tracker_candidate_index(&tx);
+    lock_handle_lock(&mt->validated_lock);
+    worker->index = candidate.index;
+    lock_handle_unlock(&mt->validated_lock);
+    if (validate_milestone(mt, &worker->tangle, &candidate,
+                           &milestone_status) != RC_OK) {
+      log_warning(logger_id, "Validating milestone failed\n");
+      milestone_status = MILESTONE_INVALID;
+    }
+  }
+  validation_done(mt, worker, &candidate, milestone_status);
+}
 
-  if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
-    log_critical(logger_id, "Initializing tangle connection failed\n");
+static void notify_solidifier(milestone_tracker_t* const mt) {
+  if (mt->running) {
+    executor_schedule(mt->executor, &mt->milestone_solidifier);
+  }
+}
+
+static void on_newly_solid(milestone_tracker_t* const mt,
+                           hash243_set_t const newly_solid) {
+  bool awaited = false;
+
+  lock_handle_lock(&mt->solid_lock);
+  awaited = hash243_set_contains(&newly_solid, mt->awaited_milestone);
+  lock_handle_unlock(&mt->solid_lock);
+
+  if (awaited) {
+    notify_solidifier(mt);
+  }
+}
+
+/**
+ * Detaches the validated milestones that can be committed, i.e. those not
+ * preceded by a candidate still queued or being validated. Candidates of
+ * unknown index hold back every commit. Both the candidates lock and the
+ * validated lock must be held.
+ */
+static validated_milestone_t* detach_committable(
+    milestone_tracker_t* const mt) {
+  validated_milestone_t *head = mt->validated, *last = NULL;
+  milestone_candidate_t* candidate = NULL;
+  uint64_t bound = UINT64_MAX;
+
+  DL_FOREACH(mt->candidates, candidate) {
+    bound = MIN(bound, candidate->index);
+  }
+  for (size_t i = 0; i < mt->workers_count; i++) {
+    if (mt->workers[i].busy) {
+      bound = MIN(bound, mt->workers[i].index);
+    }
+  }
+  for (validated_milestone_t* iter = head;
+       iter != NULL && iter->milestone.index <= bound; iter = iter->next) {
+    last = iter;
+  }
+  if (last == NULL) {
     return NULL;
   }
+  mt->validated = last->next;
+  last->next = NULL;
+  return head;
+}
 
-  while (mt->running) {
-    rw_lock_handle_wrlock(&mt->candidates_lock);
-    peek = hash243_queue_peek(mt->candidates);
-
-    if (peek != NULL) {
-      memcpy(candidate.hash, peek, FLEX_TRIT_SIZE_243);
-      hash243_queue_pop(&mt->candidates);
-      rw_lock_handle_unlock(&mt->candidates_lock);
-      hash_pack_reset(&pack);
-      if (iota_tangle_transaction_load_partial(
-              &tangle, candidate.hash, &pack,
-              PARTIAL_TX_MODEL_ESSENCE_CONSENSUS) == RC_OK &&
-          pack.num_loaded != 0) {
-        candidate.index = get_milestone_index(&tx);
-        if (validate_milestone(mt, &tangle, &candidate, &milestone_status) !=
-            RC_OK) {
-          log_warning(logger_id, "Validating milestone failed\n");
-          continue;
-        }
-        if (milestone_status == MILESTONE_VALID) {
-          iota_tangle_milestone_store(&tangle, &candidate);
-          if (candidate.index > mt->latest_milestone_index) {
-            log_info(logger_id,
-                     "Latest milestone has changed from #%" PRIu64
-                     " to #%" PRIu64 " (%d remaining candidates)\n",
-                     mt->latest_milestone_index, candidate.index,
-                     hash243_queue_count(mt->candidates));
-            mt->latest_milestone_index = candidate.index;
-            memcpy(mt->latest_milestone, candidate.hash, FLEX_TRIT_SIZE_243);
-          }
-        } else if (milestone_status == MILESTONE_INCOMPLETE) {
-          iota_milestone_tracker_add_candidate(mt, candidate.hash);
-        }
-      }
-    } else {
-      rw_lock_handle_unlock(&mt->candidates_lock);
+static void commit_milestones(milestone_tracker_t* const mt,
+                              tangle_t* const tangle,
+                              validated_milestone_t* milestones) {
+  validated_milestone_t* next = NULL;
+  bool committed = false;
+
+  for (; milestones != NULL; milestones = next) {
+    next = milestones->next;
+    if (iota_tangle_milestone_store(tangle, &milestones->milestone) != RC_OK) {
+      log_warning(logger_id, "Storing milestone #%" PRIu64 " failed\n",
+                  milestones->milestone.index);
+    } else if (milestones->milestone.index > mt->latest_milestone_index) {
+      log_info(logger_id,
+               "Latest milestone has changed from #%" PRIu64 " to #%" PRIu64
+               "\n",
+               mt->latest_milestone_index, milestones->milestone.index);
+      memcpy(mt->latest_milestone, milestones->milestone.hash,
+             FLEX_TRIT_SIZE_243);
+      __atomic_store_n(&mt->latest_milestone_index,
+                       milestones->milestone.index, __ATOMIC_RELEASE);
+      committed = true;
     }
-    sleep_ms(MILESTONE_VALIDATION_INTERVAL);
+    free(milestones);
+  }
+
+  if (committed) {
+    notify_solidifier(mt);
   }
+}
+
+static void retry_incomplete(milestone_tracker_t* const mt,
+                             milestone_candidate_t** const incomplete) {
+  milestone_candidate_t *iter = NULL, *tmp = NULL;
 
-  if (iota_tangle_destroy(&tangle) != RC_OK) {
-    log_critical(logger_id, "Destroying tangle connection failed\n");
+  DL_FOREACH_SAFE(*incomplete, iter, tmp) {
+    iota_milestone_tracker_add_candidate(mt, iter->hash, iter->index);
+    DL_DELETE(*incomplete, iter);
+    free(iter);
   }
+}
+
+/**
+ * Commits the validated milestones that can be and periodically retries the
+ * incomplete ones
+ */
+static void milestone_committer(milestone_tracker_t* const mt) {
+  validated_milestone_t* committable = NULL;
+  milestone_candidate_t* incomplete = NULL;
+  bool pending = false;
+
+  lock_handle_lock(&mt->candidates_lock);
+  lock_handle_lock(&mt->validated_lock);
+  committable = detach_committable(mt);
+  lock_handle_unlock(&mt->candidates_lock);
+  // Incomplete bundles are retried periodically rather than spinning on them
+  if (current_timestamp_ms() - mt->last_retry_ms >=
+      MILESTONE_INCOMPLETE_RETRY_INTERVAL_MS) {
+    incomplete = mt->incomplete;
+    mt->incomplete = NULL;
+    mt->last_retry_ms = current_timestamp_ms();
+  }
+  lock_handle_unlock(&mt->validated_lock);
+
+  commit_milestones(mt, &mt->committer_tangle, committable);
+  retry_incomplete(mt, &incomplete);
+
+  lock_handle_lock(&mt->validated_lock);
+  pending = mt->incomplete != NULL;
+  lock_handle_unlock(&mt->validated_lock);
 
-  return NULL;
+  if (pending) {
+    executor_schedule_after(mt->executor, &mt->milestone_committer,
+                            MILESTONE_INCOMPLETE_RETRY_INTERVAL_MS);
+  }
 }
 
 static retcode_t update_latest_solid_subtangle_milestone(
@@ -238,10 +459,16 @@ static retcode_t update_latest_solid_subtangle_milestone(
   }
 
   while (pack.num_loaded != 0 &&
-         milestone.index <= mt->latest_milestone_index && mt->running) {
+         milestone.index <=
+             __atomic_load_n(&mt->latest_milestone_index, __ATOMIC_ACQUIRE) &&
+         mt->running) {
     has_snapshot = false;
     is_solid = false;
     if (milestone.index > mt->latest_solid_subtangle_milestone_index) {
+      // Recorded before checking so that becoming solid meanwhile is not missed
+      lock_handle_lock(&mt->solid_lock);
+      memcpy(mt->awaited_milestone, milestone.hash, FLEX_TRIT_SIZE_243);
+      lock_handle_unlock(&mt->solid_lock);
       if ((ret = iota_consensus_transaction_solidifier_check_solidity(
                mt->transaction_solidifier, tangle, milestone.hash, true,
                &is_solid)) != RC_OK) {
@@ -256,9 +483,11 @@ static retcode_t update_latest_solid_subtangle_milestone(
         log_error(logger_id, "Updating snapshot failed\n");
         return ret;
       } else if (has_snapshot) {
+        lock_handle_lock(&mt->solid_lock);
         mt->latest_solid_subtangle_milestone_index = milestone.index;
         memcpy(mt->latest_solid_subtangle_milestone, milestone.hash,
                FLEX_TRIT_SIZE_243);
+        lock_handle_unlock(&mt->solid_lock);
       } else {
         break;
       }
@@ -275,49 +504,70 @@ static retcode_t update_latest_solid_subtangle_milestone(
   return ret;
 }
 
-static void* milestone_solidifier(void* arg) {
-  milestone_tracker_t* mt = (milestone_tracker_t*)arg;
-  uint64_t previous_solid_subtangle_latest_milestone_index = 0;
-  connection_config_t db_conf = {.db_path = mt->conf->db_path};
-  tangle_t tangle;
-
-  if (mt == NULL) {
-    return NULL;
+/**
+ * Scans for the latest solid subtangle milestone, schedules itself again right
+ * away as long as it progresses
+ */
+static void milestone_solidifier(milestone_tracker_t* const mt) {
+  uint64_t previous_solid_subtangle_latest_milestone_index =
+      mt->latest_solid_subtangle_milestone_index;
+
+  log_debug(logger_id, "Scanning for latest solid subtangle milestone\n");
+  if (mt->latest_solid_subtangle_milestone_index <
+      __atomic_load_n(&mt->latest_milestone_index, __ATOMIC_ACQUIRE)) {
+    if (update_latest_solid_subtangle_milestone(mt, &mt->solidifier_tangle) !=
+        RC_OK) {
+      log_warning(logger_id,
+                  "Updating latest solid subtangle milestone failed\n");
+    }
   }
 
-  if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
-    log_critical(logger_id, "Initializing tangle connection failed\n");
-    return NULL;
+  if (previous_solid_subtangle_latest_milestone_index !=
+      mt->latest_solid_subtangle_milestone_index) {
+    log_info(logger_id,
+             "Latest solid subtangle milestone has changed from #%" PRIu64
+             " to #%" PRIu64 "\n",
+             previous_solid_subtangle_latest_milestone_index,
+             mt->latest_solid_subtangle_milestone_index);
+    executor_schedule(mt->executor, &mt->milestone_solidifier);
+    return;
   }
 
-  while (mt->running) {
-    log_debug(logger_id, "Scanning for latest solid subtangle milestone\n");
-    previous_solid_subtangle_latest_milestone_index =
-        mt->latest_solid_subtangle_milestone_index;
-    if (mt->latest_solid_subtangle_milestone_index <
-        mt->latest_milestone_index) {
-      if (update_latest_solid_subtangle_milestone(mt, &tangle) != RC_OK) {
-        log_warning(logger_id,
-                    "Updating latest solid subtangle milestone failed\n");
-      }
-    }
-    if (previous_solid_subtangle_latest_milestone_index !=
-        mt->latest_solid_subtangle_milestone_index) {
-      log_info(logger_id,
-               "Latest solid subtangle milestone has changed from #%" PRIu64
-               " to #%" PRIu64 "\n",
-               previous_solid_subtangle_latest_milestone_index,
-               mt->latest_solid_subtangle_milestone_index);
-      continue;
+  // The rescan interval is only a fallback, e.g. after failed ledger updates
+  executor_schedule_after(mt->executor, &mt->milestone_solidifier,
+                          SOLID_MILESTONE_RESCAN_INTERVAL_MS);
+}
+
+/**
+ * Opens the tangle connections of the tasks
+ */
+static retcode_t milestone_tracker_connect(milestone_tracker_t* const mt) {
+  retcode_t ret = RC_OK;
+  connection_config_t db_conf = {.db_path = mt->conf->db_path};
+  size_t i = 0;
+
+  if ((ret = iota_tangle_init(&mt->committer_tangle, &db_conf)) != RC_OK) {
+    return ret;
+  }
+  if ((ret = iota_tangle_init(&mt->solidifier_tangle, &db_conf)) != RC_OK) {
+    goto committer;
+  }
+  for (i = 0; i < mt->workers_count; i++) {
+    if ((ret = iota_tangle_init(&mt->workers[i].tangle, &db_conf)) != RC_OK) {
+      goto workers;
     }
-    sleep_ms(SOLID_MILESTONE_RESCAN_INTERVAL);
   }
 
-  if (iota_tangle_destroy(&tangle) != RC_OK) {
-    log_critical(logger_id, "Destroying tangle connection failed\n");
-  }
+  return RC_OK;
 
-  return NULL;
+workers:
+  while (i-- > 0) {
+    iota_tangle_destroy(&mt->workers[i].tangle);
+  }
+  iota_tangle_destroy(&mt->solidifier_tangle);
+committer:
+  iota_tangle_destroy(&mt->committer_tangle);
+  return ret;
 }
 
 retcode_t iota_milestone_tracker_init(milestone_tracker_t* const mt,
@@ -338,33 +588,66 @@ retcode_t iota_milestone_tracker_init(milestone_tracker_t* const mt,
   mt->ledger_validator = lv;
   mt->transaction_solidifier = ts;
   mt->candidates = NULL;
-  rw_lock_handle_init(&mt->candidates_lock);
+  lock_handle_init(&mt->candidates_lock);
+  mt->validated = NULL;
+  mt->incomplete = NULL;
+  lock_handle_init(&mt->validated_lock);
+  lock_handle_init(&mt->solid_lock);
+  mt->workers_count =
+      MAX(1, MIN(system_cpu_available(), MILESTONE_VALIDATION_MAX_WORKERS));
+  for (size_t i = 0; i < mt->workers_count; i++) {
+    mt->workers[i].mt = mt;
+    executor_task_init(&mt->workers[i].task,
+                       (executor_routine_t)milestone_validation_worker,
+                       &mt->workers[i]);
+  }
+  executor_task_init(&mt->milestone_committer,
+                     (executor_routine_t)milestone_committer, mt);
+  executor_task_init(&mt->milestone_solidifier,
+                     (executor_routine_t)milestone_solidifier, mt);
+  iota_confirmation_cache_init(&mt->confirmation_cache, conf->max_depth);
   memcpy(mt->coordinator, conf->coordinator, FLEX_TRIT_SIZE_243);
   mt->milestone_start_index = conf->last_milestone;
   mt->latest_milestone_index = conf->last_milestone;
   mt->latest_solid_subtangle_milestone_index = conf->last_milestone;
 
+  if (ts != NULL) {
+    iota_consensus_transaction_solidifier_on_newly_solid(
+        ts, (newly_solid_callback_t)on_newly_solid, mt);
+  }
+
   return RC_OK;
 }
 
 retcode_t iota_milestone_tracker_start(milestone_tracker_t* const mt,
-                                       tangle_t* const tangle) {
+                                       tangle_t* const tangle,
+                                       executor_t* const executor) {
   retcode_t ret = RC_OK;
   DECLARE_PACK_SINGLE_MILESTONE(latest_milestone, latest_milestone_ptr, pack);
   iota_stor_pack_t hash_pack;
 
   if (mt == NULL) {
     return RC_CONSENSUS_MT_NULL_SELF;
+  } else if (executor == NULL) {
+    return RC_NULL_PARAM;
   }
 
+  if ((ret = milestone_tracker_connect(mt)) != RC_OK) {
+    log_critical(logger_id, "Initializing tangle connections failed\n");
+    return ret;
+  }
+
+  mt->executor = executor;
+  mt->last_retry_ms = current_timestamp_ms();
   mt->running = true;
 
   if ((ret = iota_tangle_milestone_load_last(tangle, &pack)) != RC_OK) {
     return ret;
   }
   if (pack.num_loaded != 0) {
-    mt->latest_milestone_index = latest_milestone.index;
     memcpy(mt->latest_milestone, latest_milestone.hash, FLEX_TRIT_SIZE_243);
+    __atomic_store_n(&mt->latest_milestone_index, latest_milestone.index,
+                     __ATOMIC_RELEASE);
   }
   log_info(logger_id, "Latest milestone: #%d\n", mt->latest_milestone_index);
 
@@ -376,34 +659,24 @@ retcode_t iota_milestone_tracker_start(milestone_tracker_t* const mt,
   }
   log_info(logger_id, "Loaded %d milestone candidates\n", hash_pack.num_loaded);
 
+  // Their indexes are only known once the workers load them
   for (size_t i = 0; i < hash_pack.num_loaded; i++) {
-    iota_milestone_tracker_add_candidate(mt,
-                                         ((flex_trit_t**)hash_pack.models)[i]);
+    iota_milestone_tracker_add_candidate(
+        mt, ((flex_trit_t**)hash_pack.models)[i], 0);
   }
   hash_pack_free(&hash_pack);
 
-  log_info(logger_id, "Spawning milestone validator thread\n");
-  if (thread_handle_create(&mt->milestone_validator,
-                           (thread_routine_t)milestone_validator, mt) != 0) {
-    log_critical(logger_id, "Spawning milestone validator thread failed\n");
-    return RC_CONSENSUS_MT_FAILED_THREAD_SPAWN;
-  }
-
   log_info(logger_id, "Latest solid milestone: #%d\n",
            mt->latest_solid_subtangle_milestone_index);
 
-  log_info(logger_id, "Spawning milestone solidifier thread\n");
-  if (thread_handle_create(&mt->milestone_solidifier,
-                           (thread_routine_t)milestone_solidifier, mt) != 0) {
-    log_critical(logger_id, "Spawning milestone solidifier thread failed\n");
-    return RC_CONSENSUS_MT_FAILED_THREAD_SPAWN;
-  }
+  notify_solidifier(mt);
 
   return RC_OK;
 }
 
 retcode_t iota_milestone_tracker_stop(milestone_tracker_t* const mt) {
   retcode_t ret = RC_OK;
+  retcode_t err = RC_OK;
 
   if (mt == NULL) {
     return RC_CONSENSUS_MT_NULL_SELF;
@@ -413,16 +686,29 @@ retcode_t iota_milestone_tracker_stop(milestone_tracker_t* const mt) {
 
   mt->running = false;
 
-  log_info(logger_id, "Shutting down milestone validator thread\n");
-  if (thread_handle_join(mt->milestone_validator, NULL) != 0) {
-    log_error(logger_id, "Shutting down milestone validator thread failed\n");
-    ret = RC_CONSENSUS_MT_FAILED_THREAD_JOIN;
+  // Workers schedule the committer which schedules the solidifier
+  log_info(logger_id, "Stopping milestone validation worker tasks\n");
+  for (size_t i = 0; i < mt->workers_count; i++) {
+    executor_cancel(mt->executor, &mt->workers[i].task);
   }
-
-  log_info(logger_id, "Shutting down milestone solidifier thread\n");
-  if (thread_handle_join(mt->milestone_solidifier, NULL) != 0) {
-    log_error(logger_id, "Shutting down milestone solidifier thread failed\n");
-    ret = RC_CONSENSUS_MT_FAILED_THREAD_JOIN;
+  log_info(logger_id, "Stopping milestone committer task\n");
+  executor_cancel(mt->executor, &mt->milestone_committer);
+  log_info(logger_id, "Stopping milestone solidifier task\n");
+  executor_cancel(mt->executor, &mt->milestone_solidifier);
+
+  for (size_t i = 0; i < mt->workers_count; i++) {
+    if ((err = iota_tangle_destroy(&mt->workers[i].tangle)) != RC_OK) {
+      ret = err;
+    }
+  }
+  if ((err = iota_tangle_destroy(&mt->committer_tangle)) != RC_OK) {
+    ret = err;
+  }
+  if ((err = iota_tangle_destroy(&mt->solidifier_tangle)) != RC_OK) {
+    ret = err;
+  }
+  if (ret != RC_OK) {
+    log_error(logger_id, "Destroying tangle connections failed\n");
   }
 
   return ret;
@@ -430,6 +716,7 @@ retcode_t iota_milestone_tracker_stop(milestone_tracker_t* const mt) {
 
 retcode_t iota_milestone_tracker_destroy(milestone_tracker_t* const mt) {
   retcode_t ret = RC_OK;
+  validated_milestone_t* next = NULL;
 
   if (mt == NULL) {
     return RC_CONSENSUS_MT_NULL_SELF;
@@ -437,25 +724,56 @@ retcode_t iota_milestone_tracker_destroy(milestone_tracker_t* const mt) {
     return RC_CONSENSUS_MT_STILL_RUNNING;
   }
 
-  hash243_queue_free(&mt->candidates);
-  rw_lock_handle_destroy(&mt->candidates_lock);
+  if (mt->transaction_solidifier != NULL) {
+    iota_consensus_transaction_solidifier_on_newly_solid(
+        mt->transaction_solidifier, NULL, NULL);
+  }
+  for (; mt->validated != NULL; mt->validated = next) {
+    next = mt->validated->next;
+    free(mt->validated);
+  }
+  candidates_free(&mt->incomplete);
+  candidates_free(&mt->candidates);
+  lock_handle_destroy(&mt->candidates_lock);
+  lock_handle_destroy(&mt->validated_lock);
+  lock_handle_destroy(&mt->solid_lock);
+  for (size_t i = 0; i < mt->workers_count; i++) {
+    executor_task_destroy(&mt->workers[i].task);
+  }
+  executor_task_destroy(&mt->milestone_committer);
+  executor_task_destroy(&mt->milestone_solidifier);
+  iota_confirmation_cache_destroy(&mt->confirmation_cache);
   memset(mt, 0, sizeof(milestone_tracker_t));
   logger_helper_release(logger_id);
 
   return ret;
 }
 
+uint64_t iota_milestone_tracker_candidate_index(iota_transaction_t* const tx) {
+  trit_t buffer[NUM_TRITS_OBSOLETE_TAG];
+
+  flex_trits_to_trits(buffer, NUM_TRITS_OBSOLETE_TAG,
+                      transaction_obsolete_tag(tx), NUM_TRITS_OBSOLETE_TAG,
+                      NUM_TRITS_OBSOLETE_TAG);
+  return trits_to_long(buffer, NUM_TRITS_VALUE);
+}
+
 retcode_t iota_milestone_tracker_add_candidate(milestone_tracker_t* const mt,
-                                               flex_trit_t const* const hash) {
+                                               flex_trit_t const* const hash,
+                                               uint64_t const index) {
   retcode_t ret = RC_OK;
+  milestone_validation_worker_t* worker = NULL;
 
   if (mt == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_wrlock(&mt->candidates_lock);
-  ret = hash243_queue_push(&mt->candidates, hash);
-  rw_lock_handle_unlock(&mt->candidates_lock);
+  lock_handle_lock(&mt->candidates_lock);
+  ret = candidate_push(&mt->candidates, hash, index);
+  // Candidates are spread over the workers so that they are validated
+  // concurrently
+  worker = &mt->workers[mt->next_worker++ % mt->workers_count];
+  lock_handle_unlock(&mt->candidates_lock);
 
   if (ret != RC_OK) {
     log_warning(logger_id,
@@ -463,5 +781,20 @@ retcode_t iota_milestone_tracker_add_candidate(milestone_tracker_t* const mt,
     return RC_OOM;
   }
 
+  if (mt->running) {
+    executor_schedule(mt->executor, &worker->task);
+  }
+
   return RC_OK;
 }
+
+void iota_milestone_tracker_latest_solid_subtangle_milestone(
+    milestone_tracker_t* const mt, flex_trit_t* const hash,
+    uint64_t* const index) {
+  lock_handle_lock(&mt->solid_lock);
+  memcpy(hash, mt->latest_solid_subtangle_milestone, FLEX_TRIT_SIZE_243);
+  if (index) {
+    *index = mt->latest_solid_subtangle_milestone_index;
+  }
+  lock_handle_unlock(&mt->solid_lock);
+}
@@ -12,37 +12,73 @@
 
 #include "common/errors.h"
 #include "consensus/conf.h"
-#include "utils/containers/hash/hash243_queue.h"
-#include "utils/handles/rw_lock.h"
-#include "utils/handles/thread.h"
+#include "consensus/confirmation_cache/confirmation_cache.h"
+#include "consensus/tangle/tangle.h"
+#include "utils/handles/executor.h"
+#include "utils/handles/lock.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 // Foward declarations
-typedef struct tangle_s tangle_t;
 typedef struct snapshot_s snapshot_t;
 typedef struct _trit_array* trit_array_p;
 typedef struct ledger_validator_s ledger_validator_t;
 typedef struct transaction_solidifier_s transaction_solidifier_t;
+// Validated milestone waiting to be committed, defined in the implementation
+typedef struct validated_milestone_s validated_milestone_t;
+// Milestone candidate waiting to be validated, defined in the implementation
+typedef struct milestone_candidate_s milestone_candidate_t;
+
+#define MILESTONE_VALIDATION_MAX_WORKERS 8
+
+typedef struct milestone_validation_worker_s {
+  struct milestone_tracker_s* mt;
+  executor_task_t task;
+  tangle_t tangle;
+  // Whether a candidate is being validated and its index, 0 until it is known
+  bool busy;
+  uint64_t index;
+} milestone_validation_worker_t;
 
 typedef struct milestone_tracker_s {
   bool running;
+  executor_t* executor;
   iota_consensus_conf_t* conf;
   snapshot_t* latest_snapshot;
   uint64_t milestone_start_index;
-  thread_handle_t milestone_validator;
+  // Candidates are validated concurrently by the worker tasks, valid milestones
+  // are committed in index order by the committer task once no lower index is
+  // queued or in flight
+  milestone_validation_worker_t workers[MILESTONE_VALIDATION_MAX_WORKERS];
+  size_t workers_count;
+  size_t next_worker;
+  executor_task_t milestone_committer;
+  tangle_t committer_tangle;
+  lock_handle_t validated_lock;
+  validated_milestone_t* validated;
+  milestone_candidate_t* incomplete;
+  uint64_t last_retry_ms;
+  // Only written by the committer task, accessed atomically
   uint64_t latest_milestone_index;
   flex_trit_t latest_milestone[FLEX_TRIT_SIZE_243];
-  thread_handle_t milestone_solidifier;
+  // The solidifier task is scheduled when a milestone is committed or when the
+  // milestone it waits for becomes solid
+  executor_task_t milestone_solidifier;
+  tangle_t solidifier_tangle;
+  // Protects the awaited milestone and the latest solid subtangle milestone
+  // which is only written by the solidifier task
+  lock_handle_t solid_lock;
+  flex_trit_t awaited_milestone[FLEX_TRIT_SIZE_243];
   uint64_t latest_solid_subtangle_milestone_index;
   flex_trit_t latest_solid_subtangle_milestone[FLEX_TRIT_SIZE_243];
   flex_trit_t coordinator[FLEX_TRIT_SIZE_243];
   ledger_validator_t* ledger_validator;
   transaction_solidifier_t* transaction_solidifier;
-  hash243_queue_t candidates;
-  rw_lock_handle_t candidates_lock;
+  milestone_candidate_t* candidates;
+  lock_handle_t candidates_lock;
+  confirmation_cache_t confirmation_cache;
   // bool accept_any_testnet_coo;
 } milestone_tracker_t;
 
@@ -67,11 +103,13 @@ retcode_t iota_milestone_tracker_init(milestone_tracker_t* const mt,
  *
  * @param mt The milestone tracker
  * @param tangle A tangle
+ * @param executor The executor running the milestone tracker tasks
  *
  * @return a status code
  */
 retcode_t iota_milestone_tracker_start(milestone_tracker_t* const mt,
-                                       tangle_t* const tangle);
+                                       tangle_t* const tangle,
+                                       executor_t* const executor);
 
 /**
  * Stops a milestone tracker
@@ -91,16 +129,39 @@ retcode_t iota_milestone_tracker_stop(milestone_tracker_t* const mt);
  */
 retcode_t iota_milestone_tracker_destroy(milestone_tracker_t* const mt);
 
+/**
+ * Gives the index a milestone candidate claims
+ *
+ * @param tx The tail transaction of the candidate
+ *
+ * @return the index
+ */
+uint64_t iota_milestone_tracker_candidate_index(iota_transaction_t* const tx);
+
 /**
  * Pushes a milestone candidate to the milestone tracker candidates queue
  *
  * @param mt The milestone tracker
  * @param hash The candidate hash
+ * @param index The index the candidate claims, 0 if its transaction was not
+ * loaded. Validated milestones are not committed past it until it is validated
  *
  * @return a status code
  */
 retcode_t iota_milestone_tracker_add_candidate(milestone_tracker_t* const mt,
-                                               flex_trit_t const* const hash);
+                                               flex_trit_t const* const hash,
+                                               uint64_t const index);
+
+/**
+ * Gets the latest solid subtangle milestone
+ *
+ * @param mt The milestone tracker
+ * @param hash The milestone hash
+ * @param index The milestone index, may be NULL
+ */
+void iota_milestone_tracker_latest_solid_subtangle_milestone(
+    milestone_tracker_t* const mt, flex_trit_t* const hash,
+    uint64_t* const index);
 
 #ifdef __cplusplus
 }
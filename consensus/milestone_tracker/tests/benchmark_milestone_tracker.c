@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/model/bundle.h"
+#include "common/sign/normalize.h"
+#include "common/sign/v1/iss_curl.h"
+#include "common/storage/storage.h"
+#include "common/trinary/trit_long.h"
+#include "common/trinary/trit_tryte.h"
+#include "consensus/milestone_tracker/milestone_tracker.h"
+#include "consensus/test_utils/tangle.h"
+#include "consensus/transaction_solidifier/transaction_solidifier.h"
+#include "utils/handles/executor.h"
+#include "utils/merkle.h"
+#include "utils/time.h"
+
+// Milestones #1 to #2^NUM_KEYS - 1 are signed by a small coordinator tree
+#define NUM_KEYS 8
+#define NUM_LEAVES (1 << NUM_KEYS)
+#define RESYNC_TIMEOUT_MS 600000
+
+static char *test_db_path = "consensus/milestone_tracker/tests/test.db";
+static char *ciri_db_path = "consensus/milestone_tracker/tests/ciri.db";
+
+static char *const seed =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ9ABCDEFGHIJKLMNOPQRSTUVWXYZ9ABCDEFGHIJKLMNOPQR"
+    "STUVWXYZ9";
+
+static double elapsed_ms(struct timespec const *const start,
+                         struct timespec const *const end) {
+  return (end->tv_sec - start->tv_sec) * 1e3 +
+         (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static void synthetic_hash(flex_trit_t *const hash, int64_t const value,
+                           trit_t const marker) {
+  trit_t trits[HASH_LENGTH_TRIT] = {0};
+
+  long_to_trits(value, trits);
+  trits[HASH_LENGTH_TRIT - 2] = marker;
+  trits[HASH_LENGTH_TRIT - 1] = 1;
+  flex_trits_from_trits(hash, HASH_LENGTH_TRIT, trits, HASH_LENGTH_TRIT,
+                        HASH_LENGTH_TRIT);
+}
+
+/**
+ * Builds milestone #index the way the coordinator does: the head transaction
+ * carries the signature of its trunk and the second one the merkle siblings
+ */
+static retcode_t store_milestone(tangle_t *const tangle,
+                                 trit_t const *const tree,
+                                 size_t const tree_size,
+                                 trit_t const *const seed_trits,
+                                 flex_trit_t const *const coordinator,
+                                 size_t const index) {
+  retcode_t ret = RC_OK;
+  iota_transaction_t txs[2];
+  bundle_transactions_t *bundle = NULL;
+  trit_t key[NUM_TRITS_SIGNATURE];
+  trit_t signature[NUM_TRITS_SIGNATURE];
+  trit_t siblings[NUM_TRITS_SIGNATURE] = {0};
+  trit_t normalized_trunk[HASH_LENGTH_TRIT];
+  trit_t tag[NUM_TRITS_OBSOLETE_TAG] = {0};
+  flex_trit_t buffer[FLEX_TRIT_SIZE_6561];
+  Kerl kerl;
+  Curl curl;
+
+  curl.type = CURL_P_27;
+  init_curl(&curl);
+
+  for (size_t i = 0; i < 2; i++) {
+    transaction_reset(&txs[i]);
+    transaction_set_value(&txs[i], 0);
+    transaction_set_timestamp(&txs[i], index);
+    transaction_set_current_index(&txs[i], i);
+    transaction_set_last_index(&txs[i], 1);
+    synthetic_hash(buffer, index, i == 0 ? -1 : 0);
+    transaction_set_hash(&txs[i], buffer);
+  }
+  synthetic_hash(buffer, index, 1);
+  transaction_set_trunk(&txs[1], buffer);
+  transaction_set_branch(&txs[1], buffer);
+  transaction_set_trunk(&txs[0], transaction_hash(&txs[1]));
+  transaction_set_branch(&txs[0], transaction_trunk(&txs[1]));
+  transaction_set_address(&txs[0], coordinator);
+  long_to_trits(index, tag);
+  flex_trits_from_trits(buffer, NUM_TRITS_OBSOLETE_TAG, tag,
+                        NUM_TRITS_OBSOLETE_TAG, NUM_TRITS_OBSOLETE_TAG);
+  transaction_set_obsolete_tag(&txs[0], buffer);
+
+  iss_curl_subseed(seed_trits, key, index, &curl);
+  iss_curl_key(key, key, NUM_TRITS_SIGNATURE, &curl);
+  normalize_flex_hash_to_trits(transaction_trunk(&txs[0]), normalized_trunk);
+  iss_curl_signature(signature, normalized_trunk, key, NUM_TRITS_SIGNATURE,
+                     &curl);
+  flex_trits_from_trits(buffer, NUM_TRITS_SIGNATURE, signature,
+                        NUM_TRITS_SIGNATURE, NUM_TRITS_SIGNATURE);
+  transaction_set_signature(&txs[0], buffer);
+
+  merkle_branch(tree, siblings, tree_size * HASH_LENGTH_TRIT, NUM_KEYS + 1,
+                index, NUM_LEAVES);
+  flex_trits_from_trits(buffer, NUM_TRITS_SIGNATURE, siblings,
+                        NUM_TRITS_SIGNATURE, NUM_TRITS_SIGNATURE);
+  transaction_set_signature(&txs[1], buffer);
+
+  bundle_transactions_new(&bundle);
+  bundle_transactions_add(bundle, &txs[0]);
+  bundle_transactions_add(bundle, &txs[1]);
+  bundle_calculate_hash(bundle, &kerl, buffer);
+  bundle_transactions_free(&bundle);
+
+  for (size_t i = 0; i < 2; i++) {
+    transaction_set_bundle(&txs[i], buffer);
+    if ((ret = iota_tangle_transaction_store(tangle, &txs[i])) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return ret;
+}
+
+int main(int argc, char *argv[]) {
+  tangle_t tangle;
+  connection_config_t config;
+  iota_consensus_conf_t conf;
+  transaction_solidifier_t ts;
+  milestone_tracker_t mt;
+  executor_t executor;
+  size_t const tree_size = merkle_size(NUM_LEAVES);
+  trit_t *tree = NULL;
+  trit_t seed_trits[HASH_LENGTH_TRIT];
+  struct timespec start, end;
+  uint64_t deadline = 0;
+  double total = 0;
+  int status = EXIT_FAILURE;
+  Curl curl;
+
+  if (argc >= 2) {
+    test_db_path = "test.db";
+    ciri_db_path = "ciri.db";
+  }
+
+  if (storage_init() != RC_OK) {
+    return EXIT_FAILURE;
+  }
+  config.db_path = test_db_path;
+  if (tangle_setup(&tangle, &config, test_db_path, ciri_db_path) != RC_OK) {
+    return EXIT_FAILURE;
+  }
+
+  memset(&conf, 0, sizeof(iota_consensus_conf_t));
+  strcpy(conf.db_path, test_db_path);
+  conf.max_depth = 15;
+  conf.num_keys_in_milestone = NUM_KEYS;
+
+  if ((tree = (trit_t *)malloc(tree_size * HASH_LENGTH_TRIT)) == NULL) {
+    goto done;
+  }
+  curl.type = CURL_P_27;
+  init_curl(&curl);
+  trytes_to_trits((tryte_t *)seed, seed_trits, HASH_LENGTH_TRYTE);
+  merkle_create(tree, NUM_LEAVES, seed_trits, 0, 1, &curl);
+  flex_trits_from_trits(conf.coordinator, HASH_LENGTH_TRIT, tree,
+                        HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+
+  for (size_t i = 1; i < NUM_LEAVES; i++) {
+    if (store_milestone(&tangle, tree, tree_size, seed_trits, conf.coordinator,
+                        i) != RC_OK) {
+      fprintf(stderr, "Storing milestone #%zu failed\n", i);
+      goto done;
+    }
+  }
+
+  if (executor_init(&executor, 0) != RC_OK) {
+    goto done;
+  } else if (executor_start(&executor) != RC_OK) {
+    executor_destroy(&executor);
+    goto done;
+  }
+  iota_consensus_transaction_solidifier_init(&ts, &conf, NULL, NULL);
+  iota_milestone_tracker_init(&mt, &conf, NULL, NULL, &ts);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  deadline = current_timestamp_ms() + RESYNC_TIMEOUT_MS;
+  if (iota_milestone_tracker_start(&mt, &tangle, &executor) != RC_OK) {
+    goto destroy;
+  }
+  while (__atomic_load_n(&mt.latest_milestone_index, __ATOMIC_ACQUIRE) <
+             NUM_LEAVES - 1 &&
+         current_timestamp_ms() < deadline) {
+    sleep_ms(1);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  total = elapsed_ms(&start, &end);
+  iota_milestone_tracker_stop(&mt);
+
+  if (mt.latest_milestone_index != NUM_LEAVES - 1) {
+    fprintf(stderr, "Latest milestone is #%" PRIu64 " instead of #%d\n",
+            mt.latest_milestone_index, NUM_LEAVES - 1);
+  } else {
+    printf("%d milestones validated by %zu workers in %.3f ms: %.1f "
+           "milestones/s\n",
+           NUM_LEAVES - 1, mt.workers_count, total,
+           (NUM_LEAVES - 1) / (total / 1e3));
+    status = EXIT_SUCCESS;
+  }
+
+destroy:
+  iota_milestone_tracker_destroy(&mt);
+  iota_consensus_transaction_solidifier_destroy(&ts);
+  executor_stop(&executor);
+  executor_destroy(&executor);
+
+done:
+  free(tree);
+  tangle_cleanup(&tangle, test_db_path);
+  storage_destroy();
+  return status;
+}
@@ -5,6 +5,9 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <inttypes.h>
+#include <stdio.h>
+
 #include "consensus/snapshot/snapshot.h"
 #include "common/model/transaction.h"
 #include "consensus/conf.h"
@@ -19,22 +22,15 @@ static logger_id_t logger_id;
  * Private functions
  */
 
-static retcode_t iota_snapshot_initial_state(snapshot_t *const snapshot,
-                                             char const *const snapshot_file) {
+// Reads "ADDRESS;balance" lines until the end of the file
+static retcode_t read_balances(state_delta_t *const state, FILE *const fp) {
   retcode_t ret = RC_OK;
   char *line = NULL, *delim = NULL;
   int64_t value = 0, supply = 0;
   size_t len = 0;
   ssize_t rd = 0;
-  FILE *fp = NULL;
   flex_trit_t hash[FLEX_TRIT_SIZE_243];
 
-  if ((fp = fopen(snapshot_file, "r")) == NULL) {
-    log_critical(logger_id, "Opening snapshot file failed\n");
-    ret = RC_SNAPSHOT_FILE_NOT_FOUND;
-    goto done;
-  }
-
   while ((rd = getline(&line, &len, fp)) > 0) {
     line[--rd] = '\0';
     if ((delim = strchr(line, ';')) == NULL) {
@@ -47,7 +43,7 @@ static retcode_t iota_snapshot_initial_state(snapshot_t *const snapshot,
     if (value > 0) {
       flex_trits_from_trytes(hash, NUM_TRITS_HASH, (tryte_t *)line,
                              NUM_TRYTES_HASH, NUM_TRYTES_HASH);
-      if ((ret = state_delta_add(&snapshot->state, hash, value)) != RC_OK) {
+      if ((ret = state_delta_add(state, hash, value)) != RC_OK) {
         goto done;
       }
       supply += value;
@@ -67,12 +63,56 @@ done:
   if (line) {
     free(line);
   }
-  if (fp) {
-    fclose(fp);
+  return ret;
+}
+
+static retcode_t iota_snapshot_initial_state(snapshot_t *const snapshot,
+                                             char const *const snapshot_file) {
+  retcode_t ret = RC_OK;
+  FILE *fp = NULL;
+
+  if ((fp = fopen(snapshot_file, "r")) == NULL) {
+    log_critical(logger_id, "Opening snapshot file failed\n");
+    return RC_SNAPSHOT_FILE_NOT_FOUND;
   }
+
+  ret = read_balances(&snapshot->state, fp);
+  fclose(fp);
   return ret;
 }
 
+static retcode_t iota_snapshot_local_state(snapshot_t *const snapshot,
+                                           char const *const path) {
+  retcode_t ret = RC_OK;
+  snapshot_metadata_t metadata = {.solid_entry_points = NULL};
+
+  if ((ret = iota_snapshot_local_read(path, &snapshot->state, &metadata)) !=
+      RC_OK) {
+    return ret;
+  }
+
+  snapshot->index = metadata.index;
+  // Milestones and transactions older than the local snapshot may have been
+  // pruned, the local snapshot supersedes the global one
+  snapshot->conf->last_milestone = metadata.index;
+  snapshot->conf->snapshot_timestamp_sec = metadata.timestamp;
+  log_info(logger_id,
+           "Loaded local snapshot #%" PRIu64 " with %d solid entry points\n",
+           metadata.index, hash243_set_size(&metadata.solid_entry_points));
+  hash243_set_free(&metadata.solid_entry_points);
+  return ret;
+}
+
+static bool file_exists(char const *const path) {
+  FILE *fp = NULL;
+
+  if ((fp = fopen(path, "r")) == NULL) {
+    return false;
+  }
+  fclose(fp);
+  return true;
+}
+
 /*
  * Public functions
  */
@@ -91,6 +131,19 @@ retcode_t iota_snapshot_init(snapshot_t *const snapshot,
   snapshot->index = 0;
   snapshot->state = NULL;
 
+  if (file_exists(conf->local_snapshots_path)) {
+    if ((ret = iota_snapshot_local_state(snapshot,
+                                         conf->local_snapshots_path))) {
+      log_critical(logger_id, "Initializing snapshot local state failed\n");
+      return ret;
+    }
+    log_info(logger_id,
+             "Consistent local snapshot with %ld addresses and correct "
+             "supply\n",
+             HASH_COUNT(snapshot->state));
+    return ret;
+  }
+
   if (strlen(snapshot->conf->snapshot_signature_file)) {
     bool valid = false;
     if ((ret = iota_file_signature_validate(
@@ -161,6 +214,44 @@ retcode_t iota_snapshot_get_balance(snapshot_t *const snapshot,
   return ret;
 }
 
+retcode_t iota_snapshot_get_balances(snapshot_t *const snapshot,
+                                     hash243_queue_t const addresses,
+                                     state_delta_t const *const delta,
+                                     int64_t *const balances,
+                                     size_t *const index) {
+  hash243_queue_entry_t *iter = NULL;
+  state_delta_entry_t *entry = NULL;
+  size_t i = 0;
+
+  if (snapshot == NULL) {
+    return RC_SNAPSHOT_NULL_SELF;
+  } else if (balances == NULL) {
+    return RC_SNAPSHOT_NULL_BALANCE;
+  }
+
+  rw_lock_handle_rdlock(&snapshot->rw_lock);
+  CDL_FOREACH(addresses, iter) {
+    balances[i] = 0;
+    state_delta_find(snapshot->state, iter->hash, entry);
+    if (entry) {
+      balances[i] = entry->value;
+    }
+    if (delta) {
+      state_delta_find(*delta, iter->hash, entry);
+      if (entry) {
+        balances[i] += entry->value;
+      }
+    }
+    i++;
+  }
+  if (index) {
+    *index = snapshot->index;
+  }
+  rw_lock_handle_unlock(&snapshot->rw_lock);
+
+  return RC_OK;
+}
+
 retcode_t iota_snapshot_create_patch(snapshot_t *const snapshot,
                                      state_delta_t *const delta,
                                      state_delta_t *const patch) {
@@ -170,7 +261,7 @@ retcode_t iota_snapshot_create_patch(snapshot_t *const snapshot,
     return RC_SNAPSHOT_NULL_SELF;
   }
 
-  HASH_CLEAR(hh, *patch);
+  state_delta_destroy(patch);
   rw_lock_handle_rdlock(&snapshot->rw_lock);
   ret = state_delta_create_patch(&snapshot->state, delta, patch);
   rw_lock_handle_unlock(&snapshot->rw_lock);
@@ -199,3 +290,217 @@ retcode_t iota_snapshot_apply_patch(snapshot_t *const snapshot,
 
   return ret;
 }
+
+retcode_t iota_snapshot_apply_serialized_patch(snapshot_t *const snapshot,
+                                               byte_t const *const bytes,
+                                               size_t const size, size_t index,
+                                               bool *const is_consistent) {
+  retcode_t ret = RC_OK;
+
+  if (snapshot == NULL) {
+    return RC_SNAPSHOT_NULL_SELF;
+  }
+
+  rw_lock_handle_wrlock(&snapshot->rw_lock);
+  if ((ret = state_delta_apply_serialized_patch(&snapshot->state, bytes, size,
+                                                is_consistent)) == RC_OK &&
+      *is_consistent) {
+    snapshot->index = index;
+  }
+  rw_lock_handle_unlock(&snapshot->rw_lock);
+
+  return ret;
+}
+
+retcode_t iota_snapshot_copy_state(snapshot_t *const snapshot,
+                                   state_delta_t *const state,
+                                   size_t *const index) {
+  retcode_t ret = RC_OK;
+
+  if (snapshot == NULL) {
+    return RC_SNAPSHOT_NULL_SELF;
+  } else if (state == NULL) {
+    return RC_SNAPSHOT_NULL_STATE;
+  }
+
+  rw_lock_handle_rdlock(&snapshot->rw_lock);
+  ret = state_delta_apply_patch(state, &snapshot->state);
+  if (index) {
+    *index = snapshot->index;
+  }
+  rw_lock_handle_unlock(&snapshot->rw_lock);
+
+  return ret;
+}
+
+retcode_t iota_snapshot_replace_state(snapshot_t *const snapshot,
+                                      state_delta_t *const state,
+                                      size_t const index) {
+  if (snapshot == NULL) {
+    return RC_SNAPSHOT_NULL_SELF;
+  } else if (state == NULL) {
+    return RC_SNAPSHOT_NULL_STATE;
+  }
+
+  rw_lock_handle_wrlock(&snapshot->rw_lock);
+  state_delta_destroy(&snapshot->state);
+  snapshot->state = *state;
+  snapshot->index = index;
+  rw_lock_handle_unlock(&snapshot->rw_lock);
+  *state = NULL;
+
+  return RC_OK;
+}
+
+static retcode_t write_solid_entry_point(FILE *const fp,
+                                         flex_trit_t const *const hash) {
+  tryte_t trytes[NUM_TRYTES_HASH + 1];
+
+  flex_trits_to_trytes(trytes, NUM_TRYTES_HASH, hash, NUM_TRITS_HASH,
+                       NUM_TRITS_HASH);
+  trytes[NUM_TRYTES_HASH] = '\0';
+  if (fprintf(fp, "%s\n", trytes) < 0) {
+    return RC_SNAPSHOT_FAILED_WRITING_FILE;
+  }
+  return RC_OK;
+}
+
+retcode_t iota_snapshot_local_write(char const *const path,
+                                    state_delta_t const *const state,
+                                    snapshot_metadata_t const *const metadata) {
+  retcode_t ret = RC_OK;
+  FILE *fp = NULL;
+  char tmp_path[256];
+  tryte_t trytes[NUM_TRYTES_HASH + 1];
+  state_delta_entry_t *iter = NULL, *tmp = NULL;
+  size_t num_balances = 0;
+
+  if (state == NULL) {
+    return RC_SNAPSHOT_NULL_STATE;
+  }
+
+  // Written aside and renamed so that a crash never leaves a partial file
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+  if ((fp = fopen(tmp_path, "w")) == NULL) {
+    log_error(logger_id, "Opening local snapshot file failed\n");
+    return RC_SNAPSHOT_FAILED_WRITING_FILE;
+  }
+
+  HASH_ITER(hh, *state, iter, tmp) {
+    if (iter->value != 0) {
+      num_balances++;
+    }
+  }
+
+  flex_trits_to_trytes(trytes, NUM_TRYTES_HASH, metadata->hash, NUM_TRITS_HASH,
+                       NUM_TRITS_HASH);
+  trytes[NUM_TRYTES_HASH] = '\0';
+  if (fprintf(fp, "%s\n%" PRIu64 "\n%" PRIu64 "\n%d\n%zu\n", trytes,
+              metadata->index, metadata->timestamp,
+              hash243_set_size(&metadata->solid_entry_points),
+              num_balances) < 0) {
+    ret = RC_SNAPSHOT_FAILED_WRITING_FILE;
+    goto done;
+  }
+
+  if ((ret = hash243_set_for_each(
+           &metadata->solid_entry_points,
+           (hash243_on_container_func)write_solid_entry_point, fp)) != RC_OK) {
+    goto done;
+  }
+
+  HASH_ITER(hh, *state, iter, tmp) {
+    if (iter->value == 0) {
+      continue;
+    }
+    flex_trits_to_trytes(trytes, NUM_TRYTES_HASH, iter->hash, NUM_TRITS_HASH,
+                         NUM_TRITS_HASH);
+    if (fprintf(fp, "%s;%" PRId64 "\n", trytes, iter->value) < 0) {
+      ret = RC_SNAPSHOT_FAILED_WRITING_FILE;
+      goto done;
+    }
+  }
+
+  if (fflush(fp) != 0) {
+    ret = RC_SNAPSHOT_FAILED_WRITING_FILE;
+  }
+
+done:
+  if (fclose(fp) != 0 && ret == RC_OK) {
+    ret = RC_SNAPSHOT_FAILED_WRITING_FILE;
+  }
+  if (ret == RC_OK && rename(tmp_path, path) != 0) {
+    ret = RC_SNAPSHOT_FAILED_WRITING_FILE;
+  }
+  if (ret != RC_OK) {
+    log_error(logger_id, "Writing local snapshot file failed\n");
+    remove(tmp_path);
+  }
+  return ret;
+}
+
+retcode_t iota_snapshot_local_read(char const *const path,
+                                   state_delta_t *const state,
+                                   snapshot_metadata_t *const metadata) {
+  retcode_t ret = RC_OK;
+  FILE *fp = NULL;
+  char *line = NULL;
+  size_t len = 0;
+  ssize_t rd = 0;
+  uint64_t header[4];
+  size_t num_solid_entry_points = 0;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  if ((fp = fopen(path, "r")) == NULL) {
+    log_critical(logger_id, "Opening local snapshot file failed\n");
+    return RC_SNAPSHOT_FILE_NOT_FOUND;
+  }
+
+  // Header: milestone hash, index, timestamp, number of solid entry points and
+  // number of balances
+  if ((rd = getline(&line, &len, fp)) != NUM_TRYTES_HASH + 1) {
+    goto invalid;
+  }
+  flex_trits_from_trytes(metadata->hash, NUM_TRITS_HASH, (tryte_t *)line,
+                         NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  for (size_t i = 0; i < 4; i++) {
+    if ((rd = getline(&line, &len, fp)) <= 1) {
+      goto invalid;
+    }
+    header[i] = strtoull(line, NULL, 10);
+  }
+  metadata->index = header[0];
+  metadata->timestamp = header[1];
+  num_solid_entry_points = header[2];
+
+  for (size_t i = 0; i < num_solid_entry_points; i++) {
+    if ((rd = getline(&line, &len, fp)) != NUM_TRYTES_HASH + 1) {
+      goto invalid;
+    }
+    flex_trits_from_trytes(hash, NUM_TRITS_HASH, (tryte_t *)line,
+                           NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+    if ((ret = hash243_set_add(&metadata->solid_entry_points, hash)) !=
+        RC_OK) {
+      goto done;
+    }
+  }
+
+  if ((ret = read_balances(state, fp)) != RC_OK) {
+    goto done;
+  }
+  if (state_delta_size(*state) != header[3]) {
+    goto invalid;
+  }
+  goto done;
+
+invalid:
+  log_critical(logger_id, "Badly formatted local snapshot file\n");
+  ret = RC_SNAPSHOT_INVALID_FILE;
+
+done:
+  if (line) {
+    free(line);
+  }
+  fclose(fp);
+  return ret;
+}
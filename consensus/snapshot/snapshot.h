@@ -15,6 +15,8 @@
 #include "common/trinary/trit_array.h"
 #include "consensus/conf.h"
 #include "consensus/snapshot/state_delta.h"
+#include "utils/containers/hash/hash243_queue.h"
+#include "utils/containers/hash/hash243_set.h"
 #include "utils/handles/rw_lock.h"
 
 #ifdef __cplusplus
@@ -28,8 +30,18 @@ typedef struct snapshot_s {
   state_delta_t state;
 } snapshot_t;
 
+// Describes the milestone a local snapshot was taken at
+typedef struct snapshot_metadata_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  uint64_t index;
+  uint64_t timestamp;
+  // Transactions confirmed by the snapshot still referenced by the tangle
+  hash243_set_t solid_entry_points;
+} snapshot_metadata_t;
+
 /**
- * Initializes a snapshot
+ * Initializes a snapshot, from the local snapshot file when one exists and
+ * from the global snapshot file otherwise
  *
  * @param snapshot The snapshot
  * @param conf Consensus configuration
@@ -68,6 +80,77 @@ size_t iota_snapshot_get_index(snapshot_t *const snapshot);
 retcode_t iota_snapshot_get_balance(snapshot_t *const snapshot,
                                     flex_trit_t *const hash, int64_t *balance);
 
+/**
+ * Gets the balances of a list of address hashes and the snapshot index they
+ * were read at, under a single read lock so that all balances are consistent
+ * with each other. Addresses unknown to the snapshot have a balance of 0.
+ *
+ * @param snapshot The snapshot
+ * @param addresses The address hashes
+ * @param delta An optional delta added on top of the snapshot balances
+ * @param balances The balances, must be able to hold one value per address
+ * @param index The snapshot index
+ *
+ * @return a status code
+ */
+retcode_t iota_snapshot_get_balances(snapshot_t *const snapshot,
+                                     hash243_queue_t const addresses,
+                                     state_delta_t const *const delta,
+                                     int64_t *const balances,
+                                     size_t *const index);
+
+/**
+ * Copies the state of a snapshot and the index it was read at
+ *
+ * @param snapshot The snapshot
+ * @param state The copy, must be empty
+ * @param index The snapshot index
+ *
+ * @return a status code
+ */
+retcode_t iota_snapshot_copy_state(snapshot_t *const snapshot,
+                                   state_delta_t *const state,
+                                   size_t *const index);
+
+/**
+ * Replaces the state of a snapshot, e.g. by a ledger checkpoint
+ *
+ * @param snapshot The snapshot
+ * @param state The new state, ownership is taken and it is reset to NULL
+ * @param index A new index for the snapshot
+ *
+ * @return a status code
+ */
+retcode_t iota_snapshot_replace_state(snapshot_t *const snapshot,
+                                      state_delta_t *const state,
+                                      size_t const index);
+
+/**
+ * Writes a local snapshot file, atomically replacing any previous one
+ *
+ * @param path Path of the local snapshot file
+ * @param state The ledger state at the milestone of the metadata
+ * @param metadata The snapshot metadata
+ *
+ * @return a status code
+ */
+retcode_t iota_snapshot_local_write(char const *const path,
+                                    state_delta_t const *const state,
+                                    snapshot_metadata_t const *const metadata);
+
+/**
+ * Reads a local snapshot file
+ *
+ * @param path Path of the local snapshot file
+ * @param state The ledger state, must be empty
+ * @param metadata The snapshot metadata
+ *
+ * @return a status code
+ */
+retcode_t iota_snapshot_local_read(char const *const path,
+                                   state_delta_t *const state,
+                                   snapshot_metadata_t *const metadata);
+
 /**
  * Creates a patch of a snapshot state and a delta
  *
@@ -93,6 +176,22 @@ retcode_t iota_snapshot_create_patch(snapshot_t *const snapshot,
 retcode_t iota_snapshot_apply_patch(snapshot_t *const snapshot,
                                     state_delta_t *const patch, size_t index);
 
+/**
+ * Applies a serialized patch to a snapshot state as it is decoded
+ *
+ * @param snapshot The snapshot
+ * @param bytes The serialized patch
+ * @param size The size of the serialized patch
+ * @param index A new index for the snapshot
+ * @param is_consistent Whether the patch was consistent and applied
+ *
+ * @return a status code
+ */
+retcode_t iota_snapshot_apply_serialized_patch(snapshot_t *const snapshot,
+                                               byte_t const *const bytes,
+                                               size_t const size, size_t index,
+                                               bool *const is_consistent);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,8 +5,33 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
+
+#include "common/defs.h"
+#include "common/trinary/trit_byte.h"
 #include "consensus/snapshot/state_delta.h"
 
+/*
+ * Serialized deltas are made of a version byte and a varint entry count
+ * followed by the entries sorted by address. Each entry is a 5 trits per byte
+ * packed address followed by its zigzag encoded varint value.
+ *
+ * Deltas and checkpoints stored before were a bare sequence of flex trits
+ * addresses and native 64 bits values. The migration of unversioned databases
+ * prefixes them with STATE_DELTA_LEGACY_VERSION so that they are still decoded.
+ */
+
+#define STATE_DELTA_SERIALIZATION_VERSION 1
+#define STATE_DELTA_LEGACY_VERSION 0
+#define STATE_DELTA_LEGACY_ENTRY_SIZE (FLEX_TRIT_SIZE_243 + sizeof(int64_t))
+#define STATE_DELTA_PACKED_ADDRESS_SIZE MIN_BYTES(HASH_LENGTH_TRIT)
+#define VARINT_MAX_SIZE 10
+
+typedef struct packed_entry_s {
+  byte_t address[STATE_DELTA_PACKED_ADDRESS_SIZE];
+  int64_t value;
+} packed_entry_t;
+
 int64_t state_delta_sum(state_delta_t const *const state) {
   int64_t sum = 0;
   state_delta_entry_t *iter = NULL, *tmp = NULL;
@@ -102,46 +127,239 @@ bool state_delta_is_consistent(state_delta_t *const delta) {
       if (entry->value < 0) {
         return false;
       }
-      HASH_DEL(*delta, entry);
-      free(entry);
+      hash_to_int64_t_map_remove_entry(delta, entry);
     }
   }
   return true;
 }
 
+/*
+ * Serialization
+ */
+
+static size_t varint_size(uint64_t value) {
+  size_t size = 1;
+
+  while (value >= 0x80) {
+    value >>= 7;
+    size++;
+  }
+  return size;
+}
+
+static size_t varint_encode(uint64_t value, byte_t *const bytes) {
+  size_t size = 0;
+
+  while (value >= 0x80) {
+    bytes[size++] = (byte_t)(value | 0x80);
+    value >>= 7;
+  }
+  bytes[size++] = (byte_t)value;
+  return size;
+}
+
+static retcode_t varint_decode(byte_t const *const bytes, size_t const size,
+                               size_t *const offset, uint64_t *const value) {
+  *value = 0;
+
+  for (size_t shift = 0; *offset < size && shift < 7 * VARINT_MAX_SIZE;
+       shift += 7) {
+    byte_t const byte = bytes[(*offset)++];
+    *value |= (uint64_t)(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return RC_OK;
+    }
+  }
+  return RC_SNAPSHOT_INVALID_SERIALIZED_DELTA;
+}
+
+static inline uint64_t zigzag_encode(int64_t const value) {
+  return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t zigzag_decode(uint64_t const value) {
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static int packed_entry_cmp(void const *const lhs, void const *const rhs) {
+  return memcmp(((packed_entry_t const *)lhs)->address,
+                ((packed_entry_t const *)rhs)->address,
+                STATE_DELTA_PACKED_ADDRESS_SIZE);
+}
+
+/**
+ * Decodes the next entry of a serialized delta
+ */
+static retcode_t decode_entry(byte_t const *const bytes, size_t const size,
+                              byte_t const version, size_t *const offset,
+                              flex_trit_t *const hash, int64_t *const value) {
+  retcode_t ret = RC_OK;
+  uint64_t encoded = 0;
+
+  if (version == STATE_DELTA_LEGACY_VERSION) {
+    if (*offset + STATE_DELTA_LEGACY_ENTRY_SIZE > size) {
+      return RC_SNAPSHOT_INVALID_SERIALIZED_DELTA;
+    }
+    memcpy(hash, bytes + *offset, FLEX_TRIT_SIZE_243);
+    memcpy(value, bytes + *offset + FLEX_TRIT_SIZE_243, sizeof(int64_t));
+    *offset += STATE_DELTA_LEGACY_ENTRY_SIZE;
+    return RC_OK;
+  }
+
+  if (*offset + STATE_DELTA_PACKED_ADDRESS_SIZE > size) {
+    return RC_SNAPSHOT_INVALID_SERIALIZED_DELTA;
+  }
+  flex_trits_from_bytes(hash, HASH_LENGTH_TRIT, bytes + *offset,
+                        HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+  *offset += STATE_DELTA_PACKED_ADDRESS_SIZE;
+  if ((ret = varint_decode(bytes, size, offset, &encoded)) != RC_OK) {
+    return ret;
+  }
+  *value = zigzag_decode(encoded);
+  return RC_OK;
+}
+
+/**
+ * Decodes the header of a serialized delta
+ */
+static retcode_t decode_header(byte_t const *const bytes, size_t const size,
+                               byte_t *const version, size_t *const offset,
+                               uint64_t *const count) {
+  *version = STATE_DELTA_SERIALIZATION_VERSION;
+  *offset = 0;
+  *count = 0;
+  // Milestones stored without a delta have an empty one
+  if (size == 0) {
+    return RC_OK;
+  }
+  *version = bytes[0];
+  *offset = 1;
+  if (*version == STATE_DELTA_LEGACY_VERSION) {
+    if ((size - 1) % STATE_DELTA_LEGACY_ENTRY_SIZE != 0) {
+      return RC_SNAPSHOT_INVALID_SERIALIZED_DELTA;
+    }
+    *count = (size - 1) / STATE_DELTA_LEGACY_ENTRY_SIZE;
+    return RC_OK;
+  } else if (*version != STATE_DELTA_SERIALIZATION_VERSION) {
+    return RC_SNAPSHOT_INVALID_SERIALIZED_DELTA;
+  }
+  return varint_decode(bytes, size, offset, count);
+}
+
 size_t state_delta_serialized_size(state_delta_t const *const delta) {
+  size_t size = 0;
+  state_delta_entry_t *iter = NULL, *tmp = NULL;
+
   if (delta == NULL) {
     return 0;
   }
-  return HASH_COUNT(*delta) * (FLEX_TRIT_SIZE_243 + sizeof(int64_t));
+
+  size = 1 + varint_size(HASH_COUNT(*delta));
+  HASH_ITER(hh, *delta, iter, tmp) {
+    size += STATE_DELTA_PACKED_ADDRESS_SIZE +
+            varint_size(zigzag_encode(iter->value));
+  }
+  return size;
 }
 
 retcode_t state_delta_serialize(state_delta_t const *const delta,
                                 byte_t *const bytes) {
-  uint64_t offset = 0;
+  size_t offset = 0, count = HASH_COUNT(*delta), i = 0;
+  packed_entry_t *entries = NULL;
   state_delta_entry_t *iter = NULL, *tmp = NULL;
 
+  if (count != 0 && (entries = (packed_entry_t *)malloc(
+                         count * sizeof(packed_entry_t))) == NULL) {
+    return RC_SNAPSHOT_OOM;
+  }
+
   HASH_ITER(hh, *delta, iter, tmp) {
-    memcpy(bytes + offset, iter->hash, FLEX_TRIT_SIZE_243);
-    offset += FLEX_TRIT_SIZE_243;
-    memcpy(bytes + offset, &iter->value, sizeof(int64_t));
-    offset += sizeof(int64_t);
+    flex_trits_to_bytes(entries[i].address, HASH_LENGTH_TRIT, iter->hash,
+                        HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+    entries[i++].value = iter->value;
+  }
+  // Sorted entries make serialization deterministic and allow merging
+  qsort(entries, count, sizeof(packed_entry_t), packed_entry_cmp);
+
+  bytes[offset++] = STATE_DELTA_SERIALIZATION_VERSION;
+  offset += varint_encode(count, bytes + offset);
+  for (i = 0; i < count; i++) {
+    memcpy(bytes + offset, entries[i].address, STATE_DELTA_PACKED_ADDRESS_SIZE);
+    offset += STATE_DELTA_PACKED_ADDRESS_SIZE;
+    offset += varint_encode(zigzag_encode(entries[i].value), bytes + offset);
   }
+
+  free(entries);
   return RC_OK;
 }
 
 retcode_t state_delta_deserialize(byte_t const *const bytes, size_t const size,
                                   state_delta_t *const delta) {
-  retcode_t ret;
-  uint64_t offset = 0;
+  retcode_t ret = RC_OK;
+  size_t offset = 0;
+  uint64_t count = 0;
+  int64_t value = 0;
+  byte_t version = 0;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
 
-  for (size_t i = 0; i < size / (FLEX_TRIT_SIZE_243 + sizeof(int64_t)); i++) {
-    if ((ret = state_delta_add(
-             delta, bytes + offset,
-             *((int64_t *)(bytes + offset + FLEX_TRIT_SIZE_243)))) != RC_OK) {
+  if ((ret = decode_header(bytes, size, &version, &offset, &count)) != RC_OK) {
+    return ret;
+  }
+  for (uint64_t i = 0; i < count; i++) {
+    if ((ret = decode_entry(bytes, size, version, &offset, hash, &value)) !=
+            RC_OK ||
+        (ret = state_delta_add(delta, hash, value)) != RC_OK) {
       return ret;
     }
-    offset += FLEX_TRIT_SIZE_243 + sizeof(int64_t);
   }
   return RC_OK;
 }
+
+retcode_t state_delta_apply_serialized_patch(state_delta_t *const state,
+                                             byte_t const *const bytes,
+                                             size_t const size,
+                                             bool *const is_consistent) {
+  retcode_t ret = RC_OK;
+  size_t offset = 0, entries = 0;
+  uint64_t count = 0;
+  int64_t value = 0, sum = 0;
+  byte_t version = 0;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  state_delta_entry_t *entry = NULL;
+
+  *is_consistent = false;
+
+  if ((ret = decode_header(bytes, size, &version, &offset, &count)) != RC_OK) {
+    return ret;
+  }
+  entries = offset;
+
+  // First pass probes the state so that nothing is applied if a balance would
+  // become negative
+  for (uint64_t i = 0; i < count; i++) {
+    if ((ret = decode_entry(bytes, size, version, &offset, hash, &value)) !=
+        RC_OK) {
+      return ret;
+    }
+    state_delta_find(*state, hash, entry);
+    if ((entry ? entry->value : 0) + value < 0) {
+      return RC_OK;
+    }
+    sum += value;
+  }
+  if (sum != 0) {
+    return RC_OK;
+  }
+
+  offset = entries;
+  for (uint64_t i = 0; i < count; i++) {
+    if ((ret = decode_entry(bytes, size, version, &offset, hash, &value)) !=
+            RC_OK ||
+        (ret = state_delta_add_or_sum(state, hash, value)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  *is_consistent = true;
+  return RC_OK;
+}
@@ -49,6 +49,23 @@ retcode_t state_delta_serialize(state_delta_t const *const delta,
 retcode_t state_delta_deserialize(byte_t const *const bytes, size_t const size,
                                   state_delta_t *const delta);
 
+/**
+ * Applies a serialized patch to a state while decoding it, without building an
+ * intermediate delta. The patch is not applied if it does not sum to zero or
+ * if it would make a balance negative.
+ *
+ * @param state The state
+ * @param bytes The serialized patch
+ * @param size The size of the serialized patch
+ * @param is_consistent Whether the patch was consistent and applied
+ *
+ * @return a status code
+ */
+retcode_t state_delta_apply_serialized_patch(state_delta_t *const state,
+                                             byte_t const *const bytes,
+                                             size_t const size,
+                                             bool *const is_consistent);
+
 #ifdef __cplusplus
 }
 #endif
@@ -94,6 +94,51 @@ void test_snapshot_get_balance() {
   TEST_ASSERT(iota_snapshot_destroy(&snapshot) == RC_OK);
 }
 
+void test_snapshot_get_balances() {
+  hash243_queue_t addresses = NULL;
+  state_delta_t delta = NULL;
+  flex_trit_t address[FLEX_TRIT_SIZE_243];
+  int64_t balances[3];
+  size_t index = 0;
+
+  strcpy(conf.snapshot_file, "consensus/snapshot/tests/snapshot.txt");
+  TEST_ASSERT(iota_snapshot_init(&snapshot, &conf) == RC_OK);
+  flex_trits_from_trytes(address, NUM_TRITS_HASH,
+                         (tryte_t*)"J9999999999999999999999999999999999999999999999999999"
+                         "9999999999999999999999999999",
+                         NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  TEST_ASSERT(hash243_queue_push(&addresses, address) == RC_OK);
+  TEST_ASSERT(state_delta_add(&delta, address, (int64_t)-1000) == RC_OK);
+  flex_trits_from_trytes(address, NUM_TRITS_HASH,
+                         (tryte_t*)"Z9999999999999999999999999999999999999999999999999999"
+                         "9999999999999999999999999999",
+                         NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  TEST_ASSERT(hash243_queue_push(&addresses, address) == RC_OK);
+  TEST_ASSERT(state_delta_add(&delta, address, (int64_t)1000) == RC_OK);
+  flex_trits_from_trytes(address, NUM_TRITS_HASH,
+                         (tryte_t*)"I9999999999999999999999999999999999999999999999999999"
+                         "9999999999999999999999999999",
+                         NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  TEST_ASSERT(hash243_queue_push(&addresses, address) == RC_OK);
+
+  TEST_ASSERT(iota_snapshot_get_balances(&snapshot, addresses, NULL, balances,
+                                         &index) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(index, snapshot.index);
+  TEST_ASSERT_EQUAL_INT(balances[0], 3000000);
+  TEST_ASSERT_EQUAL_INT(balances[1], 0);
+  TEST_ASSERT_EQUAL_INT(balances[2], 80000000);
+
+  TEST_ASSERT(iota_snapshot_get_balances(&snapshot, addresses, &delta, balances,
+                                         &index) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(balances[0], 2999000);
+  TEST_ASSERT_EQUAL_INT(balances[1], 1000);
+  TEST_ASSERT_EQUAL_INT(balances[2], 80000000);
+
+  hash243_queue_free(&addresses);
+  state_delta_destroy(&delta);
+  TEST_ASSERT(iota_snapshot_destroy(&snapshot) == RC_OK);
+}
+
 void test_snapshot_create_and_apply_patch() {
   state_delta_t delta = NULL;
   state_delta_t patch = NULL;
@@ -127,6 +172,167 @@ void test_snapshot_create_and_apply_patch() {
   state_delta_destroy(&delta);
 }
 
+void test_snapshot_apply_serialized_patch() {
+  state_delta_t delta = NULL;
+  state_delta_t deserialized = NULL;
+  state_delta_entry_t *entry = NULL;
+  byte_t *bytes = NULL;
+  size_t size = 0;
+  bool is_consistent = true;
+  int64_t balance = 0;
+  flex_trit_t hash1[FLEX_TRIT_SIZE_243];
+  flex_trit_t hash2[FLEX_TRIT_SIZE_243];
+
+  strcpy(conf.snapshot_file, "consensus/snapshot/tests/snapshot.txt");
+  TEST_ASSERT(iota_snapshot_init(&snapshot, &conf) == RC_OK);
+  flex_trits_from_trytes(hash1, NUM_TRITS_HASH,
+                         (tryte_t*)"O99999999999999999999999999999999999999999999999999999999999999999999999999999999",
+                         NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  flex_trits_from_trytes(hash2, NUM_TRITS_HASH,
+                         (tryte_t*)"Q99999999999999999999999999999999999999999999999999999999999999999999999999999999",
+                         NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+
+  // Spending more than the balance is rejected and leaves the state untouched
+  TEST_ASSERT(state_delta_add(&delta, hash1, (int64_t)-70) == RC_OK);
+  TEST_ASSERT(state_delta_add(&delta, hash2, (int64_t)70) == RC_OK);
+  size = state_delta_serialized_size(&delta);
+  bytes = (byte_t*)malloc(size);
+  TEST_ASSERT(state_delta_serialize(&delta, bytes) == RC_OK);
+  TEST_ASSERT(iota_snapshot_apply_serialized_patch(&snapshot, bytes, size, 1,
+                                                   &is_consistent) == RC_OK);
+  TEST_ASSERT_FALSE(is_consistent);
+  TEST_ASSERT(iota_snapshot_get_balance(&snapshot, hash1, &balance) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(balance, 60);
+  free(bytes);
+  state_delta_destroy(&delta);
+
+  TEST_ASSERT(state_delta_add(&delta, hash2, (int64_t)50) == RC_OK);
+  TEST_ASSERT(state_delta_add(&delta, hash1, (int64_t)-50) == RC_OK);
+  size = state_delta_serialized_size(&delta);
+  bytes = (byte_t*)malloc(size);
+  TEST_ASSERT(state_delta_serialize(&delta, bytes) == RC_OK);
+
+  TEST_ASSERT(state_delta_deserialize(bytes, size, &deserialized) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(state_delta_size(deserialized), 2);
+  state_delta_find(deserialized, hash1, entry);
+  TEST_ASSERT_NOT_NULL(entry);
+  TEST_ASSERT_EQUAL_INT(entry->value, -50);
+  state_delta_destroy(&deserialized);
+  TEST_ASSERT(state_delta_deserialize(bytes, size - 1, &deserialized) ==
+              RC_SNAPSHOT_INVALID_SERIALIZED_DELTA);
+
+  TEST_ASSERT(iota_snapshot_apply_serialized_patch(&snapshot, bytes, size, 2,
+                                                   &is_consistent) == RC_OK);
+  TEST_ASSERT_TRUE(is_consistent);
+  TEST_ASSERT_EQUAL_INT(iota_snapshot_get_index(&snapshot), 2);
+  TEST_ASSERT(iota_snapshot_get_balance(&snapshot, hash1, &balance) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(balance, 10);
+  TEST_ASSERT(iota_snapshot_get_balance(&snapshot, hash2, &balance) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(balance, 50);
+
+  TEST_ASSERT(iota_snapshot_destroy(&snapshot) == RC_OK);
+  free(bytes);
+  state_delta_destroy(&delta);
+  state_delta_destroy(&deserialized);
+}
+
+void test_snapshot_apply_legacy_serialized_patch() {
+  state_delta_t deserialized = NULL;
+  state_delta_entry_t *entry = NULL;
+  byte_t bytes[1 + 2 * (FLEX_TRIT_SIZE_243 + sizeof(int64_t))];
+  int64_t const values[2] = {-50, 50};
+  bool is_consistent = false;
+  int64_t balance = 0;
+  flex_trit_t hash1[FLEX_TRIT_SIZE_243];
+  flex_trit_t hash2[FLEX_TRIT_SIZE_243];
+
+  strcpy(conf.snapshot_file, "consensus/snapshot/tests/snapshot.txt");
+  TEST_ASSERT(iota_snapshot_init(&snapshot, &conf) == RC_OK);
+  flex_trits_from_trytes(hash1, NUM_TRITS_HASH,
+                         (tryte_t*)"O99999999999999999999999999999999999999999999999999999999999999999999999999999999",
+                         NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  flex_trits_from_trytes(hash2, NUM_TRITS_HASH,
+                         (tryte_t*)"Q99999999999999999999999999999999999999999999999999999999999999999999999999999999",
+                         NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+
+  // Flex trits addresses and native values as tagged by the schema migration
+  bytes[0] = 0;
+  memcpy(bytes + 1, hash1, FLEX_TRIT_SIZE_243);
+  memcpy(bytes + 1 + FLEX_TRIT_SIZE_243, &values[0], sizeof(int64_t));
+  memcpy(bytes + 1 + FLEX_TRIT_SIZE_243 + sizeof(int64_t), hash2,
+         FLEX_TRIT_SIZE_243);
+  memcpy(bytes + 1 + 2 * FLEX_TRIT_SIZE_243 + sizeof(int64_t), &values[1],
+         sizeof(int64_t));
+
+  TEST_ASSERT(state_delta_deserialize(bytes, sizeof(bytes), &deserialized) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(state_delta_size(deserialized), 2);
+  state_delta_find(deserialized, hash2, entry);
+  TEST_ASSERT_NOT_NULL(entry);
+  TEST_ASSERT_EQUAL_INT(entry->value, 50);
+  state_delta_destroy(&deserialized);
+  TEST_ASSERT(state_delta_deserialize(bytes, sizeof(bytes) - 1,
+                                      &deserialized) ==
+              RC_SNAPSHOT_INVALID_SERIALIZED_DELTA);
+
+  TEST_ASSERT(iota_snapshot_apply_serialized_patch(
+                  &snapshot, bytes, sizeof(bytes), 1, &is_consistent) ==
+              RC_OK);
+  TEST_ASSERT_TRUE(is_consistent);
+  TEST_ASSERT(iota_snapshot_get_balance(&snapshot, hash1, &balance) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(balance, 10);
+  TEST_ASSERT(iota_snapshot_get_balance(&snapshot, hash2, &balance) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(balance, 50);
+
+  TEST_ASSERT(iota_snapshot_destroy(&snapshot) == RC_OK);
+  state_delta_destroy(&deserialized);
+}
+
+void test_snapshot_local_write_and_read() {
+  char const *path = "consensus/snapshot/tests/local_snapshot.txt";
+  snapshot_metadata_t metadata = {.index = 42, .timestamp = 1537203600};
+  snapshot_metadata_t read_metadata = {.solid_entry_points = NULL};
+  state_delta_t state = NULL;
+  state_delta_entry_t *entry = NULL;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  int64_t balance = 0;
+
+  strcpy(conf.snapshot_file, "consensus/snapshot/tests/snapshot.txt");
+  TEST_ASSERT(iota_snapshot_init(&snapshot, &conf) == RC_OK);
+  flex_trits_from_trytes(metadata.hash, NUM_TRITS_HASH,
+                         (tryte_t*)"A99999999999999999999999999999999999999999999999999999999999999999999999999999999",
+                         NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  TEST_ASSERT(hash243_set_add(&metadata.solid_entry_points, metadata.hash) ==
+              RC_OK);
+  TEST_ASSERT(iota_snapshot_local_write(path, &snapshot.state, &metadata) ==
+              RC_OK);
+
+  TEST_ASSERT(iota_snapshot_local_read(path, &state, &read_metadata) == RC_OK);
+  TEST_ASSERT_EQUAL_MEMORY(read_metadata.hash, metadata.hash,
+                           FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_INT(read_metadata.index, 42);
+  TEST_ASSERT_EQUAL_INT(read_metadata.timestamp, 1537203600);
+  TEST_ASSERT_EQUAL_INT(hash243_set_size(&read_metadata.solid_entry_points), 1);
+  TEST_ASSERT(hash243_set_contains(&read_metadata.solid_entry_points,
+                                   metadata.hash));
+  TEST_ASSERT_EQUAL_INT(state_delta_size(state),
+                        state_delta_size(snapshot.state));
+  flex_trits_from_trytes(hash, NUM_TRITS_HASH,
+                         (tryte_t*)"J9999999999999999999999999999999999999999999999999999"
+                         "9999999999999999999999999999",
+                         NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  state_delta_find(state, hash, entry);
+  TEST_ASSERT_NOT_NULL(entry);
+  TEST_ASSERT(iota_snapshot_get_balance(&snapshot, hash, &balance) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(entry->value, balance);
+
+  remove(path);
+  hash243_set_free(&metadata.solid_entry_points);
+  hash243_set_free(&read_metadata.solid_entry_points);
+  state_delta_destroy(&state);
+  TEST_ASSERT(iota_snapshot_destroy(&snapshot) == RC_OK);
+}
+
 int main(int argc, char *argv[]) {
   UNITY_BEGIN();
 
@@ -141,7 +347,11 @@ int main(int argc, char *argv[]) {
   RUN_TEST(test_snapshot_init_file_invalid_supply);
   RUN_TEST(test_snapshot_check_consistency);
   RUN_TEST(test_snapshot_get_balance);
+  RUN_TEST(test_snapshot_get_balances);
   RUN_TEST(test_snapshot_create_and_apply_patch);
+  RUN_TEST(test_snapshot_apply_serialized_patch);
+  RUN_TEST(test_snapshot_apply_legacy_serialized_patch);
+  RUN_TEST(test_snapshot_local_write_and_read);
 
   return UNITY_END();
 }
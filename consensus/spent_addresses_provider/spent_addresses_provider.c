@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+
+#include "consensus/spent_addresses_provider/spent_addresses_provider.h"
+#include "utils/logger_helper.h"
+
+#define SPENT_ADDRESSES_PROVIDER_LOGGER_ID "spent_addresses_provider"
+#define SPENT_ADDRESSES_LOAD_PACK_SIZE 1024
+
+static logger_id_t logger_id;
+
+/*
+ * Private functions
+ */
+
+// FNV-1a over the address, split in two halves for double hashing
+static void bloom_filter_hashes(flex_trit_t const *const address,
+                                uint32_t *const h1, uint32_t *const h2) {
+  uint64_t hash = 14695981039346656037ULL;
+
+  for (size_t i = 0; i < FLEX_TRIT_SIZE_243; i++) {
+    hash ^= (uint8_t)address[i];
+    hash *= 1099511628211ULL;
+  }
+  *h1 = (uint32_t)hash;
+  *h2 = (uint32_t)(hash >> 32) | 1;
+}
+
+static void bloom_filter_add(uint64_t *const bloom_filter,
+                             flex_trit_t const *const address) {
+  uint32_t h1 = 0, h2 = 0;
+  size_t bit = 0;
+
+  bloom_filter_hashes(address, &h1, &h2);
+  for (size_t i = 0; i < SPENT_ADDRESSES_BLOOM_FILTER_NUM_HASHES; i++) {
+    bit = (h1 + i * h2) % SPENT_ADDRESSES_BLOOM_FILTER_SIZE;
+    bloom_filter[bit / 64] |= 1ULL << (bit % 64);
+  }
+}
+
+static bool bloom_filter_may_contain(uint64_t const *const bloom_filter,
+                                     flex_trit_t const *const address) {
+  uint32_t h1 = 0, h2 = 0;
+  size_t bit = 0;
+
+  bloom_filter_hashes(address, &h1, &h2);
+  for (size_t i = 0; i < SPENT_ADDRESSES_BLOOM_FILTER_NUM_HASHES; i++) {
+    bit = (h1 + i * h2) % SPENT_ADDRESSES_BLOOM_FILTER_SIZE;
+    if ((bloom_filter[bit / 64] & (1ULL << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t iota_spent_addresses_provider_init(
+    spent_addresses_provider_t *const sap, tangle_t const *const tangle) {
+  retcode_t ret = RC_OK;
+  iota_stor_pack_t pack;
+
+  if (sap == NULL) {
+    return RC_SPENT_ADDRESSES_PROVIDER_NULL_SELF;
+  }
+
+  logger_id = logger_helper_enable(SPENT_ADDRESSES_PROVIDER_LOGGER_ID,
+                                   LOGGER_DEBUG, true);
+  rw_lock_handle_init(&sap->rw_lock);
+  if ((sap->bloom_filter = (uint64_t *)calloc(
+           SPENT_ADDRESSES_BLOOM_FILTER_SIZE / 64, sizeof(uint64_t))) ==
+      NULL) {
+    ret = RC_SPENT_ADDRESSES_PROVIDER_OOM;
+    goto failed;
+  }
+
+  if ((ret = hash_pack_init(&pack, SPENT_ADDRESSES_LOAD_PACK_SIZE)) != RC_OK) {
+    goto failed;
+  }
+  // The pack grows until every spent address fits, a partially seeded bloom
+  // filter would answer that spent addresses are not
+  if ((ret = iota_tangle_spent_addresses_load(tangle, &pack)) != RC_OK) {
+    log_critical(logger_id, "Loading spent addresses failed\n");
+    goto done;
+  }
+  if (pack.insufficient_capacity) {
+    log_critical(logger_id, "Loading spent addresses was incomplete\n");
+    ret = RC_SPENT_ADDRESSES_PROVIDER_OOM;
+    goto done;
+  }
+  for (size_t i = 0; i < pack.num_loaded; i++) {
+    bloom_filter_add(sap->bloom_filter, (flex_trit_t *)pack.models[i]);
+  }
+  log_info(logger_id, "Loaded %ld spent addresses\n", pack.num_loaded);
+
+done:
+  hash_pack_free(&pack);
+
+failed:
+  if (ret != RC_OK) {
+    free(sap->bloom_filter);
+    sap->bloom_filter = NULL;
+    rw_lock_handle_destroy(&sap->rw_lock);
+    logger_helper_release(logger_id);
+  }
+  return ret;
+}
+
+retcode_t iota_spent_addresses_provider_destroy(
+    spent_addresses_provider_t *const sap) {
+  if (sap == NULL) {
+    return RC_SPENT_ADDRESSES_PROVIDER_NULL_SELF;
+  }
+
+  free(sap->bloom_filter);
+  sap->bloom_filter = NULL;
+  rw_lock_handle_destroy(&sap->rw_lock);
+  logger_helper_release(logger_id);
+  return RC_OK;
+}
+
+retcode_t iota_spent_addresses_provider_store(
+    spent_addresses_provider_t *const sap, tangle_t const *const tangle,
+    flex_trit_t const *const address) {
+  retcode_t ret = RC_OK;
+
+  if (sap == NULL) {
+    return RC_SPENT_ADDRESSES_PROVIDER_NULL_SELF;
+  }
+
+  // Persisted first so that a positive bloom filter answer can always be
+  // confirmed by the storage
+  if ((ret = iota_tangle_spent_address_store(tangle, address)) != RC_OK) {
+    return ret;
+  }
+
+  rw_lock_handle_wrlock(&sap->rw_lock);
+  bloom_filter_add(sap->bloom_filter, address);
+  rw_lock_handle_unlock(&sap->rw_lock);
+
+  return ret;
+}
+
+retcode_t iota_spent_addresses_provider_batch_store(
+    spent_addresses_provider_t *const sap, tangle_t const *const tangle,
+    hash243_set_t const addresses) {
+  retcode_t ret = RC_OK;
+  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+
+  if (sap == NULL) {
+    return RC_SPENT_ADDRESSES_PROVIDER_NULL_SELF;
+  } else if (hash243_set_size(&addresses) == 0) {
+    return RC_OK;
+  }
+
+  if ((ret = iota_tangle_spent_addresses_store(tangle, addresses)) != RC_OK) {
+    return ret;
+  }
+
+  rw_lock_handle_wrlock(&sap->rw_lock);
+  HASH_ITER(hh, addresses, iter, tmp) {
+    bloom_filter_add(sap->bloom_filter, iter->hash);
+  }
+  rw_lock_handle_unlock(&sap->rw_lock);
+
+  return ret;
+}
+
+retcode_t iota_spent_addresses_provider_contains(
+    spent_addresses_provider_t *const sap, tangle_t const *const tangle,
+    flex_trit_t const *const address, bool *const spent) {
+  bool may_contain = false;
+
+  if (sap == NULL) {
+    return RC_SPENT_ADDRESSES_PROVIDER_NULL_SELF;
+  }
+
+  rw_lock_handle_rdlock(&sap->rw_lock);
+  may_contain = bloom_filter_may_contain(sap->bloom_filter, address);
+  rw_lock_handle_unlock(&sap->rw_lock);
+
+  if (!may_contain) {
+    *spent = false;
+    return RC_OK;
+  }
+
+  return iota_tangle_spent_address_exist(tangle, address, spent);
+}
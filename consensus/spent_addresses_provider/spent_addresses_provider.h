@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_SPENT_ADDRESSES_PROVIDER_SPENT_ADDRESSES_PROVIDER_H__
+#define __CONSENSUS_SPENT_ADDRESSES_PROVIDER_SPENT_ADDRESSES_PROVIDER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "common/trinary/flex_trit.h"
+#include "consensus/tangle/tangle.h"
+#include "utils/containers/hash/hash243_set.h"
+#include "utils/handles/rw_lock.h"
+
+// Number of bits of the bloom filter, 2MB
+#define SPENT_ADDRESSES_BLOOM_FILTER_SIZE (1 << 24)
+// Number of bits set per address in the bloom filter
+#define SPENT_ADDRESSES_BLOOM_FILTER_NUM_HASHES 4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Keeps track of every address that has ever been spent from.
+ * Addresses are persisted in the storage and mirrored in an in-memory bloom
+ * filter so that lookups of addresses that were never spent from - the vast
+ * majority - never hit the storage.
+ */
+typedef struct spent_addresses_provider_s {
+  rw_lock_handle_t rw_lock;
+  uint64_t *bloom_filter;
+} spent_addresses_provider_t;
+
+/**
+ * Initializes a spent addresses provider and fills its bloom filter with the
+ * spent addresses already persisted in the storage
+ *
+ * @param sap The spent addresses provider
+ * @param tangle A tangle
+ *
+ * @return a status code
+ */
+retcode_t iota_spent_addresses_provider_init(
+    spent_addresses_provider_t *const sap, tangle_t const *const tangle);
+
+/**
+ * Destroys a spent addresses provider
+ *
+ * @param sap The spent addresses provider
+ *
+ * @return a status code
+ */
+retcode_t iota_spent_addresses_provider_destroy(
+    spent_addresses_provider_t *const sap);
+
+/**
+ * Marks an address as spent
+ *
+ * @param sap The spent addresses provider
+ * @param tangle A tangle
+ * @param address The address
+ *
+ * @return a status code
+ */
+retcode_t iota_spent_addresses_provider_store(
+    spent_addresses_provider_t *const sap, tangle_t const *const tangle,
+    flex_trit_t const *const address);
+
+/**
+ * Marks a batch of addresses as spent in a single storage transaction
+ *
+ * @param sap The spent addresses provider
+ * @param tangle A tangle
+ * @param addresses The addresses
+ *
+ * @return a status code
+ */
+retcode_t iota_spent_addresses_provider_batch_store(
+    spent_addresses_provider_t *const sap, tangle_t const *const tangle,
+    hash243_set_t const addresses);
+
+/**
+ * Checks if an address was spent from
+ *
+ * @param sap The spent addresses provider
+ * @param tangle A tangle
+ * @param address The address
+ * @param spent Whether the address was spent from or not
+ *
+ * @return a status code
+ */
+retcode_t iota_spent_addresses_provider_contains(
+    spent_addresses_provider_t *const sap, tangle_t const *const tangle,
+    flex_trit_t const *const address, bool *const spent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_SPENT_ADDRESSES_PROVIDER_SPENT_ADDRESSES_PROVIDER_H__
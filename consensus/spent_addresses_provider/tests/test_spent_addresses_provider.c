@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "common/helpers/digest.h"
+#include "consensus/spent_addresses_provider/spent_addresses_provider.h"
+#include "consensus/test_utils/tangle.h"
+
+// More than a single load pack so that reloading has to grow it
+#define NUM_ADDRESSES 2500
+
+static char *test_db_path =
+    "consensus/spent_addresses_provider/tests/test.db";
+static char *ciri_db_path =
+    "consensus/spent_addresses_provider/tests/ciri.db";
+static connection_config_t config;
+static tangle_t tangle;
+static spent_addresses_provider_t sap;
+static flex_trit_t addresses[NUM_ADDRESSES][FLEX_TRIT_SIZE_243];
+
+void setUp(void) {
+  TEST_ASSERT(tangle_setup(&tangle, &config, test_db_path, ciri_db_path) ==
+              RC_OK);
+  TEST_ASSERT(iota_spent_addresses_provider_init(&sap, &tangle) == RC_OK);
+}
+
+void tearDown(void) {
+  TEST_ASSERT(iota_spent_addresses_provider_destroy(&sap) == RC_OK);
+  TEST_ASSERT(tangle_cleanup(&tangle, test_db_path) == RC_OK);
+}
+
+static void addresses_init() {
+  trit_t trits[HASH_LENGTH_TRIT] = {1};
+  flex_trit_t *hashed_hash = NULL;
+
+  flex_trits_from_trits(addresses[0], HASH_LENGTH_TRIT, trits,
+                        HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+  for (size_t i = 1; i < NUM_ADDRESSES; i++) {
+    hashed_hash = iota_flex_digest(addresses[i - 1], HASH_LENGTH_TRIT);
+    memcpy(addresses[i], hashed_hash, FLEX_TRIT_SIZE_243);
+    free(hashed_hash);
+  }
+}
+
+void test_spent_addresses_provider_empty(void) {
+  bool spent = true;
+
+  for (size_t i = 0; i < NUM_ADDRESSES; i++) {
+    TEST_ASSERT(iota_spent_addresses_provider_contains(
+                    &sap, &tangle, addresses[i], &spent) == RC_OK);
+    TEST_ASSERT_FALSE(spent);
+  }
+}
+
+void test_spent_addresses_provider_store(void) {
+  bool spent = false;
+
+  for (size_t i = 0; i < NUM_ADDRESSES; i += 2) {
+    TEST_ASSERT(iota_spent_addresses_provider_store(&sap, &tangle,
+                                                    addresses[i]) == RC_OK);
+  }
+  // Storing twice is a no-op
+  TEST_ASSERT(iota_spent_addresses_provider_store(&sap, &tangle,
+                                                  addresses[0]) == RC_OK);
+
+  for (size_t i = 0; i < NUM_ADDRESSES; i++) {
+    TEST_ASSERT(iota_spent_addresses_provider_contains(
+                    &sap, &tangle, addresses[i], &spent) == RC_OK);
+    TEST_ASSERT_EQUAL(i % 2 == 0, spent);
+  }
+}
+
+void test_spent_addresses_provider_batch_store_and_reload(void) {
+  hash243_set_t set = NULL;
+  bool spent = false;
+
+  for (size_t i = 1; i < NUM_ADDRESSES; i += 2) {
+    TEST_ASSERT(hash243_set_add(&set, addresses[i]) == RC_OK);
+  }
+  TEST_ASSERT(iota_spent_addresses_provider_batch_store(&sap, &tangle, set) ==
+              RC_OK);
+  hash243_set_free(&set);
+
+  // The bloom filter has to be rebuilt from the storage
+  TEST_ASSERT(iota_spent_addresses_provider_destroy(&sap) == RC_OK);
+  TEST_ASSERT(iota_spent_addresses_provider_init(&sap, &tangle) == RC_OK);
+
+  for (size_t i = 0; i < NUM_ADDRESSES; i++) {
+    TEST_ASSERT(iota_spent_addresses_provider_contains(
+                    &sap, &tangle, addresses[i], &spent) == RC_OK);
+    TEST_ASSERT_EQUAL(i % 2 == 1, spent);
+  }
+}
+
+void test_spent_addresses_provider_reload_all(void) {
+  hash243_set_t set = NULL;
+  bool spent = false;
+
+  for (size_t i = 0; i < NUM_ADDRESSES; i++) {
+    TEST_ASSERT(hash243_set_add(&set, addresses[i]) == RC_OK);
+  }
+  TEST_ASSERT(iota_spent_addresses_provider_batch_store(&sap, &tangle, set) ==
+              RC_OK);
+  hash243_set_free(&set);
+
+  TEST_ASSERT(iota_spent_addresses_provider_destroy(&sap) == RC_OK);
+  TEST_ASSERT(iota_spent_addresses_provider_init(&sap, &tangle) == RC_OK);
+
+  // Every address has to be found by the bloom filter, a miss is never
+  // confirmed by the storage
+  for (size_t i = 0; i < NUM_ADDRESSES; i++) {
+    TEST_ASSERT(iota_spent_addresses_provider_contains(
+                    &sap, &tangle, addresses[i], &spent) == RC_OK);
+    TEST_ASSERT_TRUE(spent);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  config.db_path = test_db_path;
+  TEST_ASSERT(storage_init() == RC_OK);
+  addresses_init();
+
+  RUN_TEST(test_spent_addresses_provider_empty);
+  RUN_TEST(test_spent_addresses_provider_store);
+  RUN_TEST(test_spent_addresses_provider_batch_store_and_reload);
+  RUN_TEST(test_spent_addresses_provider_reload_all);
+
+  TEST_ASSERT(storage_destroy() == RC_OK);
+  return UNITY_END();
+}
@@ -6,6 +6,7 @@
  */
 
 #include <inttypes.h>
+#include <string.h>
 
 #include "consensus/tangle/tangle.h"
 #include "utils/logger_helper.h"
@@ -13,6 +14,92 @@
 #define TANGLE_LOGGER_ID "tangle"
 
 static logger_id_t logger_id;
+static transaction_cache_t transaction_cache;
+static bool transaction_cache_enabled = false;
+
+typedef retcode_t (*transaction_loader_t)(
+    storage_connection_t const *const connection,
+    flex_trit_t const *const hash, iota_stor_pack_t *const pack);
+
+/*
+ * Private functions
+ */
+
+static field_mask_t partial_model_mask(
+    partial_transaction_model_e const model) {
+  field_mask_t mask = {0};
+
+  switch (model) {
+    case PARTIAL_TX_MODEL_METADATA:
+      mask.metadata = MASK_METADATA_ALL;
+      break;
+    case PARTIAL_TX_MODEL_ESSENCE_METADATA:
+      mask.essence = MASK_ESSENCE_ALL;
+      mask.metadata = MASK_METADATA_SNAPSHOT_INDEX | MASK_METADATA_SOLID;
+      break;
+    case PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA:
+      mask.essence = MASK_ESSENCE_ALL;
+      mask.attachment = MASK_ATTACHMENT_ALL;
+      mask.metadata = MASK_METADATA_ALL;
+      break;
+    case PARTIAL_TX_MODEL_ESSENCE_CONSENSUS:
+      mask.essence = MASK_ESSENCE_ALL;
+      mask.consensus = MASK_CONSENSUS_ALL;
+      break;
+    case PARTIAL_TX_MODEL_SIGNATURE:
+      mask.data = MASK_DATA_ALL;
+      break;
+  }
+
+  return mask;
+}
+
+static retcode_t transaction_load_by_hash(
+    storage_connection_t const *const connection,
+    flex_trit_t const *const hash, iota_stor_pack_t *const pack) {
+  return iota_stor_transaction_load(connection, TRANSACTION_FIELD_HASH, hash,
+                                    pack);
+}
+
+/**
+ * Serves a load from the transaction cache when all the requested columns are
+ * cached, otherwise loads from the storage and caches the result
+ */
+static retcode_t transaction_load_cached(tangle_t const *const tangle,
+                                         flex_trit_t const *const hash,
+                                         iota_stor_pack_t *const pack,
+                                         field_mask_t const *const mask,
+                                         transaction_loader_t const loader) {
+  retcode_t ret = RC_OK;
+  iota_transaction_t *tx = NULL;
+  size_t const num_loaded = pack->num_loaded;
+  uint64_t epoch = 0;
+
+  if (!transaction_cache_enabled || num_loaded == pack->capacity) {
+    return loader(&tangle->connection, hash, pack);
+  }
+
+  tx = (iota_transaction_t *)pack->models[num_loaded];
+  if (iota_transaction_cache_get(&transaction_cache, hash, mask, tx, &epoch)) {
+    pack->num_loaded++;
+    pack->insufficient_capacity = false;
+    return RC_OK;
+  }
+
+  if ((ret = loader(&tangle->connection, hash, pack)) == RC_OK &&
+      pack->num_loaded > num_loaded) {
+    if (iota_transaction_cache_put(&transaction_cache, hash, mask, tx,
+                                   epoch) != RC_OK) {
+      log_warning(logger_id, "Caching transaction failed\n");
+    }
+  }
+
+  return ret;
+}
+
+/*
+ * Public functions
+ */
 
 retcode_t iota_tangle_init(tangle_t *const tangle,
                            connection_config_t const *const conf) {
@@ -25,6 +112,42 @@ retcode_t iota_tangle_destroy(tangle_t *const tangle) {
   return connection_destroy(&tangle->connection);
 }
 
+/*
+ * Transaction cache operations
+ */
+
+retcode_t iota_tangle_cache_init(size_t const capacity) {
+  retcode_t ret = RC_OK;
+
+  if (capacity == 0 || transaction_cache_enabled) {
+    return RC_OK;
+  }
+
+  if ((ret = iota_transaction_cache_init(&transaction_cache, capacity)) ==
+      RC_OK) {
+    transaction_cache_enabled = true;
+  }
+
+  return ret;
+}
+
+retcode_t iota_tangle_cache_destroy() {
+  if (!transaction_cache_enabled) {
+    return RC_OK;
+  }
+
+  transaction_cache_enabled = false;
+  return iota_transaction_cache_destroy(&transaction_cache);
+}
+
+void iota_tangle_cache_stats(transaction_cache_stats_t *const stats) {
+  if (transaction_cache_enabled) {
+    iota_transaction_cache_stats(&transaction_cache, stats);
+  } else {
+    memset(stats, 0, sizeof(transaction_cache_stats_t));
+  }
+}
+
 /*
  * Transaction operations
  */
@@ -36,28 +159,73 @@ retcode_t iota_tangle_transaction_count(tangle_t const *const tangle,
 
 retcode_t iota_tangle_transaction_store(tangle_t const *const tangle,
                                         iota_transaction_t const *const tx) {
-  return iota_stor_transaction_store(&tangle->connection, tx);
+  retcode_t ret = RC_OK;
+  // Metadata columns are not stored, they are set by the database
+  field_mask_t const mask = {.essence = MASK_ESSENCE_ALL,
+                             .attachment = MASK_ATTACHMENT_ALL,
+                             .consensus = MASK_CONSENSUS_ALL,
+                             .data = MASK_DATA_ALL};
+  uint64_t epoch = 0;
+
+  if (transaction_cache_enabled) {
+    epoch = iota_transaction_cache_epoch(&transaction_cache,
+                                         transaction_hash(tx));
+  }
+
+  if ((ret = iota_stor_transaction_store(&tangle->connection, tx)) != RC_OK) {
+    return ret;
+  }
+
+  if (transaction_cache_enabled &&
+      iota_transaction_cache_put(&transaction_cache, transaction_hash(tx),
+                                 &mask, tx, epoch) != RC_OK) {
+    log_warning(logger_id, "Caching transaction failed\n");
+  }
+
+  return ret;
 }
 
 retcode_t iota_tangle_transaction_load(tangle_t const *const tangle,
                                        transaction_field_t const field,
                                        flex_trit_t const *const key,
                                        iota_stor_pack_t *const tx) {
-  return iota_stor_transaction_load(&tangle->connection, field, key, tx);
+  field_mask_t const mask = {.essence = MASK_ESSENCE_ALL,
+                             .attachment = MASK_ATTACHMENT_ALL,
+                             .consensus = MASK_CONSENSUS_ALL,
+                             .data = MASK_DATA_ALL};
+
+  if (field != TRANSACTION_FIELD_HASH) {
+    return iota_stor_transaction_load(&tangle->connection, field, key, tx);
+  }
+
+  return transaction_load_cached(tangle, key, tx, &mask,
+                                 transaction_load_by_hash);
 }
 
 retcode_t iota_tangle_transaction_update_solid_state(
     tangle_t const *const tangle, flex_trit_t const *const hash,
     bool const state) {
-  return iota_stor_transaction_update_solid_state(&tangle->connection, hash,
-                                                  state);
+  retcode_t ret =
+      iota_stor_transaction_update_solid_state(&tangle->connection, hash, state);
+
+  if (transaction_cache_enabled) {
+    iota_transaction_cache_invalidate_metadata(&transaction_cache, hash);
+  }
+
+  return ret;
 }
 
 retcode_t iota_tangle_transactions_update_solid_state(
     tangle_t const *const tangle, hash243_set_t const hashes,
     bool const is_solid) {
-  return iota_stor_transactions_update_solid_state(&tangle->connection, hashes,
-                                                   is_solid);
+  retcode_t ret = iota_stor_transactions_update_solid_state(&tangle->connection,
+                                                            hashes, is_solid);
+
+  if (transaction_cache_enabled) {
+    iota_transaction_cache_invalidate_metadata_set(&transaction_cache, hashes);
+  }
+
+  return ret;
 }
 
 retcode_t iota_tangle_transaction_load_hashes_of_approvers(
@@ -85,23 +253,43 @@ retcode_t iota_tangle_transaction_load_hashes_of_approvers(
   return res;
 }
 
+retcode_t iota_tangle_transaction_cursor_hashes_of_approvers(
+    tangle_t const *const tangle, flex_trit_t const *const approvee_hash,
+    int64_t const before_timestamp, iota_stor_cursor_t *const cursor) {
+  retcode_t res = iota_stor_transaction_cursor_hashes_of_approvers(
+      &tangle->connection, approvee_hash, before_timestamp, cursor);
+
+  if (res != RC_OK) {
+    log_error(logger_id,
+              "Failed in opening approvers cursor, error code is: %" PRIu64
+              "\n",
+              res);
+  }
+
+  return res;
+}
+
 retcode_t iota_tangle_transaction_load_partial(
     tangle_t const *const tangle, flex_trit_t const *const hash,
     iota_stor_pack_t *const pack, partial_transaction_model_e models_mask) {
+  transaction_loader_t loader = NULL;
+  field_mask_t mask = partial_model_mask(models_mask);
+
   if (models_mask == PARTIAL_TX_MODEL_METADATA) {
-    return iota_stor_transaction_load_metadata(&tangle->connection, hash, pack);
+    loader = iota_stor_transaction_load_metadata;
   } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_METADATA) {
-    return iota_stor_transaction_load_essence_and_metadata(&tangle->connection,
-                                                           hash, pack);
+    loader = iota_stor_transaction_load_essence_and_metadata;
   } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA) {
-    return iota_stor_transaction_load_essence_attachment_and_metadata(
-        &tangle->connection, hash, pack);
+    loader = iota_stor_transaction_load_essence_attachment_and_metadata;
   } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_CONSENSUS) {
-    return iota_stor_transaction_load_essence_and_consensus(&tangle->connection,
-                                                            hash, pack);
+    loader = iota_stor_transaction_load_essence_and_consensus;
+  } else if (models_mask == PARTIAL_TX_MODEL_SIGNATURE) {
+    loader = iota_stor_transaction_load_signature;
   } else {
     return RC_CONSENSUS_NOT_IMPLEMENTED;
   }
+
+  return transaction_load_cached(tangle, hash, pack, &mask, loader);
 }
 
 retcode_t iota_tangle_transaction_load_hashes_of_requests(
@@ -180,18 +368,71 @@ retcode_t iota_tangle_transaction_load_hashes_of_milestone_candidates(
   return res;
 }
 
+retcode_t iota_tangle_transaction_load_hashes_of_solid_entry_points(
+    tangle_t const *const tangle, uint64_t const snapshot_index,
+    iota_stor_pack_t *const pack) {
+  retcode_t res = RC_OK;
+
+  res = iota_stor_transaction_load_hashes_of_solid_entry_points(
+      &tangle->connection, snapshot_index, pack);
+
+  while (res == RC_OK && pack->insufficient_capacity) {
+    if ((res = hash_pack_resize(pack, 2)) == RC_OK) {
+      pack->num_loaded = 0;
+      res = iota_stor_transaction_load_hashes_of_solid_entry_points(
+          &tangle->connection, snapshot_index, pack);
+    }
+  }
+
+  if (res != RC_OK) {
+    log_error(logger_id,
+              "Failed in loading hashes of solid entry points, error code "
+              "is: %" PRIu64 "\n",
+              res);
+  }
+
+  return res;
+}
+
+retcode_t iota_tangle_transactions_prune(tangle_t const *const tangle,
+                                         uint64_t const snapshot_index,
+                                         size_t const limit,
+                                         size_t *const count) {
+  retcode_t ret = iota_stor_transactions_prune(&tangle->connection,
+                                               snapshot_index, limit, count);
+
+  // Deleted hashes are not known here, the whole cache goes
+  if (transaction_cache_enabled && *count > 0) {
+    iota_transaction_cache_clear(&transaction_cache);
+  }
+
+  return ret;
+}
+
 retcode_t iota_tangle_transaction_update_snapshot_index(
     tangle_t const *const tangle, flex_trit_t const *const hash,
     uint64_t const snapshot_index) {
-  return iota_stor_transaction_update_snapshot_index(&tangle->connection, hash,
-                                                     snapshot_index);
+  retcode_t ret = iota_stor_transaction_update_snapshot_index(
+      &tangle->connection, hash, snapshot_index);
+
+  if (transaction_cache_enabled) {
+    iota_transaction_cache_invalidate_metadata(&transaction_cache, hash);
+  }
+
+  return ret;
 }
 
 retcode_t iota_tangle_transactions_update_snapshot_index(
     tangle_t const *const tangle, hash243_set_t const hashes,
     uint64_t const snapshot_index) {
-  return iota_stor_transactions_update_snapshot_index(&tangle->connection,
-                                                      hashes, snapshot_index);
+  retcode_t ret = iota_stor_transactions_update_snapshot_index(
+      &tangle->connection, hashes, snapshot_index);
+
+  if (transaction_cache_enabled) {
+    iota_transaction_cache_invalidate_metadata_set(&transaction_cache, hashes);
+  }
+
+  return ret;
 }
 
 retcode_t iota_tangle_transaction_exist(tangle_t const *const tangle,
@@ -255,6 +496,11 @@ retcode_t iota_tangle_milestone_exist(tangle_t const *const tangle,
   return iota_stor_milestone_exist(&tangle->connection, hash, exist);
 }
 
+retcode_t iota_tangle_milestones_delete(tangle_t const *const tangle,
+                                        uint64_t const index) {
+  return iota_stor_milestones_delete(&tangle->connection, index);
+}
+
 /*
  * Utilities
  */
@@ -266,7 +512,10 @@ retcode_t iota_tangle_find_tail(tangle_t const *const tangle,
   retcode_t res = RC_OK;
   iota_transaction_t next_tx_s;
   iota_transaction_t *next_tx = &next_tx_s;
+  iota_transaction_t *swap_tx = NULL;
   flex_trit_t bundle_hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t const *approver_hash = NULL;
+  iota_stor_cursor_t cursor;
   bool found_approver = false;
   DECLARE_PACK_SINGLE_TX(curr_tx_s, curr_tx, tx_pack);
 
@@ -281,41 +530,38 @@ retcode_t iota_tangle_find_tail(tangle_t const *const tangle,
   uint32_t index = transaction_current_index(curr_tx);
   memcpy(bundle_hash, transaction_bundle(curr_tx), FLEX_TRIT_SIZE_243);
 
-  iota_stor_pack_t hash_pack;
-  if ((res = hash_pack_init(&hash_pack, 10)) != RC_OK) {
-    return res;
-  }
-
   while (res == RC_OK && index > 0 &&
          memcmp(transaction_bundle(curr_tx), bundle_hash, FLEX_TRIT_SIZE_243) ==
              0) {
-    hash_pack_reset(&hash_pack);
-    if ((res = iota_tangle_transaction_load_hashes_of_approvers(
-             tangle, transaction_hash(curr_tx), &hash_pack, 0)) != RC_OK) {
+    if ((res = iota_tangle_transaction_cursor_hashes_of_approvers(
+             tangle, transaction_hash(curr_tx), 0, &cursor)) != RC_OK) {
       break;
     }
 
     --index;
-    uint32_t approver_idx = 0;
     found_approver = false;
-    while (approver_idx < hash_pack.num_loaded) {
-      flex_trit_t *approver_hash =
-          (flex_trit_t *)hash_pack.models[approver_idx];
+    while ((res = iota_stor_cursor_next(&cursor, &approver_hash)) == RC_OK &&
+           approver_hash != NULL) {
       tx_pack.models = (void **)(&next_tx);
       hash_pack_reset(&tx_pack);
-      res = iota_tangle_transaction_load_partial(
-          tangle, approver_hash, &tx_pack, PARTIAL_TX_MODEL_ESSENCE_CONSENSUS);
-      if (res != RC_OK || tx_pack.num_loaded == 0) {
+      if ((res = iota_tangle_transaction_load_partial(
+               tangle, approver_hash, &tx_pack,
+               PARTIAL_TX_MODEL_ESSENCE_CONSENSUS)) != RC_OK) {
         break;
       }
-      if (transaction_current_index(next_tx) == index &&
+      if (tx_pack.num_loaded != 0 &&
+          transaction_current_index(next_tx) == index &&
           memcmp(transaction_bundle(next_tx), bundle_hash,
                  FLEX_TRIT_SIZE_243) == 0) {
+        // Swapping keeps the next candidate from overwriting the current one
+        swap_tx = curr_tx;
         curr_tx = next_tx;
+        next_tx = swap_tx;
         found_approver = true;
         break;
       }
     }
+    iota_stor_cursor_close(&cursor);
 
     if (!found_approver) {
       break;
@@ -327,8 +573,6 @@ retcode_t iota_tangle_find_tail(tangle_t const *const tangle,
     *found_tail = true;
   }
 
-  hash_pack_free(&hash_pack);
-
   return res;
 }
 
@@ -347,3 +591,75 @@ retcode_t iota_tangle_state_delta_load(tangle_t const *const tangle,
                                        state_delta_t *const delta) {
   return iota_stor_state_delta_load(&tangle->connection, index, delta);
 }
+
+retcode_t iota_tangle_state_delta_load_serialized(tangle_t const *const tangle,
+                                                  uint64_t const index,
+                                                  byte_t **const bytes,
+                                                  size_t *const size) {
+  return iota_stor_state_delta_load_serialized(&tangle->connection, index,
+                                               bytes, size);
+}
+
+/*
+ * Ledger checkpoint operations
+ */
+
+retcode_t iota_tangle_ledger_checkpoint_store(tangle_t const *const tangle,
+                                              uint64_t const index,
+                                              flex_trit_t const *const hash,
+                                              state_delta_t const *const state,
+                                              size_t const kept) {
+  return iota_stor_ledger_checkpoint_store(&tangle->connection, index, hash,
+                                           state, kept);
+}
+
+retcode_t iota_tangle_ledger_checkpoint_load_latest(
+    tangle_t const *const tangle, uint64_t const below_index,
+    uint64_t *const index, flex_trit_t *const hash, state_delta_t *const state) {
+  return iota_stor_ledger_checkpoint_load_latest(&tangle->connection,
+                                                 below_index, index, hash,
+                                                 state);
+}
+
+/*
+ * Spent address operations
+ */
+
+retcode_t iota_tangle_spent_address_store(tangle_t const *const tangle,
+                                          flex_trit_t const *const address) {
+  return iota_stor_spent_address_store(&tangle->connection, address);
+}
+
+retcode_t iota_tangle_spent_addresses_store(tangle_t const *const tangle,
+                                            hash243_set_t const addresses) {
+  return iota_stor_spent_addresses_store(&tangle->connection, addresses);
+}
+
+retcode_t iota_tangle_spent_address_exist(tangle_t const *const tangle,
+                                          flex_trit_t const *const address,
+                                          bool *const exist) {
+  return iota_stor_spent_address_exist(&tangle->connection, address, exist);
+}
+
+retcode_t iota_tangle_spent_addresses_load(tangle_t const *const tangle,
+                                           iota_stor_pack_t *const pack) {
+  retcode_t res = RC_OK;
+
+  res = iota_stor_spent_addresses_load(&tangle->connection, pack);
+
+  while (res == RC_OK && pack->insufficient_capacity) {
+    if ((res = hash_pack_resize(pack, 2)) == RC_OK) {
+      pack->num_loaded = 0;
+      res = iota_stor_spent_addresses_load(&tangle->connection, pack);
+    }
+  }
+
+  if (res != RC_OK) {
+    log_error(logger_id,
+              "Failed in loading spent addresses, error code is: %" PRIu64
+              "\n",
+              res);
+  }
+
+  return res;
+}
@@ -18,6 +18,7 @@
 #include "common/storage/storage.h"
 #include "common/trinary/flex_trit.h"
 #include "consensus/snapshot/state_delta.h"
+#include "consensus/tangle/transaction_cache.h"
 #include "utils/containers/hash/hash243_queue.h"
 #include "utils/containers/hash/hash243_set.h"
 #include "utils/containers/hash/hash81_queue.h"
@@ -36,6 +37,7 @@ typedef enum _partial_transaction_model {
   PARTIAL_TX_MODEL_ESSENCE_METADATA,
   PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA,
   PARTIAL_TX_MODEL_ESSENCE_CONSENSUS,
+  PARTIAL_TX_MODEL_SIGNATURE,
 } partial_transaction_model_e;
 
 retcode_t iota_tangle_init(tangle_t *const tangle,
@@ -43,6 +45,34 @@ retcode_t iota_tangle_init(tangle_t *const tangle,
 
 retcode_t iota_tangle_destroy(tangle_t *const tangle);
 
+/*
+ * Transaction cache operations
+ */
+
+/**
+ * Enables the process-wide cache of decoded transactions shared by all tangle
+ * connections. Must be called before any tangle is used concurrently.
+ *
+ * @param capacity The maximum number of cached transactions, 0 disables it
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_cache_init(size_t const capacity);
+
+/**
+ * Disables and empties the process-wide cache of decoded transactions
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_cache_destroy();
+
+/**
+ * Gets the hits, misses and evictions of the transaction cache
+ *
+ * @param stats The statistics, zeroed if the cache is disabled
+ */
+void iota_tangle_cache_stats(transaction_cache_stats_t *const stats);
+
 /*
  * Transaction operations
  */
@@ -62,6 +92,22 @@ retcode_t iota_tangle_transaction_load_hashes_of_approvers(
     tangle_t const *const tangle, flex_trit_t const *const approvee_hash,
     iota_stor_pack_t *const pack, int64_t before_timestamp);
 
+/**
+ * Opens a cursor over the hashes of the approvers of a transaction, to be
+ * walked with iota_stor_cursor_next and closed with iota_stor_cursor_close
+ *
+ * @param tangle The tangle
+ * @param approvee_hash The hash of the approved transaction
+ * @param before_timestamp Only approvers attached before it are yielded, 0 to
+ * yield all of them
+ * @param cursor The cursor to open
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_transaction_cursor_hashes_of_approvers(
+    tangle_t const *const tangle, flex_trit_t const *const approvee_hash,
+    int64_t const before_timestamp, iota_stor_cursor_t *const cursor);
+
 /**
  * Loads partial transaction data - (contains metadata)
  *
@@ -115,6 +161,37 @@ retcode_t iota_tangle_transaction_load_hashes_of_milestone_candidates(
     tangle_t const *const tangle, iota_stor_pack_t *const pack,
     flex_trit_t const *const coordinator);
 
+/**
+ * Loads hashes of the transactions confirmed by a milestone up to a snapshot
+ * index that are still referenced by transactions confirmed afterwards or not
+ * confirmed yet
+ *
+ * @param tangle The tangle
+ * @param snapshot_index The snapshot index
+ * @param pack A pack to be filled with hashes
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_transaction_load_hashes_of_solid_entry_points(
+    tangle_t const *const tangle, uint64_t const snapshot_index,
+    iota_stor_pack_t *const pack);
+
+/**
+ * Deletes a batch of transactions confirmed by a milestone up to a snapshot
+ * index, solid entry points excepted
+ *
+ * @param tangle The tangle
+ * @param snapshot_index The snapshot index
+ * @param limit The maximum number of transactions to delete
+ * @param count The number of transactions deleted
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_transactions_prune(tangle_t const *const tangle,
+                                         uint64_t const snapshot_index,
+                                         size_t const limit,
+                                         size_t *const count);
+
 retcode_t iota_tangle_transaction_update_snapshot_index(
     tangle_t const *const tangle, flex_trit_t const *const hash,
     uint64_t const snapshot_index);
@@ -186,6 +263,17 @@ retcode_t iota_tangle_milestone_exist(tangle_t const *const tangle,
                                       flex_trit_t const *const hash,
                                       bool *const exist);
 
+/**
+ * Deletes milestones, and their state deltas, up to an index
+ *
+ * @param tangle The tangle
+ * @param index The index of the last milestone to delete
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_milestones_delete(tangle_t const *const tangle,
+                                        uint64_t const index);
+
 /*
  * State delta operations
  */
@@ -198,6 +286,76 @@ retcode_t iota_tangle_state_delta_load(tangle_t const *const tangle,
                                        uint64_t const index,
                                        state_delta_t *const delta);
 
+/**
+ * Loads the state delta of a milestone without deserializing it
+ *
+ * @param tangle The tangle
+ * @param index The milestone index
+ * @param bytes The serialized delta, NULL if there is none - Must be freed
+ * @param size The size of the serialized delta
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_state_delta_load_serialized(tangle_t const *const tangle,
+                                                  uint64_t const index,
+                                                  byte_t **const bytes,
+                                                  size_t *const size);
+
+/*
+ * Ledger checkpoint operations
+ */
+
+/**
+ * Stores a checkpoint of the ledger state at a milestone and deletes all but
+ * the most recent ones
+ *
+ * @param tangle The tangle
+ * @param index The milestone index
+ * @param hash The milestone hash
+ * @param state The ledger state at the milestone
+ * @param kept The number of most recent checkpoints to keep
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_ledger_checkpoint_store(tangle_t const *const tangle,
+                                              uint64_t const index,
+                                              flex_trit_t const *const hash,
+                                              state_delta_t const *const state,
+                                              size_t const kept);
+
+/**
+ * Loads the most recent checkpoint below an index whose milestone is still
+ * stored with the same hash
+ *
+ * @param tangle The tangle
+ * @param below_index Only checkpoints strictly below this index are considered
+ * @param index The milestone index, 0 if there is no such checkpoint
+ * @param hash The milestone hash
+ * @param state The ledger state at the milestone
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_ledger_checkpoint_load_latest(
+    tangle_t const *const tangle, uint64_t const below_index,
+    uint64_t *const index, flex_trit_t *const hash, state_delta_t *const state);
+
+/*
+ * Spent address operations
+ */
+
+retcode_t iota_tangle_spent_address_store(tangle_t const *const tangle,
+                                          flex_trit_t const *const address);
+
+retcode_t iota_tangle_spent_addresses_store(tangle_t const *const tangle,
+                                            hash243_set_t const addresses);
+
+retcode_t iota_tangle_spent_address_exist(tangle_t const *const tangle,
+                                          flex_trit_t const *const address,
+                                          bool *const exist);
+
+retcode_t iota_tangle_spent_addresses_load(tangle_t const *const tangle,
+                                           iota_stor_pack_t *const pack);
+
 /*
  * Utilities
  */
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "common/helpers/digest.h"
+#include "consensus/tangle/transaction_cache.h"
+
+#define NUM_HASHES 64
+#define CACHE_CAPACITY 16
+
+static transaction_cache_t cache;
+static flex_trit_t hashes[NUM_HASHES][FLEX_TRIT_SIZE_243];
+static field_mask_t const essence_consensus = {
+    .essence = MASK_ESSENCE_ALL, .consensus = MASK_CONSENSUS_ALL};
+static field_mask_t const metadata = {.metadata = MASK_METADATA_ALL};
+
+void setUp(void) {
+  TEST_ASSERT(iota_transaction_cache_init(&cache, CACHE_CAPACITY) == RC_OK);
+}
+
+void tearDown(void) {
+  TEST_ASSERT(iota_transaction_cache_destroy(&cache) == RC_OK);
+}
+
+static void hashes_init() {
+  trit_t trits[HASH_LENGTH_TRIT] = {1};
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t *hashed_hash = NULL;
+
+  flex_trits_from_trits(hash, HASH_LENGTH_TRIT, trits, HASH_LENGTH_TRIT,
+                        HASH_LENGTH_TRIT);
+  for (size_t i = 0; i < NUM_HASHES; i++) {
+    hashed_hash = iota_flex_digest(hash, HASH_LENGTH_TRIT);
+    memcpy(hash, hashed_hash, FLEX_TRIT_SIZE_243);
+    memcpy(hashes[i], hashed_hash, FLEX_TRIT_SIZE_243);
+    free(hashed_hash);
+  }
+}
+
+static void transaction_build(iota_transaction_t *const tx, size_t const i) {
+  transaction_reset(tx);
+  transaction_set_hash(tx, hashes[i]);
+  transaction_set_address(tx, hashes[(i + 1) % NUM_HASHES]);
+  transaction_set_bundle(tx, hashes[(i + 2) % NUM_HASHES]);
+  transaction_set_value(tx, i);
+  transaction_set_obsolete_tag(tx, hashes[i]);
+  transaction_set_timestamp(tx, i);
+  transaction_set_current_index(tx, 0);
+  transaction_set_last_index(tx, 0);
+}
+
+void test_transaction_cache_get_put(void) {
+  iota_transaction_t tx, cached_tx;
+  transaction_cache_stats_t stats;
+  uint64_t epoch = 0;
+
+  transaction_build(&tx, 0);
+
+  TEST_ASSERT_FALSE(iota_transaction_cache_get(&cache, hashes[0],
+                                               &essence_consensus, &cached_tx,
+                                               &epoch));
+  TEST_ASSERT(iota_transaction_cache_put(&cache, hashes[0], &essence_consensus,
+                                         &tx, epoch) == RC_OK);
+
+  memset(&cached_tx, 0, sizeof(iota_transaction_t));
+  TEST_ASSERT_TRUE(iota_transaction_cache_get(&cache, hashes[0],
+                                              &essence_consensus, &cached_tx,
+                                              &epoch));
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&tx), transaction_hash(&cached_tx),
+                           FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_bundle(&tx),
+                           transaction_bundle(&cached_tx), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_INT64(transaction_value(&tx), transaction_value(&cached_tx));
+
+  // Metadata was never cached
+  TEST_ASSERT_FALSE(iota_transaction_cache_get(&cache, hashes[0], &metadata,
+                                               &cached_tx, &epoch));
+
+  iota_transaction_cache_stats(&cache, &stats);
+  TEST_ASSERT_EQUAL_INT(1, stats.size);
+  TEST_ASSERT_EQUAL_INT(1, stats.hits);
+  TEST_ASSERT_EQUAL_INT(2, stats.misses);
+  TEST_ASSERT_EQUAL_INT(0, stats.evictions);
+}
+
+void test_transaction_cache_invalidate_metadata(void) {
+  iota_transaction_t tx, cached_tx;
+  uint64_t epoch = 0;
+  uint64_t stale_epoch = 0;
+
+  memset(&cached_tx, 0, sizeof(iota_transaction_t));
+  transaction_build(&tx, 1);
+  transaction_set_snapshot_index(&tx, 0);
+  transaction_set_solid(&tx, false);
+  transaction_set_arrival_timestamp(&tx, 42);
+
+  TEST_ASSERT_FALSE(iota_transaction_cache_get(&cache, hashes[1], &metadata,
+                                               &cached_tx, &stale_epoch));
+  TEST_ASSERT(iota_transaction_cache_put(&cache, hashes[1], &metadata, &tx,
+                                         stale_epoch) == RC_OK);
+  TEST_ASSERT(iota_transaction_cache_put(&cache, hashes[1], &essence_consensus,
+                                         &tx, stale_epoch) == RC_OK);
+  TEST_ASSERT_TRUE(iota_transaction_cache_get(&cache, hashes[1], &metadata,
+                                              &cached_tx, &epoch));
+  TEST_ASSERT_FALSE(transaction_solid(&cached_tx));
+
+  iota_transaction_cache_invalidate_metadata(&cache, hashes[1]);
+
+  // Immutable columns survive the invalidation
+  TEST_ASSERT_TRUE(iota_transaction_cache_get(&cache, hashes[1],
+                                              &essence_consensus, &cached_tx,
+                                              &epoch));
+  TEST_ASSERT_FALSE(iota_transaction_cache_get(&cache, hashes[1], &metadata,
+                                               &cached_tx, &epoch));
+
+  // A load started before the invalidation can't put stale metadata back
+  TEST_ASSERT(iota_transaction_cache_put(&cache, hashes[1], &metadata, &tx,
+                                         stale_epoch) == RC_OK);
+  TEST_ASSERT_FALSE(iota_transaction_cache_get(&cache, hashes[1], &metadata,
+                                               &cached_tx, &epoch));
+
+  transaction_set_solid(&tx, true);
+  TEST_ASSERT(iota_transaction_cache_put(&cache, hashes[1], &metadata, &tx,
+                                         epoch) == RC_OK);
+  TEST_ASSERT_TRUE(iota_transaction_cache_get(&cache, hashes[1], &metadata,
+                                              &cached_tx, &epoch));
+  TEST_ASSERT_TRUE(transaction_solid(&cached_tx));
+  TEST_ASSERT_EQUAL_INT(42, transaction_arrival_timestamp(&cached_tx));
+}
+
+void test_transaction_cache_eviction(void) {
+  iota_transaction_t tx;
+  transaction_cache_stats_t stats;
+  uint64_t epoch = 0;
+
+  for (size_t i = 0; i < NUM_HASHES; i++) {
+    transaction_build(&tx, i);
+    epoch = iota_transaction_cache_epoch(&cache, hashes[i]);
+    TEST_ASSERT(iota_transaction_cache_put(&cache, hashes[i],
+                                           &essence_consensus, &tx,
+                                           epoch) == RC_OK);
+  }
+
+  iota_transaction_cache_stats(&cache, &stats);
+  TEST_ASSERT(stats.size <= CACHE_CAPACITY);
+  TEST_ASSERT_EQUAL_INT(NUM_HASHES, stats.size + stats.evictions);
+
+  // The last transaction put in a shard is never the one evicted
+  TEST_ASSERT_TRUE(iota_transaction_cache_get(&cache, hashes[NUM_HASHES - 1],
+                                              &essence_consensus, &tx,
+                                              &epoch));
+
+  iota_transaction_cache_clear(&cache);
+  iota_transaction_cache_stats(&cache, &stats);
+  TEST_ASSERT_EQUAL_INT(0, stats.size);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  hashes_init();
+
+  RUN_TEST(test_transaction_cache_get_put);
+  RUN_TEST(test_transaction_cache_invalidate_metadata);
+  RUN_TEST(test_transaction_cache_eviction);
+
+  return UNITY_END();
+}
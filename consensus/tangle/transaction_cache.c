@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "consensus/tangle/transaction_cache.h"
+
+/*
+ * Private functions
+ */
+
+static transaction_cache_shard_t *transaction_cache_shard(
+    transaction_cache_t *const cache, flex_trit_t const *const hash) {
+  size_t index = 0;
+
+  for (size_t i = 0; i < sizeof(uint64_t); i++) {
+    index = index * 31 + (uint8_t)hash[i];
+  }
+
+  return &cache->shards[index % TRANSACTION_CACHE_NUM_SHARDS];
+}
+
+static bool field_mask_contains(field_mask_t const *const mask,
+                                field_mask_t const *const requested) {
+  return (mask->essence & requested->essence) == requested->essence &&
+         (mask->attachment & requested->attachment) == requested->attachment &&
+         (mask->consensus & requested->consensus) == requested->consensus &&
+         (mask->data & requested->data) == requested->data &&
+         (mask->metadata & requested->metadata) == requested->metadata;
+}
+
+static bool field_mask_is_empty(field_mask_t const *const mask) {
+  return mask->essence == 0 && mask->attachment == 0 && mask->consensus == 0 &&
+         mask->data == 0 && mask->metadata == 0;
+}
+
+/**
+ * Copies the requested groups of columns as a whole
+ */
+static void transaction_copy(iota_transaction_t *const dst,
+                             iota_transaction_t const *const src,
+                             field_mask_t const *const mask) {
+#define TRANSACTION_COPY_GROUP(GROUP)                                   \
+  if (mask->GROUP) {                                                    \
+    dst->GROUP = src->GROUP;                                            \
+    dst->loaded_columns_mask.GROUP |= src->loaded_columns_mask.GROUP &  \
+                                      mask->GROUP;                      \
+  }
+
+  TRANSACTION_COPY_GROUP(essence);
+  TRANSACTION_COPY_GROUP(attachment);
+  TRANSACTION_COPY_GROUP(consensus);
+  TRANSACTION_COPY_GROUP(data);
+  TRANSACTION_COPY_GROUP(metadata);
+
+#undef TRANSACTION_COPY_GROUP
+}
+
+/**
+ * A group of columns of an entry is only replaced if it doesn't lose any
+ * column in the process
+ */
+static void transaction_merge(iota_transaction_t *const dst,
+                              field_mask_t const *const bits,
+                              iota_transaction_t const *const src) {
+#define TRANSACTION_MERGE_GROUP(GROUP)                                  \
+  if (bits->GROUP &&                                                    \
+      (bits->GROUP & dst->loaded_columns_mask.GROUP) ==                 \
+          dst->loaded_columns_mask.GROUP) {                             \
+    dst->GROUP = src->GROUP;                                            \
+    dst->loaded_columns_mask.GROUP = bits->GROUP;                       \
+  }
+
+  TRANSACTION_MERGE_GROUP(essence);
+  TRANSACTION_MERGE_GROUP(attachment);
+  TRANSACTION_MERGE_GROUP(consensus);
+  TRANSACTION_MERGE_GROUP(data);
+  TRANSACTION_MERGE_GROUP(metadata);
+
+#undef TRANSACTION_MERGE_GROUP
+}
+
+static void transaction_cache_shard_clear(
+    transaction_cache_shard_t *const shard) {
+  transaction_cache_entry_t *entry = NULL, *tmp = NULL;
+
+  HASH_ITER(hh, shard->entries, entry, tmp) {
+    HASH_DEL(shard->entries, entry);
+    free(entry);
+  }
+  shard->size = 0;
+  shard->epoch++;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t iota_transaction_cache_init(transaction_cache_t *const cache,
+                                      size_t const capacity) {
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(cache, 0, sizeof(transaction_cache_t));
+  cache->shard_capacity = (capacity + TRANSACTION_CACHE_NUM_SHARDS - 1) /
+                          TRANSACTION_CACHE_NUM_SHARDS;
+  for (size_t i = 0; i < TRANSACTION_CACHE_NUM_SHARDS; i++) {
+    lock_handle_init(&cache->shards[i].lock);
+  }
+
+  return RC_OK;
+}
+
+retcode_t iota_transaction_cache_destroy(transaction_cache_t *const cache) {
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  for (size_t i = 0; i < TRANSACTION_CACHE_NUM_SHARDS; i++) {
+    transaction_cache_shard_clear(&cache->shards[i]);
+    lock_handle_destroy(&cache->shards[i].lock);
+  }
+
+  return RC_OK;
+}
+
+bool iota_transaction_cache_get(transaction_cache_t *const cache,
+                                flex_trit_t const *const hash,
+                                field_mask_t const *const mask,
+                                iota_transaction_t *const tx,
+                                uint64_t *const epoch) {
+  transaction_cache_shard_t *shard = transaction_cache_shard(cache, hash);
+  transaction_cache_entry_t *entry = NULL;
+  bool found = false;
+
+  lock_handle_lock(&shard->lock);
+  *epoch = shard->epoch;
+  HASH_FIND(hh, shard->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry && field_mask_contains(&entry->tx.loaded_columns_mask, mask)) {
+    transaction_copy(tx, &entry->tx, mask);
+    // Most recently used entries are at the back of the table
+    HASH_DELETE(hh, shard->entries, entry);
+    HASH_ADD(hh, shard->entries, hash, FLEX_TRIT_SIZE_243, entry);
+    shard->hits++;
+    found = true;
+  } else {
+    shard->misses++;
+  }
+  lock_handle_unlock(&shard->lock);
+
+  return found;
+}
+
+retcode_t iota_transaction_cache_put(transaction_cache_t *const cache,
+                                     flex_trit_t const *const hash,
+                                     field_mask_t const *const mask,
+                                     iota_transaction_t const *const tx,
+                                     uint64_t const epoch) {
+  retcode_t ret = RC_OK;
+  transaction_cache_shard_t *shard = transaction_cache_shard(cache, hash);
+  transaction_cache_entry_t *entry = NULL;
+  field_mask_t const none = {0};
+  field_mask_t bits = tx->loaded_columns_mask;
+
+  bits.essence &= mask->essence;
+  bits.attachment &= mask->attachment;
+  bits.consensus &= mask->consensus;
+  bits.data &= mask->data;
+  bits.metadata &= mask->metadata;
+
+  if (cache->shard_capacity == 0 || field_mask_is_empty(&bits)) {
+    return RC_OK;
+  }
+
+  lock_handle_lock(&shard->lock);
+
+  if (epoch != shard->epoch) {
+    goto done;
+  }
+
+  HASH_FIND(hh, shard->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry == NULL) {
+    if (shard->size >= cache->shard_capacity) {
+      // Recycles the least recently used entry
+      entry = shard->entries;
+      HASH_DELETE(hh, shard->entries, entry);
+      shard->size--;
+      shard->evictions++;
+    } else if ((entry = (transaction_cache_entry_t *)malloc(
+                    sizeof(transaction_cache_entry_t))) == NULL) {
+      ret = RC_CONSENSUS_OOM;
+      goto done;
+    }
+    memcpy(entry->hash, hash, FLEX_TRIT_SIZE_243);
+    entry->tx.loaded_columns_mask = none;
+    HASH_ADD(hh, shard->entries, hash, FLEX_TRIT_SIZE_243, entry);
+    shard->size++;
+  }
+  transaction_merge(&entry->tx, &bits, tx);
+
+done:
+  lock_handle_unlock(&shard->lock);
+  return ret;
+}
+
+uint64_t iota_transaction_cache_epoch(transaction_cache_t *const cache,
+                                      flex_trit_t const *const hash) {
+  transaction_cache_shard_t *shard = transaction_cache_shard(cache, hash);
+  uint64_t epoch = 0;
+
+  lock_handle_lock(&shard->lock);
+  epoch = shard->epoch;
+  lock_handle_unlock(&shard->lock);
+
+  return epoch;
+}
+
+void iota_transaction_cache_invalidate_metadata(
+    transaction_cache_t *const cache, flex_trit_t const *const hash) {
+  transaction_cache_shard_t *shard = transaction_cache_shard(cache, hash);
+  transaction_cache_entry_t *entry = NULL;
+
+  lock_handle_lock(&shard->lock);
+  HASH_FIND(hh, shard->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry) {
+    entry->tx.loaded_columns_mask.metadata = 0;
+  }
+  shard->epoch++;
+  lock_handle_unlock(&shard->lock);
+}
+
+void iota_transaction_cache_invalidate_metadata_set(
+    transaction_cache_t *const cache, hash243_set_t const hashes) {
+  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+
+  HASH_ITER(hh, hashes, iter, tmp) {
+    iota_transaction_cache_invalidate_metadata(cache, iter->hash);
+  }
+}
+
+void iota_transaction_cache_clear(transaction_cache_t *const cache) {
+  for (size_t i = 0; i < TRANSACTION_CACHE_NUM_SHARDS; i++) {
+    lock_handle_lock(&cache->shards[i].lock);
+    transaction_cache_shard_clear(&cache->shards[i]);
+    lock_handle_unlock(&cache->shards[i].lock);
+  }
+}
+
+void iota_transaction_cache_stats(transaction_cache_t *const cache,
+                                  transaction_cache_stats_t *const stats) {
+  memset(stats, 0, sizeof(transaction_cache_stats_t));
+  for (size_t i = 0; i < TRANSACTION_CACHE_NUM_SHARDS; i++) {
+    lock_handle_lock(&cache->shards[i].lock);
+    stats->size += cache->shards[i].size;
+    stats->hits += cache->shards[i].hits;
+    stats->misses += cache->shards[i].misses;
+    stats->evictions += cache->shards[i].evictions;
+    lock_handle_unlock(&cache->shards[i].lock);
+  }
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_TANGLE_TRANSACTION_CACHE_H__
+#define __CONSENSUS_TANGLE_TRANSACTION_CACHE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "uthash.h"
+
+#include "common/errors.h"
+#include "common/model/transaction.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/containers/hash/hash243_set.h"
+#include "utils/handles/lock.h"
+
+#define TRANSACTION_CACHE_NUM_SHARDS 16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct transaction_cache_entry_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  iota_transaction_t tx;
+  UT_hash_handle hh;
+} transaction_cache_entry_t;
+
+/**
+ * Entries are kept in insertion order by uthash, a hit moves the entry to the
+ * back so that the front of the table is always the least recently used one.
+ * The epoch is bumped by every invalidation so that a load racing with an
+ * update can't put stale columns back in the shard.
+ */
+typedef struct transaction_cache_shard_s {
+  lock_handle_t lock;
+  transaction_cache_entry_t *entries;
+  size_t size;
+  uint64_t epoch;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+} transaction_cache_shard_t;
+
+/**
+ * Decoded transactions, possibly partial, keyed by hash. Only the groups of
+ * columns flagged in the loaded columns mask of an entry are meaningful.
+ */
+typedef struct transaction_cache_s {
+  transaction_cache_shard_t shards[TRANSACTION_CACHE_NUM_SHARDS];
+  size_t shard_capacity;
+} transaction_cache_t;
+
+typedef struct transaction_cache_stats_s {
+  size_t size;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+} transaction_cache_stats_t;
+
+/**
+ * Initializes a transaction cache
+ *
+ * @param cache The transaction cache
+ * @param capacity The maximum number of transactions, spread over the shards
+ *
+ * @return a status code
+ */
+retcode_t iota_transaction_cache_init(transaction_cache_t *const cache,
+                                      size_t const capacity);
+
+/**
+ * Destroys a transaction cache
+ *
+ * @param cache The transaction cache
+ *
+ * @return a status code
+ */
+retcode_t iota_transaction_cache_destroy(transaction_cache_t *const cache);
+
+/**
+ * Copies the columns of a cached transaction into a given transaction if all
+ * the requested columns are cached
+ *
+ * @param cache The transaction cache
+ * @param hash The transaction hash
+ * @param mask The requested columns
+ * @param tx A transaction to copy the columns into
+ * @param epoch The epoch to give back to iota_transaction_cache_put after a
+ * miss
+ *
+ * @return whether the requested columns were found
+ */
+bool iota_transaction_cache_get(transaction_cache_t *const cache,
+                                flex_trit_t const *const hash,
+                                field_mask_t const *const mask,
+                                iota_transaction_t *const tx,
+                                uint64_t *const epoch);
+
+/**
+ * Merges the columns of a transaction into its cache entry, evicting the least
+ * recently used entry of the shard if needed. Nothing is cached if the entry
+ * has been invalidated since the epoch was read.
+ *
+ * @param cache The transaction cache
+ * @param hash The transaction hash
+ * @param mask The columns to cache, ignored if not loaded in the transaction
+ * @param tx The transaction
+ * @param epoch The epoch read before loading the transaction
+ *
+ * @return a status code
+ */
+retcode_t iota_transaction_cache_put(transaction_cache_t *const cache,
+                                     flex_trit_t const *const hash,
+                                     field_mask_t const *const mask,
+                                     iota_transaction_t const *const tx,
+                                     uint64_t const epoch);
+
+/**
+ * Gets the current epoch of the shard of a transaction
+ *
+ * @param cache The transaction cache
+ * @param hash The transaction hash
+ *
+ * @return the epoch
+ */
+uint64_t iota_transaction_cache_epoch(transaction_cache_t *const cache,
+                                      flex_trit_t const *const hash);
+
+/**
+ * Drops the cached metadata of a transaction, the immutable columns are kept
+ *
+ * @param cache The transaction cache
+ * @param hash The transaction hash
+ */
+void iota_transaction_cache_invalidate_metadata(
+    transaction_cache_t *const cache, flex_trit_t const *const hash);
+
+/**
+ * Drops the cached metadata of a set of transactions
+ *
+ * @param cache The transaction cache
+ * @param hashes The transaction hashes
+ */
+void iota_transaction_cache_invalidate_metadata_set(
+    transaction_cache_t *const cache, hash243_set_t const hashes);
+
+/**
+ * Removes all entries, e.g. when transactions are deleted from the database
+ *
+ * @param cache The transaction cache
+ */
+void iota_transaction_cache_clear(transaction_cache_t *const cache);
+
+/**
+ * Sums the statistics of all shards
+ *
+ * @param cache The transaction cache
+ * @param stats The statistics
+ */
+void iota_transaction_cache_stats(transaction_cache_t *const cache,
+                                  transaction_cache_stats_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_TANGLE_TRANSACTION_CACHE_H__
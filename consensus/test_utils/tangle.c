@@ -27,11 +27,12 @@ retcode_t tangle_setup(tangle_t *const tangle,
 
 retcode_t tangle_cleanup(tangle_t *const tangle, char *test_db_path) {
   retcode_t ret = RC_OK;
+  connection_config_t config = {.db_path = test_db_path};
 
   if ((ret = iota_tangle_destroy(tangle))) {
     return ret;
   }
-  if ((ret = remove_file(test_db_path))) {
+  if ((ret = connection_drop_db(&config))) {
     return ret;
   }
   return ret;
@@ -13,6 +13,7 @@
 #include "consensus/exit_probability_validator/exit_probability_validator.h"
 #include "consensus/snapshot/snapshot.h"
 #include "consensus/tip_selector/tip_selector.h"
+#include "utils/containers/hash/hash_allocator.h"
 #include "utils/logger_helper.h"
 
 #define TIP_SELECTOR_LOGGER_ID "tip_selector"
@@ -48,7 +49,10 @@ retcode_t iota_consensus_tip_selector_get_transactions_to_approve(
   cw_calc_result rating_results = {.cw_ratings = NULL, .tx_to_approvers = NULL};
   bool consistent = false;
   hash243_stack_t tips_stack = NULL;
+  hash_allocator_scope_t scope;
 
+  // The traversal state of the request is released at once when it completes
+  hash_allocator_scope_begin(&scope);
   rw_lock_handle_rdlock(
       &tip_selector->milestone_tracker->latest_snapshot->rw_lock);
 
@@ -67,6 +71,10 @@ retcode_t iota_consensus_tip_selector_get_transactions_to_approve(
     goto done;
   }
 
+  // Walks update validation caches outliving the request, they open their own
+  // scopes around their local state
+  hash_allocator_suspend();
+
   if ((ret = iota_consensus_exit_probability_randomize(
            tip_selector->ep_randomizer, tangle, tip_selector->walker_validator,
            &rating_results, ep_p, tips->trunk)) != RC_OK) {
@@ -117,6 +125,7 @@ done:
       &tip_selector->milestone_tracker->latest_snapshot->rw_lock);
   cw_calc_result_destroy(&rating_results);
   hash243_stack_free(&tips_stack);
+  hash_allocator_scope_end(&scope);
   return ret;
 }
 
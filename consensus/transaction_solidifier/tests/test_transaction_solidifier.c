@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "consensus/test_utils/tangle.h"
+#include "consensus/transaction_solidifier/transaction_solidifier.h"
+#include "gossip/conf.h"
+#include "gossip/node.h"
+
+// Transactions are named by the first tryte of their hash, the genesis being
+// named '9'
+#define GENESIS '9'
+
+static char *test_db_path = "consensus/transaction_solidifier/tests/test.db";
+static char *ciri_db_path = "consensus/transaction_solidifier/tests/ciri.db";
+static connection_config_t config;
+static tangle_t tangle;
+static iota_consensus_conf_t conf;
+static node_t node;
+static tips_cache_t tips;
+static transaction_solidifier_t ts;
+static hash243_set_t notified = NULL;
+
+static void on_newly_solid(void *data, hash243_set_t const newly_solid) {
+  TEST_ASSERT(hash243_set_append(&newly_solid, data) == RC_OK);
+}
+
+void setUp(void) {
+  TEST_ASSERT(tangle_setup(&tangle, &config, test_db_path, ciri_db_path) ==
+              RC_OK);
+  TEST_ASSERT(requester_init(&node.transaction_requester, &node) == RC_OK);
+  TEST_ASSERT(tips_cache_init(&tips, node.conf.tips_cache_size) == RC_OK);
+  TEST_ASSERT(iota_consensus_transaction_solidifier_init(
+                  &ts, &conf, &node.transaction_requester, &tips) == RC_OK);
+  TEST_ASSERT(iota_consensus_transaction_solidifier_on_newly_solid(
+                  &ts, on_newly_solid, &notified) == RC_OK);
+}
+
+void tearDown(void) {
+  TEST_ASSERT(iota_consensus_transaction_solidifier_destroy(&ts) == RC_OK);
+  TEST_ASSERT(tips_cache_destroy(&tips) == RC_OK);
+  TEST_ASSERT(requester_destroy(&node.transaction_requester) == RC_OK);
+  TEST_ASSERT(tangle_cleanup(&tangle, test_db_path) == RC_OK);
+  hash243_set_free(&notified);
+}
+
+static flex_trit_t *hash_of(char const name) {
+  static flex_trit_t hashes[27][FLEX_TRIT_SIZE_243];
+  tryte_t trytes[HASH_LENGTH_TRYTE];
+  size_t index = name == GENESIS ? 0 : name - 'A' + 1;
+
+  memset(trytes, '9', HASH_LENGTH_TRYTE);
+  trytes[0] = name;
+  flex_trits_from_trytes(hashes[index], HASH_LENGTH_TRIT, trytes,
+                         HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+  return hashes[index];
+}
+
+/**
+ * Stores a transaction and notifies the solidifier of its arrival
+ */
+static void arrive(char const name, char const trunk, char const branch) {
+  iota_transaction_t tx;
+
+  transaction_reset(&tx);
+  transaction_set_hash(&tx, hash_of(name));
+  transaction_set_trunk(&tx, hash_of(trunk));
+  transaction_set_branch(&tx, hash_of(branch));
+  transaction_set_solid(&tx, false);
+  TEST_ASSERT(iota_tangle_transaction_store(&tangle, &tx) == RC_OK);
+  TEST_ASSERT(iota_consensus_transaction_solidifier_update_status(
+                  &ts, &tangle, &tx) == RC_OK);
+}
+
+static bool is_stored_solid(char const name) {
+  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
+
+  TEST_ASSERT(iota_tangle_transaction_load_partial(
+                  &tangle, hash_of(name), &pack,
+                  PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  return transaction_solid(&tx);
+}
+
+static bool is_requested(char const name, bool const milestone) {
+  return hash243_set_contains(milestone
+                                  ? &node.transaction_requester.milestones
+                                  : &node.transaction_requester.transactions,
+                              hash_of(name));
+}
+
+static void assert_solid(char const *const names) {
+  for (char const *name = names; *name; name++) {
+    TEST_ASSERT_TRUE(is_stored_solid(*name));
+    TEST_ASSERT_TRUE(hash243_set_contains(&notified, hash_of(*name)));
+  }
+}
+
+static void assert_unsolid(char const *const names) {
+  for (char const *name = names; *name; name++) {
+    TEST_ASSERT_FALSE(is_stored_solid(*name));
+    TEST_ASSERT_FALSE(hash243_set_contains(&notified, hash_of(*name)));
+  }
+}
+
+static size_t frontier_size(void) {
+  transaction_solidifier_stats_t stats;
+
+  iota_consensus_transaction_solidifier_stats(&ts, &stats);
+  return stats.frontier_size;
+}
+
+void test_in_order(void) {
+  arrive('A', GENESIS, GENESIS);
+  assert_solid("A");
+  arrive('B', 'A', GENESIS);
+  assert_solid("B");
+  TEST_ASSERT_EQUAL_INT(0, frontier_size());
+}
+
+void test_out_of_order(void) {
+  // C -> B -> A -> genesis arriving from the tip
+  arrive('C', 'B', 'B');
+  assert_unsolid("C");
+  TEST_ASSERT_TRUE(is_requested('B', false));
+
+  arrive('B', 'A', 'A');
+  assert_unsolid("CB");
+  TEST_ASSERT_FALSE(is_requested('B', false));
+  TEST_ASSERT_TRUE(is_requested('A', false));
+
+  arrive('A', GENESIS, GENESIS);
+  assert_solid("ABC");
+  TEST_ASSERT_EQUAL_INT(0, frontier_size());
+}
+
+void test_diamond(void) {
+  // D approves B and C which both approve A
+  arrive('D', 'B', 'C');
+  arrive('C', 'A', GENESIS);
+  arrive('B', GENESIS, 'A');
+  assert_unsolid("BCD");
+  // The shared approvee is awaited once by both of its approvers
+  TEST_ASSERT_EQUAL_INT(4, frontier_size());
+
+  arrive('A', GENESIS, GENESIS);
+  assert_solid("ABCD");
+  TEST_ASSERT_EQUAL_INT(0, frontier_size());
+}
+
+void test_milestone_last_missing_parent(void) {
+  bool is_solid = true;
+  transaction_solidifier_stats_t stats;
+
+  // M approves X, already solid, and Y which arrives last
+  arrive('X', GENESIS, GENESIS);
+  arrive('M', 'X', 'Y');
+  TEST_ASSERT(iota_consensus_transaction_solidifier_check_solidity(
+                  &ts, &tangle, hash_of('M'), true, &is_solid) == RC_OK);
+  TEST_ASSERT_FALSE(is_solid);
+  assert_unsolid("M");
+  TEST_ASSERT_TRUE(is_requested('Y', true));
+
+  arrive('Y', GENESIS, GENESIS);
+  assert_solid("XYM");
+  TEST_ASSERT(iota_consensus_transaction_solidifier_check_solidity(
+                  &ts, &tangle, hash_of('M'), true, &is_solid) == RC_OK);
+  TEST_ASSERT_TRUE(is_solid);
+
+  iota_consensus_transaction_solidifier_stats(&ts, &stats);
+  TEST_ASSERT_EQUAL_INT(1, stats.milestones);
+  TEST_ASSERT(stats.max_latency_us <= stats.total_latency_us);
+}
+
+void test_eviction(void) {
+  bool is_solid = true;
+  transaction_solidifier_stats_t stats;
+
+  ts.frontier_capacity = 2;
+
+  // M -> X -> Y with Y missing, X being the oldest it is evicted when M is
+  // tracked
+  arrive('X', 'Y', 'Y');
+  arrive('M', 'X', 'X');
+  iota_consensus_transaction_solidifier_stats(&ts, &stats);
+  TEST_ASSERT_EQUAL_INT(2, stats.frontier_size);
+  TEST_ASSERT_EQUAL_INT(1, stats.evictions);
+
+  // Y no longer has its approver in the frontier
+  arrive('Y', GENESIS, GENESIS);
+  assert_solid("Y");
+  assert_unsolid("XM");
+
+  // Which is loaded from the tangle again when M is checked
+  TEST_ASSERT(iota_consensus_transaction_solidifier_check_solidity(
+                  &ts, &tangle, hash_of('M'), true, &is_solid) == RC_OK);
+  TEST_ASSERT_TRUE(is_solid);
+  assert_solid("XM");
+  TEST_ASSERT_EQUAL_INT(0, frontier_size());
+}
+
+void test_eviction_of_awaited(void) {
+  bool is_solid = true;
+  transaction_solidifier_stats_t stats;
+
+  ts.frontier_capacity = 3;
+
+  // A is awaited by X and B, then X and A, the oldest, are evicted when D and
+  // C are tracked
+  arrive('X', 'A', 'A');
+  arrive('B', 'A', 'A');
+  arrive('D', 'C', 'C');
+  iota_consensus_transaction_solidifier_stats(&ts, &stats);
+  TEST_ASSERT_EQUAL_INT(3, stats.frontier_size);
+  TEST_ASSERT_EQUAL_INT(2, stats.evictions);
+
+  // B is not released by the arrival of A but D is by the arrival of C
+  arrive('A', GENESIS, GENESIS);
+  arrive('C', GENESIS, GENESIS);
+  assert_solid("ACD");
+  assert_unsolid("BX");
+
+  // B and X await their approvees again from the tangle
+  TEST_ASSERT(iota_consensus_transaction_solidifier_check_solidity(
+                  &ts, &tangle, hash_of('B'), false, &is_solid) == RC_OK);
+  TEST_ASSERT_TRUE(is_solid);
+  TEST_ASSERT(iota_consensus_transaction_solidifier_check_solidity(
+                  &ts, &tangle, hash_of('X'), false, &is_solid) == RC_OK);
+  TEST_ASSERT_TRUE(is_solid);
+  assert_solid("BX");
+  TEST_ASSERT_EQUAL_INT(0, frontier_size());
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  TEST_ASSERT(storage_init() == RC_OK);
+
+  config.db_path = test_db_path;
+  TEST_ASSERT(iota_consensus_conf_init(&conf) == RC_OK);
+  TEST_ASSERT(iota_gossip_conf_init(&node.conf) == RC_OK);
+
+  RUN_TEST(test_in_order);
+  RUN_TEST(test_out_of_order);
+  RUN_TEST(test_diamond);
+  RUN_TEST(test_milestone_last_missing_parent);
+  RUN_TEST(test_eviction);
+  RUN_TEST(test_eviction_of_awaited);
+
+  TEST_ASSERT(storage_destroy() == RC_OK);
+  return UNITY_END();
+}
@@ -5,396 +5,760 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
+
 #include "consensus/transaction_solidifier/transaction_solidifier.h"
-#include "consensus/utils/tangle_traversals.h"
 #include "utils/logger_helper.h"
+#include "utils/time.h"
 
 #define TRANSACTION_SOLIDIFIER_LOGGER_ID "transaction_solidifier"
-#define SOLID_PROPAGATION_INTERVAL 500000uLL
 
 static logger_id_t logger_id;
 
+struct unsolid_transaction_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t trunk[FLEX_TRIT_SIZE_243];
+  flex_trit_t branch[FLEX_TRIT_SIZE_243];
+  // Whether the transaction is stored, otherwise it is only awaited by its
+  // approvers and has been requested
+  bool stored;
+  // Whether its approvees are awaited, reset when one of them is evicted so
+  // that they are awaited again from the tangle
+  bool tracked;
+  // Whether the transaction is a milestone being solidified
+  bool milestone;
+  // Number of approvees that are not solid yet
+  uint8_t unsolid_approvees;
+  // Approvers waiting for this transaction to become solid
+  hash243_set_t approvers;
+  UT_hash_handle hh;
+};
+
+// A transaction loaded from the tangle outside of the lock
+typedef struct loaded_transaction_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t trunk[FLEX_TRIT_SIZE_243];
+  flex_trit_t branch[FLEX_TRIT_SIZE_243];
+  bool found;
+  bool solid;
+  UT_hash_handle hh;
+} loaded_transaction_t;
+
+// A solidity check alternates passes over the frontier, under the lock, with
+// loads of the transactions these passes lacked, outside of it
+typedef struct solidity_check_s {
+  tangle_t *tangle;
+  bool is_milestone;
+  // Arrival time of the checked transaction, 0 if it is not an arrival
+  uint64_t arrival_us;
+  // Whether the checked transaction is still to be resolved
+  bool pending;
+  bool is_solid;
+  // Stored transactions of the frontier whose approvees have to be awaited
+  hash243_stack_t to_track;
+  // Awaited transactions of the frontier to look for in the tangle
+  hash243_set_t awaited;
+  hash243_set_t to_load;
+  hash243_set_t to_request;
+  loaded_transaction_t *loaded;
+  hash243_set_t newly_solid;
+  // Number of milestones among the newly solid transactions
+  size_t milestones;
+} solidity_check_t;
+
 /*
- * Forward declarations
+ * Private functions
  */
 
-static retcode_t check_approvee_solid_state(transaction_solidifier_t *const ts,
-                                            tangle_t *const tangle,
-                                            flex_trit_t *const approvee,
-                                            bool *solid);
-
-static retcode_t check_transaction_and_update_solid_state(
-    transaction_solidifier_t *const ts, tangle_t *const tangle,
-    flex_trit_t *const transaction, bool *const is_new_solid);
+static retcode_t frontier_add(transaction_solidifier_t *const ts,
+                              flex_trit_t const *const hash,
+                              unsolid_transaction_t **const entry) {
+  if ((*entry = (unsolid_transaction_t *)calloc(
+           1, sizeof(unsolid_transaction_t))) == NULL) {
+    return RC_OOM;
+  }
+  memcpy((*entry)->hash, hash, FLEX_TRIT_SIZE_243);
+  HASH_ADD(hh, ts->frontier, hash, FLEX_TRIT_SIZE_243, *entry);
+  return RC_OK;
+}
 
-static retcode_t add_new_solid_transaction(transaction_solidifier_t *const ts,
-                                           flex_trit_t *const hash);
+static void frontier_remove(transaction_solidifier_t *const ts,
+                            unsolid_transaction_t *const entry) {
+  HASH_DEL(ts->frontier, entry);
+  hash243_set_free(&entry->approvers);
+  free(entry);
+}
 
-static retcode_t check_solidity_do_func(flex_trit_t *hash,
-                                        iota_stor_pack_t *pack, void *data,
-                                        bool *should_branch, bool *should_stop);
+static void frontier_set_stored(unsolid_transaction_t *const entry,
+                                loaded_transaction_t const *const tx) {
+  entry->stored = true;
+  memcpy(entry->trunk, tx->trunk, FLEX_TRIT_SIZE_243);
+  memcpy(entry->branch, tx->branch, FLEX_TRIT_SIZE_243);
+}
 
-/*
- * Private functions
+/**
+ * Evicts the oldest transactions of the frontier beyond its capacity, their
+ * approvers will await their approvees again from the tangle
  */
+static void frontier_trim(transaction_solidifier_t *const ts) {
+  unsolid_transaction_t *entry = NULL, *approver = NULL;
+  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+
+  // Transactions are iterated in insertion order, the oldest first
+  while (HASH_COUNT(ts->frontier) > ts->frontier_capacity) {
+    entry = ts->frontier;
+    HASH_ITER(hh, entry->approvers, iter, tmp) {
+      HASH_FIND(hh, ts->frontier, iter->hash, FLEX_TRIT_SIZE_243, approver);
+      if (approver) {
+        approver->tracked = false;
+      }
+    }
+    frontier_remove(ts, entry);
+    ts->evictions++;
+  }
+}
 
-typedef struct check_solidity_do_func_params_s {
-  transaction_solidifier_t *ts;
-  tangle_t *tangle;
-  bool is_milestone;
-  bool is_solid;
-  hash243_set_t *solid_transactions_candidates;
-} check_solidity_do_func_params_t;
+static loaded_transaction_t *loaded_find(solidity_check_t const *const check,
+                                         flex_trit_t const *const hash) {
+  loaded_transaction_t *loaded = NULL;
 
-static retcode_t propagate_solid_transactions(
-    transaction_solidifier_t *const ts, tangle_t *const tangle) {
-  retcode_t ret = RC_OK;
-  hash243_set_t transactions_to_propagate = NULL;
-  hash243_set_entry_t *curr_entry = NULL;
-  hash243_set_entry_t *tmp_entry = NULL;
-  flex_trit_t *approver_hash = NULL;
-  iota_stor_pack_t hash_pack;
+  HASH_FIND(hh, check->loaded, hash, FLEX_TRIT_SIZE_243, loaded);
+  return loaded;
+}
 
-  lock_handle_lock(&ts->lock);
-  transactions_to_propagate = ts->newly_set_solid_transactions;
-  ts->newly_set_solid_transactions = NULL;
-  lock_handle_unlock(&ts->lock);
+static retcode_t loaded_add(solidity_check_t *const check,
+                            flex_trit_t const *const hash,
+                            iota_transaction_t const *const tx) {
+  loaded_transaction_t *loaded = NULL;
 
-  if ((ret = hash_pack_init(&hash_pack, 32)) != RC_OK) {
-    goto done;
+  if ((loaded = (loaded_transaction_t *)calloc(
+           1, sizeof(loaded_transaction_t))) == NULL) {
+    return RC_OOM;
+  }
+  memcpy(loaded->hash, hash, FLEX_TRIT_SIZE_243);
+  if (tx != NULL) {
+    loaded->found = true;
+    loaded->solid = transaction_solid(tx);
+    memcpy(loaded->trunk, transaction_trunk(tx), FLEX_TRIT_SIZE_243);
+    memcpy(loaded->branch, transaction_branch(tx), FLEX_TRIT_SIZE_243);
   }
+  HASH_ADD(hh, check->loaded, hash, FLEX_TRIT_SIZE_243, loaded);
+  return RC_OK;
+}
+
+/**
+ * Loads the transactions a pass lacked, the lock must not be held
+ */
+static retcode_t load(solidity_check_t *const check) {
+  retcode_t ret = RC_OK;
+  hash243_set_entry_t *iter = NULL, *tmp = NULL;
 
-  HASH_ITER(hh, transactions_to_propagate, curr_entry, tmp_entry) {
-    if (!ts->running) {
+  HASH_ITER(hh, check->to_load, iter, tmp) {
+    DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
+
+    if (loaded_find(check, iter->hash) != NULL) {
+      continue;
+    }
+    if ((ret = iota_tangle_transaction_load_partial(
+             check->tangle, iter->hash, &pack,
+             PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA)) != RC_OK) {
+      log_error(logger_id, "Loading transaction failed\n");
+      break;
+    }
+    if ((ret = loaded_add(check, iter->hash,
+                          pack.num_loaded != 0 ? &tx : NULL)) != RC_OK) {
       break;
     }
+  }
+  hash243_set_free(&check->to_load);
+
+  return ret;
+}
+
+/**
+ * Tells whether the state of an approvee is known without loading it
+ */
+static bool approvee_known(transaction_solidifier_t const *const ts,
+                           solidity_check_t const *const check,
+                           flex_trit_t const *const approvee) {
+  unsolid_transaction_t *entry = NULL;
+
+  if (memcmp(approvee, ts->conf->genesis_hash, FLEX_TRIT_SIZE_243) == 0) {
+    return true;
+  }
+  HASH_FIND(hh, ts->frontier, approvee, FLEX_TRIT_SIZE_243, entry);
+  return entry != NULL || hash243_set_contains(&ts->solidifying, approvee) ||
+         loaded_find(check, approvee) != NULL;
+}
 
-    hash_pack_reset(&hash_pack);
-    if ((ret = iota_tangle_transaction_load_hashes_of_approvers(
-             tangle, curr_entry->hash, &hash_pack, 0)) != RC_OK) {
-      log_error(logger_id,
-                "Loading hashes of approvers while propagating "
-                "solidity failed\n");
+/**
+ * Marks a transaction as solid and cascades to the approvers it was the last
+ * unsolid approvee of
+ */
+static retcode_t set_solid(transaction_solidifier_t *const ts,
+                           solidity_check_t *const check,
+                           flex_trit_t const *const hash) {
+  retcode_t ret = RC_OK;
+  hash243_stack_t stack = NULL;
+  flex_trit_t current[FLEX_TRIT_SIZE_243];
+  unsolid_transaction_t *entry = NULL, *approver = NULL;
+  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+
+  if ((ret = hash243_stack_push(&stack, hash)) != RC_OK) {
+    return ret;
+  }
+
+  while (!hash243_stack_empty(stack)) {
+    memcpy(current, hash243_stack_peek(stack), FLEX_TRIT_SIZE_243);
+    hash243_stack_pop(&stack);
+
+    if ((ret = hash243_set_add(&check->newly_solid, current)) != RC_OK ||
+        (ret = hash243_set_add(&ts->solidifying, current)) != RC_OK) {
       goto done;
     }
-
-    for (size_t approver_index = 0; approver_index < hash_pack.num_loaded;
-         ++approver_index) {
-      approver_hash = ((flex_trit_t *)hash_pack.models[approver_index]);
-      if (hash243_set_contains(&transactions_to_propagate, approver_hash)) {
-        continue;
-      }
-      if ((ret =
-               iota_consensus_transaction_solidifier_check_and_update_solid_state(
-                   ts, tangle, approver_hash)) != RC_OK) {
-        log_error(logger_id,
-                  "Checking and updating solid state while propagating "
-                  "solidity failed\n");
-        goto done;
+    HASH_FIND(hh, ts->frontier, current, FLEX_TRIT_SIZE_243, entry);
+    if (entry == NULL) {
+      continue;
+    }
+    HASH_ITER(hh, entry->approvers, iter, tmp) {
+      HASH_FIND(hh, ts->frontier, iter->hash, FLEX_TRIT_SIZE_243, approver);
+      if (approver && approver->tracked && approver->unsolid_approvees > 0 &&
+          --approver->unsolid_approvees == 0) {
+        if ((ret = hash243_stack_push(&stack, approver->hash)) != RC_OK) {
+          goto done;
+        }
       }
     }
+    if (entry->milestone) {
+      check->milestones++;
+    }
+    frontier_remove(ts, entry);
   }
 
 done:
-  hash243_set_free(&transactions_to_propagate);
-  hash_pack_free(&hash_pack);
+  hash243_stack_free(&stack);
   return ret;
 }
 
-static void *spawn_solid_transactions_propagation(void *arg) {
-  transaction_solidifier_t *ts = (transaction_solidifier_t *)arg;
-  connection_config_t db_conf = {.db_path = ts->conf->db_path};
-  tangle_t tangle;
+/**
+ * Registers an approver as waiting for an approvee unless the approvee is
+ * solid, the approvee must be known. Stored approvees unknown to the frontier
+ * are queued to be tracked and missing ones are requested.
+ */
+static retcode_t await_approvee(transaction_solidifier_t *const ts,
+                                solidity_check_t *const check,
+                                unsolid_transaction_t *const approver,
+                                flex_trit_t const *const approvee) {
+  retcode_t ret = RC_OK;
+  unsolid_transaction_t *entry = NULL;
+  loaded_transaction_t *loaded = NULL;
 
-  if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
-    log_critical(logger_id, "Initializing tangle connection failed\n");
-    return NULL;
+  if (memcmp(approvee, ts->conf->genesis_hash, FLEX_TRIT_SIZE_243) == 0) {
+    return RC_OK;
   }
 
-  while (ts->running) {
-    while (hash243_set_size(&ts->newly_set_solid_transactions) > 0) {
-      if (propagate_solid_transactions(ts, &tangle) != RC_OK) {
-        log_error(logger_id, "Solid transaction propagation failed\n");
+  HASH_FIND(hh, ts->frontier, approvee, FLEX_TRIT_SIZE_243, entry);
+  if (entry == NULL) {
+    if (hash243_set_contains(&ts->solidifying, approvee)) {
+      return RC_OK;
+    }
+    loaded = loaded_find(check, approvee);
+    if (loaded->found && loaded->solid) {
+      return RC_OK;
+    }
+    if ((ret = frontier_add(ts, approvee, &entry)) != RC_OK) {
+      return ret;
+    }
+    if (loaded->found) {
+      frontier_set_stored(entry, loaded);
+      if ((ret = hash243_stack_push(&check->to_track, approvee)) != RC_OK) {
+        return ret;
       }
+    } else if ((ret = hash243_set_add(&check->to_request, approvee)) !=
+               RC_OK) {
+      return ret;
     }
-    usleep(SOLID_PROPAGATION_INTERVAL);
+  } else if (!entry->stored && check->is_milestone &&
+             (ret = hash243_set_add(&check->to_request, approvee)) != RC_OK) {
+    return ret;
   }
 
-  if (iota_tangle_destroy(&tangle) != RC_OK) {
-    log_critical(logger_id, "Destroying tangle connection failed\n");
+  if ((ret = hash243_set_add(&entry->approvers, approver->hash)) != RC_OK) {
+    return ret;
   }
+  approver->unsolid_approvees++;
 
-  return NULL;
+  return RC_OK;
 }
 
-/*
- * Public functions
+/**
+ * Awaits the approvees of the stored transactions queued to be tracked and,
+ * transitively, of their stored unsolid ancestors. Transactions whose
+ * approvees are not known yet are deferred to the next pass.
  */
+static retcode_t track(transaction_solidifier_t *const ts,
+                       solidity_check_t *const check) {
+  retcode_t ret = RC_OK;
+  hash243_stack_t deferred = NULL;
+  flex_trit_t current[FLEX_TRIT_SIZE_243];
+  unsolid_transaction_t *entry = NULL;
+  bool known = true;
+
+  while (!hash243_stack_empty(check->to_track)) {
+    memcpy(current, hash243_stack_peek(check->to_track), FLEX_TRIT_SIZE_243);
+    hash243_stack_pop(&check->to_track);
+
+    HASH_FIND(hh, ts->frontier, current, FLEX_TRIT_SIZE_243, entry);
+    if (entry == NULL || !entry->stored || entry->tracked) {
+      continue;
+    }
+    known = true;
+    if (!approvee_known(ts, check, entry->trunk)) {
+      known = false;
+      if ((ret = hash243_set_add(&check->to_load, entry->trunk)) != RC_OK) {
+        goto done;
+      }
+    }
+    if (!approvee_known(ts, check, entry->branch)) {
+      known = false;
+      if ((ret = hash243_set_add(&check->to_load, entry->branch)) != RC_OK) {
+        goto done;
+      }
+    }
+    if (!known) {
+      if ((ret = hash243_stack_push(&deferred, current)) != RC_OK) {
+        goto done;
+      }
+      continue;
+    }
 
-retcode_t iota_consensus_transaction_solidifier_init(
-    transaction_solidifier_t *const ts, iota_consensus_conf_t *const conf,
-    transaction_requester_t *const transaction_requester,
-    tips_cache_t *const tips) {
-  ts->conf = conf;
-  ts->transaction_requester = transaction_requester;
-  ts->running = false;
-  ts->newly_set_solid_transactions = NULL;
-  ts->tips = tips;
-  lock_handle_init(&ts->lock);
-  logger_id = logger_helper_enable(TRANSACTION_SOLIDIFIER_LOGGER_ID,
-                                   LOGGER_DEBUG, true);
-  return RC_OK;
+    // Approvees are awaited from scratch as a previous attempt may have been
+    // interrupted by an eviction
+    entry->unsolid_approvees = 0;
+    if ((ret = await_approvee(ts, check, entry, entry->trunk)) != RC_OK) {
+      goto done;
+    }
+    if (memcmp(entry->trunk, entry->branch, FLEX_TRIT_SIZE_243) != 0 &&
+        (ret = await_approvee(ts, check, entry, entry->branch)) != RC_OK) {
+      goto done;
+    }
+    entry->tracked = true;
+    if (entry->unsolid_approvees == 0 &&
+        (ret = set_solid(ts, check, current)) != RC_OK) {
+      goto done;
+    }
+  }
+
+done:
+  hash243_stack_free(&check->to_track);
+  check->to_track = deferred;
+  return ret;
 }
 
-retcode_t iota_consensus_transaction_solidifier_start(
-    transaction_solidifier_t *const ts) {
-  if (ts == NULL) {
-    return RC_CONSENSUS_NULL_PTR;
+/**
+ * Resolves a transaction that is not stored in the frontier from what was
+ * loaded: missing ones are requested, solid ones release their approvers and
+ * stored ones are queued to be tracked
+ */
+static retcode_t resolve(transaction_solidifier_t *const ts,
+                         solidity_check_t *const check,
+                         flex_trit_t const *const hash,
+                         unsolid_transaction_t *entry,
+                         loaded_transaction_t const *const loaded) {
+  retcode_t ret = RC_OK;
+
+  if (!loaded->found) {
+    return hash243_set_add(&check->to_request, hash);
+  } else if (loaded->solid) {
+    return entry ? set_solid(ts, check, hash) : RC_OK;
   }
 
-  ts->running = true;
-  log_info(logger_id, "Spawning transaction solidifier thread\n");
-  if (thread_handle_create(
-          &ts->thread, (thread_routine_t)spawn_solid_transactions_propagation,
-          ts) != 0) {
-    log_critical(logger_id, "Spawning transaction solidifier thread failed\n");
-    return RC_FAILED_THREAD_SPAWN;
+  if (entry == NULL && (ret = frontier_add(ts, hash, &entry)) != RC_OK) {
+    return ret;
   }
-  return RC_OK;
+  frontier_set_stored(entry, loaded);
+  return hash243_stack_push(&check->to_track, hash);
 }
 
-retcode_t iota_consensus_transaction_solidifier_stop(
-    transaction_solidifier_t *const ts) {
+/**
+ * Walks the stored ancestors of a tracked transaction to look for the missing
+ * ones again, in case they arrived, the requester dropped them or they have to
+ * be prioritized as milestones. Ancestors whose approvees were evicted are
+ * tracked again.
+ */
+static retcode_t walk_ancestors(transaction_solidifier_t *const ts,
+                                solidity_check_t *const check,
+                                flex_trit_t const *const hash) {
   retcode_t ret = RC_OK;
+  hash243_stack_t stack = NULL;
+  hash243_set_t visited = NULL;
+  flex_trit_t current[FLEX_TRIT_SIZE_243];
+  unsolid_transaction_t *entry = NULL;
 
-  if (ts == NULL) {
-    return RC_CONSENSUS_NULL_PTR;
-  } else if (ts->running == false) {
-    return RC_OK;
+  if ((ret = hash243_stack_push(&stack, hash)) != RC_OK) {
+    return ret;
   }
 
-  ts->running = false;
+  while (!hash243_stack_empty(stack)) {
+    memcpy(current, hash243_stack_peek(stack), FLEX_TRIT_SIZE_243);
+    hash243_stack_pop(&stack);
 
-  log_info(logger_id, "Shutting down transaction solidifier thread\n");
-  if (thread_handle_join(ts->thread, NULL) != 0) {
-    log_error(logger_id,
-              "Shutting down transaction solidifier thread failed\n");
-    ret = RC_FAILED_THREAD_JOIN;
+    if (hash243_set_contains(&visited, current)) {
+      continue;
+    }
+    if ((ret = hash243_set_add(&visited, current)) != RC_OK) {
+      goto done;
+    }
+    HASH_FIND(hh, ts->frontier, current, FLEX_TRIT_SIZE_243, entry);
+    if (entry == NULL) {
+      continue;
+    } else if (!entry->stored) {
+      if ((ret = hash243_set_add(&check->awaited, current)) != RC_OK ||
+          (ret = hash243_set_add(&check->to_load, current)) != RC_OK) {
+        goto done;
+      }
+      continue;
+    } else if (!entry->tracked &&
+               (ret = hash243_stack_push(&check->to_track, current)) !=
+                   RC_OK) {
+      goto done;
+    }
+    if ((ret = hash243_stack_push(&stack, entry->trunk)) != RC_OK ||
+        (ret = hash243_stack_push(&stack, entry->branch)) != RC_OK) {
+      goto done;
+    }
   }
+
+done:
+  hash243_stack_free(&stack);
+  hash243_set_free(&visited);
   return ret;
 }
 
-retcode_t iota_consensus_transaction_solidifier_destroy(
-    transaction_solidifier_t *const ts) {
-  if (ts == NULL) {
-    return RC_CONSENSUS_NULL_PTR;
-  } else if (ts->running) {
-    return RC_STILL_RUNNING;
+/**
+ * Resolves the checked transaction once it is known
+ */
+static retcode_t check_transaction(transaction_solidifier_t *const ts,
+                                   solidity_check_t *const check,
+                                   flex_trit_t const *const hash) {
+  retcode_t ret = RC_OK;
+  unsolid_transaction_t *entry = NULL;
+  loaded_transaction_t *loaded = NULL;
+
+  HASH_FIND(hh, ts->frontier, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry && entry->stored) {
+    // Already tracked, solidity will be propagated when its approvees arrive
+    check->pending = false;
+    entry->milestone |= check->is_milestone;
+    return walk_ancestors(ts, check, hash);
+  } else if (entry == NULL && hash243_set_contains(&ts->solidifying, hash)) {
+    check->pending = false;
+    check->is_solid = true;
+    return RC_OK;
+  } else if ((loaded = loaded_find(check, hash)) == NULL) {
+    return hash243_set_add(&check->to_load, hash);
   }
 
-  ts->transaction_requester = NULL;
-  ts->newly_set_solid_transactions = NULL;
-  ts->conf = NULL;
-
-  lock_handle_destroy(&ts->lock);
+  check->pending = false;
+  check->is_solid = loaded->found && loaded->solid;
+  if ((ret = resolve(ts, check, hash, entry, loaded)) != RC_OK) {
+    return ret;
+  }
+  HASH_FIND(hh, ts->frontier, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry) {
+    entry->milestone |= check->is_milestone;
+  }
 
-  logger_helper_release(logger_id);
   return RC_OK;
 }
 
-static retcode_t check_solidity_do_func(flex_trit_t *hash,
-                                        iota_stor_pack_t *pack, void *data,
-                                        bool *should_branch,
-                                        bool *should_stop) {
-  *should_stop = false;
-  *should_branch = false;
-  check_solidity_do_func_params_t *params = data;
-  transaction_solidifier_t *ts = params->ts;
-  tangle_t *tangle = params->tangle;
-
-  // Transaction is not marked solid, but it is a candidate
-  if (pack->num_loaded == 1 &&
-      !(transaction_solid((iota_transaction_t *)pack->models[0]))) {
-    *should_branch = true;
-    return hash243_set_add(params->solid_transactions_candidates, hash);
-  } else if (pack->num_loaded == 0) {
-    params->is_solid = false;
-    return request_transaction(ts->transaction_requester, tangle, hash,
-                               params->is_milestone);
+/**
+ * Resolves the awaited transactions of the frontier that were loaded
+ */
+static retcode_t check_awaited(transaction_solidifier_t *const ts,
+                               solidity_check_t *const check) {
+  retcode_t ret = RC_OK;
+  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  unsolid_transaction_t *entry = NULL;
+  loaded_transaction_t *loaded = NULL;
+
+  HASH_ITER(hh, check->awaited, iter, tmp) {
+    if ((loaded = loaded_find(check, iter->hash)) == NULL) {
+      continue;
+    }
+    memcpy(hash, iter->hash, FLEX_TRIT_SIZE_243);
+    hash243_set_remove_entry(&check->awaited, iter);
+    HASH_FIND(hh, ts->frontier, hash, FLEX_TRIT_SIZE_243, entry);
+    if (entry && !entry->stored &&
+        (ret = resolve(ts, check, hash, entry, loaded)) != RC_OK) {
+      return ret;
+    }
   }
 
   return RC_OK;
 }
 
-retcode_t iota_consensus_transaction_solidifier_check_solidity(
-    transaction_solidifier_t *const ts, tangle_t *const tangle,
-    flex_trit_t *const hash, bool is_milestone, bool *const is_solid) {
+/**
+ * Makes a pass over the frontier with what was loaded so far, the lock must be
+ * held
+ */
+static retcode_t check_pass(transaction_solidifier_t *const ts,
+                            solidity_check_t *const check,
+                            flex_trit_t const *const hash) {
   retcode_t ret = RC_OK;
-  DECLARE_PACK_SINGLE_TX(curr_tx_s, curr_tx, pack);
-  hash243_set_t solid_transactions_candidates = NULL;
 
-  ret = iota_tangle_transaction_load_partial(
-      tangle, hash, &pack, PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA);
-  if (ret != RC_OK) {
-    log_error(logger_id, "No transactions were loaded for the provided hash\n");
+  if (check->pending && (ret = check_transaction(ts, check, hash)) != RC_OK) {
     return ret;
   }
-  if (transaction_solid(curr_tx)) {
-    *is_solid = true;
-    return RC_OK;
-  }
-
-  check_solidity_do_func_params_t params = {
-      .ts = ts,
-      .tangle = tangle,
-      .is_milestone = is_milestone,
-      .is_solid = true,
-      .solid_transactions_candidates = &solid_transactions_candidates};
-
-  if ((ret = tangle_traversal_dfs_to_genesis(tangle, check_solidity_do_func,
-                                             hash, ts->conf->genesis_hash, NULL,
-                                             &params)) != RC_OK) {
-    *is_solid = false;
-    goto done;
+  if ((ret = check_awaited(ts, check)) != RC_OK) {
+    return ret;
   }
+  return track(ts, check);
+}
 
-  if (params.is_solid) {
-    *is_solid = true;
-    log_debug(logger_id, "In %s, updating solid state\n", __FUNCTION__);
-
-    ret = iota_tangle_transactions_update_solid_state(
-        tangle, solid_transactions_candidates, true);
+/**
+ * Requests the missing transactions, the lock must not be held
+ */
+static retcode_t request_missing(transaction_solidifier_t *const ts,
+                                 solidity_check_t const *const check) {
+  retcode_t ret = RC_OK;
+  hash243_set_entry_t *iter = NULL, *tmp = NULL;
 
-    lock_handle_lock(&ts->lock);
-    hash243_set_append(&solid_transactions_candidates,
-                       &ts->newly_set_solid_transactions);
-    lock_handle_unlock(&ts->lock);
+  HASH_ITER(hh, check->to_request, iter, tmp) {
+    if ((ret = request_transaction(ts->transaction_requester, check->tangle,
+                                   iter->hash, check->is_milestone)) != RC_OK) {
+      log_error(logger_id, "Requesting missing transaction failed\n");
+      return ret;
+    }
   }
 
-done:
-  hash243_set_free(&solid_transactions_candidates);
-  return ret;
+  return RC_OK;
 }
 
-static retcode_t check_transaction_and_update_solid_state(
-    transaction_solidifier_t *const ts, tangle_t *const tangle,
-    flex_trit_t *const hash, bool *const is_new_solid) {
+/**
+ * Persists the transactions that became solid in a single batch, the lock must
+ * not be held
+ */
+static retcode_t flush_newly_solid(transaction_solidifier_t *const ts,
+                                   tangle_t *const tangle,
+                                   hash243_set_t const newly_solid) {
   retcode_t ret = RC_OK;
-  bool is_trunk_solid = false;
-  bool is_branch_solid = false;
-  DECLARE_PACK_SINGLE_TX(transaction_s, transaction, pack);
+  hash243_set_entry_t *iter = NULL, *tmp = NULL;
 
-  *is_new_solid = false;
+  if (hash243_set_size(&newly_solid) == 0) {
+    return RC_OK;
+  }
 
-  ret = iota_tangle_transaction_load_partial(
-      tangle, hash, &pack, PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA);
-  if (ret != RC_OK || pack.num_loaded == 0) {
-    log_error(logger_id, "No transactions were loaded for the provided hash\n");
+  if ((ret = iota_tangle_transactions_update_solid_state(tangle, newly_solid,
+                                                         true)) != RC_OK) {
+    log_error(logger_id, "Updating solid states failed\n");
     return ret;
   }
-
-  if (!transaction_solid(transaction)) {
-    if ((ret = check_approvee_solid_state(
-             ts, tangle, transaction_trunk(transaction), &is_trunk_solid)) !=
-        RC_OK) {
-      *is_new_solid = false;
-      log_error(logger_id, "Checking solidity of trunk failed\n");
+  HASH_ITER(hh, newly_solid, iter, tmp) {
+    if ((ret = tips_cache_set_solid(ts->tips, iter->hash)) != RC_OK) {
       return ret;
     }
+  }
 
-    if ((ret = check_approvee_solid_state(
-             ts, tangle, transaction_branch(transaction), &is_branch_solid)) !=
-        RC_OK) {
-      *is_new_solid = false;
-      log_error(logger_id, "Checking solidity of branch failed\n");
-      return ret;
-    }
+  return ret;
+}
 
-    if ((*is_new_solid = is_trunk_solid && is_branch_solid)) {
-      if ((ret = iota_tangle_transaction_update_solid_state(tangle, hash,
-                                                            true)) != RC_OK) {
-        log_error(logger_id, "Updating solid state failed\n");
-        return ret;
-      }
-    }
+/**
+ * Notifies the callback, if any, it must be read while the lock is held and
+ * called after the lock is released
+ */
+static void notify_newly_solid(newly_solid_callback_t const callback,
+                               void *const data,
+                               hash243_set_t const newly_solid) {
+  if (callback != NULL && hash243_set_size(&newly_solid) != 0) {
+    callback(data, newly_solid);
   }
+}
 
-  return ret;
+static void solidity_check_free(solidity_check_t *const check) {
+  loaded_transaction_t *loaded = NULL, *tmp = NULL;
+
+  hash243_stack_free(&check->to_track);
+  hash243_set_free(&check->awaited);
+  hash243_set_free(&check->to_load);
+  hash243_set_free(&check->to_request);
+  hash243_set_free(&check->newly_solid);
+  HASH_ITER(hh, check->loaded, loaded, tmp) {
+    HASH_DEL(check->loaded, loaded);
+    free(loaded);
+  }
 }
 
-static retcode_t check_approvee_solid_state(transaction_solidifier_t *const ts,
-                                            tangle_t *const tangle,
-                                            flex_trit_t *const approvee,
-                                            bool *solid) {
-  retcode_t ret = RC_OK;
-  DECLARE_PACK_SINGLE_TX(curr_tx_s, curr_tx, pack);
-
-  if ((ret = iota_tangle_transaction_load_partial(
-           tangle, approvee, &pack, PARTIAL_TX_MODEL_METADATA)) != RC_OK) {
-    log_error(logger_id,
-              "Loading transaction metadata for checking approvee solid state "
-              "failed\n");
-    *solid = false;
-    return ret;
+/**
+ * Checks the solidity of a transaction, tracking it if needed. Passes over the
+ * frontier are made under the lock until nothing is left to load, the tangle
+ * being accessed in between.
+ */
+static retcode_t check_solidity(transaction_solidifier_t *const ts,
+                                tangle_t *const tangle,
+                                flex_trit_t const *const hash,
+                                iota_transaction_t const *const stored_tx,
+                                bool const is_milestone,
+                                bool *const is_solid) {
+  retcode_t ret = RC_OK, flush_ret = RC_OK;
+  solidity_check_t check;
+  hash243_set_entry_t *iter = NULL, *tmp = NULL;
+  newly_solid_callback_t callback = NULL;
+  void *data = NULL;
+  uint64_t latency = 0;
+
+  memset(&check, 0, sizeof(solidity_check_t));
+  check.tangle = tangle;
+  check.is_milestone = is_milestone;
+  check.pending = true;
+  if (stored_tx != NULL) {
+    check.arrival_us = current_timestamp_us();
+    ret = loaded_add(&check, hash, stored_tx);
   }
 
-  if (pack.num_loaded == 0) {
-    *solid = false;
-    if ((ret = request_transaction(ts->transaction_requester, tangle, approvee,
-                                   false)) != RC_OK) {
-      log_error(logger_id, "Requesting missing approvee failed\n");
+  while (ret == RC_OK) {
+    lock_handle_lock(&ts->lock);
+    ret = check_pass(ts, &check, hash);
+    frontier_trim(ts);
+    lock_handle_unlock(&ts->lock);
+    if (ret != RC_OK || hash243_set_size(&check.to_load) == 0) {
+      break;
     }
-    return ret;
+    ret = load(&check);
   }
 
-  if (memcmp(approvee, ts->conf->genesis_hash, FLEX_TRIT_SIZE_243) == 0) {
-    *solid = true;
-    return ret;
+  if (ret == RC_OK) {
+    ret = request_missing(ts, &check);
+  }
+  // Transactions set solid are persisted even if the check failed since they
+  // left the frontier
+  flush_ret = flush_newly_solid(ts, tangle, check.newly_solid);
+
+  lock_handle_lock(&ts->lock);
+  HASH_ITER(hh, check.newly_solid, iter, tmp) {
+    hash243_set_remove(&ts->solidifying, iter->hash);
+  }
+  if (flush_ret == RC_OK && check.milestones != 0 && check.arrival_us != 0) {
+    latency = current_timestamp_us() - check.arrival_us;
+    ts->milestones += check.milestones;
+    ts->total_latency_us += latency * check.milestones;
+    if (latency > ts->max_latency_us) {
+      ts->max_latency_us = latency;
+    }
   }
+  callback = ts->on_newly_solid;
+  data = ts->on_newly_solid_data;
+  lock_handle_unlock(&ts->lock);
 
-  *solid = transaction_solid(curr_tx);
+  if (flush_ret == RC_OK) {
+    notify_newly_solid(callback, data, check.newly_solid);
+  }
 
-  return ret;
+  *is_solid = check.is_solid || hash243_set_contains(&check.newly_solid, hash);
+  solidity_check_free(&check);
+  return ret != RC_OK ? ret : flush_ret;
 }
 
-retcode_t iota_consensus_transaction_solidifier_check_and_update_solid_state(
-    transaction_solidifier_t *const ts, tangle_t *const tangle,
-    flex_trit_t *const hash) {
-  retcode_t ret = RC_OK;
-  bool is_new_solid = false;
+/*
+ * Public functions
+ */
 
-  if (ts->transaction_requester == NULL) {
-    return RC_OK;
+retcode_t iota_consensus_transaction_solidifier_init(
+    transaction_solidifier_t *const ts, iota_consensus_conf_t *const conf,
+    transaction_requester_t *const transaction_requester,
+    tips_cache_t *const tips) {
+  ts->conf = conf;
+  ts->transaction_requester = transaction_requester;
+  ts->running = false;
+  ts->frontier = NULL;
+  ts->frontier_capacity = TRANSACTION_SOLIDIFIER_FRONTIER_CAPACITY;
+  ts->solidifying = NULL;
+  ts->tips = tips;
+  ts->on_newly_solid = NULL;
+  ts->on_newly_solid_data = NULL;
+  ts->evictions = 0;
+  ts->milestones = 0;
+  ts->total_latency_us = 0;
+  ts->max_latency_us = 0;
+  lock_handle_init(&ts->lock);
+  logger_id = logger_helper_enable(TRANSACTION_SOLIDIFIER_LOGGER_ID,
+                                   LOGGER_DEBUG, true);
+  return RC_OK;
+}
+
+retcode_t iota_consensus_transaction_solidifier_start(
+    transaction_solidifier_t *const ts) {
+  if (ts == NULL) {
+    return RC_CONSENSUS_NULL_PTR;
   }
 
-  if ((ret = check_transaction_and_update_solid_state(ts, tangle, hash,
-                                                      &is_new_solid))) {
-    log_error(logger_id,
-              "In %s, failed check_transaction_and_update_solid_state\n",
-              __FUNCTION__);
-    return ret;
+  ts->running = true;
+  return RC_OK;
+}
+
+retcode_t iota_consensus_transaction_solidifier_stop(
+    transaction_solidifier_t *const ts) {
+  if (ts == NULL) {
+    return RC_CONSENSUS_NULL_PTR;
   }
 
-  if (is_new_solid) {
-    return add_new_solid_transaction(ts, hash);
+  ts->running = false;
+  return RC_OK;
+}
+
+retcode_t iota_consensus_transaction_solidifier_destroy(
+    transaction_solidifier_t *const ts) {
+  unsolid_transaction_t *entry = NULL, *tmp = NULL;
+
+  if (ts == NULL) {
+    return RC_CONSENSUS_NULL_PTR;
+  } else if (ts->running) {
+    return RC_STILL_RUNNING;
   }
 
-  return ret;
+  HASH_ITER(hh, ts->frontier, entry, tmp) { frontier_remove(ts, entry); }
+  hash243_set_free(&ts->solidifying);
+  ts->transaction_requester = NULL;
+  ts->conf = NULL;
+
+  lock_handle_destroy(&ts->lock);
+
+  logger_helper_release(logger_id);
+  return RC_OK;
 }
 
-static retcode_t add_new_solid_transaction(transaction_solidifier_t *const ts,
-                                           flex_trit_t *const hash) {
-  retcode_t ret = RC_OK;
+retcode_t iota_consensus_transaction_solidifier_on_newly_solid(
+    transaction_solidifier_t *const ts, newly_solid_callback_t const callback,
+    void *const data) {
+  if (ts == NULL) {
+    return RC_CONSENSUS_NULL_PTR;
+  }
 
   lock_handle_lock(&ts->lock);
-  ret = hash243_set_add(&ts->newly_set_solid_transactions, hash);
+  ts->on_newly_solid = callback;
+  ts->on_newly_solid_data = data;
   lock_handle_unlock(&ts->lock);
+  return RC_OK;
+}
 
-  if (ret != RC_OK) {
-    return ret;
+retcode_t iota_consensus_transaction_solidifier_check_solidity(
+    transaction_solidifier_t *const ts, tangle_t *const tangle,
+    flex_trit_t *const hash, bool is_milestone, bool *const is_solid) {
+  return check_solidity(ts, tangle, hash, NULL, is_milestone, is_solid);
+}
+
+retcode_t iota_consensus_transaction_solidifier_check_and_update_solid_state(
+    transaction_solidifier_t *const ts, tangle_t *const tangle,
+    flex_trit_t *const hash) {
+  bool is_solid = false;
+
+  if (ts->transaction_requester == NULL) {
+    return RC_OK;
   }
 
-  return tips_cache_set_solid(ts->tips, hash);
+  return iota_consensus_transaction_solidifier_check_solidity(
+      ts, tangle, hash, false, &is_solid);
 }
 
 retcode_t iota_consensus_transaction_solidifier_update_status(
@@ -402,6 +766,7 @@ retcode_t iota_consensus_transaction_solidifier_update_status(
     iota_transaction_t *const tx) {
   retcode_t ret = RC_OK;
   size_t approvers_count = 0;
+  bool is_solid = false;
 
   if ((ret = requester_clear_request(ts->transaction_requester,
                                      transaction_hash(tx))) != RC_OK) {
@@ -424,6 +789,20 @@ retcode_t iota_consensus_transaction_solidifier_update_status(
     return ret;
   }
 
-  return iota_consensus_transaction_solidifier_check_and_update_solid_state(
-      ts, tangle, transaction_hash(tx));
+  // The stored transaction is used as is, if approvers were waiting for it
+  // they are now solidified along with it
+  return check_solidity(ts, tangle, transaction_hash(tx), tx, false,
+                        &is_solid);
+}
+
+void iota_consensus_transaction_solidifier_stats(
+    transaction_solidifier_t *const ts,
+    transaction_solidifier_stats_t *const stats) {
+  lock_handle_lock(&ts->lock);
+  stats->frontier_size = HASH_COUNT(ts->frontier);
+  stats->evictions = ts->evictions;
+  stats->milestones = ts->milestones;
+  stats->total_latency_us = ts->total_latency_us;
+  stats->max_latency_us = ts->max_latency_us;
+  lock_handle_unlock(&ts->lock);
 }
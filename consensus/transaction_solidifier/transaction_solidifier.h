@@ -21,22 +21,60 @@
 #include "utils/containers/hash/hash243_set.h"
 #include "utils/containers/hash/hash243_stack.h"
 #include "utils/handles/lock.h"
-#include "utils/handles/thread.h"
+
+// Maximum number of transactions tracked by the frontier, the oldest ones are
+// evicted beyond it
+#define TRANSACTION_SOLIDIFIER_FRONTIER_CAPACITY 100000
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Unsolid transaction of the frontier, defined in the implementation
+typedef struct unsolid_transaction_s unsolid_transaction_t;
+
+// Notified with the transactions that just became solid
+typedef void (*newly_solid_callback_t)(void *data,
+                                       hash243_set_t const newly_solid);
+
+// Solidity is propagated as soon as transactions are stored: the frontier
+// keeps, for every unsolid transaction, how many of its approvees are not
+// solid yet and which approvers wait for it so that a transaction becoming
+// solid immediately cascades to its approvers without rescanning the tangle.
+// The tangle is only accessed outside of the lock, which is held to update
+// the frontier from what was loaded. Once the frontier is full, the oldest
+// transactions are evicted and their approvers are checked against the tangle
+// again the next time they are checked.
 typedef struct transaction_solidifier_s {
   iota_consensus_conf_t *conf;
   transaction_requester_t *transaction_requester;
-  thread_handle_t thread;
   bool running;
+  // Protects the frontier, the solidifying transactions and the statistics
   lock_handle_t lock;
-  hash243_set_t newly_set_solid_transactions;
+  unsolid_transaction_t *frontier;
+  size_t frontier_capacity;
+  // Transactions set solid whose solid state is not persisted yet
+  hash243_set_t solidifying;
   tips_cache_t *tips;
+  newly_solid_callback_t on_newly_solid;
+  void *on_newly_solid_data;
+  uint64_t evictions;
+  uint64_t milestones;
+  uint64_t total_latency_us;
+  uint64_t max_latency_us;
 } transaction_solidifier_t;
 
+typedef struct transaction_solidifier_stats_s {
+  size_t frontier_size;
+  uint64_t evictions;
+  // Number of milestones that became solid on the arrival of their last
+  // missing ancestor
+  uint64_t milestones;
+  // Time from that arrival to the milestone being solid, in microseconds
+  uint64_t total_latency_us;
+  uint64_t max_latency_us;
+} transaction_solidifier_stats_t;
+
 retcode_t iota_consensus_transaction_solidifier_init(
     transaction_solidifier_t *const ts, iota_consensus_conf_t *const conf,
     transaction_requester_t *const transaction_requester,
@@ -51,6 +89,32 @@ retcode_t iota_consensus_transaction_solidifier_stop(
 retcode_t iota_consensus_transaction_solidifier_destroy(
     transaction_solidifier_t *const ts);
 
+/**
+ * Sets the callback notified, outside of the solidifier lock, with every batch
+ * of transactions that became solid
+ *
+ * @param ts The transaction solidifier
+ * @param callback The callback, NULL to unset it
+ * @param data Data passed to the callback
+ *
+ * @return a status code
+ */
+retcode_t iota_consensus_transaction_solidifier_on_newly_solid(
+    transaction_solidifier_t *const ts, newly_solid_callback_t const callback,
+    void *const data);
+
+/**
+ * Checks whether a transaction is solid, tracking it and its unsolid ancestors
+ * in the frontier if it is not and requesting its missing ancestors
+ *
+ * @param ts The transaction solidifier
+ * @param tangle A tangle
+ * @param hash The transaction hash
+ * @param is_milestone Whether missing ancestors are requested as milestones
+ * @param is_solid Whether the transaction is solid
+ *
+ * @return a status code
+ */
 retcode_t iota_consensus_transaction_solidifier_check_solidity(
     transaction_solidifier_t *const ts, tangle_t *const tangle,
     flex_trit_t *const hash, bool is_milestone, bool *const is_solid);
@@ -59,10 +123,30 @@ retcode_t iota_consensus_transaction_solidifier_check_and_update_solid_state(
     transaction_solidifier_t *const ts, tangle_t *const tangle,
     flex_trit_t *const hash);
 
+/**
+ * Updates the requester, the tips and the solidity of a newly stored
+ * transaction and cascades solidity to the approvers waiting for it
+ *
+ * @param ts The transaction solidifier
+ * @param tangle A tangle
+ * @param tx The newly stored transaction
+ *
+ * @return a status code
+ */
 retcode_t iota_consensus_transaction_solidifier_update_status(
     transaction_solidifier_t *const ts, tangle_t *const tangle,
     iota_transaction_t *const tx);
 
+/**
+ * Gets the statistics of a transaction solidifier
+ *
+ * @param ts The transaction solidifier
+ * @param stats The statistics
+ */
+void iota_consensus_transaction_solidifier_stats(
+    transaction_solidifier_t *const ts,
+    transaction_solidifier_stats_t *const stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -10,6 +10,7 @@
 #include <unity/unity.h>
 
 #include "common/model/transaction.h"
+#include "common/trinary/trit_tryte.h"
 #include "consensus/conf.h"
 #include "consensus/test_utils/bundle.h"
 #include "consensus/transaction_validator/transaction_validator.h"
@@ -174,6 +175,41 @@ void transaction_is_valid() {
   transaction_free(tx1);
 }
 
+void transaction_view_is_valid() {
+  flex_trit_t transaction_1_trits[FLEX_TRIT_SIZE_8019];
+  trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION];
+  byte_t bytes[NUM_BYTES_SERIALIZED_TRANSACTION];
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  transaction_view_t view;
+
+  flex_trits_from_trytes(transaction_1_trits, NUM_TRITS_SERIALIZED_TRANSACTION,
+                         TX_1_OF_4_VALUE_BUNDLE_TRYTES,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION,
+                         NUM_TRYTES_SERIALIZED_TRANSACTION);
+  trytes_to_trits(TX_1_OF_4_VALUE_BUNDLE_TRYTES, trits,
+                  NUM_TRYTES_SERIALIZED_TRANSACTION);
+  trits_to_bytes(trits, bytes, NUM_TRITS_SERIALIZED_TRANSACTION);
+
+  iota_transaction_t *tx1 = transaction_deserialize(transaction_1_trits, true);
+  memcpy(hash, transaction_hash(tx1), FLEX_TRIT_SIZE_243);
+  transaction_validator_t tv;
+  conf.snapshot_timestamp_sec = transaction_attachment_timestamp(tx1) / 1000;
+  TEST_ASSERT(iota_consensus_transaction_validator_init(&tv, &conf) == RC_OK);
+
+  transaction_view_init(&view, bytes, hash);
+  TEST_ASSERT_TRUE(iota_consensus_transaction_view_validate(&tv, &view));
+
+  transaction_view_init(&view, bytes, NULL);
+  TEST_ASSERT_FALSE(iota_consensus_transaction_view_validate(&tv, &view));
+
+  hash[FLEX_TRIT_SIZE_243 - 1] = hash[0];
+  transaction_view_init(&view, bytes, hash);
+  TEST_ASSERT_FALSE(iota_consensus_transaction_view_validate(&tv, &view));
+
+  TEST_ASSERT(iota_consensus_transaction_validator_destroy(&tv) == RC_OK);
+  transaction_free(tx1);
+}
+
 int main(int argc, char *argv[]) {
   UNITY_BEGIN();
 
@@ -188,6 +224,7 @@ int main(int argc, char *argv[]) {
   RUN_TEST(transaction_invalid_value_tx_wrong_address);
   RUN_TEST(transaction_invalid_timestamp_too_futuristic);
   RUN_TEST(transaction_invalid_timestamp_too_old);
+  RUN_TEST(transaction_view_is_valid);
 
   return UNITY_END();
 }
@@ -29,32 +29,71 @@ static uint64_t MAX_TIMESTAMP_FUTURE_MS = 2 * 60 * 60 * 1000;
  * Genesis transaction will always be valid.
  *
  * @param tv Transaction validator
- * @param transaction Transaction under test
+ * @param timestamp Timestamp of the transaction under test
+ * @param attachment_timestamp Attachment timestamp of the transaction
+ * @param hash Hash of the transaction
  *
  * @returns true if timestamp is invalid, false otherwise
  */
 static bool has_invalid_timestamp(transaction_validator_t const* const tv,
-                                  iota_transaction_t const* const transaction) {
-  uint64_t timestamp_ms = transaction_attachment_timestamp(transaction) == 0
-                              ? transaction_timestamp(transaction) * 1000UL
-                              : transaction_attachment_timestamp(transaction);
+                                  uint64_t const timestamp,
+                                  uint64_t const attachment_timestamp,
+                                  flex_trit_t const* const hash) {
+  uint64_t timestamp_ms =
+      attachment_timestamp == 0 ? timestamp * 1000UL : attachment_timestamp;
+  uint64_t snapshot_timestamp_sec =
+      __atomic_load_n(&tv->conf->snapshot_timestamp_sec, __ATOMIC_ACQUIRE);
   bool is_too_futuristic =
       timestamp_ms > (current_timestamp_ms() + MAX_TIMESTAMP_FUTURE_MS);
   bool is_below_snapshot =
-      timestamp_ms < tv->conf->snapshot_timestamp_sec * 1000UL;
+      timestamp_ms < snapshot_timestamp_sec * 1000UL;
 
   if (is_too_futuristic) {
     return true;
   }
 
   if (is_below_snapshot) {
-    return memcmp(transaction_hash(transaction), tv->conf->genesis_hash,
-                  FLEX_TRIT_SIZE_243) != 0;
+    return memcmp(hash, tv->conf->genesis_hash, FLEX_TRIT_SIZE_243) != 0;
   }
 
   return false;
 }
 
+/**
+ * Runs the validation checks that don't need the address of the transaction
+ *
+ * @param tv Transaction validator
+ * @param hash Hash of the transaction
+ * @param timestamp Timestamp of the transaction
+ * @param attachment_timestamp Attachment timestamp of the transaction
+ * @param value Value of the transaction
+ *
+ * @returns true if valid, false otherwise
+ */
+static bool validate_fields(transaction_validator_t const* const tv,
+                            flex_trit_t const* const hash,
+                            uint64_t const timestamp,
+                            uint64_t const attachment_timestamp,
+                            int64_t const value) {
+  if (transaction_hash_weight_magnitude(hash) < tv->conf->mwm) {
+    log_debug(logger_id,
+              "Validation failed: insufficient transaction weight\n");
+    return false;
+  }
+
+  if (has_invalid_timestamp(tv, timestamp, attachment_timestamp, hash)) {
+    log_debug(logger_id, "Validation failed: invalid timestamp\n");
+    return false;
+  }
+
+  if (llabs(value) > IOTA_SUPPLY) {
+    log_debug(logger_id, "Validation failed: invalid value\n");
+    return false;
+  }
+
+  return true;
+}
+
 /*
  * Public functions
  */
@@ -79,25 +118,42 @@ retcode_t iota_consensus_transaction_validator_destroy(
 bool iota_consensus_transaction_validate(
     transaction_validator_t const* const tv,
     iota_transaction_t const* const transaction) {
-  if (transaction_weight_magnitude(transaction) < tv->conf->mwm) {
+  if (!validate_fields(tv, transaction_hash(transaction),
+                       transaction_timestamp(transaction),
+                       transaction_attachment_timestamp(transaction),
+                       transaction_value(transaction))) {
+    return false;
+  }
+
+  if (transaction_value(transaction) != 0 &&
+      flex_trits_at(transaction_address(transaction), NUM_TRITS_ADDRESS,
+                    NUM_TRITS_ADDRESS - 1) != 0) {
     log_debug(logger_id,
-              "Validation failed: insufficient transaction weight\n");
+              "Validation failed: invalid address for value transaction\n");
     return false;
   }
 
-  if (has_invalid_timestamp(tv, transaction)) {
-    log_debug(logger_id, "Validation failed: invalid timestamp\n");
+  return true;
+}
+
+bool iota_consensus_transaction_view_validate(
+    transaction_validator_t const* const tv, transaction_view_t* const view) {
+  if (transaction_view_hash(view) == NULL) {
+    log_debug(logger_id, "Validation failed: unknown transaction hash\n");
     return false;
   }
 
-  if (llabs(transaction_value(transaction)) > IOTA_SUPPLY) {
-    log_debug(logger_id, "Validation failed: invalid value\n");
+  if (!validate_fields(tv, transaction_view_hash(view),
+                       transaction_view_timestamp(view),
+                       transaction_view_attachment_timestamp(view),
+                       transaction_view_value(view))) {
     return false;
   }
 
-  if (transaction_value(transaction) != 0 &&
-      flex_trits_at(transaction_address(transaction), NUM_TRITS_ADDRESS,
-                    NUM_TRITS_ADDRESS - 1) != 0) {
+  // Only the last trit of the address is decoded
+  if (transaction_view_value(view) != 0 &&
+      transaction_view_trit_at(view, NUM_TRITS_SIGNATURE + NUM_TRITS_ADDRESS -
+                                         1) != 0) {
     log_debug(logger_id,
               "Validation failed: invalid address for value transaction\n");
     return false;
@@ -12,6 +12,7 @@
 
 #include "common/errors.h"
 #include "common/model/transaction.h"
+#include "common/model/transaction_view.h"
 #include "consensus/conf.h"
 
 #ifdef __cplusplus
@@ -63,6 +64,18 @@ bool iota_consensus_transaction_validate(
     transaction_validator_t const *const tv,
     iota_transaction_t const *const transaction);
 
+/**
+ * Runs the same validation checks on a transaction view, decoding only the
+ * fields they need
+ *
+ * @param tv The transaction validator
+ * @param view A view, with a known hash, of the transaction under test
+ *
+ * @return true if valid, false otherwise
+ */
+bool iota_consensus_transaction_view_validate(
+    transaction_validator_t const *const tv, transaction_view_t *const view);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,6 +5,7 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "consensus/tangle/tangle.h"
@@ -13,7 +14,9 @@
 #include "utils/logger_helper.h"
 
 #define BROADCASTER_LOGGER_ID "broadcaster"
-#define BROADCASTER_TIMEOUT_SEC 5
+// Transactions broadcast per run of the task
+#define BROADCASTER_BATCH_SIZE 16
+#define BROADCASTER_POOL_MAX_SIZE 64
 
 static logger_id_t logger_id;
 
@@ -21,62 +24,61 @@ static logger_id_t logger_id;
  * Private functions
  */
 
-static void *broadcaster_routine(broadcaster_t *const broadcaster) {
-  neighbor_t *iter = NULL;
-  flex_trit_t *transaction_flex_trits_ptr = NULL;
-  flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
-  connection_config_t db_conf = {.db_path = broadcaster->node->conf.db_path};
-  tangle_t tangle;
-
-  if (broadcaster == NULL) {
-    return NULL;
-  }
-
-  if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
-    log_critical(logger_id, "Initializing tangle connection failed\n");
-    return NULL;
+/**
+ * Gives a broadcast entry back to the pool, the caller must hold the
+ * broadcaster lock in write access
+ *
+ * @param broadcaster The broadcaster
+ * @param entry The entry
+ */
+static void broadcaster_entry_release(broadcaster_t *const broadcaster,
+                                      broadcaster_entry_t *const entry) {
+  if (broadcaster->pool_size < BROADCASTER_POOL_MAX_SIZE) {
+    LL_PREPEND(broadcaster->pool, entry);
+    broadcaster->pool_size++;
+  } else {
+    free(entry);
   }
+}
 
-  lock_handle_t lock_cond;
-  lock_handle_init(&lock_cond);
-  lock_handle_lock(&lock_cond);
-
-  while (broadcaster->running) {
-    if (broadcaster_is_empty(broadcaster)) {
-      cond_handle_timedwait(&broadcaster->cond, &lock_cond,
-                            BROADCASTER_TIMEOUT_SEC);
-    }
+/**
+ * Broadcasts a batch of transactions from the broadcaster queue and schedules
+ * itself again if more are queued.
+ *
+ * @param broadcaster The broadcaster
+ */
+static void broadcaster_routine(broadcaster_t *const broadcaster) {
+  neighbor_t *iter = NULL;
+  broadcaster_entry_t *entry = NULL;
+  size_t count = 0;
 
+  for (count = 0; count < BROADCASTER_BATCH_SIZE; count++) {
     rw_lock_handle_wrlock(&broadcaster->lock);
-    transaction_flex_trits_ptr = hash8019_queue_peek(broadcaster->queue);
-    if (transaction_flex_trits_ptr == NULL) {
+    if ((entry = (broadcaster_entry_t *)priority_queue_pop(
+             &broadcaster->queue)) == NULL) {
       rw_lock_handle_unlock(&broadcaster->lock);
-      continue;
+      return;
     }
-    memcpy(transaction_flex_trits, transaction_flex_trits_ptr,
-           FLEX_TRIT_SIZE_8019);
-    hash8019_queue_pop(&broadcaster->queue);
     rw_lock_handle_unlock(&broadcaster->lock);
 
     log_debug(logger_id, "Broadcasting transaction\n");
     rw_lock_handle_rdlock(&broadcaster->node->neighbors_lock);
     LL_FOREACH(broadcaster->node->neighbors, iter) {
-      if (neighbor_send(broadcaster->node, &tangle, iter,
-                        transaction_flex_trits) != RC_OK) {
+      if (neighbor_send_bytes(broadcaster->node, &broadcaster->tangle, iter,
+                              entry->transaction) != RC_OK) {
         log_warning(logger_id, "Broadcasting transaction failed\n");
       }
     }
     rw_lock_handle_unlock(&broadcaster->node->neighbors_lock);
-  }
-
-  lock_handle_unlock(&lock_cond);
-  lock_handle_destroy(&lock_cond);
 
-  if (iota_tangle_destroy(&tangle) != RC_OK) {
-    log_critical(logger_id, "Destroying tangle connection failed\n");
+    rw_lock_handle_wrlock(&broadcaster->lock);
+    broadcaster_entry_release(broadcaster, entry);
+    rw_lock_handle_unlock(&broadcaster->lock);
   }
 
-  return NULL;
+  if (!broadcaster_is_empty(broadcaster)) {
+    executor_schedule(broadcaster->executor, &broadcaster->task);
+  }
 }
 
 /*
@@ -93,14 +95,20 @@ retcode_t broadcaster_init(broadcaster_t *const broadcaster,
   memset(broadcaster, 0, sizeof(broadcaster_t));
   broadcaster->running = false;
   broadcaster->node = node;
-  broadcaster->queue = NULL;
+  priority_queue_init(&broadcaster->queue, node->conf.gossip_queue_size);
+  broadcaster->pool = NULL;
+  broadcaster->pool_size = 0;
   rw_lock_handle_init(&broadcaster->lock);
-  cond_handle_init(&broadcaster->cond);
+  executor_task_init(&broadcaster->task,
+                     (executor_routine_t)broadcaster_routine, broadcaster);
 
   return RC_OK;
 }
 
 retcode_t broadcaster_destroy(broadcaster_t *const broadcaster) {
+  broadcaster_entry_t *entry = NULL;
+  broadcaster_entry_t *tmp = NULL;
+
   if (broadcaster == NULL) {
     return RC_NULL_PARAM;
   } else if (broadcaster->running) {
@@ -108,48 +116,79 @@ retcode_t broadcaster_destroy(broadcaster_t *const broadcaster) {
   }
 
   broadcaster->node = NULL;
-  hash8019_queue_free(&broadcaster->queue);
+  while ((entry = (broadcaster_entry_t *)priority_queue_pop(
+              &broadcaster->queue)) != NULL) {
+    free(entry);
+  }
+  LL_FOREACH_SAFE(broadcaster->pool, entry, tmp) {
+    LL_DELETE(broadcaster->pool, entry);
+    free(entry);
+  }
+  broadcaster->pool_size = 0;
   rw_lock_handle_destroy(&broadcaster->lock);
-  cond_handle_destroy(&broadcaster->cond);
+  executor_task_destroy(&broadcaster->task);
   logger_helper_release(logger_id);
 
   return RC_OK;
 }
 
-retcode_t broadcaster_start(broadcaster_t *const broadcaster) {
-  if (broadcaster == NULL) {
+retcode_t broadcaster_start(broadcaster_t *const broadcaster,
+                            executor_t *const executor) {
+  retcode_t ret = RC_OK;
+  connection_config_t db_conf = {.db_path = NULL};
+
+  if (broadcaster == NULL || executor == NULL) {
     return RC_NULL_PARAM;
   }
 
-  log_info(logger_id, "Spawning broadcaster thread\n");
+  db_conf.db_path = broadcaster->node->conf.db_path;
+  if ((ret = iota_tangle_init(&broadcaster->tangle, &db_conf)) != RC_OK) {
+    log_critical(logger_id, "Initializing tangle connection failed\n");
+    return ret;
+  }
+
+  log_info(logger_id, "Starting broadcaster task\n");
+  broadcaster->executor = executor;
   broadcaster->running = true;
-  if (thread_handle_create(&broadcaster->thread,
-                           (thread_routine_t)broadcaster_routine,
-                           broadcaster) != 0) {
-    return RC_FAILED_THREAD_SPAWN;
+
+  // Transactions may have been queued before the broadcaster started
+  if (!broadcaster_is_empty(broadcaster)) {
+    executor_schedule(executor, &broadcaster->task);
   }
 
   return RC_OK;
 }
 
 retcode_t broadcaster_on_next(broadcaster_t *const broadcaster,
-                              flex_trit_t const *const transaction_flex_trits) {
-  retcode_t ret = RC_OK;
+                              byte_t const *const transaction,
+                              gossip_priority_t const priority) {
+  broadcaster_entry_t *entry = NULL;
+  broadcaster_entry_t *dropped = NULL;
 
-  if (broadcaster == NULL || transaction_flex_trits == NULL) {
+  if (broadcaster == NULL || transaction == NULL) {
     return RC_NULL_PARAM;
   }
 
   rw_lock_handle_wrlock(&broadcaster->lock);
-  ret = hash8019_queue_push(&broadcaster->queue, transaction_flex_trits);
-  rw_lock_handle_unlock(&broadcaster->lock);
-
-  if (ret != RC_OK) {
+  if ((entry = broadcaster->pool) != NULL) {
+    LL_DELETE(broadcaster->pool, entry);
+    broadcaster->pool_size--;
+  } else if ((entry = (broadcaster_entry_t *)malloc(
+                  sizeof(broadcaster_entry_t))) == NULL) {
+    rw_lock_handle_unlock(&broadcaster->lock);
     log_warning(logger_id,
-                "Pushing transaction flex trits to broadcaster queue failed\n");
+                "Pushing transaction to broadcaster queue failed\n");
     return RC_BROADCASTER_FAILED_PUSH_QUEUE;
-  } else {
-    cond_handle_signal(&broadcaster->cond);
+  }
+  memcpy(entry->transaction, transaction, PACKET_TX_SIZE);
+  if ((dropped = (broadcaster_entry_t *)priority_queue_push(
+           &broadcaster->queue, &entry->entry, priority)) != NULL) {
+    broadcaster_entry_release(broadcaster, dropped);
+  }
+  rw_lock_handle_unlock(&broadcaster->lock);
+
+  if (broadcaster->running) {
+    executor_schedule(broadcaster->executor, &broadcaster->task);
   }
 
   return RC_OK;
@@ -163,26 +202,35 @@ size_t broadcaster_size(broadcaster_t *const broadcaster) {
   }
 
   rw_lock_handle_rdlock(&broadcaster->lock);
-  size = hash8019_queue_count(broadcaster->queue);
+  size = priority_queue_size(&broadcaster->queue);
   rw_lock_handle_unlock(&broadcaster->lock);
 
   return size;
 }
 
+void broadcaster_queue_stats(broadcaster_t *const broadcaster,
+                             priority_queue_stats_t *const stats) {
+  rw_lock_handle_rdlock(&broadcaster->lock);
+  priority_queue_stats(&broadcaster->queue, stats);
+  rw_lock_handle_unlock(&broadcaster->lock);
+}
+
 retcode_t broadcaster_stop(broadcaster_t *const broadcaster) {
+  retcode_t ret = RC_OK;
+
   if (broadcaster == NULL) {
     return RC_NULL_PARAM;
   } else if (broadcaster->running == false) {
     return RC_OK;
   }
 
-  log_info(logger_id, "Shutting down broadcaster thread\n");
+  log_info(logger_id, "Stopping broadcaster task\n");
   broadcaster->running = false;
-  cond_handle_signal(&broadcaster->cond);
-  if (thread_handle_join(broadcaster->thread, NULL) != 0) {
-    log_error(logger_id, "Shutting down broadcaster thread failed\n");
-    return RC_FAILED_THREAD_JOIN;
+  executor_cancel(broadcaster->executor, &broadcaster->task);
+
+  if ((ret = iota_tangle_destroy(&broadcaster->tangle)) != RC_OK) {
+    log_error(logger_id, "Destroying tangle connection failed\n");
   }
 
-  return RC_OK;
+  return ret;
 }
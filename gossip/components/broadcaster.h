@@ -11,21 +11,39 @@
 #include <stdbool.h>
 
 #include "common/errors.h"
-#include "utils/containers/hash/hash8019_queue.h"
-#include "utils/handles/cond.h"
+#include "common/trinary/bytes.h"
+#include "consensus/tangle/tangle.h"
+#include "gossip/conf.h"
+#include "gossip/priority_queue.h"
+#include "utils/handles/executor.h"
 #include "utils/handles/rw_lock.h"
-#include "utils/handles/thread.h"
 
 // Forward declarations
 typedef struct node_s node_t;
 
+/**
+ * A transaction to broadcast, kept in its wire encoding so that it is sent to
+ * every neighbor without being converted again
+ */
+typedef struct broadcaster_entry_s {
+  priority_queue_entry_t entry;
+  byte_t transaction[PACKET_TX_SIZE];
+  // Link in the pool
+  struct broadcaster_entry_s *next;
+} broadcaster_entry_t;
+
 typedef struct broadcaster_s {
-  thread_handle_t thread;
+  executor_t *executor;
+  executor_task_t task;
   bool running;
   node_t *node;
-  hash8019_queue_t queue;
+  priority_queue_t queue;
+  // Entries already broadcast, reused by the next transactions
+  broadcaster_entry_t *pool;
+  size_t pool_size;
   rw_lock_handle_t lock;
-  cond_handle_t cond;
+  // Only used by the task
+  tangle_t tangle;
 } broadcaster_t;
 
 #ifdef __cplusplus
@@ -56,21 +74,25 @@ retcode_t broadcaster_destroy(broadcaster_t *const broadcaster);
  * Starts a broadcaster
  *
  * @param broadcaster The broadcaster
+ * @param executor The executor running the broadcaster task
  *
  * @return a status code
  */
-retcode_t broadcaster_start(broadcaster_t *const broadcaster);
+retcode_t broadcaster_start(broadcaster_t *const broadcaster,
+                            executor_t *const executor);
 
 /**
- * Adds transaction flex trits to the broadcaster queue
+ * Adds a transaction to the broadcaster queue
  *
  * @param broadcaster The broadcaster
- * @param flex_trits Transaction flex trits
+ * @param transaction The transaction bytes, as sent in packets
+ * @param priority The priority of the transaction
  *
  * @return a status code
  */
 retcode_t broadcaster_on_next(broadcaster_t *const broadcaster,
-                              flex_trit_t const *const flex_trits);
+                              byte_t const *const transaction,
+                              gossip_priority_t const priority);
 
 /**
  * Gets the size of the broadcaster queue
@@ -81,6 +103,15 @@ retcode_t broadcaster_on_next(broadcaster_t *const broadcaster,
  */
 size_t broadcaster_size(broadcaster_t *const broadcaster);
 
+/**
+ * Gets the statistics of the broadcaster queue, one per priority
+ *
+ * @param broadcaster The broadcaster
+ * @param stats An array of GOSSIP_PRIORITY_COUNT statistics to be filled
+ */
+void broadcaster_queue_stats(broadcaster_t *const broadcaster,
+                             priority_queue_stats_t *const stats);
+
 /**
  * Stops a broadcaster
  *
@@ -98,7 +129,7 @@ retcode_t broadcaster_stop(broadcaster_t *const broadcaster);
  * @return true if empty, false otherwise
  */
 static inline bool broadcaster_is_empty(broadcaster_t *const broadcaster) {
-  return broadcaster->queue == NULL;
+  return priority_queue_empty(&broadcaster->queue);
 }
 
 #ifdef __cplusplus
@@ -8,6 +8,8 @@
 #include <string.h>
 
 #include "common/curl-p/ptrit.h"
+#include "common/model/transaction_view.h"
+#include "common/trinary/flex_ptrit.h"
 #include "common/trinary/trit_ptrit.h"
 #include "consensus/milestone_tracker/milestone_tracker.h"
 #include "consensus/transaction_solidifier/transaction_solidifier.h"
@@ -17,7 +19,8 @@
 #include "utils/logger_helper.h"
 
 #define PROCESSOR_LOGGER_ID "processor"
-#define PROCESSOR_TIMEOUT_SEC 1
+// Packets are hashed together, one per ptrit lane
+#define PROCESSOR_BATCH_SIZE 64
 
 static logger_id_t logger_id;
 
@@ -26,9 +29,23 @@ static logger_id_t logger_id;
  */
 
 /**
- * Converts transaction bytes from a packet to a transaction, validates it and
+ * Tells whether a transaction was issued by the coordinator
+ *
+ * @param processor The processor state
+ * @param address The transaction address
+ *
+ * @return true if a milestone transaction, false otherwise
+ */
+static inline bool is_milestone_address(processor_t const *const processor,
+                                        flex_trit_t const *const address) {
+  return memcmp(address, processor->milestone_tracker->coordinator,
+                FLEX_TRIT_SIZE_243) == 0;
+}
+
+/**
+ * Validates transaction bytes from a packet through a view over them and
  * updates its status.
- * If valid and new: stores and broadcasts it.
+ * If valid and new: deserializes, stores and broadcasts it.
  *
  * @param processor The processor state
  * @param tangle A tangle
@@ -45,10 +62,11 @@ static retcode_t process_transaction_bytes(processor_t const *const processor,
                                            flex_trit_t const *const curl_hash) {
   retcode_t ret = RC_OK;
   bool exists = false;
+  bool milestone = false;
+  transaction_view_t view;
   iota_transaction_t transaction = {.metadata.snapshot_index = 0,
                                     .metadata.solid = 0,
                                     .loaded_columns_mask = 0};
-  flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
 
   if (processor == NULL || neighbor == NULL || packet == NULL ||
       curl_hash == NULL) {
@@ -57,30 +75,12 @@ static retcode_t process_transaction_bytes(processor_t const *const processor,
 
   // TODO Check if transaction hash is cached
 
-  // Retreives the transaction from the packet
-  if (flex_trits_from_bytes(transaction_flex_trits,
-                            NUM_TRITS_SERIALIZED_TRANSACTION, packet->content,
-                            NUM_TRITS_SERIALIZED_TRANSACTION,
-                            NUM_TRITS_SERIALIZED_TRANSACTION) !=
-      NUM_TRITS_SERIALIZED_TRANSACTION) {
-    log_warning(logger_id, "Invalid transaction bytes\n");
-    ret = RC_PROCESSOR_INVALID_TRANSACTION;
-    goto failure;
-  }
-
-  // Deserializes the transaction
-  if (transaction_deserialize_from_trits(&transaction, transaction_flex_trits,
-                                         false) !=
-      NUM_TRITS_SERIALIZED_TRANSACTION) {
-    log_warning(logger_id, "Deserializing transaction failed\n");
-    ret = RC_PROCESSOR_INVALID_TRANSACTION;
-    goto failure;
-  }
-  transaction_set_hash(&transaction, curl_hash);
+  // Only the fields needed by the validation are decoded from the packet
+  transaction_view_init(&view, packet->content, curl_hash);
 
   // Validates the transaction
-  if (!iota_consensus_transaction_validate(processor->transaction_validator,
-                                           &transaction)) {
+  if (!iota_consensus_transaction_view_validate(
+          processor->transaction_validator, &view)) {
     log_debug(logger_id, "Invalid transaction\n");
     goto failure;
   }
@@ -94,7 +94,15 @@ static retcode_t process_transaction_bytes(processor_t const *const processor,
     goto failure;
   }
 
+  // Duplicates are dropped before paying for a full deserialization
   if (!exists) {
+    if (transaction_view_to_transaction(&view, &transaction) !=
+        NUM_TRITS_SERIALIZED_TRANSACTION) {
+      log_warning(logger_id, "Deserializing transaction failed\n");
+      ret = RC_PROCESSOR_INVALID_TRANSACTION;
+      goto failure;
+    }
+
     // Stores the new transaction
     log_debug(logger_id, "Storing new transaction\n");
     if ((ret = iota_tangle_transaction_store(tangle, &transaction)) != RC_OK) {
@@ -112,22 +120,34 @@ static retcode_t process_transaction_bytes(processor_t const *const processor,
 
     // TODO Store transaction metadata
 
-    // Broadcast the new transaction
-    if ((ret = broadcaster_on_next(&processor->node->broadcaster,
-                                   transaction_flex_trits)) != RC_OK) {
+    // New transactions are the most likely to be requested by neighbors
+    if (packet_cache_put(&processor->node->packet_cache,
+                         transaction_hash(&transaction),
+                         packet->content) != RC_OK) {
+      log_warning(logger_id, "Caching new transaction packet failed\n");
+    }
+
+    milestone =
+        is_milestone_address(processor, transaction_address(&transaction));
+
+    // Broadcast the new transaction as it was received
+    if ((ret = broadcaster_on_next(
+             &processor->node->broadcaster, packet->content,
+             milestone ? GOSSIP_PRIORITY_MILESTONE : GOSSIP_PRIORITY_NORMAL)) !=
+        RC_OK) {
       log_warning(logger_id, "Propagating packet to broadcaster failed\n");
       goto failure;
     }
 
-    if (transaction_current_index(&transaction) == 0 &&
-        memcmp(transaction_address(&transaction),
-               processor->milestone_tracker->coordinator,
-               FLEX_TRIT_SIZE_243) == 0) {
+    if (milestone && transaction_current_index(&transaction) == 0) {
       ret = iota_milestone_tracker_add_candidate(
-          processor->milestone_tracker, transaction_hash(&transaction));
+          processor->milestone_tracker, transaction_hash(&transaction),
+          iota_milestone_tracker_candidate_index(&transaction));
     }
 
     neighbor->nbr_new_tx++;
+  } else {
+    neighbor->nbr_duplicate_tx++;
   }
 
   return ret;
@@ -243,107 +263,61 @@ done:
 }
 
 /**
- * Continuously looks for a packet from a processor packet queue and process it.
+ * Processes a batch of packets from a processor packet queue and schedules
+ * itself again if more are queued.
  *
  * @param processor The processor state
  */
-static void *processor_routine(processor_t *const processor) {
-  connection_config_t db_conf = {.db_path = processor->node->conf.db_path};
-  tangle_t tangle;
-  size_t j;
-
-  if (processor == NULL) {
-    return NULL;
-  }
-
-  if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
-    log_critical(logger_id, "Initializing tangle connection failed\n");
-    return NULL;
-  }
-
-  const size_t PACKET_MAX = 64;
+static void processor_routine(processor_t *const processor) {
   size_t packet_cnt = 0;
   iota_packet_t *packet_ptr = NULL;
-  iota_packet_t *packets =
-      (iota_packet_t *)calloc(PACKET_MAX, sizeof(iota_packet_t));
-
-  trit_t *tx =
-      (trit_t *)calloc(NUM_TRITS_SERIALIZED_TRANSACTION, sizeof(trit_t));
-  trit_t *hash = (trit_t *)calloc(HASH_LENGTH_TRIT, sizeof(trit_t));
-
-  PCurl *curl = (PCurl *)calloc(1, sizeof(PCurl));
-  curl->type = 81;
-
-  ptrit_t *txs_acc =
-      (ptrit_t *)calloc(NUM_TRITS_SERIALIZED_TRANSACTION, sizeof(ptrit_t));
-
+  byte_t const *contents[PROCESSOR_BATCH_SIZE];
   flex_trit_t flex_hash[FLEX_TRIT_SIZE_243];
+  bool more = false;
+  size_t j;
 
-  lock_handle_t lock_cond;
-  lock_handle_init(&lock_cond);
-  lock_handle_lock(&lock_cond);
-
-  while (processor->running) {
-    if (processor_is_empty(processor)) {
-      cond_handle_timedwait(&processor->cond, &lock_cond,
-                            PROCESSOR_TIMEOUT_SEC);
-    }
-
-    rw_lock_handle_wrlock(&processor->lock);
-    for (packet_cnt = 0; packet_cnt < PACKET_MAX; packet_cnt++) {
-      packet_ptr = iota_packet_queue_peek(processor->queue);
-      if (packet_ptr == NULL) {
-        goto process_packets;
-      }
-      packets[packet_cnt] = *packet_ptr;
-      iota_packet_queue_pop(&processor->queue);
+  rw_lock_handle_wrlock(&processor->lock);
+  for (packet_cnt = 0; packet_cnt < PROCESSOR_BATCH_SIZE; packet_cnt++) {
+    packet_ptr = iota_packet_queue_peek(&processor->queue);
+    if (packet_ptr == NULL) {
+      break;
     }
+    processor->packets[packet_cnt] = *packet_ptr;
+    iota_packet_queue_pop(&processor->queue);
+  }
+  more = !processor_is_empty(processor);
+  rw_lock_handle_unlock(&processor->lock);
 
-  process_packets:
-    rw_lock_handle_unlock(&processor->lock);
+  if (packet_cnt == 0) {
+    return;
+  }
 
-    if (packet_cnt == 0) {
-      continue;
-    }
+  // Gives other tasks a chance to run before the next batch
+  if (more) {
+    executor_schedule(processor->executor, &processor->task);
+  }
 
-    ptrit_curl_init(curl, CURL_P_81);
-    memset(txs_acc, 0, NUM_TRITS_SERIALIZED_TRANSACTION * sizeof(ptrit_t));
-    memset(flex_hash, FLEX_TRIT_NULL_VALUE, sizeof(flex_hash));
+  ptrit_curl_init(processor->curl, CURL_P_81);
 
-    for (j = 0; j < packet_cnt; j++) {
-      bytes_to_trits(packets[j].content, PACKET_TX_SIZE, tx,
-                     NUM_TRITS_SERIALIZED_TRANSACTION);
-      trits_to_ptrits(tx, txs_acc, j, NUM_TRITS_SERIALIZED_TRANSACTION);
-    }
+  // Transactions go straight from their packed bytes to their ptrit lanes
+  for (j = 0; j < packet_cnt; j++) {
+    contents[j] = processor->packets[j].content;
+  }
+  bytes_to_ptrits(contents, packet_cnt, processor->txs_acc,
+                  NUM_TRITS_SERIALIZED_TRANSACTION);
 
-    ptrit_curl_absorb(curl, txs_acc, NUM_TRITS_SERIALIZED_TRANSACTION);
-    ptrit_curl_squeeze(curl, txs_acc, HASH_LENGTH_TRIT);
+  ptrit_curl_absorb(processor->curl, processor->txs_acc,
+                    NUM_TRITS_SERIALIZED_TRANSACTION);
+  ptrit_curl_squeeze(processor->curl, processor->txs_acc, HASH_LENGTH_TRIT);
 
-    for (j = 0; j < packet_cnt; j++) {
-      ptrits_to_trits(txs_acc, hash, j, HASH_LENGTH_TRIT);
-      flex_trits_from_trits(flex_hash, HASH_LENGTH_TRIT, hash, HASH_LENGTH_TRIT,
-                            HASH_LENGTH_TRIT);
+  for (j = 0; j < packet_cnt; j++) {
+    flex_trits_from_ptrits(flex_hash, processor->txs_acc, j, HASH_LENGTH_TRIT);
 
-      if (process_packet(processor, &tangle, &packets[j], flex_hash) != RC_OK) {
-        log_warning(logger_id, "Processing packet failed\n");
-      }
+    if (process_packet(processor, &processor->tangle, &processor->packets[j],
+                       flex_hash) != RC_OK) {
+      log_warning(logger_id, "Processing packet failed\n");
     }
   }
-
-  lock_handle_unlock(&lock_cond);
-  lock_handle_destroy(&lock_cond);
-
-  if (iota_tangle_destroy(&tangle) != RC_OK) {
-    log_critical(logger_id, "Destroying tangle connection failed\n");
-  }
-
-  free(curl);
-  free(packets);
-  free(tx);
-  free(hash);
-  free(txs_acc);
-
-  return NULL;
 }
 
 /*
@@ -361,51 +335,97 @@ retcode_t processor_init(processor_t *const processor, node_t *const node,
 
   logger_id = logger_helper_enable(PROCESSOR_LOGGER_ID, LOGGER_DEBUG, true);
 
+  processor->executor = NULL;
   processor->running = false;
-  processor->queue = NULL;
+  iota_packet_queue_init(&processor->queue, node->conf.gossip_queue_size);
   rw_lock_handle_init(&processor->lock);
-  cond_handle_init(&processor->cond);
   processor->node = node;
   processor->transaction_validator = transaction_validator;
   processor->transaction_solidifier = transaction_solidifier;
   processor->milestone_tracker = milestone_tracker;
+  processor->packets = NULL;
+  processor->curl = NULL;
+  processor->txs_acc = NULL;
+  executor_task_init(&processor->task, (executor_routine_t)processor_routine,
+                     processor);
 
   return RC_OK;
 }
 
-retcode_t processor_start(processor_t *const processor) {
-  if (processor == NULL) {
+retcode_t processor_start(processor_t *const processor,
+                          executor_t *const executor) {
+  retcode_t ret = RC_OK;
+  connection_config_t db_conf = {.db_path = NULL};
+
+  if (processor == NULL || executor == NULL) {
     return RC_NULL_PARAM;
   }
 
-  log_info(logger_id, "Spawning processor thread\n");
+  db_conf.db_path = processor->node->conf.db_path;
+  if ((ret = iota_tangle_init(&processor->tangle, &db_conf)) != RC_OK) {
+    log_critical(logger_id, "Initializing tangle connection failed\n");
+    return ret;
+  }
+
+  processor->packets =
+      (iota_packet_t *)calloc(PROCESSOR_BATCH_SIZE, sizeof(iota_packet_t));
+  processor->curl = (PCurl *)calloc(1, sizeof(PCurl));
+  processor->txs_acc =
+      (ptrit_t *)calloc(NUM_TRITS_SERIALIZED_TRANSACTION, sizeof(ptrit_t));
+  if (processor->packets == NULL || processor->curl == NULL ||
+      processor->txs_acc == NULL) {
+    ret = RC_OOM;
+    goto failure;
+  }
+  processor->curl->type = 81;
+
+  log_info(logger_id, "Starting processor task\n");
+  processor->executor = executor;
   processor->running = true;
-  if (thread_handle_create(&processor->thread,
-                           (thread_routine_t)processor_routine,
-                           processor) != 0) {
-    log_critical(logger_id, "Spawning processor thread failed\n");
-    return RC_FAILED_THREAD_SPAWN;
+
+  // Packets may have been queued before the processor started
+  if (!processor_is_empty(processor)) {
+    executor_schedule(executor, &processor->task);
   }
 
   return RC_OK;
+
+failure:
+  free(processor->packets);
+  free(processor->curl);
+  free(processor->txs_acc);
+  processor->packets = NULL;
+  processor->curl = NULL;
+  processor->txs_acc = NULL;
+  iota_tangle_destroy(&processor->tangle);
+  return ret;
 }
 
 retcode_t processor_stop(processor_t *const processor) {
+  retcode_t ret = RC_OK;
+
   if (processor == NULL) {
     return RC_NULL_PARAM;
   } else if (processor->running == false) {
     return RC_OK;
   }
 
-  log_info(logger_id, "Shutting down processor thread\n");
+  log_info(logger_id, "Stopping processor task\n");
   processor->running = false;
-  cond_handle_signal(&processor->cond);
-  if (thread_handle_join(processor->thread, NULL) != 0) {
-    log_error(logger_id, "Shutting down processor thread failed\n");
-    return RC_FAILED_THREAD_JOIN;
+  executor_cancel(processor->executor, &processor->task);
+
+  free(processor->packets);
+  free(processor->curl);
+  free(processor->txs_acc);
+  processor->packets = NULL;
+  processor->curl = NULL;
+  processor->txs_acc = NULL;
+
+  if ((ret = iota_tangle_destroy(&processor->tangle)) != RC_OK) {
+    log_error(logger_id, "Destroying tangle connection failed\n");
   }
 
-  return RC_OK;
+  return ret;
 }
 
 retcode_t processor_destroy(processor_t *const processor) {
@@ -417,7 +437,7 @@ retcode_t processor_destroy(processor_t *const processor) {
 
   iota_packet_queue_free(&processor->queue);
   rw_lock_handle_destroy(&processor->lock);
-  cond_handle_destroy(&processor->cond);
+  executor_task_destroy(&processor->task);
   processor->node = NULL;
   processor->transaction_validator = NULL;
   processor->transaction_solidifier = NULL;
@@ -431,20 +451,47 @@ retcode_t processor_destroy(processor_t *const processor) {
 retcode_t processor_on_next(processor_t *const processor,
                             iota_packet_t const packet) {
   retcode_t ret = RC_OK;
+  neighbor_t *neighbor = NULL;
+  bool admitted = false;
+  transaction_view_t view;
+  flex_trit_t address[FLEX_TRIT_SIZE_243];
+  gossip_priority_t priority = GOSSIP_PRIORITY_NORMAL;
 
   if (processor == NULL) {
     return RC_NULL_PARAM;
   }
 
+  // A flooding or misbehaving neighbor is cut off before using any queue space
+  // or validation time
+  rw_lock_handle_rdlock(&processor->node->neighbors_lock);
+  if ((neighbor = neighbors_find_by_endpoint(processor->node->neighbors,
+                                             &packet.source)) != NULL) {
+    admitted = neighbor_admit_packet(neighbor, &processor->node->conf);
+  }
+  rw_lock_handle_unlock(&processor->node->neighbors_lock);
+  if (!admitted) {
+    return RC_OK;
+  }
+
+  // Milestones must not wait behind the spam. Only the address is decoded,
+  // nothing is hashed on the receive path: the milestone lane is capped and
+  // forged milestones are rejected by the validation once batch hashed, which
+  // counts against the score of their neighbor
+  transaction_view_init(&view, packet.content, NULL);
+  transaction_view_address(&view, address);
+  if (is_milestone_address(processor, address)) {
+    priority = GOSSIP_PRIORITY_MILESTONE;
+  }
+
   rw_lock_handle_wrlock(&processor->lock);
-  ret = iota_packet_queue_push(&processor->queue, &packet);
+  ret = iota_packet_queue_push(&processor->queue, &packet, priority);
   rw_lock_handle_unlock(&processor->lock);
 
   if (ret != RC_OK) {
     log_warning(logger_id, "Pushing packet to processor queue failed\n");
     return ret;
-  } else {
-    cond_handle_signal(&processor->cond);
+  } else if (processor->running) {
+    executor_schedule(processor->executor, &processor->task);
   }
 
   return RC_OK;
@@ -458,8 +505,15 @@ size_t processor_size(processor_t *const processor) {
   }
 
   rw_lock_handle_rdlock(&processor->lock);
-  size = iota_packet_queue_count(processor->queue);
+  size = iota_packet_queue_count(&processor->queue);
   rw_lock_handle_unlock(&processor->lock);
 
   return size;
 }
+
+void processor_queue_stats(processor_t *const processor,
+                           priority_queue_stats_t *const stats) {
+  rw_lock_handle_rdlock(&processor->lock);
+  priority_queue_stats(&processor->queue, stats);
+  rw_lock_handle_unlock(&processor->lock);
+}
@@ -10,33 +10,39 @@
 
 #include <stdbool.h>
 
+#include "common/curl-p/ptrit.h"
 #include "common/errors.h"
+#include "consensus/tangle/tangle.h"
 #include "consensus/transaction_validator/transaction_validator.h"
 #include "gossip/iota_packet.h"
-#include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
+#include "utils/handles/executor.h"
 #include "utils/handles/rw_lock.h"
-#include "utils/handles/thread.h"
 
 // Forward declarations
 typedef struct node_s node_t;
-typedef struct tangle_s tangle_t;
 typedef struct transaction_solidifier_s transaction_solidifier_t;
 typedef struct milestone_tracker_s milestone_tracker_t;
 
 /**
  * A processor is responsible for analyzing packets sent by neighbors.
+ * Its task is scheduled on the executor whenever packets are queued and
+ * processes one batch of them per run.
  */
 typedef struct processor_s {
-  thread_handle_t thread;
+  executor_t *executor;
+  executor_task_t task;
   bool running;
   iota_packet_queue_t queue;
   rw_lock_handle_t lock;
-  cond_handle_t cond;
   node_t *node;
   transaction_validator_t *transaction_validator;
   transaction_solidifier_t *transaction_solidifier;
   milestone_tracker_t *milestone_tracker;
+  // Only used by the task
+  tangle_t tangle;
+  iota_packet_t *packets;
+  PCurl *curl;
+  ptrit_t *txs_acc;
 } processor_t;
 
 #ifdef __cplusplus
@@ -63,10 +69,12 @@ retcode_t processor_init(processor_t *const processor, node_t *const node,
  * Starts a processor
  *
  * @param processor The processor state
+ * @param executor The executor running the processor task
  *
  * @return a status code
  */
-retcode_t processor_start(processor_t *const processor);
+retcode_t processor_start(processor_t *const processor,
+                          executor_t *const executor);
 
 /**
  * Stops a processor
@@ -87,7 +95,9 @@ retcode_t processor_stop(processor_t *const processor);
 retcode_t processor_destroy(processor_t *const processor);
 
 /**
- * Adds a packet to a processor queue
+ * Adds a packet to a processor queue, ahead of regular ones if it carries the
+ * coordinator address. Called by the receivers, packets of unknown neighbors
+ * and packets over the rate limit or score of their neighbor are dropped.
  *
  * @param processor The processor state
  * @param packet The packet
@@ -106,6 +116,15 @@ retcode_t processor_on_next(processor_t *const processor,
  */
 size_t processor_size(processor_t *const processor);
 
+/**
+ * Gets the statistics of the processor queue, one per priority
+ *
+ * @param processor The processor
+ * @param stats An array of GOSSIP_PRIORITY_COUNT statistics to be filled
+ */
+void processor_queue_stats(processor_t *const processor,
+                           priority_queue_stats_t *const stats);
+
 /**
  * Tells whether the processor queue is empty or not
  *
@@ -114,7 +133,7 @@ size_t processor_size(processor_t *const processor);
  * @return true if empty, false otherwise
  */
 static inline bool processor_is_empty(processor_t *const processor) {
-  return processor->queue == NULL;
+  return iota_packet_queue_empty(&processor->queue);
 }
 
 #ifdef __cplusplus
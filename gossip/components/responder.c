@@ -5,15 +5,20 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <inttypes.h>
+#include <string.h>
+
 #include "gossip/components/responder.h"
 #include "consensus/tangle/tangle.h"
+#include "gossip/iota_packet.h"
 #include "gossip/neighbor.h"
 #include "gossip/node.h"
 #include "utils/handles/rand.h"
 #include "utils/logger_helper.h"
+#include "utils/time.h"
 
 #define RESPONDER_LOGGER_ID "responder"
-#define RESPONDER_TIMEOUT_SEC 1
+#define RESPONDER_STATS_INTERVAL_SEC 60
 
 static logger_id_t logger_id;
 
@@ -21,6 +26,61 @@ static logger_id_t logger_id;
  * Private functions
  */
 
+/**
+ * Gets the wire encoding of a transaction, from the packet cache if possible.
+ * A transaction loaded from the tangle is added to the cache.
+ *
+ * @param responder The responder
+ * @param tangle A tangle
+ * @param hash The transaction hash
+ * @param pack A stor pack to load the transaction with
+ * @param transaction A buffer of PACKET_TX_SIZE bytes to be filled
+ * @param found Whether the transaction was found
+ *
+ * @return a status code
+ */
+static retcode_t get_transaction_bytes(responder_t const *const responder,
+                                       tangle_t *const tangle,
+                                       flex_trit_t const *const hash,
+                                       iota_stor_pack_t *const pack,
+                                       byte_t *const transaction,
+                                       bool *const found) {
+  retcode_t ret = RC_OK;
+  iota_packet_t packet;
+  flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
+
+  *found = packet_cache_get(&responder->node->packet_cache, hash, transaction);
+  if (*found) {
+    return RC_OK;
+  }
+
+  hash_pack_reset(pack);
+  if ((ret = iota_tangle_transaction_load(tangle, TRANSACTION_FIELD_HASH, hash,
+                                          pack)) != RC_OK) {
+    log_warning(logger_id, "Loading transaction failed\n");
+    return ret;
+  }
+  if (pack->num_loaded == 0) {
+    return RC_OK;
+  }
+
+  transaction_serialize_on_flex_trits(((iota_transaction_t **)(pack->models))[0],
+                                      transaction_flex_trits);
+  if ((ret = iota_packet_set_transaction(&packet, transaction_flex_trits)) !=
+      RC_OK) {
+    return ret;
+  }
+  memcpy(transaction, packet.content, PACKET_TX_SIZE);
+  *found = true;
+
+  if (packet_cache_put(&responder->node->packet_cache, hash, transaction) !=
+      RC_OK) {
+    log_warning(logger_id, "Caching transaction packet failed\n");
+  }
+
+  return RC_OK;
+}
+
 /**
  * Gets a transaction according to a request hash
  * - if null hash: gets a random tip
@@ -30,7 +90,9 @@ static logger_id_t logger_id;
  * @param tangle A tangle
  * @param neighbor The requesting neighbor
  * @param hash The request hash
- * @param pack A stor pack to be filled with a transaction
+ * @param pack A stor pack to load a transaction with
+ * @param transaction A buffer of PACKET_TX_SIZE bytes to be filled
+ * @param found Whether a transaction was found
  *
  * @return a status code
  */
@@ -38,13 +100,18 @@ static retcode_t get_transaction_for_request(responder_t const *const responder,
                                              tangle_t *const tangle,
                                              neighbor_t *const neighbor,
                                              flex_trit_t const *const hash,
-                                             iota_stor_pack_t *const pack) {
+                                             iota_stor_pack_t *const pack,
+                                             byte_t *const transaction,
+                                             bool *const found) {
   retcode_t ret = RC_OK;
 
-  if (responder == NULL || neighbor == NULL || hash == NULL || pack == NULL) {
+  if (responder == NULL || neighbor == NULL || hash == NULL || pack == NULL ||
+      transaction == NULL || found == NULL) {
     return RC_NULL_PARAM;
   }
 
+  *found = false;
+
   // If the hash is null, a random tip was requested
   if (flex_trits_are_null(hash, FLEX_TRIT_SIZE_243)) {
     flex_trit_t tip[FLEX_TRIT_SIZE_243];
@@ -56,10 +123,9 @@ static retcode_t get_transaction_for_request(responder_t const *const responder,
       if ((ret = tips_cache_random_tip(&responder->node->tips, tip)) != RC_OK) {
         return ret;
       }
-      if ((ret = iota_tangle_transaction_load(tangle, TRANSACTION_FIELD_HASH,
-                                              tip, pack)) != RC_OK ||
-          pack->num_loaded == 0) {
-        return ret;
+      if (!flex_trits_are_null(tip, FLEX_TRIT_SIZE_243)) {
+        return get_transaction_bytes(responder, tangle, tip, pack, transaction,
+                                     found);
       }
     }
     // Else no tx to request, so no random tip will be sent as a reply.
@@ -67,11 +133,8 @@ static retcode_t get_transaction_for_request(responder_t const *const responder,
   // If the hash is non-null, a transaction was requested
   else {
     log_debug(logger_id, "Responding to regular transaction request\n");
-    if ((ret = iota_tangle_transaction_load(tangle, TRANSACTION_FIELD_HASH,
-                                            hash, pack)) != RC_OK) {
-      log_warning(logger_id, "Loading transaction failed\n");
-      return ret;
-    }
+    return get_transaction_bytes(responder, tangle, hash, pack, transaction,
+                                 found);
   }
 
   return ret;
@@ -86,7 +149,7 @@ static retcode_t get_transaction_for_request(responder_t const *const responder,
  * @param tangle A tangle
  * @param neighbor The requesting neighbor
  * @param hash The request hash
- * @param pack A stor pack containing a transaction
+ * @param transaction The transaction bytes if one was found, NULL otherwise
  *
  * @return a status code
  */
@@ -94,26 +157,23 @@ static retcode_t respond_to_request(responder_t const *const responder,
                                     tangle_t *const tangle,
                                     neighbor_t *const neighbor,
                                     flex_trit_t const *const hash,
-                                    iota_stor_pack_t *const pack) {
+                                    byte_t const *const transaction) {
   retcode_t ret = RC_OK;
 
-  if (responder == NULL || neighbor == NULL || hash == NULL || pack == NULL) {
+  if (responder == NULL || neighbor == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
-  if (pack->num_loaded != 0) {
+  if (transaction != NULL) {
     // If a transaction or a random tip was found, sends it back to the neighbor
-    iota_transaction_t *transaction =
-        ((iota_transaction_t **)(pack->models))[0];
-    flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
-
-    transaction_serialize_on_flex_trits(transaction, transaction_flex_trits);
-    if ((ret = neighbor_send(responder->node, tangle, neighbor,
-                             transaction_flex_trits)) != RC_OK) {
+    // while its connection can't be replaced
+    rw_lock_handle_rdlock(&responder->node->neighbors_lock);
+    ret = neighbor_send_bytes(responder->node, tangle, neighbor, transaction);
+    rw_lock_handle_unlock(&responder->node->neighbors_lock);
+    if (ret != RC_OK) {
       log_warning(logger_id, "Sending transaction failed\n");
       return ret;
     }
-    // TODO Add transaction to cache
   } else {
     // If a transaction was requested but not found, requests it
     if (!flex_trits_are_null(hash, FLEX_TRIT_SIZE_243) &&
@@ -130,66 +190,137 @@ static retcode_t respond_to_request(responder_t const *const responder,
 }
 
 /**
- * Continuously looks for a transaction request from a responder queue and
- * process it
+ * Logs the statistics of a gossip queue, per priority
+ *
+ * @param name The name of the queue
+ * @param stats The GOSSIP_PRIORITY_COUNT statistics of the queue
+ */
+static void log_queue_stats(char const *const name,
+                            priority_queue_stats_t const *const stats) {
+  for (size_t i = 0; i < GOSSIP_PRIORITY_COUNT; i++) {
+    log_info(logger_id,
+             "%s queue, %s priority: %zu queued, %" PRIu64 " pushed, %" PRIu64
+             " dropped, latency avg %" PRIu64 " us max %" PRIu64 " us\n",
+             name, gossip_priority_name((gossip_priority_t)i), stats[i].size,
+             stats[i].pushed, stats[i].dropped,
+             stats[i].popped ? stats[i].total_latency_us / stats[i].popped : 0,
+             stats[i].max_latency_us);
+  }
+}
+
+/**
+ * Logs the responder, packet cache, gossip queues and executor statistics
+ *
+ * @param responder The responder
+ */
+static void responder_log_stats(responder_t *const responder) {
+  responder_stats_t stats;
+  packet_cache_stats_t cache_stats;
+  executor_stats_t exec_stats;
+  priority_queue_stats_t queue_stats[GOSSIP_PRIORITY_COUNT];
+  uint64_t lookups = 0;
+
+  responder_stats(responder, &stats);
+  packet_cache_stats(&responder->node->packet_cache, &cache_stats);
+  executor_stats(responder->executor, &exec_stats);
+  lookups = cache_stats.hits + cache_stats.misses;
+
+  log_info(logger_id,
+           "Answered %" PRIu64 " requests, latency avg %" PRIu64
+           " us max %" PRIu64 " us, packet cache hit rate %.2f%% (%zu "
+           "entries, %" PRIu64 " evictions)\n",
+           stats.requests,
+           stats.requests ? stats.total_latency_us / stats.requests : 0,
+           stats.max_latency_us,
+           lookups ? 100.0 * cache_stats.hits / lookups : 0.0,
+           cache_stats.size, cache_stats.evictions);
+  processor_queue_stats(&responder->node->processor, queue_stats);
+  log_queue_stats("Processor", queue_stats);
+  broadcaster_queue_stats(&responder->node->broadcaster, queue_stats);
+  log_queue_stats("Broadcaster", queue_stats);
+  responder_queue_stats(responder, queue_stats);
+  log_queue_stats("Responder", queue_stats);
+  log_info(logger_id,
+           "Executor ran %" PRIu64 " tasks (%" PRIu64
+           " stolen), queue latency avg %" PRIu64 " us max %" PRIu64
+           " us, %zu queued, %zu timers\n",
+           exec_stats.tasks, exec_stats.steals,
+           exec_stats.tasks
+               ? exec_stats.total_latency_us / exec_stats.tasks
+               : 0,
+           exec_stats.max_latency_us, exec_stats.queued,
+           exec_stats.timers);
+}
+
+/**
+ * Takes a batch of transaction requests from a responder queue, processes them
+ * and schedules itself again if more are queued.
  *
  * @param responder The responder state
  */
-static void *responder_routine(responder_t *const responder) {
+static void responder_routine(responder_t *const responder) {
   transaction_request_t *request_ptr = NULL;
-  transaction_request_t request;
+  transaction_request_t requests[RESPONDER_BATCH_SIZE];
+  size_t count = 0;
+  byte_t transaction[PACKET_TX_SIZE];
+  bool found = false;
+  bool more = false;
+  uint64_t start = 0, latency = 0, total_latency = 0, max_latency = 0;
   DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
-  connection_config_t db_conf = {.db_path = responder->node->conf.db_path};
-  tangle_t tangle;
 
-  if (responder == NULL) {
-    return NULL;
+  if (current_timestamp_ms() - responder->last_stats_ms >=
+      RESPONDER_STATS_INTERVAL_SEC * 1000ULL) {
+    responder_log_stats(responder);
+    responder->last_stats_ms = current_timestamp_ms();
   }
 
-  if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
-    log_critical(logger_id, "Initializing tangle connection failed\n");
-    return NULL;
+  rw_lock_handle_wrlock(&responder->lock);
+  for (count = 0;
+       count < RESPONDER_BATCH_SIZE &&
+       (request_ptr = transaction_request_queue_peek(&responder->queue)) !=
+           NULL;
+       count++) {
+    requests[count] = *request_ptr;
+    transaction_request_queue_pop(&responder->queue);
   }
+  more = !responder_is_empty(responder);
+  rw_lock_handle_unlock(&responder->lock);
 
-  lock_handle_t lock_cond;
-  lock_handle_init(&lock_cond);
-  lock_handle_lock(&lock_cond);
-
-  while (responder->running) {
-    if (responder_is_empty(responder)) {
-      cond_handle_timedwait(&responder->cond, &lock_cond,
-                            RESPONDER_TIMEOUT_SEC);
-    }
+  if (count == 0) {
+    return;
+  }
 
-    rw_lock_handle_wrlock(&responder->lock);
-    request_ptr = transaction_request_queue_peek(responder->queue);
-    if (request_ptr == NULL) {
-      rw_lock_handle_unlock(&responder->lock);
-      continue;
-    }
-    request = *request_ptr;
-    transaction_request_queue_pop(&responder->queue);
-    rw_lock_handle_unlock(&responder->lock);
+  // Gives other tasks a chance to run before the next batch
+  if (more) {
+    executor_schedule(responder->executor, &responder->task);
+  }
 
-    log_debug(logger_id, "Responding to request\n");
-    hash_pack_reset(&pack);
-    if (get_transaction_for_request(responder, &tangle, request.neighbor,
-                                    request.hash, &pack) != RC_OK) {
+  log_debug(logger_id, "Responding to %zu requests\n", count);
+  for (size_t i = 0; i < count; i++) {
+    start = current_timestamp_us();
+    if (get_transaction_for_request(
+            responder, &responder->tangle, requests[i].neighbor,
+            requests[i].hash, &pack, transaction, &found) != RC_OK) {
       log_warning(logger_id, "Getting transaction for request failed\n");
-    } else if (respond_to_request(responder, &tangle, request.neighbor,
-                                  request.hash, &pack) != RC_OK) {
+    } else if (respond_to_request(responder, &responder->tangle,
+                                  requests[i].neighbor, requests[i].hash,
+                                  found ? transaction : NULL) != RC_OK) {
       log_warning(logger_id, "Replying to request failed\n");
     }
+    latency = current_timestamp_us() - start;
+    total_latency += latency;
+    if (latency > max_latency) {
+      max_latency = latency;
+    }
   }
 
-  lock_handle_unlock(&lock_cond);
-  lock_handle_destroy(&lock_cond);
-
-  if (iota_tangle_destroy(&tangle) != RC_OK) {
-    log_critical(logger_id, "Destroying tangle connection failed\n");
+  rw_lock_handle_wrlock(&responder->lock);
+  responder->requests += count;
+  responder->total_latency_us += total_latency;
+  if (max_latency > responder->max_latency_us) {
+    responder->max_latency_us = max_latency;
   }
-
-  return NULL;
+  rw_lock_handle_unlock(&responder->lock);
 }
 
 /**
@@ -203,27 +334,45 @@ retcode_t responder_init(responder_t *const responder, node_t *const node) {
 
   logger_id = logger_helper_enable(RESPONDER_LOGGER_ID, LOGGER_DEBUG, true);
 
+  responder->executor = NULL;
   responder->running = false;
-  responder->queue = NULL;
+  transaction_request_queue_init(&responder->queue,
+                                 node->conf.gossip_queue_size);
   rw_lock_handle_init(&responder->lock);
-  cond_handle_init(&responder->cond);
   responder->node = node;
+  responder->requests = 0;
+  responder->total_latency_us = 0;
+  responder->max_latency_us = 0;
+  responder->last_stats_ms = 0;
+  executor_task_init(&responder->task, (executor_routine_t)responder_routine,
+                     responder);
 
   return RC_OK;
 }
 
-retcode_t responder_start(responder_t *const responder) {
-  if (responder == NULL) {
+retcode_t responder_start(responder_t *const responder,
+                          executor_t *const executor) {
+  retcode_t ret = RC_OK;
+  connection_config_t db_conf = {.db_path = NULL};
+
+  if (responder == NULL || executor == NULL) {
     return RC_NULL_PARAM;
   }
 
-  log_info(logger_id, "Spawning responder thread\n");
+  db_conf.db_path = responder->node->conf.db_path;
+  if ((ret = iota_tangle_init(&responder->tangle, &db_conf)) != RC_OK) {
+    log_critical(logger_id, "Initializing tangle connection failed\n");
+    return ret;
+  }
+
+  log_info(logger_id, "Starting responder task\n");
+  responder->executor = executor;
+  responder->last_stats_ms = current_timestamp_ms();
   responder->running = true;
-  if (thread_handle_create(&responder->thread,
-                           (thread_routine_t)responder_routine,
-                           responder) != 0) {
-    log_critical(logger_id, "Spawning responder thread failed\n");
-    return RC_FAILED_THREAD_SPAWN;
+
+  // Requests may have been queued before the responder started
+  if (!responder_is_empty(responder)) {
+    executor_schedule(executor, &responder->task);
   }
 
   return RC_OK;
@@ -238,11 +387,12 @@ retcode_t responder_stop(responder_t *const responder) {
     return RC_OK;
   }
 
-  log_info(logger_id, "Shutting down responder thread\n");
+  log_info(logger_id, "Stopping responder task\n");
   responder->running = false;
-  if (thread_handle_join(responder->thread, NULL) != 0) {
-    log_error(logger_id, "Shutting down responder thread failed\n");
-    ret = RC_FAILED_THREAD_JOIN;
+  executor_cancel(responder->executor, &responder->task);
+
+  if ((ret = iota_tangle_destroy(&responder->tangle)) != RC_OK) {
+    log_error(logger_id, "Destroying tangle connection failed\n");
   }
 
   return ret;
@@ -259,7 +409,7 @@ retcode_t responder_destroy(responder_t *const responder) {
 
   transaction_request_queue_free(&responder->queue);
   rw_lock_handle_destroy(&responder->lock);
-  cond_handle_destroy(&responder->cond);
+  executor_task_destroy(&responder->task);
   responder->node = NULL;
 
   logger_helper_release(logger_id);
@@ -276,16 +426,24 @@ retcode_t responder_on_next(responder_t *const responder,
     return RC_NULL_PARAM;
   }
 
+  if (!neighbor_admit_request(neighbor, &responder->node->conf)) {
+    return RC_OK;
+  }
+
   rw_lock_handle_wrlock(&responder->lock);
-  ret = transaction_request_queue_push(&responder->queue, neighbor, hash);
+  // Requests of specific transactions usually come from a solidifying neighbor
+  ret = transaction_request_queue_push(
+      &responder->queue, neighbor, hash,
+      flex_trits_are_null(hash, FLEX_TRIT_SIZE_243) ? GOSSIP_PRIORITY_NORMAL
+                                                    : GOSSIP_PRIORITY_HIGH);
   rw_lock_handle_unlock(&responder->lock);
 
   if (ret != RC_OK) {
     log_warning(logger_id,
                 "Pushing transaction_request to responder queue failed\n");
     return ret;
-  } else {
-    cond_handle_signal(&responder->cond);
+  } else if (responder->running) {
+    executor_schedule(responder->executor, &responder->task);
   }
 
   return RC_OK;
@@ -299,8 +457,28 @@ size_t responder_size(responder_t *const responder) {
   }
 
   rw_lock_handle_rdlock(&responder->lock);
-  size = transaction_request_queue_count(responder->queue);
+  size = transaction_request_queue_count(&responder->queue);
   rw_lock_handle_unlock(&responder->lock);
 
   return size;
 }
+
+void responder_queue_stats(responder_t *const responder,
+                           priority_queue_stats_t *const stats) {
+  rw_lock_handle_rdlock(&responder->lock);
+  priority_queue_stats(&responder->queue, stats);
+  rw_lock_handle_unlock(&responder->lock);
+}
+
+void responder_stats(responder_t *const responder,
+                     responder_stats_t *const stats) {
+  if (responder == NULL || stats == NULL) {
+    return;
+  }
+
+  rw_lock_handle_rdlock(&responder->lock);
+  stats->requests = responder->requests;
+  stats->total_latency_us = responder->total_latency_us;
+  stats->max_latency_us = responder->max_latency_us;
+  rw_lock_handle_unlock(&responder->lock);
+}
@@ -9,14 +9,17 @@
 #define __GOSSIP_COMPONENTS_RESPONDER_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
+#include "consensus/tangle/tangle.h"
 #include "gossip/transaction_request.h"
-#include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
+#include "utils/handles/executor.h"
 #include "utils/handles/rw_lock.h"
-#include "utils/handles/thread.h"
+
+// Maximum number of requests answered per run of the responder task
+#define RESPONDER_BATCH_SIZE 64
 
 // Forward declarations
 typedef struct neighbor_s neighbor_t;
@@ -27,14 +30,28 @@ typedef struct node_s node_t;
  * neighbors.
  */
 typedef struct responder_s {
-  thread_handle_t thread;
+  executor_t *executor;
+  executor_task_t task;
   bool running;
   transaction_request_queue_t queue;
   rw_lock_handle_t lock;
-  cond_handle_t cond;
   node_t *node;
+  // Number of requests answered, protected by the lock
+  uint64_t requests;
+  // Time spent answering requests, in microseconds, protected by the lock
+  uint64_t total_latency_us;
+  uint64_t max_latency_us;
+  // Only used by the task
+  tangle_t tangle;
+  uint64_t last_stats_ms;
 } responder_t;
 
+typedef struct responder_stats_s {
+  uint64_t requests;
+  uint64_t total_latency_us;
+  uint64_t max_latency_us;
+} responder_stats_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -53,10 +70,12 @@ retcode_t responder_init(responder_t *const responder, node_t *const node);
  * Starts a responder
  *
  * @param responder The responder state
+ * @param executor The executor running the responder task
  *
  * @return a status code
  */
-retcode_t responder_start(responder_t *const responder);
+retcode_t responder_start(responder_t *const responder,
+                          executor_t *const executor);
 
 /**
  * Stops a responder
@@ -77,7 +96,9 @@ retcode_t responder_stop(responder_t *const responder);
 retcode_t responder_destroy(responder_t *const responder);
 
 /**
- * Adds a request to a responder
+ * Adds a request to a responder, requests of specific transactions are
+ * answered before random tip requests. Requests over the rate limit or score
+ * of the neighbor are dropped.
  *
  * @param responder The responder state
  * @param neighbor Requesting neighbor
@@ -98,6 +119,25 @@ retcode_t responder_on_next(responder_t *const responder,
  */
 size_t responder_size(responder_t *const responder);
 
+/**
+ * Gets the statistics of the responder queue, one per priority
+ *
+ * @param responder The responder
+ * @param stats An array of GOSSIP_PRIORITY_COUNT statistics to be filled
+ */
+void responder_queue_stats(responder_t *const responder,
+                           priority_queue_stats_t *const stats);
+
+/**
+ * Gets the statistics of a responder, the latency of a request being the time
+ * spent answering it once taken from the queue
+ *
+ * @param responder The responder
+ * @param stats The statistics
+ */
+void responder_stats(responder_t *const responder,
+                     responder_stats_t *const stats);
+
 /**
  * Tells whether the responder queue is empty or not
  *
@@ -106,7 +146,7 @@ size_t responder_size(responder_t *const responder);
  * @return true if empty, false otherwise
  */
 static inline bool responder_is_empty(responder_t *const responder) {
-  return responder->queue == NULL;
+  return transaction_request_queue_empty(&responder->queue);
 }
 
 #ifdef __cplusplus
@@ -13,7 +13,7 @@
 #include "utils/logger_helper.h"
 
 #define TIPS_REQUESTER_LOGGER_ID "tips_requester"
-#define TIPS_REQUESTER_INTERVAL 5
+#define TIPS_REQUESTER_INTERVAL_MS 5000
 
 static logger_id_t logger_id;
 
@@ -21,65 +21,55 @@ static logger_id_t logger_id;
  * Private functions
  */
 
-static void *tips_requester_routine(tips_requester_t *const tips_requester) {
+/**
+ * Requests the tips of the neighbors by sending them the latest milestone and
+ * schedules itself again after an interval.
+ *
+ * @param tips_requester The tips requester state
+ */
+static void tips_requester_routine(tips_requester_t *const tips_requester) {
   iota_packet_t packet;
   neighbor_t *iter = NULL;
   DECLARE_PACK_SINGLE_TX(transaction, transaction_ptr, transaction_pack);
   DECLARE_PACK_SINGLE_MILESTONE(latest_milestone, latest_milestone_ptr,
                                 milestone_pack);
-  connection_config_t db_conf = {.db_path = tips_requester->node->conf.db_path};
-  tangle_t tangle;
-
   flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
 
-  if (tips_requester == NULL) {
-    return NULL;
+  hash_pack_reset(&milestone_pack);
+  if (iota_tangle_milestone_load_last(&tips_requester->tangle,
+                                      &milestone_pack) != RC_OK ||
+      milestone_pack.num_loaded == 0) {
+    goto done;
   }
-
-  if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
-    log_critical(logger_id, "Initializing tangle connection failed\n");
-    return NULL;
+  hash_pack_reset(&transaction_pack);
+  if (iota_tangle_transaction_load(&tips_requester->tangle,
+                                   TRANSACTION_FIELD_HASH,
+                                   latest_milestone.hash,
+                                   &transaction_pack) != RC_OK ||
+      transaction_pack.num_loaded == 0) {
+    goto done;
   }
-
-  while (tips_requester->running) {
-    hash_pack_reset(&milestone_pack);
-    if (iota_tangle_milestone_load_last(&tangle, &milestone_pack) != RC_OK ||
-        milestone_pack.num_loaded == 0) {
-      continue;
-    }
-    hash_pack_reset(&transaction_pack);
-    if (iota_tangle_transaction_load(&tangle, TRANSACTION_FIELD_HASH,
-                                     latest_milestone.hash,
-                                     &transaction_pack) != RC_OK ||
-        transaction_pack.num_loaded == 0) {
-      continue;
-    }
-    transaction_serialize_on_flex_trits(transaction_ptr,
-                                        transaction_flex_trits);
-    if (iota_packet_set_transaction(&packet, transaction_flex_trits) != RC_OK) {
-      continue;
-    }
-    if (iota_packet_set_request(
-            &packet, latest_milestone.hash,
-            tips_requester->node->conf.request_hash_size_trit) != RC_OK) {
-      continue;
-    }
-
-    rw_lock_handle_rdlock(&tips_requester->node->neighbors_lock);
-    LL_FOREACH(tips_requester->node->neighbors, iter) {
-      if (neighbor_send_packet(tips_requester->node, iter, &packet) != RC_OK) {
-        log_warning(logger_id, "Sending tip request to neighbor failed\n");
-      }
-    }
-    rw_lock_handle_unlock(&tips_requester->node->neighbors_lock);
-    sleep(TIPS_REQUESTER_INTERVAL);
+  transaction_serialize_on_flex_trits(transaction_ptr, transaction_flex_trits);
+  if (iota_packet_set_transaction(&packet, transaction_flex_trits) != RC_OK) {
+    goto done;
+  }
+  if (iota_packet_set_request(
+          &packet, latest_milestone.hash,
+          tips_requester->node->conf.request_hash_size_trit) != RC_OK) {
+    goto done;
   }
 
-  if (iota_tangle_destroy(&tangle) != RC_OK) {
-    log_critical(logger_id, "Destroying tangle connection failed\n");
+  rw_lock_handle_rdlock(&tips_requester->node->neighbors_lock);
+  LL_FOREACH(tips_requester->node->neighbors, iter) {
+    if (neighbor_send_packet(tips_requester->node, iter, &packet) != RC_OK) {
+      log_warning(logger_id, "Sending tip request to neighbor failed\n");
+    }
   }
+  rw_lock_handle_unlock(&tips_requester->node->neighbors_lock);
 
-  return NULL;
+done:
+  executor_schedule_after(tips_requester->executor, &tips_requester->task,
+                          TIPS_REQUESTER_INTERVAL_MS);
 }
 
 /*
@@ -95,44 +85,57 @@ retcode_t tips_requester_init(tips_requester_t *const tips_requester,
   logger_id =
       logger_helper_enable(TIPS_REQUESTER_LOGGER_ID, LOGGER_DEBUG, true);
 
+  tips_requester->executor = NULL;
   tips_requester->running = false;
   tips_requester->node = node;
+  executor_task_init(&tips_requester->task,
+                     (executor_routine_t)tips_requester_routine,
+                     tips_requester);
 
   return RC_OK;
 }
 
-retcode_t tips_requester_start(tips_requester_t *const tips_requester) {
-  if (tips_requester == NULL) {
+retcode_t tips_requester_start(tips_requester_t *const tips_requester,
+                               executor_t *const executor) {
+  retcode_t ret = RC_OK;
+  connection_config_t db_conf = {.db_path = NULL};
+
+  if (tips_requester == NULL || executor == NULL) {
     return RC_NULL_PARAM;
   }
 
-  log_info(logger_id, "Spawning tips requester thread\n");
-  tips_requester->running = true;
-  if (thread_handle_create(&tips_requester->thread,
-                           (thread_routine_t)tips_requester_routine,
-                           tips_requester) != 0) {
-    log_critical(logger_id, "Spawning tips requester thread failed\n");
-    return RC_FAILED_THREAD_SPAWN;
+  db_conf.db_path = tips_requester->node->conf.db_path;
+  if ((ret = iota_tangle_init(&tips_requester->tangle, &db_conf)) != RC_OK) {
+    log_critical(logger_id, "Initializing tangle connection failed\n");
+    return ret;
   }
 
+  log_info(logger_id, "Starting tips requester task\n");
+  tips_requester->executor = executor;
+  tips_requester->running = true;
+  executor_schedule(executor, &tips_requester->task);
+
   return RC_OK;
 }
 
 retcode_t tips_requester_stop(tips_requester_t *const tips_requester) {
+  retcode_t ret = RC_OK;
+
   if (tips_requester == NULL) {
     return RC_NULL_PARAM;
   } else if (tips_requester->running == false) {
     return RC_OK;
   }
 
-  log_info(logger_id, "Shutting down tips requester thread\n");
+  log_info(logger_id, "Stopping tips requester task\n");
   tips_requester->running = false;
-  if (thread_handle_join(tips_requester->thread, NULL) != 0) {
-    log_error(logger_id, "Shutting down tips requester thread failed\n");
-    return RC_FAILED_THREAD_JOIN;
+  executor_cancel(tips_requester->executor, &tips_requester->task);
+
+  if ((ret = iota_tangle_destroy(&tips_requester->tangle)) != RC_OK) {
+    log_error(logger_id, "Destroying tangle connection failed\n");
   }
 
-  return RC_OK;
+  return ret;
 }
 
 retcode_t tips_requester_destroy(tips_requester_t *const tips_requester) {
@@ -143,6 +146,7 @@ retcode_t tips_requester_destroy(tips_requester_t *const tips_requester) {
   }
 
   tips_requester->node = NULL;
+  executor_task_destroy(&tips_requester->task);
 
   logger_helper_release(logger_id);
 
@@ -11,16 +11,19 @@
 #include <stdbool.h>
 
 #include "common/errors.h"
-#include "utils/handles/thread.h"
+#include "consensus/tangle/tangle.h"
+#include "utils/handles/executor.h"
 
 // Forward declarations
 typedef struct node_s node_t;
-typedef struct tangle_s tangle_t;
 
 typedef struct tips_requester_s {
-  thread_handle_t thread;
+  executor_t *executor;
+  executor_task_t task;
   bool running;
   node_t *node;
+  // Only used by the task
+  tangle_t tangle;
 } tips_requester_t;
 
 #ifdef __cplusplus
@@ -43,10 +46,12 @@ retcode_t tips_requester_init(tips_requester_t *const tips_requester,
  * Starts a tips requester
  *
  * @param tips_requester The tips requester state
+ * @param executor The executor running the tips requester task
  *
  * @return a status code
  */
-retcode_t tips_requester_start(tips_requester_t *const tips_requester);
+retcode_t tips_requester_start(tips_requester_t *const tips_requester,
+                               executor_t *const executor);
 
 /**
  * Stops a tips requester
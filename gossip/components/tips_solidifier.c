@@ -9,7 +9,6 @@
 #include "consensus/tangle/tangle.h"
 #include "consensus/transaction_solidifier/transaction_solidifier.h"
 #include "utils/logger_helper.h"
-#include "utils/time.h"
 
 #define TIPS_SOLIDIFIER_LOGGER_ID "tips_solidifier"
 #define TIPS_SOLIDIFICATION_INTERVAL_MS 750
@@ -21,75 +20,54 @@ static logger_id_t logger_id;
  */
 
 /**
- * Routine that continuously selects a random tip from a tips cache, checks if
- * it's still a tip and tries to solidify it
+ * Selects a random tip from a tips cache, checks if it's still a tip and tries
+ * to solidify it, then schedules itself again after an interval
  *
  * @param tips_solidifier The tips solidifier
- *
- * @return a status code
  */
-static void *tips_solidifier_routine(tips_solidifier_t *const tips_solidifier) {
+static void tips_solidifier_routine(tips_solidifier_t *const tips_solidifier) {
   bool is_solid = false;
   size_t approvers_count = 0;
   flex_trit_t tip[FLEX_TRIT_SIZE_243];
-  connection_config_t db_conf = {.db_path = tips_solidifier->conf->db_path};
-  tangle_t tangle;
 
-  if (tips_solidifier == NULL) {
-    return NULL;
+  if (tips_cache_non_solid_size(tips_solidifier->tips) == 0) {
+    goto done;
   }
 
-  if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
-    log_critical(logger_id, "Initializing tangle connection failed\n");
-    return NULL;
+  if (tips_cache_random_tip(tips_solidifier->tips, tip) != RC_OK) {
+    log_warning(logger_id, "Accessing random tip from cache failed\n");
+    goto done;
   }
 
-  while (tips_solidifier->running) {
-    if (tips_cache_non_solid_size(tips_solidifier->tips) == 0) {
-      goto sleep;
-    }
-
-    if (tips_cache_random_tip(tips_solidifier->tips, tip) != RC_OK) {
-      log_warning(logger_id, "Accessing random tip from cache failed\n");
-      goto sleep;
-    }
-
-    if (iota_tangle_transaction_approvers_count(&tangle, tip,
-                                                &approvers_count) != RC_OK) {
-      log_warning(logger_id, "Counting number of approvers of tip failed\n");
-      goto sleep;
-    }
-
-    if (approvers_count != 0) {
-      if (tips_cache_remove(tips_solidifier->tips, tip) != RC_OK) {
-        log_warning(logger_id, "Removing tip from cache failed\n");
-      }
-      goto sleep;
-    }
-
-    is_solid = false;
-    if (iota_consensus_transaction_solidifier_check_solidity(
-            tips_solidifier->transaction_solidifier, &tangle, tip, false,
-            &is_solid) != RC_OK) {
-      log_warning(logger_id, "Checking solidity of tip failed\n");
-      goto sleep;
-    }
+  if (iota_tangle_transaction_approvers_count(
+          &tips_solidifier->tangle, tip, &approvers_count) != RC_OK) {
+    log_warning(logger_id, "Counting number of approvers of tip failed\n");
+    goto done;
+  }
 
-    if (is_solid) {
-      if (tips_cache_set_solid(tips_solidifier->tips, tip) != RC_OK) {
-        log_warning(logger_id, "Changing status of tip to solid failed\n");
-      }
+  if (approvers_count != 0) {
+    if (tips_cache_remove(tips_solidifier->tips, tip) != RC_OK) {
+      log_warning(logger_id, "Removing tip from cache failed\n");
     }
+    goto done;
+  }
 
-  sleep:
-    sleep_ms(TIPS_SOLIDIFICATION_INTERVAL_MS);
+  if (iota_consensus_transaction_solidifier_check_solidity(
+          tips_solidifier->transaction_solidifier, &tips_solidifier->tangle,
+          tip, false, &is_solid) != RC_OK) {
+    log_warning(logger_id, "Checking solidity of tip failed\n");
+    goto done;
   }
 
-  if (iota_tangle_destroy(&tangle) != RC_OK) {
-    log_critical(logger_id, "Destroying tangle connection failed\n");
+  if (is_solid) {
+    if (tips_cache_set_solid(tips_solidifier->tips, tip) != RC_OK) {
+      log_warning(logger_id, "Changing status of tip to solid failed\n");
+    }
   }
 
-  return NULL;
+done:
+  executor_schedule_after(tips_solidifier->executor, &tips_solidifier->task,
+                          TIPS_SOLIDIFICATION_INTERVAL_MS);
 }
 
 /*
@@ -108,45 +86,59 @@ retcode_t tips_solidifier_init(
   logger_id =
       logger_helper_enable(TIPS_SOLIDIFIER_LOGGER_ID, LOGGER_DEBUG, true);
   tips_solidifier->conf = conf;
+  tips_solidifier->executor = NULL;
   tips_solidifier->running = false;
   tips_solidifier->tips = tips;
   tips_solidifier->transaction_solidifier = transaction_solidifier;
+  executor_task_init(&tips_solidifier->task,
+                     (executor_routine_t)tips_solidifier_routine,
+                     tips_solidifier);
 
   return RC_OK;
 }
 
-retcode_t tips_solidifier_start(tips_solidifier_t *const tips_solidifier) {
-  if (tips_solidifier == NULL) {
+retcode_t tips_solidifier_start(tips_solidifier_t *const tips_solidifier,
+                                executor_t *const executor) {
+  retcode_t ret = RC_OK;
+  connection_config_t db_conf = {.db_path = NULL};
+
+  if (tips_solidifier == NULL || executor == NULL) {
     return RC_NULL_PARAM;
   }
 
-  log_info(logger_id, "Spawning tips solidifier thread\n");
-  tips_solidifier->running = true;
-  if (thread_handle_create(&tips_solidifier->thread,
-                           (thread_routine_t)tips_solidifier_routine,
-                           tips_solidifier) != 0) {
-    log_error(logger_id, "Spawning tips solidifier thread failed\n");
-    return RC_FAILED_THREAD_SPAWN;
+  db_conf.db_path = tips_solidifier->conf->db_path;
+  if ((ret = iota_tangle_init(&tips_solidifier->tangle, &db_conf)) != RC_OK) {
+    log_critical(logger_id, "Initializing tangle connection failed\n");
+    return ret;
   }
 
+  log_info(logger_id, "Starting tips solidifier task\n");
+  tips_solidifier->executor = executor;
+  tips_solidifier->running = true;
+  executor_schedule_after(executor, &tips_solidifier->task,
+                          TIPS_SOLIDIFICATION_INTERVAL_MS);
+
   return RC_OK;
 }
 
 retcode_t tips_solidifier_stop(tips_solidifier_t *const tips_solidifier) {
+  retcode_t ret = RC_OK;
+
   if (tips_solidifier == NULL) {
     return RC_NULL_PARAM;
   } else if (tips_solidifier->running == false) {
     return RC_OK;
   }
 
-  log_info(logger_id, "Shutting down tips solidifier thread\n");
+  log_info(logger_id, "Stopping tips solidifier task\n");
   tips_solidifier->running = false;
-  if (thread_handle_join(tips_solidifier->thread, NULL) != 0) {
-    log_error(logger_id, "Shutting down tips solidifier thread failed\n");
-    return RC_FAILED_THREAD_JOIN;
+  executor_cancel(tips_solidifier->executor, &tips_solidifier->task);
+
+  if ((ret = iota_tangle_destroy(&tips_solidifier->tangle)) != RC_OK) {
+    log_error(logger_id, "Destroying tangle connection failed\n");
   }
 
-  return RC_OK;
+  return ret;
 }
 
 retcode_t tips_solidifier_destroy(tips_solidifier_t *const tips_solidifier) {
@@ -159,6 +151,7 @@ retcode_t tips_solidifier_destroy(tips_solidifier_t *const tips_solidifier) {
   tips_solidifier->conf = NULL;
   tips_solidifier->tips = NULL;
   tips_solidifier->transaction_solidifier = NULL;
+  executor_task_destroy(&tips_solidifier->task);
 
   logger_helper_release(logger_id);
 
@@ -11,9 +11,10 @@
 #include <stdbool.h>
 
 #include "common/errors.h"
+#include "consensus/tangle/tangle.h"
 #include "gossip/conf.h"
 #include "gossip/tips_cache.h"
-#include "utils/handles/thread.h"
+#include "utils/handles/executor.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,10 +28,13 @@ typedef struct transaction_solidifier_s transaction_solidifier_t;
  */
 typedef struct tips_solidifier_s {
   iota_gossip_conf_t *conf;
-  thread_handle_t thread;
+  executor_t *executor;
+  executor_task_t task;
   bool running;
   tips_cache_t *tips;
   transaction_solidifier_t *transaction_solidifier;
+  // Only used by the task
+  tangle_t tangle;
 } tips_solidifier_t;
 
 /**
@@ -52,10 +56,12 @@ retcode_t tips_solidifier_init(
  * Starts a tips solidifier
  *
  * @param tips_solidifier The tips solidifier
+ * @param executor The executor running the tips solidifier task
  *
  * @return a status code
  */
-retcode_t tips_solidifier_start(tips_solidifier_t *const tips_solidifier);
+retcode_t tips_solidifier_start(tips_solidifier_t *const tips_solidifier,
+                                executor_t *const executor);
 
 /**
  * Stops a tips solidifier
@@ -47,6 +47,10 @@ retcode_t requester_destroy(
 
   hash243_set_free(&transaction_requester->milestones);
   hash243_set_free(&transaction_requester->transactions);
+  if (transaction_requester->executor) {
+    executor_task_destroy(&transaction_requester->task);
+    transaction_requester->executor = NULL;
+  }
   transaction_requester->node = NULL;
   rw_lock_handle_destroy(&transaction_requester->lock);
   logger_helper_release(logger_id);
@@ -129,6 +133,7 @@ retcode_t request_transaction(
     bool const is_milestone) {
   retcode_t ret = RC_OK;
   bool exists = false;
+  bool was_empty = false;
 
   if (transaction_requester == NULL || hash == NULL) {
     return RC_NULL_PARAM;
@@ -148,6 +153,7 @@ retcode_t request_transaction(
 
   rw_lock_handle_wrlock(&transaction_requester->lock);
 
+  was_empty = requester_is_empty(transaction_requester);
   if (is_milestone) {
     hash243_set_remove(&transaction_requester->transactions, hash);
     if ((ret = hash243_set_add(&transaction_requester->milestones, hash)) !=
@@ -165,6 +171,13 @@ retcode_t request_transaction(
 
 done:
   rw_lock_handle_unlock(&transaction_requester->lock);
+
+  // The task stops rescheduling itself once there is nothing left to request
+  if (was_empty && transaction_requester->running) {
+    executor_schedule(transaction_requester->executor,
+                      &transaction_requester->task);
+  }
+
   return ret;
 }
 
@@ -11,21 +11,25 @@
 #include <stdbool.h>
 
 #include "common/errors.h"
+#include "consensus/tangle/tangle.h"
 #include "utils/containers/hash/hash243_set.h"
+#include "utils/handles/executor.h"
 #include "utils/handles/rw_lock.h"
-#include "utils/handles/thread.h"
 
 // Forward declarations
-typedef struct tangle_s tangle_t;
 typedef struct node_s node_t;
 
 typedef struct transaction_requester_s {
-  thread_handle_t thread;
+  // Set when the requester is started, its task runs while requests are pending
+  executor_t *executor;
+  executor_task_t task;
   bool running;
   hash243_set_t milestones;
   hash243_set_t transactions;
   node_t *node;
   rw_lock_handle_t lock;
+  // Only used by the task
+  tangle_t tangle;
 } transaction_requester_t;
 
 #ifdef __cplusplus
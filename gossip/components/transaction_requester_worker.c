@@ -10,7 +10,6 @@
 #include "consensus/tangle/tangle.h"
 #include "gossip/node.h"
 #include "utils/logger_helper.h"
-#include "utils/time.h"
 
 #define REQUESTER_LOGGER_ID "requester"
 #define REQUESTER_INTERVAL 10
@@ -21,97 +20,101 @@ static logger_id_t logger_id;
  * Private functions
  */
 
-static void *transaction_requester_routine(
+/**
+ * Sends a request to every neighbor and schedules itself again after an
+ * interval while requests are pending.
+ *
+ * @param transaction_requester The transaction requester
+ */
+static void transaction_requester_routine(
     transaction_requester_t *const transaction_requester) {
   neighbor_t *iter = NULL;
   flex_trit_t hash[FLEX_TRIT_SIZE_243];
   flex_trit_t transaction[FLEX_TRIT_SIZE_8019];
   retcode_t ret = RC_OK;
   DECLARE_PACK_SINGLE_TX(tx, txp, pack);
-  connection_config_t db_conf = {.db_path =
-                                     transaction_requester->node->conf.db_path};
-  tangle_t tangle;
 
-  if (transaction_requester == NULL) {
-    return NULL;
+  if (requester_is_empty(transaction_requester)) {
+    return;
   }
 
-  if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
-    log_critical(logger_id, "Initializing tangle connection failed\n");
-    return NULL;
-  }
-
-  while (transaction_requester->running) {
-    if (requester_is_empty(transaction_requester)) {
-      goto sleep;
-    }
-    tips_cache_random_tip(&transaction_requester->node->tips, hash);
-    if (flex_trits_are_null(hash, FLEX_TRIT_SIZE_243)) {
-      memset(transaction, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_8019);
+  tips_cache_random_tip(&transaction_requester->node->tips, hash);
+  if (flex_trits_are_null(hash, FLEX_TRIT_SIZE_243)) {
+    memset(transaction, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_8019);
+  } else {
+    hash_pack_reset(&pack);
+    ret = iota_tangle_transaction_load(&transaction_requester->tangle,
+                                       TRANSACTION_FIELD_HASH, hash, &pack);
+    if (ret == RC_OK && pack.num_loaded != 0) {
+      transaction_serialize_on_flex_trits(txp, transaction);
     } else {
-      hash_pack_reset(&pack);
-      ret = iota_tangle_transaction_load(&tangle, TRANSACTION_FIELD_HASH, hash,
-                                         &pack);
-      if (ret == RC_OK && pack.num_loaded != 0) {
-        transaction_serialize_on_flex_trits(txp, transaction);
-      } else {
-        memset(transaction, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_8019);
-      }
-    }
-    rw_lock_handle_rdlock(&transaction_requester->node->neighbors_lock);
-    LL_FOREACH(transaction_requester->node->neighbors, iter) {
-      if (neighbor_send(transaction_requester->node, &tangle, iter,
-                        transaction) != RC_OK) {
-        log_warning(logger_id, "Sending request failed\n");
-      }
+      memset(transaction, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_8019);
     }
-    rw_lock_handle_unlock(&transaction_requester->node->neighbors_lock);
-  sleep:
-    sleep_ms(REQUESTER_INTERVAL);
   }
-
-  if (iota_tangle_destroy(&tangle) != RC_OK) {
-    log_critical(logger_id, "Destroying tangle connection failed\n");
+  rw_lock_handle_rdlock(&transaction_requester->node->neighbors_lock);
+  LL_FOREACH(transaction_requester->node->neighbors, iter) {
+    if (neighbor_send(transaction_requester->node,
+                      &transaction_requester->tangle, iter,
+                      transaction) != RC_OK) {
+      log_warning(logger_id, "Sending request failed\n");
+    }
   }
+  rw_lock_handle_unlock(&transaction_requester->node->neighbors_lock);
 
-  return NULL;
+  executor_schedule_after(transaction_requester->executor,
+                          &transaction_requester->task, REQUESTER_INTERVAL);
 }
 
 /*
  * Public functions
  */
 
-retcode_t requester_start(
-    transaction_requester_t *const transaction_requester) {
-  if (transaction_requester == NULL) {
+retcode_t requester_start(transaction_requester_t *const transaction_requester,
+                          executor_t *const executor) {
+  retcode_t ret = RC_OK;
+  connection_config_t db_conf = {.db_path = NULL};
+
+  if (transaction_requester == NULL || executor == NULL) {
     return RC_NULL_PARAM;
   }
 
   logger_id = logger_helper_enable(REQUESTER_LOGGER_ID, LOGGER_DEBUG, true);
-  log_info(logger_id, "Spawning transaction requester thread\n");
-  transaction_requester->running = true;
-  if (thread_handle_create(&transaction_requester->thread,
-                           (thread_routine_t)transaction_requester_routine,
-                           transaction_requester) != 0) {
-    return RC_FAILED_THREAD_SPAWN;
+
+  db_conf.db_path = transaction_requester->node->conf.db_path;
+  if ((ret = iota_tangle_init(&transaction_requester->tangle, &db_conf)) !=
+      RC_OK) {
+    log_critical(logger_id, "Initializing tangle connection failed\n");
+    return ret;
   }
 
+  log_info(logger_id, "Starting transaction requester task\n");
+  executor_task_init(&transaction_requester->task,
+                     (executor_routine_t)transaction_requester_routine,
+                     transaction_requester);
+  transaction_requester->executor = executor;
+  transaction_requester->running = true;
+  executor_schedule(executor, &transaction_requester->task);
+
   return RC_OK;
 }
 
 retcode_t requester_stop(transaction_requester_t *const transaction_requester) {
+  retcode_t ret = RC_OK;
+
   if (transaction_requester == NULL) {
     return RC_NULL_PARAM;
   } else if (transaction_requester->running == false) {
     return RC_OK;
   }
 
-  log_info(logger_id, "Shutting down transaction requester thread\n");
+  log_info(logger_id, "Stopping transaction requester task\n");
   transaction_requester->running = false;
-  if (thread_handle_join(transaction_requester->thread, NULL) != 0) {
-    log_error(logger_id, "Shutting down transaction requester thread failed\n");
-    return RC_FAILED_THREAD_JOIN;
+  executor_cancel(transaction_requester->executor,
+                  &transaction_requester->task);
+
+  if ((ret = iota_tangle_destroy(&transaction_requester->tangle)) != RC_OK) {
+    log_error(logger_id, "Destroying tangle connection failed\n");
   }
 
-  return RC_OK;
+  return ret;
 }
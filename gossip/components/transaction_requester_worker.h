@@ -19,10 +19,12 @@ extern "C" {
  * Starts a transaction requester
  *
  * @param transaction_requester The transaction requester
+ * @param executor The executor running the transaction requester task
  *
  * @return a status code
  */
-retcode_t requester_start(transaction_requester_t *const transaction_requester);
+retcode_t requester_start(transaction_requester_t *const transaction_requester,
+                          executor_t *const executor);
 
 /**
  * Stops a transaction requester
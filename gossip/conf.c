@@ -24,7 +24,15 @@ retcode_t iota_gossip_conf_init(iota_gossip_conf_t* const conf) {
   conf->p_select_milestone = DEFAULT_PROBABILITY_SELECT_MILESTONE;
   conf->p_send_milestone = DEFAULT_PROBABILITY_SEND_MILESTONE;
   conf->tips_cache_size = DEFAULT_TIPS_CACHE_SIZE;
+  conf->packet_cache_size = DEFAULT_PACKET_CACHE_SIZE;
+  conf->packet_compression = DEFAULT_PACKET_COMPRESSION;
   conf->requester_queue_size = DEFAULT_REQUESTER_QUEUE_SIZE;
+  conf->gossip_queue_size = DEFAULT_GOSSIP_QUEUE_SIZE;
+  conf->neighbor_packets_rate = DEFAULT_NEIGHBOR_PACKETS_RATE;
+  conf->neighbor_requests_rate = DEFAULT_NEIGHBOR_REQUESTS_RATE;
+  conf->neighbor_bytes_rate = DEFAULT_NEIGHBOR_BYTES_RATE;
+  conf->neighbor_throttle_score = DEFAULT_NEIGHBOR_THROTTLE_SCORE;
+  conf->neighbor_disconnect_score = DEFAULT_NEIGHBOR_DISCONNECT_SCORE;
 
   return RC_OK;
 }
@@ -8,6 +8,7 @@
 #ifndef __GOSSIP_CONF_H__
 #define __GOSSIP_CONF_H__
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "common/errors.h"
@@ -26,7 +27,15 @@
 #define DEFAULT_PROBABILITY_SELECT_MILESTONE 0.7
 #define DEFAULT_PROBABILITY_SEND_MILESTONE 0.02
 #define DEFAULT_TIPS_CACHE_SIZE 5000
+#define DEFAULT_PACKET_CACHE_SIZE 5000
+#define DEFAULT_PACKET_COMPRESSION false
 #define DEFAULT_REQUESTER_QUEUE_SIZE 10000
+#define DEFAULT_GOSSIP_QUEUE_SIZE 10000
+#define DEFAULT_NEIGHBOR_PACKETS_RATE 500
+#define DEFAULT_NEIGHBOR_REQUESTS_RATE 500
+#define DEFAULT_NEIGHBOR_BYTES_RATE 2097152
+#define DEFAULT_NEIGHBOR_THROTTLE_SCORE 0.5
+#define DEFAULT_NEIGHBOR_DISCONNECT_SCORE 0.1
 
 #ifdef __cplusplus
 extern "C" {
@@ -64,8 +73,30 @@ typedef struct iota_gossip_conf_s {
   double p_send_milestone;
   // Size of the tips cache
   size_t tips_cache_size;
+  // Maximum number of wire encoded transactions cached to answer requests
+  size_t packet_cache_size;
+  // Whether to offer TCP neighbors to send compressed packets, leaving out the
+  // trailing zero bytes of the signature or message fragment
+  bool packet_compression;
   // Size of the requester queue
   size_t requester_queue_size;
+  // Maximum number of entries in each of the processor, broadcaster and
+  // responder queues before less urgent ones are dropped, 0 for no limit
+  size_t gossip_queue_size;
+  // Maximum number of packets per second accepted from a neighbor, 0 for no
+  // limit
+  size_t neighbor_packets_rate;
+  // Maximum number of requests per second answered to a neighbor, 0 for no
+  // limit
+  size_t neighbor_requests_rate;
+  // Maximum number of bytes per second sent to a neighbor, 0 for no limit
+  size_t neighbor_bytes_rate;
+  // Score under which the rate limits of a neighbor are scaled down by its
+  // score. Value must be in [0,1]
+  double neighbor_throttle_score;
+  // Score under which a neighbor is disconnected for a while. Value must be in
+  // [0,1]
+  double neighbor_disconnect_score;
   // Path of the DB file
   char db_path[128];
 } iota_gossip_conf_t;
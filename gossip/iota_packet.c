@@ -6,6 +6,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "common/model/transaction.h"
 #include "gossip/iota_packet.h"
@@ -58,22 +59,101 @@ retcode_t iota_packet_set_endpoint(iota_packet_t *const packet,
   return RC_OK;
 }
 
-bool iota_packet_queue_empty(iota_packet_queue_t const queue) {
-  return (queue == NULL);
+size_t iota_packet_compress(byte_t const *const transaction,
+                            byte_t const *const request,
+                            byte_t *const compressed) {
+  size_t length = PACKET_SIGNATURE_SIZE;
+  byte_t *tail = NULL;
+
+  while (length > 0 && transaction[length - 1] == 0) {
+    length--;
+  }
+
+  compressed[0] = PACKET_COMPRESSED_MARKER;
+  compressed[1] = (byte_t)(length >> 8);
+  compressed[2] = (byte_t)(length & 0xFF);
+  memcpy(compressed + PACKET_COMPRESSED_HEADER_SIZE, transaction, length);
+  tail = compressed + PACKET_COMPRESSED_HEADER_SIZE + length;
+  memcpy(tail, transaction + PACKET_SIGNATURE_SIZE,
+         PACKET_TX_SIZE - PACKET_SIGNATURE_SIZE);
+  memcpy(tail + PACKET_TX_SIZE - PACKET_SIGNATURE_SIZE, request,
+         REQUEST_HASH_SIZE);
+
+  return tail - compressed + PACKET_SIZE - PACKET_SIGNATURE_SIZE;
+}
+
+retcode_t iota_packet_compressed_size(byte_t const *const header,
+                                      size_t *const size) {
+  size_t length = 0;
+
+  if (header == NULL || size == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  length = ((uint8_t)header[1] << 8) | (uint8_t)header[2];
+  if (header[0] != PACKET_COMPRESSED_MARKER ||
+      length > PACKET_SIGNATURE_SIZE) {
+    return RC_GOSSIP_INVALID_COMPRESSED_PACKET;
+  }
+
+  *size = PACKET_COMPRESSED_HEADER_SIZE + length + PACKET_SIZE -
+          PACKET_SIGNATURE_SIZE;
+
+  return RC_OK;
+}
+
+retcode_t iota_packet_decompress(iota_packet_t *const packet,
+                                 byte_t const *const compressed,
+                                 size_t const size) {
+  retcode_t ret = RC_OK;
+  size_t expected_size = 0;
+  size_t length = 0;
+
+  if (packet == NULL || compressed == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if (size < PACKET_COMPRESSED_HEADER_SIZE) {
+    return RC_GOSSIP_INVALID_COMPRESSED_PACKET;
+  }
+  if ((ret = iota_packet_compressed_size(compressed, &expected_size)) !=
+      RC_OK) {
+    return ret;
+  }
+  if (size != expected_size) {
+    return RC_GOSSIP_INVALID_COMPRESSED_PACKET;
+  }
+
+  length = expected_size - PACKET_COMPRESSED_HEADER_SIZE - PACKET_SIZE +
+           PACKET_SIGNATURE_SIZE;
+  memcpy(packet->content, compressed + PACKET_COMPRESSED_HEADER_SIZE, length);
+  memset(packet->content + length, 0, PACKET_SIGNATURE_SIZE - length);
+  memcpy(packet->content + PACKET_SIGNATURE_SIZE,
+         compressed + PACKET_COMPRESSED_HEADER_SIZE + length,
+         PACKET_SIZE - PACKET_SIGNATURE_SIZE);
+
+  return RC_OK;
+}
+
+void iota_packet_queue_init(iota_packet_queue_t *const queue,
+                            size_t const capacity) {
+  priority_queue_init(queue, capacity);
 }
 
-size_t iota_packet_queue_count(iota_packet_queue_t const queue) {
-  iota_packet_queue_entry_t *iter = NULL;
-  size_t count = 0;
-  CDL_COUNT(queue, iter, count);
-  return count;
+bool iota_packet_queue_empty(iota_packet_queue_t const *const queue) {
+  return priority_queue_empty(queue);
+}
+
+size_t iota_packet_queue_count(iota_packet_queue_t const *const queue) {
+  return priority_queue_size(queue);
 }
 
 retcode_t iota_packet_queue_push(iota_packet_queue_t *const queue,
-                                 iota_packet_t const *const packet) {
+                                 iota_packet_t const *const packet,
+                                 gossip_priority_t const priority) {
   iota_packet_queue_entry_t *entry = NULL;
 
-  if (queue == NULL) {
+  if (queue == NULL || packet == NULL) {
     return RC_NULL_PARAM;
   }
 
@@ -82,41 +162,37 @@ retcode_t iota_packet_queue_push(iota_packet_queue_t *const queue,
     return RC_OOM;
   }
   entry->packet = *packet;
-  CDL_APPEND(*queue, entry);
+  // Dropping a packet is the expected outcome of a flood, not an error
+  free(priority_queue_push(queue, &entry->entry, priority));
   return RC_OK;
 }
 
 void iota_packet_queue_pop(iota_packet_queue_t *const queue) {
-  iota_packet_queue_entry_t *tmp = NULL;
-
   if (queue == NULL) {
     return;
   }
-
-  tmp = *queue;
-  if (tmp != NULL) {
-    CDL_DELETE(*queue, *queue);
-    free(tmp);
-  }
+  free(priority_queue_pop(queue));
 }
 
-iota_packet_t *iota_packet_queue_peek(iota_packet_queue_t const queue) {
-  if (queue == NULL) {
+iota_packet_t *iota_packet_queue_peek(iota_packet_queue_t const *const queue) {
+  iota_packet_queue_entry_t *entry = NULL;
+
+  if (queue == NULL ||
+      (entry = (iota_packet_queue_entry_t *)priority_queue_peek(queue)) ==
+          NULL) {
     return NULL;
   }
-  return &queue->packet;
+  return &entry->packet;
 }
 
 void iota_packet_queue_free(iota_packet_queue_t *const queue) {
-  iota_packet_queue_entry_t *iter = NULL, *tmp1 = NULL, *tmp2 = NULL;
+  priority_queue_entry_t *entry = NULL;
 
   if (queue == NULL) {
     return;
   }
 
-  CDL_FOREACH_SAFE(*queue, iter, tmp1, tmp2) {
-    CDL_DELETE(*queue, iter);
-    free(iter);
+  while ((entry = priority_queue_pop(queue)) != NULL) {
+    free(entry);
   }
-  *queue = NULL;
 }
@@ -8,13 +8,25 @@
 #ifndef __GOSSIP_IOTA_PACKET_H__
 #define __GOSSIP_IOTA_PACKET_H__
 
-#include "utlist.h"
+#include <stdint.h>
 
 #include "common/errors.h"
+#include "common/model/transaction.h"
 #include "common/network/endpoint.h"
 #include "common/trinary/bytes.h"
 #include "common/trinary/flex_trit.h"
 #include "gossip/conf.h"
+#include "gossip/priority_queue.h"
+
+// Bytes of a packet only made of trits of the signature or message fragment
+#define PACKET_SIGNATURE_SIZE (NUM_TRITS_SIGNATURE / NUMBER_OF_TRITS_IN_A_BYTE)
+// First byte of a compressed packet. No trits encode to it so that it can't
+// be mistaken for the first byte of a fixed-size packet
+#define PACKET_COMPRESSED_MARKER INT8_MIN
+// Marker followed by the length of the signature or message fragment, big
+// endian
+#define PACKET_COMPRESSED_HEADER_SIZE 3
+#define PACKET_COMPRESSED_MAX_SIZE (PACKET_COMPRESSED_HEADER_SIZE + PACKET_SIZE)
 
 /**
  * The IOTA gossip protocol exchange packet that contains:
@@ -28,16 +40,16 @@ typedef struct iota_packet_s {
 } iota_packet_t;
 
 /**
- * A queue of packet used to dispatch packets in different threads.
+ * A bounded priority queue of packets used to dispatch packets in different
+ * threads.
  * Not concurrent by default.
  */
 typedef struct iota_packet_queue_entry_s {
+  priority_queue_entry_t entry;
   iota_packet_t packet;
-  struct iota_packet_queue_entry_s* next;
-  struct iota_packet_queue_entry_s* prev;
 } iota_packet_queue_entry_t;
 
-typedef iota_packet_queue_entry_t* iota_packet_queue_t;
+typedef priority_queue_t iota_packet_queue_t;
 
 #ifdef __cplusplus
 extern "C" {
@@ -81,6 +93,54 @@ retcode_t iota_packet_set_endpoint(iota_packet_t* const packet,
                                    char const* const ip, uint16_t const port,
                                    protocol_type_t const protocol);
 
+/**
+ * Compresses a packet given as its transaction and request parts. The
+ * trailing zero bytes of the signature or message fragment, which make most of
+ * a zero-value transaction, are left out and the rest is copied as is.
+ *
+ * @param transaction The transaction bytes of the packet
+ * @param request The request bytes of the packet
+ * @param compressed A buffer of PACKET_COMPRESSED_MAX_SIZE bytes
+ *
+ * @return the size of the compressed packet
+ */
+size_t iota_packet_compress(byte_t const* const transaction,
+                            byte_t const* const request,
+                            byte_t* const compressed);
+
+/**
+ * Gets the size of a compressed packet from its header
+ *
+ * @param header The first PACKET_COMPRESSED_HEADER_SIZE bytes of the packet
+ * @param size The size of the compressed packet, header included
+ *
+ * @return a status code
+ */
+retcode_t iota_packet_compressed_size(byte_t const* const header,
+                                      size_t* const size);
+
+/**
+ * Decompresses a packet
+ *
+ * @param packet The packet
+ * @param compressed The compressed packet
+ * @param size The size of the compressed packet
+ *
+ * @return a status code
+ */
+retcode_t iota_packet_decompress(iota_packet_t* const packet,
+                                 byte_t const* const compressed,
+                                 size_t const size);
+
+/**
+ * Initializes an empty packet queue
+ *
+ * @param queue The packet queue
+ * @param capacity The maximum number of packets, 0 for an unbounded queue
+ */
+void iota_packet_queue_init(iota_packet_queue_t* const queue,
+                            size_t const capacity);
+
 /**
  * Tells whether a packet queue is empty or not
  *
@@ -88,7 +148,7 @@ retcode_t iota_packet_set_endpoint(iota_packet_t* const packet,
  *
  * @return true if empty, false otherwise
  */
-bool iota_packet_queue_empty(iota_packet_queue_t const queue);
+bool iota_packet_queue_empty(iota_packet_queue_t const* const queue);
 
 /**
  * Gets the size of a packet queue
@@ -97,18 +157,21 @@ bool iota_packet_queue_empty(iota_packet_queue_t const queue);
  *
  * @return the size of the packet queue
  */
-size_t iota_packet_queue_count(iota_packet_queue_t const queue);
+size_t iota_packet_queue_count(iota_packet_queue_t const* const queue);
 
 /**
- * Pushes a packet to a packet queue
+ * Pushes a packet to a packet queue, a full queue makes room for it by dropping
+ * a less urgent packet or drops it if there is none
  *
  * @param queue The packet queue
  * @param packet The packet
+ * @param priority The priority of the packet
  *
  * @return a status code
  */
 retcode_t iota_packet_queue_push(iota_packet_queue_t* const queue,
-                                 iota_packet_t const* const packet);
+                                 iota_packet_t const* const packet,
+                                 gossip_priority_t const priority);
 
 /**
  * Pops a packet from a packet queue
@@ -126,7 +189,7 @@ void iota_packet_queue_pop(iota_packet_queue_t* const queue);
  *
  * @return the packet
  */
-iota_packet_t* iota_packet_queue_peek(iota_packet_queue_t const queue);
+iota_packet_t* iota_packet_queue_peek(iota_packet_queue_t const* const queue);
 
 /**
  * Frees a packet queue
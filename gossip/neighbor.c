@@ -14,6 +14,133 @@
 #include "gossip/services/tcp_sender.hpp"
 #include "gossip/services/udp_sender.hpp"
 #include "utils/handles/rand.h"
+#include "utils/time.h"
+
+#define NEIGHBOR_SCORE_WINDOW_MS 10000
+// Minimum number of transactions received in a window to update the score
+#define NEIGHBOR_SCORE_MIN_TX 50
+// Weight of the last window in the score
+#define NEIGHBOR_SCORE_ALPHA 0.5
+#define NEIGHBOR_DISCONNECT_MS 60000
+
+/*
+ * Private functions
+ */
+
+static void neighbor_traffic_window_reset(neighbor_t *const neighbor,
+                                          uint64_t const now_ms) {
+  neighbor->traffic.window_start_ms = now_ms;
+  neighbor->traffic.window_all_tx = neighbor->nbr_all_tx;
+  neighbor->traffic.window_invalid_tx = neighbor->nbr_invalid_tx;
+}
+
+/**
+ * Updates the score and state of a neighbor once a window is over, the caller
+ * must hold the traffic lock
+ *
+ * @param neighbor The neighbor
+ * @param conf Gossip configuration
+ * @param now_ms The current time in milliseconds
+ */
+static void neighbor_traffic_update(neighbor_t *const neighbor,
+                                    iota_gossip_conf_t const *const conf,
+                                    uint64_t const now_ms) {
+  neighbor_traffic_t *const traffic = &neighbor->traffic;
+  unsigned int all = 0, invalid = 0;
+  double sample = 0;
+
+  if (traffic->state == NEIGHBOR_DISCONNECTED) {
+    if (now_ms >= traffic->disconnected_until_ms) {
+      // Back on probation
+      traffic->state = NEIGHBOR_THROTTLED;
+      traffic->score = conf->neighbor_throttle_score;
+      neighbor_traffic_window_reset(neighbor, now_ms);
+    }
+    return;
+  } else if (traffic->window_start_ms == 0) {
+    neighbor_traffic_window_reset(neighbor, now_ms);
+    return;
+  } else if (now_ms - traffic->window_start_ms < NEIGHBOR_SCORE_WINDOW_MS) {
+    return;
+  }
+
+  all = neighbor->nbr_all_tx - traffic->window_all_tx;
+  if (all < NEIGHBOR_SCORE_MIN_TX) {
+    return;
+  }
+  invalid = neighbor->nbr_invalid_tx - traffic->window_invalid_tx;
+
+  // An honest neighbor in a mesh of k neighbors only brings about 1/k of the
+  // new transactions, duplicates are therefore neutral and only invalid
+  // transactions lower the score
+  sample = invalid >= all ? 0.0 : 1.0 - (double)invalid / all;
+  traffic->score = (1.0 - NEIGHBOR_SCORE_ALPHA) * traffic->score +
+                   NEIGHBOR_SCORE_ALPHA * sample;
+  neighbor_traffic_window_reset(neighbor, now_ms);
+
+  if (traffic->score < conf->neighbor_disconnect_score) {
+    traffic->state = NEIGHBOR_DISCONNECTED;
+    traffic->disconnected_until_ms = now_ms + NEIGHBOR_DISCONNECT_MS;
+  } else if (traffic->score < conf->neighbor_throttle_score) {
+    traffic->state = NEIGHBOR_THROTTLED;
+  } else {
+    traffic->state = NEIGHBOR_ACTIVE;
+  }
+}
+
+/**
+ * Gets a rate limit as applied to a neighbor, scaled down by its score if
+ * throttled
+ *
+ * @param traffic The traffic control state of the neighbor
+ * @param rate The configured rate limit, 0 for no limit
+ *
+ * @return the rate limit
+ */
+static double neighbor_rate(neighbor_traffic_t const *const traffic,
+                            size_t const rate) {
+  if (rate == 0 || traffic->state != NEIGHBOR_THROTTLED) {
+    return rate;
+  }
+  return rate * traffic->score < 1.0 ? 1.0 : rate * traffic->score;
+}
+
+/**
+ * Takes from a token bucket of a neighbor, a second worth of traffic is
+ * allowed in a burst. Nothing is admitted while the neighbor is disconnected.
+ *
+ * @param neighbor The neighbor
+ * @param conf Gossip configuration
+ * @param bucket The token bucket
+ * @param rate The configured rate limit
+ * @param throttled Whether the rate is scaled down for a throttled neighbor
+ * @param amount The number of tokens to take
+ *
+ * @return true if admitted, false otherwise
+ */
+static bool neighbor_admit(neighbor_t *const neighbor,
+                           iota_gossip_conf_t const *const conf,
+                           token_bucket_t *const bucket, size_t const rate,
+                           bool const throttled, double const amount) {
+  bool admitted = false;
+  uint64_t const now_ms = current_timestamp_ms();
+  double limit = 0;
+
+  lock_handle_lock(&neighbor->traffic.lock);
+  neighbor_traffic_update(neighbor, conf, now_ms);
+  if (neighbor->traffic.state != NEIGHBOR_DISCONNECTED) {
+    limit = throttled ? neighbor_rate(&neighbor->traffic, rate) : rate;
+    admitted = token_bucket_take(bucket, limit, limit < amount ? amount : limit,
+                                 amount, now_ms);
+  }
+  lock_handle_unlock(&neighbor->traffic.lock);
+
+  return admitted;
+}
+
+/*
+ * Public functions
+ */
 
 retcode_t neighbor_init_with_uri(neighbor_t *const neighbor,
                                  char const *const uri) {
@@ -26,6 +153,7 @@ retcode_t neighbor_init_with_uri(neighbor_t *const neighbor,
     return RC_NEIGHBOR_NULL_URI;
   }
   memset(neighbor, 0, sizeof(neighbor_t));
+  neighbor->traffic.score = 1.0;
   if (uri_parse(uri, scheme, MAX_SCHEME_LENGTH, neighbor->endpoint.host,
                 MAX_HOST_LENGTH, &neighbor->endpoint.port) == false) {
     return RC_NEIGHBOR_FAILED_URI_PARSING;
@@ -48,6 +176,7 @@ retcode_t neighbor_init_with_values(neighbor_t *const neighbor,
   }
 
   memset(neighbor, 0, sizeof(neighbor_t));
+  neighbor->traffic.score = 1.0;
   neighbor->endpoint.protocol = protocol;
   if (ip) {
     if (strlen(ip) > MAX_HOST_LENGTH) {
@@ -59,20 +188,65 @@ retcode_t neighbor_init_with_values(neighbor_t *const neighbor,
   return RC_OK;
 }
 
-retcode_t neighbor_send_packet(node_t *const node, neighbor_t *const neighbor,
-                               iota_packet_t const *const packet) {
-  if (node == NULL || neighbor == NULL || packet == NULL) {
-    return RC_NULL_PARAM;
+bool neighbor_admit_packet(neighbor_t *const neighbor,
+                           iota_gossip_conf_t const *const conf) {
+  if (neighbor_admit(neighbor, conf, &neighbor->traffic.packets,
+                     conf->neighbor_packets_rate, true, 1)) {
+    return true;
+  }
+  neighbor->nbr_dropped_tx++;
+  return false;
+}
+
+bool neighbor_admit_request(neighbor_t *const neighbor,
+                            iota_gossip_conf_t const *const conf) {
+  if (neighbor_admit(neighbor, conf, &neighbor->traffic.requests,
+                     conf->neighbor_requests_rate, true, 1)) {
+    return true;
+  }
+  neighbor->nbr_dropped_req++;
+  return false;
+}
+
+void neighbor_traffic_status(neighbor_t *const neighbor,
+                             iota_gossip_conf_t const *const conf,
+                             neighbor_traffic_status_t *const status) {
+  lock_handle_lock(&neighbor->traffic.lock);
+  status->state = neighbor->traffic.state;
+  status->score = neighbor->traffic.score;
+  status->packets_rate =
+      neighbor_rate(&neighbor->traffic, conf->neighbor_packets_rate);
+  status->requests_rate =
+      neighbor_rate(&neighbor->traffic, conf->neighbor_requests_rate);
+  status->bytes_rate = conf->neighbor_bytes_rate;
+  lock_handle_unlock(&neighbor->traffic.lock);
+}
+
+/**
+ * Sends a packet given as its transaction and request parts, which are
+ * gathered by the senders without being copied together. Bytes sent to a
+ * neighbor are not scaled down by its score, the limit only protects the
+ * bandwidth of this node.
+ */
+static retcode_t neighbor_send_parts(node_t *const node,
+                                     neighbor_t *const neighbor,
+                                     byte_t const *const transaction,
+                                     byte_t const *const request) {
+  if (!neighbor_admit(neighbor, &node->conf, &neighbor->traffic.bytes,
+                      node->conf.neighbor_bytes_rate, false, PACKET_SIZE)) {
+    // Not an error, the caller goes on with the other neighbors
+    neighbor->nbr_dropped_sent_tx++;
+    return RC_OK;
   }
 
   if (neighbor->endpoint.protocol == PROTOCOL_TCP) {
-    if (tcp_send(&node->receiver.tcp_service, &neighbor->endpoint, packet) ==
-        false) {
+    if (tcp_send(&node->receiver.tcp_service, &neighbor->endpoint,
+                 transaction, request) == false) {
       return RC_NEIGHBOR_FAILED_SEND;
     }
   } else if (neighbor->endpoint.protocol == PROTOCOL_UDP) {
-    if (udp_send(&node->receiver.udp_service, &neighbor->endpoint, packet) ==
-        false) {
+    if (udp_send(&node->receiver.udp_service, &neighbor->endpoint,
+                 transaction, request) == false) {
       return RC_NEIGHBOR_FAILED_SEND;
     }
   } else {
@@ -84,21 +258,27 @@ retcode_t neighbor_send_packet(node_t *const node, neighbor_t *const neighbor,
   return RC_OK;
 }
 
-retcode_t neighbor_send(node_t *const node, tangle_t *const tangle,
-                        neighbor_t *const neighbor,
-                        flex_trit_t const *const transaction) {
+retcode_t neighbor_send_packet(node_t *const node, neighbor_t *const neighbor,
+                               iota_packet_t const *const packet) {
+  if (node == NULL || neighbor == NULL || packet == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  return neighbor_send_parts(node, neighbor, packet->content,
+                             packet->content + PACKET_TX_SIZE);
+}
+
+retcode_t neighbor_send_bytes(node_t *const node, tangle_t *const tangle,
+                              neighbor_t *const neighbor,
+                              byte_t const *const transaction) {
   retcode_t ret = RC_OK;
-  iota_packet_t packet;
   flex_trit_t request[FLEX_TRIT_SIZE_243];
+  byte_t request_bytes[REQUEST_HASH_SIZE];
 
   if (node == NULL || neighbor == NULL || transaction == NULL) {
     return RC_NULL_PARAM;
   }
 
-  if ((ret = iota_packet_set_transaction(&packet, transaction)) != RC_OK) {
-    return ret;
-  }
-
   bool is_milestone = rand_handle_probability() < node->conf.p_select_milestone;
 
   if ((ret = get_transaction_to_request(&node->transaction_requester, tangle,
@@ -106,12 +286,31 @@ retcode_t neighbor_send(node_t *const node, tangle_t *const tangle,
     return ret;
   }
 
-  if ((ret = iota_packet_set_request(
-           &packet, request, node->conf.request_hash_size_trit)) != RC_OK) {
+  if (flex_trits_to_bytes(request_bytes, node->conf.request_hash_size_trit,
+                          request, HASH_LENGTH_TRIT,
+                          node->conf.request_hash_size_trit) !=
+      node->conf.request_hash_size_trit) {
+    return RC_GOSSIP_SET_PACKET_REQUEST_FAILED;
+  }
+
+  return neighbor_send_parts(node, neighbor, transaction, request_bytes);
+}
+
+retcode_t neighbor_send(node_t *const node, tangle_t *const tangle,
+                        neighbor_t *const neighbor,
+                        flex_trit_t const *const transaction) {
+  retcode_t ret = RC_OK;
+  iota_packet_t packet;
+
+  if (node == NULL || neighbor == NULL || transaction == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if ((ret = iota_packet_set_transaction(&packet, transaction)) != RC_OK) {
     return ret;
   }
 
-  return neighbor_send_packet(node, neighbor, &packet);
+  return neighbor_send_bytes(node, tangle, neighbor, packet.content);
 }
 
 static int neighbor_cmp(neighbor_t const *const lhs,
@@ -146,6 +345,7 @@ retcode_t neighbors_add(neighbor_t **const neighbors,
   }
 
   memcpy(entry, neighbor, sizeof(neighbor_t));
+  lock_handle_init(&entry->traffic.lock);
   LL_PREPEND(*neighbors, entry);
 
   if (entry->endpoint.protocol == PROTOCOL_UDP) {
@@ -184,6 +384,7 @@ retcode_t neighbors_remove_entry(neighbor_t **const neighbors,
   }
 
   LL_DELETE(*neighbors, neighbor);
+  lock_handle_destroy(&neighbor->traffic.lock);
   free(neighbor);
 
   return ret;
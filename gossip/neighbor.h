@@ -14,23 +14,73 @@
 
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
+#include "gossip/conf.h"
 #include "gossip/iota_packet.h"
 #include "utarray.h"
+#include "utils/handles/lock.h"
+#include "utils/token_bucket.h"
 
 // Forward declarations
 typedef struct node_s node_t;
 typedef struct tangle_s tangle_t;
 
+typedef enum neighbor_state_e {
+  NEIGHBOR_ACTIVE,
+  // Rate limits of the neighbor are scaled down by its score
+  NEIGHBOR_THROTTLED,
+  // All traffic from and to the neighbor is dropped for a while
+  NEIGHBOR_DISCONNECTED,
+} neighbor_state_t;
+
+/**
+ * Traffic control of a neighbor: its packets, the requests it makes and the
+ * bytes sent to it go through token buckets, and a score tracks how useful the
+ * transactions it sends are. The score is an exponential moving average of the
+ * share of valid transactions, duplicates included, over windows of
+ * NEIGHBOR_SCORE_WINDOW_MS. A low score throttles the neighbor, a very low one
+ * disconnects it for NEIGHBOR_DISCONNECT_MS after which it is on probation
+ * with a throttling score.
+ */
+typedef struct neighbor_traffic_s {
+  // Guards the traffic control state, which is updated by several threads
+  lock_handle_t lock;
+  token_bucket_t packets;
+  token_bucket_t requests;
+  token_bucket_t bytes;
+  neighbor_state_t state;
+  double score;
+  uint64_t window_start_ms;
+  // Counters of the neighbor at the start of the window
+  unsigned int window_all_tx;
+  unsigned int window_invalid_tx;
+  uint64_t disconnected_until_ms;
+} neighbor_traffic_t;
+
 typedef struct neighbor_s {
   endpoint_t endpoint;
   unsigned int nbr_all_tx;
   unsigned int nbr_new_tx;
   unsigned int nbr_invalid_tx;
+  unsigned int nbr_duplicate_tx;
   unsigned int nbr_sent_tx;
   unsigned int nbr_random_tx_req;
+  // Traffic dropped by the rate limits or because of the neighbor state
+  unsigned int nbr_dropped_tx;
+  unsigned int nbr_dropped_req;
+  unsigned int nbr_dropped_sent_tx;
+  neighbor_traffic_t traffic;
   struct neighbor_s *next;
 } neighbor_t;
 
+typedef struct neighbor_traffic_status_s {
+  neighbor_state_t state;
+  double score;
+  // Limits currently applied to the neighbor, 0 for no limit
+  double packets_rate;
+  double requests_rate;
+  double bytes_rate;
+} neighbor_traffic_status_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -60,6 +110,43 @@ retcode_t neighbor_init_with_values(neighbor_t *const neighbor,
                                     char const *const ip, uint16_t const port,
                                     protocol_type_t const protocol);
 
+/**
+ * Tells whether a packet received from a neighbor may be processed, according
+ * to its state and packets rate limit. The score of the neighbor is updated on
+ * the way. Dropped packets are counted in nbr_dropped_tx.
+ *
+ * @param neighbor The neighbor
+ * @param conf Gossip configuration
+ *
+ * @return true if the packet is admitted, false if it must be dropped
+ */
+bool neighbor_admit_packet(neighbor_t *const neighbor,
+                           iota_gossip_conf_t const *const conf);
+
+/**
+ * Tells whether a request of a neighbor may be answered, according to its
+ * state and requests rate limit. Dropped requests are counted in
+ * nbr_dropped_req.
+ *
+ * @param neighbor The neighbor
+ * @param conf Gossip configuration
+ *
+ * @return true if the request is admitted, false if it must be dropped
+ */
+bool neighbor_admit_request(neighbor_t *const neighbor,
+                            iota_gossip_conf_t const *const conf);
+
+/**
+ * Gets the traffic control status of a neighbor
+ *
+ * @param neighbor The neighbor
+ * @param conf Gossip configuration
+ * @param status The status
+ */
+void neighbor_traffic_status(neighbor_t *const neighbor,
+                             iota_gossip_conf_t const *const conf,
+                             neighbor_traffic_status_t *const status);
+
 /**
  * Sends a packet to a neighbor
  *
@@ -72,6 +159,23 @@ retcode_t neighbor_init_with_values(neighbor_t *const neighbor,
 retcode_t neighbor_send_packet(node_t *const node, neighbor_t *const neighbor,
                                iota_packet_t const *const packet);
 
+/**
+ * Sends transaction bytes to a neighbor, along with a request of this node.
+ * Only the request is encoded, the transaction bytes are sent as they are.
+ * Like all sends, it is skipped and counted in nbr_dropped_sent_tx if the
+ * neighbor is disconnected or its bytes rate limit is exceeded.
+ *
+ * @param node A node
+ * @param tangle A tangle
+ * @param neighbor The neighbor
+ * @param transaction The transaction bytes
+ *
+ * @return a status code
+ */
+retcode_t neighbor_send_bytes(node_t *const node, tangle_t *const tangle,
+                              neighbor_t *const neighbor,
+                              byte_t const *const transaction);
+
 /**
  * Sends transaction flex trits to a neighbor
  *
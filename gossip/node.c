@@ -199,6 +199,13 @@ retcode_t node_init(node_t* const node, core_t* const core,
     return ret;
   }
 
+  log_info(logger_id, "Initializing packet cache\n");
+  if ((ret = packet_cache_init(&node->packet_cache,
+                               node->conf.packet_cache_size)) != RC_OK) {
+    log_error(logger_id, "Initializing packet cache failed\n");
+    return ret;
+  }
+
   log_info(logger_id, "Initializing tips cache\n");
   if ((ret = node_tips_cache_init(node, tangle)) != RC_OK) {
     log_error(logger_id, "Initializing tips cache failed\n");
@@ -210,19 +217,23 @@ retcode_t node_init(node_t* const node, core_t* const core,
 
 retcode_t node_start(node_t* const node) {
   retcode_t ret = RC_OK;
+  executor_t* executor = NULL;
 
   if (node == NULL) {
     return RC_NODE_NULL_NODE;
   }
 
+  // Components but the receiver run as tasks of the core executor
+  executor = &node->core->executor;
+
   log_info(logger_id, "Starting broadcaster component\n");
-  if (broadcaster_start(&node->broadcaster) != RC_OK) {
+  if (broadcaster_start(&node->broadcaster, executor) != RC_OK) {
     log_critical(logger_id, "Starting broadcaster component failed\n");
     return RC_NODE_FAILED_BROADCASTER_START;
   }
 
   log_info(logger_id, "Starting processor component\n");
-  if (processor_start(&node->processor) != RC_OK) {
+  if (processor_start(&node->processor, executor) != RC_OK) {
     log_critical(logger_id, "Starting processor component failed\n");
     return RC_NODE_FAILED_PROCESSOR_START;
   }
@@ -234,26 +245,28 @@ retcode_t node_start(node_t* const node) {
   }
 
   log_info(logger_id, "Starting responder component\n");
-  if (responder_start(&node->responder) != RC_OK) {
+  if (responder_start(&node->responder, executor) != RC_OK) {
     log_critical(logger_id, "Starting responder component failed\n");
     return RC_NODE_FAILED_RESPONDER_START;
   }
 
   log_info(logger_id, "Starting tips requester component\n");
-  if ((ret = tips_requester_start(&node->tips_requester)) != RC_OK) {
+  if ((ret = tips_requester_start(&node->tips_requester, executor)) != RC_OK) {
     log_critical(logger_id, "Starting tips requester component failed\n");
     return ret;
   }
 
   log_info(logger_id, "Starting transaction requester component\n");
-  if ((ret = requester_start(&node->transaction_requester)) != RC_OK) {
+  if ((ret = requester_start(&node->transaction_requester, executor)) !=
+      RC_OK) {
     log_critical(logger_id,
                  "Starting transaction requester component failed\n");
     return ret;
   }
 
   log_info(logger_id, "Starting tips solidifier component\n");
-  if ((ret = tips_solidifier_start(&node->tips_solidifier)) != RC_OK) {
+  if ((ret = tips_solidifier_start(&node->tips_solidifier, executor)) !=
+      RC_OK) {
     log_critical(logger_id, "Starting tips solidifier component failed\n");
     return ret;
   }
@@ -372,6 +385,7 @@ retcode_t node_destroy(node_t* const node) {
   rw_lock_handle_destroy(&node->neighbors_lock);
 
   tips_cache_destroy(&node->tips);
+  packet_cache_destroy(&node->packet_cache);
   free(node->conf.neighbors);
 
   logger_helper_release(logger_id);
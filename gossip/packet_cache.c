@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gossip/packet_cache.h"
+
+/*
+ * Public functions
+ */
+
+retcode_t packet_cache_init(packet_cache_t *const cache,
+                            size_t const capacity) {
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(cache, 0, sizeof(packet_cache_t));
+  lock_handle_init(&cache->lock);
+  cache->capacity = capacity;
+
+  return RC_OK;
+}
+
+retcode_t packet_cache_destroy(packet_cache_t *const cache) {
+  packet_cache_entry_t *entry = NULL, *tmp = NULL;
+
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  HASH_ITER(hh, cache->entries, entry, tmp) {
+    HASH_DEL(cache->entries, entry);
+    free(entry);
+  }
+  cache->size = 0;
+  lock_handle_destroy(&cache->lock);
+
+  return RC_OK;
+}
+
+bool packet_cache_get(packet_cache_t *const cache,
+                      flex_trit_t const *const hash,
+                      byte_t *const transaction) {
+  packet_cache_entry_t *entry = NULL;
+
+  if (cache == NULL || hash == NULL || transaction == NULL) {
+    return false;
+  }
+
+  lock_handle_lock(&cache->lock);
+  HASH_FIND(hh, cache->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry) {
+    memcpy(transaction, entry->transaction, PACKET_TX_SIZE);
+    // Most recently used entries are at the back of the table
+    HASH_DELETE(hh, cache->entries, entry);
+    HASH_ADD(hh, cache->entries, hash, FLEX_TRIT_SIZE_243, entry);
+    cache->hits++;
+  } else {
+    cache->misses++;
+  }
+  lock_handle_unlock(&cache->lock);
+
+  return entry != NULL;
+}
+
+retcode_t packet_cache_put(packet_cache_t *const cache,
+                           flex_trit_t const *const hash,
+                           byte_t const *const transaction) {
+  retcode_t ret = RC_OK;
+  packet_cache_entry_t *entry = NULL;
+
+  if (cache == NULL || hash == NULL || transaction == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if (cache->capacity == 0) {
+    return RC_OK;
+  }
+
+  lock_handle_lock(&cache->lock);
+
+  HASH_FIND(hh, cache->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry) {
+    // A transaction is immutable, only its recency changes
+    HASH_DELETE(hh, cache->entries, entry);
+  } else {
+    if (cache->size >= cache->capacity) {
+      // Recycles the least recently used entry
+      entry = cache->entries;
+      HASH_DELETE(hh, cache->entries, entry);
+      cache->evictions++;
+    } else if ((entry = (packet_cache_entry_t *)malloc(
+                    sizeof(packet_cache_entry_t))) == NULL) {
+      ret = RC_OOM;
+      goto done;
+    } else {
+      cache->size++;
+    }
+    memcpy(entry->hash, hash, FLEX_TRIT_SIZE_243);
+    memcpy(entry->transaction, transaction, PACKET_TX_SIZE);
+  }
+  HASH_ADD(hh, cache->entries, hash, FLEX_TRIT_SIZE_243, entry);
+
+done:
+  lock_handle_unlock(&cache->lock);
+
+  return ret;
+}
+
+size_t packet_cache_size(packet_cache_t *const cache) {
+  size_t size = 0;
+
+  if (cache == NULL) {
+    return 0;
+  }
+
+  lock_handle_lock(&cache->lock);
+  size = cache->size;
+  lock_handle_unlock(&cache->lock);
+
+  return size;
+}
+
+void packet_cache_stats(packet_cache_t *const cache,
+                        packet_cache_stats_t *const stats) {
+  if (cache == NULL || stats == NULL) {
+    return;
+  }
+
+  lock_handle_lock(&cache->lock);
+  stats->size = cache->size;
+  stats->hits = cache->hits;
+  stats->misses = cache->misses;
+  stats->evictions = cache->evictions;
+  lock_handle_unlock(&cache->lock);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __GOSSIP_PACKET_CACHE_H__
+#define __GOSSIP_PACKET_CACHE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "uthash.h"
+
+#include "common/errors.h"
+#include "common/trinary/bytes.h"
+#include "common/trinary/flex_trit.h"
+#include "gossip/conf.h"
+#include "utils/handles/lock.h"
+
+typedef struct packet_cache_entry_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  byte_t transaction[PACKET_TX_SIZE];
+  UT_hash_handle hh;
+} packet_cache_entry_t;
+
+/**
+ * A fixed capacity LRU cache of transactions in their wire encoding, keyed by
+ * hash, so that answering a request for a recent transaction doesn't go
+ * through the database. Entries are kept in insertion order by uthash, a hit
+ * moves the entry to the back so that the front of the table is always the
+ * least recently used one.
+ */
+typedef struct packet_cache_s {
+  packet_cache_entry_t *entries;
+  lock_handle_t lock;
+  size_t size;
+  size_t capacity;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+} packet_cache_t;
+
+typedef struct packet_cache_stats_s {
+  size_t size;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+} packet_cache_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a packet cache
+ *
+ * @param cache The cache
+ * @param capacity The cache capacity, 0 disables the cache
+ *
+ * @return a status code
+ */
+retcode_t packet_cache_init(packet_cache_t *const cache, size_t const capacity);
+
+/**
+ * Destroys a packet cache
+ *
+ * @param cache The cache
+ *
+ * @return a status code
+ */
+retcode_t packet_cache_destroy(packet_cache_t *const cache);
+
+/**
+ * Copies the wire encoding of a cached transaction
+ *
+ * @param cache The cache
+ * @param hash The transaction hash
+ * @param transaction A buffer of PACKET_TX_SIZE bytes to be filled
+ *
+ * @return whether the transaction was found
+ */
+bool packet_cache_get(packet_cache_t *const cache,
+                      flex_trit_t const *const hash,
+                      byte_t *const transaction);
+
+/**
+ * Adds the wire encoding of a transaction to a packet cache, evicting the least
+ * recently used entry if the cache is full
+ *
+ * @param cache The cache
+ * @param hash The transaction hash
+ * @param transaction The PACKET_TX_SIZE transaction bytes
+ *
+ * @return a status code
+ */
+retcode_t packet_cache_put(packet_cache_t *const cache,
+                           flex_trit_t const *const hash,
+                           byte_t const *const transaction);
+
+/**
+ * Gets the number of transactions in a packet cache
+ *
+ * @param cache The cache
+ *
+ * @return the number of transactions
+ */
+size_t packet_cache_size(packet_cache_t *const cache);
+
+/**
+ * Gets the statistics of a packet cache
+ *
+ * @param cache The cache
+ * @param stats The statistics
+ */
+void packet_cache_stats(packet_cache_t *const cache,
+                        packet_cache_stats_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __GOSSIP_PACKET_CACHE_H__
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include "utlist.h"
+
+#include "gossip/priority_queue.h"
+#include "utils/time.h"
+
+static char const *const priority_names[GOSSIP_PRIORITY_COUNT] = {
+    "milestone", "high", "normal"};
+
+/*
+ * Private functions
+ */
+
+static inline bool lane_full(priority_queue_t const *const queue,
+                             gossip_priority_t const priority) {
+  size_t lane_capacity = queue->capacity / PRIORITY_QUEUE_URGENT_LANE_SHARE;
+
+  if (queue->capacity == 0 || priority == GOSSIP_PRIORITY_COUNT - 1) {
+    return false;
+  }
+  return queue->stats[priority].size >= (lane_capacity ? lane_capacity : 1);
+}
+
+static void lane_remove(priority_queue_t *const queue,
+                        priority_queue_entry_t *const entry) {
+  DL_DELETE(queue->lanes[entry->priority], entry);
+  entry->prev = entry->next = NULL;
+  queue->stats[entry->priority].size--;
+  queue->size--;
+}
+
+/*
+ * Public functions
+ */
+
+void priority_queue_init(priority_queue_t *const queue, size_t const capacity) {
+  memset(queue, 0, sizeof(priority_queue_t));
+  queue->capacity = capacity;
+}
+
+priority_queue_entry_t *priority_queue_push(priority_queue_t *const queue,
+                                            priority_queue_entry_t *const entry,
+                                            gossip_priority_t const priority) {
+  priority_queue_entry_t *evicted = NULL;
+  int lane = 0;
+
+  queue->stats[priority].pushed++;
+
+  if (lane_full(queue, priority)) {
+    queue->stats[priority].dropped++;
+    return entry;
+  }
+
+  if (queue->capacity && queue->size >= queue->capacity) {
+    // The newest entry of the least urgent lane is the least worth keeping
+    for (lane = GOSSIP_PRIORITY_COUNT - 1; lane > (int)priority; lane--) {
+      if (queue->lanes[lane] != NULL) {
+        evicted = queue->lanes[lane]->prev;
+        break;
+      }
+    }
+    if (evicted == NULL) {
+      queue->stats[priority].dropped++;
+      return entry;
+    }
+    queue->stats[evicted->priority].dropped++;
+    lane_remove(queue, evicted);
+  }
+
+  entry->priority = priority;
+  entry->enqueued_us = current_timestamp_us();
+  DL_APPEND(queue->lanes[priority], entry);
+  queue->stats[priority].size++;
+  queue->size++;
+
+  return evicted;
+}
+
+priority_queue_entry_t *priority_queue_peek(
+    priority_queue_t const *const queue) {
+  for (size_t lane = 0; lane < GOSSIP_PRIORITY_COUNT; lane++) {
+    if (queue->lanes[lane] != NULL) {
+      return queue->lanes[lane];
+    }
+  }
+  return NULL;
+}
+
+priority_queue_entry_t *priority_queue_pop(priority_queue_t *const queue) {
+  priority_queue_entry_t *entry = NULL;
+  priority_queue_stats_t *stats = NULL;
+  uint64_t latency = 0;
+
+  if ((entry = priority_queue_peek(queue)) == NULL) {
+    return NULL;
+  }
+
+  stats = &queue->stats[entry->priority];
+  latency = current_timestamp_us() - entry->enqueued_us;
+  stats->popped++;
+  stats->total_latency_us += latency;
+  if (latency > stats->max_latency_us) {
+    stats->max_latency_us = latency;
+  }
+  lane_remove(queue, entry);
+
+  return entry;
+}
+
+void priority_queue_stats(priority_queue_t const *const queue,
+                          priority_queue_stats_t *const stats) {
+  memcpy(stats, queue->stats,
+         GOSSIP_PRIORITY_COUNT * sizeof(priority_queue_stats_t));
+}
+
+char const *gossip_priority_name(gossip_priority_t const priority) {
+  if (priority >= GOSSIP_PRIORITY_COUNT) {
+    return "unknown";
+  }
+  return priority_names[priority];
+}
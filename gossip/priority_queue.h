@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __GOSSIP_PRIORITY_QUEUE_H__
+#define __GOSSIP_PRIORITY_QUEUE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Share of a bounded queue each lane but the least urgent one may take, so
+// that a flood of urgent entries never pushes out all the regular ones
+#define PRIORITY_QUEUE_URGENT_LANE_SHARE 4
+
+/**
+ * Priorities of the gossip traffic, from the most to the least urgent
+ */
+typedef enum gossip_priority_e {
+  // Transactions issued by the coordinator, they drive confirmation
+  GOSSIP_PRIORITY_MILESTONE,
+  // Locally attached transactions and requests of specific transactions
+  GOSSIP_PRIORITY_HIGH,
+  // Everything else, notably the bulk of what neighbors send
+  GOSSIP_PRIORITY_NORMAL,
+  GOSSIP_PRIORITY_COUNT
+} gossip_priority_t;
+
+/**
+ * Link of an element in a priority queue, to be embedded as the first member
+ * of the element so that no allocation happens in the queue itself
+ */
+typedef struct priority_queue_entry_s {
+  struct priority_queue_entry_s *prev;
+  struct priority_queue_entry_s *next;
+  uint64_t enqueued_us;
+  gossip_priority_t priority;
+} priority_queue_entry_t;
+
+typedef struct priority_queue_stats_s {
+  size_t size;
+  uint64_t pushed;
+  // Entries evicted by a more urgent one or refused because the queue was full
+  uint64_t dropped;
+  uint64_t popped;
+  // Time spent in the queue by popped entries
+  uint64_t total_latency_us;
+  uint64_t max_latency_us;
+} priority_queue_stats_t;
+
+/**
+ * A bounded queue with one FIFO lane per priority, entries are popped from the
+ * most urgent non-empty lane. When full, a push evicts the newest entry of the
+ * least urgent lane below its own priority or is refused if there is none, so
+ * that a flood of normal traffic never delays nor pushes out milestones. Urgent
+ * lanes are bounded to 1 / PRIORITY_QUEUE_URGENT_LANE_SHARE of the capacity
+ * each, pushes beyond are refused.
+ * Not concurrent.
+ */
+typedef struct priority_queue_s {
+  priority_queue_entry_t *lanes[GOSSIP_PRIORITY_COUNT];
+  size_t size;
+  // Maximum number of entries, 0 for an unbounded queue
+  size_t capacity;
+  priority_queue_stats_t stats[GOSSIP_PRIORITY_COUNT];
+} priority_queue_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes an empty priority queue
+ *
+ * @param queue The queue
+ * @param capacity The maximum number of entries, 0 for an unbounded queue
+ */
+void priority_queue_init(priority_queue_t *const queue, size_t const capacity);
+
+/**
+ * Pushes an entry to a priority queue
+ *
+ * @param queue The queue
+ * @param entry The entry
+ * @param priority The priority of the entry
+ *
+ * @return the entry left out of the queue to be released by the caller, either
+ * an evicted one or the pushed one if refused, NULL if none
+ */
+priority_queue_entry_t *priority_queue_push(priority_queue_t *const queue,
+                                            priority_queue_entry_t *const entry,
+                                            gossip_priority_t const priority);
+
+/**
+ * Peeks the most urgent entry of a priority queue
+ *
+ * @param queue The queue
+ *
+ * @return the entry, NULL if the queue is empty
+ */
+priority_queue_entry_t *priority_queue_peek(priority_queue_t const *const queue);
+
+/**
+ * Pops the most urgent entry of a priority queue
+ *
+ * @param queue The queue
+ *
+ * @return the entry to be released by the caller, NULL if the queue is empty
+ */
+priority_queue_entry_t *priority_queue_pop(priority_queue_t *const queue);
+
+/**
+ * Gets the statistics of a priority queue, one per priority
+ *
+ * @param queue The queue
+ * @param stats An array of GOSSIP_PRIORITY_COUNT statistics to be filled
+ */
+void priority_queue_stats(priority_queue_t const *const queue,
+                          priority_queue_stats_t *const stats);
+
+/**
+ * Gets the name of a priority, for logging purposes
+ *
+ * @param priority The priority
+ *
+ * @return the name
+ */
+char const *gossip_priority_name(gossip_priority_t const priority);
+
+static inline size_t priority_queue_size(priority_queue_t const *const queue) {
+  return queue->size;
+}
+
+static inline bool priority_queue_empty(priority_queue_t const *const queue) {
+  return queue->size == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __GOSSIP_PRIORITY_QUEUE_H__
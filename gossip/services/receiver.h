@@ -17,6 +17,11 @@
 
 #define PORT_SIZE 10
 #define CRC_SIZE 16
+// Sent back by a receiver able to read compressed packets, on the connection
+// of its neighbor right after its listening port. Older nodes never read from
+// the connections they send on and keep sending fixed-size packets
+#define COMPRESSION_OFFER "compressed"
+#define COMPRESSION_OFFER_SIZE 10
 
 // Forward declarations
 typedef struct receiver_state_s receiver_state_t;
@@ -10,7 +10,9 @@
 
 #include "gossip/node.h"
 #include "gossip/services/tcp_receiver.hpp"
+#include "gossip/services/tcp_sender.hpp"
 #include "utils/logger_helper.h"
+#include "utils/time.h"
 
 #define TCP_RECEIVER_SERVICE_LOGGER_ID "tcp_receiver_service"
 
@@ -81,18 +83,51 @@ void TcpConnection::start(uint16_t const port) {
   boost::asio::write(*neighbor_socket,
                      boost::asio::buffer(encoded_port, PORT_SIZE), error);
 
-  neighbor->endpoint.opaque_inetaddr = neighbor_socket;
+  // A reconnecting neighbor replaces its previous connection
+  tcp_sender_endpoint_destroy(&neighbor->endpoint);
+  neighbor->endpoint.opaque_inetaddr =
+      new tcp_peer_t{neighbor_socket, TCP_COMPRESSION_PENDING,
+                     current_timestamp_ms() + TCP_COMPRESSION_OFFER_TIMEOUT_MS};
 
   rw_lock_handle_unlock(&service_->state->node->neighbors_lock);
 
+  // Offering to receive compressed packets
+
+  if (service_->state->node->conf.packet_compression) {
+    boost::asio::write(
+        socket_, boost::asio::buffer(COMPRESSION_OFFER, COMPRESSION_OFFER_SIZE),
+        error);
+  }
+
   iota_packet_t packet;
   boost::crc_32_type result;
   char crc[CRC_SIZE + 1];
+  std::array<byte_t, PACKET_COMPRESSED_MAX_SIZE + CRC_SIZE> tcp_packet;
+  size_t size = 0;
 
   for (;;) {
-    std::array<char, PACKET_SIZE + CRC_SIZE> tcp_packet;
-
-    boost::asio::read(socket_, boost::asio::buffer(tcp_packet), error);
+    // Both formats are told apart from their first bytes, a neighbor may send
+    // fixed-size packets until it notices the offer
+
+    boost::asio::read(
+        socket_,
+        boost::asio::buffer(&tcp_packet[0], PACKET_COMPRESSED_HEADER_SIZE),
+        error);
+    if (!error) {
+      if (tcp_packet[0] != PACKET_COMPRESSED_MARKER) {
+        size = PACKET_SIZE;
+      } else if (iota_packet_compressed_size(&tcp_packet[0], &size) != RC_OK) {
+        log_warning(logger_id,
+                    "Received invalid packet from tethered node tcp://%s:%d\n",
+                    remote_host_.c_str(), remote_port_);
+        break;
+      }
+      boost::asio::read(
+          socket_,
+          boost::asio::buffer(&tcp_packet[PACKET_COMPRESSED_HEADER_SIZE],
+                              size + CRC_SIZE - PACKET_COMPRESSED_HEADER_SIZE),
+          error);
+    }
 
     if (error) {
       log_warning(logger_id,
@@ -101,16 +136,22 @@ void TcpConnection::start(uint16_t const port) {
       break;
     }
 
+    if (tcp_packet[0] != PACKET_COMPRESSED_MARKER) {
+      memcpy(packet.content, &tcp_packet[0], PACKET_SIZE);
+    } else if (iota_packet_decompress(&packet, &tcp_packet[0], size) !=
+               RC_OK) {
+      continue;
+    }
+
     // Computing CRC
 
-    result.process_bytes(&tcp_packet[0], PACKET_SIZE);
+    result.process_bytes(packet.content, PACKET_SIZE);
     snprintf(crc, CRC_SIZE + 1, "%0*x", CRC_SIZE, result.checksum());
     result.reset();
 
     // Checking CRC
 
-    if (memcmp(crc, &tcp_packet[0] + PACKET_SIZE, CRC_SIZE) == 0) {
-      memcpy(packet.content, &tcp_packet[0], PACKET_SIZE);
+    if (memcmp(crc, &tcp_packet[size], CRC_SIZE) == 0) {
       iota_packet_set_endpoint(
           &packet, socket_.remote_endpoint().address().to_string().c_str(),
           remote_port_, PROTOCOL_TCP);
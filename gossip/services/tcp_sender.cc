@@ -5,6 +5,7 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <array>
 #include <iomanip>
 
 #include <boost/asio.hpp>
@@ -13,6 +14,7 @@
 #include "gossip/iota_packet.h"
 #include "gossip/services/receiver.h"
 #include "gossip/services/tcp_sender.hpp"
+#include "utils/time.h"
 
 retcode_t tcp_sender_endpoint_init(endpoint_t *const endpoint) {
   if (endpoint == NULL) {
@@ -34,11 +36,73 @@ retcode_t tcp_sender_endpoint_init(endpoint_t *const endpoint) {
 }
 
 retcode_t tcp_sender_endpoint_destroy(endpoint_t *const endpoint) {
+  if (endpoint == NULL) {
+    return RC_NULL_PARAM;
+  } else if (endpoint->opaque_inetaddr == NULL) {
+    return RC_OK;
+  }
+
+  auto peer = reinterpret_cast<tcp_peer_t *>(endpoint->opaque_inetaddr);
+  auto socket = reinterpret_cast<boost::asio::ip::tcp::socket *>(peer->socket);
+  boost::system::error_code ignored_error;
+
+  socket->close(ignored_error);
+  delete socket;
+  delete peer;
+  endpoint->opaque_inetaddr = NULL;
+
   return RC_OK;
 }
 
+/**
+ * Looks for the offer of a neighbor to receive compressed packets, without
+ * blocking. The offer is only peeked at since nothing else is ever read from
+ * the connection. Anything but the offer settles the negotiation.
+ */
+static tcp_compression_t tcp_compression_offer(
+    boost::asio::ip::tcp::socket *const socket) {
+  std::array<char, COMPRESSION_OFFER_SIZE> offer;
+  boost::system::error_code error;
+
+  if (socket->available(error) < COMPRESSION_OFFER_SIZE && !error) {
+    return TCP_COMPRESSION_PENDING;
+  } else if (error) {
+    return TCP_COMPRESSION_OFF;
+  }
+  socket->receive(boost::asio::buffer(offer),
+                  boost::asio::socket_base::message_peek, error);
+  if (error ||
+      memcmp(&offer[0], COMPRESSION_OFFER, COMPRESSION_OFFER_SIZE) != 0) {
+    return TCP_COMPRESSION_OFF;
+  }
+  return TCP_COMPRESSION_ON;
+}
+
+/**
+ * Settles the compression negotiation of a peer the first time its offer is
+ * found or its deadline passed, the connection is not polled afterwards
+ */
+static bool tcp_compressed(tcp_peer_t *const peer,
+                           boost::asio::ip::tcp::socket *const socket) {
+  tcp_compression_t compression =
+      __atomic_load_n(&peer->compression, __ATOMIC_ACQUIRE);
+
+  if (compression == TCP_COMPRESSION_PENDING) {
+    compression = tcp_compression_offer(socket);
+    if (compression == TCP_COMPRESSION_PENDING &&
+        current_timestamp_ms() >= peer->offer_deadline_ms) {
+      compression = TCP_COMPRESSION_OFF;
+    }
+    if (compression != TCP_COMPRESSION_PENDING) {
+      __atomic_store_n(&peer->compression, compression, __ATOMIC_RELEASE);
+    }
+  }
+
+  return compression == TCP_COMPRESSION_ON;
+}
+
 bool tcp_send(receiver_service_t *const service, endpoint_t *const endpoint,
-              iota_packet_t const *const packet) {
+              byte_t const *const transaction, byte_t const *const request) {
   if (endpoint == NULL) {
     return false;
   } else if (endpoint->opaque_inetaddr == NULL) {
@@ -47,17 +111,31 @@ bool tcp_send(receiver_service_t *const service, endpoint_t *const endpoint,
 
   try {
     char crc[CRC_SIZE + 1];
-    auto socket = reinterpret_cast<boost::asio::ip::tcp::socket *>(
-        endpoint->opaque_inetaddr);
+    auto peer = reinterpret_cast<tcp_peer_t *>(endpoint->opaque_inetaddr);
+    auto socket =
+        reinterpret_cast<boost::asio::ip::tcp::socket *>(peer->socket);
     boost::system::error_code ignored_error;
     boost::crc_32_type result;
 
-    result.process_bytes(packet->content, PACKET_SIZE);
+    // The CRC covers the packet as it is once decompressed
+    result.process_bytes(transaction, PACKET_TX_SIZE);
+    result.process_bytes(request, REQUEST_HASH_SIZE);
     snprintf(crc, CRC_SIZE + 1, "%0*x", CRC_SIZE, result.checksum());
-    boost::asio::write(*socket, boost::asio::buffer(packet->content),
-                       ignored_error);
-    boost::asio::write(*socket, boost::asio::buffer(crc, CRC_SIZE),
-                       ignored_error);
+
+    if (tcp_compressed(peer, socket)) {
+      byte_t compressed[PACKET_COMPRESSED_MAX_SIZE];
+      size_t size = iota_packet_compress(transaction, request, compressed);
+      std::array<boost::asio::const_buffer, 2> buffers = {
+          boost::asio::buffer(compressed, size),
+          boost::asio::buffer(crc, CRC_SIZE)};
+      boost::asio::write(*socket, buffers, ignored_error);
+    } else {
+      std::array<boost::asio::const_buffer, 3> buffers = {
+          boost::asio::buffer(transaction, PACKET_TX_SIZE),
+          boost::asio::buffer(request, REQUEST_HASH_SIZE),
+          boost::asio::buffer(crc, CRC_SIZE)};
+      boost::asio::write(*socket, buffers, ignored_error);
+    }
   } catch (...) {
     return false;
   }
@@ -7,28 +7,67 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/trinary/bytes.h"
+
+// Time a neighbor has to offer to receive compressed packets once connected,
+// fixed-size packets are sent for the rest of the connection past it
+#define TCP_COMPRESSION_OFFER_TIMEOUT_MS 10000
+
 // Forward declarations
-typedef struct iota_packet_s iota_packet_t;
 typedef struct endpoint_s endpoint_t;
 typedef struct receiver_service_s receiver_service_t;
 
+typedef enum tcp_compression_e {
+  TCP_COMPRESSION_PENDING,
+  TCP_COMPRESSION_ON,
+  TCP_COMPRESSION_OFF,
+} tcp_compression_t;
+
+/**
+ * The sending side of a TCP connection with a neighbor, kept as the opaque
+ * address of its endpoint
+ */
+typedef struct tcp_peer_s {
+  void *socket;
+  // Outcome of the compression negotiation, settled once per connection.
+  // Accessed atomically since the broadcaster and the responder send from
+  // different executor workers
+  tcp_compression_t compression;
+  uint64_t offer_deadline_ms;
+} tcp_peer_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 retcode_t tcp_sender_endpoint_init(endpoint_t *const endpoint);
+
+/**
+ * Closes and releases the connection of an endpoint, if any. Called with the
+ * neighbors lock held for writing
+ *
+ * @param endpoint The endpoint
+ *
+ * @return a status code
+ */
 retcode_t tcp_sender_endpoint_destroy(endpoint_t *const endpoint);
 
 /**
- * Sends a TCP packet to an endpoint
+ * Sends a TCP packet to an endpoint, gathered from its two parts. The packet
+ * is compressed if the neighbor offered to receive compressed packets. Called
+ * with the neighbors lock held for reading
  *
  * @param endpoint The endpoint
- * @param packet The packet
+ * @param transaction The transaction bytes of the packet
+ * @param request The request bytes of the packet
  *
  * @return true if sending succeeded, false otherwise
  */
 bool tcp_send(receiver_service_t *const service, endpoint_t *const endpoint,
-              iota_packet_t const *const packet);
+              byte_t const *const transaction, byte_t const *const request);
 
 #ifdef __cplusplus
 }
@@ -5,6 +5,8 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <array>
+
 #include <boost/asio.hpp>
 
 #include "gossip/iota_packet.h"
@@ -43,7 +45,7 @@ bool udp_endpoint_destroy(endpoint_t *const endpoint) {
 }
 
 bool udp_send(receiver_service_t *const service, endpoint_t *const endpoint,
-              iota_packet_t const *const packet) {
+              byte_t const *const transaction, byte_t const *const request) {
   if (service == NULL || service->opaque_socket == NULL || endpoint == NULL ||
       endpoint->opaque_inetaddr == NULL) {
     return false;
@@ -52,11 +54,16 @@ bool udp_send(receiver_service_t *const service, endpoint_t *const endpoint,
   try {
     auto socket = reinterpret_cast<boost::asio::ip::udp::socket *>(
         service->opaque_socket);
-    socket->async_send_to(
-        boost::asio::buffer(packet->content, PACKET_SIZE),
-        *reinterpret_cast<boost::asio::ip::udp::endpoint *>(
-            endpoint->opaque_inetaddr),
-        [](const boost::system::error_code &, std::size_t) {});
+    std::array<boost::asio::const_buffer, 2> buffers = {
+        boost::asio::buffer(transaction, PACKET_TX_SIZE),
+        boost::asio::buffer(request, REQUEST_HASH_SIZE)};
+    boost::system::error_code ignored_error;
+    // Sent synchronously since the caller owns the buffers, a datagram send
+    // doesn't block on the peer anyway
+    socket->send_to(buffers,
+                    *reinterpret_cast<boost::asio::ip::udp::endpoint *>(
+                        endpoint->opaque_inetaddr),
+                    0, ignored_error);
   } catch (std::exception const &e) {
     return false;
   }
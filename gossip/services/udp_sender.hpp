@@ -7,8 +7,9 @@
 
 #pragma once
 
+#include "common/trinary/bytes.h"
+
 // Forward declarations
-typedef struct iota_packet_s iota_packet_t;
 typedef struct endpoint_s endpoint_t;
 typedef struct receiver_service_s receiver_service_t;
 
@@ -35,16 +36,17 @@ bool udp_endpoint_init(endpoint_t *const endpoint);
 bool udp_endpoint_destroy(endpoint_t *const endpoint);
 
 /**
- * Sends a UDP packet to an endpoint
+ * Sends a UDP packet to an endpoint, gathered from its two parts
  *
  * @param service An UDP service
  * @param endpoint The endpoint
- * @param packet The packet
+ * @param transaction The transaction bytes of the packet
+ * @param request The request bytes of the packet
  *
  * @return true if sending succeeded, false otherwise
  */
 bool udp_send(receiver_service_t *const service, endpoint_t *const endpoint,
-              iota_packet_t const *const packet);
+              byte_t const *const transaction, byte_t const *const request);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/model/transaction.h"
+#include "common/trinary/trit_byte.h"
+#include "common/trinary/trit_tryte.h"
+#include "gossip/iota_packet.h"
+
+#define NUM_PACKETS 100000
+#define NUM_RUNS 10
+
+// Shares of the synthetic replay, in percents, close to what mainnet gossips:
+// mostly zero-value transactions with an empty fragment, some carrying a
+// message and a few spending inputs, milestones included
+#define SHARE_EMPTY 65
+#define SHARE_MESSAGE 25
+// Longest message of the synthetic replay, in trytes
+#define MAX_MESSAGE_TRYTES 500
+
+static byte_t (*packets)[PACKET_SIZE];
+static byte_t compressed[PACKET_COMPRESSED_MAX_SIZE];
+static size_t num_packets = 0;
+
+static double elapsed_ms(struct timespec const *const start,
+                         struct timespec const *const end) {
+  return (end->tv_sec - start->tv_sec) * 1e3 +
+         (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static void synthetic_packet(byte_t *const packet) {
+  trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION];
+  size_t fragment_trits = 0;
+  int share = rand() % 100;
+
+  if (share < SHARE_EMPTY) {
+    fragment_trits = 0;
+  } else if (share < SHARE_EMPTY + SHARE_MESSAGE) {
+    fragment_trits =
+        (rand() % MAX_MESSAGE_TRYTES + 1) * NUMBER_OF_TRITS_IN_A_TRYTE;
+  } else {
+    fragment_trits = NUM_TRITS_SIGNATURE;
+  }
+
+  for (size_t i = 0; i < NUM_TRITS_SERIALIZED_TRANSACTION; i++) {
+    trits[i] = (i < fragment_trits || i >= NUM_TRITS_SIGNATURE)
+                   ? (trit_t)(rand() % 3 - 1)
+                   : 0;
+  }
+  trits_to_bytes(trits, packet, NUM_TRITS_SERIALIZED_TRANSACTION);
+  for (size_t i = PACKET_TX_SIZE; i < PACKET_SIZE; i++) {
+    packet[i] = (byte_t)(rand() % 243 - 121);
+  }
+}
+
+/**
+ * Loads transactions from a file of one transaction trytes per line, as
+ * exported from a node
+ */
+static size_t replay_packets(char const *const path) {
+  FILE *file = NULL;
+  char line[NUM_TRYTES_SERIALIZED_TRANSACTION + 2];
+  trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION];
+  size_t count = 0;
+
+  if ((file = fopen(path, "r")) == NULL) {
+    return 0;
+  }
+  while (count < NUM_PACKETS && fgets(line, sizeof(line), file) != NULL) {
+    if (strlen(line) < NUM_TRYTES_SERIALIZED_TRANSACTION) {
+      continue;
+    }
+    trytes_to_trits((tryte_t *)line, trits, NUM_TRYTES_SERIALIZED_TRANSACTION);
+    trits_to_bytes(trits, packets[count], NUM_TRITS_SERIALIZED_TRANSACTION);
+    memset(packets[count] + PACKET_TX_SIZE, 0, REQUEST_HASH_SIZE);
+    count++;
+  }
+  fclose(file);
+
+  return count;
+}
+
+int main(int argc, char **argv) {
+  struct timespec start, end;
+  iota_packet_t packet;
+  size_t size = 0, total = 0;
+  double compress_ms = 0, decompress_ms = 0;
+
+  if ((packets = malloc(NUM_PACKETS * PACKET_SIZE)) == NULL) {
+    return EXIT_FAILURE;
+  }
+
+  if (argc > 1) {
+    num_packets = replay_packets(argv[1]);
+  } else {
+    for (num_packets = 0; num_packets < NUM_PACKETS; num_packets++) {
+      synthetic_packet(packets[num_packets]);
+    }
+  }
+  if (num_packets == 0) {
+    fprintf(stderr, "No transaction to replay\n");
+    free(packets);
+    return EXIT_FAILURE;
+  }
+
+  for (size_t run = 0; run < NUM_RUNS; run++) {
+    total = 0;
+    for (size_t i = 0; i < num_packets; i++) {
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      size = iota_packet_compress(packets[i], packets[i] + PACKET_TX_SIZE,
+                                  compressed);
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      compress_ms += elapsed_ms(&start, &end);
+      total += size;
+
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      iota_packet_decompress(&packet, compressed, size);
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      decompress_ms += elapsed_ms(&start, &end);
+
+      if (memcmp(packet.content, packets[i], PACKET_SIZE) != 0) {
+        fprintf(stderr, "Packets differ\n");
+        free(packets);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  printf("%zu packets, %zu bytes fixed-size, %zu bytes compressed\n",
+         num_packets, num_packets * PACKET_SIZE, total);
+  printf("%.1f%% saved, %.1f bytes per packet on average\n",
+         100.0 * (num_packets * PACKET_SIZE - total) /
+             (num_packets * PACKET_SIZE),
+         (double)total / num_packets);
+  printf("compress   %8.3f us per packet\n",
+         compress_ms * 1e3 / (num_packets * NUM_RUNS));
+  printf("decompress %8.3f us per packet\n",
+         decompress_ms * 1e3 / (num_packets * NUM_RUNS));
+
+  free(packets);
+  return EXIT_SUCCESS;
+}
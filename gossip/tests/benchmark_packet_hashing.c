@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/curl-p/ptrit.h"
+#include "common/model/transaction.h"
+#include "common/trinary/flex_ptrit.h"
+#include "common/trinary/trit_byte.h"
+#include "common/trinary/trit_ptrit.h"
+#include "gossip/conf.h"
+
+// Packets hashed together, as in the processor
+#define NUM_LANES 64
+#define NUM_RUNS 200
+
+static byte_t packets[NUM_LANES][PACKET_TX_SIZE];
+static byte_t const *contents[NUM_LANES];
+static ptrit_t txs_acc[NUM_TRITS_SERIALIZED_TRANSACTION];
+static trit_t tx[NUM_TRITS_SERIALIZED_TRANSACTION];
+static trit_t hash[HASH_LENGTH_TRIT];
+static flex_trit_t flex_hashes[NUM_LANES][FLEX_TRIT_SIZE_243];
+static PCurl curl;
+
+static double elapsed_ms(struct timespec const *const start,
+                         struct timespec const *const end) {
+  return (end->tv_sec - start->tv_sec) * 1e3 +
+         (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Expands every packet into trits before spreading them over the lanes
+static void lanes_through_trits(void) {
+  memset(txs_acc, 0, sizeof(txs_acc));
+  for (size_t j = 0; j < NUM_LANES; j++) {
+    bytes_to_trits(packets[j], PACKET_TX_SIZE, tx,
+                   NUM_TRITS_SERIALIZED_TRANSACTION);
+    trits_to_ptrits(tx, txs_acc, j, NUM_TRITS_SERIALIZED_TRANSACTION);
+  }
+}
+
+static void hashes_through_trits(void) {
+  for (size_t j = 0; j < NUM_LANES; j++) {
+    ptrits_to_trits(txs_acc, hash, j, HASH_LENGTH_TRIT);
+    flex_trits_from_trits(flex_hashes[j], HASH_LENGTH_TRIT, hash,
+                          HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+  }
+}
+
+static void lanes_fused(void) {
+  bytes_to_ptrits(contents, NUM_LANES, txs_acc,
+                  NUM_TRITS_SERIALIZED_TRANSACTION);
+}
+
+static void hashes_fused(void) {
+  for (size_t j = 0; j < NUM_LANES; j++) {
+    flex_trits_from_ptrits(flex_hashes[j], txs_acc, j, HASH_LENGTH_TRIT);
+  }
+}
+
+static void benchmark(char const *const name, void (*from_bytes)(void),
+                      void (*to_hashes)(void)) {
+  struct timespec start, end;
+  double codec_ms = 0, total_ms = 0;
+
+  for (size_t i = 0; i < NUM_RUNS; i++) {
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    from_bytes();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    codec_ms += elapsed_ms(&start, &end);
+    total_ms += elapsed_ms(&start, &end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ptrit_curl_init(&curl, CURL_P_81);
+    ptrit_curl_absorb(&curl, txs_acc, NUM_TRITS_SERIALIZED_TRANSACTION);
+    ptrit_curl_squeeze(&curl, txs_acc, HASH_LENGTH_TRIT);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    total_ms += elapsed_ms(&start, &end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    to_hashes();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    codec_ms += elapsed_ms(&start, &end);
+    total_ms += elapsed_ms(&start, &end);
+  }
+
+  printf("%-7s codec %8.3f us per batch, %10.0f packets hashed per second\n",
+         name, codec_ms * 1e3 / NUM_RUNS,
+         NUM_LANES * NUM_RUNS / (total_ms / 1e3));
+}
+
+int main(void) {
+  trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION];
+  flex_trit_t reference[NUM_LANES][FLEX_TRIT_SIZE_243];
+
+  for (size_t j = 0; j < NUM_LANES; j++) {
+    for (size_t i = 0; i < NUM_TRITS_SERIALIZED_TRANSACTION; i++) {
+      trits[i] = (trit_t)(rand() % 3 - 1);
+    }
+    trits_to_bytes(trits, packets[j], NUM_TRITS_SERIALIZED_TRANSACTION);
+    contents[j] = packets[j];
+  }
+
+  benchmark("trits", lanes_through_trits, hashes_through_trits);
+  memcpy(reference, flex_hashes, sizeof(reference));
+  benchmark("fused", lanes_fused, hashes_fused);
+
+  if (memcmp(reference, flex_hashes, sizeof(reference)) != 0) {
+    fprintf(stderr, "Hashes differ\n");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "gossip/iota_packet.h"
+
+static iota_packet_t packet;
+static iota_packet_t decompressed;
+static byte_t compressed[PACKET_COMPRESSED_MAX_SIZE];
+
+/**
+ * Fills a packet with random bytes, as encoded from trits, leaving the given
+ * number of bytes of its signature or message fragment
+ */
+static void packet_fill(size_t const signature_size) {
+  for (size_t i = 0; i < PACKET_SIZE; i++) {
+    packet.content[i] = (byte_t)(rand() % 243 - 121);
+  }
+  memset(packet.content + signature_size, 0,
+         PACKET_SIGNATURE_SIZE - signature_size);
+  if (signature_size > 0) {
+    packet.content[signature_size - 1] = 1;
+  }
+}
+
+static size_t compress(void) {
+  return iota_packet_compress(packet.content, packet.content + PACKET_TX_SIZE,
+                              compressed);
+}
+
+static void assert_round_trip(size_t const signature_size) {
+  size_t size = 0;
+  size_t header_size = 0;
+
+  packet_fill(signature_size);
+  size = compress();
+  TEST_ASSERT_EQUAL_INT(PACKET_COMPRESSED_HEADER_SIZE + signature_size +
+                            PACKET_SIZE - PACKET_SIGNATURE_SIZE,
+                        size);
+  TEST_ASSERT_EQUAL_INT(PACKET_COMPRESSED_MARKER, compressed[0]);
+  TEST_ASSERT(iota_packet_compressed_size(compressed, &header_size) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(size, header_size);
+
+  memset(decompressed.content, 1, PACKET_SIZE);
+  TEST_ASSERT(iota_packet_decompress(&decompressed, compressed, size) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_MEMORY(packet.content, decompressed.content, PACKET_SIZE);
+}
+
+void test_compress_zero_value(void) { assert_round_trip(0); }
+
+void test_compress_message(void) {
+  // Zeros inside the fragment are kept, only the trailing ones are left out
+  packet_fill(100);
+  packet.content[50] = 0;
+  TEST_ASSERT_EQUAL_INT(PACKET_COMPRESSED_HEADER_SIZE + 100 + PACKET_SIZE -
+                            PACKET_SIGNATURE_SIZE,
+                        compress());
+  TEST_ASSERT(iota_packet_decompress(&decompressed, compressed,
+                                     PACKET_COMPRESSED_HEADER_SIZE + 100 +
+                                         PACKET_SIZE - PACKET_SIGNATURE_SIZE) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_MEMORY(packet.content, decompressed.content, PACKET_SIZE);
+
+  assert_round_trip(255);
+  assert_round_trip(256);
+}
+
+void test_compress_signature(void) {
+  assert_round_trip(PACKET_SIGNATURE_SIZE);
+  TEST_ASSERT_EQUAL_INT(PACKET_COMPRESSED_MAX_SIZE, compress());
+}
+
+void test_decompress_invalid(void) {
+  size_t size = 0;
+
+  packet_fill(10);
+  size = compress();
+
+  TEST_ASSERT(iota_packet_decompress(&decompressed, compressed, size - 1) ==
+              RC_GOSSIP_INVALID_COMPRESSED_PACKET);
+  TEST_ASSERT(iota_packet_decompress(&decompressed, compressed, 2) ==
+              RC_GOSSIP_INVALID_COMPRESSED_PACKET);
+
+  // Longer than a signature or message fragment
+  compressed[1] = (byte_t)((PACKET_SIGNATURE_SIZE + 1) >> 8);
+  compressed[2] = (byte_t)((PACKET_SIGNATURE_SIZE + 1) & 0xFF);
+  TEST_ASSERT(iota_packet_compressed_size(compressed, &size) ==
+              RC_GOSSIP_INVALID_COMPRESSED_PACKET);
+
+  // A fixed-size packet
+  TEST_ASSERT(iota_packet_compressed_size(packet.content, &size) ==
+              RC_GOSSIP_INVALID_COMPRESSED_PACKET);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_compress_zero_value);
+  RUN_TEST(test_compress_message);
+  RUN_TEST(test_compress_signature);
+  RUN_TEST(test_decompress_invalid);
+
+  return UNITY_END();
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "gossip/packet_cache.h"
+
+static flex_trit_t hashes[4][FLEX_TRIT_SIZE_243];
+static byte_t transactions[4][PACKET_TX_SIZE];
+
+void setUp(void) {
+  tryte_t trytes[81] =
+      "A99999999999999999999999999999999999999999999999999999999999999999999999"
+      "999999999";
+
+  for (size_t i = 0; i < 4; i++) {
+    flex_trits_from_trytes(hashes[i], HASH_LENGTH_TRIT, trytes,
+                           HASH_LENGTH_TRYTE, HASH_LENGTH_TRYTE);
+    trytes[0]++;
+    memset(transactions[i], (int)i + 1, PACKET_TX_SIZE);
+  }
+}
+
+void tearDown(void) {}
+
+void test_packet_cache_get_put() {
+  packet_cache_t cache;
+  packet_cache_stats_t stats;
+  byte_t transaction[PACKET_TX_SIZE];
+
+  TEST_ASSERT(packet_cache_init(&cache, 3) == RC_OK);
+
+  TEST_ASSERT_FALSE(packet_cache_get(&cache, hashes[0], transaction));
+  TEST_ASSERT(packet_cache_put(&cache, hashes[0], transactions[0]) == RC_OK);
+  TEST_ASSERT_TRUE(packet_cache_get(&cache, hashes[0], transaction));
+  TEST_ASSERT_EQUAL_MEMORY(transactions[0], transaction, PACKET_TX_SIZE);
+
+  // Putting a cached transaction again doesn't add an entry
+  TEST_ASSERT(packet_cache_put(&cache, hashes[0], transactions[0]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(packet_cache_size(&cache), 1);
+
+  packet_cache_stats(&cache, &stats);
+  TEST_ASSERT_EQUAL_INT(stats.size, 1);
+  TEST_ASSERT_EQUAL_INT(stats.hits, 1);
+  TEST_ASSERT_EQUAL_INT(stats.misses, 1);
+  TEST_ASSERT_EQUAL_INT(stats.evictions, 0);
+
+  TEST_ASSERT(packet_cache_destroy(&cache) == RC_OK);
+}
+
+void test_packet_cache_lru_eviction() {
+  packet_cache_t cache;
+  packet_cache_stats_t stats;
+  byte_t transaction[PACKET_TX_SIZE];
+
+  TEST_ASSERT(packet_cache_init(&cache, 3) == RC_OK);
+
+  for (size_t i = 0; i < 3; i++) {
+    TEST_ASSERT(packet_cache_put(&cache, hashes[i], transactions[i]) == RC_OK);
+  }
+
+  // Touching the oldest entry makes the second one the least recently used
+  TEST_ASSERT_TRUE(packet_cache_get(&cache, hashes[0], transaction));
+  TEST_ASSERT(packet_cache_put(&cache, hashes[3], transactions[3]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(packet_cache_size(&cache), 3);
+
+  TEST_ASSERT_FALSE(packet_cache_get(&cache, hashes[1], transaction));
+  TEST_ASSERT_TRUE(packet_cache_get(&cache, hashes[0], transaction));
+  TEST_ASSERT_EQUAL_MEMORY(transactions[0], transaction, PACKET_TX_SIZE);
+  TEST_ASSERT_TRUE(packet_cache_get(&cache, hashes[2], transaction));
+  TEST_ASSERT_EQUAL_MEMORY(transactions[2], transaction, PACKET_TX_SIZE);
+  TEST_ASSERT_TRUE(packet_cache_get(&cache, hashes[3], transaction));
+  TEST_ASSERT_EQUAL_MEMORY(transactions[3], transaction, PACKET_TX_SIZE);
+
+  packet_cache_stats(&cache, &stats);
+  TEST_ASSERT_EQUAL_INT(stats.hits, 4);
+  TEST_ASSERT_EQUAL_INT(stats.misses, 1);
+  TEST_ASSERT_EQUAL_INT(stats.evictions, 1);
+
+  TEST_ASSERT(packet_cache_destroy(&cache) == RC_OK);
+}
+
+void test_packet_cache_disabled() {
+  packet_cache_t cache;
+  byte_t transaction[PACKET_TX_SIZE];
+
+  TEST_ASSERT(packet_cache_init(&cache, 0) == RC_OK);
+  TEST_ASSERT(packet_cache_put(&cache, hashes[0], transactions[0]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(packet_cache_size(&cache), 0);
+  TEST_ASSERT_FALSE(packet_cache_get(&cache, hashes[0], transaction));
+  TEST_ASSERT(packet_cache_destroy(&cache) == RC_OK);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_packet_cache_get_put);
+  RUN_TEST(test_packet_cache_lru_eviction);
+  RUN_TEST(test_packet_cache_disabled);
+
+  return UNITY_END();
+}
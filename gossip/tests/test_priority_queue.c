@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "gossip/priority_queue.h"
+
+typedef struct test_entry_s {
+  priority_queue_entry_t entry;
+  int value;
+} test_entry_t;
+
+static test_entry_t entries[16];
+
+static int pop_value(priority_queue_t *const queue) {
+  test_entry_t *entry = (test_entry_t *)priority_queue_pop(queue);
+
+  TEST_ASSERT_NOT_NULL(entry);
+  return entry->value;
+}
+
+static void init_entries(void) {
+  for (int i = 0; i < 16; i++) {
+    entries[i].value = i;
+  }
+}
+
+void test_priority_order(void) {
+  priority_queue_t queue;
+  priority_queue_stats_t stats[GOSSIP_PRIORITY_COUNT];
+
+  priority_queue_init(&queue, 0);
+  TEST_ASSERT_TRUE(priority_queue_empty(&queue));
+  TEST_ASSERT_NULL(priority_queue_peek(&queue));
+  TEST_ASSERT_NULL(priority_queue_pop(&queue));
+
+  TEST_ASSERT_NULL(priority_queue_push(&queue, &entries[0].entry,
+                                       GOSSIP_PRIORITY_NORMAL));
+  TEST_ASSERT_NULL(priority_queue_push(&queue, &entries[1].entry,
+                                       GOSSIP_PRIORITY_HIGH));
+  TEST_ASSERT_NULL(priority_queue_push(&queue, &entries[2].entry,
+                                       GOSSIP_PRIORITY_NORMAL));
+  TEST_ASSERT_NULL(priority_queue_push(&queue, &entries[3].entry,
+                                       GOSSIP_PRIORITY_MILESTONE));
+  TEST_ASSERT_NULL(priority_queue_push(&queue, &entries[4].entry,
+                                       GOSSIP_PRIORITY_HIGH));
+  TEST_ASSERT_EQUAL_INT(5, priority_queue_size(&queue));
+  TEST_ASSERT_EQUAL_PTR(&entries[3].entry, priority_queue_peek(&queue));
+
+  // Most urgent lane first, FIFO within a lane
+  TEST_ASSERT_EQUAL_INT(3, pop_value(&queue));
+  TEST_ASSERT_EQUAL_INT(1, pop_value(&queue));
+  TEST_ASSERT_EQUAL_INT(4, pop_value(&queue));
+  TEST_ASSERT_EQUAL_INT(0, pop_value(&queue));
+  TEST_ASSERT_EQUAL_INT(2, pop_value(&queue));
+  TEST_ASSERT_TRUE(priority_queue_empty(&queue));
+
+  priority_queue_stats(&queue, stats);
+  TEST_ASSERT_EQUAL_INT(1, stats[GOSSIP_PRIORITY_MILESTONE].pushed);
+  TEST_ASSERT_EQUAL_INT(2, stats[GOSSIP_PRIORITY_HIGH].popped);
+  TEST_ASSERT_EQUAL_INT(2, stats[GOSSIP_PRIORITY_NORMAL].popped);
+  TEST_ASSERT_EQUAL_INT(0, stats[GOSSIP_PRIORITY_NORMAL].size);
+  TEST_ASSERT_EQUAL_INT(0, stats[GOSSIP_PRIORITY_NORMAL].dropped);
+}
+
+void test_eviction(void) {
+  priority_queue_t queue;
+  priority_queue_stats_t stats[GOSSIP_PRIORITY_COUNT];
+  int const expected[] = {9, 10, 6, 12, 0, 1, 2, 3};
+
+  // Urgent lanes hold at most 2 entries each
+  priority_queue_init(&queue, 8);
+  for (int i = 0; i < 6; i++) {
+    TEST_ASSERT_NULL(priority_queue_push(&queue, &entries[i].entry,
+                                         GOSSIP_PRIORITY_NORMAL));
+  }
+  TEST_ASSERT_NULL(priority_queue_push(&queue, &entries[6].entry,
+                                       GOSSIP_PRIORITY_HIGH));
+  TEST_ASSERT_NULL(priority_queue_push(&queue, &entries[7].entry,
+                                       GOSSIP_PRIORITY_NORMAL));
+
+  // A regular entry is refused by a full queue
+  TEST_ASSERT_EQUAL_PTR(&entries[8].entry,
+                        priority_queue_push(&queue, &entries[8].entry,
+                                            GOSSIP_PRIORITY_NORMAL));
+  // A milestone evicts the newest entry of the least urgent lane
+  TEST_ASSERT_EQUAL_PTR(&entries[7].entry,
+                        priority_queue_push(&queue, &entries[9].entry,
+                                            GOSSIP_PRIORITY_MILESTONE));
+  TEST_ASSERT_EQUAL_PTR(&entries[5].entry,
+                        priority_queue_push(&queue, &entries[10].entry,
+                                            GOSSIP_PRIORITY_MILESTONE));
+  // Until its own lane is full
+  TEST_ASSERT_EQUAL_PTR(&entries[11].entry,
+                        priority_queue_push(&queue, &entries[11].entry,
+                                            GOSSIP_PRIORITY_MILESTONE));
+  TEST_ASSERT_EQUAL_PTR(&entries[4].entry,
+                        priority_queue_push(&queue, &entries[12].entry,
+                                            GOSSIP_PRIORITY_HIGH));
+  TEST_ASSERT_EQUAL_PTR(&entries[13].entry,
+                        priority_queue_push(&queue, &entries[13].entry,
+                                            GOSSIP_PRIORITY_HIGH));
+  TEST_ASSERT_EQUAL_INT(8, priority_queue_size(&queue));
+
+  priority_queue_stats(&queue, stats);
+  TEST_ASSERT_EQUAL_INT(4, stats[GOSSIP_PRIORITY_NORMAL].dropped);
+  TEST_ASSERT_EQUAL_INT(1, stats[GOSSIP_PRIORITY_HIGH].dropped);
+  TEST_ASSERT_EQUAL_INT(1, stats[GOSSIP_PRIORITY_MILESTONE].dropped);
+  TEST_ASSERT_EQUAL_INT(2, stats[GOSSIP_PRIORITY_MILESTONE].size);
+  TEST_ASSERT_EQUAL_INT(2, stats[GOSSIP_PRIORITY_HIGH].size);
+  TEST_ASSERT_EQUAL_INT(4, stats[GOSSIP_PRIORITY_NORMAL].size);
+
+  for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+    TEST_ASSERT_EQUAL_INT(expected[i], pop_value(&queue));
+  }
+  TEST_ASSERT_TRUE(priority_queue_empty(&queue));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  init_entries();
+  RUN_TEST(test_priority_order);
+  RUN_TEST(test_eviction);
+
+  return UNITY_END();
+}
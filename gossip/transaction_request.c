@@ -6,27 +6,31 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "gossip/transaction_request.h"
 
-bool transaction_request_queue_empty(transaction_request_queue_t const queue) {
-  return (queue == NULL);
+void transaction_request_queue_init(transaction_request_queue_t *const queue,
+                                    size_t const capacity) {
+  priority_queue_init(queue, capacity);
+}
+
+bool transaction_request_queue_empty(
+    transaction_request_queue_t const *const queue) {
+  return priority_queue_empty(queue);
 }
 
 size_t transaction_request_queue_count(
-    transaction_request_queue_t const queue) {
-  transaction_request_queue_entry_t *iter = NULL;
-  size_t count = 0;
-  CDL_COUNT(queue, iter, count);
-  return count;
+    transaction_request_queue_t const *const queue) {
+  return priority_queue_size(queue);
 }
 
 retcode_t transaction_request_queue_push(
     transaction_request_queue_t *const queue, neighbor_t *const neighbor,
-    flex_trit_t const *const hash) {
+    flex_trit_t const *const hash, gossip_priority_t const priority) {
   transaction_request_queue_entry_t *entry = NULL;
 
-  if (queue == NULL) {
+  if (queue == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
@@ -36,42 +40,38 @@ retcode_t transaction_request_queue_push(
   }
   entry->request.neighbor = neighbor;
   memcpy(entry->request.hash, hash, FLEX_TRIT_SIZE_243);
-  CDL_APPEND(*queue, entry);
+  // Dropping a request is the expected outcome of a flood, not an error
+  free(priority_queue_push(queue, &entry->entry, priority));
   return RC_OK;
 }
 
 void transaction_request_queue_pop(transaction_request_queue_t *const queue) {
-  transaction_request_queue_entry_t *tmp = NULL;
-
   if (queue == NULL) {
     return;
   }
-
-  tmp = *queue;
-  if (tmp != NULL) {
-    CDL_DELETE(*queue, *queue);
-    free(tmp);
-  }
+  free(priority_queue_pop(queue));
 }
 
 transaction_request_t *transaction_request_queue_peek(
-    transaction_request_queue_t const queue) {
-  if (queue == NULL) {
+    transaction_request_queue_t const *const queue) {
+  transaction_request_queue_entry_t *entry = NULL;
+
+  if (queue == NULL ||
+      (entry = (transaction_request_queue_entry_t *)priority_queue_peek(
+           queue)) == NULL) {
     return NULL;
   }
-  return &queue->request;
+  return &entry->request;
 }
 
 void transaction_request_queue_free(transaction_request_queue_t *const queue) {
-  transaction_request_queue_entry_t *iter = NULL, *tmp1 = NULL, *tmp2 = NULL;
+  priority_queue_entry_t *entry = NULL;
 
   if (queue == NULL) {
     return;
   }
 
-  CDL_FOREACH_SAFE(*queue, iter, tmp1, tmp2) {
-    CDL_DELETE(*queue, iter);
-    free(iter);
+  while ((entry = priority_queue_pop(queue)) != NULL) {
+    free(entry);
   }
-  *queue = NULL;
 }
@@ -8,10 +8,9 @@
 #ifndef __GOSSIP_TRANSACTION_REQUEST_H__
 #define __GOSSIP_TRANSACTION_REQUEST_H__
 
-#include "utlist.h"
-
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
+#include "gossip/priority_queue.h"
 
 // Forward declarations
 typedef struct neighbor_s neighbor_t;
@@ -25,16 +24,29 @@ typedef struct transaction_request_s {
 } transaction_request_t;
 
 /**
- * A queue of transaction requests used to dispatch them in different threads.
+ * A bounded priority queue of transaction requests used to dispatch them in
+ * different threads.
  * Not concurrent by default.
  */
 typedef struct transaction_request_queue_entry_s {
+  priority_queue_entry_t entry;
   transaction_request_t request;
-  struct transaction_request_queue_entry_s* next;
-  struct transaction_request_queue_entry_s* prev;
 } transaction_request_queue_entry_t;
 
-typedef transaction_request_queue_entry_t* transaction_request_queue_t;
+typedef priority_queue_t transaction_request_queue_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes an empty transaction request queue
+ *
+ * @param queue The transaction request queue
+ * @param capacity The maximum number of requests, 0 for an unbounded queue
+ */
+void transaction_request_queue_init(transaction_request_queue_t* const queue,
+                                    size_t const capacity);
 
 /**
  * Tells whether a transaction request queue is empty or not
@@ -43,7 +55,8 @@ typedef transaction_request_queue_entry_t* transaction_request_queue_t;
  *
  * @return true if empty, false otherwise
  */
-bool transaction_request_queue_empty(transaction_request_queue_t const queue);
+bool transaction_request_queue_empty(
+    transaction_request_queue_t const* const queue);
 
 /**
  * Gets the size of a transaction request queue
@@ -52,20 +65,24 @@ bool transaction_request_queue_empty(transaction_request_queue_t const queue);
  *
  * @return the size of the transaction request queue
  */
-size_t transaction_request_queue_count(transaction_request_queue_t const queue);
+size_t transaction_request_queue_count(
+    transaction_request_queue_t const* const queue);
 
 /**
- * Pushes a transaction request to a transaction request queue
+ * Pushes a transaction request to a transaction request queue, a full queue
+ * makes room for it by dropping a less urgent request or drops it if there is
+ * none
  *
  * @param queue The transaction request queue
  * @param neighbor The requesting neighbor
  * @param hash The requested hash
+ * @param priority The priority of the request
  *
  * @return a status code
  */
 retcode_t transaction_request_queue_push(
     transaction_request_queue_t* const queue, neighbor_t* const neighbor,
-    flex_trit_t const* const hash);
+    flex_trit_t const* const hash, gossip_priority_t const priority);
 
 /**
  * Pops a transaction request from a transaction request queue
@@ -84,7 +101,7 @@ void transaction_request_queue_pop(transaction_request_queue_t* const queue);
  * @return the transaction request
  */
 transaction_request_t* transaction_request_queue_peek(
-    transaction_request_queue_t const queue);
+    transaction_request_queue_t const* const queue);
 
 /**
  * Frees a transaction request queue
@@ -95,4 +112,8 @@ transaction_request_t* transaction_request_queue_peek(
  */
 void transaction_request_queue_free(transaction_request_queue_t* const queue);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif  // __GOSSIP_TRANSACTION_REQUEST_H__
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "utils/arena.h"
+
+#define ARENA_ALIGNMENT 16
+// Blocks double in size up to this one, bounding both the waste of the last
+// block and the number of blocks
+#define ARENA_MAX_BLOCK_SIZE (16 * 1024 * 1024)
+
+#define ARENA_ALIGN(size) \
+  (((size) + ARENA_ALIGNMENT - 1) & ~((size_t)ARENA_ALIGNMENT - 1))
+#define ARENA_HEADER_SIZE ARENA_ALIGN(sizeof(arena_block_t))
+#define ARENA_BLOCK_DATA(block) ((char *)(block) + ARENA_HEADER_SIZE)
+
+/*
+ * Private functions
+ */
+
+static arena_block_t *arena_block_new(size_t const size) {
+  arena_block_t *block = NULL;
+
+  if ((block = (arena_block_t *)malloc(ARENA_HEADER_SIZE + size)) == NULL) {
+    return NULL;
+  }
+  block->next = NULL;
+  block->size = size;
+  block->used = 0;
+
+  return block;
+}
+
+/*
+ * Public functions
+ */
+
+void arena_init(arena_t *const arena, size_t const block_size) {
+  arena->first = NULL;
+  arena->current = NULL;
+  arena->block_size = ARENA_ALIGN(block_size);
+}
+
+void *arena_alloc(arena_t *const arena, size_t const size) {
+  size_t const aligned = ARENA_ALIGN(size);
+  arena_block_t *block = arena->current;
+  size_t block_size = arena->block_size;
+  void *ptr = NULL;
+
+  // Blocks kept by a previous rewind are reused before allocating new ones
+  while (block && block->used + aligned > block->size && block->next) {
+    block = block->next;
+    block->used = 0;
+  }
+
+  // Otherwise block is the last one, if any, and a bigger one is appended
+  if (block == NULL || block->used + aligned > block->size) {
+    arena_block_t *const last = block;
+
+    if (last) {
+      block_size = last->size < ARENA_MAX_BLOCK_SIZE / 2 ? last->size * 2
+                                                          : ARENA_MAX_BLOCK_SIZE;
+    }
+    if (block_size < aligned) {
+      block_size = aligned;
+    }
+    if ((block = arena_block_new(block_size)) == NULL) {
+      return NULL;
+    }
+    if (last) {
+      last->next = block;
+    } else {
+      arena->first = block;
+    }
+  }
+
+  arena->current = block;
+  ptr = ARENA_BLOCK_DATA(block) + block->used;
+  block->used += aligned;
+
+  return ptr;
+}
+
+arena_mark_t arena_mark(arena_t const *const arena) {
+  arena_mark_t mark = {.block = arena->current,
+                       .used = arena->current ? arena->current->used : 0};
+
+  return mark;
+}
+
+void arena_rewind(arena_t *const arena, arena_mark_t const *const mark) {
+  if (mark->block == NULL) {
+    arena_reset(arena);
+    return;
+  }
+  arena->current = mark->block;
+  arena->current->used = mark->used;
+}
+
+void arena_reset(arena_t *const arena) {
+  arena->current = arena->first;
+  if (arena->current) {
+    arena->current->used = 0;
+  }
+}
+
+void arena_trim(arena_t *const arena, size_t const retain) {
+  arena_block_t *block = arena->current, *next = NULL;
+  size_t kept = 0;
+
+  if (block == NULL) {
+    return;
+  }
+
+  for (arena_block_t *iter = arena->first; iter != block; iter = iter->next) {
+    kept += iter->size;
+  }
+  kept += block->size;
+
+  while (block->next) {
+    next = block->next;
+    if (kept + next->size <= retain) {
+      kept += next->size;
+      block = next;
+      continue;
+    }
+    block->next = next->next;
+    free(next);
+  }
+}
+
+bool arena_owns(arena_t const *const arena, void const *const ptr) {
+  uintptr_t const address = (uintptr_t)ptr;
+
+  for (arena_block_t const *block = arena->first; block; block = block->next) {
+    uintptr_t const data = (uintptr_t)ARENA_BLOCK_DATA(block);
+    if (address >= data && address < data + block->size) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void arena_destroy(arena_t *const arena) {
+  arena_block_t *block = arena->first, *next = NULL;
+
+  while (block) {
+    next = block->next;
+    free(block);
+    block = next;
+  }
+  arena->first = NULL;
+  arena->current = NULL;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __UTILS_ARENA_H__
+#define __UTILS_ARENA_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * An arena hands out memory by bumping a cursor through a list of blocks.
+ * Allocations are never freed one by one: rewinding to a mark releases
+ * everything allocated since in O(1), and the blocks are kept to serve the
+ * next allocations without going back to malloc.
+ */
+
+typedef struct arena_block_s {
+  struct arena_block_s *next;
+  size_t size;
+  size_t used;
+} arena_block_t;
+
+typedef struct arena_s {
+  arena_block_t *first;
+  arena_block_t *current;
+  size_t block_size;
+} arena_t;
+
+typedef struct arena_mark_s {
+  arena_block_t *block;
+  size_t used;
+} arena_mark_t;
+
+/**
+ * Initializes an arena, no memory is allocated until the first allocation
+ *
+ * @param arena The arena
+ * @param block_size Size of the first block, the next ones grow from it
+ */
+void arena_init(arena_t *const arena, size_t const block_size);
+
+/**
+ * Allocates memory from an arena
+ *
+ * @param arena The arena
+ * @param size Number of bytes
+ *
+ * @return suitably aligned memory or NULL if out of memory
+ */
+void *arena_alloc(arena_t *const arena, size_t const size);
+
+/**
+ * Marks the current position of an arena
+ *
+ * @param arena The arena
+ *
+ * @return the mark
+ */
+arena_mark_t arena_mark(arena_t const *const arena);
+
+/**
+ * Releases everything allocated since a mark, in constant time
+ *
+ * @param arena The arena
+ * @param mark A mark of this arena not rewound past yet
+ */
+void arena_rewind(arena_t *const arena, arena_mark_t const *const mark);
+
+/**
+ * Releases everything allocated from an arena, in constant time
+ *
+ * @param arena The arena
+ */
+void arena_reset(arena_t *const arena);
+
+/**
+ * Gives the blocks not in use back to the system, keeping at least retain
+ * bytes worth of blocks
+ *
+ * @param arena The arena
+ * @param retain Number of bytes to keep
+ */
+void arena_trim(arena_t *const arena, size_t const retain);
+
+/**
+ * Tells if memory belongs to one of the blocks of an arena
+ *
+ * @param arena The arena
+ * @param ptr The memory
+ *
+ * @return true if ptr was handed out by the arena
+ */
+bool arena_owns(arena_t const *const arena, void const *const ptr);
+
+/**
+ * Frees all the blocks of an arena
+ *
+ * @param arena The arena
+ */
+void arena_destroy(arena_t *const arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __UTILS_ARENA_H__
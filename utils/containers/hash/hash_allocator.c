@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "utils/containers/hash/hash_allocator.h"
+
+#define HASH_ALLOCATOR_BLOCK_SIZE (64 * 1024)
+// Memory a thread keeps for its next scopes once the outermost one is closed
+#define HASH_ALLOCATOR_RETAINED_SIZE (4 * 1024 * 1024)
+
+// Every allocation is preceded by the arena it comes from, NULL for malloc,
+// padded to keep the entries aligned like the arena does
+typedef union hash_allocator_header_u {
+  arena_t *arena;
+  char padding[16];
+} hash_allocator_header_t;
+
+static pthread_once_t arena_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t arena_key;
+
+static __thread arena_t *thread_arena = NULL;
+static __thread bool thread_active = false;
+static __thread size_t thread_depth = 0;
+
+/*
+ * Private functions
+ */
+
+static void arena_key_destroy(void *const arena) {
+  arena_destroy((arena_t *)arena);
+  free(arena);
+}
+
+static void arena_key_create(void) {
+  pthread_key_create(&arena_key, arena_key_destroy);
+}
+
+// The arena is created on first use and destroyed when the thread exits
+static arena_t *thread_arena_get(void) {
+  if (thread_arena == NULL) {
+    pthread_once(&arena_key_once, arena_key_create);
+    if ((thread_arena = (arena_t *)malloc(sizeof(arena_t))) == NULL) {
+      return NULL;
+    }
+    arena_init(thread_arena, HASH_ALLOCATOR_BLOCK_SIZE);
+    pthread_setspecific(arena_key, thread_arena);
+  }
+
+  return thread_arena;
+}
+
+/*
+ * Public functions
+ */
+
+void *hash_allocator_malloc(void const *const container, size_t const size) {
+  arena_t *arena = NULL;
+  hash_allocator_header_t *header = NULL;
+
+  if (container != NULL) {
+    arena = ((hash_allocator_header_t const *)container - 1)->arena;
+  } else if (thread_active) {
+    arena = thread_arena;
+  }
+
+  if (arena) {
+    header = (hash_allocator_header_t *)arena_alloc(
+        arena, sizeof(hash_allocator_header_t) + size);
+  } else {
+    header = (hash_allocator_header_t *)malloc(sizeof(hash_allocator_header_t) +
+                                               size);
+  }
+  if (header == NULL) {
+    return NULL;
+  }
+  header->arena = arena;
+
+  return header + 1;
+}
+
+void hash_allocator_free(void *const ptr) {
+  hash_allocator_header_t *header = NULL;
+
+  if (ptr == NULL) {
+    return;
+  }
+  // Arena memory is only released by closing the scope it was allocated in
+  header = (hash_allocator_header_t *)ptr - 1;
+  if (header->arena == NULL) {
+    free(header);
+  }
+}
+
+void hash_allocator_scope_begin(hash_allocator_scope_t *const scope) {
+  arena_t *const arena = thread_arena_get();
+
+  scope->enabled = thread_active;
+  scope->mark.block = NULL;
+  scope->mark.used = 0;
+  if (arena) {
+    scope->mark = arena_mark(arena);
+  }
+  // Without an arena the scope falls back to malloc
+  thread_active = arena != NULL;
+  thread_depth++;
+}
+
+void hash_allocator_scope_end(hash_allocator_scope_t const *const scope) {
+  if (thread_arena) {
+    arena_rewind(thread_arena, &scope->mark);
+  }
+  thread_active = scope->enabled;
+  if (--thread_depth == 0 && thread_arena) {
+    arena_trim(thread_arena, HASH_ALLOCATOR_RETAINED_SIZE);
+  }
+}
+
+bool hash_allocator_suspend(void) {
+  bool const active = thread_active;
+
+  thread_active = false;
+  return active;
+}
+
+void hash_allocator_resume(bool const active) { thread_active = active; }
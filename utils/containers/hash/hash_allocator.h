@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __UTILS_CONTAINERS_HASH_HASH_ALLOCATOR_H__
+#define __UTILS_CONTAINERS_HASH_HASH_ALLOCATOR_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "utils/arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Allocator of the hash containers entries.
+ *
+ * Every entry records where it was allocated and the entries of a container
+ * all come from the same place, decided when its first entry is added: an
+ * arena owned by the calling thread if it opened a scope, malloc otherwise.
+ * Adding to a non-empty container never depends on the calling thread, and
+ * entries can be freed from any thread. Closing a scope releases everything
+ * allocated from its arena since it was opened at once, freeing such memory
+ * before is a no-op. Containers started within a scope must then not outlive
+ * it: code starting longer-lived containers suspends the scope while doing so.
+ * The uthash tables of the containers always come from malloc.
+ */
+
+typedef struct hash_allocator_scope_s {
+  arena_mark_t mark;
+  bool enabled;
+} hash_allocator_scope_t;
+
+/**
+ * Allocates an entry of a container from where its other entries come from.
+ * The first entry of a container comes from the thread arena if a scope is
+ * open, from malloc otherwise
+ *
+ * @param container Any entry of the container, NULL if it is empty
+ * @param size Number of bytes
+ *
+ * @return the memory or NULL if out of memory
+ */
+void *hash_allocator_malloc(void const *const container, size_t const size);
+
+/**
+ * Frees memory allocated by hash_allocator_malloc, from any thread
+ *
+ * @param ptr The memory, may be NULL
+ */
+void hash_allocator_free(void *const ptr);
+
+/**
+ * Opens a scope, scopes can be nested
+ *
+ * @param scope The scope
+ */
+void hash_allocator_scope_begin(hash_allocator_scope_t *const scope);
+
+/**
+ * Closes a scope, releasing everything allocated since it was opened
+ *
+ * @param scope The scope, the last one opened by the thread
+ */
+void hash_allocator_scope_end(hash_allocator_scope_t const *const scope);
+
+/**
+ * Makes the next allocations of the thread come from malloc even within a
+ * scope
+ *
+ * @return whether a scope was active, to be given to hash_allocator_resume
+ */
+bool hash_allocator_suspend(void);
+
+/**
+ * Undoes hash_allocator_suspend
+ *
+ * @param active The value returned by hash_allocator_suspend
+ */
+void hash_allocator_resume(bool const active);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __UTILS_CONTAINERS_HASH_HASH_ALLOCATOR_H__
@@ -5,6 +5,7 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include "utils/containers/hash/hash_allocator.h"
 #include "utils/containers/hash/hash_{TYPE}_map.h"
 #include "utils/handles/rand.h"
 
@@ -12,8 +13,8 @@ retcode_t hash_to_{TYPE}_map_add(hash_to_{TYPE}_map_t *const map,
                                   flex_trit_t const *const hash,
                                   {TYPE} value) {
   hash_to_{TYPE}_map_entry_t *map_entry = NULL;
-  map_entry = (hash_to_{TYPE}_map_entry_t *)malloc(
-      sizeof(hash_to_{TYPE}_map_entry_t));
+  map_entry = (hash_to_{TYPE}_map_entry_t *)hash_allocator_malloc(
+      *map, sizeof(hash_to_{TYPE}_map_entry_t));
 
   if (map_entry == NULL) {
     return RC_UTILS_OOM;
@@ -50,13 +51,22 @@ bool hash_to_{TYPE}_map_find(hash_to_{TYPE}_map_t const *const map,
   HASH_FIND(hh, *map, hash, FLEX_TRIT_SIZE_243, *res);
   return *res != NULL;
 }
+
+void hash_to_{TYPE}_map_remove_entry(hash_to_{TYPE}_map_t *const map,
+                                     hash_to_{TYPE}_map_entry_t *const entry) {
+  if (map != NULL && *map != NULL && entry != NULL) {
+    HASH_DEL(*map, entry);
+    hash_allocator_free(entry);
+  }
+}
+
 void hash_to_{TYPE}_map_free(hash_to_{TYPE}_map_t *const map) {
   hash_to_{TYPE}_map_entry_t *curr_entry = NULL;
   hash_to_{TYPE}_map_entry_t *tmp_entry = NULL;
 
   HASH_ITER(hh, *map, curr_entry, tmp_entry) {
     HASH_DEL(*map, curr_entry);
-    free(curr_entry);
+    hash_allocator_free(curr_entry);
   }
   *map = NULL;
 }
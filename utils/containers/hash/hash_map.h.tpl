@@ -34,6 +34,8 @@ bool hash_to_{TYPE}_map_contains(hash_to_{TYPE}_map_t const *const map,
 bool hash_to_{TYPE}_map_find(hash_to_{TYPE}_map_t const *const map,
         flex_trit_t const *const hash,
 hash_to_{TYPE}_map_entry_t ** const res);
+void hash_to_{TYPE}_map_remove_entry(hash_to_{TYPE}_map_t *const map,
+        hash_to_{TYPE}_map_entry_t *const entry);
 void hash_to_{TYPE}_map_free(hash_to_{TYPE}_map_t *const map);
 void hash_to_{TYPE}_map_keys(hash_to_{TYPE}_map_t *const map,
                              hash243_set_t * const keys);
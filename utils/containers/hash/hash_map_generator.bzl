@@ -46,6 +46,7 @@ def hash_map_generate(mapped_type):
         deps = [
             "//common:errors",
             "//common/trinary:flex_trit",
+            "//utils/containers/hash:hash_allocator",
             "//utils/handles:rand",
             "//utils/containers/hash:hash243_set",
             "@com_github_uthash//:uthash",
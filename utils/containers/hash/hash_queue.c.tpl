@@ -7,6 +7,7 @@
 
 #include <stdlib.h>
 
+#include "utils/containers/hash/hash_allocator.h"
 #include "utils/containers/hash/hash{SIZE}_queue.h"
 
 bool hash{SIZE}_queue_empty(hash{SIZE}_queue_t const queue) { return (queue == NULL); }
@@ -15,7 +16,7 @@ retcode_t hash{SIZE}_queue_push(hash{SIZE}_queue_t *const queue,
                           flex_trit_t const *const hash) {
   hash{SIZE}_queue_entry_t *entry = NULL;
 
-  if ((entry = (hash{SIZE}_queue_entry_t *)malloc(sizeof(hash{SIZE}_queue_entry_t))) == NULL) {
+  if ((entry = (hash{SIZE}_queue_entry_t *)hash_allocator_malloc(*queue, sizeof(hash{SIZE}_queue_entry_t))) == NULL) {
     return RC_UTILS_OOM;
   }
   memcpy(entry->hash, hash, FLEX_TRIT_SIZE_{SIZE});
@@ -29,7 +30,7 @@ void hash{SIZE}_queue_pop(hash{SIZE}_queue_t *const queue) {
   tmp = *queue;
   if (tmp != NULL) {
     CDL_DELETE(*queue, *queue);
-    free(tmp);
+    hash_allocator_free(tmp);
   }
 }
 
@@ -45,7 +46,7 @@ void hash{SIZE}_queue_free(hash{SIZE}_queue_t *const queue) {
 
   CDL_FOREACH_SAFE(*queue, iter, tmp1, tmp2) {
     CDL_DELETE(*queue, iter);
-    free(iter);
+    hash_allocator_free(iter);
   }
 }
 
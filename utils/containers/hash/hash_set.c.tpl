@@ -5,6 +5,7 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include "utils/containers/hash/hash_allocator.h"
 #include "utils/containers/hash/hash{SIZE}_set.h"
 #include "utils/handles/rand.h"
 
@@ -17,7 +18,7 @@ retcode_t hash{SIZE}_set_add(hash{SIZE}_set_t *const set,
   hash{SIZE}_set_entry_t *entry = NULL;
 
   if (!hash{SIZE}_set_contains(set, hash)) {
-    if ((entry = (hash{SIZE}_set_entry_t *)malloc(sizeof(hash{SIZE}_set_entry_t))) == NULL) {
+    if ((entry = (hash{SIZE}_set_entry_t *)hash_allocator_malloc(*set, sizeof(hash{SIZE}_set_entry_t))) == NULL) {
       return RC_UTILS_OOM;
     }
     memcpy(entry->hash, hash, FLEX_TRIT_SIZE_{SIZE});
@@ -41,7 +42,7 @@ retcode_t hash{SIZE}_set_remove_entry(hash{SIZE}_set_t *const set,
                                       hash{SIZE}_set_entry_t * const entry) {
   if (set != NULL && * set != NULL && entry != NULL) {
     HASH_DEL(*set, entry);
-    free(entry);
+    hash_allocator_free(entry);
   }
   return RC_OK;
 }
@@ -91,7 +92,7 @@ void hash{SIZE}_set_free(hash{SIZE}_set_t *const set) {
 
   HASH_ITER(hh, *set, iter, tmp) {
     HASH_DEL(*set, iter);
-    free(iter);
+    hash_allocator_free(iter);
   }
   *set = NULL;
 }
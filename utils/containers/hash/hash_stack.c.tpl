@@ -7,6 +7,7 @@
 
 #include <stdlib.h>
 
+#include "utils/containers/hash/hash_allocator.h"
 #include "utils/containers/hash/hash{SIZE}_stack.h"
 
 bool hash{SIZE}_stack_empty(hash{SIZE}_stack_t const stack) { return (stack == NULL); }
@@ -15,7 +16,7 @@ retcode_t hash{SIZE}_stack_push(hash{SIZE}_stack_t *const stack,
                           flex_trit_t const *const hash) {
   hash{SIZE}_stack_entry_t *entry = NULL;
 
-  if ((entry = (hash{SIZE}_stack_entry_t *)malloc(sizeof(hash{SIZE}_stack_entry_t))) == NULL) {
+  if ((entry = (hash{SIZE}_stack_entry_t *)hash_allocator_malloc(*stack, sizeof(hash{SIZE}_stack_entry_t))) == NULL) {
     return RC_UTILS_OOM;
   }
   memcpy(entry->hash, hash, FLEX_TRIT_SIZE_{SIZE});
@@ -28,7 +29,7 @@ void hash{SIZE}_stack_pop(hash{SIZE}_stack_t *const stack) {
 
   tmp = *stack;
   LL_DELETE(*stack, *stack);
-  free(tmp);
+  hash_allocator_free(tmp);
 }
 
 flex_trit_t *hash{SIZE}_stack_peek(hash{SIZE}_stack_t const stack) {
@@ -40,7 +41,7 @@ void hash{SIZE}_stack_free(hash{SIZE}_stack_t *const stack) {
 
   LL_FOREACH_SAFE(*stack, iter, tmp) {
     LL_DELETE(*stack, iter);
-    free(iter);
+    hash_allocator_free(iter);
   }
 }
 
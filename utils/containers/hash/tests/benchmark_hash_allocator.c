@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "utils/containers/hash/hash243_set.h"
+#include "utils/containers/hash/hash243_stack.h"
+#include "utils/containers/hash/hash_allocator.h"
+#include "utils/containers/hash/hash_int64_t_map.h"
+
+#define NUM_RUNS 10
+
+static double elapsed_ms(struct timespec const *const start,
+                         struct timespec const *const end) {
+  return (end->tv_sec - start->tv_sec) * 1e3 +
+         (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static void node_hash(flex_trit_t *const hash, size_t const node) {
+  memset(hash, 0, FLEX_TRIT_SIZE_243);
+  memcpy(hash, &node, sizeof(node));
+}
+
+/**
+ * Mimics the traversal state of a tip selection request: a depth-first walk of
+ * a synthetic tangle where each transaction approves the previous one and a
+ * random older one, rating every visited transaction.
+ */
+static retcode_t traverse(size_t const *const branches, size_t const size) {
+  retcode_t ret = RC_OK;
+  hash243_stack_t stack = NULL;
+  hash243_set_t visited = NULL;
+  hash_to_int64_t_map_t ratings = NULL;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  size_t node = 0;
+
+  node_hash(hash, size - 1);
+  if ((ret = hash243_stack_push(&stack, hash)) != RC_OK) {
+    goto done;
+  }
+  while (!hash243_stack_empty(stack)) {
+    memcpy(hash, hash243_stack_peek(stack), FLEX_TRIT_SIZE_243);
+    hash243_stack_pop(&stack);
+    if (hash243_set_contains(&visited, hash)) {
+      continue;
+    }
+    if ((ret = hash243_set_add(&visited, hash)) != RC_OK ||
+        (ret = hash_to_int64_t_map_add(&ratings, hash, 1)) != RC_OK) {
+      goto done;
+    }
+    memcpy(&node, hash, sizeof(node));
+    if (node == 0) {
+      continue;
+    }
+    node_hash(hash, node - 1);
+    if ((ret = hash243_stack_push(&stack, hash)) != RC_OK) {
+      goto done;
+    }
+    node_hash(hash, branches[node]);
+    if ((ret = hash243_stack_push(&stack, hash)) != RC_OK) {
+      goto done;
+    }
+  }
+
+done:
+  hash243_stack_free(&stack);
+  hash243_set_free(&visited);
+  hash_to_int64_t_map_free(&ratings);
+  return ret;
+}
+
+static int benchmark(size_t const size, bool const scoped) {
+  size_t *branches = NULL;
+  hash_allocator_scope_t scope;
+  struct timespec start, end;
+  double total = 0;
+  retcode_t ret = RC_OK;
+
+  if ((branches = (size_t *)malloc(size * sizeof(size_t))) == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (size_t i = 0; i < size; i++) {
+    branches[i] = i ? (size_t)rand() % i : 0;
+  }
+
+  for (size_t i = 0; i < NUM_RUNS && ret == RC_OK; i++) {
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (scoped) {
+      hash_allocator_scope_begin(&scope);
+    }
+    ret = traverse(branches, size);
+    if (scoped) {
+      hash_allocator_scope_end(&scope);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    total += elapsed_ms(&start, &end);
+  }
+  free(branches);
+
+  if (ret != RC_OK) {
+    fprintf(stderr, "Traversal of %zu transactions failed\n", size);
+    return EXIT_FAILURE;
+  }
+  printf("%7zu transactions, %-6s: %8.3f ms per traversal\n", size,
+         scoped ? "arena" : "malloc", total / NUM_RUNS);
+  return EXIT_SUCCESS;
+}
+
+int main(void) {
+  size_t const sizes[] = {1000, 10000, 100000};
+
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    if (benchmark(sizes[i], false) != EXIT_SUCCESS ||
+        benchmark(sizes[i], true) != EXIT_SUCCESS) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
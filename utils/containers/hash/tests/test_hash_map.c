@@ -5,7 +5,10 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <string.h>
+
 #include "common/errors.h"
+#include "utils/containers/hash/hash_allocator.h"
 #include "utils/containers/hash/hash_int64_t_map.h"
 #include "utils/containers/hash/tests/defs.h"
 
@@ -18,10 +21,85 @@ void test_hash_int64_t_map() {
   hash_to_int64_t_map_free(&map);
 }
 
+void test_hash_int64_t_map_scope() {
+  hash_to_int64_t_map_t local = NULL;
+  hash_to_int64_t_map_t global = NULL;
+  hash_to_int64_t_map_entry_t* e = NULL;
+  hash_allocator_scope_t scope;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  bool active = false;
+
+  hash_allocator_scope_begin(&scope);
+  for (int64_t i = 0; i < 1000; i++) {
+    memcpy(hash, hash243_1, FLEX_TRIT_SIZE_243);
+    memcpy(hash, &i, sizeof(i));
+    TEST_ASSERT(hash_to_int64_t_map_add(&local, hash, i) == RC_OK);
+    if (i % 10 == 0) {
+      active = hash_allocator_suspend();
+      TEST_ASSERT(hash_to_int64_t_map_add(&global, hash, i) == RC_OK);
+      hash_allocator_resume(active);
+    }
+  }
+  TEST_ASSERT(hash_to_int64_t_map_find(&local, hash, &e));
+  hash_to_int64_t_map_remove_entry(&local, e);
+  TEST_ASSERT(hash_to_int64_t_map_find(&local, hash, &e) == false);
+  hash_to_int64_t_map_free(&local);
+  hash_allocator_scope_end(&scope);
+
+  // Entries added while suspended outlive the scope
+  for (int64_t i = 0; i < 1000; i += 10) {
+    memcpy(hash, hash243_1, FLEX_TRIT_SIZE_243);
+    memcpy(hash, &i, sizeof(i));
+    TEST_ASSERT(hash_to_int64_t_map_find(&global, hash, &e));
+    TEST_ASSERT(e->value == i);
+  }
+  hash_to_int64_t_map_free(&global);
+}
+
+void test_hash_int64_t_map_scope_grow() {
+  hash_to_int64_t_map_t local = NULL;
+  hash_to_int64_t_map_t global = NULL;
+  hash_to_int64_t_map_entry_t* e = NULL;
+  hash_allocator_scope_t scope;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  memcpy(hash, hash243_1, FLEX_TRIT_SIZE_243);
+  TEST_ASSERT(hash_to_int64_t_map_add(&global, hash, -1) == RC_OK);
+
+  // A container started outside of a scope keeps growing from malloc
+  hash_allocator_scope_begin(&scope);
+  for (int64_t i = 0; i < 1000; i++) {
+    memcpy(hash, hash243_1, FLEX_TRIT_SIZE_243);
+    memcpy(hash, &i, sizeof(i));
+    TEST_ASSERT(hash_to_int64_t_map_add(&global, hash, i) == RC_OK);
+  }
+  hash_allocator_scope_end(&scope);
+
+  // Reusing the arena leaves it untouched
+  hash_allocator_scope_begin(&scope);
+  for (int64_t i = 0; i < 1000; i++) {
+    memcpy(hash, hash243_1, FLEX_TRIT_SIZE_243);
+    memcpy(hash, &i, sizeof(i));
+    TEST_ASSERT(hash_to_int64_t_map_add(&local, hash, -i) == RC_OK);
+  }
+  for (int64_t i = 0; i < 1000; i++) {
+    memcpy(hash, hash243_1, FLEX_TRIT_SIZE_243);
+    memcpy(hash, &i, sizeof(i));
+    TEST_ASSERT(hash_to_int64_t_map_find(&global, hash, &e));
+    TEST_ASSERT(e->value == i);
+  }
+  hash_to_int64_t_map_free(&local);
+  hash_allocator_scope_end(&scope);
+
+  hash_to_int64_t_map_free(&global);
+}
+
 int main(void) {
   UNITY_BEGIN();
 
   RUN_TEST(test_hash_int64_t_map);
+  RUN_TEST(test_hash_int64_t_map_scope);
+  RUN_TEST(test_hash_int64_t_map_scope_grow);
 
   return UNITY_END();
 }
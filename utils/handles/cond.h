@@ -25,6 +25,8 @@ extern "C" {
 #include <Windows.h>
 #endif
 
+#include <stdint.h>
+
 #include "utils/handles/lock.h"
 
 #ifdef _POSIX_THREADS
@@ -57,6 +59,21 @@ static inline int cond_handle_timedwait(cond_handle_t* const cond,
   return pthread_cond_timedwait(cond, lock, &ts);
 }
 
+static inline int cond_handle_timedwait_ms(cond_handle_t* const cond,
+                                           lock_handle_t* const lock,
+                                           uint64_t const timeout_ms) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+  ts.tv_sec += timeout_ms / 1000;
+  ts.tv_nsec += (timeout_ms % 1000) * 1000000;
+  if (ts.tv_nsec >= 1000000000) {
+    ts.tv_sec++;
+    ts.tv_nsec -= 1000000000;
+  }
+  return pthread_cond_timedwait(cond, lock, &ts);
+}
+
 static inline int cond_handle_destroy(cond_handle_t* const cond) {
   return pthread_cond_destroy(cond);
 }
@@ -90,6 +107,14 @@ static inline int cond_handle_timedwait(cond_handle_t* const cond,
   return 0;
 }
 
+static inline int cond_handle_timedwait_ms(cond_handle_t* const cond,
+                                           lock_handle_t* const lock,
+                                           uint64_t const timeout_ms) {
+  if (!SleepConditionVariableCS(cond, lock, (DWORD)timeout_ms))
+    return ETIMEDOUT;
+  return 0;
+}
+
 static inline int cond_handle_destroy(cond_handle_t* const cond) { return 0; }
 
 #else
@@ -153,6 +178,19 @@ static inline int cond_handle_timedwait(cond_handle_t* const cond,
                                         lock_handle_t* const lock,
                                         unsigned int timeout);
 
+/**
+ * Same as cond_handle_timedwait with a timeout in milliseconds
+ *
+ * @param cond The condition variable
+ * @param lock The associated lock
+ * @param timeout_ms The timeout in milliseconds
+ *
+ * @return exit status
+ */
+static inline int cond_handle_timedwait_ms(cond_handle_t* const cond,
+                                           lock_handle_t* const lock,
+                                           uint64_t const timeout_ms);
+
 /**
  * Destroys the condition variable specified by cond
  *
@@ -0,0 +1,647 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/handles/executor.h"
+#include "utils/system.h"
+#include "utils/time.h"
+
+#define EXECUTOR_DEQUE_INITIAL_CAPACITY 64
+#define EXECUTOR_TIMERS_INITIAL_CAPACITY 16
+// Number of due timers fired at once by a worker
+#define EXECUTOR_TIMERS_BATCH 16
+
+// Worker running on the calling thread, tasks it schedules go to its own queue
+static __thread executor_worker_t *current_worker = NULL;
+
+/*
+ * Private functions
+ */
+
+static retcode_t deque_init(executor_deque_t *const deque) {
+  if ((deque->tasks = (executor_task_t **)malloc(
+           EXECUTOR_DEQUE_INITIAL_CAPACITY * sizeof(executor_task_t *))) ==
+      NULL) {
+    return RC_OOM;
+  }
+  deque->head = 0;
+  deque->size = 0;
+  deque->capacity = EXECUTOR_DEQUE_INITIAL_CAPACITY;
+  lock_handle_init(&deque->lock);
+
+  return RC_OK;
+}
+
+static void deque_destroy(executor_deque_t *const deque) {
+  free(deque->tasks);
+  deque->tasks = NULL;
+  lock_handle_destroy(&deque->lock);
+}
+
+/**
+ * Appends a task to a deque, the caller must hold the deque lock
+ */
+static retcode_t deque_push(executor_deque_t *const deque,
+                            executor_task_t *const task) {
+  executor_task_t **tasks = NULL;
+
+  if (deque->size == deque->capacity) {
+    if ((tasks = (executor_task_t **)malloc(2 * deque->capacity *
+                                            sizeof(executor_task_t *))) ==
+        NULL) {
+      return RC_OOM;
+    }
+    for (size_t i = 0; i < deque->size; i++) {
+      tasks[i] = deque->tasks[(deque->head + i) % deque->capacity];
+    }
+    free(deque->tasks);
+    deque->tasks = tasks;
+    deque->head = 0;
+    deque->capacity *= 2;
+  }
+  deque->tasks[(deque->head + deque->size) % deque->capacity] = task;
+  deque->size++;
+
+  return RC_OK;
+}
+
+/**
+ * Takes the oldest task of a deque, the caller must hold the deque lock. Both
+ * the owner and thieves take the oldest task so that a task rescheduling
+ * itself cannot starve the others queued behind it.
+ */
+static executor_task_t *deque_pop(executor_deque_t *const deque) {
+  executor_task_t *task = NULL;
+
+  if (deque->size == 0) {
+    return NULL;
+  }
+  task = deque->tasks[deque->head];
+  deque->head = (deque->head + 1) % deque->capacity;
+  deque->size--;
+
+  return task;
+}
+
+static bool executor_has_work(executor_t *const executor) {
+  bool has_work = false;
+
+  for (size_t i = 0; i < executor->workers_count && !has_work; i++) {
+    lock_handle_lock(&executor->workers[i].deque.lock);
+    has_work = executor->workers[i].deque.size != 0;
+    lock_handle_unlock(&executor->workers[i].deque.lock);
+  }
+
+  return has_work;
+}
+
+/**
+ * Queues a task whose state was just set to queued, on the queue of the
+ * calling worker if any and in a round-robin fashion otherwise
+ */
+static retcode_t executor_push(executor_t *const executor,
+                               executor_task_t *const task) {
+  retcode_t ret = RC_OK;
+  executor_worker_t *worker = current_worker;
+
+  lock_handle_lock(&executor->lock);
+  if (worker == NULL || worker->executor != executor) {
+    worker = &executor->workers[executor->next_worker];
+    executor->next_worker =
+        (executor->next_worker + 1) % executor->workers_count;
+  }
+  lock_handle_lock(&worker->deque.lock);
+  ret = deque_push(&worker->deque, task);
+  lock_handle_unlock(&worker->deque.lock);
+  if (ret == RC_OK && executor->idle != 0) {
+    cond_handle_signal(&executor->cond);
+  }
+  lock_handle_unlock(&executor->lock);
+
+  return ret;
+}
+
+static void timers_sift_up(executor_t *const executor, size_t index) {
+  executor_timer_t *const timers = executor->timers;
+  executor_timer_t const timer = timers[index];
+
+  while (index > 0 &&
+         timers[(index - 1) / 2].deadline_ms > timer.deadline_ms) {
+    timers[index] = timers[(index - 1) / 2];
+    index = (index - 1) / 2;
+  }
+  timers[index] = timer;
+}
+
+static void timers_sift_down(executor_t *const executor, size_t index) {
+  executor_timer_t *const timers = executor->timers;
+  executor_timer_t const timer = timers[index];
+  size_t child = 0;
+
+  while ((child = 2 * index + 1) < executor->timers_count) {
+    if (child + 1 < executor->timers_count &&
+        timers[child + 1].deadline_ms < timers[child].deadline_ms) {
+      child++;
+    }
+    if (timers[child].deadline_ms >= timer.deadline_ms) {
+      break;
+    }
+    timers[index] = timers[child];
+    index = child;
+  }
+  timers[index] = timer;
+}
+
+/**
+ * Removes a timer, the caller must hold the executor lock
+ */
+static void executor_remove_timer(executor_t *const executor,
+                                  size_t const index) {
+  executor->timers[index] = executor->timers[--executor->timers_count];
+  if (index < executor->timers_count) {
+    timers_sift_down(executor, index);
+    timers_sift_up(executor, index);
+  }
+}
+
+/**
+ * Arms a timer for a task whose state was just set to timed
+ */
+static retcode_t executor_add_timer(executor_t *const executor,
+                                    executor_task_t *const task) {
+  executor_timer_t *timers = NULL;
+  size_t capacity = 0;
+
+  lock_handle_lock(&executor->lock);
+  if (executor->timers_count == executor->timers_capacity) {
+    capacity = executor->timers_capacity ? 2 * executor->timers_capacity
+                                         : EXECUTOR_TIMERS_INITIAL_CAPACITY;
+    if ((timers = (executor_timer_t *)realloc(
+             executor->timers, capacity * sizeof(executor_timer_t))) == NULL) {
+      lock_handle_unlock(&executor->lock);
+      return RC_OOM;
+    }
+    executor->timers = timers;
+    executor->timers_capacity = capacity;
+  }
+  executor->timers[executor->timers_count].deadline_ms = task->deadline_ms;
+  executor->timers[executor->timers_count].generation = task->generation;
+  executor->timers[executor->timers_count].task = task;
+  timers_sift_up(executor, executor->timers_count++);
+  // A sleeping worker may have to wake up earlier than planned
+  if (executor->timers[0].task == task && executor->idle != 0) {
+    cond_handle_signal(&executor->cond);
+  }
+  lock_handle_unlock(&executor->lock);
+
+  return RC_OK;
+}
+
+/**
+ * Queues the task of a due timer unless the timer is stale
+ */
+static void executor_fire_timer(executor_t *const executor,
+                                executor_timer_t const *const timer) {
+  executor_task_t *const task = timer->task;
+  bool queued = false;
+
+  lock_handle_lock(&task->lock);
+  if (task->state == EXECUTOR_TASK_TIMED &&
+      task->generation == timer->generation && !task->cancelled) {
+    task->state = EXECUTOR_TASK_QUEUED;
+    // Latency is measured from when the task was due
+    task->queued_at_us = timer->deadline_ms * 1000ULL;
+    queued = true;
+  }
+  lock_handle_unlock(&task->lock);
+
+  if (queued && executor_push(executor, task) != RC_OK) {
+    lock_handle_lock(&task->lock);
+    task->state = EXECUTOR_TASK_IDLE;
+    cond_handle_broadcast(&task->cond);
+    lock_handle_unlock(&task->lock);
+  }
+}
+
+static void executor_task_done(executor_t *const executor,
+                               executor_task_t *const task) {
+  uint64_t const now = current_timestamp_ms();
+  retcode_t ret = RC_OK;
+
+  lock_handle_lock(&task->lock);
+  if (task->rerun && !task->cancelled) {
+    task->rerun = false;
+    task->generation++;
+    if (task->rerun_at_ms <= now) {
+      task->state = EXECUTOR_TASK_QUEUED;
+      task->queued_at_us = current_timestamp_us();
+      lock_handle_unlock(&task->lock);
+      ret = executor_push(executor, task);
+    } else {
+      task->state = EXECUTOR_TASK_TIMED;
+      task->deadline_ms = task->rerun_at_ms;
+      lock_handle_unlock(&task->lock);
+      ret = executor_add_timer(executor, task);
+    }
+    if (ret == RC_OK) {
+      return;
+    }
+    lock_handle_lock(&task->lock);
+  }
+  task->rerun = false;
+  task->state = EXECUTOR_TASK_IDLE;
+  cond_handle_broadcast(&task->cond);
+  lock_handle_unlock(&task->lock);
+}
+
+static void executor_run(executor_worker_t *const worker,
+                         executor_task_t *const task, bool const stolen) {
+  uint64_t latency = 0;
+  uint64_t now = 0;
+
+  lock_handle_lock(&task->lock);
+  if (task->cancelled) {
+    task->state = EXECUTOR_TASK_IDLE;
+    cond_handle_broadcast(&task->cond);
+    lock_handle_unlock(&task->lock);
+    return;
+  }
+  task->state = EXECUTOR_TASK_RUNNING;
+  now = current_timestamp_us();
+  latency = now > task->queued_at_us ? now - task->queued_at_us : 0;
+  lock_handle_unlock(&task->lock);
+
+  lock_handle_lock(&worker->deque.lock);
+  worker->stats.tasks++;
+  worker->stats.steals += stolen;
+  worker->stats.total_latency_us += latency;
+  if (latency > worker->stats.max_latency_us) {
+    worker->stats.max_latency_us = latency;
+  }
+  lock_handle_unlock(&worker->deque.lock);
+
+  task->routine(task->arg);
+  executor_task_done(worker->executor, task);
+}
+
+static executor_task_t *executor_steal(executor_worker_t *const worker) {
+  executor_t *const executor = worker->executor;
+  executor_task_t *task = NULL;
+
+  for (size_t i = 1; i < executor->workers_count && task == NULL; i++) {
+    executor_worker_t *const victim =
+        &executor->workers[(worker->index + i) % executor->workers_count];
+    lock_handle_lock(&victim->deque.lock);
+    task = deque_pop(&victim->deque);
+    lock_handle_unlock(&victim->deque.lock);
+  }
+
+  return task;
+}
+
+static void *executor_worker_routine(executor_worker_t *const worker) {
+  executor_t *const executor = worker->executor;
+  executor_timer_t due[EXECUTOR_TIMERS_BATCH];
+  executor_task_t *task = NULL;
+  size_t due_count = 0;
+  uint64_t now = 0;
+
+  current_worker = worker;
+
+  while (true) {
+    lock_handle_lock(&worker->deque.lock);
+    task = deque_pop(&worker->deque);
+    lock_handle_unlock(&worker->deque.lock);
+    if (task) {
+      executor_run(worker, task, false);
+      continue;
+    }
+    if ((task = executor_steal(worker)) != NULL) {
+      executor_run(worker, task, true);
+      continue;
+    }
+
+    lock_handle_lock(&executor->lock);
+    if (!executor->running) {
+      lock_handle_unlock(&executor->lock);
+      break;
+    }
+    now = current_timestamp_ms();
+    for (due_count = 0; due_count < EXECUTOR_TIMERS_BATCH &&
+                        executor->timers_count != 0 &&
+                        executor->timers[0].deadline_ms <= now;
+         due_count++) {
+      due[due_count] = executor->timers[0];
+      executor_remove_timer(executor, 0);
+    }
+    if (due_count != 0) {
+      executor->firing++;
+      lock_handle_unlock(&executor->lock);
+      for (size_t i = 0; i < due_count; i++) {
+        executor_fire_timer(executor, &due[i]);
+      }
+      lock_handle_lock(&executor->lock);
+      if (--executor->firing == 0) {
+        cond_handle_broadcast(&executor->cond);
+      }
+      lock_handle_unlock(&executor->lock);
+      continue;
+    }
+    if (executor_has_work(executor)) {
+      lock_handle_unlock(&executor->lock);
+      continue;
+    }
+    executor->idle++;
+    if (executor->timers_count != 0) {
+      cond_handle_timedwait_ms(&executor->cond, &executor->lock,
+                               executor->timers[0].deadline_ms - now);
+    } else {
+      cond_handle_wait(&executor->cond, &executor->lock);
+    }
+    executor->idle--;
+    lock_handle_unlock(&executor->lock);
+  }
+
+  current_worker = NULL;
+  return NULL;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t executor_init(executor_t *const executor, size_t workers_count) {
+  retcode_t ret = RC_OK;
+
+  if (executor == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(executor, 0, sizeof(executor_t));
+  if (workers_count == 0 && (workers_count = system_cpu_available()) == 0) {
+    workers_count = 1;
+  }
+  if ((executor->workers = (executor_worker_t *)calloc(
+           workers_count, sizeof(executor_worker_t))) == NULL) {
+    return RC_OOM;
+  }
+  for (size_t i = 0; i < workers_count; i++) {
+    executor->workers[i].executor = executor;
+    executor->workers[i].index = i;
+    if ((ret = deque_init(&executor->workers[i].deque)) != RC_OK) {
+      executor_destroy(executor);
+      return ret;
+    }
+    executor->workers_count++;
+  }
+  lock_handle_init(&executor->lock);
+  cond_handle_init(&executor->cond);
+
+  return RC_OK;
+}
+
+retcode_t executor_start(executor_t *const executor) {
+  if (executor == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  executor->running = true;
+  for (size_t i = 0; i < executor->workers_count; i++) {
+    if (thread_handle_create(&executor->workers[i].thread,
+                             (thread_routine_t)executor_worker_routine,
+                             &executor->workers[i]) != 0) {
+      executor->workers_count = i;
+      executor_stop(executor);
+      return RC_FAILED_THREAD_SPAWN;
+    }
+  }
+
+  return RC_OK;
+}
+
+retcode_t executor_stop(executor_t *const executor) {
+  retcode_t ret = RC_OK;
+  executor_task_t *task = NULL;
+
+  if (executor == NULL) {
+    return RC_NULL_PARAM;
+  } else if (executor->running == false) {
+    return RC_OK;
+  }
+
+  lock_handle_lock(&executor->lock);
+  executor->running = false;
+  cond_handle_broadcast(&executor->cond);
+  lock_handle_unlock(&executor->lock);
+
+  for (size_t i = 0; i < executor->workers_count; i++) {
+    if (thread_handle_join(executor->workers[i].thread, NULL) != 0) {
+      ret = RC_FAILED_THREAD_JOIN;
+    }
+  }
+
+  // Tasks left behind are released so that cancelling them does not block
+  for (size_t i = 0; i < executor->workers_count; i++) {
+    while ((task = deque_pop(&executor->workers[i].deque)) != NULL) {
+      lock_handle_lock(&task->lock);
+      task->state = EXECUTOR_TASK_IDLE;
+      cond_handle_broadcast(&task->cond);
+      lock_handle_unlock(&task->lock);
+    }
+  }
+  executor->timers_count = 0;
+
+  return ret;
+}
+
+retcode_t executor_destroy(executor_t *const executor) {
+  if (executor == NULL) {
+    return RC_NULL_PARAM;
+  } else if (executor->running) {
+    return RC_STILL_RUNNING;
+  }
+
+  for (size_t i = 0; i < executor->workers_count; i++) {
+    deque_destroy(&executor->workers[i].deque);
+  }
+  free(executor->workers);
+  free(executor->timers);
+  lock_handle_destroy(&executor->lock);
+  cond_handle_destroy(&executor->cond);
+  memset(executor, 0, sizeof(executor_t));
+
+  return RC_OK;
+}
+
+void executor_task_init(executor_task_t *const task,
+                        executor_routine_t const routine, void *const arg) {
+  memset(task, 0, sizeof(executor_task_t));
+  task->routine = routine;
+  task->arg = arg;
+  task->state = EXECUTOR_TASK_IDLE;
+  lock_handle_init(&task->lock);
+  cond_handle_init(&task->cond);
+}
+
+void executor_task_destroy(executor_task_t *const task) {
+  lock_handle_destroy(&task->lock);
+  cond_handle_destroy(&task->cond);
+}
+
+retcode_t executor_schedule(executor_t *const executor,
+                            executor_task_t *const task) {
+  retcode_t ret = RC_OK;
+  bool queued = false;
+
+  if (executor == NULL || task == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  lock_handle_lock(&task->lock);
+  if (task->cancelled) {
+    lock_handle_unlock(&task->lock);
+    return RC_OK;
+  }
+  switch (task->state) {
+    case EXECUTOR_TASK_IDLE:
+    case EXECUTOR_TASK_TIMED:
+      // Makes a pending timer stale
+      task->generation++;
+      task->state = EXECUTOR_TASK_QUEUED;
+      task->queued_at_us = current_timestamp_us();
+      queued = true;
+      break;
+    case EXECUTOR_TASK_QUEUED:
+      break;
+    case EXECUTOR_TASK_RUNNING:
+      task->rerun = true;
+      task->rerun_at_ms = 0;
+      break;
+  }
+  lock_handle_unlock(&task->lock);
+
+  if (queued && (ret = executor_push(executor, task)) != RC_OK) {
+    lock_handle_lock(&task->lock);
+    task->state = EXECUTOR_TASK_IDLE;
+    cond_handle_broadcast(&task->cond);
+    lock_handle_unlock(&task->lock);
+  }
+
+  return ret;
+}
+
+retcode_t executor_schedule_after(executor_t *const executor,
+                                  executor_task_t *const task,
+                                  uint64_t const delay_ms) {
+  retcode_t ret = RC_OK;
+  uint64_t const deadline = current_timestamp_ms() + delay_ms;
+  bool armed = false;
+
+  if (executor == NULL || task == NULL) {
+    return RC_NULL_PARAM;
+  } else if (delay_ms == 0) {
+    return executor_schedule(executor, task);
+  }
+
+  lock_handle_lock(&task->lock);
+  if (task->cancelled) {
+    lock_handle_unlock(&task->lock);
+    return RC_OK;
+  }
+  switch (task->state) {
+    case EXECUTOR_TASK_IDLE:
+      armed = true;
+      break;
+    case EXECUTOR_TASK_TIMED:
+      armed = deadline < task->deadline_ms;
+      break;
+    case EXECUTOR_TASK_QUEUED:
+      break;
+    case EXECUTOR_TASK_RUNNING:
+      if (!task->rerun || deadline < task->rerun_at_ms) {
+        task->rerun = true;
+        task->rerun_at_ms = deadline;
+      }
+      break;
+  }
+  if (armed) {
+    task->generation++;
+    task->state = EXECUTOR_TASK_TIMED;
+    task->deadline_ms = deadline;
+  }
+  lock_handle_unlock(&task->lock);
+
+  if (armed && (ret = executor_add_timer(executor, task)) != RC_OK) {
+    lock_handle_lock(&task->lock);
+    task->state = EXECUTOR_TASK_IDLE;
+    cond_handle_broadcast(&task->cond);
+    lock_handle_unlock(&task->lock);
+  }
+
+  return ret;
+}
+
+void executor_cancel(executor_t *const executor, executor_task_t *const task) {
+  if (executor == NULL || task == NULL) {
+    return;
+  }
+
+  lock_handle_lock(&task->lock);
+  task->cancelled = true;
+  task->rerun = false;
+  if (task->state == EXECUTOR_TASK_TIMED) {
+    task->generation++;
+    task->state = EXECUTOR_TASK_IDLE;
+  }
+  // A queued task is released by the worker popping it
+  while (task->state == EXECUTOR_TASK_QUEUED ||
+         task->state == EXECUTOR_TASK_RUNNING) {
+    cond_handle_wait(&task->cond, &task->lock);
+  }
+  lock_handle_unlock(&task->lock);
+
+  // No timer may refer to the task once it returns, it can then be destroyed
+  lock_handle_lock(&executor->lock);
+  for (size_t i = 0; i < executor->timers_count;) {
+    if (executor->timers[i].task == task) {
+      executor_remove_timer(executor, i);
+    } else {
+      i++;
+    }
+  }
+  while (executor->firing != 0) {
+    cond_handle_wait(&executor->cond, &executor->lock);
+  }
+  lock_handle_unlock(&executor->lock);
+}
+
+void executor_stats(executor_t *const executor, executor_stats_t *const stats) {
+  executor_worker_t *worker = NULL;
+
+  memset(stats, 0, sizeof(executor_stats_t));
+  if (executor == NULL) {
+    return;
+  }
+
+  for (size_t i = 0; i < executor->workers_count; i++) {
+    worker = &executor->workers[i];
+    lock_handle_lock(&worker->deque.lock);
+    stats->tasks += worker->stats.tasks;
+    stats->steals += worker->stats.steals;
+    stats->total_latency_us += worker->stats.total_latency_us;
+    if (worker->stats.max_latency_us > stats->max_latency_us) {
+      stats->max_latency_us = worker->stats.max_latency_us;
+    }
+    stats->queued += worker->deque.size;
+    lock_handle_unlock(&worker->deque.lock);
+  }
+  lock_handle_lock(&executor->lock);
+  stats->timers = executor->timers_count;
+  lock_handle_unlock(&executor->lock);
+}
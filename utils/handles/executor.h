@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __UTILS_HANDLES_EXECUTOR_H__
+#define __UTILS_HANDLES_EXECUTOR_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * An executor runs tasks on a fixed set of worker threads, one per core by
+ * default. Each worker has its own queue and takes work from the queues of the
+ * others when it runs out, idle workers sleep until a task is scheduled or a
+ * timer is due.
+ *
+ * A task is a routine bound to an argument, scheduled to run as soon as
+ * possible or after a delay. A task never runs concurrently with itself and is
+ * queued at most once: scheduling a queued task does nothing and scheduling a
+ * running task makes it run again once it returns. Components therefore own a
+ * task per activity and schedule it whenever there is work, the routine doing
+ * a bounded amount of it and scheduling itself again if some is left.
+ */
+
+typedef void (*executor_routine_t)(void *const arg);
+
+typedef enum executor_task_state_e {
+  EXECUTOR_TASK_IDLE,
+  EXECUTOR_TASK_TIMED,
+  EXECUTOR_TASK_QUEUED,
+  EXECUTOR_TASK_RUNNING,
+} executor_task_state_t;
+
+typedef struct executor_task_s {
+  executor_routine_t routine;
+  void *arg;
+  lock_handle_t lock;
+  cond_handle_t cond;
+  executor_task_state_t state;
+  bool cancelled;
+  // Scheduled while running, to run again at rerun_at_ms
+  bool rerun;
+  uint64_t rerun_at_ms;
+  // Timer of the task, timers of previous generations are stale
+  uint64_t deadline_ms;
+  uint64_t generation;
+  uint64_t queued_at_us;
+} executor_task_t;
+
+typedef struct executor_timer_s {
+  uint64_t deadline_ms;
+  uint64_t generation;
+  executor_task_t *task;
+} executor_timer_t;
+
+typedef struct executor_deque_s {
+  lock_handle_t lock;
+  executor_task_t **tasks;
+  size_t head;
+  size_t size;
+  size_t capacity;
+} executor_deque_t;
+
+typedef struct executor_stats_s {
+  // Number of tasks run and how many of them were stolen from another worker
+  uint64_t tasks;
+  uint64_t steals;
+  // Time from when a task is due to when a worker starts running it
+  uint64_t total_latency_us;
+  uint64_t max_latency_us;
+  size_t queued;
+  size_t timers;
+} executor_stats_t;
+
+typedef struct executor_worker_s {
+  struct executor_s *executor;
+  thread_handle_t thread;
+  size_t index;
+  executor_deque_t deque;
+  // Guarded by the deque lock
+  executor_stats_t stats;
+} executor_worker_t;
+
+typedef struct executor_s {
+  bool running;
+  executor_worker_t *workers;
+  size_t workers_count;
+  // Guard the fields below, workers sleep on cond
+  lock_handle_t lock;
+  cond_handle_t cond;
+  size_t idle;
+  // Workers firing due timers outside of the lock
+  size_t firing;
+  size_t next_worker;
+  executor_timer_t *timers;
+  size_t timers_count;
+  size_t timers_capacity;
+} executor_t;
+
+/**
+ * Initializes an executor
+ *
+ * @param executor The executor
+ * @param workers_count Number of worker threads, 0 for one per available core
+ *
+ * @return a status code
+ */
+retcode_t executor_init(executor_t *const executor, size_t workers_count);
+
+/**
+ * Starts the worker threads of an executor
+ *
+ * @param executor The executor
+ *
+ * @return a status code
+ */
+retcode_t executor_start(executor_t *const executor);
+
+/**
+ * Stops the worker threads of an executor, tasks still queued are not run.
+ * Components must have cancelled their tasks beforehand.
+ *
+ * @param executor The executor
+ *
+ * @return a status code
+ */
+retcode_t executor_stop(executor_t *const executor);
+
+/**
+ * Destroys an executor
+ *
+ * @param executor The executor
+ *
+ * @return a status code
+ */
+retcode_t executor_destroy(executor_t *const executor);
+
+/**
+ * Initializes a task
+ *
+ * @param task The task
+ * @param routine The routine run by the task
+ * @param arg Argument given to the routine
+ */
+void executor_task_init(executor_task_t *const task,
+                        executor_routine_t const routine, void *const arg);
+
+/**
+ * Destroys a task, it must not be scheduled
+ *
+ * @param task The task
+ */
+void executor_task_destroy(executor_task_t *const task);
+
+/**
+ * Schedules a task to run as soon as possible
+ *
+ * @param executor The executor
+ * @param task The task
+ *
+ * @return a status code
+ */
+retcode_t executor_schedule(executor_t *const executor,
+                            executor_task_t *const task);
+
+/**
+ * Schedules a task to run after a delay, or earlier if it already is
+ *
+ * @param executor The executor
+ * @param task The task
+ * @param delay_ms The delay in milliseconds
+ *
+ * @return a status code
+ */
+retcode_t executor_schedule_after(executor_t *const executor,
+                                  executor_task_t *const task,
+                                  uint64_t const delay_ms);
+
+/**
+ * Prevents a task from running again and waits for a running instance to
+ * return, it must not be called from the task itself. The task can be
+ * initialized again afterwards.
+ *
+ * @param executor The executor
+ * @param task The task
+ */
+void executor_cancel(executor_t *const executor, executor_task_t *const task);
+
+/**
+ * Gets statistics about the tasks run by an executor so far
+ *
+ * @param executor The executor
+ * @param stats The statistics
+ */
+void executor_stats(executor_t *const executor, executor_stats_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __UTILS_HANDLES_EXECUTOR_H__
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "utils/handles/executor.h"
+#include "utils/time.h"
+
+#define NUM_TASKS 64
+#define WAIT_TIMEOUT_MS 5000
+
+typedef struct counter_s {
+  lock_handle_t lock;
+  executor_t *executor;
+  executor_task_t task;
+  size_t runs;
+  size_t running;
+  size_t max_running;
+  // Runs left before the task stops rescheduling itself
+  size_t reschedules;
+  uint64_t sleep_ms;
+  uint64_t last_run_ms;
+} counter_t;
+
+static void counter_routine(counter_t *const counter) {
+  lock_handle_lock(&counter->lock);
+  counter->running++;
+  if (counter->running > counter->max_running) {
+    counter->max_running = counter->running;
+  }
+  lock_handle_unlock(&counter->lock);
+
+  if (counter->sleep_ms) {
+    sleep_ms(counter->sleep_ms);
+  }
+
+  lock_handle_lock(&counter->lock);
+  counter->running--;
+  counter->runs++;
+  counter->last_run_ms = current_timestamp_ms();
+  if (counter->reschedules) {
+    counter->reschedules--;
+    executor_schedule(counter->executor, &counter->task);
+  }
+  lock_handle_unlock(&counter->lock);
+}
+
+static void counter_init(counter_t *const counter, executor_t *const executor) {
+  memset(counter, 0, sizeof(counter_t));
+  lock_handle_init(&counter->lock);
+  counter->executor = executor;
+  executor_task_init(&counter->task, (executor_routine_t)counter_routine,
+                     counter);
+}
+
+static void counter_destroy(counter_t *const counter) {
+  executor_cancel(counter->executor, &counter->task);
+  executor_task_destroy(&counter->task);
+  lock_handle_destroy(&counter->lock);
+}
+
+static size_t counter_runs(counter_t *const counter) {
+  size_t runs = 0;
+
+  lock_handle_lock(&counter->lock);
+  runs = counter->runs;
+  lock_handle_unlock(&counter->lock);
+  return runs;
+}
+
+static bool wait_runs(counter_t *const counter, size_t const runs) {
+  uint64_t const start = current_timestamp_ms();
+
+  while (counter_runs(counter) < runs) {
+    if (current_timestamp_ms() - start > WAIT_TIMEOUT_MS) {
+      return false;
+    }
+    sleep_ms(1);
+  }
+  return true;
+}
+
+void test_schedule(void) {
+  executor_t executor;
+  counter_t counters[NUM_TASKS];
+  executor_stats_t stats;
+
+  TEST_ASSERT(executor_init(&executor, 4) == RC_OK);
+  TEST_ASSERT(executor_start(&executor) == RC_OK);
+
+  for (size_t i = 0; i < NUM_TASKS; i++) {
+    counter_init(&counters[i], &executor);
+    TEST_ASSERT(executor_schedule(&executor, &counters[i].task) == RC_OK);
+  }
+  for (size_t i = 0; i < NUM_TASKS; i++) {
+    TEST_ASSERT_TRUE(wait_runs(&counters[i], 1));
+  }
+  executor_stats(&executor, &stats);
+  TEST_ASSERT_TRUE(stats.tasks >= NUM_TASKS);
+
+  for (size_t i = 0; i < NUM_TASKS; i++) {
+    counter_destroy(&counters[i]);
+  }
+  TEST_ASSERT(executor_stop(&executor) == RC_OK);
+  TEST_ASSERT(executor_destroy(&executor) == RC_OK);
+}
+
+void test_schedule_coalesced(void) {
+  executor_t executor;
+  counter_t counter;
+
+  TEST_ASSERT(executor_init(&executor, 4) == RC_OK);
+  TEST_ASSERT(executor_start(&executor) == RC_OK);
+  counter_init(&counter, &executor);
+  counter.sleep_ms = 50;
+
+  TEST_ASSERT(executor_schedule(&executor, &counter.task) == RC_OK);
+  sleep_ms(10);
+  // The task is running, it runs once more whatever the number of schedules
+  for (size_t i = 0; i < 100; i++) {
+    TEST_ASSERT(executor_schedule(&executor, &counter.task) == RC_OK);
+  }
+  TEST_ASSERT_TRUE(wait_runs(&counter, 2));
+  sleep_ms(150);
+  TEST_ASSERT_EQUAL_INT(2, counter_runs(&counter));
+  TEST_ASSERT_EQUAL_INT(1, counter.max_running);
+
+  counter_destroy(&counter);
+  TEST_ASSERT(executor_stop(&executor) == RC_OK);
+  TEST_ASSERT(executor_destroy(&executor) == RC_OK);
+}
+
+void test_schedule_fair(void) {
+  executor_t executor;
+  counter_t busy, other;
+
+  // A single worker, a task rescheduling itself must not starve the others
+  TEST_ASSERT(executor_init(&executor, 1) == RC_OK);
+  TEST_ASSERT(executor_start(&executor) == RC_OK);
+  counter_init(&busy, &executor);
+  counter_init(&other, &executor);
+  busy.reschedules = 1000000;
+
+  TEST_ASSERT(executor_schedule(&executor, &busy.task) == RC_OK);
+  TEST_ASSERT(executor_schedule(&executor, &other.task) == RC_OK);
+  TEST_ASSERT_TRUE(wait_runs(&other, 1));
+  TEST_ASSERT_TRUE(counter_runs(&busy) < 1000000);
+
+  counter_destroy(&busy);
+  counter_destroy(&other);
+  TEST_ASSERT(executor_stop(&executor) == RC_OK);
+  TEST_ASSERT(executor_destroy(&executor) == RC_OK);
+}
+
+void test_schedule_after(void) {
+  executor_t executor;
+  counter_t late, early;
+  uint64_t start = 0;
+
+  TEST_ASSERT(executor_init(&executor, 2) == RC_OK);
+  TEST_ASSERT(executor_start(&executor) == RC_OK);
+  counter_init(&late, &executor);
+  counter_init(&early, &executor);
+
+  start = current_timestamp_ms();
+  TEST_ASSERT(executor_schedule_after(&executor, &late.task, 200) == RC_OK);
+  TEST_ASSERT(executor_schedule_after(&executor, &early.task, 500) == RC_OK);
+  // Rescheduling earlier wins over the pending timer
+  TEST_ASSERT(executor_schedule_after(&executor, &early.task, 50) == RC_OK);
+  TEST_ASSERT_TRUE(wait_runs(&early, 1));
+  TEST_ASSERT_TRUE(early.last_run_ms - start >= 50);
+  TEST_ASSERT_EQUAL_INT(0, counter_runs(&late));
+  TEST_ASSERT_TRUE(wait_runs(&late, 1));
+  TEST_ASSERT_TRUE(late.last_run_ms - start >= 200);
+
+  // The stale timer of the early task does not run it again
+  sleep_ms(600);
+  TEST_ASSERT_EQUAL_INT(1, counter_runs(&early));
+
+  counter_destroy(&late);
+  counter_destroy(&early);
+  TEST_ASSERT(executor_stop(&executor) == RC_OK);
+  TEST_ASSERT(executor_destroy(&executor) == RC_OK);
+}
+
+void test_cancel(void) {
+  executor_t executor;
+  counter_t running, timed;
+
+  TEST_ASSERT(executor_init(&executor, 2) == RC_OK);
+  TEST_ASSERT(executor_start(&executor) == RC_OK);
+  counter_init(&running, &executor);
+  counter_init(&timed, &executor);
+  running.sleep_ms = 100;
+  running.reschedules = 1000000;
+
+  TEST_ASSERT(executor_schedule(&executor, &running.task) == RC_OK);
+  TEST_ASSERT(executor_schedule_after(&executor, &timed.task, 100) == RC_OK);
+  while (true) {
+    lock_handle_lock(&running.lock);
+    if (running.running) {
+      lock_handle_unlock(&running.lock);
+      break;
+    }
+    lock_handle_unlock(&running.lock);
+    sleep_ms(1);
+  }
+
+  executor_cancel(&executor, &timed.task);
+  // Waits for the running instance and prevents the next ones
+  executor_cancel(&executor, &running.task);
+  TEST_ASSERT_EQUAL_INT(1, counter_runs(&running));
+  TEST_ASSERT(executor_schedule(&executor, &timed.task) == RC_OK);
+  sleep_ms(200);
+  TEST_ASSERT_EQUAL_INT(1, counter_runs(&running));
+  TEST_ASSERT_EQUAL_INT(0, counter_runs(&timed));
+
+  counter_destroy(&running);
+  counter_destroy(&timed);
+  TEST_ASSERT(executor_stop(&executor) == RC_OK);
+  TEST_ASSERT(executor_destroy(&executor) == RC_OK);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_schedule);
+  RUN_TEST(test_schedule_coalesced);
+  RUN_TEST(test_schedule_fair);
+  RUN_TEST(test_schedule_after);
+  RUN_TEST(test_cancel);
+
+  return UNITY_END();
+}
@@ -6,6 +6,7 @@
  */
 
 #include "utils/hash_indexed_map.h"
+#include "utils/containers/hash/hash_allocator.h"
 
 /*
  * Hash-indexed_hash_set map
@@ -42,8 +43,8 @@ retcode_t hash_to_indexed_hash_set_map_add_new_set(
     hash_to_indexed_hash_set_map_t *const map, flex_trit_t const *const hash,
     hash_to_indexed_hash_set_entry_t **const new_set_entry,
     size_t const index) {
-  *new_set_entry = (hash_to_indexed_hash_set_entry_t *)malloc(
-      sizeof(hash_to_indexed_hash_set_entry_t));
+  *new_set_entry = (hash_to_indexed_hash_set_entry_t *)hash_allocator_malloc(
+      *map, sizeof(hash_to_indexed_hash_set_entry_t));
   if (*new_set_entry == NULL) {
     return RC_UTILS_OOM;
   }
@@ -65,7 +66,7 @@ void hash_to_indexed_hash_set_map_free(
   HASH_ITER(hh, *map, curr_entry, tmp_entry) {
     hash243_set_free(&((*map)->approvers));
     HASH_DEL(*map, curr_entry);
-    free(curr_entry);
+    hash_allocator_free(curr_entry);
   }
   *map = NULL;
 }
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <unity/unity.h>
+
+#include "utils/arena.h"
+
+#define BLOCK_SIZE 256
+
+static size_t arena_num_blocks(arena_t const *const arena) {
+  size_t count = 0;
+
+  for (arena_block_t const *block = arena->first; block; block = block->next) {
+    count++;
+  }
+  return count;
+}
+
+void test_arena_alloc(void) {
+  arena_t arena;
+  char *ptrs[64];
+
+  arena_init(&arena, BLOCK_SIZE);
+  TEST_ASSERT_NULL(arena.first);
+
+  for (size_t i = 0; i < 64; i++) {
+    ptrs[i] = (char *)arena_alloc(&arena, i + 1);
+    TEST_ASSERT_NOT_NULL(ptrs[i]);
+    TEST_ASSERT_EQUAL_INT(0, (uintptr_t)ptrs[i] % 16);
+    memset(ptrs[i], (int)i, i + 1);
+    TEST_ASSERT_TRUE(arena_owns(&arena, ptrs[i]));
+  }
+  for (size_t i = 0; i < 64; i++) {
+    for (size_t j = 0; j <= i; j++) {
+      TEST_ASSERT_EQUAL_INT((int)i, ptrs[i][j]);
+    }
+  }
+  TEST_ASSERT_TRUE(arena_num_blocks(&arena) > 1);
+  TEST_ASSERT_FALSE(arena_owns(&arena, &arena));
+
+  // Bigger than any block
+  TEST_ASSERT_NOT_NULL(arena_alloc(&arena, 64 * BLOCK_SIZE));
+
+  arena_destroy(&arena);
+  TEST_ASSERT_NULL(arena.first);
+}
+
+void test_arena_rewind(void) {
+  arena_t arena;
+  arena_mark_t mark;
+  void *before = NULL, *after = NULL;
+  size_t num_blocks = 0;
+
+  arena_init(&arena, BLOCK_SIZE);
+  arena_alloc(&arena, 32);
+  mark = arena_mark(&arena);
+  before = arena_alloc(&arena, 32);
+  for (size_t i = 0; i < 100; i++) {
+    arena_alloc(&arena, 64);
+  }
+  num_blocks = arena_num_blocks(&arena);
+
+  arena_rewind(&arena, &mark);
+  after = arena_alloc(&arena, 32);
+  TEST_ASSERT_EQUAL_PTR(before, after);
+
+  // Blocks kept by the rewind are reused
+  for (size_t i = 0; i < 100; i++) {
+    arena_alloc(&arena, 64);
+  }
+  TEST_ASSERT_EQUAL_INT(num_blocks, arena_num_blocks(&arena));
+
+  arena_destroy(&arena);
+}
+
+void test_arena_reset(void) {
+  arena_t arena;
+  arena_mark_t mark;
+  void *first = NULL;
+
+  arena_init(&arena, BLOCK_SIZE);
+  // A mark taken before any allocation resets the arena
+  mark = arena_mark(&arena);
+  first = arena_alloc(&arena, 16);
+  arena_alloc(&arena, 4 * BLOCK_SIZE);
+  arena_rewind(&arena, &mark);
+  TEST_ASSERT_EQUAL_PTR(first, arena_alloc(&arena, 16));
+
+  arena_reset(&arena);
+  TEST_ASSERT_EQUAL_PTR(first, arena_alloc(&arena, 16));
+
+  arena_destroy(&arena);
+}
+
+void test_arena_trim(void) {
+  arena_t arena;
+
+  arena_init(&arena, BLOCK_SIZE);
+  for (size_t i = 0; i < 100; i++) {
+    arena_alloc(&arena, 64);
+  }
+  TEST_ASSERT_TRUE(arena_num_blocks(&arena) > 2);
+
+  arena_reset(&arena);
+  arena_trim(&arena, 0);
+  TEST_ASSERT_EQUAL_INT(1, arena_num_blocks(&arena));
+
+  for (size_t i = 0; i < 100; i++) {
+    arena_alloc(&arena, 64);
+  }
+  arena_reset(&arena);
+  arena_trim(&arena, 3 * BLOCK_SIZE);
+  TEST_ASSERT_EQUAL_INT(2, arena_num_blocks(&arena));
+
+  arena_destroy(&arena);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_arena_alloc);
+  RUN_TEST(test_arena_rewind);
+  RUN_TEST(test_arena_reset);
+  RUN_TEST(test_arena_trim);
+
+  return UNITY_END();
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+#include <unity/unity.h>
+
+#include "utils/token_bucket.h"
+
+void test_token_bucket_burst(void) {
+  token_bucket_t bucket;
+  uint64_t now = 1000;
+
+  memset(&bucket, 0, sizeof(token_bucket_t));
+
+  // A new bucket is full
+  for (size_t i = 0; i < 10; i++) {
+    TEST_ASSERT_TRUE(token_bucket_take(&bucket, 100, 10, 1, now));
+  }
+  TEST_ASSERT_FALSE(token_bucket_take(&bucket, 100, 10, 1, now));
+
+  // 100 tokens per second is one every 10 ms
+  TEST_ASSERT_FALSE(token_bucket_take(&bucket, 100, 10, 1, now + 5));
+  TEST_ASSERT_TRUE(token_bucket_take(&bucket, 100, 10, 1, now + 10));
+  TEST_ASSERT_FALSE(token_bucket_take(&bucket, 100, 10, 1, now + 10));
+
+  // Never more than the burst
+  now += 60000;
+  TEST_ASSERT_FALSE(token_bucket_take(&bucket, 100, 10, 11, now));
+  TEST_ASSERT_TRUE(token_bucket_take(&bucket, 100, 10, 10, now));
+}
+
+void test_token_bucket_rate(void) {
+  token_bucket_t bucket;
+  uint64_t now = 1000;
+  size_t taken = 0;
+
+  memset(&bucket, 0, sizeof(token_bucket_t));
+
+  // Over 10 seconds, at most the burst plus 10 times the rate
+  for (size_t ms = 0; ms < 10000; ms++) {
+    for (size_t i = 0; i < 10; i++) {
+      taken += token_bucket_take(&bucket, 50, 20, 1, now + ms);
+    }
+  }
+  TEST_ASSERT_TRUE(taken >= 500);
+  TEST_ASSERT_TRUE(taken <= 520);
+
+  // A lower rate takes effect immediately
+  memset(&bucket, 0, sizeof(token_bucket_t));
+  TEST_ASSERT_TRUE(token_bucket_take(&bucket, 50, 1, 1, now));
+  TEST_ASSERT_FALSE(token_bucket_take(&bucket, 5, 1, 1, now + 100));
+  TEST_ASSERT_TRUE(token_bucket_take(&bucket, 5, 1, 1, now + 300));
+}
+
+void test_token_bucket_unlimited(void) {
+  token_bucket_t bucket;
+
+  memset(&bucket, 0, sizeof(token_bucket_t));
+  for (size_t i = 0; i < 1000; i++) {
+    TEST_ASSERT_TRUE(token_bucket_take(&bucket, 0, 0, 1650, 1000));
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_token_bucket_burst);
+  RUN_TEST(test_token_bucket_rate);
+  RUN_TEST(test_token_bucket_unlimited);
+
+  return UNITY_END();
+}
@@ -35,6 +35,17 @@ uint64_t current_timestamp_ms() {
 #endif
 }
 
+uint64_t current_timestamp_us() {
+#ifdef _WIN32
+  return current_timestamp_ms() * 1000ULL;
+#else
+  struct timeval tv = {0};
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000000ULL + tv.tv_usec;
+#endif
+}
+
 void sleep_ms(uint64_t milliseconds) {
 #ifdef _WIN32
   Sleep(milliseconds);
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include "utils/token_bucket.h"
+
+bool token_bucket_take(token_bucket_t *const bucket, double const rate,
+                       double const burst, double const amount,
+                       uint64_t const now_ms) {
+  if (rate <= 0) {
+    return true;
+  }
+
+  if (bucket->last_ms == 0) {
+    bucket->tokens = burst;
+  } else if (now_ms > bucket->last_ms) {
+    bucket->tokens += rate * (now_ms - bucket->last_ms) / 1000.0;
+  }
+  if (bucket->tokens > burst) {
+    bucket->tokens = burst;
+  }
+  bucket->last_ms = now_ms;
+
+  if (bucket->tokens < amount) {
+    return false;
+  }
+  bucket->tokens -= amount;
+  return true;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2018 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __UTILS_TOKEN_BUCKET_H__
+#define __UTILS_TOKEN_BUCKET_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A token bucket limits the rate of an activity while allowing short bursts:
+ * tokens are added at a given rate up to a burst size and each unit of the
+ * activity takes one. The rate is given on each use so that it can be adjusted
+ * at will, a zeroed bucket is full on its first use.
+ * Not concurrent.
+ */
+typedef struct token_bucket_s {
+  double tokens;
+  uint64_t last_ms;
+} token_bucket_t;
+
+/**
+ * Takes tokens from a bucket if enough are available
+ *
+ * @param bucket The bucket
+ * @param rate The refill rate in tokens per second, 0 for no limit
+ * @param burst The maximum number of tokens
+ * @param amount The number of tokens to take
+ * @param now_ms The current time in milliseconds
+ *
+ * @return true if the tokens were taken, false if the rate is exceeded
+ */
+bool token_bucket_take(token_bucket_t *const bucket, double const rate,
+                       double const burst, double const amount,
+                       uint64_t const now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __UTILS_TOKEN_BUCKET_H__